@@ -26,6 +26,7 @@ inverter::inverter(MODULE *module)
 {	
 	if (oclass==NULL)
 	{
+		// not PC_PARALLEL_INIT: init writes the parent meter's Norton and full_Y matrix, the module frequency flags and gen_object_count
 		oclass = gl_register_class(module,"inverter",sizeof(inverter),PC_PRETOPDOWN|PC_BOTTOMUP|PC_POSTTOPDOWN|PC_AUTOLOCK);
 		if (oclass==NULL)
 			throw "unable to register class inverter";
@@ -8544,10 +8545,11 @@ void inverter::reset_complex_powerflow_accumulators(void)
 //Function to push up all changes of complex properties to powerflow from local variables
 void inverter::push_complex_powerflow_values(void)
 {
-	complex temp_complex_val;
+	OBJECT *obj = OBJECTHDR(this);
 	gld_wlock *test_rlock;
 	int indexval;
 
+	//Accumulators are added through the core, so siblings don't need to lock the parent
 	//See which one we are, since that will impact things
 	if (parent_is_triplex == false)	//Three-phase
 	{
@@ -8555,34 +8557,13 @@ void inverter::push_complex_powerflow_values(void)
 		for (indexval=0; indexval<3; indexval++)
 		{
 			//**** Current value ***/
-			//Pull current value again, just in case
-			temp_complex_val = pLine_I[indexval]->get_complex();
-
-			//Add the difference
-			temp_complex_val += value_Line_I[indexval];
-
-			//Push it back up
-			pLine_I[indexval]->setp<complex>(temp_complex_val,*test_rlock);
+			pLine_I[indexval]->addp(value_Line_I[indexval],obj);
 
 			//**** Power value ***/
-			//Pull current value again, just in case
-			temp_complex_val = pPower[indexval]->get_complex();
-
-			//Add the difference
-			temp_complex_val += value_Power[indexval];
-
-			//Push it back up
-			pPower[indexval]->setp<complex>(temp_complex_val,*test_rlock);
+			pPower[indexval]->addp(value_Power[indexval],obj);
 
 			//**** pre-rotated Current value ***/
-			//Pull current value again, just in case
-			temp_complex_val = pLine_unrotI[indexval]->get_complex();
-
-			//Add the difference
-			temp_complex_val += value_Line_unrotI[indexval];
-
-			//Push it back up
-			pLine_unrotI[indexval]->setp<complex>(temp_complex_val,*test_rlock);
+			pLine_unrotI[indexval]->addp(value_Line_unrotI[indexval],obj);
 
 			if ((VSI_mode == VSI_ISOCHRONOUS) || (VSI_mode == VSI_DROOP))
 			{
@@ -8594,37 +8575,14 @@ void inverter::push_complex_powerflow_values(void)
 	}
 	else	//Assumes must be triplex - else how did it get here?
 	{
-		//Pull the relevant values -- all single pulls
-		
 		//**** Current12 value ***/
-		//Pull current value again, just in case
-		temp_complex_val = pLine12->get_complex();
-
-		//Add the difference
-		temp_complex_val += value_Line12;
-
-		//Push it back up
-		pLine12->setp<complex>(temp_complex_val,*test_rlock);
+		pLine12->addp(value_Line12,obj);
 
 		//**** powert12 value ***/
-		//Pull current value again, just in case
-		temp_complex_val = pPower12->get_complex();
-
-		//Add the difference
-		temp_complex_val += value_Power12;
-
-		//Push it back up
-		pPower12->setp<complex>(temp_complex_val,*test_rlock);
+		pPower12->addp(value_Power12,obj);
 
 		//**** prerotated_12 value ***/
-		//Pull current value again, just in case
-		temp_complex_val = pLine_unrotI[0]->get_complex();
-
-		//Add the difference
-		temp_complex_val += value_Line_unrotI[0];
-
-		//Push it back up
-		pLine_unrotI[0]->setp<complex>(temp_complex_val,*test_rlock);
+		pLine_unrotI[0]->addp(value_Line_unrotI[0],obj);
 
 		//**** IGenerated_12 ****/
 		if ((VSI_mode == VSI_ISOCHRONOUS) || (VSI_mode == VSI_DROOP))
@@ -1197,22 +1197,14 @@ gld_property *windturb_dg::map_double_value(OBJECT *obj, char *name)
 //Function to push up all changes of complex properties to powerflow from local variables
 void windturb_dg::push_complex_powerflow_values(void)
 {
-	complex temp_complex_val;
-	gld_wlock *test_rlock;
+	OBJECT *obj = OBJECTHDR(this);
 	int indexval;
 
 	//Loop through the three-phases/accumulators
 	for (indexval=0; indexval<3; indexval++)
 	{
 		//**** Current value ***/
-		//Pull current value again, just in case
-		temp_complex_val = pLine_I[indexval]->get_complex();
-
-		//Add the difference
-		temp_complex_val += value_Line_I[indexval];
-
-		//Push it back up
-		pLine_I[indexval]->setp<complex>(temp_complex_val,*test_rlock);
+		pLine_I[indexval]->addp(value_Line_I[indexval],obj);
 	}
 }
 
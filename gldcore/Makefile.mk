@@ -35,8 +35,12 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/globals.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/gridlabd.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/gui.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/gui.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/hash.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/hash.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/http_client.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/http_client.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/image.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/image.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/index.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/index.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/instance.c
@@ -91,6 +95,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/random.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/gldrandom.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/realtime.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/realtime.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/reduce.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/reduce.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/sanitize.cpp
 GLD_SOURCES_PLACE_HOLDER += gldcore/sanitize.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/save.c
@@ -99,6 +105,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/schedule.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/schedule.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/server.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/server.h
+GLD_SOURCES_PLACE_HOLDER += gldcore/sparse.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/sparse.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/setup.cpp
 GLD_SOURCES_PLACE_HOLDER += gldcore/setup.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/stream.cpp
@@ -112,6 +120,8 @@ GLD_SOURCES_PLACE_HOLDER += gldcore/test.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/threadpool.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/threadpool.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/timestamp.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/timeline.c
+GLD_SOURCES_PLACE_HOLDER += gldcore/timeline.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/timestamp.h
 GLD_SOURCES_PLACE_HOLDER += gldcore/transform.c
 GLD_SOURCES_PLACE_HOLDER += gldcore/transform.h
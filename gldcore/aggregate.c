@@ -22,6 +22,16 @@
 	std(price)
 	\endverbatim
 
+	Aggregations are compiled the first time they are evaluated.  The members of the
+	group and the address of the property in each member are resolved into flat arrays,
+	and the unit conversion is reduced to a factor and an offset, so an evaluation only
+	reads values and reduces them.  The members are reduced in fixed blocks of
+	#AGGR_BLOCKSIZE objects whose partial results are combined in order, so large groups
+	can be reduced by several threads and still give the same result for any number of
+	threads.  Groups whose membership is not constant are compiled again only when the
+	clock has advanced since the last compile, because the object header fields used by
+	group expressions only change when objects are synchronized.
+
 	@bug Right now, not all allowed aggregations are invariant (meaning that the members of the group
 	do not change over time).  However, the collector object requires invariant aggregations.  Using 
 	an aggregation that isn't invariant will cause the simulation to fail. (ticket #112)
@@ -34,6 +44,22 @@
 #include "aggregate.h"
 #include "output.h"
 #include "find.h"
+#include "globals.h"
+#include "threadpool.h"
+
+#define AGGR_BLOCKSIZE 4096 /**< the number of objects reduced in one block */
+#define AGGR_PARALLEL 65536 /**< the smallest group reduced by more than one thread */
+
+/** The partial result of one block of a compiled group */
+typedef struct s_aggrblock {
+	AGGREGATION *aggr;
+	unsigned int first, last; /**< the members in this block */
+	unsigned int n; /**< the number of valid values */
+	double sum, min, max, mean, m2, sumlog, prod;
+} AGGRBLOCK;
+
+static WSPOOL *aggr_pool = NULL;
+static pthread_mutex_t aggr_poollock = PTHREAD_MUTEX_INITIALIZER;
 
 /** This function builds an collection of objects into an aggregation.  
 	The aggregation can be run using aggregate_value(AGGREGATION*)
@@ -116,7 +142,7 @@ AGGREGATION *aggregate_mkgroup(char *aggregator, /**< aggregator (min,max,avg,st
 	else if (stricmp(aggrop,"avg")==0) op=AGGR_AVG;
 	else if (stricmp(aggrop,"std")==0) op=AGGR_STD;
 	else if (stricmp(aggrop,"sum")==0) op=AGGR_SUM;
-	else if (stricmp(aggrop,"prod")==0) op=AGGR_SUM;
+	else if (stricmp(aggrop,"prod")==0) op=AGGR_PROD;
 	else if (stricmp(aggrop,"mbe")==0) op=AGGR_MBE;
 	else if (stricmp(aggrop,"mean")==0) op=AGGR_MEAN;
 	else if (stricmp(aggrop,"var")==0) op=AGGR_VAR;
@@ -313,6 +339,21 @@ AGGREGATION *aggregate_mkgroup(char *aggregator, /**< aggregator (min,max,avg,st
 			result->flags = flags;
 			result->punit = to_unit;
 			result->scale = scale;
+			result->n_members = 0;
+			result->member = NULL;
+			result->addr = NULL;
+			result->factor = 1.0;
+			result->offset = 0.0;
+			result->compiled = TS_INVALID;
+			result->n_blocks = 0;
+			result->block = NULL;
+			if ( part==AP_NONE && from_unit!=NULL && to_unit!=NULL )
+			{
+				double one = 1.0;
+				unit_convert_ex(from_unit, to_unit, &result->offset);
+				unit_convert_ex(from_unit, to_unit, &one);
+				result->factor = one - result->offset;
+			}
 		}
 		else
 		{
@@ -338,121 +379,256 @@ double arg(complex *x)
 	return (x->r==0) ? (x->i>0 ? PI/2 : (x->i==0 ? 0 : -PI/2)) : ((x->i>0) ? (x->r>0 ? atan(x->i/x->r) : PI-atan(x->i/x->r)) : (x->r>0 ? -atan(x->i/x->r) : PI+atan(x->i/x->r)));
 }
 
-/** This function performs an aggregate calculation given by the aggregation 
- **/
-double aggregate_value(AGGREGATION *aggr) /**< the aggregation to perform */
+/* resolve the members of the group and the address of the property in each */
+static int aggregate_compile(AGGREGATION *aggr)
 {
 	OBJECT *obj;
-	double numerator=0, denominator=0, secondary=0, third=0, fourth=0;
-	double scale = (aggr->punit ? aggr->scale : 1.0);
+	unsigned int n = 0, b;
 
 	/* non-constant groups need search program rerun */
-	if ((aggr->group->constflags & CF_CONSTANT) != CF_CONSTANT){
+	if ((aggr->group->constflags & CF_CONSTANT) != CF_CONSTANT || aggr->last==NULL){
+		free(aggr->last);
 		aggr->last = find_runpgm(NULL,aggr->group); /** @todo use constant part instead of NULL (ticket #3) */
+		if (aggr->last==NULL)
+			return 0;
 	}
 
-	for(obj = find_first(aggr->last); obj != NULL; obj = find_next(aggr->last, obj)){
-		double value=0;
-		double *pdouble = NULL;
-		complex *pcomplex = NULL;
-
-		/* add time-sensitivity to verify that we are only aggregating objects that are in-service and not out-service. */
-		if(obj->in_svc >= global_clock || obj->out_svc <= global_clock)
-			continue;
+	if (aggr->last->hit_count>aggr->n_members || aggr->member==NULL)
+	{
+		unsigned int size = aggr->last->hit_count>0 ? aggr->last->hit_count : 1;
+		unsigned int blocks = (size+AGGR_BLOCKSIZE-1)/AGGR_BLOCKSIZE;
+		OBJECT **member = (OBJECT**)realloc(aggr->member,sizeof(OBJECT*)*size);
+		void **addr = member ? (void**)realloc(aggr->addr,sizeof(void*)*size) : NULL;
+		AGGRBLOCK *block = addr ? (AGGRBLOCK*)realloc(aggr->block,sizeof(AGGRBLOCK)*blocks) : NULL;
+		if (member!=NULL) aggr->member = member;
+		if (addr!=NULL) aggr->addr = addr;
+		if (block==NULL)
+		{
+			output_error("aggregate_value(): unable to allocate memory for %d objects", size);
+			/* TROUBLESHOOT
+				There was not enough memory to compile the members of an aggregation group.
+				Try reducing the size of the group or freeing up memory and try again.
+			 */
+			aggr->n_members = 0;
+			return 0;
+		}
+		aggr->block = block;
+	}
 
+	for (obj = find_first(aggr->last); obj != NULL; obj = find_next(aggr->last, obj))
+	{
+		void *addr = NULL;
 		switch (aggr->pinfo->ptype) {
 		case PT_complex:
 		case PT_enduse:
-			pcomplex = object_get_complex(obj,aggr->pinfo);
-			if (pcomplex!=NULL)
-			{
-				switch (aggr->part) {
-				case AP_REAL: value=pcomplex->r; break;
-				case AP_IMAG: value=pcomplex->i; break;
-				case AP_MAG: value=mag(pcomplex); break;
-				case AP_ARG: value=arg(pcomplex); break;
-				case AP_ANG: value=arg(pcomplex)*180/PI;  break;
-				default: pcomplex = NULL; break; /* invalidate the result */
-				}
-			}
+			if (aggr->part!=AP_NONE)
+				addr = object_get_complex(obj,aggr->pinfo);
 			break;
 		case PT_double:
 		case PT_loadshape:
 		case PT_random:
-			pdouble = object_get_double(obj,aggr->pinfo);
-			if (pdouble!=NULL){
-				value = *pdouble;
-				if(aggr->pinfo->unit != 0 && aggr->punit != 0){
-					int rv = unit_convert_ex(aggr->pinfo->unit, aggr->punit, &value);
-					if(rv == 0){ // error
-						;
-					}
-				} // else don't worry
-			}
+			addr = object_get_double(obj,aggr->pinfo);
 			break;
 		default:
 			break;
 		}
+		if (addr!=NULL)
+		{
+			aggr->member[n] = obj;
+			aggr->addr[n] = addr;
+			n++;
+		}
+	}
+	aggr->n_members = n;
+	aggr->n_blocks = (n+AGGR_BLOCKSIZE-1)/AGGR_BLOCKSIZE;
+	for (b=0; b<aggr->n_blocks; b++)
+	{
+		aggr->block[b].aggr = aggr;
+		aggr->block[b].first = b*AGGR_BLOCKSIZE;
+		aggr->block[b].last = (b+1)*AGGR_BLOCKSIZE<n ? (b+1)*AGGR_BLOCKSIZE : n;
+	}
+	aggr->compiled = global_clock;
+	return 1;
+}
+
+/* reduce one block of a compiled group */
+static void aggregate_block(unsigned int thread, void *item, void *data)
+{
+	AGGRBLOCK *block = (AGGRBLOCK*)item;
+	AGGREGATION *aggr = block->aggr;
+	OBJECT **member = aggr->member;
+	void **addr = aggr->addr;
+	double value[AGGR_BLOCKSIZE];
+	unsigned int i, n = 0;
+
+	/* gather the values of the objects that are in service */
+#define GATHER(X) for (i=block->first; i<block->last; i++) \
+	{ if (member[i]->in_svc<global_clock && member[i]->out_svc>global_clock) value[n++] = (X); }
+	switch (aggr->part) {
+	case AP_NONE:
+		if (aggr->factor!=1.0 || aggr->offset!=0.0)
+			GATHER(*(double*)addr[i]*aggr->factor+aggr->offset)
+		else
+			GATHER(*(double*)addr[i])
+		break;
+	case AP_REAL: GATHER(((complex*)addr[i])->r) break;
+	case AP_IMAG: GATHER(((complex*)addr[i])->i) break;
+	case AP_MAG: GATHER(mag((complex*)addr[i])) break;
+	case AP_ARG: GATHER(arg((complex*)addr[i])) break;
+	case AP_ANG: GATHER(arg((complex*)addr[i])*180/PI) break;
+	default: break;
+	}
+#undef GATHER
+	if ((aggr->flags&AF_ABS)==AF_ABS)
+		for (i=0; i<n; i++)
+			value[i] = fabs(value[i]);
+
+	/* reduce them */
+	block->n = n;
+	block->sum = block->mean = block->m2 = block->sumlog = 0;
+	block->prod = 1;
+	block->min = block->max = n>0 ? value[0] : 0;
+	switch (aggr->op) {
+	case AGGR_MIN:
+	case AGGR_GAMMA:
+		for (i=1; i<n; i++)
+			if (value[i]<block->min) block->min = value[i];
+		if (aggr->op==AGGR_GAMMA)
+			for (i=0; i<n; i++)
+				block->sumlog += log(value[i]);
+		break;
+	case AGGR_MAX:
+		for (i=1; i<n; i++)
+			if (value[i]>block->max) block->max = value[i];
+		break;
+	case AGGR_PROD:
+		for (i=0; i<n; i++)
+			block->prod *= value[i];
+		break;
+	case AGGR_MBE:
+	case AGGR_STD:
+	case AGGR_VAR:
+		for (i=0; i<n; i++)
+			block->sum += value[i];
+		if (n>0)
+		{
+			block->mean = block->sum/n;
+			for (i=0; i<n; i++)
+				block->m2 += (value[i]-block->mean)*(value[i]-block->mean);
+		}
+		break;
+	default:
+		for (i=0; i<n; i++)
+			block->sum += value[i];
+		break;
+	}
+}
 
-		if (pdouble!=NULL || pcomplex!=NULL) /* valid value */
+/** This function performs an aggregate calculation given by the aggregation 
+ **/
+double aggregate_value(AGGREGATION *aggr) /**< the aggregation to perform */
+{
+	double numerator=0, denominator=0, secondary=0;
+	double sum=0, min=0, max=0, mean=0, m2=0, sumlog=0, prod=1;
+	unsigned int n=0, b;
+
+	/* compile the group the first time, and again when its membership may have changed */
+	if (aggr->compiled==TS_INVALID || ((aggr->group->constflags & CF_CONSTANT) != CF_CONSTANT && aggr->compiled!=global_clock))
+	{
+		if (!aggregate_compile(aggr))
+			aggr->n_members = aggr->n_blocks = 0;
+	}
+
+	/* reduce the blocks, in parallel when the group is large */
+	if (aggr->n_members>=AGGR_PARALLEL && global_threadcount>1 && pthread_mutex_trylock(&aggr_poollock)==0)
+	{
+		void *item[AGGR_PARALLEL/AGGR_BLOCKSIZE*16];
+		size_t done = 0;
+		if (aggr_pool==NULL)
+			aggr_pool = wsp_create("aggregate",global_threadcount,1);
+		while (aggr_pool!=NULL && done<aggr->n_blocks)
 		{
-			if ((aggr->flags&AF_ABS)==AF_ABS) value=fabs(value);
-			switch (aggr->op) {
-			case AGGR_MIN:
-				if (value<numerator || denominator==0) numerator=value;
-				denominator = 1;
-				break;
-			case AGGR_MAX:
-				if (value>numerator || denominator==0) numerator=value;
-				denominator = 1;
-				break;
-			case AGGR_COUNT:
-				numerator++;
-				denominator=1;
-				break;
-			case AGGR_MBE:
-				denominator++;
-				numerator += value;
-				secondary += (value-secondary)/denominator;
-				break;
-			case AGGR_AVG:
-			case AGGR_MEAN:
-				numerator+=value;
-				denominator++;
-				break;
-			case AGGR_SUM:
-				numerator+=value;
-				denominator = 1;
-				break;
-			case AGGR_PROD:
-				numerator*=value;
-				denominator = 1;
-				break;
-			case AGGR_GAMMA:
-				denominator+=log(value);
-				if (numerator==0 || secondary>value)
-					secondary = value;
-				numerator++;
-				break;
-			case AGGR_STD:
-			case AGGR_VAR:
-				denominator++;
-				// note this uses a compensated on-line algorithm (see Knuth 1998)
-				// it's better than the obvious method because it doesn't suffer from numerical instability when mean(x)-x is near zero
-				{	double delta = value-secondary;
-					secondary += delta/denominator;
-					numerator += delta*(value-secondary);
-				}
-				break;
-			case AGGR_SKEW:
-			case AGGR_KUR:
-			default:
-				break;
-			}
+			size_t m = aggr->n_blocks-done < sizeof(item)/sizeof(item[0]) ? aggr->n_blocks-done : sizeof(item)/sizeof(item[0]);
+			for (b=0; b<m; b++)
+				item[b] = aggr->block+done+b;
+			wsp_run(aggr_pool,item,m,aggregate_block,NULL);
+			done += m;
 		}
+		pthread_mutex_unlock(&aggr_poollock);
+		for (b=(unsigned int)done; b<aggr->n_blocks; b++)
+			aggregate_block(0,aggr->block+b,NULL);
+	}
+	else
+	{
+		for (b=0; b<aggr->n_blocks; b++)
+			aggregate_block(0,aggr->block+b,NULL);
+	}
+
+	/* combine the partial results in block order */
+	for (b=0; b<aggr->n_blocks; b++)
+	{
+		AGGRBLOCK *block = aggr->block+b;
+		if (block->n==0)
+			continue;
+		if (n==0 || block->min<min) min = block->min;
+		if (n==0 || block->max>max) max = block->max;
+		sum += block->sum;
+		sumlog += block->sumlog;
+		prod *= block->prod;
+		{	// pairwise update of the mean and the sum of squared deviations (Chan et al. 1979)
+			double delta = block->mean-mean;
+			double total = (double)n+block->n;
+			m2 += block->m2 + delta*delta*n*block->n/total;
+			mean += delta*block->n/total;
+		}
+		n += block->n;
+	}
+
+	switch (aggr->op) {
+	case AGGR_MIN:
+		numerator = min;
+		denominator = n>0;
+		break;
+	case AGGR_MAX:
+		numerator = max;
+		denominator = n>0;
+		break;
+	case AGGR_COUNT:
+		numerator = n;
+		denominator = n>0;
+		break;
+	case AGGR_MBE:
+		numerator = sum;
+		denominator = n;
+		secondary = mean;
+		break;
+	case AGGR_AVG:
+	case AGGR_MEAN:
+		numerator = sum;
+		denominator = n;
+		break;
+	case AGGR_SUM:
+		numerator = sum;
+		denominator = n>0;
+		break;
+	case AGGR_PROD:
+		numerator = prod;
+		denominator = n>0;
+		break;
+	case AGGR_GAMMA:
+		numerator = n;
+		denominator = sumlog;
+		secondary = min;
+		break;
+	case AGGR_STD:
+	case AGGR_VAR:
+		numerator = m2;
+		denominator = n;
+		break;
+	default:
+		break;
 	}
 	switch (aggr->op) {
-		double v = 0.0, t = 0.0, m = 0.0;
 	case AGGR_GAMMA:
 		return 1 + numerator/(denominator-numerator*log(secondary));
 	case AGGR_STD:
@@ -25,6 +25,13 @@ typedef struct s_aggregate {
 	AGGRPART part; /**< the property part (complex only) */
 	unsigned char flags; /**< aggregation flags (e.g., AF_ABS) */
 	struct s_findlist *last; /**< the result of the last run */
+	unsigned int n_members; /**< the number of objects in the compiled group */
+	struct s_object_list **member; /**< the objects in the compiled group */
+	void **addr; /**< the address of the property in each object of the compiled group */
+	double factor, offset; /**< the cached unit conversion (value*factor+offset) */
+	TIMESTAMP compiled; /**< the clock when the group was last compiled */
+	unsigned int n_blocks; /**< the number of blocks the compiled group is reduced in */
+	struct s_aggrblock *block; /**< the partial results of each block */
 	struct s_aggregate *next; /**< the next aggregation in the core's list of aggregators */
 } AGGREGATION; /**< the aggregation type */
 
@@ -17,6 +17,9 @@
 #include "enduse.h"
 #include "stream.h"
 #include "gldrandom.h"
+#include "hash.h"
+
+#include <pthread.h>
 
 #if defined(WIN32) && !defined(__MINGW32__)
 #define WIN32_LEAN_AND_MEAN		// Exclude rarely-used stuff from Windows headers
@@ -144,19 +147,79 @@ int property_create(PROPERTY *prop, void *addr)
 }
 #endif
 
-/* though improbable, this is to prevent more complicated, specifically crafted
-	inheritence loops.  these should be impossible if a class_register call is
-	immediately followed by a class_define_map call. -d3p988 */
-PROPERTY *class_find_property_rec(CLASS *oclass, 
-                                  PROPERTYNAME name, 
-                                  CLASS *pclass)
+/* the property index of a class is read without a lock, so it is published with release
+   semantics only once it is complete, and read with acquire semantics */
+#ifdef _MSC_VER
+	#define PHASH_LOAD(X) (*(HASHTABLE*volatile*)&(X))
+	#define PHASH_STORE(X,V) (*(HASHTABLE*volatile*)&(X)=(V))
+#else
+	#define PHASH_LOAD(X) __atomic_load_n(&(X),__ATOMIC_ACQUIRE)
+	#define PHASH_STORE(X,V) __atomic_store_n(&(X),(V),__ATOMIC_RELEASE)
+#endif
+
+/* indexes replaced by class_add_property, which other threads may still be searching */
+typedef struct s_retired_phash {
+	HASHTABLE *table;
+	struct s_retired_phash *next;
+} RETIREDPHASH;
+static RETIREDPHASH *retired_phash = NULL;
+
+/* get the index of the properties defined by a class (not including its parents) */
+static pthread_mutex_t phash_lock = PTHREAD_MUTEX_INITIALIZER;
+static HASHTABLE *class_get_property_index(CLASS *oclass)
+{
+	HASHTABLE *table = PHASH_LOAD(oclass->phash);
+	if ( table==NULL )
+	{
+		pthread_mutex_lock(&phash_lock);
+		if ( oclass->phash==NULL )
+		{
+			PROPERTY *prop;
+			table = hash_create(0);
+			for (prop=oclass->pmap; table!=NULL && prop!=NULL && prop->oclass==oclass; prop=prop->next)
+			{
+				/* the first property with a given name hides later ones */
+				if ( hash_find(table,prop->name)==NULL && !hash_insert(table,prop->name,prop) )
+				{
+					hash_destroy(table);
+					table = NULL;
+				}
+			}
+			PHASH_STORE(oclass->phash,table);
+		}
+		table = oclass->phash;
+		pthread_mutex_unlock(&phash_lock);
+	}
+	return table;
+}
+
+/* find a property defined by a class (not including its parents) */
+static PROPERTY *class_find_own_property(CLASS *oclass, PROPERTYNAME name)
 {
 	PROPERTY *prop;
+	HASHTABLE *table = class_get_property_index(oclass);
+	if ( table!=NULL )
+		return (PROPERTY*)hash_find(table,name);
+
+	/* index is not available so search the hard way */
 	for (prop=oclass->pmap; prop!=NULL && prop->oclass==oclass; prop=prop->next)
 	{
 		if (strcmp(name,prop->name)==0)
 			return prop;
 	}
+	return NULL;
+}
+
+/* though improbable, this is to prevent more complicated, specifically crafted
+	inheritence loops.  these should be impossible if a class_register call is
+	immediately followed by a class_define_map call. -d3p988 */
+PROPERTY *class_find_property_rec(CLASS *oclass, 
+                                  PROPERTYNAME name, 
+                                  CLASS *pclass)
+{
+	PROPERTY *prop = class_find_own_property(oclass,name);
+	if (prop!=NULL)
+		return prop;
 	if (oclass->parent==pclass)
 	{
 		output_error("class_find_property_rec(CLASS *oclass='%s', PROPERTYNAME name='%s', CLASS *pclass='%s') causes an infinite class inheritance loop", oclass->name, name, pclass->name);
@@ -193,22 +256,20 @@ PROPERTY *class_find_property(CLASS *oclass,     /**< the object class */
 	if(oclass == NULL)
 		return NULL;
 
-	for (prop=oclass->pmap; prop!=NULL && prop->oclass==oclass; prop=prop->next)
+	prop = class_find_own_property(oclass,name);
+	if (prop!=NULL)
 	{
-		if (strcmp(name,prop->name)==0)
+		if (prop->flags&PF_DEPRECATED && !(prop->flags&PF_DEPRECATED_NONOTICE) && !global_suppress_deprecated_messages)
 		{
-			if (prop->flags&PF_DEPRECATED && !(prop->flags&PF_DEPRECATED_NONOTICE) && !global_suppress_deprecated_messages)
-			{
-				output_warning("class_find_property(CLASS *oclass='%s', PROPERTYNAME name='%s': property is deprecated", oclass->name, name);
-				/* TROUBLESHOOT
-					You have done a search on a property that has been flagged as deprecated and will most likely not be supported soon.
-					Correct the usage of this property to get rid of this message.
-				 */
-				if (global_suppress_repeat_messages)
-					prop->flags |= ~PF_DEPRECATED_NONOTICE;
-			}
-			return prop;
+			output_warning("class_find_property(CLASS *oclass='%s', PROPERTYNAME name='%s': property is deprecated", oclass->name, name);
+			/* TROUBLESHOOT
+				You have done a search on a property that has been flagged as deprecated and will most likely not be supported soon.
+				Correct the usage of this property to get rid of this message.
+			 */
+			if (global_suppress_repeat_messages)
+				prop->flags |= ~PF_DEPRECATED_NONOTICE;
 		}
+		return prop;
 	}
 	if (oclass->parent==oclass)
 	{
@@ -237,6 +298,22 @@ void class_add_property(CLASS *oclass,  /**< the class to which the property is
 		oclass->pmap = prop;
 	else
 		last->next = prop;
+
+	/* the property index is rebuilt on the next lookup; the old one is kept
+	   because lookups in progress on other threads may still be using it */
+	pthread_mutex_lock(&phash_lock);
+	if (oclass->phash!=NULL)
+	{
+		RETIREDPHASH *item = malloc(sizeof(RETIREDPHASH));
+		if ( item!=NULL )
+		{
+			item->table = oclass->phash;
+			item->next = retired_phash;
+			retired_phash = item;
+		}
+		PHASH_STORE(oclass->phash,NULL);
+	}
+	pthread_mutex_unlock(&phash_lock);
 }
 
 /** Add an extended property to a class 
@@ -473,6 +550,7 @@ CLASS *class_register(MODULE *module,        /**< the module that implements the
 	oclass->profiler.numobjs=0;
 	oclass->profiler.count=0;
 	oclass->profiler.clocks=0;
+	oclass->profiler.init=0;
 	if (first_class==NULL)
 		first_class = oclass;
 	else
@@ -1144,16 +1222,17 @@ int class_saveall_xml(FILE *fp) /**< a pointer to the stream FILE structure */
 void class_profiles(void)
 {
 	CLASS *cl;
-	int64 total=0;
+	int64 total=0, init=0;
 	int count=0, i=0, hits;
 	CLASS **index;
 	output_profile("Model profiler results");
 	output_profile("======================\n");
-	output_profile("Class            Time (s) Time (%%) msec/obj");
-	output_profile("---------------- -------- -------- --------");
+	output_profile("Class            Time (s) Time (%%) msec/obj Init (s)");
+	output_profile("---------------- -------- -------- -------- --------");
 	for (cl=first_class; cl!=NULL; cl=cl->next)
 	{
 		total+=cl->profiler.clocks;
+		init+=cl->profiler.init;
 		count++;
 	}
 	if(0 == count){
@@ -1189,16 +1268,16 @@ void class_profiles(void)
 			double ts = (double)cl->profiler.clocks/CLOCKS_PER_SEC;
 			double tp = (double)cl->profiler.clocks/total*100;
 			double mt = ts/cl->profiler.numobjs*1000;
-			output_profile("%-16.16s %7.3f %8.1f%% %8.1f", cl->name, ts,tp,mt);
+			output_profile("%-16.16s %7.3f %8.1f%% %8.1f %8.3f", cl->name, ts,tp,mt,(double)cl->profiler.init/CLOCKS_PER_SEC);
 		}
 		else
 			break;
 	}
 	free(index);
 	index = NULL;
-	output_profile("================ ======== ======== ========");
-	output_profile("%-16.16s %7.3f %8.1f%% %8.1f\n",
-		"Total", (double)total/CLOCKS_PER_SEC,100.0,1000*(double)total/CLOCKS_PER_SEC/object_get_count());
+	output_profile("================ ======== ======== ======== ========");
+	output_profile("%-16.16s %7.3f %8.1f%% %8.1f %8.3f\n",
+		"Total", (double)total/CLOCKS_PER_SEC,100.0,1000*(double)total/CLOCKS_PER_SEC/object_get_count(),(double)init/CLOCKS_PER_SEC);
 
 }
 
@@ -42,6 +42,8 @@ typedef unsigned long PASSCONFIG; /**< the pass configuration */
 #define PC_ABSTRACTONLY 0x100 /**< used to flag that the class should never be instantiated itself, only inherited classes should */
 #define PC_AUTOLOCK 0x200 /**< used to flag that sync operations should not be automatically write locked */
 #define PC_OBSERVER 0x400 /**< used to flag whether commit process needs to be delayed with respect to ordinary "in-the-loop" objects */
+#define PC_PARALLEL_INIT 0x800 /**< used to flag that objects of this class may be initialized concurrently (init only writes to the object itself) */
+#define PC_SPARSE_SYNC 0x1000 /**< used to flag that objects of this class may sleep until their next event when sparse_sync is set (see PF_WAKEUP) */
 
 typedef enum {
 	NM_PREUPDATE = 0, /**< notify module before property change */
@@ -115,10 +117,13 @@ struct s_class_list {
 		int32 numobjs;
 		int64 clocks;
 		int32 count;
+		int64 init; /**< part of clocks spent in init */
 	} profiler;
 	TECHNOLOGYREADINESSLEVEL trl; // technology readiness level (1-9, 0=unknown)
 	bool has_runtime;	///< flag indicating that a runtime dll, so, or dylib is in use
 	char runtime[1024]; ///< name of file containing runtime dll, so, or dylib
+	struct s_hashtable *phash; ///< index of the properties defined by this class (built on first lookup)
+	struct s_objectpool *pool; ///< slabs the objects of this class are allocated from (see object.c)
 	struct s_class_list *next;
 }; /* CLASS */
 
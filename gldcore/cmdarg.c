@@ -336,6 +336,23 @@ static int mt_profile(int argc, char *argv[])
 		return CMDERR;
 	}
 }
+static int profile_trace(int argc, char *argv[])
+{
+	if ( argc>1 )
+	{
+		strncpy(global_profile_trace,*++argv,sizeof(global_profile_trace)-1);
+		return 1;
+	}
+	else
+	{
+		output_fatal("missing profile_trace file name");
+		/* TROUBLESHOOT
+			The --profile_trace option must be followed by the name of the file to which the timeline is written.
+			Add the file name and try again.
+		 */
+		return CMDERR;
+	}
+}
 static int pauseatexit(int argc, char *argv[])
 {
 	global_pauseatexit = !global_pauseatexit;
@@ -346,6 +363,11 @@ static int compile(int argc, char *argv[])
 	global_compileonly = !global_compileonly;
 	return 0;
 }
+static int use_image(int argc, char *argv[])
+{
+	global_use_image = !global_use_image;
+	return 0;
+}
 static int license(int argc, char *argv[])
 {
 	legal_license();
@@ -1227,6 +1249,7 @@ static CMDARG main[] = {
 	{"dumpall",		NULL,	dumpall,		NULL, "Dumps the global variable list" },
 	{"mt_profile",	NULL,	mt_profile,		"<n-threads>", "Analyses multithreaded performance profile" },
 	{"profile",		NULL,	profile,		NULL, "Toggles performance profiling of core and modules while simulation runs" },
+	{"profile_trace",	NULL,	profile_trace,	"<file>", "Writes a per-thread timeline of the run that Perfetto can display" },
 	{"quiet",		"q",	quiet,			NULL, "Toggles suppression of all but error and fatal messages" },
 	{"verbose",		"v",	verbose,		NULL, "Toggles output of verbose messages" },
 	{"warn",		"w",	warn,			NULL, "Toggles display of warning messages" },
@@ -1283,8 +1306,9 @@ static CMDARG main[] = {
 	{"avlbalance",	NULL,	avlbalance,		NULL, "Toggles automatic balancing of object index" },
 	{"bothstdout",	NULL,	bothstdout,		NULL, "Merges all output on stdout" },
 	{"check_version", NULL,	_check_version,	NULL, "Perform online version check to see if any updates are available" },
-	{"compile",		"C",	compile,		NULL, "Toggles compile-only flags" },
+	{"compile",		"C",	compile,		NULL, "Toggles compile-only flags (also writes the model image)" },
 	{"environment",	"e",	environment,	"<appname>", "Set the application to use for run environment" },
+	{"image",		NULL,	use_image,		NULL, "Toggles loading the model image written by --compile when it is current" },
 	{"output",		"o",	output,			"<file>", "Enables save of output to a file (default is gridlabd.glm)" },
 	{"pause",		NULL,	pauseatexit,			NULL, "Toggles pause-at-exit feature" },
 	{"relax",		NULL,	relax,			NULL, "Allows implicit variable definition when assignments are made" },
@@ -17,9 +17,25 @@
 #include "deltamode.h"
 #include "output.h"
 #include "realtime.h"
+#include "threadpool.h"
+#include "reduce.h"
 
 static OBJECT **delta_objectlist = NULL; /* qualified object list */
 static int delta_objectcount = 0; /* qualified object count */
+static int *delta_rankstart = NULL; /* start of each rank in the object list (last entry is delta_objectcount) */
+static int delta_rankcount = 0; /* number of non-empty ranks in the object list */
+static WSPOOL *delta_pool = NULL; /* worker pool for parallel object updates */
+
+/* parallel update state */
+typedef struct s_deltaresult {
+	SIMULATIONMODE mode; /* merged result of this worker's updates */
+	OBJECT *failed; /* first object that failed on this worker */
+} DELTARESULT;
+static DELTARESULT *delta_result = NULL; /* one result per pool worker */
+typedef struct s_deltaargs {
+	DT timestep;
+	unsigned int iteration_count;
+} DELTAARGS;
 static MODULE **delta_modulelist = NULL; /* qualified module list */
 static int delta_modulecount = 0; /* qualified module count */
 
@@ -180,11 +196,31 @@ STATUS delta_init(void)
 		}
 	}
 
+	/* allocate rank boundaries */
+	for ( n=0 ; n<=toprank ; n++)
+	{
+		if ( rankcount[n]>0 )
+			delta_rankcount++;
+	}
+	delta_rankstart = (int*)malloc(sizeof(int)*(delta_rankcount+1));
+	if ( 0 == delta_rankstart ){
+		output_error("unable to allocate memory for deltamode rank boundaries");
+		/* TROUBLESHOOT
+		  Deltamode operation requires more memory than is available.
+		  Try freeing up memory by making more heap available or making the model smaller. 
+		 */
+		return FAILED;
+	}
+
 	/* build final object list */
 	pObj = delta_objectlist;
+	delta_rankcount = 0;
 	for ( n=0 ; n<=toprank ; n++)
 	{
 		int m;
+		if ( rankcount[n]>0 ){
+			delta_rankstart[delta_rankcount++] = (int)(pObj - delta_objectlist);
+		}
 		for ( m=0 ; m<rankcount[n] ; m++ ){
 			*pObj++ = ranklist[n][m];
 		}
@@ -199,6 +235,34 @@ STATUS delta_init(void)
 	rankcount = NULL;
 	free(ranklist);
 	ranklist = NULL;
+	delta_rankstart[delta_rankcount] = delta_objectcount;
+
+	/* start the update workers */
+	if ( global_deltamode_threadcount!=1 && delta_objectcount>1 )
+	{
+		unsigned int n_threads = global_deltamode_threadcount>0 ? global_deltamode_threadcount : global_threadcount;
+		if ( n_threads==0 )
+			n_threads = processor_count();
+		if ( n_threads>1 )
+		{
+			delta_pool = wsp_create("deltamode",n_threads,0);
+			if ( delta_pool!=NULL )
+				delta_result = (DELTARESULT*)malloc(sizeof(DELTARESULT)*wsp_count(delta_pool));
+			if ( delta_pool==NULL || delta_result==NULL )
+			{
+				output_warning("deltamode worker pool could not be started - using serial updates");
+				/* TROUBLESHOOT
+				  The threads used to update deltamode objects in parallel could not be created.
+				  Deltamode will continue to update objects one at a time.  Reduce the value of
+				  deltamode_threadcount or free up system resources to use parallel updates.
+				 */
+				wsp_destroy(delta_pool);
+				delta_pool = NULL;
+			}
+			else
+				output_verbose("deltamode updates use %d threads over %d ranks", wsp_count(delta_pool), delta_rankcount);
+		}
+	}
 Success:
 	profile.t_init += clock() - t;
 	return SUCCESS;
@@ -237,22 +301,125 @@ DT delta_modedesired(DELTAMODEFLAGS *flags)
 	return dt_desired;
 }
 
+/* merge an object update result into the pass result (SM_DELTA_ITER trumps SM_DELTA trumps SM_EVENT) */
+static SIMULATIONMODE delta_merge(SIMULATIONMODE mode, SIMULATIONMODE result)
+{
+	switch ( result ) {
+		case SM_DELTA_ITER:
+			return SM_DELTA_ITER;
+		case SM_DELTA:
+			return mode==SM_DELTA_ITER ? SM_DELTA_ITER : SM_DELTA;
+		case SM_EVENT:
+		default: /* mode remains untouched */
+			return mode;
+	}
+}
+
+/* update a single object if it is in service */
+static SIMULATIONMODE delta_objectcall(OBJECT *d_obj, DT timestep, unsigned int iteration_count)
+{
+	CLASS *d_oclass = d_obj->oclass;
+
+	/* See if the object is in service or not */
+	if ((d_obj->in_svc_double <= global_delta_curr_clock) && (d_obj->out_svc_double >= global_delta_curr_clock))
+	{
+		if ( d_oclass->update )	/* Make sure it exists - init should handle this */
+		{
+			/* Call the object-level interupdate */
+			return d_oclass->update(d_obj,global_clock,global_deltaclock,timestep,iteration_count);
+		}
+	}
+	/* Defaulted else, skip over it (not in service) */
+	return SM_EVENT;
+}
+
+/* pool callback for parallel object updates */
+static void delta_objectcall_worker(unsigned int thread, void *item, void *arg)
+{
+	DELTAARGS *args = (DELTAARGS*)arg;
+	DELTARESULT *result = &delta_result[thread];
+	SIMULATIONMODE mode = delta_objectcall((OBJECT*)item,args->timestep,args->iteration_count);
+	if ( mode==SM_ERROR )
+	{
+		if ( result->failed==NULL )
+			result->failed = (OBJECT*)item;
+	}
+	else if ( mode!=SM_EVENT && mode!=result->mode )
+		result->mode = delta_merge(result->mode,mode);
+}
+
+/* run the update of every deltamode object and return the merged mode (SM_ERROR on failure) */
+static SIMULATIONMODE delta_objectupdate(DT timestep, unsigned int iteration_count)
+{
+	char temp_name_buff[64];
+	SIMULATIONMODE interupdate_mode = SM_EVENT; /* Assume we are ready to go on, initially */
+	int n;
+
+	if ( delta_pool==NULL )
+	{
+		for ( n=0 ; n<delta_objectcount ; n++ )
+		{
+			OBJECT *d_obj = delta_objectlist[n];	/* Shouldn't need NULL checks, since they were done above */
+			SIMULATIONMODE result = delta_objectcall(d_obj,timestep,iteration_count);
+			if ( result==SM_ERROR )
+			{
+				output_error("delta_update(): update failed for object \'%s\'", object_name(d_obj, temp_name_buff, 63));
+				/* TROUBLESHOOT
+				   An object failed to update correctly while operating in deltamode.
+				   Generally, this is an internal error and should be reported to the GridLAB-D developers.
+				 */
+				return SM_ERROR;
+			}
+			interupdate_mode = delta_merge(interupdate_mode,result);
+		}
+	}
+	else
+	{
+		/* objects of the same rank are updated concurrently, ranks are updated in order */
+		DELTAARGS args = {timestep, iteration_count};
+		unsigned int n_workers = wsp_count(delta_pool), w;
+		for ( w=0 ; w<n_workers ; w++ )
+		{
+			delta_result[w].mode = SM_EVENT;
+			delta_result[w].failed = NULL;
+		}
+		for ( n=0 ; n<delta_rankcount ; n++ )
+		{
+			int first = delta_rankstart[n];
+			reduce_begin();
+			wsp_run(delta_pool,(void**)(delta_objectlist+first),delta_rankstart[n+1]-first,delta_objectcall_worker,&args);
+			reduce_end();
+			for ( w=0 ; w<n_workers ; w++ )
+			{
+				if ( delta_result[w].failed!=NULL )
+				{
+					output_error("delta_update(): update failed for object \'%s\'", object_name(delta_result[w].failed, temp_name_buff, 63));
+					/* TROUBLESHOOT
+					   An object failed to update correctly while operating in deltamode.
+					   Generally, this is an internal error and should be reported to the GridLAB-D developers.
+					 */
+					return SM_ERROR;
+				}
+			}
+		}
+		for ( w=0 ; w<n_workers ; w++ )
+			interupdate_mode = delta_merge(interupdate_mode,delta_result[w].mode);
+	}
+	return interupdate_mode;
+}
+
 /** Run a series of delta mode updates until mode changes back to event mode
 	@return number of seconds to advance clock
  **/
 DT delta_update(void)
 {
-	char temp_name_buff[64];
 	clock_t t = clock();
 	DT seconds_advance, timestep;
 	DELTAT temp_time;
 	unsigned int delta_iteration_remaining, delta_iteration_count, delta_forced_iteration, delta_federation_iteration_remaining;
 	SIMULATIONMODE interupdate_mode, interupdate_mode_result, clockupdate_result;
-	int n;
 	double dbl_stop_time;
 	double dbl_curr_clk_time;
-	OBJECT *d_obj = NULL;
-	CLASS *d_oclass = NULL;
 
 	/* send preupdate messages */
 	timestep=delta_preupdate();
@@ -306,48 +473,10 @@ DT delta_update(void)
 			/* Begin deltamode iteration loop */
 			while (delta_iteration_remaining>0) /* Iterate on this delta timestep */
 			{
-				/* Assume we are ready to go on, initially */
-				interupdate_mode = SM_EVENT;
-
 				/* Loop through objects with their individual updates */
-				for ( n=0 ; n<delta_objectcount ; n++ )
-				{
-					d_obj = delta_objectlist[n];	/* Shouldn't need NULL checks, since they were done above */
-					d_oclass = d_obj->oclass;
-
-					/* See if the object is in service or not */
-					if ((d_obj->in_svc_double <= global_delta_curr_clock) && (d_obj->out_svc_double >= global_delta_curr_clock))
-					{
-						if ( d_oclass->update )	/* Make sure it exists - init should handle this */
-						{
-							/* Call the object-level interupdate */
-							interupdate_mode_result = d_oclass->update(d_obj,global_clock,global_deltaclock,timestep,delta_iteration_count);
-
-							/* Check the status and handle appropriately */
-							switch ( interupdate_mode_result ) {
-								case SM_DELTA_ITER:
-									interupdate_mode = SM_DELTA_ITER;
-									break;
-								case SM_DELTA:
-									if (interupdate_mode != SM_DELTA_ITER)
-										interupdate_mode = SM_DELTA;
-									/* default else - leave it as is (SM_DELTA_ITER) */
-									break;
-								case SM_ERROR:
-									output_error("delta_update(): update failed for object \'%s\'", object_name(d_obj, temp_name_buff, 63));
-									/* TROUBLESHOOT
-									   An object failed to update correctly while operating in deltamode.
-									   Generally, this is an internal error and should be reported to the GridLAB-D developers.
-									 */
-									return DT_INVALID;
-								case SM_EVENT:
-								default: /* mode remains untouched */
-									break;
-							}
-						} /*End update exists */
-					}/* End in service */
-					/* Defaulted else, skip over it (not in service) */
-				}
+				interupdate_mode = delta_objectupdate(timestep,delta_iteration_count);
+				if ( interupdate_mode == SM_ERROR )
+					return DT_INVALID;
 
 				/* send interupdate messages */
 				interupdate_mode_result = delta_interupdate(timestep,delta_iteration_count);
@@ -133,6 +133,9 @@
 #include "test.h"
 #include "link.h"
 #include "save.h"
+#include "reduce.h"
+#include "timeline.h"
+#include "sparse.h"
 
 #include "pthread.h"
 
@@ -259,6 +262,7 @@ clock_t cstart, cend;
 static struct thread_data *thread_data = NULL;
 static INDEX **ranks = NULL;
 const PASSCONFIG passtype[] = {PC_PRETOPDOWN, PC_BOTTOMUP, PC_POSTTOPDOWN};
+static const char *passname[] = {"presync", "sync", "postsync"}; /* names of the passes in the profiler timeline */
 static unsigned int pass;
 int iteration_counter = 0;   /* number of redos completed */
 int federation_iteration_counter = 0; /* number of federate redos completed */
@@ -268,22 +272,25 @@ int64 rlock_count = 0, rlock_spin = 0;
 int64 wlock_count = 0, wlock_spin = 0;
 #endif
 
-extern pthread_mutex_t mls_inst_lock;
-extern pthread_cond_t mls_inst_signal;
-
-//sjin: struct for pthread_create arguments
-struct arg_data {
-	int thread;
-	void *item;
-	int incr;
-};
-struct arg_data arg_data_array[2];
+static WSPOOL *sync_pool = NULL; /* persistent worker pool for rank passes */
 
 INDEX **exec_getranks(void)
 {
 	return ranks;
 }
 
+/* rank sort order used when sort_ranks is set (by class, then by id) */
+static int rank_compare(const void *a, const void *b)
+{
+	OBJECT *obj1 = *(OBJECT**)a;
+	OBJECT *obj2 = *(OBJECT**)b;
+	if (obj1->oclass->id != obj2->oclass->id)
+		return obj1->oclass->id < obj2->oclass->id ? -1 : 1;
+	if (obj1->id != obj2->id)
+		return obj1->id < obj2->id ? -1 : 1;
+	return 0;
+}
+
 static STATUS setup_ranks(void)
 {
 	OBJECT *obj;
@@ -321,6 +328,10 @@ static STATUS setup_ranks(void)
 
 			/* shuffle the objects in the index */
 			index_shuffle(ranks[i]);
+
+		/* build the contiguous arrays used by the sync loops */
+		if (index_freeze(ranks[i],global_sortranks?rank_compare:NULL)==FAILED)
+			return FAILED;
 	}
 
 	return SUCCESS;
@@ -509,6 +520,10 @@ static void ss_do_object_sync(int thread, void *item)
 	else 
 		this_t = TS_NEVER; /* already out of service */
 
+	/* remember when a sleeping object is due again */
+	if (sparse_active)
+		sparse_record(obj,this_t);
+
 	/* check for "soft" event (events that are ignored when stopping) */
 	if (this_t < -1)
 		this_t = -this_t;
@@ -556,25 +571,10 @@ static void ss_do_object_sync(int thread, void *item)
 	}
 }
 
-//sjin: implement new ss_do_object_sync_list for pthreads
-static void *ss_do_object_sync_list(void *threadarg)
+/* work-stealing pool call for object sync */
+static void ss_do_object_sync_call(unsigned int thread, void *item, void *arg)
 {
-	LISTITEM *ptr;
-	int iPtr;
-
-	struct arg_data *mydata = (struct arg_data *) threadarg;
-	int thread = mydata->thread;
-	void *item = mydata->item;
-	int incr = mydata->incr;
-
-	iPtr = 0;
-	for (ptr = item; ptr != NULL; ptr=ptr->next) {
-		if (iPtr < incr) {
-			ss_do_object_sync(thread, ptr->data);
-			iPtr++;
-		}
-	}
-	return NULL;
+	ss_do_object_sync(thread,item);
 }
 
 static STATUS init_by_creation()
@@ -823,6 +823,173 @@ static int init_by_deferral()
 	return SUCCESS;
 }
 
+/* an object waiting to be initialized by rank, and the result of its last attempt */
+typedef struct s_initrank {
+	OBJECT *obj;
+	int rv; /**< -1 until the object is tried */
+} INITRANK;
+
+/* work-stealing pool call for object init */
+static void init_by_rank_call(unsigned int thread, void *item, void *arg)
+{
+	INITRANK *init = (INITRANK*)item;
+	init->rv = object_init(init->obj);
+}
+
+/** Initialize objects top-down, in waves.  Each wave holds every object
+	whose parent is already initialized, so a parent always finishes before
+	its children start.  Objects of classes registered with PC_PARALLEL_INIT
+	are initialized concurrently when more than one thread is available; all
+	others are initialized one at a time in creation order once the
+	concurrent ones are done.  An object that defers (returns 2) is tried
+	again in the next wave, and its children wait for it.
+ **/
+static int init_by_rank(void)
+{
+	size_t n_objects = object_get_count(), n_pending = 0, n_ready, n_parallel, i;
+	INITRANK *pending = (INITRANK*)malloc(sizeof(INITRANK)*n_objects);
+	void **ready = (void**)malloc(sizeof(void*)*n_objects);
+	WSPOOL *pool = NULL;
+	OBJECT *obj;
+	STATUS rv = SUCCESS;
+	int tries = 0;
+	char b[64];
+
+	if (pending == NULL || ready == NULL)
+	{
+		output_error("init_by_rank(): failed to allocate memory");
+		free(pending);
+		free(ready);
+		return FAILED;
+	}
+	for (obj = object_get_first(); obj != NULL; obj = obj->next)
+	{
+		pending[n_pending].obj = obj;
+		pending[n_pending].rv = -1;
+		n_pending++;
+	}
+	if (global_threadcount > 1)
+	{
+		pool = wsp_create("init",global_threadcount,0);
+		if (pool == NULL)
+			output_warning("init worker pool creation failed - initializing objects on one thread");
+	}
+
+	while (n_pending > 0 && rv == SUCCESS)
+	{
+		size_t n_init = 0, n_deferred = 0, n_waiting = 0;
+
+		/* objects that may run concurrently go first, the rest follow in creation order */
+		n_ready = 0;
+		for (i = 0; i < n_pending; i++)
+		{
+			obj = pending[i].obj;
+			if ((obj->parent == NULL || (obj->parent->flags & OF_INIT) == OF_INIT)
+				&& pool != NULL && (obj->oclass->passconfig & PC_PARALLEL_INIT) == PC_PARALLEL_INIT)
+				ready[n_ready++] = pending+i;
+		}
+		n_parallel = n_ready;
+		for (i = 0; i < n_pending; i++)
+		{
+			obj = pending[i].obj;
+			if ((obj->parent == NULL || (obj->parent->flags & OF_INIT) == OF_INIT)
+				&& !(pool != NULL && (obj->oclass->passconfig & PC_PARALLEL_INIT) == PC_PARALLEL_INIT))
+				ready[n_ready++] = pending+i;
+		}
+		if (n_ready == 0)
+		{
+			output_error("init_by_rank(): %d objects are waiting on parents that cannot be initialized", (int)n_pending);
+			/* TROUBLESHOOT
+				Every object that has not been initialized has a parent that has not been initialized either.
+				This happens when the parent relationships form a loop.  Check the parents of the objects in
+				the model and try again.
+			 */
+			rv = FAILED;
+			break;
+		}
+
+		if (n_parallel > 0)
+			wsp_run(pool,ready,n_parallel,init_by_rank_call,NULL);
+		for (i = n_parallel; i < n_ready; i++)
+			init_by_rank_call(0,ready[i],NULL);
+
+		/* record the results in creation order and keep what is left for the next wave */
+		for (i = 0; i < n_pending; i++)
+		{
+			INITRANK *init = pending+i;
+			obj = init->obj;
+			if (init->rv == -1) /* not in this wave */
+			{
+				pending[n_waiting++] = *init;
+				continue;
+			}
+			switch (init->rv)
+			{
+				case 0:
+					rv = FAILED;
+					memset(b, 0, 64);
+					output_error("init_by_rank(): object %s initialization failed", object_name(obj, b, 63));
+					break;
+				case 1:
+					wlock(&obj->lock);
+					obj->flags |= OF_INIT;
+					obj->flags &= ~OF_DEFERRED;
+					wunlock(&obj->lock);
+					n_init++;
+					break;
+				case 2:
+					wlock(&obj->lock);
+					obj->flags |= OF_DEFERRED;
+					wunlock(&obj->lock);
+					init->rv = -1;
+					pending[n_waiting++] = *init;
+					n_deferred++;
+					break;
+				// no default
+			}
+			if (rv == FAILED)
+				break;
+		}
+		if (rv == FAILED)
+			break;
+		n_pending = n_waiting;
+
+		if (n_init == 0)
+		{
+			output_error("init_by_rank(): all uninitialized objects deferred, model is unable to initialize");
+			rv = FAILED;
+		}
+		else if (n_deferred > 0 && ++tries > global_init_max_defer)
+		{
+			output_error("init_by_rank(): exhausted initialization attempts");
+			rv = FAILED;
+		}
+	}
+
+	if (pool != NULL)
+		wsp_destroy(pool);
+	free(pending);
+	free(ready);
+	if (rv == FAILED)
+		return FAILED;
+
+	for (obj = object_get_first(); obj != NULL; obj = obj->next)
+	{
+		if ((obj->oclass->passconfig & PC_FORCE_NAME) == PC_FORCE_NAME)
+		{
+			if (0 == strcmp(obj->name, ""))
+			{
+				output_warning("init: object %s:%d should have a name, but doesn't", obj->oclass->name, obj->id);
+				/* TROUBLESHOOT
+				   The object indicated has been flagged by the module which implements its class as one which must be named
+				   to work properly.  Please provide the object with a name and try again.
+				 */
+			}
+		}
+	}
+	return SUCCESS;
+}
+
 OBJECT **object_heartbeats = NULL;
 unsigned int n_object_heartbeats = 0;
 unsigned int max_object_heartbeats = 0;
@@ -854,8 +1021,7 @@ static STATUS init_all(void)
 			rv = FAILED;
 			break;
 		case IS_TOPDOWN:
-			output_fatal("Top-down rank-based initialization mode not yet supported");
-			rv = FAILED;
+			rv = init_by_rank();
 			break;
 		default:
 			output_fatal("Unrecognized initialization mode");
@@ -906,51 +1072,58 @@ static STATUS init_all(void)
  *		of a timestep, before the sync process.  This callback is only triggered
  *		once per timestep, and will not fire between iterations.
  */
-typedef struct s_simplelinklist { 
-	void *data;
-	struct s_simplelinklist *next;
-} SIMPLELINKLIST;
+
+/* build a contiguous array of the objects accepted by test(), most recently created first */
+static STATUS build_object_array(INDEXARRAY *list, int (*test)(OBJECT*,void*), void *arg, const char *what)
+{
+	OBJECT *obj;
+	size_t n = 0;
+	for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+		if ( test(obj,arg) ) n++;
+	list->size = n;
+	list->item = NULL;
+	if ( n==0 )
+		return SUCCESS;
+	list->item = (void**)malloc(sizeof(void*)*n);
+	if ( list->item==NULL )
+	{
+		output_error("%s list memory allocation failed", what);
+		/* TROUBLESHOOT
+		   Insufficient memory remains to build the list of objects that
+		   implement the named operation.  Free up memory and try again.
+		 */
+		return FAILED;
+	}
+	for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+		if ( test(obj,arg) ) list->item[--n] = (void*)obj;
+	return SUCCESS;
+}
 
 /**************************************************************************
  ** PRECOMMIT ITERATOR
  **************************************************************************/
+static int has_precommit(OBJECT *obj, void *arg)
+{
+	return obj->oclass->precommit!=NULL;
+}
 static STATUS precommit_all(TIMESTAMP t0)
 {
 	STATUS rv=SUCCESS;
 	static int first=1;
 	/* TODO implement this multithreaded */
-	static SIMPLELINKLIST *precommit_list = NULL;
-	SIMPLELINKLIST *item;
+	static INDEXARRAY precommit_list = {NULL,0};
+	size_t n;
 	if ( first )
 	{
-		OBJECT *obj;
-		for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
-		{
-			if ( obj->oclass->precommit!=NULL )
-			{
-				item = (SIMPLELINKLIST*)malloc(sizeof(SIMPLELINKLIST));
-				if ( item==NULL )
-				{
-					char name[64];
-					output_error("object %s precommit memory allocation failed", object_name(obj,name,sizeof(name)-1));
-					/* TROUBLESHOOT
-					   Insufficient memory remains to perform the precommit operation.
-					   Free up memory and try again.
-					 */
-					return FAILED;
-				}
-				item->data = (void*)obj;
-				item->next = precommit_list;
-				precommit_list = item;
-			}
-		}
+		if ( build_object_array(&precommit_list,has_precommit,NULL,"precommit")==FAILED )
+			return FAILED;
 		first = 0;
 	}
 
 	TRY {
-		for ( item=precommit_list ; item!=NULL ; item=item->next )
+		for ( n=0 ; n<precommit_list.size ; n++ )
 		{
-			OBJECT *obj = (OBJECT*)item->data;
+			OBJECT *obj = (OBJECT*)precommit_list.item[n];
 			if ((obj->in_svc <= t0 && obj->out_svc >= t0) && (obj->in_svc_micro >= obj->out_svc_micro))
 			{
 				if ( object_precommit(obj, t0)==FAILED )
@@ -983,51 +1156,44 @@ static STATUS precommit_all(TIMESTAMP t0)
 /**************************************************************************
  ** COMMIT ITERATOR
  **************************************************************************/
-static SIMPLELINKLIST *commit_list[2] = {NULL, NULL};
+static INDEXARRAY commit_list[2] = {{NULL,0}, {NULL,0}};
+/* commit_list selector (observers are separated) */
+static int has_commit(OBJECT *obj, void *arg)
+{
+	unsigned int pc = ((obj->oclass->passconfig&PC_OBSERVER)==PC_OBSERVER)?1:0;
+	return obj->oclass->commit!=NULL && pc==*(unsigned int*)arg;
+}
 /* initialize commit_list - must be called only once */
 static int commit_init(void)
 {
-	int n_commits = 0;
-	OBJECT *obj;
-	SIMPLELINKLIST *item;
+	unsigned int pc;
 
 	/* build commit list */
-	for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+	for ( pc=0 ; pc<2 ; pc++ )
 	{
-		if ( obj->oclass->commit!=NULL )
-		{
-			/* separate observers */
-			unsigned int pc = ((obj->oclass->passconfig&PC_OBSERVER)==PC_OBSERVER)?1:0;
-			item = (SIMPLELINKLIST*)malloc(sizeof(SIMPLELINKLIST));
-			if ( item==NULL ) 
-				throw_exception("commit_init memory allocation failure");
-			item->data = (void*)obj;
-			item->next = commit_list[pc];
-			commit_list[pc] = item;
-			n_commits++;
-		}
+		if ( build_object_array(&commit_list[pc],has_commit,&pc,"commit")==FAILED )
+			throw_exception("commit_init memory allocation failure");
 	}
-	return n_commits;
+	return (int)(commit_list[0].size + commit_list[1].size);
+}
+/* commit_list iterator (items are pointers into the commit array) */
+static MTIITEM commit_get(INDEXARRAY *list, MTIITEM item)
+{
+	void **next = ( item==NULL ) ? list->item : ((void**)item)+1;
+	return ( next!=NULL && next<list->item+list->size ) ? (MTIITEM)next : NULL;
 }
-/* commit_list iterator */
 static MTIITEM commit_get0(MTIITEM item)
 {
-	if ( item==NULL )
-		return (MTIITEM)commit_list[0];
-	else
-		return (MTIITEM)(((SIMPLELINKLIST*)item)->next);
+	return commit_get(&commit_list[0],item);
 }
 static MTIITEM commit_get1(MTIITEM item)
 {
-	if ( item==NULL )
-		return (MTIITEM)commit_list[1];
-	else
-		return (MTIITEM)(((SIMPLELINKLIST*)item)->next);
+	return commit_get(&commit_list[1],item);
 }
 /* commit function call */
 static void commit_call(MTIDATA output, MTIITEM item, MTIDATA input)
 {
-	OBJECT *obj = (OBJECT*)(((SIMPLELINKLIST*)item)->data);
+	OBJECT *obj = *(OBJECT**)item;
 	TIMESTAMP *t2 = (TIMESTAMP*)output;
 	TIMESTAMP *t0 = (TIMESTAMP*)input;
 	if ( *t0<obj->in_svc )
@@ -1082,13 +1248,13 @@ static int commit_reject(MTI *mti, MTIDATA value)
 static TIMESTAMP commit_all_st(TIMESTAMP t0, TIMESTAMP t2)
 {
 	TIMESTAMP result = TS_NEVER;
-	SIMPLELINKLIST *item;
+	size_t n;
 	unsigned int pc;
 	for ( pc=0 ; pc<2 ; pc ++ )
 	{
-		for ( item=commit_list[pc] ; item!=NULL ; item=item->next )
+		for ( n=0 ; n<commit_list[pc].size ; n++ )
 		{
-			OBJECT *obj = (OBJECT*)item->data;
+			OBJECT *obj = (OBJECT*)commit_list[pc].item[n];
 			if ( t0<obj->in_svc )
 			{
 				if ( obj->in_svc<result ) result = obj->in_svc;
@@ -1184,43 +1350,28 @@ static TIMESTAMP commit_all(TIMESTAMP t0, TIMESTAMP t2)
 /**************************************************************************
  ** FINALIZE ITERATOR
  **************************************************************************/
+static int has_finalize(OBJECT *obj, void *arg)
+{
+	return obj->oclass->finalize!=NULL;
+}
 static STATUS finalize_all()
 {
 	STATUS rv=SUCCESS;
 	static int first=1;
 	/* TODO implement this multithreaded */
-	static SIMPLELINKLIST *finalize_list = NULL;
-	SIMPLELINKLIST *item;
+	static INDEXARRAY finalize_list = {NULL,0};
+	size_t n;
 	if ( first )
 	{
-		OBJECT *obj;
-		for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
-		{
-			if ( obj->oclass->finalize!=NULL )
-			{
-				item = (SIMPLELINKLIST*)malloc(sizeof(SIMPLELINKLIST));
-				if ( item==NULL )
-				{
-					char name[64];
-					output_error("object %s finalize memory allocation failed", object_name(obj,name,sizeof(name)-1));
-					/* TROUBLESHOOT
-					   Insufficient memory remains to perform the finalize operation.
-					   Free up memory and try again.
-					 */
-					return FAILED;
-				}
-				item->data = (void*)obj;
-				item->next = finalize_list;
-				finalize_list = item;
-			}
-		}
+		if ( build_object_array(&finalize_list,has_finalize,NULL,"finalize")==FAILED )
+			return FAILED;
 		first = 0;
 	}
 
 	TRY {
-		for ( item=finalize_list ; item!=NULL ; item=item->next )
+		for ( n=0 ; n<finalize_list.size ; n++ )
 		{
-			OBJECT *obj = (OBJECT*)item->data;
+			OBJECT *obj = (OBJECT*)finalize_list.item[n];
 			if ( object_finalize(obj)==FAILED )
 			{
 				char name[64];
@@ -1266,15 +1417,11 @@ STATUS t_sync_all(PASSCONFIG pass)
 		/* process object in order of rank using index */
 		for (i = PASSINIT(pass_index); PASSCMP(i, pass_index); i += PASSINC(pass_index))
 		{
-			LISTITEM *item;
-			/* skip empty lists */
-			if (ranks[pass_index]->ordinal[i] == NULL) 
-				continue;
-			
-			
-			for (item=ranks[pass_index]->ordinal[i]->first; item!=NULL; item=item->next)
+			INDEXARRAY *rank = &(ranks[pass_index]->frozen[i]);
+			size_t n;
+			for (n = 0; n < rank->size; n++)
 			{
-				OBJECT *obj = item->data;
+				OBJECT *obj = rank->item[n];
 				if (exec_test(&sync,pass,obj)==FAILED)
 					return FAILED;
 			}
@@ -1350,68 +1497,63 @@ void exec_sleep(unsigned int usec)
 #endif
 }
 
-typedef struct s_objsyncdata {
-	unsigned int n; // thread id 0~n_threads for this object rank list
-	pthread_t pt;
-	bool ok;
-	//void *item;
-	LISTITEM *ls;
-	unsigned int nObj; // number of obj in this object rank list
-	unsigned int t0;
-	int i; // index of mutex or cond this object rank list uses 
-} OBJSYNCDATA;
-
-static pthread_mutex_t *startlock;
-static pthread_mutex_t *donelock;
-static pthread_cond_t *start;
-static pthread_cond_t *done;
+/** SNAPSHOTS **************************************************************************/
 
-static unsigned int *next_t1;
-static unsigned int *donecount;
-static unsigned int *n_threads; //number of thread used in the threadpool of an object rank list
+/* Readers that need every object at the same pass (e.g., bulk server
+   requests) ask the main loop to stop at the top of its next pass and hold
+   it there until they are all done.  When the main loop is not running the
+   model does not change, so readers go ahead at once. */
+static pthread_mutex_t snapshot_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t snapshot_signal = PTHREAD_COND_INITIALIZER;
+static volatile unsigned int snapshot_wanted = 0; /**< readers holding or waiting for a snapshot */
+static int snapshot_running = 0; /**< main loop may change the model */
+static int snapshot_held = 0; /**< main loop is stopped for readers */
 
-static void *obj_syncproc(void *ptr)
+/* readers that started while the main loop was stopped finish before it goes on */
+static void exec_snapshot_running(int running)
 {
-	OBJSYNCDATA *data = (OBJSYNCDATA*)ptr;
-	LISTITEM *s;
-	unsigned int n;
-	int i = data->i;
-
-	// begin processing loop
-	while (data->ok)
-	{
-		// lock access to start condition
-		pthread_mutex_lock(&startlock[i]);
-
-		// wait for thread start condition)
-		while (data->t0 == next_t1[i]) 
-			pthread_cond_wait(&start[i], &startlock[i]);
-		// unlock access to start count
-		pthread_mutex_unlock(&startlock[i]);
-
-		// process the list for this thread
-		for (s=data->ls, n=0; s!=NULL, n<data->nObj; s=s->next,n++) {
-			OBJECT *obj = s->data;
-			ss_do_object_sync(data->n, s->data);
-		}
-
-		// signal completed condition
-		data->t0 = next_t1[i];
-
-		// lock access to done condition
-		pthread_mutex_lock(&donelock[i]);
+	pthread_mutex_lock(&snapshot_lock);
+	while ( running && snapshot_wanted>0 )
+		pthread_cond_wait(&snapshot_signal,&snapshot_lock);
+	snapshot_running = running;
+	pthread_cond_broadcast(&snapshot_signal);
+	pthread_mutex_unlock(&snapshot_lock);
+}
 
-		// signal thread is done for now
-		donecount[i] --; 
+/* called by the main loop between passes */
+static void exec_snapshot_point(void)
+{
+	if ( snapshot_wanted==0 )
+		return;
+	pthread_mutex_lock(&snapshot_lock);
+	snapshot_held = 1;
+	pthread_cond_broadcast(&snapshot_signal);
+	while ( snapshot_wanted>0 )
+		pthread_cond_wait(&snapshot_signal,&snapshot_lock);
+	snapshot_held = 0;
+	pthread_mutex_unlock(&snapshot_lock);
+}
 
-		// signal change in done condition
-		pthread_cond_broadcast(&done[i]);
+/** Stop the main loop between passes so the model can be read consistently.
+	Each call must be matched by a call to exec_snapshot_end().
+ **/
+void exec_snapshot_begin(void)
+{
+	pthread_mutex_lock(&snapshot_lock);
+	snapshot_wanted++;
+	while ( snapshot_running && !snapshot_held )
+		pthread_cond_wait(&snapshot_signal,&snapshot_lock);
+	pthread_mutex_unlock(&snapshot_lock);
+}
 
-		//unlock access to done count
-		pthread_mutex_unlock(&donelock[i]);
-	}
-	pthread_exit((void*)0);
-	return (void*)0;
+/** Let the main loop continue once the last reader is done
+ **/
+void exec_snapshot_end(void)
+{
+	pthread_mutex_lock(&snapshot_lock);
+	if ( --snapshot_wanted==0 )
+		pthread_cond_broadcast(&snapshot_signal);
+	pthread_mutex_unlock(&snapshot_lock);
 }
 
 /** MAIN LOOP CONTROL ******************************************************************/
@@ -1733,18 +1875,10 @@ STATUS exec_start(void)
 	int pc_rv = 0; // precommit return value
 	STATUS fnl_rv = 0; // finalize all return value
 	time_t started_at = realtime_now(); // for profiler
-	int j, k;
-	LISTITEM *ptr;
-	int incr;
-	struct arg_data *arg_data_array;
+	int64 tl; // start of the current profiler timeline event
+	int j;
 
-	// Only setup threadpool for each object rank list at the first iteration;
-	// After the first iteration, setTP = false;
-	bool setTP = true; 
-	//int n_threads; //number of thread used in the threadpool of an object rank list
-	OBJSYNCDATA *thread = NULL;
-
-	int nObjRankList, iObjRankList;
+	int nObjRankList;
 
 	/* run create scripts, if any */
 	if ( exec_run_createscripts()!=XC_SUCCESS )
@@ -1756,7 +1890,11 @@ STATUS exec_start(void)
 	/* initialize the main loop state control */
 	exec_mls_init();
 
+	/* start the profiler timeline, if any */
+	timeline_init();
+
 	/* perform object initialization */
+	tl = timeline_now();
 	if (init_all() == FAILED)
 	{
 		output_error("model initialization failed");
@@ -1765,8 +1903,11 @@ STATUS exec_start(void)
 			by a more detailed message that explains why it failed.  Follow
 			the guidance for that message and try again.
 		 */
+		timeline_save();
 		return FAILED;
 	}
+	timeline_flush();
+	timeline_event("core","init_all",tl,global_clock);
 
 	/* establish rank index if necessary */
 	if (ranks == NULL && setup_ranks() == FAILED)
@@ -1807,10 +1948,6 @@ STATUS exec_start(void)
 			output_verbose("using %d helper thread(s)", global_threadcount);
 		}
 
-		//sjin: allocate arg_data_array to store pthreads creation argument
-		arg_data_array = (struct arg_data *) malloc(sizeof(struct arg_data) 
-						 * global_threadcount);
-
 		/* allocate thread synchronization data */
 		thread_data = (struct thread_data *) malloc(sizeof(struct thread_data) +
 					  sizeof(struct sync_data) * global_threadcount);
@@ -1826,6 +1963,18 @@ STATUS exec_start(void)
 		thread_data->data = (struct sync_data *) (thread_data + 1);
 		for (j = 0; j < thread_data->count; j++) 
 			thread_data->data[j].status = SUCCESS;
+
+		/* start the persistent sync workers */
+		if (global_threadcount > 1)
+		{
+			sync_pool = wsp_create("sync",global_threadcount,0);
+			if (sync_pool == NULL)
+				output_warning("sync worker pool creation failed - using single-threaded sync as fallback");
+		}
+
+		/* let idle objects sleep until their next event, if desired */
+		if (global_sparse_sync)
+			sparse_init(ranks);
 	}
 	else
 	{
@@ -1855,11 +2004,8 @@ STATUS exec_start(void)
 	/*** GET FIRST SIGNAL FROM MASTER HERE ****/
 	if (global_multirun_mode == MRM_SLAVE)
 	{
-		pthread_cond_broadcast(&mls_inst_signal); // tell slaveproc() it's time to get rolling
 		output_debug("exec_start(), slave waiting for first time signal");
-		pthread_mutex_lock(&mls_inst_lock);
-		pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
-		pthread_mutex_unlock(&mls_inst_lock);
+		instance_slave_yield(); // tell slaveproc() it's time to get rolling
 		// will have copied data down and updated step_to with slave_cache
 		//global_clock = exec_sync_get(NULL); // copy time signal to gc
 		output_debug("exec_start(), slave received first time signal of %lli", global_clock);
@@ -1899,37 +2045,14 @@ STATUS exec_start(void)
 		for (i = PASSINIT(pass); PASSCMP(i, pass); i += PASSINC(pass))
 		{
 			/* skip empty lists */
-			if (ranks[pass]->ordinal[i] == NULL) 
+			if (ranks[pass]->frozen[i].size == 0) 
 				continue;
 			nObjRankList++; // count how many object rank list in one iteration
 		}
 	}
 
-	/* allocate and initialize thread data */
 	output_debug("nObjRankList=%d ",nObjRankList);
 
-	next_t1 = malloc(sizeof(next_t1[0])*nObjRankList);
-	memset(next_t1,0,sizeof(next_t1[0])*nObjRankList);
-
-	donecount = malloc(sizeof(donecount[0])*nObjRankList);
-	memset(donecount,0,sizeof(donecount[0])*nObjRankList);
-
-	n_threads = malloc(sizeof(n_threads[0])*nObjRankList);
-	memset(n_threads,0,sizeof(n_threads[0])*nObjRankList);
-
-	// allocation and nitialize mutex and cond for object rank lists
-	startlock = malloc(sizeof(startlock[0])*nObjRankList);
-	donelock = malloc(sizeof(donelock[0])*nObjRankList);
-	start = malloc(sizeof(start[0])*nObjRankList);
-	done = malloc(sizeof(done[0])*nObjRankList);
-	for(k=0;k<nObjRankList;k++) 
-	{
-		pthread_mutex_init(&startlock[k], NULL);
-		pthread_mutex_init(&donelock[k], NULL);
-		pthread_cond_init(&start[k], NULL);
-		pthread_cond_init(&done[k], NULL);
-	}
-
 	// global test mode
 	if ( global_test_mode==TRUE )
 		return test_exec();
@@ -1947,17 +2070,25 @@ STATUS exec_start(void)
 	TRY {
 
 		/* main loop runs for iteration limit, or when nothing futher occurs (ignoring soft events) */
+		exec_snapshot_running(1);
 		while ( iteration_counter>0 && exec_sync_isrunning(NULL) && exec_getexitcode()==XC_SUCCESS ) 
 		{
 			TIMESTAMP internal_synctime;
 			output_debug("*** main loop event at %lli; stoptime=%lli, n_events=%i, exitcode=%i ***", exec_sync_get(NULL), global_stoptime, exec_sync_getevents(NULL), exec_getexitcode());
 
+			/* let snapshot readers in between passes */
+			exec_snapshot_point();
+
 			/* update the process table info */
 			sched_update(global_clock,MLS_RUNNING);
 
 			/* main loop control */
 			if ( global_clock>=global_mainlooppauseat && global_mainlooppauseat<TS_NEVER )
+			{
+				exec_snapshot_running(0);
 				exec_mls_suspend();
+				exec_snapshot_running(1);
+			}
 
 			do_checkpoint();
 
@@ -2071,7 +2202,9 @@ STATUS exec_start(void)
 				exec_sync_set(NULL,global_stoptime+1,false);
 
 			/* synchronize all internal schedules */
+			tl = timeline_now();
 			internal_synctime = syncall_internals(global_clock);
+			timeline_event("core","syncall_internals",tl,global_clock);
 			if( internal_synctime!=TS_NEVER && absolute_timestamp(internal_synctime)<global_clock )
 			{
 				// must be able to force reiterations for m/s mode.
@@ -2100,34 +2233,42 @@ STATUS exec_start(void)
 			/* run precommit only on first iteration */
 			if (iteration_counter == global_iteration_limit)
 			{
+				tl = timeline_now();
 				pc_rv = precommit_all(global_clock);
+				timeline_flush();
+				timeline_event("core","precommit_all",tl,global_clock);
 				if(SUCCESS != pc_rv)
 				{
 					THROW("precommit failure");
 				}
 			}
-			iObjRankList = -1;
+
+			/* wake the sleeping objects that are due */
+			sparse_wake(global_clock);
 
 			/* scan the ranks of objects for each pass */
 			for (pass = 0; ranks[pass] != NULL; pass++)
 			{
 				int i;
+				int64 tp = timeline_now();
 
 				/* process object in order of rank using index */
 				for (i = PASSINIT(pass); PASSCMP(i, pass); i += PASSINC(pass))
 				{
+					INDEXARRAY *rank = sparse_rank(pass,i,&(ranks[pass]->frozen[i]));
+
 					/* skip empty lists */
-					if (ranks[pass]->ordinal[i] == NULL) 
+					if (rank->size == 0) 
 						continue;
 
-					iObjRankList ++;
+					tl = timeline_now();
 
 					if (global_debug_mode)
 					{
-						LISTITEM *item;
-						for (item=ranks[pass]->ordinal[i]->first; item!=NULL; item=item->next)
+						size_t n;
+						for (n = 0; n < rank->size; n++)
 						{
-							OBJECT *obj = item->data;
+							OBJECT *obj = rank->item[n];
 							// @todo change debug so it uses sync API
 							if (exec_debug(&main_sync,pass,i,obj)==FAILED)
 							{
@@ -2137,95 +2278,32 @@ STATUS exec_start(void)
 					}
 					else
 					{
+						/* contributions to parents are folded in once the whole rank is done */
+						reduce_begin();
+
 						//sjin: if global_threadcount == 1, no pthread multhreading
-						if (global_threadcount == 1) 
+						if (sync_pool == NULL) 
 						{
-							for (ptr = ranks[pass]->ordinal[i]->first; ptr != NULL; ptr=ptr->next) {
-								OBJECT *obj = ptr->data;
-								ss_do_object_sync(0, ptr->data);					
+							size_t n;
+							for (n = 0; n < rank->size; n++) {
+								OBJECT *obj = rank->item[n];
+								ss_do_object_sync(0, obj);					
 								
 								if (obj->valid_to == TS_INVALID)
 								{
 									//Get us out of the loop so others don't exec on bad status
 									break;
 								}
-								///printf("%d %s %d\n", obj->id, obj->name, obj->rank);
 							}
-							//printf("\n");
 						} 
 						else 
-						{ //sjin: implement pthreads
-							unsigned int n_items,objn=0,n;
-							unsigned int n_obj = ranks[pass]->ordinal[i]->size;
-
-							// Only create threadpool for each object rank list at the first iteration. 
-							// Reuse the threadppol of each object rank list at all other iterations.
-							if (setTP == true) { 
-								incr = (int)ceil((float) n_obj / global_threadcount);
-								// if the number of objects is less than or equal to the number of threads, each thread process one object 
-								if (incr <= 1) {
-									n_threads[iObjRankList] = n_obj;
-									n_items = 1;
-								// if the number of objects is greater than the number of threads, each thread process the same number of 
-								// objects (incr), except that the last thread may process less objects 
-								} else {
-									n_threads[iObjRankList] = (int)ceil((float) n_obj / incr);
-									n_items = incr;
-								}
-								if ((int)n_threads[iObjRankList] > global_threadcount) {
-									output_error("Running threads > global_threadcount");
-									exit(0);
-								}
-
-								// allocate thread list
-								thread = (OBJSYNCDATA*)malloc(sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
-								memset(thread,0,sizeof(OBJSYNCDATA)*n_threads[iObjRankList]);
-								// assign starting obj for each thread
-								for (ptr=ranks[pass]->ordinal[i]->first;ptr!=NULL;ptr=ptr->next)
-								{
-									if (thread[objn].nObj==n_items)
-										objn++;
-									if (thread[objn].nObj==0) {
-										thread[objn].ls=ptr;
-									}
-									thread[objn].nObj++;
-								}
-								// create threads
-								for (n=0; n<n_threads[iObjRankList]; n++) {
-									thread[n].ok = true;
-									thread[n].i = iObjRankList;
-									if (pthread_create(&(thread[n].pt),NULL,obj_syncproc,&(thread[n]))!=0) {
-										output_fatal("obj_sync thread creation failed");
-										thread[n].ok = false;
-									} else
-										thread[n].n = n;
-								}
-
-							}
-														
-							// lock access to done count
-							pthread_mutex_lock(&donelock[iObjRankList]);
-							
-							// initialize wait count
-							donecount[iObjRankList] = n_threads[iObjRankList];
-
-							// lock access to start condition
-							pthread_mutex_lock(&startlock[iObjRankList]);
-
-							// update start condition
-							next_t1[iObjRankList] ++;
-
-							// signal all the threads
-							pthread_cond_broadcast(&start[iObjRankList]);
-							// unlock access to start count
-							pthread_mutex_unlock(&startlock[iObjRankList]);
-
-							// begin wait
-							while (donecount[iObjRankList]>0)
-								pthread_cond_wait(&done[iObjRankList],&donelock[iObjRankList]);
-							// unlock done count
-							pthread_mutex_unlock(&donelock[iObjRankList]);
+						{
+							/* all workers process this rank until it is empty */
+							wsp_run(sync_pool,rank->item,rank->size,ss_do_object_sync_call,NULL);
 						}
+						reduce_end();
+						timeline_flush();
+						timeline_event("rank",passname[pass],tl,i);
 
 						for (j = 0; j < thread_data->count; j++) {
 							if (thread_data->data[j].status == FAILED) {
@@ -2242,8 +2320,11 @@ STATUS exec_start(void)
 					TIMESTAMP st = transform_syncall(global_clock,XS_DOUBLE|XS_COMPLEX|XS_ENDUSE);// if (abs(t)<t2) t2=t;
 					exec_sync_set(NULL,st,false);
 				}
+				timeline_event("pass",passname[pass],tp,global_clock);
 			}
-			setTP = false;
+
+			/* objects that are not due again sleep, but their events still count */
+			sparse_sleep(global_clock);
 
 			if (!global_debug_mode)
 			{
@@ -2264,12 +2345,7 @@ STATUS exec_start(void)
 			{
 				output_debug("step_to = %lli", exec_sync_get(NULL));
 				output_debug("exec_start(), slave waiting for looped time signal");
-
-				pthread_cond_broadcast(&mls_inst_signal);
-
-				pthread_mutex_lock(&mls_inst_lock);
-				pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
-				pthread_mutex_unlock(&mls_inst_lock);
+				instance_slave_yield();
 
 				output_debug("exec_start(), slave received looped time signal (%lli)", exec_sync_get(NULL));
 			}
@@ -2282,7 +2358,10 @@ STATUS exec_start(void)
 				if(exec_sync_get(NULL) > global_clock) {
 					global_federation_reiteration = false;
 					TIMESTAMP commit_time = TS_NEVER;
+					tl = timeline_now();
 					commit_time = commit_all(global_clock, exec_sync_get(NULL));
+					timeline_flush();
+					timeline_event("core","commit_all",tl,global_clock);
 					if ( absolute_timestamp(commit_time) <= global_clock)
 					{
 						// commit cannot force reiterations, and any event where the time is less than the global clock
@@ -2343,7 +2422,11 @@ STATUS exec_start(void)
 			/* handle delta mode operation */
 			if ( global_simulation_mode==SM_DELTA && exec_sync_get(NULL)>=global_clock )
 			{
-				DT deltatime = delta_update();
+				DT deltatime;
+				tl = timeline_now();
+				deltatime = delta_update();
+				timeline_flush();
+				timeline_event("core","delta_update",tl,global_clock);
 				if ( deltatime==DT_INVALID )
 				{
 					output_error("delta_update() failed, deltamode operation cannot continue");
@@ -2385,6 +2468,7 @@ STATUS exec_start(void)
 		 */
 	}
 	ENDCATCH
+	exec_snapshot_running(0);
 	output_debug("*** main loop ended at %lli; stoptime=%lli, n_events=%i, exitcode=%i ***", exec_sync_get(NULL), global_stoptime, exec_sync_getevents(NULL), exec_getexitcode());
 	if(global_multirun_mode == MRM_MASTER)
 	{
@@ -2400,6 +2484,9 @@ STATUS exec_start(void)
 		output_error("finalize_all() failed");
 	}
 
+	/* write the profiler timeline, if any */
+	timeline_save();
+
 	/* run term scripts, if any */
 	if ( exec_run_termscripts()!=XC_SUCCESS )
 	{
@@ -2410,6 +2497,10 @@ STATUS exec_start(void)
 	/* deallocate threadpool */
 	if (!global_debug_mode)
 	{
+		wsp_destroy(sync_pool);
+		sync_pool = NULL;
+		reduce_term();
+		sparse_term();
 		free(thread_data);
 		thread_data = NULL;
 
@@ -2420,14 +2511,6 @@ STATUS exec_start(void)
 #endif
 	}
 
-	// Destroy mutex and cond
-	for(k=0;k<nObjRankList;k++) {
-		pthread_mutex_destroy(&startlock[k]);
-		pthread_mutex_destroy(&donelock[k]);
-		pthread_cond_destroy(&start[k]);
-		pthread_cond_destroy(&done[k]);
-	}
-
 	/* report performance */
 	if (global_profiler && !exec_sync_isinvalid(NULL) )
 	{
@@ -2438,6 +2521,7 @@ STATUS exec_start(void)
 
 		extern clock_t loader_time;
 		extern clock_t instance_synctime;
+		extern unsigned int instance_syncs;
 		extern clock_t randomvar_synctime;
 		extern clock_t schedule_synctime;
 		extern clock_t loadshape_synctime;
@@ -2462,6 +2546,8 @@ STATUS exec_start(void)
 		output_profile("  Core time             %8.1f seconds (%.1f%%)", (elapsed_wall-sync_time-delta_runtime),(elapsed_wall-sync_time-delta_runtime)/elapsed_wall*100);
 		output_profile("    Compiler            %8.1f seconds (%.1f%%)", (double)loader_time/CLOCKS_PER_SEC,((double)loader_time/CLOCKS_PER_SEC)/elapsed_wall*100);
 		output_profile("    Instances           %8.1f seconds (%.1f%%)", (double)instance_synctime/CLOCKS_PER_SEC,((double)instance_synctime/CLOCKS_PER_SEC)/elapsed_wall*100);
+		if ( instance_syncs>0 )
+			output_profile("      Exchanges         %8u syncs (%.1f usec/sync)", instance_syncs, (double)instance_synctime/CLOCKS_PER_SEC*1e6/instance_syncs);
 		output_profile("    Random variables    %8.1f seconds (%.1f%%)", (double)randomvar_synctime/CLOCKS_PER_SEC,((double)randomvar_synctime/CLOCKS_PER_SEC)/elapsed_wall*100);
 		output_profile("    Schedules           %8.1f seconds (%.1f%%)", (double)schedule_synctime/CLOCKS_PER_SEC,((double)schedule_synctime/CLOCKS_PER_SEC)/elapsed_wall*100);
 		output_profile("    Loadshapes          %8.1f seconds (%.1f%%)", (double)loadshape_synctime/CLOCKS_PER_SEC,((double)loadshape_synctime/CLOCKS_PER_SEC)/elapsed_wall*100);
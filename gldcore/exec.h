@@ -41,6 +41,8 @@ void exec_mls_init(void);
 void exec_mls_suspend(void);
 void exec_mls_resume(TIMESTAMP next_pause);
 void exec_mls_done(void);
+void exec_snapshot_begin(void);
+void exec_snapshot_end(void);
 void exec_mls_statewait(unsigned states);
 void exec_slave_node();
 int exec_run_createscripts(void);
@@ -92,7 +92,10 @@ GLOBAL int global_dumpall INIT(FALSE);	/**< Flags all modules to dump data after
 GLOBAL int global_runchecks INIT(FALSE); /**< Flags module check code to be called after initialization */
 /** @todo Set the threadcount to zero to automatically use the maximum system resources (tickets 180) */
 GLOBAL int global_threadcount INIT(1); /**< the maximum thread limit, zero means automagically determine best thread count */
+GLOBAL int global_sparse_sync INIT(0); /**< Flags that objects of PC_SPARSE_SYNC classes sleep until their next event (see sparse.h) */
 GLOBAL int global_profiler INIT(0); /**< Flags the profiler to process class performance data */
+GLOBAL char global_profile_trace[1024] INIT(""); /**< File to which the profiler timeline is written (none if empty) */
+GLOBAL char global_profile_trace_objects[1024] INIT(""); /**< Objects or classes whose calls are recorded individually in the profiler timeline */
 GLOBAL int global_pauseatexit INIT(0); /**< Enable a pause for user input after exit */
 GLOBAL char global_testoutputfile[1024] INIT("test.txt"); /**< Specifies the test output file */
 GLOBAL int global_xml_encoding INIT(8);  /**< Specifies XML encoding (default is 8) */
@@ -178,6 +181,7 @@ GLOBAL int global_streaming_io_enabled INIT(0); /**< flag to enable compact stre
 
 GLOBAL int global_nondeterminism_warning INIT(0); /**< flag to enable nondeterminism warning (use of rand when multithreading */
 GLOBAL int global_compileonly INIT(0); /**< flag to enable compile-only option (does not actually start the simulation) */
+GLOBAL int global_use_image INIT(0); /**< flag to load the model image written by the compile-only option, when it is current */
 
 GLOBAL int global_server_portnum INIT(0); /**< port used in server mode (6267 was assigned by IANA Dec 2010) */
 GLOBAL char global_server_inaddr[1024] INIT(""); /**< interface address to bind server to */
@@ -257,6 +261,7 @@ GLOBAL char global_deltamode_updateorder[1025] INIT(""); /**< the order in which
 GLOBAL unsigned int global_deltamode_iteration_limit INIT(10);	/**< Global iteration limit for each delta timestep (object and interupdate calls) */
 GLOBAL unsigned int global_deltamode_forced_extra_timesteps INIT(0);	/**< Deltamode forced extra time steps -- once all items want SM_EVENT, this will force this many more updates */
 GLOBAL bool global_deltamode_forced_always INIT(false);	/**< Deltamode flag - prevents exit from deltamode (no SM_EVENT) -- mainly for debugging purposes */
+GLOBAL unsigned int global_deltamode_threadcount INIT(1);	/**< Deltamode thread count for object updates (0 uses threadcount, 1 updates serially) */
 
 /* master/slave */
 GLOBAL char global_master[1024] INIT(""); /**< master hostname */
@@ -318,6 +323,7 @@ GLOBAL char1024 global_svnroot INIT("http://gridlab-d.svn.sourceforge.net/svnroo
 GLOBAL char1024 global_wget_options INIT("maxsize:100MB;update:newer"); /**< maximum size of wget request */
 
 GLOBAL bool global_reinclude INIT(false); /**< allow the same include file to be included multiple times */
+GLOBAL bool global_sortranks INIT(false); /**< sort objects within each rank by class so that the same sync function runs back-to-back */
 #ifdef __cplusplus
 }
 #endif
@@ -238,7 +238,12 @@ CDECL EXTERN CALLBACKS *callback INIT(NULL);
 #ifdef __cplusplus
 inline void GL_THROW(char *format, ...)
 {
-	static char buffer[1024];
+	/* each thread formats into its own buffer, so concurrent throws (e.g., NR islands) don't mix messages */
+#ifdef _MSC_VER
+	__declspec(thread) static char buffer[1024];
+#else
+	static __thread char buffer[1024];
+#endif
 	va_list ptr;
 	va_start(ptr,format);
 	vsprintf(buffer,format,ptr);
@@ -1199,6 +1204,45 @@ inline const char *gl_module_find_transform_function(TRANSFORMFUNCTION function)
 #endif
 /**@}*/
 
+/****************************
+ * Parent reductions
+ */
+/** @defgroup gridlabd_h_reduce Parent reductions
+	Children add their contributions to their parent's properties with these
+	calls instead of locking the parent.  During a sync pass the additions are
+	deferred until the whole rank is done and then applied in a fixed order,
+	so the sums do not depend on the number of threads.  Work that needs the
+	whole rank done can be queued with gl_reduce_call().
+ * @{
+ */
+#define gl_reduce_add (*callback->reduce.add) /* void (*reduce.add)(OBJECT *from, OBJECT *to, double *target, const double *delta, unsigned int n) */
+#define gl_reduce_call (*callback->reduce.call) /* void (*reduce.call)(void (*call)(void*), void *data) */
+#ifdef __cplusplus
+/** Add \p delta to the double \p target of object \p to on behalf of object \p from */
+inline void gl_reduce(OBJECT *from, OBJECT *to, double &target, double delta) { callback->reduce.add(from,to,&target,&delta,1); };
+/** Add \p delta to the complex \p target of object \p to on behalf of object \p from */
+inline void gl_reduce(OBJECT *from, OBJECT *to, complex &target, complex delta) { double d[2] = {delta.Re(),delta.Im()}; callback->reduce.add(from,to,(double*)&target,d,2); };
+#endif
+/**@}*/
+
+/****************************
+ * Profiler timeline
+ */
+/** @defgroup gridlabd_h_timeline Profiler timeline
+	Modules add their own spans to the profiler timeline (see the
+	\p profile_trace global).  gl_timeline_now() returns 0 when no timeline
+	is being recorded, and gl_timeline_event() then does nothing.
+	@code
+	int64 t0 = gl_timeline_now();
+	// ... work ...
+	gl_timeline_event("module","my_solver",t0,iterations);
+	@endcode
+ * @{
+ */
+#define gl_timeline_now (*callback->timeline.now) /* int64 (*timeline.now)(void) */
+#define gl_timeline_event (*callback->timeline.event) /* void (*timeline.event)(const char *category, const char *name, int64 start, int64 arg) */
+/**@}*/
+
 #ifdef __cplusplus
 inline randomvar *gl_randomvar_getfirst(void) { return callback->randomvar.getnext(NULL); };
 inline randomvar *gl_randomvar_getnext(randomvar *var) { return callback->randomvar.getnext(var); };
@@ -2137,6 +2181,8 @@ public: // special operations
 	template <class T> inline void setp(T &value, gld_wlock&) { *(T*)get_addr()=value; };
 	inline void setp(enumeration value) { ::wlock(&obj->lock); *(enumeration*)get_addr()=value; ::wunlock(&obj->lock); };
 	inline void setp(set value) { ::wlock(&obj->lock); *(set*)get_addr()=value; ::wunlock(&obj->lock); };
+	inline void addp(double value, OBJECT *from) { gl_reduce(from,obj,*(double*)get_addr(),value); };
+	inline void addp(complex value, OBJECT *from) { gl_reduce(from,obj,*(complex*)get_addr(),value); };
 	inline gld_keyword* find_keyword(unsigned long value) { return get_first_keyword()->find(value); };
 	inline gld_keyword* find_keyword(const char *name) { return get_first_keyword()->find(name); };
 	inline bool compare(char *op, char *a, char *b=NULL, char *p=NULL) 
@@ -0,0 +1,189 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file hash.c
+	@addtogroup hash Hash tables
+	@ingroup core
+
+	Hash tables provide constant-time lookup of named items such as objects
+	and class properties.  Tables use open addressing with linear probing
+	and do not copy their keys, so each key must be an interned string that
+	remains valid for as long as the entry is in the table.
+ @{
+ **/
+
+#include <stdlib.h>
+#include <memory.h>
+#include <string.h>
+#include <errno.h>
+#include "output.h"
+#include "hash.h"
+
+static const char deleted_key[] = ""; /* marks a slot whose entry was deleted */
+#define HASH_DELETED deleted_key
+
+/* FNV-1a hash of a string */
+static size_t hash_string(const char *key)
+{
+	unsigned long long h = 14695981039346656037ULL;
+	while ( *key!='\0' )
+	{
+		h ^= (unsigned char)*key++;
+		h *= 1099511628211ULL;
+	}
+	return (size_t)(h ^ (h>>32));
+}
+
+/* locate the slot for a key, or the empty slot where it would go */
+static HASHENTRY *hash_locate(HASHTABLE *table, const char *key, HASHENTRY **deleted)
+{
+	size_t mask = table->size-1;
+	size_t n = hash_string(key)&mask;
+	*deleted = NULL;
+	while ( table->slot[n].key!=NULL )
+	{
+		if ( table->slot[n].key==HASH_DELETED )
+		{
+			if ( *deleted==NULL )
+				*deleted = &table->slot[n];
+		}
+		else if ( strcmp(table->slot[n].key,key)==0 )
+			return &table->slot[n];
+		n = (n+1)&mask;
+	}
+	return &table->slot[n];
+}
+
+/* rebuild the table with a new number of slots (also purges deleted entries) */
+static int hash_resize(HASHTABLE *table, size_t size)
+{
+	HASHENTRY *old = table->slot;
+	size_t n, oldsize = table->size;
+	HASHENTRY *slot = (HASHENTRY*)malloc(sizeof(HASHENTRY)*size);
+	if ( slot==NULL )
+	{
+		output_error("unable to grow hash table to %d entries: %s", (int)size, strerror(errno));
+		/*	TROUBLESHOOT
+			An internal memory allocation error cause a hash table operation to fail.
+			The message will usually include some explanation as to what cause
+			the failure.  Remedy the indicated memory problem to fix the problem.
+		*/
+		return 0;
+	}
+	memset(slot,0,sizeof(HASHENTRY)*size);
+	table->slot = slot;
+	table->size = size;
+	table->used = table->count;
+	for ( n=0 ; n<oldsize ; n++ )
+	{
+		if ( old[n].key!=NULL && old[n].key!=HASH_DELETED )
+		{
+			HASHENTRY *deleted;
+			*hash_locate(table,old[n].key,&deleted) = old[n];
+		}
+	}
+	free(old);
+	return 1;
+}
+
+/** Create a hash table
+	@return a pointer to the new table, or NULL on failure
+ **/
+HASHTABLE *hash_create(size_t size) /**< the expected number of entries (0 for default) */
+{
+	HASHTABLE *table = (HASHTABLE*)malloc(sizeof(HASHTABLE));
+	size_t slots = 16;
+	if ( table==NULL )
+	{
+		errno = ENOMEM;
+		return NULL;
+	}
+	while ( slots<size*2 )
+		slots *= 2;
+	table->slot = (HASHENTRY*)malloc(sizeof(HASHENTRY)*slots);
+	if ( table->slot==NULL )
+	{
+		free(table);
+		errno = ENOMEM;
+		return NULL;
+	}
+	memset(table->slot,0,sizeof(HASHENTRY)*slots);
+	table->size = slots;
+	table->count = 0;
+	table->used = 0;
+	return table;
+}
+
+/** Destroy a hash table (the keys and data are not freed)
+ **/
+void hash_destroy(HASHTABLE *table) /**< the table to destroy */
+{
+	if ( table==NULL )
+		return;
+	free(table->slot);
+	free(table);
+}
+
+/** Find an entry in a hash table
+	@return the data stored under the key, or NULL if none
+ **/
+void *hash_find(HASHTABLE *table, /**< the table to search */
+				const char *key) /**< the key to find */
+{
+	HASHENTRY *deleted, *entry;
+	if ( table==NULL || key==NULL )
+		return NULL;
+	entry = hash_locate(table,key,&deleted);
+	return entry->key!=NULL ? entry->data : NULL;
+}
+
+/** Insert an entry in a hash table
+	@return 1 on success, 0 if the key is already in use or the table could not grow
+ **/
+int hash_insert(HASHTABLE *table, /**< the table to insert into */
+				const char *key, /**< the interned key */
+				void *data) /**< the data to store */
+{
+	HASHENTRY *deleted, *entry;
+
+	/* keep the load factor below 70% */
+	if ( (table->used+1)*10 >= table->size*7 )
+	{
+		size_t size = table->size;
+		if ( (table->count+1)*10 >= size*7/2 )
+			size *= 2;
+		if ( !hash_resize(table,size) )
+			return 0;
+	}
+
+	entry = hash_locate(table,key,&deleted);
+	if ( entry->key!=NULL )
+		return 0;
+	if ( deleted!=NULL )
+		entry = deleted;
+	else
+		table->used++;
+	entry->key = key;
+	entry->data = data;
+	table->count++;
+	return 1;
+}
+
+/** Delete an entry from a hash table
+	@return 1 on success, 0 if the key was not found
+ **/
+int hash_delete(HASHTABLE *table, /**< the table to delete from */
+				const char *key) /**< the key to remove */
+{
+	HASHENTRY *deleted, *entry;
+	if ( table==NULL || key==NULL )
+		return 0;
+	entry = hash_locate(table,key,&deleted);
+	if ( entry->key==NULL )
+		return 0;
+	entry->key = HASH_DELETED;
+	entry->data = NULL;
+	table->count--;
+	return 1;
+}
+
+/**@}*/
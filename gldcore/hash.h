@@ -0,0 +1,42 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file hash.h
+	@addtogroup hash
+	@ingroup core
+@{
+ **/
+
+#ifndef _HASH_H
+#define _HASH_H
+
+#include <stdlib.h>
+
+typedef struct s_hashentry {
+	const char *key;	/**< the interned key (not copied, must outlive the entry) */
+	void *data;			/**< the data stored under the key */
+} HASHENTRY; /**< a slot in a hash table */
+
+typedef struct s_hashtable {
+	HASHENTRY *slot;	/**< the open-addressed slots */
+	size_t size;		/**< the number of slots (always a power of 2) */
+	size_t count;		/**< the number of live entries */
+	size_t used;		/**< the number of live and deleted entries */
+} HASHTABLE; /**< a string-keyed open-addressing hash table */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+HASHTABLE *hash_create(size_t size);
+void hash_destroy(HASHTABLE *table);
+void *hash_find(HASHTABLE *table, const char *key);
+int hash_insert(HASHTABLE *table, const char *key, void *data);
+int hash_delete(HASHTABLE *table, const char *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}*/
@@ -0,0 +1,1275 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file image.c
+	@addtogroup image
+	@ingroup core
+
+	Writing and reading model images.  See image.h for the design.
+
+	An image is a header, the list of included files, the first object id,
+	the timezone, the core globals, the modules, the module globals, the
+	schedules, a table of classes, a table of properties and the objects.
+	Numbers are written in the byte order of the machine and strings as a
+	length followed by the characters and a terminating zero, so the reader
+	can use them where they lie.
+ @{
+ **/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "platform.h"
+#include "output.h"
+#include "globals.h"
+#include "module.h"
+#include "class.h"
+#include "object.h"
+#include "schedule.h"
+#include "timestamp.h"
+#include "image.h"
+
+#define IMAGE_VERSION 2
+#define IMAGE_EXT ".gli"
+#define IMAGE_ORDER 0x01020304
+#define FNV_OFFSET (((uint64)0xcbf29ce4<<32)|0x84222325)
+#define FNV_PRIME (((uint64)0x00000100<<32)|0x000001b3)
+
+typedef enum {
+	IK_RAW=0, /**< bytes copied into place */
+	IK_RAWNOTIFY=1, /**< bytes copied into place between the notifiers, which get the text that follows */
+	IK_TEXT=2, /**< text converted into place */
+	IK_TEXTNOTIFY=3, /**< text set through the notifiers */
+	IK_OBJECT=4, /**< index of the object referenced, -1 for none */
+} IMAGEKIND;
+
+typedef struct s_imageheader {
+	char magic[8];
+	uint32 version; /**< IMAGE_VERSION */
+	uint32 order; /**< IMAGE_ORDER as written by the writer */
+	uint32 wordsize;
+	uint32 major, minor, patch, build;
+	char branch[32];
+	uint64 hash; /**< hash of the model files and the globals at the start of the load */
+} IMAGEHEADER;
+
+/** The object header as written, followed by the name and the properties */
+typedef struct s_imageobject {
+	uint32 oclass; /**< index in the class table */
+	int32 parent; /**< index of the parent, -1 for none */
+	uint32 child_count;
+	OBJECTRANK rank;
+	TIMESTAMP clock, valid_to, schedule_skew, in_svc, out_svc, heartbeat;
+	double latitude, longitude, in_svc_double, out_svc_double;
+	uint32 in_svc_micro, out_svc_micro;
+	uint32 flags;
+	uint32 nprops;
+	char32 groupid;
+} IMAGEOBJECT;
+
+/** A property the loader set */
+typedef struct s_imageset {
+	OBJECT *obj;
+	PROPERTY *prop;
+	unsigned int seq;
+	int notify; /**< set through object_set_value_by_name() rather than directly */
+} IMAGESET;
+
+typedef struct s_imageglobal {
+	GLOBALVAR *var;
+	uint64 value; /**< hash of the value when the load started */
+} IMAGEGLOBAL;
+
+typedef struct s_imagereader {
+	char *pos, *end;
+	int error;
+} IMAGEREADER;
+
+typedef struct s_imagefixup {
+	OBJECT **addr;
+	int32 index;
+} IMAGEFIXUP;
+
+static char image_magic[8] = {'G','L','D','I','M','A','G','E'};
+
+/* globals that do not change what the model loads */
+static char *image_ignore[] = {"randomseed","clock","quiet","warn","debugger","gdb","debug","test","verbose",
+	"profiler","pauseatexit","show_progress","suppress_repeat_messages","no_deprecate","threadcount",NULL};
+
+static int tracking = 0;
+static char *unsupported = NULL;
+static OBJECTNUM first_id = 0;
+static uint64 entry_hash = 0;
+static IMAGEGLOBAL *entry_globals = NULL;
+static unsigned int n_entry_globals = 0, max_entry_globals = 0;
+static IMAGESET *sets = NULL;
+static unsigned int n_sets = 0, max_sets = 0;
+static OBJECT **created = NULL;
+static unsigned int n_created = 0, max_created = 0;
+static char **includes = NULL;
+static unsigned int n_includes = 0, max_includes = 0;
+static char **envnames = NULL;
+static unsigned int n_envnames = 0, max_envnames = 0;
+
+/* make room for one more item in a list
+   @return 0 if out of memory */
+static int grow(void **list, unsigned int *max, unsigned int n, size_t size)
+{
+	void *grown;
+	unsigned int newmax;
+	if ( n<*max )
+		return 1;
+	newmax = *max==0 ? 64 : *max*2;
+	grown = realloc(*list,newmax*size);
+	if ( grown==NULL )
+		return 0;
+	*list = grown;
+	*max = newmax;
+	return 1;
+}
+
+static void reset(void)
+{
+	unsigned int i;
+	for ( i=0 ; i<n_includes ; i++ )
+		free(includes[i]);
+	free(includes);
+	for ( i=0 ; i<n_envnames ; i++ )
+		free(envnames[i]);
+	free(envnames);
+	envnames = NULL;
+	n_envnames = max_envnames = 0;
+	free(created);
+	free(sets);
+	free(entry_globals);
+	includes = NULL;
+	created = NULL;
+	sets = NULL;
+	entry_globals = NULL;
+	n_includes = max_includes = n_created = max_created = n_sets = max_sets = n_entry_globals = max_entry_globals = 0;
+	unsupported = NULL;
+	tracking = 0;
+}
+
+static uint64 hash_bytes(uint64 hash, const void *data, size_t len)
+{
+	const unsigned char *p = (const unsigned char*)data;
+	while ( len-->0 )
+	{
+		hash ^= *p++;
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static uint64 hash_string(uint64 hash, const char *str)
+{
+	return hash_bytes(hash,str,strlen(str)+1);
+}
+
+/* @return 0 if the file cannot be read */
+static int hash_file(uint64 *hash, char *file)
+{
+	char buffer[65536];
+	size_t len;
+	FILE *fp = fopen(file,"rb");
+	if ( fp==NULL )
+		return 0;
+	*hash = hash_string(*hash,file);
+	while ( (len=fread(buffer,1,sizeof(buffer),fp))>0 )
+		*hash = hash_bytes(*hash,buffer,len);
+	fclose(fp);
+	return 1;
+}
+
+/* the value of an environment variable, which may be unset */
+static uint64 hash_env(uint64 hash, const char *name)
+{
+	char *value = getenv(name);
+	hash = hash_string(hash,name);
+	if ( value==NULL )
+		return hash_bytes(hash,"",1);
+	hash = hash_bytes(hash,"=",1);
+	return hash_string(hash,value);
+}
+
+/* types whose values can be copied as bytes */
+static int is_plain(PROPERTY *prop)
+{
+	if ( prop->size>1 )
+		return 0;
+	switch ( prop->ptype ) {
+	case PT_double:
+	case PT_complex:
+	case PT_enumeration:
+	case PT_set:
+	case PT_int16:
+	case PT_int32:
+	case PT_int64:
+	case PT_char8:
+	case PT_char32:
+	case PT_char256:
+	case PT_char1024:
+	case PT_bool:
+	case PT_timestamp:
+	case PT_float:
+		return property_size(prop)>0;
+	default:
+		return 0;
+	}
+}
+
+/* bytes of a plain value worth copying */
+static size_t plain_size(PROPERTY *prop, void *addr)
+{
+	size_t size = property_size(prop);
+	if ( prop->ptype>=PT_char8 && prop->ptype<=PT_char1024 )
+	{
+		size_t len = strlen((char*)addr)+1;
+		return len<size ? len : size;
+	}
+	return size;
+}
+
+/* globals whose values can be copied as bytes; set globals are C enums,
+   which may be smaller than the set property size */
+static int is_plain_global(GLOBALVAR *var)
+{
+	return var->prop->ptype!=PT_set && is_plain(var->prop);
+}
+
+static uint64 global_value(GLOBALVAR *var)
+{
+	char buffer[1025];
+	if ( is_plain_global(var) )
+		return hash_bytes(FNV_OFFSET,var->prop->addr,plain_size(var->prop,var->prop->addr));
+	if ( global_getvar(var->prop->name,buffer,sizeof(buffer))==NULL )
+		buffer[0] = '\0';
+	return hash_string(FNV_OFFSET,buffer);
+}
+
+static int is_ignored(char *name)
+{
+	char **p;
+	for ( p=image_ignore ; *p!=NULL ; p++ )
+	{
+		if ( strcmp(*p,name)==0 )
+			return 1;
+	}
+	return 0;
+}
+
+/* note the state of the run before the model is loaded */
+static void image_begin(void)
+{
+	GLOBALVAR *var;
+	char *tz = timestamp_current_timezone();
+
+	reset();
+	tracking = global_compileonly;
+	first_id = object_get_count();
+	entry_hash = hash_string(FNV_OFFSET,tz?tz:"");
+	for ( var=global_getnext(NULL) ; var!=NULL ; var=global_getnext(var) )
+	{
+		uint64 value;
+		if ( var->prop->access!=PA_PUBLIC )
+			continue;
+		value = global_value(var);
+		if ( tracking && grow((void**)&entry_globals,&max_entry_globals,n_entry_globals,sizeof(IMAGEGLOBAL)) )
+		{
+			entry_globals[n_entry_globals].var = var;
+			entry_globals[n_entry_globals].value = value;
+			n_entry_globals++;
+		}
+		if ( !is_ignored(var->prop->name) )
+		{
+			entry_hash = hash_string(entry_hash,var->prop->name);
+			entry_hash = hash_bytes(entry_hash,&value,sizeof(value));
+		}
+	}
+}
+
+/* @return 0 if the model file has no image name */
+static int image_name(char *file, char *path, size_t size)
+{
+	char *ext;
+	if ( strlen(file)+strlen(IMAGE_EXT)>=size )
+		return 0;
+	strcpy(path,file);
+	ext = strrchr(path,'.');
+	if ( ext==NULL || strchr(ext,'/')!=NULL || strchr(ext,'\\')!=NULL )
+		ext = path+strlen(path);
+	strcpy(ext,IMAGE_EXT);
+	return 1;
+}
+
+/** Record that the model being loaded uses \p feature, which an image
+	cannot reproduce.
+ **/
+void image_unsupported(char *feature)
+{
+	if ( tracking && unsupported==NULL )
+		unsupported = feature;
+}
+
+/** Record that the model being loaded included \p file */
+void image_include(char *file)
+{
+	if ( !tracking )
+		return;
+	if ( !grow((void**)&includes,&max_includes,n_includes,sizeof(char*))
+		|| (includes[n_includes]=(char*)malloc(strlen(file)+1))==NULL )
+	{
+		image_unsupported("more includes than memory allows");
+		return;
+	}
+	strcpy(includes[n_includes++],file);
+}
+
+/** Read the environment variable \p name for the loader, recording that
+	the model being loaded depends on it.
+	@return the value, or NULL if it is not set
+ **/
+char *image_getenv(char *name)
+{
+	unsigned int i;
+	if ( tracking )
+	{
+		for ( i=0 ; i<n_envnames && strcmp(envnames[i],name)!=0 ; i++ ) {}
+		if ( i==n_envnames )
+		{
+			if ( !grow((void**)&envnames,&max_envnames,n_envnames,sizeof(char*))
+				|| (envnames[n_envnames]=(char*)malloc(strlen(name)+1))==NULL )
+				image_unsupported("more environment variables than memory allows");
+			else
+				strcpy(envnames[n_envnames++],name);
+		}
+	}
+	return getenv(name);
+}
+
+/** Record that the loader created \p obj */
+void image_object(OBJECT *obj)
+{
+	if ( !tracking )
+		return;
+	if ( !grow((void**)&created,&max_created,n_created,sizeof(OBJECT*)) )
+	{
+		image_unsupported("more objects than memory allows");
+		return;
+	}
+	created[n_created++] = obj;
+}
+
+/** Record that the loader set \p prop of \p obj, through the notifiers
+	when \p notify is set.
+ **/
+void image_set(OBJECT *obj, PROPERTY *prop, int notify)
+{
+	if ( !tracking || prop==NULL )
+		return;
+	if ( !grow((void**)&sets,&max_sets,n_sets,sizeof(IMAGESET)) )
+	{
+		image_unsupported("more properties than memory allows");
+		return;
+	}
+	sets[n_sets].obj = obj;
+	sets[n_sets].prop = prop;
+	sets[n_sets].seq = n_sets;
+	sets[n_sets].notify = notify;
+	n_sets++;
+}
+
+/****************************************************************
+ * Writer
+ ****************************************************************/
+
+static int put(FILE *fp, const void *data, size_t len)
+{
+	return len==0 || fwrite(data,len,1,fp)==1;
+}
+
+static int put_u32(FILE *fp, uint32 value)
+{
+	return put(fp,&value,sizeof(value));
+}
+
+static int put_string(FILE *fp, const char *str)
+{
+	uint32 len = (uint32)strlen(str)+1;
+	return put_u32(fp,len) && put(fp,str,len);
+}
+
+static int compare_sets(const void *a, const void *b)
+{
+	const IMAGESET *x = (const IMAGESET*)a, *y = (const IMAGESET*)b;
+	if ( x->obj->id!=y->obj->id )
+		return x->obj->id<y->obj->id ? -1 : 1;
+	return x->seq<y->seq ? -1 : (x->seq>y->seq ? 1 : 0);
+}
+
+static int compare_pointers(const void *a, const void *b)
+{
+	const char *x = *(const char**)a, *y = *(const char**)b;
+	return x<y ? -1 : (x>y ? 1 : 0);
+}
+
+/* sort and remove duplicates
+   @return the number left */
+static unsigned int unique(void **list, unsigned int n)
+{
+	unsigned int i, m = 0;
+	qsort(list,n,sizeof(void*),compare_pointers);
+	for ( i=0 ; i<n ; i++ )
+	{
+		if ( m==0 || list[m-1]!=list[i] )
+			list[m++] = list[i];
+	}
+	return m;
+}
+
+static int32 find_pointer(void **list, unsigned int n, void *item)
+{
+	void **found = (void**)bsearch(&item,list,n,sizeof(void*),compare_pointers);
+	return found ? (int32)(found-list) : -1;
+}
+
+static int32 object_index(OBJECT *obj)
+{
+	if ( obj==NULL )
+		return -1;
+	return (int32)(obj->id-first_id);
+}
+
+/* the entry of \p var when the load started, or NULL if it was created since */
+static IMAGEGLOBAL *entry_global(GLOBALVAR *var)
+{
+	unsigned int i;
+	for ( i=0 ; i<n_entry_globals ; i++ )
+	{
+		if ( entry_globals[i].var==var )
+			return entry_globals+i;
+	}
+	return NULL;
+}
+
+/* write the public globals the load changed or created, either the core
+   ones or those of modules */
+static int put_globals(FILE *fp, int modules)
+{
+	GLOBALVAR *var;
+	uint32 n = 0;
+	char buffer[1025];
+	int pass;
+
+	/* count then write */
+	for ( pass=0 ; pass<2 ; pass++ )
+	{
+		if ( pass==1 && !put_u32(fp,n) )
+			return 0;
+		for ( var=global_getnext(NULL) ; var!=NULL ; var=global_getnext(var) )
+		{
+			char *name = var->prop->name;
+			IMAGEGLOBAL *entry;
+			if ( var->prop->access!=PA_PUBLIC || (strstr(name,"::")!=NULL)!=modules )
+				continue;
+			entry = entry_global(var);
+			if ( entry!=NULL && entry->value==global_value(var) )
+				continue;
+			if ( pass==0 )
+			{
+				n++;
+				continue;
+			}
+			if ( !put_string(fp,name) )
+				return 0;
+
+			/* globals created by the model are created again when set as text */
+			if ( (entry!=NULL || modules) && is_plain_global(var) && var->callback==NULL )
+			{
+				uint32 len = (uint32)plain_size(var->prop,var->prop->addr);
+				if ( !put_u32(fp,IK_RAW) || !put_u32(fp,len) || !put(fp,var->prop->addr,len) )
+					return 0;
+			}
+			else if ( global_getvar(name,buffer,sizeof(buffer))==NULL )
+			{
+				output_error("image_save(): unable to get the value of global '%s'", name);
+				/* TROUBLESHOOT
+				   The value of a global variable the model changed could not be written to the model image.
+				   The image is not written and the model will be loaded from the GLM file.
+				 */
+				return 0;
+			}
+			else if ( !put_u32(fp,IK_TEXT) || !put_string(fp,buffer) )
+				return 0;
+		}
+	}
+	return 1;
+}
+
+/* write the properties of one object
+   @return 0 on failure */
+static int put_properties(FILE *fp, OBJECT *obj, IMAGESET *set, unsigned int n, void **props, unsigned int n_props)
+{
+	static char buffer[65536];
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+	{
+		PROPERTY *prop = set[i].prop;
+		void *addr = (void*)((char*)(obj+1)+(int64)prop->addr);
+		int notify = set[i].notify && (prop->notify!=NULL || obj->oclass->notify!=NULL);
+		int32 index;
+
+		if ( !put_u32(fp,(uint32)find_pointer(props,n_props,prop)) )
+			return 0;
+		if ( prop->ptype==PT_object )
+		{
+			OBJECT *ref = *(OBJECT**)addr;
+			index = object_index(ref);
+			if ( ref!=NULL && (index<0 || (uint32)index>=n_created || created[index]!=ref) )
+			{
+				output_warning("image_save(): %s refers to an object the model did not create", prop->name);
+				/* TROUBLESHOOT
+				   An object reference in the model points to an object that was not created by the model.
+				   The model image is not written and the model will be loaded from the GLM file.
+				 */
+				return 0;
+			}
+			if ( !put_u32(fp,IK_OBJECT) || !put_u32(fp,(uint32)index) )
+				return 0;
+			continue;
+		}
+		if ( (!is_plain(prop) || notify) && class_property_to_string(prop,addr,buffer,sizeof(buffer))<=0 )
+		{
+			output_warning("image_save(): unable to convert the value of %s to a string", prop->name);
+			/* TROUBLESHOOT
+			   A property set by the model could not be converted to a string to store in the model image.
+			   The image is not written and the model will be loaded from the GLM file.
+			 */
+			return 0;
+		}
+		if ( is_plain(prop) )
+		{
+			uint32 len = (uint32)plain_size(prop,addr);
+			if ( !put_u32(fp,notify?IK_RAWNOTIFY:IK_RAW) || !put_u32(fp,len) || !put(fp,addr,len) )
+				return 0;
+			if ( notify && !put_string(fp,buffer) )
+				return 0;
+		}
+		else if ( !put_u32(fp,notify?IK_TEXTNOTIFY:IK_TEXT) || !put_string(fp,buffer) )
+			return 0;
+	}
+	return 1;
+}
+
+static int put_image(FILE *fp, char *file)
+{
+	IMAGEHEADER hdr;
+	MODULE *mod;
+	SCHEDULE *sch;
+	OBJECT *obj;
+	void **classes = NULL, **props = NULL;
+	unsigned int n_classes = 0, n_props = 0, i, j, k;
+	char *tz = timestamp_current_timezone();
+	int ok = 0;
+
+	/* header */
+	memset(&hdr,0,sizeof(hdr));
+	memcpy(hdr.magic,image_magic,sizeof(hdr.magic));
+	hdr.version = IMAGE_VERSION;
+	hdr.order = IMAGE_ORDER;
+	hdr.wordsize = sizeof(void*);
+	hdr.major = global_version_major;
+	hdr.minor = global_version_minor;
+	hdr.patch = global_version_patch;
+	hdr.build = global_version_build;
+	strncpy(hdr.branch,global_version_branch,sizeof(hdr.branch)-1);
+	hdr.hash = entry_hash;
+	if ( !hash_file(&hdr.hash,file) )
+		return 0;
+	for ( i=0 ; i<n_includes ; i++ )
+	{
+		if ( !hash_file(&hdr.hash,includes[i]) )
+			return 0;
+	}
+	for ( i=0 ; i<n_envnames ; i++ )
+		hdr.hash = hash_env(hdr.hash,envnames[i]);
+	if ( !put(fp,&hdr,sizeof(hdr)) || !put_u32(fp,n_includes) )
+		return 0;
+	for ( i=0 ; i<n_includes ; i++ )
+	{
+		if ( !put_string(fp,includes[i]) )
+			return 0;
+	}
+	if ( !put_u32(fp,n_envnames) )
+		return 0;
+	for ( i=0 ; i<n_envnames ; i++ )
+	{
+		if ( !put_string(fp,envnames[i]) )
+			return 0;
+	}
+	if ( !put_u32(fp,first_id) || !put_string(fp,tz?tz:"") )
+		return 0;
+
+	/* core globals, modules, module globals */
+	if ( !put_globals(fp,0) )
+		return 0;
+	for ( mod=module_get_first(), i=0 ; mod!=NULL ; mod=mod->next )
+		i++;
+	if ( !put_u32(fp,i) )
+		return 0;
+	for ( mod=module_get_first() ; mod!=NULL ; mod=mod->next )
+	{
+		if ( !put_string(fp,mod->name) )
+			return 0;
+	}
+	if ( !put_globals(fp,1) )
+		return 0;
+
+	/* schedules */
+	for ( sch=schedule_getfirst(), i=0 ; sch!=NULL ; sch=schedule_getnext(sch) )
+		i++;
+	if ( !put_u32(fp,i) )
+		return 0;
+	for ( sch=schedule_getfirst() ; sch!=NULL ; sch=schedule_getnext(sch) )
+	{
+		if ( !put_string(fp,sch->name) || !put_string(fp,sch->definition?sch->definition:"") )
+			return 0;
+	}
+
+	/* class and property tables */
+	classes = (void**)malloc(sizeof(void*)*(n_created+n_sets+1));
+	props = (void**)malloc(sizeof(void*)*(n_sets+1));
+	if ( classes==NULL || props==NULL )
+		goto Done;
+	for ( i=0 ; i<n_created ; i++ )
+		classes[n_classes++] = created[i]->oclass;
+	for ( i=0 ; i<n_sets ; i++ )
+	{
+		classes[n_classes++] = sets[i].prop->oclass;
+		props[n_props++] = sets[i].prop;
+	}
+	n_classes = unique(classes,n_classes);
+	n_props = unique(props,n_props);
+	if ( !put_u32(fp,n_classes) )
+		goto Done;
+	for ( i=0 ; i<n_classes ; i++ )
+	{
+		CLASS *oclass = (CLASS*)classes[i];
+		char name[1024];
+		if ( oclass->module==NULL )
+		{
+			output_warning("image_save(): class '%s' is not implemented by a module", oclass->name);
+			/* TROUBLESHOOT
+			   The model uses a class that was defined at runtime, which a model image cannot reproduce.
+			   The image is not written and the model will be loaded from the GLM file.
+			 */
+			goto Done;
+		}
+		sprintf(name,"%.500s.%.500s",oclass->module->name,oclass->name);
+		if ( !put_string(fp,name) || !put_u32(fp,oclass->size) )
+			goto Done;
+	}
+	if ( !put_u32(fp,n_props) )
+		goto Done;
+	for ( i=0 ; i<n_props ; i++ )
+	{
+		PROPERTY *prop = (PROPERTY*)props[i];
+		if ( !put_u32(fp,(uint32)find_pointer(classes,n_classes,prop->oclass)) || !put_string(fp,prop->name) || !put_u32(fp,prop->ptype) )
+			goto Done;
+	}
+
+	/* objects, in creation order with the properties set on each */
+	qsort(sets,n_sets,sizeof(IMAGESET),compare_sets);
+	if ( !put_u32(fp,n_created) )
+		goto Done;
+	for ( i=0, j=0 ; i<n_created ; i++ )
+	{
+		IMAGEOBJECT rec;
+		unsigned int first, n = 0;
+		obj = created[i];
+
+		/* keep the first of repeated settings of a property, since the value written is the last one */
+		while ( j<n_sets && sets[j].obj->id<obj->id )
+			j++;
+		first = j;
+		for ( ; j<n_sets && sets[j].obj==obj ; j++ )
+		{
+			for ( k=first ; k<first+n ; k++ )
+			{
+				if ( sets[k].prop==sets[j].prop )
+				{
+					sets[k].notify |= sets[j].notify;
+					break;
+				}
+			}
+			if ( k==first+n )
+				sets[first+n++] = sets[j];
+		}
+
+		memset(&rec,0,sizeof(rec));
+		rec.oclass = (uint32)find_pointer(classes,n_classes,obj->oclass);
+		rec.parent = object_index(obj->parent);
+		if ( obj->parent!=NULL && (rec.parent<0 || (uint32)rec.parent>=n_created) )
+			goto Done;
+		rec.child_count = obj->child_count;
+		rec.rank = obj->rank;
+		rec.clock = obj->clock;
+		rec.valid_to = obj->valid_to;
+		rec.schedule_skew = obj->schedule_skew;
+		rec.in_svc = obj->in_svc;
+		rec.out_svc = obj->out_svc;
+		rec.heartbeat = obj->heartbeat;
+		rec.latitude = obj->latitude;
+		rec.longitude = obj->longitude;
+		rec.in_svc_double = obj->in_svc_double;
+		rec.out_svc_double = obj->out_svc_double;
+		rec.in_svc_micro = obj->in_svc_micro;
+		rec.out_svc_micro = obj->out_svc_micro;
+		rec.flags = obj->flags;
+		rec.nprops = n;
+		memcpy(rec.groupid,obj->groupid,sizeof(rec.groupid));
+		if ( !put(fp,&rec,sizeof(rec)) || !put_string(fp,obj->name?obj->name:"") )
+			goto Done;
+		if ( !put_properties(fp,obj,sets+first,n,props,n_props) )
+			goto Done;
+	}
+	ok = 1;
+Done:
+	free(classes);
+	free(props);
+	return ok;
+}
+
+/* @return NULL if the objects in the model can all be written, or the reason they cannot */
+static char *check_objects(void)
+{
+	OBJECT *obj = object_find_by_id(first_id);
+	unsigned int i;
+	for ( i=0 ; i<n_created ; i++, obj=obj->next )
+	{
+		if ( obj!=created[i] )
+			return "objects not created by the loader";
+		if ( obj->space!=NULL )
+			return "namespaces";
+		if ( obj->forecast!=NULL )
+			return "forecasts";
+	}
+	return obj==NULL ? NULL : "objects not created by the loader";
+}
+
+/** Write the image of the model just loaded from \p file, if the load was
+	done with \p --compile.  A model that cannot be written is not an error;
+	it will simply always be loaded from the GLM.
+	@return SUCCESS if the image was written or not needed, FAILED otherwise
+ **/
+STATUS image_save(char *file)
+{
+	char path[1024], temp[1024];
+	FILE *fp;
+	char *reason = unsupported;
+
+	if ( !tracking )
+		return SUCCESS;
+	tracking = 0;
+	if ( reason==NULL )
+		reason = check_objects();
+	if ( reason!=NULL )
+	{
+		output_warning("%s: model image not written because the model uses %s", file, reason);
+		/* TROUBLESHOOT
+		   The model uses a feature that cannot be reproduced from a model image, so no image was written
+		   and the model will always be loaded from the GLM file.
+		 */
+		reset();
+		return FAILED;
+	}
+	if ( !image_name(file,path,sizeof(path)) || strlen(path)+1>=sizeof(temp) )
+	{
+		reset();
+		return FAILED;
+	}
+	sprintf(temp,"%s~",path);
+	fp = fopen(temp,"wb");
+	if ( fp==NULL )
+	{
+		output_warning("%s: unable to write model image '%s' (%s)", file, temp, strerror(errno));
+		/* TROUBLESHOOT
+		   The model image could not be created next to the model.  Check that the folder is writable.
+		 */
+		reset();
+		return FAILED;
+	}
+	if ( !put_image(fp,file) )
+	{
+		fclose(fp);
+		fp = NULL;
+	}
+	if ( fp==NULL || fclose(fp)!=0 )
+	{
+		output_warning("%s: unable to write model image '%s'", file, temp);
+		/* TROUBLESHOOT
+		   The model image could not be written completely.  Check the prior messages and the
+		   space available on the disk.  The model will be loaded from the GLM file.
+		 */
+		remove(temp);
+		reset();
+		return FAILED;
+	}
+	remove(path);
+	if ( rename(temp,path)!=0 )
+	{
+		output_warning("%s: unable to rename model image '%s' to '%s' (%s)", file, temp, path, strerror(errno));
+		remove(temp);
+		reset();
+		return FAILED;
+	}
+	output_verbose("model image '%s' written for %d objects", path, n_created);
+	reset();
+	return SUCCESS;
+}
+
+/****************************************************************
+ * Reader
+ ****************************************************************/
+
+static void *get(IMAGEREADER *in, size_t len)
+{
+	char *data = in->pos;
+	if ( in->error || len>(size_t)(in->end-in->pos) )
+	{
+		in->error = 1;
+		return NULL;
+	}
+	in->pos += len;
+	return data;
+}
+
+static uint32 get_u32(IMAGEREADER *in)
+{
+	uint32 value = 0;
+	void *data = get(in,sizeof(value));
+	if ( data!=NULL )
+		memcpy(&value,data,sizeof(value));
+	return value;
+}
+
+static char *get_string(IMAGEREADER *in)
+{
+	uint32 len = get_u32(in);
+	char *str = (char*)get(in,len);
+	if ( str==NULL || len==0 || str[len-1]!='\0' )
+	{
+		in->error = 1;
+		return NULL;
+	}
+	return str;
+}
+
+static int get_globals(IMAGEREADER *in)
+{
+	uint32 n = get_u32(in), i;
+	for ( i=0 ; i<n && !in->error ; i++ )
+	{
+		char *name = get_string(in);
+		uint32 kind = get_u32(in);
+		if ( name==NULL )
+			break;
+		if ( kind==IK_RAW )
+		{
+			uint32 len = get_u32(in);
+			void *data = get(in,len);
+			GLOBALVAR *var = global_find(name);
+			if ( data==NULL )
+				break;
+			if ( var==NULL || !is_plain_global(var) || len>property_size(var->prop) )
+			{
+				output_error("model image global '%s' does not match this version", name);
+				/* TROUBLESHOOT
+				   A global variable stored in the model image does not exist or has changed type.
+				   Delete the model image or compile the model again and try again.
+				 */
+				return 0;
+			}
+			memcpy(var->prop->addr,data,len);
+		}
+		else
+		{
+			char *value = get_string(in);
+			int strict = global_strictnames;
+			STATUS rc;
+			if ( value==NULL )
+				break;
+			global_strictnames = FALSE;
+			rc = global_setvar(name,value);
+			if ( strcmp(name,"strictnames")!=0 )
+				global_strictnames = strict;
+			if ( rc==FAILED )
+				return 0;
+		}
+	}
+	return !in->error;
+}
+
+/* set a value the loader set through the notifiers, but copy the bytes so no precision is lost */
+static void set_notified(OBJECT *obj, PROPERTY *prop, void *addr, void *data, size_t len, char *text)
+{
+	if ( obj->oclass->notify && obj->oclass->notify(obj,NM_PREUPDATE,prop,text)==0 )
+		output_error("preupdate notify failure on %s in %s", prop->name, obj->name ? obj->name : "an unnamed object");
+	if ( prop->notify && prop->notify(obj,text)==0 )
+		output_error("property notify_%s_%s failure in %s", obj->oclass->name, prop->name, obj->name ? obj->name : "an unnamed object");
+	memcpy(addr,data,len);
+	if ( obj->oclass->notify && obj->oclass->notify(obj,NM_POSTUPDATE,prop,text)==0 )
+		output_error("postupdate notify failure on %s in %s", prop->name, obj->name ? obj->name : "an unnamed object");
+}
+
+static int get_properties(IMAGEREADER *in, OBJECT *obj, uint32 n, PROPERTY **props, uint32 n_props, IMAGEFIXUP *fixup, unsigned int *n_fixups)
+{
+	uint32 i;
+	for ( i=0 ; i<n && !in->error ; i++ )
+	{
+		uint32 index = get_u32(in);
+		uint32 kind = get_u32(in);
+		PROPERTY *prop = index<n_props ? props[index] : NULL;
+		void *addr;
+		if ( in->error )
+			break;
+		if ( prop==NULL )
+		{
+			in->error = 1;
+			break;
+		}
+		addr = (void*)((char*)(obj+1)+(int64)prop->addr);
+		if ( kind==IK_OBJECT )
+		{
+			fixup[*n_fixups].addr = (OBJECT**)addr;
+			fixup[*n_fixups].index = (int32)get_u32(in);
+			(*n_fixups)++;
+		}
+		else if ( kind==IK_RAW || kind==IK_RAWNOTIFY )
+		{
+			uint32 len = get_u32(in);
+			void *data = get(in,len);
+			char *text = kind==IK_RAWNOTIFY ? get_string(in) : NULL;
+			if ( in->error || !is_plain(prop) || len>property_size(prop) )
+			{
+				in->error = 1;
+				break;
+			}
+			if ( text!=NULL )
+				set_notified(obj,prop,addr,data,len,text);
+			else
+				memcpy(addr,data,len);
+		}
+		else
+		{
+			char *text = get_string(in);
+			if ( text==NULL )
+				break;
+			if ( kind==IK_TEXTNOTIFY ? (object_set_value_by_addr(obj,addr,text,prop)==0 && !prop->notify_override) : class_string_to_property(prop,addr,text)==0 )
+			{
+				output_error("model image value '%s' of property %s could not be set", text, prop->name);
+				/* TROUBLESHOOT
+				   A property value stored in the model image was rejected by the object.
+				   Delete the model image or compile the model again and try again.
+				 */
+				return 0;
+			}
+		}
+	}
+	return !in->error;
+}
+
+/* rebuild the model once the image is known to match
+   @return 0 on failure */
+static int get_model(IMAGEREADER *in)
+{
+	char *tz = get_string(in);
+	CLASS **classes = NULL;
+	PROPERTY **props = NULL;
+	OBJECT **objects = NULL;
+	IMAGEFIXUP *fixup = NULL;
+	unsigned int n_fixups = 0;
+	uint32 n, i, n_classes = 0, n_props = 0, n_objects = 0;
+	int ok = 0;
+
+	if ( tz==NULL )
+		return 0;
+	if ( tz[0]!='\0' && timestamp_set_tz(tz)==NULL )
+		output_warning("model image timezone %s is not defined", tz);
+
+	/* globals and modules */
+	if ( !get_globals(in) )
+		return 0;
+	n = get_u32(in);
+	for ( i=0 ; i<n && !in->error ; i++ )
+	{
+		char *name = get_string(in);
+		if ( name!=NULL && module_find(name)==NULL && module_load(name,0,NULL)==NULL )
+		{
+			output_error("model image module '%s' could not be loaded", name);
+			/* TROUBLESHOOT
+			   A module used by the model could not be loaded.  Check that the module is installed and try again.
+			 */
+			return 0;
+		}
+	}
+	if ( !get_globals(in) )
+		return 0;
+
+	/* schedules */
+	n = get_u32(in);
+	for ( i=0 ; i<n && !in->error ; i++ )
+	{
+		char *name = get_string(in);
+		char *definition = get_string(in);
+		if ( definition!=NULL && schedule_create(name,definition)==NULL )
+			return 0;
+	}
+
+	/* classes and properties */
+	n_classes = get_u32(in);
+	if ( in->error || (classes=(CLASS**)malloc(sizeof(CLASS*)*(n_classes+1)))==NULL )
+		goto Done;
+	for ( i=0 ; i<n_classes && !in->error ; i++ )
+	{
+		char *name = get_string(in);
+		uint32 size = get_u32(in);
+		if ( name==NULL )
+			break;
+		classes[i] = class_get_class_from_classname(name);
+		if ( classes[i]==NULL || classes[i]->size!=size )
+		{
+			output_error("model image class '%s' does not match the class loaded", name);
+			/* TROUBLESHOOT
+			   A class stored in the model image is missing or has changed since the image was written.
+			   Delete the model image or compile the model again and try again.
+			 */
+			goto Done;
+		}
+	}
+	n_props = get_u32(in);
+	if ( in->error || (props=(PROPERTY**)malloc(sizeof(PROPERTY*)*(n_props+1)))==NULL )
+		goto Done;
+	for ( i=0 ; i<n_props && !in->error ; i++ )
+	{
+		uint32 oclass = get_u32(in);
+		char *name = get_string(in);
+		uint32 ptype = get_u32(in);
+		if ( name==NULL || oclass>=n_classes )
+		{
+			in->error = 1;
+			break;
+		}
+		props[i] = class_find_property(classes[oclass],name);
+		if ( props[i]==NULL || (uint32)props[i]->ptype!=ptype )
+		{
+			output_error("model image property '%s' of class '%s' does not match the class loaded", name, classes[oclass]->name);
+			/* TROUBLESHOOT
+			   A property stored in the model image is missing or has changed since the image was written.
+			   Delete the model image or compile the model again and try again.
+			 */
+			goto Done;
+		}
+	}
+
+	/* objects */
+	n_objects = get_u32(in);
+	if ( in->error || (objects=(OBJECT**)malloc(sizeof(OBJECT*)*(n_objects+1)))==NULL )
+		goto Done;
+	for ( i=0 ; i<n_objects && !in->error ; i++ )
+	{
+		IMAGEOBJECT rec, *hdr = &rec;
+		void *data = get(in,sizeof(IMAGEOBJECT));
+		char *name = get_string(in);
+		CLASS *oclass;
+		OBJECT *obj = NULL;
+		IMAGEFIXUP *grown;
+		if ( data==NULL || name==NULL )
+			break;
+		memcpy(&rec,data,sizeof(rec));
+		if ( hdr->oclass>=n_classes )
+		{
+			in->error = 1;
+			break;
+		}
+		oclass = classes[hdr->oclass];
+		if ( oclass->create!=NULL )
+		{
+			if ( (*oclass->create)(&obj,NULL)==0 || obj==NULL )
+			{
+				output_error("model image object %s:%d could not be created", oclass->name, first_id+i);
+				/* TROUBLESHOOT
+				   The class of an object stored in the model image failed to create it.
+				   Check the prior messages for the reason.
+				 */
+				goto Done;
+			}
+		}
+		else
+			obj = object_create_single(oclass);
+		if ( obj==NULL || obj->id!=first_id+i )
+		{
+			output_error("model image object %s:%d was not created in order", oclass->name, first_id+i);
+			/* TROUBLESHOOT
+			   Creating an object made by the model also created other objects, so the model image cannot be used.
+			   Delete the model image and try again.
+			 */
+			goto Done;
+		}
+		objects[i] = obj;
+		if ( name[0]!='\0' && object_set_name(obj,name)==NULL )
+			goto Done;
+
+		/* leave room for the references of this object and its parent */
+		grown = (IMAGEFIXUP*)realloc(fixup,sizeof(IMAGEFIXUP)*(n_fixups+hdr->nprops+1));
+		if ( grown==NULL )
+			goto Done;
+		fixup = grown;
+		if ( !get_properties(in,obj,hdr->nprops,props,n_props,fixup,&n_fixups) )
+			goto Done;
+		fixup[n_fixups].addr = &obj->parent;
+		fixup[n_fixups].index = hdr->parent;
+		n_fixups++;
+
+		/* the header as it was after the load, including the ranks */
+		obj->child_count = hdr->child_count;
+		obj->rank = hdr->rank;
+		obj->clock = hdr->clock;
+		obj->valid_to = hdr->valid_to;
+		obj->schedule_skew = hdr->schedule_skew;
+		obj->in_svc = hdr->in_svc;
+		obj->out_svc = hdr->out_svc;
+		obj->heartbeat = hdr->heartbeat;
+		obj->latitude = hdr->latitude;
+		obj->longitude = hdr->longitude;
+		obj->in_svc_double = hdr->in_svc_double;
+		obj->out_svc_double = hdr->out_svc_double;
+		obj->in_svc_micro = hdr->in_svc_micro;
+		obj->out_svc_micro = hdr->out_svc_micro;
+		obj->flags = hdr->flags;
+		memcpy(obj->groupid,hdr->groupid,sizeof(obj->groupid));
+	}
+	if ( in->error )
+		goto Done;
+
+	/* object references */
+	for ( i=0 ; i<n_fixups ; i++ )
+	{
+		if ( fixup[i].index>=(int32)n_objects )
+		{
+			in->error = 1;
+			goto Done;
+		}
+		*fixup[i].addr = fixup[i].index<0 ? NULL : objects[fixup[i].index];
+	}
+	output_verbose("%d object%s loaded from model image", n_objects, n_objects==1?"":"s");
+	ok = 1;
+Done:
+	free(classes);
+	free(props);
+	free(objects);
+	free(fixup);
+	return ok;
+}
+
+/** Load the model \p file from its image, if it has a current one.
+	@return 1 if the model was loaded from its image, 0 if the GLM must be
+	loaded instead, -1 if the image matched but could not be loaded
+ **/
+int image_load(char *file)
+{
+	char path[1024];
+	char *data = NULL;
+	long size;
+	FILE *fp;
+	IMAGEREADER in;
+	IMAGEHEADER *hdr;
+	uint64 hash = 0;
+	uint32 n, i;
+	int rv = 0;
+
+	image_begin();
+	if ( !global_use_image || global_compileonly || !image_name(file,path,sizeof(path)) )
+		return 0;
+	fp = fopen(path,"rb");
+	if ( fp==NULL )
+		return 0;
+	if ( fseek(fp,0,SEEK_END)!=0 || (size=ftell(fp))<=0 || fseek(fp,0,SEEK_SET)!=0
+		|| (data=(char*)malloc(size))==NULL || fread(data,1,size,fp)!=(size_t)size )
+	{
+		output_warning("%s: unable to read model image '%s'", file, path);
+		/* TROUBLESHOOT
+		   The model image exists but could not be read, so the model is loaded from the GLM file.
+		 */
+		fclose(fp);
+		free(data);
+		return 0;
+	}
+	fclose(fp);
+	in.pos = data;
+	in.end = data+size;
+	in.error = 0;
+
+	/* the image must be from this build and for these files and globals */
+	hdr = (IMAGEHEADER*)get(&in,sizeof(IMAGEHEADER));
+	if ( hdr==NULL || memcmp(hdr->magic,image_magic,sizeof(image_magic))!=0 || hdr->version!=IMAGE_VERSION
+		|| hdr->order!=IMAGE_ORDER || hdr->wordsize!=sizeof(void*)
+		|| hdr->major!=global_version_major || hdr->minor!=global_version_minor
+		|| hdr->patch!=global_version_patch || hdr->build!=global_version_build
+		|| strncmp(hdr->branch,global_version_branch,sizeof(hdr->branch)-1)!=0 )
+	{
+		output_verbose("model image '%s' was not written by this version, loading '%s'", path, file);
+		goto Done;
+	}
+	hash = entry_hash;
+	if ( !hash_file(&hash,file) )
+		goto Done;
+	n = get_u32(&in);
+	for ( i=0 ; i<n && !in.error ; i++ )
+	{
+		char *include = get_string(&in);
+		if ( include==NULL || !hash_file(&hash,include) )
+			break;
+	}
+	if ( !in.error && i==n )
+	{
+		/* the environment variables the loader read */
+		n = get_u32(&in);
+		for ( i=0 ; i<n && !in.error ; i++ )
+		{
+			char *name = get_string(&in);
+			if ( name==NULL )
+				break;
+			hash = hash_env(hash,name);
+		}
+	}
+	if ( in.error || i<n || hash!=hdr->hash || get_u32(&in)!=(uint32)object_get_count() )
+	{
+		output_verbose("model image '%s' is out of date, loading '%s'", path, file);
+		goto Done;
+	}
+
+	/* from here on the model is changed, so failures are errors */
+	if ( get_model(&in) && !in.error )
+	{
+		output_verbose("model '%s' loaded from image '%s'", file, path);
+		rv = 1;
+	}
+	else
+	{
+		output_error("%s: model image '%s' could not be loaded", file, path);
+		/* TROUBLESHOOT
+		   The model image matched the model but could not be loaded.  Check the prior messages,
+		   delete the model image and try again.
+		 */
+		rv = -1;
+	}
+Done:
+	free(data);
+	reset();
+	return rv;
+}
+
+/**@}**/
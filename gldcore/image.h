@@ -0,0 +1,61 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file image.h
+	@addtogroup image Model images
+	@ingroup core
+
+	Parsing a large GLM file, expanding its macros and includes and resolving
+	its references can take longer than a short simulation of it.  When the
+	\p --compile option is used, the loader records what it does to the model
+	while the GLM is parsed and, once the load succeeds, writes a binary model
+	image next to the model (\p model.glm gives \p model.gli).  The image
+	holds the modules, the globals the model changed, the schedules, and every
+	object with its header and the properties the model set, with object
+	references stored as object indexes.  Later loads of \p model.glm that
+	use the \p --image option read the image instead of parsing the GLM.
+	Without that option images are never read, so one left next to a model
+	cannot change how it is loaded.
+
+	The image is keyed by a hash of the GLM, of every file it included, and
+	of the public globals and timezone in effect when the load started, so
+	changing any of them, or using \p --define, falls back to the GLM.
+	The environment variables the GLM read through \p ${VAR}, \p #ifdef
+	and \p #ifndef are part of the key too.  The image
+	is also ignored when it was written by another version or build of
+	GridLAB-D.  Property values are restored as they were after the load,
+	through the same notifiers the loader uses, but parsing, unit conversion
+	and reference resolution are skipped.  Values the GLM computed when it
+	was parsed, such as \p ${NOW}, \p ${GUID} or random expressions, are
+	frozen in the image, as they are in a saved model.
+
+	Models that use features an image cannot reproduce (class definitions,
+	transforms and filters, imports, instances, scripts, links, namespaces,
+	and macros with side effects like \p #system or \p #setenv) are never
+	written to an image and always load from the GLM.
+ @{
+ **/
+
+#ifndef _IMAGE_H
+#define _IMAGE_H
+
+#include "object.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int image_load(char *file);
+STATUS image_save(char *file);
+void image_unsupported(char *feature);
+void image_include(char *file);
+char *image_getenv(char *name);
+void image_object(OBJECT *obj);
+void image_set(OBJECT *obj, PROPERTY *prop, int notify);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}**/
@@ -41,6 +41,7 @@ INDEX *index_create(int first_ordinal, /**< the first ordinal */
 		index->id = next_index_id++;
 		index->first_ordinal = first_ordinal;
 		index->last_ordinal = last_ordinal;
+		index->frozen = NULL;
 		memset(index->ordinal,0,sizeof(GLLIST*)*size);
 		output_verbose("creating index %d", index->id);
 	}
@@ -69,6 +70,17 @@ STATUS index_insert(INDEX *index,	/**< the index to which the item is added */
 {
 	int pos = ordinal - index->first_ordinal;
 
+	if (index->frozen!=NULL)
+	{
+		output_fatal("index %d is frozen and cannot accept new items", index->id);
+		/*	TROUBLESHOOT
+			This is an internal error caused by an attempt to add an item to an index
+			after its contiguous arrays were built.  Indexes are frozen when the
+			simulation starts and may not be changed afterwards.
+		*/
+		errno = EPERM;
+		return FAILED;
+	}
 	if (ordinal<index->first_ordinal) /* grow on bottom end */
 	{
 		/** @todo allow resizing indexes when ordinal is before first (ticket #28) */
@@ -136,4 +148,59 @@ void index_shuffle(INDEX *index)	/**< the index to shuffle */
 	output_verbose("shuffled %d lists in index %d", size, index->id);
 }
 
+/** Freeze an index by copying each ordinal list into a contiguous array.
+	The lists are kept so that existing list iterators still work, but the
+	arrays in \p index->frozen are much faster to scan and to partition.
+	When \p compare is not NULL each array is sorted with it (qsort convention,
+	each argument points to an item pointer).
+	@return SUCCESS on SUCCESS, FAILED otherwise
+ **/
+STATUS index_freeze(INDEX *index,	/**< the index to freeze */
+					int (*compare)(const void*,const void*)) /**< optional item sort order */
+{
+	int i, size = index->last_ordinal - index->first_ordinal;
+	size_t count = 0;
+	if (index->frozen!=NULL)
+		return SUCCESS;
+	index->frozen = (INDEXARRAY*)malloc(sizeof(INDEXARRAY)*size);
+	if (index->frozen==NULL)
+	{
+		output_fatal("unable to freeze index %d: %s",index->id, strerror(errno));
+		/*	TROUBLESHOOT
+			An internal memory allocation error cause an index operation to fail.
+			The message will usually include some explanation as to what cause
+			the failure.  Remedy the indicated memory problem to fix the indexing problem.
+		*/
+		return FAILED;
+	}
+	memset(index->frozen,0,sizeof(INDEXARRAY)*size);
+	for (i=0; i<size; i++)
+	{
+		GLLIST *list = index->ordinal[i];
+		LISTITEM *item;
+		size_t n = 0;
+		if (list==NULL || list->size==0)
+			continue;
+		index->frozen[i].item = (void**)malloc(sizeof(void*)*list->size);
+		if (index->frozen[i].item==NULL)
+		{
+			output_fatal("unable to freeze ordinal %d of index %d: %s",i+index->first_ordinal,index->id, strerror(errno));
+			/*	TROUBLESHOOT
+				An internal memory allocation error cause an index operation to fail.
+				The message will usually include some explanation as to what cause
+				the failure.  Remedy the indicated memory problem to fix the indexing problem.
+			*/
+			return FAILED;
+		}
+		for (item=list->first; item!=NULL; item=item->next)
+			index->frozen[i].item[n++] = item->data;
+		index->frozen[i].size = n;
+		if (compare!=NULL)
+			qsort(index->frozen[i].item,n,sizeof(void*),compare);
+		count += n;
+	}
+	output_verbose("froze %d items in index %d%s", (int)count, index->id, compare?" (sorted)":"");
+	return SUCCESS;
+}
+
 /**@}*/
@@ -12,9 +12,15 @@
 #include "globals.h"
 #include "list.h"
 
+typedef struct s_indexarray {
+	void **item;		/**< the contiguous block of items */
+	size_t size;		/**< the number of items in the block */
+} INDEXARRAY;	/**< the frozen form of an ordinal list */
+
 typedef struct s_index {
 	unsigned int id;	/**< the index id */
 	GLLIST **ordinal;		/**< the list of ordinals */
+	INDEXARRAY *frozen;	/**< the contiguous copy of each ordinal list (NULL until frozen) */
 	int first_ordinal;	/**< the first ordinal in the list */
 	int last_ordinal;	/**< the last ordinal in the list */
 	int last_used;		/**< the last ordinal in use */
@@ -24,6 +30,7 @@ typedef struct s_index {
 INDEX *index_create(int first_ordinal, int last_ordinal);
 STATUS index_insert(INDEX *index, void *data, int ordinal);
 void index_shuffle(INDEX *index);
+STATUS index_freeze(INDEX *index, int (*compare)(const void*,const void*));
 
 #endif
 
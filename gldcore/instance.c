@@ -18,6 +18,7 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <sys/errno.h>
+#include <sys/mman.h>
 #define SOCKET int
 #define INVALID_SOCKET (-1)
 #define closesocket close
@@ -34,6 +35,7 @@
 #include "exec.h"
 
 clock_t instance_synctime = 0;
+unsigned int instance_syncs = 0;
 
 // only used for passing control between slaveproc and main threads
 pthread_mutex_t mls_inst_lock;
@@ -215,11 +217,18 @@ void *instance_runproc(void *ptr)
 			break;
 #endif
 		case CI_SHMEM:
-#ifdef WIN32
-			rc = -1;
-			break;
+#ifdef INSTANCE_SHMEM
+			/* run new instance (system() returns when the slave exits); when the master
+			   was started without a directory, the slave is found on the PATH too */
+			sprintf(cmd,"%s%sgridlabd %s %s --slave localhost:%"FMT_INT64"x %s",
+				strcmp(global_execdir,global_execname)==0 ? "" : global_execdir,
+				strcmp(global_execdir,global_execname)==0 ? "" : "/",
+				global_verbose_mode?"--verbose":"", global_debug_output?"--debug":"", inst->cacheid, inst->model);
+			output_verbose("starting new instance with command '%s'", cmd);
+			rc = system(cmd);
 #else
-			// shmem not written yet
+			output_error("Shared Memory (shmem) instance mode is not supported on this system, please use Memory Map (mmap) or socket instead.");
+			rc = -1;
 #endif
 			break;
 		case CI_SOCKET:
@@ -343,6 +352,29 @@ int instance_master_wait_mmap(instance *inst){
 #endif
 }
 
+int instance_master_wait_shmem(instance *inst){
+#ifdef INSTANCE_SHMEM
+	if(0 == inst){
+		output_error("instance_master_wait_shmem(): null inst pointer");
+		return 0;
+	}
+	if ( !instance_shmem_wait(&inst->shm->master) )
+	{
+		if ( errno==ETIMEDOUT )
+			output_error("slave %d wait timeout", inst->id);
+		else
+			output_error("slave %d wait failed (%s)", inst->id, strerror(errno));
+		return 0;
+	}
+	output_debug("slave %d wait completed", inst->id);
+	/* the slave wrote its data into the cache itself */
+	return 1;
+#else
+	output_error("instance_master_wait_shmem(): shared memory is not supported on this system");
+	return 0;
+#endif
+}
+
 int instance_master_wait_socket(instance *inst){
 
 	if(0 == inst){
@@ -396,9 +428,10 @@ int instance_master_wait(void)
 		if(inst->cnxtype == CI_MMAP){
 			status = instance_master_wait_mmap(inst);
 		}
-#else
-	// @todo linux/unix slave signalling
 #endif
+		if(inst->cnxtype == CI_SHMEM){
+			status = instance_master_wait_shmem(inst);
+		}
 		if(inst->cnxtype == CI_SOCKET){
 			status = instance_master_wait_socket(inst);
 		}
@@ -427,7 +460,14 @@ void instance_master_done_mmap(instance *inst){
 }
 
 void instance_master_done_shmem(instance *inst){
-	;	// send
+	if(0 == inst){
+		output_error("instance_master_done_shmem(): null inst pointer");
+		return;
+	}
+#ifdef INSTANCE_SHMEM
+	/* the cache is already in the segment */
+	sem_post(&inst->shm->slave);
+#endif
 }
 
 void instance_master_done_socket(instance *inst){
@@ -638,6 +678,27 @@ STATUS instance_init(instance *inst)
 	@see instance_slave_done
 	@returns SUCCESS or FAILED.
  **/
+#ifdef INSTANCE_SHMEM
+/** instance_unlink_shmem
+	Removes the names of the shared memory segments. The master and slaves
+	keep their mappings, so this is done as soon as the slaves have opened
+	theirs, which keeps a killed run from leaving segments behind.
+ **/
+static void instance_unlink_shmem(void)
+{
+	instance *inst;
+	for ( inst=instance_list ; inst!=NULL ; inst=inst->next )
+	{
+		if ( inst->cnxtype==CI_SHMEM && inst->shm!=NULL )
+		{
+			char shmname[64];
+			sprintf(shmname,"/GLD-%"FMT_INT64"x",inst->cacheid);
+			shm_unlink(shmname);
+		}
+	}
+}
+#endif
+
 STATUS instance_initall(void)
 {
 	instance *inst = 0;
@@ -648,9 +709,6 @@ STATUS instance_initall(void)
 		global_multirun_mode = MRM_MASTER;
 		output_verbose("entering multirun mode");
 		output_prefix_enable();
-		pthread_mutex_lock(&mls_inst_lock);
-		pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
-		
 	} else {
 		return SUCCESS;
 	}
@@ -663,6 +721,9 @@ STATUS instance_initall(void)
 
 	// wait for slaves to signal init done
 	rv = instance_master_wait();
+#ifdef INSTANCE_SHMEM
+	instance_unlink_shmem();
+#endif
 	if(0 == rv){
 		output_error("instance_initall(): final wait() failed");
 		return FAILED;
@@ -694,7 +755,8 @@ STATUS instance_write_slave(instance *inst)
 		}
 	}
 	//output_verbose("copying %d bytes from %x to %x (%lli)", inst->cachesize, inst->cache, inst->buffer, inst->cache->ts);
-	memcpy(inst->buffer, inst->cache, inst->cachesize);
+	if ( inst->buffer!=(char*)inst->cache )
+		memcpy(inst->buffer, inst->cache, inst->cachesize);
 	printcontent(inst->buffer, (int)inst->cachesize);
 	return SUCCESS;
 }
@@ -785,6 +847,7 @@ TIMESTAMP instance_syncall(TIMESTAMP t1)
 	
 		output_debug("instance sync time is %"FMT_INT64"d", t2);
 		instance_synctime += (clock_t)exec_clock() - ts;
+		instance_syncs++;
 		return t2;
 	}
 	else
@@ -799,6 +862,9 @@ STATUS instance_dispose(){
 			// release pthread and event resources
 			;
 		}
+#ifdef INSTANCE_SHMEM
+		instance_unlink_shmem();
+#endif
 		return SUCCESS;
 	} else { // slave
 		//release pthread and event resources
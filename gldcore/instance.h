@@ -14,6 +14,11 @@
 #include "linkage.h"
 #include "lock.h"
 
+#if !defined WIN32 && !defined __APPLE__
+#define INSTANCE_SHMEM ///< POSIX shared memory with process-shared semaphores is available
+#include <semaphore.h>
+#endif
+
 #define HS_SYN		"GLDMTR"
 #define HS_ACK		"GLDSND"
 // note trailing space for CBK
@@ -60,6 +65,21 @@ typedef struct s_message {
 	char data;					///< first character in link data
 } MESSAGE; ///< message cache structure
 
+#ifdef INSTANCE_SHMEM
+/** Header of a shared memory connection.  The message cache follows it at
+	SHMCACHE(), and both sides read and write the cache in place.  Only one
+	side runs at a time: the master posts \p slave and waits on \p master, the
+	slave does the reverse.
+ **/
+typedef struct s_shmheader {
+	sem_t master;				///< posted by the slave when it is done
+	sem_t slave;				///< posted by the master when the slave may run
+	size_t size;				///< size of the message cache
+} SHMHEADER;
+#define SHMCACHEOFFSET ((sizeof(SHMHEADER)+63)&~(size_t)63) ///< offset of the cache in the segment
+#define SHMCACHE(H) ((MESSAGE*)((char*)(H)+SHMCACHEOFFSET)) ///< the cache of a segment
+#endif
+
 typedef struct s_message_wrapper {
 	MESSAGE *msg;
 	int16 *name_size;
@@ -126,6 +146,7 @@ typedef struct s_instance {
 			int fd; ///<
 			int shmkey; ///<
 			int shmid; ///<
+			struct s_shmheader *shm; ///< shared memory segment (shmem only)
 		};
 #endif
 		struct {
@@ -159,6 +180,7 @@ void instance_master_done(TIMESTAMP t1);
 STATUS instance_slave_init(void);
 int instance_slave_wait(void);
 void instance_slave_done(void);
+void instance_slave_yield(void);
 TIMESTAMP instance_presync(instance *inst, TIMESTAMP t1);
 TIMESTAMP instance_sync(instance *inst, TIMESTAMP t1);
 TIMESTAMP instance_postsync(instance *inst, TIMESTAMP t1);
@@ -174,4 +196,8 @@ STATUS linkage_slave_to_master(char *buffer, linkage *lnk);
 
 void printcontent(unsigned char *data, size_t len);
 
+#ifdef INSTANCE_SHMEM
+int instance_shmem_wait(sem_t *sem);
+#endif
+
 #endif
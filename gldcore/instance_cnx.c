@@ -1,5 +1,11 @@
 #include "instance_cnx.h"
 
+#ifdef INSTANCE_SHMEM
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <errno.h>
+#endif
+
 //extern pthread_mutex_t inst_sock_lock;
 extern pthread_cond_t inst_sock_signal;
 extern int sock_created;
@@ -94,10 +100,124 @@ STATUS instance_cnx_mmap(instance *inst){
 #endif
 }
 
+/** Create the shared memory segment of a local slave and move the
+	instance cache into it, so the linkages read and write the segment
+	directly and nothing is copied when the master and slave hand over.
+	@returns SUCCESS or FAILED
+ **/
 STATUS instance_cnx_shmem(instance *inst){
+#ifdef INSTANCE_SHMEM
+	char shmname[64];
+	size_t size;
+	MESSAGE *cache;
+	char *old_data;
+	linkage *lnk;
+
+	if(inst == 0){
+		output_error("instance_cnx_shmem: no instance provided");
+		/*	TROUBLESHOOT
+			There was an internal error that was not caught prior to attempting to construct
+			the message-passing layer without an instance for context.
+			*/
+		return FAILED;
+	}
+
+	/* create the segment */
+	sprintf(shmname,"/GLD-%"FMT_INT64"x",inst->cacheid);
+	size = SHMCACHEOFFSET + inst->cachesize;
+	inst->fd = shm_open(shmname,O_RDWR|O_CREAT|O_EXCL,0600);
+	if ( inst->fd<0 )
+	{
+		output_error("unable to create shared memory '%s' for instance '%s' (%s)", shmname, inst->model, strerror(errno));
+		/* TROUBLESHOOT
+		   The shared memory segment used to exchange data with a local slave could not be created.
+		   If the error says the file exists, a previous run using the same cacheid did not shut down
+		   cleanly; remove the segment from /dev/shm or use a different cacheid and try again.
+		   */
+		return FAILED;
+	}
+	inst->shm = ftruncate(inst->fd,(off_t)size)==0 ? (SHMHEADER*)mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_SHARED,inst->fd,0) : (SHMHEADER*)MAP_FAILED;
+	if ( inst->shm==(SHMHEADER*)MAP_FAILED )
+	{
+		output_error("unable to map shared memory '%s' for instance '%s' (%s)", shmname, inst->model, strerror(errno));
+		close(inst->fd);
+		shm_unlink(shmname);
+		inst->shm = NULL;
+		return FAILED;
+	}
+	memset(inst->shm,0,SHMCACHEOFFSET);
+	inst->shm->size = inst->cachesize;
+	if ( sem_init(&inst->shm->master,1,0)!=0 )
+	{
+		output_error("unable to create signals in shared memory '%s' for instance '%s' (%s)", shmname, inst->model, strerror(errno));
+		munmap(inst->shm,size);
+		close(inst->fd);
+		shm_unlink(shmname);
+		inst->shm = NULL;
+		return FAILED;
+	}
+	if ( sem_init(&inst->shm->slave,1,0)!=0 )
+	{
+		output_error("unable to create signals in shared memory '%s' for instance '%s' (%s)", shmname, inst->model, strerror(errno));
+		sem_destroy(&inst->shm->master);
+		munmap(inst->shm,size);
+		close(inst->fd);
+		shm_unlink(shmname);
+		inst->shm = NULL;
+		return FAILED;
+	}
+	output_debug("shared memory '%s' created for instance '%s'", shmname, inst->model);
+
+	/* move the cache into the segment and point the linkages at it */
+	cache = SHMCACHE(inst->shm);
+	memcpy(cache, inst->cache, inst->cachesize);
+	old_data = inst->message->data_buffer;
+	free(inst->message);
+	if ( FAILED == messagewrapper_init(&(inst->message), cache) )
+		return FAILED;
+	for ( lnk=inst->write ; lnk!=NULL ; lnk=lnk->next )
+		lnk->addr = inst->message->data_buffer + (lnk->addr - old_data);
+	for ( lnk=inst->read ; lnk!=NULL ; lnk=lnk->next )
+		lnk->addr = inst->message->data_buffer + (lnk->addr - old_data);
+	free(inst->cache);
+	inst->cache = cache;
+	inst->buffer = (char*)cache;
+
+	output_verbose("slave %d assigned to '%s'", inst->id, inst->model);
+	return SUCCESS;
+#else
+	output_error("Shared Memory (shmem) instance mode is not supported on this system, please use Memory Map (mmap) or socket instead.");
 	return FAILED;
+#endif
 }
 
+#ifdef INSTANCE_SHMEM
+/** Wait for the other side of a shared memory connection to post \p sem,
+	for at most #global_signal_timeout milliseconds (forever if negative).
+	@returns 1 when posted, 0 on timeout (errno is ETIMEDOUT) or error
+ **/
+int instance_shmem_wait(sem_t *sem)
+{
+	struct timespec until;
+	int rv;
+	if ( global_signal_timeout<0 )
+	{
+		while ( (rv=sem_wait(sem))!=0 && errno==EINTR ) {}
+		return rv==0;
+	}
+	clock_gettime(CLOCK_REALTIME,&until);
+	until.tv_sec += global_signal_timeout/1000;
+	until.tv_nsec += (long)(global_signal_timeout%1000)*1000000L;
+	if ( until.tv_nsec>=1000000000L )
+	{
+		until.tv_sec++;
+		until.tv_nsec -= 1000000000L;
+	}
+	while ( (rv=sem_timedwait(sem,&until))!=0 && errno==EINTR ) {}
+	return rv==0;
+}
+#endif
+
 STATUS instance_cnx_socket(instance *inst){
 	char cmd[1024];
 	char sendcmd[1024];
@@ -1,5 +1,12 @@
 #include "instance_slave.h"
 
+#ifdef INSTANCE_SHMEM
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <errno.h>
+#endif
+
 // in practice, these are initialized by instance.c
 extern clock_t instance_synctime;
 
@@ -18,6 +25,55 @@ unsigned int slave_id;
 pthread_t slave_tid;
 static instance local_inst;
 
+/* which thread of the slave may run, guarded by mls_inst_lock */
+static enum {
+	SLAVE_MAIN,			/* the main exec loop runs */
+	SLAVE_CONTROLLER,	/* the controller exchanges with the master */
+	SLAVE_DETACHED,		/* the controller has exited */
+} slave_turn = SLAVE_MAIN;
+
+/** instance_slave_yield
+	Called by the slave's main exec loop to let the controller exchange with
+	the master, returns when the controller hands control back (or exits).
+ **/
+void instance_slave_yield(void)
+{
+	pthread_mutex_lock(&mls_inst_lock);
+	if ( slave_turn!=SLAVE_DETACHED )
+	{
+		slave_turn = SLAVE_CONTROLLER;
+		pthread_cond_broadcast(&mls_inst_signal);
+		while ( slave_turn==SLAVE_CONTROLLER )
+			pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
+	}
+	pthread_mutex_unlock(&mls_inst_lock);
+}
+
+/* controller side of instance_slave_yield() */
+static void instance_slave_wait_turn(void)
+{
+	pthread_mutex_lock(&mls_inst_lock);
+	while ( slave_turn==SLAVE_MAIN )
+		pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
+	pthread_mutex_unlock(&mls_inst_lock);
+}
+static void instance_slave_give_turn(int turn)
+{
+	pthread_mutex_lock(&mls_inst_lock);
+	slave_turn = turn;
+	pthread_cond_broadcast(&mls_inst_signal);
+	pthread_mutex_unlock(&mls_inst_lock);
+}
+
+/* post the time the master sent in the cache to the main exec loop */
+static void instance_slave_sync_cache(void)
+{
+	struct sync_data sd;
+	exec_sync_reset(&sd);
+	exec_sync_set(&sd,local_inst.cache->ts,false);
+	exec_sync_merge(NULL,&sd);
+}
+
 STATUS instance_slave_get_data(void *buffer, size_t offset, size_t sz){
 	if(0 == buffer){
 		output_error("instance_slave_get_data(): null buffer pointer");
@@ -348,7 +404,12 @@ int instance_slave_wait(void)
 	} else if(local_inst.cnxtype == CI_SOCKET){
 		status = instance_slave_wait_socket();
 	} else if(local_inst.cnxtype == CI_SHMEM){
-		; // linux-specific
+#ifdef INSTANCE_SHMEM
+		/* the master wrote its data into the cache itself */
+		status = instance_shmem_wait(&local_inst.shm->slave);
+		if ( !status )
+			output_error("instance_slave_wait(): slave %d wait %s (%s)", slave_id, errno==ETIMEDOUT?"timeout":"failed", strerror(errno));
+#endif
 	}
 	/* signal main loop to resume with new timestamp */
 	return status;
@@ -424,6 +485,9 @@ void instance_slave_done(void)
 			rv = instance_slave_done_mmap();
 			break;
 		case CI_SHMEM:
+#ifdef INSTANCE_SHMEM
+			rv = sem_post(&local_inst.shm->master);
+#endif
 			break;
 		case CI_SOCKET:
 			rv = instance_slave_done_socket();
@@ -449,9 +513,8 @@ void *instance_slaveproc(void *ptr)
 	STATUS rv = SUCCESS;
 	output_verbose("instance_slaveproc(): slave %d controller startup in progress", slave_id);
 
-	pthread_mutex_lock(&mls_inst_lock);
-	pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
-	pthread_mutex_unlock(&mls_inst_lock);
+	/* wait for the main loop to start */
+	instance_slave_wait_turn();
 
 	rv = instance_slave_link_properties();
 
@@ -465,7 +528,6 @@ void *instance_slaveproc(void *ptr)
 			/* stop the main loop and exit the slave controller */
 			output_error("instance_slaveproc(): slave %d controller wait failure, thread stopping", slave_id);
 			exec_setexitcode(XC_PRCERR);
-			pthread_cond_broadcast(&mls_inst_signal);
 			break;
 		}
 
@@ -485,20 +547,16 @@ void *instance_slaveproc(void *ptr)
 		//output_debug("slave %d controller resuming exec with %lli", slave_id, local_inst.cache->ts);
 		output_debug("slave %d controller resuming exec with %lli", local_inst.cache->id, local_inst.cache->ts);
 		output_debug("slave %d controller setting step_to %lli to cache->ts %lli", local_inst.cache->id, exec_sync_get(NULL), local_inst.cache->ts);
-		exec_sync_merge(NULL,(void*)&local_inst.cache);
-
-		pthread_cond_broadcast(&mls_inst_signal);
+		instance_slave_sync_cache();
 
 		if(local_inst.cache->ts == TS_NEVER){
 			break;
 		}
+		instance_slave_give_turn(SLAVE_MAIN);
 
 		/* wait for main loop to pause */
 		output_verbose("slave %d controller waiting for main to complete", slave_id);
-
-		pthread_mutex_lock(&mls_inst_lock);
-		pthread_cond_wait(&mls_inst_signal, &mls_inst_lock);
-		pthread_mutex_unlock(&mls_inst_lock);
+		instance_slave_wait_turn();
 
 		/* @todo copy output linkages */
 		output_debug("slave %d controller writing links", slave_id);
@@ -513,11 +571,13 @@ void *instance_slaveproc(void *ptr)
 
 		/* copy the next time stamp */
 		/* how about we copy the time we want to step to and see what the master says, instead? -MH */
-		exec_sync_reset((void*)&local_inst.cache);
-		exec_sync_set((void*)&local_inst.cache,0,false);
+		local_inst.cache->ts = exec_sync_get(NULL);
 
 		instance_slave_done();
 	} while (global_clock != TS_NEVER && rv == SUCCESS);
+
+	/* the main loop must not wait on this thread any more */
+	instance_slave_give_turn(SLAVE_DETACHED);
 	output_verbose("slave %"FMT_INT64" completion state reached", local_inst.cacheid);
 	pthread_exit(NULL);
 	return NULL;
@@ -580,7 +640,7 @@ STATUS instance_slave_init_mem(){
 	
 	local_inst.name_size = *(local_inst.message->name_size);
 	local_inst.prop_size = *(local_inst.message->data_size);
-	exec_sync_merge(NULL,(void*)&local_inst.cache);
+	instance_slave_sync_cache();
 
 	/* open slave signalling event */
 	sprintf(eventName,"GLD-%"FMT_INT64"x-S", global_master_port);
@@ -608,8 +668,56 @@ STATUS instance_slave_init_mem(){
 		output_debug("opened event signal '%s' for slave %d ", eventName, slave_id);
 	}
 	return SUCCESS;
+#elif defined INSTANCE_SHMEM
+	char cacheName[64];
+	struct stat st;
+	void *map;
+
+	output_debug("instance_slave_init_mem()");
+	local_inst.cacheid = global_master_port;
+	sprintf(cacheName,"/GLD-%"FMT_INT64"x",global_master_port);
+	local_inst.fd = shm_open(cacheName,O_RDWR,0);
+	if ( local_inst.fd<0 )
+	{
+		output_error("unable to open cache '%s' for slave (%s)", cacheName, strerror(errno));
+		return FAILED;
+	}
+	if ( fstat(local_inst.fd,&st)!=0 || (size_t)st.st_size<SHMCACHEOFFSET+sizeof(MESSAGE) )
+	{
+		output_error("cache '%s' is not a valid slave cache", cacheName);
+		close(local_inst.fd);
+		return FAILED;
+	}
+	map = mmap(NULL,(size_t)st.st_size,PROT_READ|PROT_WRITE,MAP_SHARED,local_inst.fd,0);
+	if ( map==MAP_FAILED )
+	{
+		output_error("unable to map cache '%s' for slave (%s)", cacheName, strerror(errno));
+		close(local_inst.fd);
+		return FAILED;
+	}
+	output_debug("cache '%s' opened for slave", cacheName);
+
+	// the cache is used in place, nothing is copied
+	local_inst.shm = (SHMHEADER*)map;
+	local_inst.cache = SHMCACHE(local_inst.shm);
+	local_inst.filemap = (void*)local_inst.cache;
+	local_inst.buffer = (char*)local_inst.cache;
+	local_inst.buffer_size = local_inst.cachesize = local_inst.shm->size;
+	if ( SHMCACHEOFFSET+local_inst.cachesize>(size_t)st.st_size || local_inst.cache->name_size<0 || local_inst.cache->data_size<0 )
+	{
+		output_error("cache '%s' is not a valid slave cache", cacheName);
+		return FAILED;
+	}
+	local_inst.id = slave_id = local_inst.cache->id;
+	if ( FAILED == messagewrapper_init(&(local_inst.message), local_inst.cache) )
+		return FAILED;
+	local_inst.name_size = *(local_inst.message->name_size);
+	local_inst.prop_size = *(local_inst.message->data_size);
+	instance_slave_sync_cache();
+	return SUCCESS;
 #else
-	// @todo linux/unix slave signalling
+	output_error("memory-based slave connections are not supported on this system");
+	return FAILED;
 #endif
 }
 
@@ -720,8 +828,8 @@ STATUS instance_slave_init_socket(){
 	local_inst.cache->name_size = (int16)local_inst.name_size;
 	local_inst.cache->data_size = (int16)local_inst.prop_size;
 	local_inst.cache->id = local_inst.id;
-	exec_sync_set((void*)&local_inst.cache,pickle.ts,false);
-	exec_sync_merge(NULL,(void*)&local_inst.cache);
+	local_inst.cache->ts = pickle.ts;
+	instance_slave_sync_cache();
 	if(0 == local_inst.buffer){
 		output_error("malloc() error with li.buffer");
 		return FAILED;
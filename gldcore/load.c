@@ -169,6 +169,7 @@ typedef struct _stat STAT;
 #define snprintf _snprintf
 #else
 #include <unistd.h>
+#include <sys/mman.h>
 typedef struct stat STAT;
 #define FSTAT fstat
 #endif
@@ -185,6 +186,7 @@ typedef struct stat STAT;
 #include "instance.h"
 #include "linkage.h"
 #include "gui.h"
+#include "image.h"
 
 static unsigned int linenum=1;
 static int include_fail = 0;
@@ -4002,6 +4004,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 		LOADMETHOD *method = class_get_loadmethod(obj->oclass,propname);
 		if ( method!=NULL )
 		{
+			image_unsupported("load methods");
 			if ( TERM(value(HERE,propval,sizeof(propval))) )
 			{
 				if ( method->call(obj,propval)==1 )
@@ -4031,6 +4034,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 			{
 				char objname[64];
 				if (subobj->name) strcpy(objname,subobj->name); else sprintf(objname,"%s:%d", subobj->oclass->name,subobj->id);
+				image_set(obj,prop,TRUE);
 				if (object_set_value_by_name(obj,propname,objname))
 					ACCEPT
 				else
@@ -4078,6 +4082,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					output_error_raw("%s(%d): unable to get value of inherit property '%s'", filename, linenum, propname);
 					REJECT;
 				}
+				image_set(obj,prop,TRUE);
 				if ( object_set_value_by_name(obj,propname,value)<=0 )
 				{
 					output_error_raw("%s(%d): unable to set value of inherit property '%s'", filename, linenum, propname);
@@ -4091,7 +4096,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					output_error_raw("%s(%d): units of value are incompatible with units of property, cannot convert from %s to %s", filename, linenum, unit->name,prop->unit->name);
 					REJECT;
 				}
-				else if (object_set_complex_by_name(obj,propname,cval)==0)
+				else if (image_set(obj,prop,FALSE),object_set_complex_by_name(obj,propname,cval)==0)
 				{
 					output_error_raw("%s(%d): property %s of %s %s could not be set to '%g%+gi'", filename, linenum, propname, format_object(obj), cval.r, cval.i);
 					REJECT;
@@ -4106,7 +4111,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					output_error_raw("%s(%d): units of value are incompatible with units of property, cannot convert from %s to %s", filename, linenum, unit->name,prop->unit->name);
 					REJECT;
 				}
-				else if (object_set_double_by_name(obj,propname,dval)==0)
+				else if (image_set(obj,prop,FALSE),object_set_double_by_name(obj,propname,dval)==0)
 				{
 					output_error_raw("%s(%d): property %s of %s %s could not be set to '%g'", filename, linenum, propname, format_object(obj), dval);
 					REJECT;
@@ -4121,7 +4126,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					output_error_raw("%s(%d): units of value are incompatible with units of property, cannot convert from %s to %s", filename, linenum, unit->name,prop->unit->name);
 					REJECT;
 				}
-				else if (object_set_double_by_name(obj,propname,dval)==0)
+				else if (image_set(obj,prop,FALSE),object_set_double_by_name(obj,propname,dval)==0)
 				{
 					output_error_raw("%s(%d): property %s of %s %s could not be set to '%g'", filename, linenum, propname, format_object(obj), dval);
 					REJECT;
@@ -4140,6 +4145,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					output_error_raw("%s(%d): units of value are incompatible with units of property, cannot convert from %s to %s", filename, linenum, unit->name,prop->unit->name);
 					REJECT;
 				} else {
+					image_set(obj,prop,FALSE);
 					switch(prop->ptype){
 						case PT_int16:
 							ival16 = (int16)dval;
@@ -4179,6 +4185,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 				&& TERM(linear_transform(HERE, &xstype, &source,&scale,&bias,obj)))
 			{
 				void *target = (void*)((char*)(obj+1) + (int64)prop->addr);
+				image_unsupported("transforms");
 
 				/* add the transform list */
 				if (!transform_add_linear(xstype,source,target,scale,bias,obj,prop,(xstype == XS_SCHEDULE ? source : 0)))
@@ -4224,6 +4231,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 				}
 
 				/* add to external transform list */
+				image_unsupported("transforms");
 				if ( !transform_add_external(obj,prop,transformname,source_obj,source_prop) )
 				{
 					output_error_raw("%s(%d): external transform could not be created - %s", filename, linenum, errno?strerror(errno):"(no details)");
@@ -4268,6 +4276,7 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 				}
 
 				/* add to external transform list */
+				image_unsupported("filters");
 				if ( !transform_add_filter(obj,prop,transformname,source_obj,source_prop) )
 				{
 					output_error_raw("%s(%d): filter transform could not be created - %s", filename, linenum, errno?strerror(errno):"(no details)");
@@ -4399,11 +4408,12 @@ static int object_properties(PARSER, CLASS *oclass, OBJECT *obj)
 					}
 					else
 					{
+						image_set(obj,prop,FALSE);
 						add_unresolved(obj,PT_object,addr,oclass,propval,filename,linenum,UR_NONE);
 						ACCEPT;
 					}
 				}
-				else if (object_set_value_by_name(obj,propname,propval)==0)
+				else if (image_set(obj,prop,TRUE),object_set_value_by_name(obj,propname,propval)==0)
 				{
 					output_error_raw("%s(%d): property %s of %s could not be set to '%s'", filename, linenum, propname, format_object(obj), propval);
 					REJECT;
@@ -4510,6 +4520,7 @@ static int object_block(PARSER, OBJECT *parent, OBJECT **subobj)
 	if WHITE ACCEPT;
 	if (LITERAL("namespace") && (WHITE,TERM(name(HERE,space,sizeof(space)))) && (WHITE,LITERAL("{")))
 	{
+		image_unsupported("namespaces");
 		if (!object_open_namespace(space))
 		{
 			output_error_raw("%s(%d): namespace %s could not be opened", filename, linenum, space);
@@ -4627,6 +4638,7 @@ static int object_block(PARSER, OBJECT *parent, OBJECT **subobj)
 			}
 			object_set_parent(obj,parent);
 		}
+		image_object(obj);
 		if (id!=-1 && load_set_index(obj,(OBJECTNUM)id)==FAILED)
 		{
 			output_error_raw("%s(%d): unable to index object id number for %s:%d", filename, linenum, classname, id);
@@ -5810,6 +5822,7 @@ static int modify_directive(PARSER)
 			OBJECT *obj = object_find_name(oname);
 			if ( obj )
 			{
+				image_set(obj,class_find_property(obj->oclass,pname),TRUE);
 				if ( object_set_value_by_name(obj,pname,ovalue)<0 )
 				{
 					output_error_raw("%s(%d): modify property '%s' of object '%s' couldn't not be set to '%' ", filename, linenum, pname, oname, ovalue);
@@ -5841,20 +5854,20 @@ static int gridlabd_file(PARSER)
 	OR if LITERAL(";") {ACCEPT; DONE;}
 	OR if TERM(line_spec(HERE)) { ACCEPT; DONE; }
 	OR if TERM(object_block(HERE,NULL,NULL)) {ACCEPT; DONE;}
-	OR if TERM(class_block(HERE)) {ACCEPT; DONE;}
+	OR if TERM(class_block(HERE)) { image_unsupported("class definitions"); ACCEPT; DONE;}
 	OR if TERM(module_block(HERE)) {ACCEPT; DONE;}
 	OR if TERM(clock_block(HERE)) {ACCEPT; DONE;}
-	OR if TERM(import(HERE)) {ACCEPT; DONE; }
-	OR if TERM(export(HERE)) {ACCEPT; DONE; }
+	OR if TERM(import(HERE)) { image_unsupported("imports"); ACCEPT; DONE; }
+	OR if TERM(export(HERE)) { image_unsupported("exports"); ACCEPT; DONE; }
 	OR if TERM(library(HERE)) {ACCEPT; DONE; }
 	OR if TERM(schedule(HERE)) {ACCEPT; DONE; }
-	OR if TERM(instance_block(HERE)) {ACCEPT; DONE; }
-	OR if TERM(gui(HERE)) {ACCEPT; DONE;}
-	OR if TERM(extern_block(HERE)) {ACCEPT; DONE; }
-	OR if TERM(filter_block(HERE)) {ACCEPT; DONE; }
+	OR if TERM(instance_block(HERE)) { image_unsupported("instances"); ACCEPT; DONE; }
+	OR if TERM(gui(HERE)) { image_unsupported("GUI definitions"); ACCEPT; DONE;}
+	OR if TERM(extern_block(HERE)) { image_unsupported("external functions"); ACCEPT; DONE; }
+	OR if TERM(filter_block(HERE)) { image_unsupported("filters"); ACCEPT; DONE; }
 	OR if TERM(global_declaration(HERE)) {ACCEPT; DONE; }
-	OR if TERM(link_declaration(HERE)) { ACCEPT; DONE; }
-	OR if TERM(script_directive(HERE)) { ACCEPT; DONE; }
+	OR if TERM(link_declaration(HERE)) { image_unsupported("links"); ACCEPT; DONE; }
+	OR if TERM(script_directive(HERE)) { image_unsupported("scripts"); ACCEPT; DONE; }
 	OR if TERM(modify_directive(HERE)) { ACCEPT; DONE; }
 	OR if (*(HERE)=='\0') {ACCEPT; DONE;}
 	else REJECT;
@@ -5870,7 +5883,7 @@ int replace_variables(char *to,char *from,int len,int warn)
 		char varname[1024];
 		if (sscanf(p+2,"%1024[^}]",varname)==1)
 		{
-			char *env = getenv(varname);
+			char *env = image_getenv(varname);
 			char *var;
 			int m = (int)(p-e);
 			strncpy(to+n,e,m);
@@ -5990,7 +6003,90 @@ static int buffer_read(FILE *fp, char *buffer, char *filename, int size)
 	return n;
 }
 
-static int buffer_read_alt(FILE *fp, char *buffer, char *filename, int size)
+/* A GLM file being read.  The whole file is mapped into memory (or read in
+   one call where it cannot be mapped) so lines are found with memchr and
+   copied to the parse buffer once, instead of through stdio and the
+   comment, variable and macro passes, which only lines that need them get.
+   This only speeds up reading: lines are still copied into the parse
+   buffer, which is tokenized in place, and object blocks are still parsed
+   one at a time because the parser keeps its state in file-scope variables
+   and creates objects (ids, names, unresolved references) as it goes.
+ */
+typedef struct s_loadsource {
+	char *data; /**< the contents of the file */
+	size_t size; /**< the number of bytes in data */
+	size_t pos; /**< the offset of the next line */
+	int mapped; /**< data is mapped rather than allocated */
+} LOADSOURCE;
+
+static int source_open(LOADSOURCE *src, FILE *fp)
+{
+	STAT st;
+	memset(src,0,sizeof(LOADSOURCE));
+	if ( FSTAT(fileno(fp),&st)!=0 )
+		return 0;
+	if ( st.st_size<=0 )
+		return 1;
+	src->size = (size_t)st.st_size;
+#ifndef WIN32
+	src->data = (char*)mmap(NULL,src->size,PROT_READ,MAP_PRIVATE,fileno(fp),0);
+	if ( src->data!=(char*)MAP_FAILED )
+	{
+		src->mapped = 1;
+		madvise(src->data,src->size,MADV_SEQUENTIAL);
+		return 1;
+	}
+#endif
+	/* text mode reads may return fewer bytes than the file size */
+	src->data = (char*)malloc(src->size);
+	if ( src->data==NULL )
+		return 0;
+	src->size = fread(src->data,1,src->size,fp);
+	return ferror(fp)==0;
+}
+
+static void source_close(LOADSOURCE *src)
+{
+#ifndef WIN32
+	if ( src->mapped )
+		munmap(src->data,src->size);
+	else
+#endif
+	free(src->data);
+	memset(src,0,sizeof(LOADSOURCE));
+}
+
+/* the next line (with its newline) and its length, like fgets() with a buffer of max bytes */
+static char *source_gets(LOADSOURCE *src, int *len, int max)
+{
+	char *line = src->data + src->pos;
+	size_t left = src->size - src->pos;
+	char *eol;
+	if ( left==0 )
+		return NULL;
+	if ( left>(size_t)max-1 )
+		left = (size_t)max-1;
+	eol = (char*)memchr(line,'\n',left);
+	*len = (int)(eol ? eol-line+1 : left);
+	src->pos += *len;
+	return line;
+}
+
+/* true if the line has a comment, a variable or a NUL that the full line processing must see */
+static int source_plain(char *line, int len)
+{
+	int i;
+	for ( i=0 ; i<len ; i++ )
+	{
+		if ( line[i]=='\0' )
+			return 0;
+		if ( i+1<len && ((line[i]=='/' && line[i+1]=='/') || (line[i]=='$' && line[i+1]=='{')) )
+			return 0;
+	}
+	return 1;
+}
+
+static int buffer_read_alt(LOADSOURCE *src, char *buffer, char *filename, int size)
 {
 	char line[10240];
 	char *buf = buffer;
@@ -6000,14 +6096,32 @@ static int buffer_read_alt(FILE *fp, char *buffer, char *filename, int size)
 	int bnest = 0, quote = 0;
 	int hassc = 0; // has semicolon
 	int quoteline = 0;
-	while (fgets(line,sizeof(line),fp)!=NULL)
+	char *text;
+	int len;
+	while ((text=source_gets(src,&len,sizeof(line)))!=NULL)
 	{
-		int len;
 		char subst[65536];
+		char *c;
 
-		/* comments must have preceding whitespace in macros */
-		char *c = line[0]!='#'?strstr(line,COMMENT):strstr(line, " " COMMENT);
 		_linenum++;
+#ifndef OLDSTYLE
+		/* lines with nothing to expand go straight into the buffer */
+		if (suppress==0 && text[0]!='#' && len<size-1 && source_plain(text,len))
+		{
+			memcpy(buffer,text,len);
+			buffer[len] = '\0';
+			text = buffer;
+			buffer += len;
+			size -= len;
+			n += len;
+			goto Scan;
+		}
+#endif
+		memcpy(line,text,len);
+		line[len] = '\0';
+
+		/* comments must have preceding whitespace in macros */
+		c = line[0]!='#'?strstr(line,COMMENT):strstr(line, " " COMMENT);
 		if (c!=NULL) /* truncate at comment */
 			strcpy(c,"\n");
 		len = (int)strlen(line);
@@ -6041,7 +6155,7 @@ static int buffer_read_alt(FILE *fp, char *buffer, char *filename, int size)
 		{
 			/* macro disables reading */
 			if (process_macro(line,sizeof(line),filename,linenum + _linenum - 1)==FALSE){
-				return 0;
+				return -1;
 			} else {
 				++hassc;
 			}
@@ -6057,26 +6171,28 @@ static int buffer_read_alt(FILE *fp, char *buffer, char *filename, int size)
 		else if (suppress==0)
 		{
 			strcpy(buffer,subst);
+			text = buffer;
 			buffer+=len;
 			size -= len;
 			n+=len;
+Scan:
 			for(i = 0; i < len; ++i){
 				if(quote == 0){
-					if(subst[i] == '\"'){
+					if(text[i] == '\"'){
 						quoteline = linenum + _linenum - 1;
 						quote = 1;
-					} else if(subst[i] == '{'){
+					} else if(text[i] == '{'){
 						++bnest;
 						++hassc;
 						// @TODO push context
-					} else if(subst[i] == '}'){
+					} else if(text[i] == '}'){
 						--bnest;
 						// @TODO pop context
-					} else if(subst[i] == ';'){
+					} else if(text[i] == ';'){
 						++hassc;
 					}
 				} else {
-					if(subst[i] == '\"'){
+					if(text[i] == '\"'){
 						quote = 0;
 					}
 				}
@@ -6119,6 +6235,7 @@ static int include_file(char *incname, char *buffer, int size, int _linenum)
 	STAT stat;
 	char ff[1024];
 	FILE *fp = 0;
+	LOADSOURCE src;
 	char buffer2[20480];
 	unsigned int old_linenum = _linenum;
 	/* check include list */
@@ -6173,8 +6290,11 @@ static int include_file(char *incname, char *buffer, int size, int _linenum)
 		return -1;
 	}
 	else
+	{
 		output_verbose("include_file(char *incname='%s', char *buffer=0x%p, int size=%d): search of GLPATH='%s' result is '%s'", 
 			incname, buffer, size, getenv("GLPATH") ? getenv("GLPATH") : "NULL", ff ? ff : "NULL");
+		image_include(ff);
+	}
 
 	old_linenum = linenum;
 	linenum = 1;
@@ -6201,7 +6321,13 @@ static int include_file(char *incname, char *buffer, int size, int _linenum)
 	include_list = this;
 	//count = buffer_read(fp,buffer,incname,size); // fread(buffer,1,stat.st_size,fp);
 
-	move = buffer_read_alt(fp, buffer2, incname, 20479);
+	if ( !source_open(&src,fp) )
+	{
+		output_error_raw("%s(%d): unable to read included file", incname, old_linenum);
+		fclose(fp);
+		return -1;
+	}
+	move = buffer_read_alt(&src, buffer2, incname, 20479);
 	while(move > 0){
 		count += move;
 		p = buffer2; // grab a block
@@ -6217,8 +6343,14 @@ static int include_file(char *incname, char *buffer, int size, int _linenum)
 			count = -1;
 			break;
 		}
-		move = buffer_read_alt(fp, buffer2, incname, 20479);
+		move = buffer_read_alt(&src, buffer2, incname, 20479);
+	}
+	if(move < 0){
+		// a macro failed (e.g., #error)
+		count = -1;
 	}
+	source_close(&src);
+	fclose(fp);
 
 	//include_list = this.next;
 
@@ -6403,7 +6535,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		//if (sscanf(term+1,"%[^\n\r]",value)==1 && global_getvar(value, buffer, 63)==NULL && getenv(value)==NULL)
 		strcpy(value, strip_right_white(term+1));
-		if ( !is_autodef(value) && global_getvar(value, buffer, 63)==NULL && getenv(value)==NULL){
+		if ( !is_autodef(value) && global_getvar(value, buffer, 63)==NULL && image_getenv(value)==NULL){
 			suppress |= (1<<nesting);
 		}
 		macro_line[nesting] = linenum;
@@ -6418,6 +6550,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		char *term = strchr(line+8,' ');
 		char value[1024];
 		char path[1024];
+		image_unsupported("#ifexist");
 		if (term==NULL)
 		{
 			output_error_raw("%s(%d): %sifexist macro missing term",filename,linenum,MACRO);
@@ -6451,7 +6584,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		}
 		//if (sscanf(term+1,"%[^\n\r]",value)==1 && global_getvar(value, buffer, 63)!=NULL || getenv(value)!=NULL))
 		strcpy(value, strip_right_white(term+1));
-		if(global_getvar(value, buffer, 63)!=NULL || getenv(value)!=NULL){
+		if(global_getvar(value, buffer, 63)!=NULL || image_getenv(value)!=NULL){
 			suppress |= (1<<nesting);
 		}
 		macro_line[nesting] = linenum;
@@ -6632,6 +6765,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 	{
 		char *term = strchr(line+7,' ');
 		char value[65536];
+		image_unsupported("#setenv");
 		if (term==NULL)
 		{
 			output_error_raw("%s(%d): %ssetenv macro missing term",filename,linenum,MACRO);
@@ -6844,6 +6978,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 	{
 		char *term = strchr(line+7,' ');
 		char value[1024];
+		image_unsupported("#system");
 		if (term==NULL)
 		{
 			output_error_raw("%s(%d): %ssystem missing system call",filename,linenum,MACRO);
@@ -6869,6 +7004,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 	{
 		char *term = strchr(line+6,' ');
 		char value[1024];
+		image_unsupported("#start");
 		if (term==NULL)
 		{
 			output_error_raw("%s(%d): %sstart missing system call",filename,linenum,MACRO);
@@ -6893,6 +7029,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 	{
 		char *term = strchr(line+7,' ');
 		char value[1024];
+		image_unsupported("#option");
 		if (term==NULL)
 		{
 			output_error_raw("%s(%d): %soption missing command option name",filename,linenum,MACRO);
@@ -6908,6 +7045,7 @@ static int process_macro(char *line, int size, char *_filename, int linenum)
 		char url[1024], file[1024];
 		size_t n = sscanf(line+5,"%s %[^\n\r]",url,file);
 		HTTPRESULT *http;
+		image_unsupported("#wget");
 		strcpy(line,"\n");
 		if ( n<1 )
 		{
@@ -7055,9 +7193,11 @@ STATUS loadall_glm_roll(char *file) /**< a pointer to the first character in the
 	STAT stat;
 	char *ext = strrchr(file,'.');
 	FILE *fp;
+	LOADSOURCE src;
 	int move = 0;
 	errno = 0;
 
+	memset(&src,0,sizeof(src));
 	fp = fopen(file,"rt");
 	if (fp==NULL)
 		goto Failed;
@@ -7073,8 +7213,10 @@ STATUS loadall_glm_roll(char *file) /**< a pointer to the first character in the
 	output_verbose("file '%s' is %d bytes long", file,fsize);
 	/* removed malloc check since it doesn't malloc any more */
 	buffer[0] = '\0';
+	if ( !source_open(&src,fp) )
+		goto Failed;
 
-	move = buffer_read_alt(fp, buffer, file, 20479);
+	move = buffer_read_alt(&src, buffer, file, 20479);
 	while(move > 0){
 		p = buffer; // grab a block
 		while(*p != 0){
@@ -7089,11 +7231,11 @@ STATUS loadall_glm_roll(char *file) /**< a pointer to the first character in the
 			status = FAILED;
 			break;
 		}
-		move = buffer_read_alt(fp, buffer, file, 20479);
+		move = buffer_read_alt(&src, buffer, file, 20479);
 	}
 
 	if(p != 0){ /* did the file contain anything? */
-		status = (*p=='\0' && !include_fail) ? SUCCESS : FAILED;
+		status = (*p=='\0' && !include_fail && move>=0) ? SUCCESS : FAILED;
 	} else {
 		status = FAILED;
 	}
@@ -7133,6 +7275,7 @@ Done:
 	//free(buffer);
 	free_index();
 	linenum=1; // parser starts at one
+	source_close(&src);
 	if (fp!=NULL) fclose(fp);
 	return status;
 }
@@ -7243,7 +7386,14 @@ STATUS loadall(char *file){
 			load_status = SUCCESS;
 	}
 	else if (ext==NULL || strcmp(ext, ".glm")==0)
-		load_status = loadall_glm_roll(filename);
+	{
+		/* use the model image when it is current, and write it when compiling */
+		int rv = image_load(filename);
+		if ( rv!=0 )
+			load_status = rv>0 ? SUCCESS : FAILED;
+		else if ( (load_status=loadall_glm_roll(filename))==SUCCESS )
+			image_save(filename);
+	}
 #ifdef HAVE_XERCES
 	else if(strcmp(ext, ".xml")==0)
 		load_status = loadall_xml(filename);
@@ -214,6 +214,7 @@ int main(int argc, /**< the number entries on command-line argument list \p argv
 	if (global_profiler)
 	{
 		class_profiles();
+		object_memory_report();
 		module_profiles();
 	}
 
@@ -82,6 +82,8 @@
 #include "exec.h"
 #include "stream.h"
 #include "transform.h"
+#include "reduce.h"
+#include "timeline.h"
 
 #include "console.h"
 
@@ -226,6 +228,8 @@ static CALLBACKS callbacks = {
 	{transform_getnext,transform_add_linear,transform_add_external,transform_apply},
 	{randomvar_getnext,randomvar_getspec},
 	{version_major,version_minor,version_patch,version_build,version_branch},
+	{reduce_add,reduce_call},
+	{timeline_now,timeline_event},
 	MAGIC /* used to check structure */
 };
 CALLBACKS *module_callbacks(void) { return &callbacks; }
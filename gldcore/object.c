@@ -42,6 +42,8 @@
 #include "lock.h"
 #include "threadpool.h"
 #include "exec.h"
+#include "hash.h"
+#include "timeline.h"
 
 /* object list */
 static OBJECTNUM next_object_id = 0;
@@ -51,6 +53,238 @@ static OBJECT *last_object = NULL;
 static OBJECTNUM object_array_size = 0;
 static OBJECT **object_array = NULL;
 
+/* object slabs
+
+   Objects are rarely freed while a model runs, so the headers and data of
+   each class are carved out of large per-class slabs.  Objects of a class
+   created together sit next to each other, the way exec visits them, and
+   the allocator does not pay for one malloc per object.  The slot of a
+   removed object is kept on its pool's free list for the next object.
+ */
+#define OBJECTSLABSIZE 262144 /**< bytes in a slab, unless one object needs more */
+#define OBJECTALIGN 16 /**< alignment of each object in a slab */
+
+typedef struct s_objectpool {
+	CLASS *oclass;
+	size_t objsize; /**< aligned size of one object of the class */
+	char *free; /**< the next free object in the current slab */
+	size_t left; /**< the number of bytes left in the current slab */
+	unsigned int objects; /**< the number of objects in use */
+	unsigned int slabs; /**< the number of slabs allocated */
+	void *slab; /**< the slabs, linked through their first word */
+	void *released; /**< the slots of removed objects, linked through their first word */
+	struct s_objectpool *next;
+} OBJECTPOOL;
+static OBJECTPOOL *object_pools = NULL;
+
+static OBJECT *object_pool_alloc(CLASS *oclass)
+{
+	OBJECTPOOL *pool = oclass->pool;
+	OBJECT *obj;
+	if ( pool==NULL )
+	{
+		pool = (OBJECTPOOL*)malloc(sizeof(OBJECTPOOL));
+		if ( pool==NULL )
+			return NULL;
+		memset(pool,0,sizeof(OBJECTPOOL));
+		pool->oclass = oclass;
+		pool->objsize = (sizeof(OBJECT)+oclass->size+OBJECTALIGN-1)/OBJECTALIGN*OBJECTALIGN;
+		pool->next = object_pools;
+		object_pools = pool;
+		oclass->pool = pool;
+	}
+	if ( pool->released!=NULL )
+	{
+		obj = (OBJECT*)pool->released;
+		pool->released = *(void**)obj;
+		pool->objects++;
+		return obj;
+	}
+	if ( pool->left<pool->objsize )
+	{
+		/* the slab's first OBJECTALIGN bytes link it to the previous one */
+		size_t size = pool->objsize+OBJECTALIGN>OBJECTSLABSIZE ? pool->objsize+OBJECTALIGN : OBJECTSLABSIZE;
+		char *slab = (char*)malloc(size);
+		if ( slab==NULL )
+			return NULL;
+		*(void**)slab = pool->slab;
+		pool->slab = slab;
+		pool->free = slab+OBJECTALIGN;
+		pool->left = size-OBJECTALIGN;
+		pool->slabs++;
+	}
+	obj = (OBJECT*)pool->free;
+	pool->free += pool->objsize;
+	pool->left -= pool->objsize;
+	pool->objects++;
+	return obj;
+}
+
+/* return the slot of a removed object to its class' pool */
+static void object_pool_release(OBJECT *obj)
+{
+	OBJECTPOOL *pool = obj->oclass->pool;
+	*(void**)obj = pool->released;
+	pool->released = obj;
+	pool->objects--;
+}
+
+/* release every slab; only valid once no object is in use */
+static void object_pool_freeall(void)
+{
+	while ( object_pools!=NULL )
+	{
+		OBJECTPOOL *pool = object_pools;
+		while ( pool->slab!=NULL )
+		{
+			void *slab = pool->slab;
+			pool->slab = *(void**)slab;
+			free(slab);
+		}
+		object_pools = pool->next;
+		pool->oclass->pool = NULL;
+		free(pool);
+	}
+}
+
+/** Report the memory used by the objects of each class
+ **/
+void object_memory_report(void)
+{
+	OBJECTPOOL *pool;
+	size_t total = 0;
+	unsigned int objects = 0;
+	if ( object_pools==NULL )
+		return;
+	output_profile("Object memory");
+	output_profile("=============\n");
+	output_profile("Class             Objects  Bytes/obj    Slabs   Bytes (kB)");
+	output_profile("---------------- -------- ---------- -------- ------------");
+	for ( pool=object_pools ; pool!=NULL ; pool=pool->next )
+	{
+		size_t bytes = (size_t)pool->slabs*OBJECTSLABSIZE;
+		if ( pool->objsize+OBJECTALIGN>OBJECTSLABSIZE )
+			bytes = (size_t)pool->slabs*(pool->objsize+OBJECTALIGN);
+		output_profile("%-16.16s %8u %10u %8u %12.1f", pool->oclass->name, pool->objects, (unsigned int)pool->objsize, pool->slabs, bytes/1024.0);
+		total += bytes;
+		objects += pool->objects;
+	}
+	output_profile("================ ======== ========== ======== ============");
+	output_profile("%-16.16s %8u %10s %8s %12.1f\n", "Total", objects, "", "", total/1024.0);
+}
+
+/** Test the object slabs
+	Creates enough objects of a private class to fill several slabs, removes
+	every other one, and checks that the next objects reuse exactly the
+	released slots, cleared, without another slab.
+	@returns the number of failed checks
+ **/
+int object_pool_test(void)
+{
+	static MODULE test_module;
+	static CLASS *oclass = NULL;
+	OBJECTPOOL *pool;
+	OBJECT **obj, **again;
+	unsigned int n, i, slabs, breaks, missed, dirty, n_objects, failed = 0;
+
+	output_test("BEGIN: object slab test");
+	if ( oclass==NULL )
+	{
+		strcpy(test_module.name,"object_pool_test");
+		oclass = class_register(&test_module,"object_pool_test",40,PC_NOSYNC);
+	}
+	n = oclass!=NULL ? 2*OBJECTSLABSIZE/(unsigned int)(sizeof(OBJECT)+oclass->size)+1 : 0;
+	obj = (OBJECT**)malloc(sizeof(OBJECT*)*n);
+	again = (OBJECT**)malloc(sizeof(OBJECT*)*n);
+	if ( oclass==NULL || obj==NULL || again==NULL )
+	{
+		output_test("FAILED: unable to set up the test class");
+		free(obj);
+		free(again);
+		exec_setexitcode(XC_TSTERR);
+		return 1;
+	}
+
+	/* fill more than two slabs */
+	for ( i=0 ; i<n ; i++ )
+	{
+		obj[i] = object_create_single(oclass);
+		memset(obj[i]+1,0xa5,oclass->size);
+	}
+	pool = oclass->pool;
+	n_objects = pool->objects;
+	slabs = pool->slabs;
+	if ( slabs<3 || n_objects!=n )
+	{
+		output_test("FAILED: %d objects use %d slabs and count %d objects", n, slabs, n_objects);
+		failed++;
+	}
+	for ( i=1, breaks=0 ; i<n ; i++ )
+	{
+		if ( (char*)obj[i]!=(char*)obj[i-1]+pool->objsize )
+			breaks++;
+	}
+	if ( breaks!=slabs-1 )
+	{
+		output_test("FAILED: %d objects in %d slabs are not contiguous", n, slabs);
+		failed++;
+	}
+
+	/* release every other object and create as many again */
+	for ( i=0 ; i<n ; i+=2 )
+		object_remove_by_id(obj[i]->id);
+	if ( pool->objects!=n_objects-(n+1)/2 )
+	{
+		output_test("FAILED: %d objects in use after releasing %d of %d", pool->objects, (n+1)/2, n);
+		failed++;
+	}
+	for ( i=0, missed=0, dirty=0 ; i<n ; i+=2 )
+	{
+		unsigned int j;
+		again[i] = object_create_single(oclass);
+		for ( j=0 ; j<n && again[i]!=obj[j] ; j+=2 ) {}
+		if ( j>=n )
+			missed++;
+		for ( j=0 ; j<oclass->size && ((unsigned char*)(again[i]+1))[j]==0 ; j++ ) {}
+		if ( j<oclass->size || again[i]->oclass!=oclass || object_find_by_id(again[i]->id)!=again[i] )
+			dirty++;
+	}
+	if ( missed>0 || dirty>0 )
+	{
+		output_test("FAILED: of %d new objects, %d did not reuse a released slot and %d were not reset", (n+1)/2, missed, dirty);
+		failed++;
+	}
+	if ( pool->slabs!=slabs || pool->objects!=n_objects )
+	{
+		output_test("FAILED: reuse took %d slabs for %d objects, expected %d slabs for %d objects", pool->slabs, pool->objects, slabs, n_objects);
+		failed++;
+	}
+	for ( i=1 ; i<n ; i+=2 )
+	{
+		if ( object_find_by_id(obj[i]->id)!=obj[i] )
+		{
+			output_test("FAILED: object %d was lost when its neighbours were released", obj[i]->id);
+			failed++;
+			break;
+		}
+	}
+
+	/* leave nothing behind */
+	for ( i=0 ; i<n ; i++ )
+		object_remove_by_id((i%2==0 ? again[i] : obj[i])->id);
+	if ( pool->objects!=0 )
+	{
+		output_test("FAILED: %d objects remain in use", pool->objects);
+		failed++;
+	}
+	free(obj);
+	free(again);
+	output_test("END: object slab test, %d failed", failed);
+	if ( failed>0 )
+		exec_setexitcode(XC_TSTERR);
+	return failed;
+}
+
 /* {name, val, next} */
 KEYWORD oflags[] = {
 	/* "name", value, next */
@@ -210,9 +444,10 @@ OBJECT *object_find_by_id(OBJECTNUM id){ /**< object id number */
 	OBJECT *obj;
 	
 	if(object_get_count() == object_array_size){
-		if(id < object_array_size){
+		/* ids are only indices until an object is removed */
+		if(id < object_array_size && object_array[id]->id == id){
 			return object_array[id];
-		} else {
+		} else if(deleted_object_count == 0){
 			return NULL;
 		}
 	} else {
@@ -285,17 +520,10 @@ char *object_get_unit(OBJECT *obj, char *name)
 	- \p ENOMEM memory allocation failed
  **/
 OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
-	/* @todo support threadpool during object creation by calling this malloc from the appropriate thread */
 	OBJECT *obj = 0;
-	static int tp_next = 0;
-	static int tp_count = 0;
 	PROPERTY *prop;
 	int sz = sizeof(OBJECT);
 
-	if(tp_count == 0){
-		tp_count = processor_count();
-	}
-
 	if(oclass == NULL){
 		throw_exception("object_create_single(CLASS *oclass=NULL): class is NULL");
 		/* TROUBLESHOOT
@@ -312,7 +540,7 @@ OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
 		*/
 	}
 
-	obj = (OBJECT*)malloc(sz + oclass->size);
+	obj = object_pool_alloc(oclass);
 
 	if(obj == NULL){
 		throw_exception("object_create_single(CLASS *oclass='%s'): memory allocation failed", oclass->name);
@@ -323,8 +551,6 @@ OBJECT *object_create_single(CLASS *oclass){ /**< the class of the object */
 
 	memset(obj, 0, sz + oclass->size);
 
-	tp_next %= tp_count;
-
 	obj->id = next_object_id++;
 	obj->oclass = oclass;
 	obj->next = NULL;
@@ -482,9 +708,15 @@ OBJECT *object_remove_by_id(OBJECTNUM id){
 		
 		object_tree_delete(target, target->name ? target->name : (sprintf(name, "%s:%d", target->oclass->name, target->id), name));
 		next = target->next;
-		prev->next = next;
+		if(prev != NULL){
+			prev->next = next;
+		}
+		if(last_object == target){
+			last_object = prev;
+		}
 		target->oclass->profiler.numobjs--;
-		free(target);
+		object_pool_release(target);
+		object_array_size = 0; /* the id index holds the removed object */
 		target = NULL;
 		deleted_object_count++;
 	}
@@ -1299,10 +1531,17 @@ static int _set_rankx(OBJECT *obj, OBJECTRANK rank, OBJECT *first)
 	}
 	for ( obj=first ; obj!=NULL ; obj=obj->parent )
 		obj->flags &= ~OF_RERANK;
+	return first->rank;
 }
+/* ranks are raised up the parent chain, which objects initialized concurrently may share */
+static unsigned int rank_lock = 0;
 static int set_rank(OBJECT *obj, OBJECTRANK rank, OBJECT *first)
 {
-	global_bigranks==TRUE ? _set_rankx(obj,rank,NULL) : _set_rank(obj,rank,NULL);
+	int result;
+	wlock(&rank_lock);
+	result = global_bigranks==TRUE ? _set_rankx(obj,rank,NULL) : _set_rank(obj,rank,NULL);
+	wunlock(&rank_lock);
+	return result;
 }
 
 /** Set the rank of an object but forcing it's parent
@@ -1396,8 +1635,10 @@ char *object_property_to_string(OBJECT *obj, char *name, char *buffer, int sz)
 		return "";
 }
 
-void object_profile(OBJECT *obj, OBJECTPROFILEITEM pass, clock_t t)
+void object_profile(OBJECT *obj, OBJECTPROFILEITEM pass, clock_t t, int64 tl)
 {
+	if ( tl!=0 )
+		timeline_object(obj,pass,tl);
 	if ( global_profiler==1 )
 	{
 		clock_t dt = (clock_t)exec_clock()-t;
@@ -1405,6 +1646,8 @@ void object_profile(OBJECT *obj, OBJECTPROFILEITEM pass, clock_t t)
 		wlock(&obj->oclass->profiler.lock);
 		obj->oclass->profiler.count++;
 		obj->oclass->profiler.clocks += dt;
+		if ( pass==OPI_INIT )
+			obj->oclass->profiler.init += dt;
 		wunlock(&obj->oclass->profiler.lock);
 	}
 }
@@ -1498,6 +1741,7 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 					  PASSCONFIG pass) /**< the pass configuration */
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 tl = timeline_active ? timeline_now() : 0;
 	TIMESTAMP t2=TS_NEVER;
 	do {
 		/* don't call sync beyond valid horizon */
@@ -1505,12 +1749,12 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 	} while (t2>0 && ts>(t2<0?-t2:t2) && t2<TS_NEVER);
 
 	/* do profiling, if needed */
-	if ( global_profiler==1 )
+	if ( global_profiler==1 || tl!=0 )
 	{
 		switch (pass) {
-		case PC_PRETOPDOWN: object_profile(obj,OPI_PRESYNC,t);break;
-		case PC_BOTTOMUP: object_profile(obj,OPI_SYNC,t);break;
-		case PC_POSTTOPDOWN: object_profile(obj,OPI_POSTSYNC,t);break;
+		case PC_PRETOPDOWN: object_profile(obj,OPI_PRESYNC,t,tl);break;
+		case PC_BOTTOMUP: object_profile(obj,OPI_SYNC,t,tl);break;
+		case PC_POSTTOPDOWN: object_profile(obj,OPI_POSTSYNC,t,tl);break;
 		default: break;
 		}
 	}
@@ -1527,8 +1771,9 @@ TIMESTAMP object_sync(OBJECT *obj, /**< the object to synchronize */
 TIMESTAMP object_heartbeat(OBJECT *obj)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 tl = timeline_active ? timeline_now() : 0;
 	TIMESTAMP t1 = obj->oclass->heartbeat ? obj->oclass->heartbeat(obj) : TS_NEVER;
-	object_profile(obj,OPI_HEARTBEAT,t);
+	object_profile(obj,OPI_HEARTBEAT,t,tl);
 		if ( global_debug_output>0 )
 		{
 			char dt[64]="(invalid)"; convert_from_timestamp(absolute_timestamp(t1),dt,sizeof(dt));
@@ -1545,11 +1790,12 @@ TIMESTAMP object_heartbeat(OBJECT *obj)
 int object_init(OBJECT *obj) /**< the object to initialize */
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 tl = timeline_active ? timeline_now() : 0;
 	int rv = 1;
 	obj->clock = global_starttime;
 	if(obj->oclass->init != NULL)
 		rv = (int)(*(obj->oclass->init))(obj, obj->parent);
-	object_profile(obj,OPI_INIT,t);
+	object_profile(obj,OPI_INIT,t,tl);
 	if ( global_debug_output>0 )
 		output_debug("object %s:%d init -> %s", obj->oclass->name, obj->id, rv?"ok":"failed");
 	return rv;
@@ -1567,6 +1813,7 @@ int object_init(OBJECT *obj) /**< the object to initialize */
 STATUS object_precommit(OBJECT *obj, TIMESTAMP t1)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 tl = timeline_active ? timeline_now() : 0;
 	STATUS rv = SUCCESS;
 	if(obj->oclass->precommit != NULL){
 		rv = (STATUS)(*(obj->oclass->precommit))(obj, t1);
@@ -1574,7 +1821,7 @@ STATUS object_precommit(OBJECT *obj, TIMESTAMP t1)
 	if(rv == 1){ // if 'old school' or no precommit callback,
 		rv = SUCCESS;
 	}
-	object_profile(obj,OPI_PRECOMMIT,t);
+	object_profile(obj,OPI_PRECOMMIT,t,tl);
 		if ( global_debug_output>0 )
 			output_debug("object %s:%d precommit -> %s", obj->oclass->name, obj->id, rv?"ok":"failed");
 	return rv;
@@ -1583,6 +1830,7 @@ STATUS object_precommit(OBJECT *obj, TIMESTAMP t1)
 TIMESTAMP object_commit(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 tl = timeline_active ? timeline_now() : 0;
 	TIMESTAMP rv = 1;
 	if(obj->oclass->commit != NULL){
 		rv = (TIMESTAMP)(*(obj->oclass->commit))(obj, t1, t2);
@@ -1590,7 +1838,7 @@ TIMESTAMP object_commit(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 	if(rv == 1){ // if 'old school' or no commit callback,
 		rv =TS_NEVER;
 	} 
-	object_profile(obj,OPI_COMMIT,t);
+	object_profile(obj,OPI_COMMIT,t,tl);
 	if ( global_debug_output>0 )
 	{
 		char dt[64]="(invalid)"; convert_from_timestamp(absolute_timestamp(rv),dt,sizeof(dt));
@@ -1608,6 +1856,7 @@ TIMESTAMP object_commit(OBJECT *obj, TIMESTAMP t1, TIMESTAMP t2)
 STATUS object_finalize(OBJECT *obj)
 {
 	clock_t t = (clock_t)exec_clock();
+	int64 tl = timeline_active ? timeline_now() : 0;
 	STATUS rv = SUCCESS;
 	if(obj->oclass->finalize != NULL){
 		rv = (STATUS)(*(obj->oclass->finalize))(obj);
@@ -1615,7 +1864,7 @@ STATUS object_finalize(OBJECT *obj)
 	if(rv == 1){ // if 'old school' or no finalize callback,
 		rv = SUCCESS;
 	}
-	object_profile(obj,OPI_FINALIZE,t);
+	object_profile(obj,OPI_FINALIZE,t,tl);
 	if ( global_debug_output>0 )
 	{
 		output_debug("object %s:%d finalize -> %s", obj->oclass->name, obj->id, rv?"ok":"failed");
@@ -2103,12 +2352,45 @@ typedef struct s_objecttree {
 	OBJECT *obj;
 	struct s_objecttree *before, *after;
 	int balance; /* unused */
+	struct s_objecttree *next; /* next name in the order names were added */
 } OBJECTTREE;
 
 static OBJECTTREE *top=NULL;
+static HASHTABLE *object_names = NULL; /* name index used for all lookups */
+static OBJECTTREE *first_name = NULL, *last_name = NULL; /* every name ever added (names are never freed) */
+static int tree_is_current = 1; /* non-zero when the ordered tree matches the name index */
+
+static int addto_tree(OBJECTTREE **tree, OBJECTTREE *item);
+
+/*	Build the ordered name tree from the name index
+	The tree is only used for ordered dumps so it is rebuilt only when needed.
+ */
+static void object_tree_build(void)
+{
+	OBJECTTREE *item;
+	if ( tree_is_current )
+		return;
+	top = NULL;
+	for ( item=first_name ; item!=NULL ; item=item->next )
+	{
+		item->before = item->after = NULL;
+		item->balance = 0;
+	}
+	for ( item=first_name ; item!=NULL ; item=item->next )
+	{
+		if ( item->obj==NULL ) /* deleted name */
+			continue;
+		if ( top==NULL )
+			top = item;
+		else
+			addto_tree(&top,item);
+	}
+	tree_is_current = 1;
+}
 
 void debug_traverse_tree(OBJECTTREE *tree){
 	if(tree == NULL){
+		object_tree_build();
 		tree = top;
 		if(top == NULL){
 			return;
@@ -2225,7 +2507,15 @@ static int addto_tree(OBJECTTREE **tree, OBJECTTREE *item){
 	Returns a pointer to the object tree item if successful, NULL on failure (usually because name already used)
  */
 static OBJECTTREE *object_tree_add(OBJECT *obj, OBJECTNAME name){
-	OBJECTTREE *item = (OBJECTTREE*)malloc(sizeof(OBJECTTREE));
+	OBJECTTREE *item = (OBJECTTREE*)hash_find(object_names,name);
+
+	if(item != NULL){
+		return item->obj==obj ? item : NULL;
+	}
+	if(object_names == NULL){
+		object_names = hash_create(0);
+	}
+	item = object_names ? (OBJECTTREE*)malloc(sizeof(OBJECTTREE)) : NULL;
 
 	if(item == NULL) {
 		output_fatal("object_tree_add(obj='%s:%d', name='%s'): memory allocation failed (%s)", obj->oclass->name, obj->id, name, strerror(errno));
@@ -2238,96 +2528,40 @@ static OBJECTTREE *object_tree_add(OBJECT *obj, OBJECTNAME name){
 	item->obj = obj;
 	item->balance = 0;
 	strncpy(item->name, name, sizeof(item->name));
+	item->name[sizeof(item->name)-1] = '\0';
 	item->before = item->after = NULL;
+	item->next = NULL;
 
-	if(top == NULL){
-		top = item;
-		return top;
-	} else {
-		if(addto_tree(&top, item) != 0){
-			return item;
-		} else {
-			return NULL;
-		}
-	}
-}
-
-/*	Finds a name in the tree
- */
-static OBJECTTREE **findin_tree(OBJECTTREE **tree, OBJECTNAME name)
-{
-	if(tree == NULL || *tree == NULL){
+	if(!hash_insert(object_names, item->name, item)){
+		output_fatal("object_tree_add(obj='%s:%d', name='%s'): unable to index object name", obj->oclass->name, obj->id, name);
+		/* TROUBLESHOOT
+			The memory required to add this object to the object index is not available.  Try freeing up system memory and try again.
+		 */
+		free(item);
 		return NULL;
+	}
+	if(last_name == NULL){
+		first_name = item;
 	} else {
-		int rel = strcmp((*tree)->name, name);
-		if(rel > 0){
-			if((*tree)->before != NULL){
-				if(strcmp((*tree)->before->name, name) == 0){
-					return &((*tree)->before);
-				} else {
-					return findin_tree(&((*tree)->before), name);
-				}
-			} else {
-				return NULL;
-			}
-		} else if(rel<0) {
-			if((*tree)->after != NULL){
-				if(strcmp((*tree)->after->name, name) == 0){
-					return &((*tree)->after);
-				} else {
-					return findin_tree(&((*tree)->after), name);
-				}
-			} else {
-				return NULL;
-			}
-		} else {
-			return tree;
-		}
+		last_name->next = item;
 	}
+	last_name = item;
+	tree_is_current = 0;
+	return item;
 }
 
 /*	Deletes a name from the tree
 	WARNING: removing a tree entry does NOT free() its object!
+	The name itself is kept because obj->name may still refer to it.
  */
 void object_tree_delete(OBJECT *obj, OBJECTNAME name)
 {
-	OBJECTTREE **item = findin_tree(&(top),name);
-	OBJECTTREE *temp = NULL, **dtemp = NULL;
-
-	if(item != NULL && strcmp((*item)->name, name)!=0){
-		if((*item)->after == NULL && (*item)->before == NULL){ /* no children -- nuke */
-			free(*item);
-			*item = NULL;
-		} else if((*item)->after != NULL && (*item)->before != NULL){ /* two children -- find a replacement */
-			dtemp = &((*item)->before);
-			while(temp->after != NULL)
-				dtemp = &(temp->after);
-			temp = (*dtemp)->before;
-			(*dtemp)->before = (*item)->before;
-			(*dtemp)->after = (*item)->after;
-			free(*item);
-			*item = *dtemp;
-			*dtemp = temp;
-			/* replace item with the rightmost left element.*/
-
-		} else if((*item)->after == NULL || (*item)->before == NULL){ /* one child -- promotion time! */
-			if((*item)->after != NULL){
-				temp = (*item)->after;
-				free(*item);
-				*item = temp;
-			} else if((*item)->before != NULL){
-				temp = (*item)->before;
-				free(*item);
-				*item = temp;
-			} else {
-				output_fatal("unexpected branch result in object_tree_delete");
-				/*	TROUBLESHOOT
-					This should never happen and if it does, the system has become unstable and the problem should be reported.
-				 */
-			}
-		}
+	OBJECTTREE *item = (OBJECTTREE*)hash_find(object_names,name);
 
-		/* throw_exception("object_tree_delete(obj=%s:%d, name='%s'): rename of objects in tree is not supported yet", obj->oclass->name, obj->id, name); */
+	if(item != NULL && item->obj == obj){
+		hash_delete(object_names,item->name);
+		item->obj = NULL;
+		tree_is_current = 0;
 	}
 }
 
@@ -2335,12 +2569,10 @@ void object_tree_delete(OBJECT *obj, OBJECTNAME name)
 	@return a pointer to the OBJECT structure
  **/
 OBJECT *object_find_name(OBJECTNAME name){
-	OBJECTTREE **item = NULL;
-
-	item = findin_tree(&(top), name);
+	OBJECTTREE *item = (OBJECTTREE*)hash_find(object_names, name);
 	
-	if(item != NULL && *item != NULL){
-		return (*item)->obj;
+	if(item != NULL){
+		return item->obj;
 	} else {
 		/* normal operation, remain silent */
 		return NULL;
@@ -2397,10 +2629,6 @@ OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name){
 			output_warning("object name '%s' does not follow strict naming rules and may not link correctly during load time", name);
 		}
 	}
-	if(obj->name != NULL){
-		object_tree_delete(obj,name);
-	}
-	
 	if(name != NULL){
 		if(object_find_name(name) != NULL){
 			output_error("An object named '%s' already exists!", name);
@@ -2410,6 +2638,9 @@ OBJECTNAME object_set_name(OBJECT *obj, OBJECTNAME name){
 			*/
 			return NULL;
 		}
+		if(obj->name != NULL){
+			object_tree_delete(obj,obj->name);
+		}
 		item = object_tree_add(obj,name);
 		if(item != NULL){
 			obj->name = item->name;
@@ -2433,11 +2664,14 @@ void remove_objects(){
 	while(obj1 != NULL){
 		first_object = obj1->next;
 		obj1->oclass->profiler.numobjs--;
-		free(obj1);
 		obj1 = first_object;
 	}
+	last_object = NULL;
+	object_pool_freeall();
 
 	next_object_id = 0;
+	deleted_object_count = 0;
+	object_array_size = 0;
 }
 
 /*****************************************************************************************************
@@ -36,6 +36,7 @@ typedef char FULLNAME[1024]; /** Full object name (including space name) */
 #define OF_FORECAST	0x0040	/**< Object flag; inidcates that the object has a valid forecast available */
 #define OF_DEFERRED	0x0080	/**< Object flag; indicates that the object started to be initialized, but requested deferral */
 #define OF_INIT		0x0100	/**< Object flag; indicates that the object has been successfully initialized */
+#define OF_TRACE	0x0200	/**< Object flag; indicates that each call to the object is recorded in the profiler timeline */
 #define OF_RERANK	0x4000	/**< Internal use only */
 
 typedef struct s_namespace {
@@ -325,6 +326,14 @@ typedef struct s_callbacks {
 		unsigned int (*build)(void);
 		const char * (*branch)(void);
 	} version;
+	struct {
+		void (*add)(OBJECT *from, OBJECT *to, double *target, const double *delta, unsigned int n);
+		void (*call)(void (*call)(void*), void *data);
+	} reduce;
+	struct {
+		int64 (*now)(void);
+		void (*event)(const char *category, const char *name, int64 start, int64 arg);
+	} timeline;
 	long unsigned int magic; /* used to check structure alignment */
 } CALLBACKS; /**< core callback function table */
 
@@ -397,6 +406,8 @@ OBJECT *object_find_by_id(OBJECTNUM id);
 OBJECT *object_get_first(void);
 OBJECT *object_get_next(OBJECT *obj);
 unsigned int object_get_count(void);
+void object_memory_report(void);
+int object_pool_test(void);
 int object_dump(char *buffer, int size, OBJECT *obj);
 int object_save(char *buffer, int size, OBJECT *obj);
 int object_saveall(FILE *fp);
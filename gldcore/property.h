@@ -1171,6 +1171,7 @@ typedef uint32 PROPERTYFLAGS;
 #define PF_RECALC	0x0001 /**< property has a recalc trigger (only works if recalc_<class> is exported) */
 #define PF_CHARSET	0x0002 /**< set supports single character keywords (avoids use of |) */
 #define PF_EXTENDED 0x0004 /**< indicates that the property was added at runtime */
+#define PF_WAKEUP	0x0008 /**< a change in the property wakes an object sleeping under sparse_sync (see PC_SPARSE_SYNC) */
 #define PF_DEPRECATED 0x8000 /**< set this flag to indicate that the property is deprecated (warning will be displayed anytime it is used */
 #define PF_DEPRECATED_NONOTICE 0x04000 /**< set this flag to indicate that the property is deprecated but no reference warning is desired */
 
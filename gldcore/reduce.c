@@ -0,0 +1,293 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file reduce.c
+	@addtogroup reduce
+	@ingroup core
+
+	Per-thread logs of child contributions to parent properties.  See
+	reduce.h for the design.
+ @{
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "output.h"
+#include "lock.h"
+#include "reduce.h"
+
+typedef struct s_reduceentry {
+	double *target;
+	OBJECTNUM from; /**< id of the contributing object */
+	unsigned int seq; /**< order of the call in its thread's log */
+	unsigned int n;
+	double delta[REDUCE_MAXSIZE];
+} REDUCEENTRY;
+
+/** The log of one thread.  Only the owning thread appends to it, and only
+	reduce_end() reads it, once the rank is finished. */
+typedef struct s_reducelog {
+	REDUCEENTRY *entry;
+	unsigned int n, max;
+	void (*last_call)(void*); /**< the last call this thread queued in the current rank */
+	void *last_data;
+	struct s_reducelog *next;
+} REDUCELOG;
+
+/** A call queued until the end of the rank */
+typedef struct s_reducecall {
+	void (*call)(void*);
+	void *data;
+} REDUCECALL;
+
+static pthread_mutex_t reduce_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t reduce_key;
+static int reduce_keyed = 0;
+static volatile int reduce_active = 0;
+static REDUCELOG *reduce_logs = NULL;
+static REDUCEENTRY *reduce_sorted = NULL;
+static unsigned int reduce_sortmax = 0;
+static REDUCECALL *reduce_calls = NULL; /* guarded by reduce_lock while a rank is running */
+static unsigned int reduce_ncalls = 0, reduce_maxcalls = 0;
+
+/* the calling thread's log, created on first use */
+static REDUCELOG *get_log(void)
+{
+	REDUCELOG *log = (REDUCELOG*)pthread_getspecific(reduce_key);
+	if ( log!=NULL )
+		return log;
+	log = (REDUCELOG*)malloc(sizeof(REDUCELOG));
+	if ( log==NULL )
+		return NULL;
+	memset(log,0,sizeof(REDUCELOG));
+	pthread_mutex_lock(&reduce_lock);
+	log->next = reduce_logs;
+	reduce_logs = log;
+	pthread_mutex_unlock(&reduce_lock);
+	pthread_setspecific(reduce_key,log);
+	return log;
+}
+
+static void apply(double *target, const double *delta, unsigned int n)
+{
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+		target[i] += delta[i];
+}
+
+/** Add \p n doubles at \p delta to those at \p target, which belongs to
+	object \p to, on behalf of object \p from.  Complex values are passed
+	as two doubles (real then imaginary).
+ **/
+void reduce_add(OBJECT *from, OBJECT *to, double *target, const double *delta, unsigned int n)
+{
+	REDUCELOG *log;
+	REDUCEENTRY *entry;
+
+	if ( n>REDUCE_MAXSIZE )
+	{
+		output_error("reduce_add(): %d values is more than the limit of %d", n, REDUCE_MAXSIZE);
+		/* TROUBLESHOOT
+		   A module tried to add more values to a parent property in one call than the core supports.
+		   This is an internal error and should be reported to the GridLAB-D developers.
+		 */
+		return;
+	}
+	if ( !reduce_active || (log=get_log())==NULL )
+	{
+		wlock(&to->lock);
+		apply(target,delta,n);
+		wunlock(&to->lock);
+		return;
+	}
+	if ( log->n==log->max )
+	{
+		unsigned int max = log->max==0 ? 256 : log->max*2;
+		REDUCEENTRY *grown = (REDUCEENTRY*)realloc(log->entry,sizeof(REDUCEENTRY)*max);
+		if ( grown==NULL )
+		{
+			/* keep going, but the result is no longer independent of thread count */
+			wlock(&to->lock);
+			apply(target,delta,n);
+			wunlock(&to->lock);
+			return;
+		}
+		log->entry = grown;
+		log->max = max;
+	}
+	entry = log->entry + log->n;
+	entry->target = target;
+	entry->from = from ? from->id : 0;
+	entry->seq = log->n++;
+	entry->n = n;
+	memcpy(entry->delta,delta,sizeof(double)*n);
+}
+
+/** Call \p call with \p data once the current rank is finished and its
+	contributions have been added, or at once outside a rank.  A call that
+	is queued many times in the same rank (e.g., by every object of a
+	class) is made only once.  Queued calls are made by a single thread,
+	in no particular order, while no object is being synchronized.
+ **/
+void reduce_call(void (*call)(void*), void *data)
+{
+	REDUCELOG *log;
+	unsigned int i;
+
+	if ( !reduce_active )
+	{
+		call(data);
+		return;
+	}
+	log = get_log();
+	if ( log!=NULL && log->last_call==call && log->last_data==data )
+		return; /* already queued by this thread */
+	pthread_mutex_lock(&reduce_lock);
+	for ( i=0 ; i<reduce_ncalls ; i++ )
+	{
+		if ( reduce_calls[i].call==call && reduce_calls[i].data==data )
+			break;
+	}
+	if ( i==reduce_ncalls )
+	{
+		if ( reduce_ncalls==reduce_maxcalls )
+		{
+			unsigned int max = reduce_maxcalls==0 ? 16 : reduce_maxcalls*2;
+			REDUCECALL *grown = (REDUCECALL*)realloc(reduce_calls,sizeof(REDUCECALL)*max);
+			if ( grown==NULL )
+			{
+				pthread_mutex_unlock(&reduce_lock);
+				output_error("reduce_call(): unable to queue a call until the end of the rank");
+				/* TROUBLESHOOT
+				   The memory needed to queue a module's end of rank call could not be allocated.
+				   The module must then do the work itself when it next needs the result, which may be slower.
+				   Free some memory and try again.
+				 */
+				return;
+			}
+			reduce_calls = grown;
+			reduce_maxcalls = max;
+		}
+		reduce_calls[reduce_ncalls].call = call;
+		reduce_calls[reduce_ncalls].data = data;
+		reduce_ncalls++;
+	}
+	pthread_mutex_unlock(&reduce_lock);
+	if ( log!=NULL )
+	{
+		log->last_call = call;
+		log->last_data = data;
+	}
+}
+
+/** Start deferring reduce_add() calls, before a rank is synchronized */
+void reduce_begin(void)
+{
+	if ( !reduce_keyed )
+	{
+		if ( pthread_key_create(&reduce_key,NULL)!=0 )
+			return;
+		reduce_keyed = 1;
+	}
+	reduce_active = 1;
+}
+
+static int compare(const void *a, const void *b)
+{
+	const REDUCEENTRY *x = (const REDUCEENTRY*)a, *y = (const REDUCEENTRY*)b;
+	if ( x->target!=y->target )
+		return x->target<y->target ? -1 : 1;
+	if ( x->from!=y->from )
+		return x->from<y->from ? -1 : 1;
+	if ( x->seq!=y->seq )
+		return x->seq<y->seq ? -1 : 1;
+	return 0;
+}
+
+/* add the logged deltas in a fixed order */
+static void apply_logs(void)
+{
+	REDUCELOG *log;
+	unsigned int total = 0, i;
+
+	for ( log=reduce_logs ; log!=NULL ; log=log->next )
+	{
+		total += log->n;
+		log->last_call = NULL;
+		log->last_data = NULL;
+	}
+	if ( total==0 )
+		return;
+
+	if ( total>reduce_sortmax )
+	{
+		REDUCEENTRY *grown = (REDUCEENTRY*)realloc(reduce_sorted,sizeof(REDUCEENTRY)*total);
+		if ( grown==NULL )
+		{
+			output_error("reduce_end(): unable to sort %d parent contributions, applying them unsorted", total);
+			for ( log=reduce_logs ; log!=NULL ; log=log->next )
+			{
+				for ( i=0 ; i<log->n ; i++ )
+					apply(log->entry[i].target,log->entry[i].delta,log->entry[i].n);
+				log->n = 0;
+			}
+			return;
+		}
+		reduce_sorted = grown;
+		reduce_sortmax = total;
+	}
+	total = 0;
+	for ( log=reduce_logs ; log!=NULL ; log=log->next )
+	{
+		memcpy(reduce_sorted+total,log->entry,sizeof(REDUCEENTRY)*log->n);
+		total += log->n;
+		log->n = 0;
+	}
+	qsort(reduce_sorted,total,sizeof(REDUCEENTRY),compare);
+	for ( i=0 ; i<total ; i++ )
+		apply(reduce_sorted[i].target,reduce_sorted[i].delta,reduce_sorted[i].n);
+}
+
+/** Stop deferring, add the logged deltas in a fixed order, then make the
+	queued calls.  Must be called by a single thread once every worker has
+	finished the rank.
+ **/
+void reduce_end(void)
+{
+	unsigned int i;
+
+	if ( !reduce_active )
+		return;
+	reduce_active = 0;
+	apply_logs();
+	for ( i=0 ; i<reduce_ncalls ; i++ )
+		reduce_calls[i].call(reduce_calls[i].data);
+	reduce_ncalls = 0;
+}
+
+/** Release the logs */
+void reduce_term(void)
+{
+	REDUCELOG *log;
+	reduce_end();
+	while ( (log=reduce_logs)!=NULL )
+	{
+		reduce_logs = log->next;
+		free(log->entry);
+		free(log);
+	}
+	free(reduce_sorted);
+	reduce_sorted = NULL;
+	reduce_sortmax = 0;
+	free(reduce_calls);
+	reduce_calls = NULL;
+	reduce_ncalls = reduce_maxcalls = 0;
+	if ( reduce_keyed )
+	{
+		pthread_key_delete(reduce_key);
+		reduce_keyed = 0;
+	}
+}
+
+/**@}**/
@@ -0,0 +1,54 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file reduce.h
+	@addtogroup reduce Parent reductions
+	@ingroup core
+
+	Child objects add their contributions (currents, shunts, powers) into
+	properties of their parent.  Siblings of the same rank sync concurrently,
+	so these additions must not race, and the order in which they are added
+	must not depend on which thread ran which child, or the floating point
+	sums will differ from run to run.
+
+	While a rank is being synchronized (between reduce_begin() and
+	reduce_end()) reduce_add() does not touch the target.  It appends the
+	delta to a log owned by the calling thread, which needs no lock.  When
+	the rank is done reduce_end() sorts all the logs by target, then by the
+	id of the contributing object, then by the order of the calls, and adds
+	the deltas in that order.  The parent's sync always runs in a later rank
+	so it sees every contribution, and the result is the same for any number
+	of threads.
+
+	Outside a rank, reduce_add() adds the delta at once under the write lock
+	of the target object.
+
+	Work that must see the whole rank (e.g., a batch solve of equations set
+	by many objects) is queued with reduce_call(), which runs it once after
+	the rank's contributions are added, before the next rank starts.
+ @{
+ **/
+
+#ifndef _REDUCE_H
+#define _REDUCE_H
+
+#include "object.h"
+
+#define REDUCE_MAXSIZE 2 /**< most doubles in one delta, enough for a complex value */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void reduce_add(OBJECT *from, OBJECT *to, double *target, const double *delta, unsigned int n);
+void reduce_call(void (*call)(void*), void *data);
+void reduce_begin(void);
+void reduce_end(void);
+void reduce_term(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}**/
@@ -504,6 +504,8 @@ typedef unsigned long PASSCONFIG; /**< the pass configuration */
 #define PC_PARENT_OVERRIDE_OMIT 0x40	/**< used to ignore parent's use of PC_UNSAFE_OVERRIDE_OMIT */
 #define PC_UNSAFE_OVERRIDE_OMIT 0x80	/**< used to flag that omitting overrides is unsafe */
 #define PC_ABSTRACTONLY 0x100 /**< used to flag that the class should never be instantiated itself, only inherited classes should */
+#define PC_PARALLEL_INIT 0x800 /**< used to flag that objects of this class may be initialized concurrently (init only writes to the object itself) */
+#define PC_SPARSE_SYNC 0x1000 /**< used to flag that objects of this class may sleep until their next event when sparse_sync is set (see PF_WAKEUP) */
 
 #ifndef FALSE
 #define FALSE (0)
@@ -539,6 +541,7 @@ typedef struct s_keyword KEYWORD;
 typedef uint32 PROPERTYFLAGS;
 #define PF_RECALC	0x0001 /**< property has a recalc trigger (only works if recalc_<class> is exported) */
 #define PF_CHARSET	0x0002 /**< set supports single character keywords (avoids use of |) */
+#define PF_WAKEUP	0x0008 /**< a change in the property wakes an object sleeping under sparse_sync (see PC_SPARSE_SYNC) */
 
 struct s_property_map {
 	CLASS *oclass; /**< class implementing the property */
@@ -664,6 +667,7 @@ struct s_class_list {
 		int32 numobjs;
 		int64 clocks;
 		int32 count;
+		int64 init; /**< part of clocks spent in init */
 	} profiler;
 	TECHNOLOGYREADINESSLEVEL trl; // technology readiness level (1-9, 0=unknown)
 	bool has_runtime;	///< flag indicating that a runtime dll, so, or dylib is in use
@@ -1319,6 +1323,10 @@ typedef struct s_callbacks {
 		unsigned int (*build)(void);
 		const char * (*branch)(void);
 	} version;
+	struct {
+		void (*add)(OBJECT *from, OBJECT *to, double *target, const double *delta, unsigned int n);
+		void (*call)(void (*call)(void*), void *data);
+	} reduce;
 	long unsigned int magic; /* used to check structure alignment */
 } CALLBACKS; /**< core callback function table */
 
@@ -17,6 +17,7 @@
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <sys/errno.h>
+#include <sys/select.h>
 #define SOCKET int
 #define INVALID_SOCKET (-1)
 
@@ -25,6 +26,7 @@
 #include <memory.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 #include <pthread.h>
 
 #include "server.h"
@@ -111,11 +113,171 @@ int client_allowed(char *saddr)
 {
 	return strncmp(saddr,global_client_allowed,strlen(global_client_allowed))==0;
 }
+/* Requests are served by a fixed pool of worker threads.  The accept
+   loop waits for a request on each connection and queues it, and the next
+   idle worker answers that one request.  A keep-alive connection is then
+   given back to the accept loop to wait for its next request, so an idle
+   client does not hold a worker.  Connections idle for HTTP_IDLETIME
+   seconds are closed. */
+#define HTTP_WORKERS 8 /**< number of threads serving requests */
+#define HTTP_BACKLOG 64 /**< most connections waiting for a worker */
+#define HTTP_MAXIDLE 256 /**< most idle keep-alive connections waiting for a request */
+#define HTTP_IDLETIME 5 /**< seconds an idle keep-alive connection is kept open */
+static pthread_mutex_t http_queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t http_handler_lock = PTHREAD_MUTEX_INITIALIZER; /**< serializes the handlers that are not thread-safe */
+static pthread_cond_t http_queue_signal = PTHREAD_COND_INITIALIZER;
+static SOCKET http_queue[HTTP_BACKLOG];
+static unsigned int http_queue_head = 0, http_queue_count = 0;
+static struct s_httpidle {
+	SOCKET s;
+	time_t since;
+} http_idle[HTTP_MAXIDLE]; /**< idle connections, only removed by the accept loop */
+static unsigned int http_idle_count = 0;
+static int http_wake[2] = {-1,-1}; /**< pipe that wakes the accept loop when a connection is given back (not on Windows, which polls) */
+
+/** Wait for connections and serve them
+	@returns NULL
+ **/
+static void *http_worker(void *arg)
+{
+	while ( !shutdown_server )
+	{
+		SOCKET s;
+		pthread_mutex_lock(&http_queue_lock);
+		while ( http_queue_count==0 )
+			pthread_cond_wait(&http_queue_signal,&http_queue_lock);
+		s = http_queue[http_queue_head];
+		http_queue_head = (http_queue_head+1)%HTTP_BACKLOG;
+		http_queue_count--;
+		pthread_cond_broadcast(&http_queue_signal);
+		pthread_mutex_unlock(&http_queue_lock);
+		http_response((void*)s);
+	}
+	return NULL;
+}
+
+/** Queue a connection for the workers, waiting if the queue is full
+ **/
+static void http_enqueue(SOCKET s)
+{
+	pthread_mutex_lock(&http_queue_lock);
+	while ( http_queue_count==HTTP_BACKLOG )
+		pthread_cond_wait(&http_queue_signal,&http_queue_lock);
+	http_queue[(http_queue_head+http_queue_count)%HTTP_BACKLOG] = s;
+	http_queue_count++;
+	pthread_cond_broadcast(&http_queue_signal);
+	pthread_mutex_unlock(&http_queue_lock);
+}
+
+/** Give an idle connection to the accept loop to wait for its next request
+	@returns non-zero if the accept loop took it, 0 if it must be closed
+ **/
+static int http_park(SOCKET s)
+{
+	int parked = 0;
+	pthread_mutex_lock(&http_queue_lock);
+	if ( http_idle_count<HTTP_MAXIDLE )
+	{
+		http_idle[http_idle_count].s = s;
+		http_idle[http_idle_count].since = time(NULL);
+		http_idle_count++;
+		parked = 1;
+	}
+	pthread_mutex_unlock(&http_queue_lock);
+#ifndef WIN32
+	if ( parked && http_wake[1]>=0 && write(http_wake[1],"",1)<0 )
+		output_warning("unable to wake the http accept loop");
+#endif
+	return parked;
+}
+
+static void http_close_socket(SOCKET s)
+{
+#ifdef WIN32
+	closesocket(s);
+#else
+	close(s);
+#endif
+}
+
+/** Wait until a new connection or a request on an idle connection arrives.
+	Idle connections with a request are queued for the workers, and those
+	idle for too long are closed.
+	@returns non-zero if a new connection is waiting to be accepted
+ **/
+static int http_poll(SOCKET sockfd)
+{
+	fd_set ready;
+	SOCKET maxfd = sockfd, busy[HTTP_MAXIDLE];
+	struct timeval wait = {0,0};
+	unsigned int i, j, n_watched, n_busy = 0;
+	time_t now;
+
+	FD_ZERO(&ready);
+	FD_SET(sockfd,&ready);
+#ifndef WIN32
+	if ( http_wake[0]>=0 )
+	{
+		FD_SET(http_wake[0],&ready);
+		if ( http_wake[0]>maxfd ) maxfd = http_wake[0];
+	}
+#endif
+	pthread_mutex_lock(&http_queue_lock);
+	n_watched = http_idle_count;
+	for ( i=0 ; i<n_watched ; i++ )
+	{
+		FD_SET(http_idle[i].s,&ready);
+		if ( http_idle[i].s>maxfd ) maxfd = http_idle[i].s;
+	}
+	pthread_mutex_unlock(&http_queue_lock);
+
+	/* without the wake pipe, connections given back are picked up on the next poll */
+	if ( http_wake[0]<0 )
+		wait.tv_usec = 10000;
+	else
+		wait.tv_sec = 1;
+	if ( select((int)maxfd+1,&ready,NULL,NULL,&wait)<0 )
+	{
+		if ( errno!=EINTR )
+			output_warning("server select failed on socket %d: code %d", sockfd, GetLastError());
+		return 0;
+	}
+#ifndef WIN32
+	if ( http_wake[0]>=0 && FD_ISSET(http_wake[0],&ready) )
+	{
+		char drain[64];
+		if ( read(http_wake[0],drain,sizeof(drain))<0 )
+			output_warning("unable to read the http wake pipe");
+	}
+#endif
+
+	/* only the connections that were watched are checked; others were given back since */
+	now = time(NULL);
+	pthread_mutex_lock(&http_queue_lock);
+	for ( i=j=0 ; i<http_idle_count ; i++ )
+	{
+		if ( i<n_watched && FD_ISSET(http_idle[i].s,&ready) )
+			busy[n_busy++] = http_idle[i].s;
+		else if ( i<n_watched && now-http_idle[i].since>=HTTP_IDLETIME )
+		{
+			IN_MYCONTEXT output_verbose("socket %d closed after %d seconds idle",http_idle[i].s,HTTP_IDLETIME);
+			http_close_socket(http_idle[i].s);
+		}
+		else
+			http_idle[j++] = http_idle[i];
+	}
+	http_idle_count = j;
+	pthread_mutex_unlock(&http_queue_lock);
+	for ( i=0 ; i<n_busy ; i++ )
+		http_enqueue(busy[i]);
+
+	return FD_ISSET(sockfd,&ready);
+}
+
 /** Main server wait loop 
     @returns a pointer to the status flag
  **/
 static unsigned int n_threads = 0;
-static pthread_t thread_id;
 static void *server_routine(void *arg)
 {
 	static int status = 0;
@@ -127,9 +289,29 @@ static void *server_routine(void *arg)
 	}
 	started = 1;
 	sockfd = (SOCKET)arg;
+	for ( ; n_threads<HTTP_WORKERS ; n_threads++ )
+	{
+		pthread_t worker;
+		if ( pthread_create(&worker,NULL,http_worker,NULL)!=0 )
+		{
+			output_error("unable to start http worker thread");
+			break;
+		}
+		pthread_detach(worker);
+	}
+	if ( n_threads==0 )
+	{
+		status = FAILED;
+		goto Done;
+	}
+#ifndef WIN32
+	if ( pipe(http_wake)!=0 )
+	{
+		http_wake[0] = http_wake[1] = -1;
+		output_warning("unable to create the http wake pipe, idle connections will be polled");
+	}
+#endif
 	// repeat forever..
-	static int active = 0;
-	void *result = NULL;
 	while (!shutdown_server)
 	{
 		struct sockaddr_in cli_addr;
@@ -137,6 +319,10 @@ static void *server_routine(void *arg)
 
 		int clilen = sizeof(cli_addr);
 
+		/* wait for a new connection, serving idle ones meanwhile */
+		if ( !http_poll(sockfd) )
+			continue;
+
 		/* accept client request and get client address */
 		newsockfd = accept(sockfd,(struct sockaddr *)&cli_addr,&clilen);
 		if ((int)newsockfd<0 && errno!=EINTR)
@@ -148,6 +334,11 @@ static void *server_routine(void *arg)
 		else if ((int)newsockfd > 0)
 		{
 			char *saddr = inet_ntoa(cli_addr.sin_addr);
+#ifdef WIN32
+			DWORD idle = HTTP_IDLETIME*1000;
+#else
+			struct timeval idle = {HTTP_IDLETIME,0};
+#endif
 			if ( !client_allowed(saddr) )
 			{
 				output_error("denying connection from %s on port %d",saddr, cli_addr.sin_port);
@@ -155,18 +346,21 @@ static void *server_routine(void *arg)
 				continue;
 			}
 			IN_MYCONTEXT output_verbose("accepting connection from %s on port %d",saddr, cli_addr.sin_port);
-			if ( active )
-				pthread_join(thread_id,&result);
-			if ( pthread_create(&thread_id,NULL, http_response,(void*)newsockfd)!=0 )
-				output_error("unable to start http response thread");
+			setsockopt(newsockfd,SOL_SOCKET,SO_RCVTIMEO,(char*)&idle,sizeof(idle));
+			/* a worker only takes the connection once its request arrives */
+			if ( !http_park(newsockfd) )
+				http_enqueue(newsockfd);
 			if (global_server_quit_on_close)
 				shutdown_now();
 			else
 				gui_wait_status(0);
-			active = 1;
 		}
 	}
 	IN_MYCONTEXT output_verbose("server shutdown");
+	pthread_mutex_lock(&http_queue_lock);
+	while ( http_idle_count>0 )
+		http_close_socket(http_idle[--http_idle_count].s);
+	pthread_mutex_unlock(&http_queue_lock);
 Done:
 	started = 0;
 	return (void*)&status;
@@ -299,6 +493,7 @@ typedef struct s_httpcnx {
 	char *type;
 	SOCKET s;
 	bool cooked;
+	int keep_alive; /**< connection stays open after the response */
 } HTTPCNX;
 
 /** Create an HTTPCNX connection handle
@@ -323,6 +518,7 @@ static void http_reset(HTTPCNX *http)
 {
 	http->status = NULL;
 	http->type = NULL;
+	http->keep_alive = 0;
 }
 
 #define HTTP_CONTINUE "100 Continue"
@@ -387,6 +583,7 @@ static void http_send(HTTPCNX *http)
 	len += sprintf(header+len, "HTTP/1.1 %s", http->status?http->status:HTTP_INTERNALSERVERERROR);
 	IN_MYCONTEXT output_verbose("%s (len=%d, mime=%s)",header,http->len,http->type?http->type:"none");
 	len += sprintf(header+len, "\nContent-Length: %d\n", http->len);
+	len += sprintf(header+len, "Connection: %s\n", http->keep_alive?"keep-alive":"close");
 	if (http->type && http->type[0]!='\0')
 		len += sprintf(header+len, "Content-Type: %s\n", http->type);
 	len += sprintf(header+len, "Cache-Control: no-cache\n");
@@ -549,6 +746,29 @@ char *http_unquote(char *buffer)
 	return buffer;
 }
 
+/** Escape a string for use inside a JSON string
+	@returns the escaped string, truncated to fit \p size
+ **/
+static char *http_json_escape(char *out, size_t size, const char *in)
+{
+	size_t n = 0;
+	for ( ; *in!='\0' && n+7<size ; in++ )
+	{
+		unsigned char c = (unsigned char)*in;
+		if ( c=='"' || c=='\\' )
+		{
+			out[n++] = '\\';
+			out[n++] = c;
+		}
+		else if ( c<0x20 )
+			n += sprintf(out+n,"\\u%04x",c);
+		else
+			out[n++] = c;
+	}
+	out[n] = '\0';
+	return out;
+}
+
 /** Get the value of a hex character
 	@returns the value corresponding to the hex code
  **/
@@ -1195,6 +1415,169 @@ int http_read_request(HTTPCNX *http, char *uri)
 	return 1;
 }
 
+/* Append one value to a bulk response; properties may have a unit spec, e.g., voltage_A[kV,4f] */
+static void http_bulk_value(HTTPCNX *http, OBJECT *obj, char *oname, char *pname, int *count)
+{
+	char prop[1024], buffer[1024], name[1024], property[1024], value[2048];
+	strncpy(prop,pname,sizeof(prop)-1);
+	prop[sizeof(prop)-1] = '\0';
+	http_json_escape(name,sizeof(name),oname);
+	http_json_escape(property,sizeof(property),pname);
+	if ( (*count)++>0 )
+		http_format(http,",\n");
+	if ( obj!=NULL && get_value_with_unit(obj,oname,prop,buffer,sizeof(buffer))>0 )
+		http_format(http,"\t\t\"%s.%s\": \"%s\"",name,property,http_json_escape(value,sizeof(value),http_unquote(buffer)));
+	else
+		http_format(http,"\t\t\"%s.%s\": null",name,property);
+}
+
+/* Start a bulk response with the time of the snapshot */
+static void http_bulk_begin(HTTPCNX *http)
+{
+	char buffer[64] = "";
+	convert_from_timestamp(global_clock,buffer,sizeof(buffer));
+	http_format(http,"{\t\"clock\" : %lld,\n\t\"timestamp\" : \"%s\",\n\t\"values\" : {\n", global_clock, buffer);
+}
+
+static void http_bulk_end(HTTPCNX *http)
+{
+	http_format(http,"\n\t}\n}\n");
+	http_type(http,"text/json");
+}
+
+/** Process a bulk snapshot request
+
+	The request is a list of \p object.property items separated by semicolons,
+	e.g., \p /bulk/meter_1.measured_real_power;meter_2.voltage_1[V,2f].
+	All the values are read at the same pass of the main loop.  Values that
+	cannot be read are returned as \p null.
+    @returns non-zero on success, 0 on failure (errno set)
+ **/
+int http_bulk_request(HTTPCNX *http, char *uri)
+{
+	char *p = uri;
+	int count = 0;
+	http_decode(uri);
+	exec_snapshot_begin();
+	http_bulk_begin(http);
+	while ( p!=NULL && *p!='\0' )
+	{
+		char oname[1024], pname[1024];
+		if ( sscanf(p,"%1023[^.;].%1023[^;]",oname,pname)==2 )
+			http_bulk_value(http,object_find_name(oname),oname,pname,&count);
+		else
+			output_error("bulk request syntax error at '%s'", p);
+		p = strchr(p,';');
+		if ( p!=NULL )
+			p++;
+	}
+	http_bulk_end(http);
+	exec_snapshot_end();
+	return 1;
+}
+
+/** Process a bulk modify request
+
+	The request is a list of \p object.property=value items separated by
+	semicolons, e.g., \p /bulkmodify/load_1.constant_power_A=1000;load_2.constant_power_A=1200.
+	All the values are set between the same two passes of the main loop.
+	The response lists the values as read back after they are set, or \p null
+	for those that could not be set.
+    @returns non-zero on success, 0 on failure (errno set)
+ **/
+int http_bulkmodify_request(HTTPCNX *http, char *uri)
+{
+	char *p = uri;
+	int count = 0;
+	http_decode(uri);
+	exec_snapshot_begin();
+	http_bulk_begin(http);
+	while ( p!=NULL && *p!='\0' )
+	{
+		char oname[1024], pname[1024], value[1024];
+		if ( sscanf(p,"%1023[^.;].%1023[^=;]=%1023[^;]",oname,pname,value)==3 )
+		{
+			OBJECT *obj = object_find_name(oname);
+			if ( obj==NULL )
+				output_error("object '%s' not found", oname);
+			else if ( object_set_value_by_name(obj,pname,value)<=0 )
+			{
+				output_error("object '%s' property '%s' set to '%s' failed", oname, pname, value);
+				obj = NULL;
+			}
+			http_bulk_value(http,obj,oname,pname,&count);
+		}
+		else
+			output_error("bulk modify syntax error at '%s'", p);
+		p = strchr(p,';');
+		if ( p!=NULL )
+			p++;
+	}
+	http_bulk_end(http);
+	exec_snapshot_end();
+	return 1;
+}
+
+/** Process a bulk snapshot request for the objects found by a search
+
+	The request is a list of properties separated by semicolons, then a
+	slash, then a find expression, e.g., \p /bulkfind/measured_real_power;voltage_1[V]/class=meter.
+	All the values are read at the same pass of the main loop.
+    @returns non-zero on success, 0 on failure (errno set)
+ **/
+int http_bulkfind_request(HTTPCNX *http, char *uri)
+{
+	char *search = uri;
+	int count = 0, depth = 0;
+	FINDPGM *finder;
+	FINDLIST *list;
+	OBJECT *obj;
+
+	/* the search starts after the first slash that is not in a unit spec */
+	for ( ; *search!='\0' && (*search!='/' || depth>0) ; search++ )
+	{
+		if ( *search=='[' ) depth++;
+		else if ( *search==']' ) depth--;
+	}
+	if ( *search=='\0' )
+		return 0;
+	*search++ = '\0';
+	http_decode(uri);
+	finder = find_mkpgm(search);
+	if ( finder==NULL )
+		return 0;
+
+	exec_snapshot_begin();
+	list = find_runpgm(NULL,finder);
+	if ( list==NULL )
+	{
+		exec_snapshot_end();
+		return 0;
+	}
+	http_bulk_begin(http);
+	for ( obj=find_first(list) ; obj!=NULL ; obj=find_next(list,obj) )
+	{
+		char oname[1024], *p = uri;
+		if ( obj->name==NULL )
+			sprintf(oname,"%s:%d",obj->oclass->name,obj->id);
+		else
+			strcpy(oname,obj->name);
+		while ( p!=NULL && *p!='\0' )
+		{
+			char pname[1024];
+			if ( sscanf(p,"%1023[^;]",pname)==1 )
+				http_bulk_value(http,obj,oname,pname,&count);
+			p = strchr(p,';');
+			if ( p!=NULL )
+				p++;
+		}
+	}
+	http_bulk_end(http);
+	exec_snapshot_end();
+	free(list);
+	return 1;
+}
+
 /** Process an incoming GUI request
 	@returns non-zero on success, 0 on failure (errno set)
  **/
@@ -1872,14 +2255,11 @@ int http_favicon(HTTPCNX *http)
 	return http_copy(http,"icon",fullpath,false,0);
 }
 
-/** Process an incoming request
-	@returns nothing
+/** Serve one request already read from a connection
+	@returns non-zero if the connection is kept open for another request, 0 if it must be closed
  **/
-void *http_response(void *ptr)
+static int http_serve(HTTPCNX *http, size_t len)
 {
-	SOCKET fd = (SOCKET)ptr;
-	HTTPCNX *http = http_create(fd);
-	size_t len;
 	int content_length = 0;
 	char *user_agent = NULL;
 	char *host = NULL;
@@ -1899,120 +2279,155 @@ void *http_response(void *ptr)
 		{"Accept", STRING, (void*)&accept, 0},
 	};
 
-	while ( (int)(len=recv_data(fd,http->query,sizeof(http->query)))>0 )
-	{
-		/* first term is always the request */
-		char *request = http->query;
-		char method[32];
-		char uri[1024];
-		char version[32];
-		char *p = strchr(http->query,'\r');
-		int v;
-		
-		/* initialize the response */
-		http_reset(http);
+	/* first term is always the request */
+	char *request = http->query;
+	char method[32];
+	char uri[1024];
+	char version[32];
+	char *p;
+	int v;
+	
+	/* initialize the response */
+	http_reset(http);
+	http->query[len<sizeof(http->query)?len:sizeof(http->query)-1] = '\0';
+	p = strchr(http->query,'\r');
 
-		/* read the request string */
-		if (sscanf(request,"%s %s %s",method,uri,version)!=3)
-		{
-			http_status(http,HTTP_BADREQUEST);
-			output_error("request [%s] is bad", request);
-			http_send(http);
-			break;
-		}
+	/* read the request string */
+	if (sscanf(request,"%31s %1023s %31s",method,uri,version)!=3)
+	{
+		http_status(http,HTTP_BADREQUEST);
+		output_error("request [%s] is bad", request);
+		http_send(http);
+		return 0;
+	}
 
-		/* read the rest of the header */
-		while (p!=NULL && (p=strchr(p,'\r'))!=NULL) 
+	/* read the rest of the header */
+	while (p!=NULL && (p=strchr(p,'\r'))!=NULL) 
+	{
+		*p = '\0';
+		p+=2;
+		for ( v=0 ; v<sizeof(map)/sizeof(map[0]) ; v++ )
 		{
- 			*p = '\0';
-			p+=2;
-			for ( v=0 ; v<sizeof(map)/sizeof(map[0]) ; v++ )
+			if (map[v].sz==0) map[v].sz = strlen(map[v].name);
+			if (strnicmp(map[v].name,p,map[v].sz)==0 && strncmp(p+map[v].sz,": ",2)==0)
 			{
-				if (map[v].sz==0) map[v].sz = strlen(map[v].name);
-				if (strnicmp(map[v].name,p,map[v].sz)==0 && strncmp(p+map[v].sz,": ",2)==0)
-				{
-					if (map[v].type==INTEGER) { *(int*)(map[v].value) = atoi(p+map[v].sz+2); break; }
-					else if (map[v].type==STRING) { *(char**)map[v].value = p+map[v].sz+2; break; }
-				}
+				if (map[v].type==INTEGER) { *(int*)(map[v].value) = atoi(p+map[v].sz+2); break; }
+				else if (map[v].type==STRING) { *(char**)map[v].value = p+map[v].sz+2; break; }
 			}
 		}
-		IN_MYCONTEXT output_verbose("%s (host='%s', len=%d, keep-alive=%d)",http->query,host?host:"???",content_length, keep_alive);
+	}
+	IN_MYCONTEXT output_verbose("%s (host='%s', len=%d, keep-alive=%d)",http->query,host?host:"???",content_length, keep_alive);
 
-		/* reject anything but a GET */
-		if (stricmp(method,"GET")!=0)
-		{
-			http_status(http,HTTP_METHODNOTALLOWED);
-			/* technically, we should add an Allow entry to the response header */
-			output_error("request [%s %s %s]: '%s' is not an allowed method", method, uri, version, method);
-			http_send(http);
-			break;
-		}
+	/* HTTP/1.0 closes unless the client asks to keep the connection, later versions keep it unless asked to close */
+	if ( stricmp(version,"HTTP/1.0")==0 )
+		http->keep_alive = ( connection!=NULL && stricmp(connection,"keep-alive")==0 );
+	else
+		http->keep_alive = ( connection==NULL || stricmp(connection,"close")!=0 );
+
+	/* reject anything but a GET */
+	if (stricmp(method,"GET")!=0)
+	{
+		http_status(http,HTTP_METHODNOTALLOWED);
+		/* technically, we should add an Allow entry to the response header */
+		output_error("request [%s %s %s]: '%s' is not an allowed method", method, uri, version, method);
+		http->keep_alive = 0;
+		http_send(http);
+		return 0;
+	}
 
-		/* handle request */
-		if ( strcmp(uri,"/favicon.ico")==0 )
+	/* handle request */
+	if ( strcmp(uri,"/favicon.ico")==0 )
+	{
+		if ( http_favicon(http) )
+			http_status(http,HTTP_OK);
+		else
+			http_status(http,HTTP_NOTFOUND);
+		http_send(http);
+	}
+	else {
+		static struct s_map {
+			char *path;
+			int (*request)(HTTPCNX*,char*);
+			char *success;
+			char *failure;
+			int concurrent; /* the handler only reads inside an exec snapshot */
+		} map[] = {
+			/* this is the map of recognize request types; the legacy handlers
+			   share globals (e.g., the gui output stream) and change the model
+			   and exec state, so they run one at a time */
+			{"/control/",	http_control_request,	HTTP_ACCEPTED, HTTP_NOTFOUND, 0},
+			{"/open/",		http_open_request,		HTTP_ACCEPTED, HTTP_NOTFOUND, 0},
+			{"/raw/",		http_raw_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/xml/",		http_xml_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/gui/",		http_gui_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/output/",	http_output_request,	HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/action/",	http_action_request,	HTTP_ACCEPTED,HTTP_NOTFOUND, 0},
+			{"/rt/",		http_get_rt,			HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/rb/",		http_get_rb,			HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/perl/",		http_run_perl,			HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/gnuplot/",	http_run_gnuplot,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/java/",		http_run_java,			HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/python/",	http_run_python,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/r/",			http_run_r,				HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/scilab/",	http_run_scilab,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/octave/",	http_run_octave,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/kml/", 		http_kml_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/json/",		http_json_request,		HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/find/",	http_find_request,	HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/modify/",	http_modify_request,	HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/read/",	http_read_request,	HTTP_OK, HTTP_NOTFOUND, 0},
+			{"/bulk/",	http_bulk_request,	HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/bulkfind/",	http_bulkfind_request,	HTTP_OK, HTTP_NOTFOUND, 1},
+			{"/bulkmodify/",	http_bulkmodify_request,	HTTP_OK, HTTP_NOTFOUND, 0},
+		};
+		int n;
+		for ( n=0 ; n<sizeof(map)/sizeof(map[0]) ; n++ )
 		{
-			if ( http_favicon(http) )
-				http_status(http,HTTP_OK);
-			else
-				http_status(http,HTTP_NOTFOUND);
-			http_send(http);
-		}
-		else {
-			static struct s_map {
-				char *path;
-				int (*request)(HTTPCNX*,char*);
-				char *success;
-				char *failure;
-			} map[] = {
-				/* this is the map of recognize request types */
-				{"/control/",	http_control_request,	HTTP_ACCEPTED, HTTP_NOTFOUND},
-				{"/open/",		http_open_request,		HTTP_ACCEPTED, HTTP_NOTFOUND},
-				{"/raw/",		http_raw_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/xml/",		http_xml_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/gui/",		http_gui_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/output/",	http_output_request,	HTTP_OK, HTTP_NOTFOUND},
-				{"/action/",	http_action_request,	HTTP_ACCEPTED,HTTP_NOTFOUND},
-				{"/rt/",		http_get_rt,			HTTP_OK, HTTP_NOTFOUND},
-				{"/rb/",		http_get_rb,			HTTP_OK, HTTP_NOTFOUND},
-				{"/perl/",		http_run_perl,			HTTP_OK, HTTP_NOTFOUND},
-				{"/gnuplot/",	http_run_gnuplot,		HTTP_OK, HTTP_NOTFOUND},
-				{"/java/",		http_run_java,			HTTP_OK, HTTP_NOTFOUND},
-				{"/python/",	http_run_python,		HTTP_OK, HTTP_NOTFOUND},
-				{"/r/",			http_run_r,				HTTP_OK, HTTP_NOTFOUND},
-				{"/scilab/",	http_run_scilab,		HTTP_OK, HTTP_NOTFOUND},
-				{"/octave/",	http_run_octave,		HTTP_OK, HTTP_NOTFOUND},
-				{"/kml/", 		http_kml_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/json/",		http_json_request,		HTTP_OK, HTTP_NOTFOUND},
-				{"/find/",	http_find_request,	HTTP_OK, HTTP_NOTFOUND},
-				{"/modify/",	http_modify_request,	HTTP_OK, HTTP_NOTFOUND},
-				{"/read/",	http_read_request,	HTTP_OK, HTTP_NOTFOUND},
-			};
-			int n;
-			for ( n=0 ; n<sizeof(map)/sizeof(map[0]) ; n++ )
+			size_t len = strlen(map[n].path);
+			if (strncmp(uri,map[n].path,len)==0)
 			{
-				size_t len = strlen(map[n].path);
-				if (strncmp(uri,map[n].path,len)==0)
-				{
-					if ( map[n].request(http,uri+len) )
-						http_status(http,map[n].success);
-					else
-						http_status(http,map[n].failure);
-					http_send(http);
-
-					/* keep-alive not desired*/
-					if (connection && stricmp(connection,"close")==0)
-						break;
-					else
-						continue;
-				}
+				int ok;
+				if ( !map[n].concurrent )
+					pthread_mutex_lock(&http_handler_lock);
+				ok = map[n].request(http,uri+len);
+				if ( !map[n].concurrent )
+					pthread_mutex_unlock(&http_handler_lock);
+				if ( ok )
+					http_status(http,map[n].success);
+				else
+					http_status(http,map[n].failure);
+				http_send(http);
+				break;
 			}
-			break;
 		}
-		break;
+		if ( n==sizeof(map)/sizeof(map[0]) )
+			return 0;
+	}
+	return http->keep_alive;
+}
+
+/** Process an incoming request
+
+	One request is served, after which a keep-alive connection is given
+	back to the accept loop to wait for the next one.
+	@returns nothing
+ **/
+void *http_response(void *ptr)
+{
+	SOCKET fd = (SOCKET)ptr;
+	HTTPCNX *http = http_create(fd);
+	size_t len = recv_data(fd,http->query,sizeof(http->query));
+	if ( (int)len>0 && http_serve(http,len) && http_park(fd) )
+	{
+		IN_MYCONTEXT output_verbose("socket %d waiting for next request",fd);
+		free(http->buffer);
+	}
+	else
+	{
+		IN_MYCONTEXT output_verbose("socket %d closed",http->s);
+		http_close(http);
 	}
-	http_close(http);
 	free(http);
-	IN_MYCONTEXT output_verbose("socket %d closed",http->s);
 	return 0;
 }
 
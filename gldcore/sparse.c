@@ -0,0 +1,517 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file sparse.c
+	@addtogroup sparse
+	@ingroup core
+
+	Sleeping objects, their wakeup heaps and the rank lists of the objects
+	that are awake.  See sparse.h for the design.
+ @{
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "globals.h"
+#include "output.h"
+#include "class.h"
+#include "exec.h"
+#include "sparse.h"
+
+#define NPASSES 3 /* presync, sync and postsync */
+#define HARD 0
+#define SOFT 1
+
+/** The wakeup properties of a class */
+typedef struct s_sparseclass {
+	CLASS *oclass;
+	PROPERTY **prop;
+	unsigned int n;
+	size_t size; /**< total size of the property values */
+	struct s_sparseclass *next;
+} SPARSECLASS;
+
+typedef struct s_sparseobject {
+	OBJECT *obj;
+	SPARSECLASS *sc;
+	int rank[NPASSES]; /**< rank of the object in each pass, -1 if the pass does not call it */
+	TIMESTAMP at[2]; /**< earliest hard and soft event returned by the passes of the last iteration it ran */
+	unsigned int heap[2]; /**< position in the hard and soft heaps plus one, 0 if not in the heap */
+	unsigned int watch; /**< position in the watch list plus one, 0 if not in it */
+	unsigned int awake; /**< position in the awake list plus one, 0 if asleep */
+	unsigned char *snapshot; /**< values of the wakeup properties when it fell asleep */
+} SPARSEOBJECT;
+
+/** The objects of one rank that are synchronized in the current iteration.
+	The objects that never sleep come first and stay. */
+typedef struct s_sparserank {
+	INDEXARRAY list;
+	size_t fixed, max;
+} SPARSERANK;
+
+typedef struct s_idlist {
+	OBJECTNUM *id;
+	unsigned int n, max;
+} IDLIST;
+
+int sparse_active = 0;
+static SPARSECLASS *sparse_classes = NULL;
+static SPARSEOBJECT *sparse_object = NULL; /* indexed by object id, obj is NULL for objects that never sleep */
+static unsigned int sparse_count = 0;
+static SPARSERANK *sparse_ranks[NPASSES] = {NULL,NULL,NULL};
+static int sparse_nranks[NPASSES] = {0,0,0};
+static IDLIST sparse_heap[2] = {{NULL,0,0},{NULL,0,0}};
+static IDLIST sparse_awake = {NULL,0,0};
+static IDLIST sparse_watch = {NULL,0,0};
+static unsigned int sparse_sleeps = 0, sparse_wakeups = 0;
+
+/* stop putting objects to sleep when the tables cannot grow; every object is synchronized again */
+static void fallback(void)
+{
+	output_warning("sparse sync is out of memory, all objects will be synchronized on every pass");
+	/* TROUBLESHOOT
+		The memory needed to track sleeping objects could not be allocated, so sparse synchronization was turned off
+		for the rest of the run.  The results are not affected, but the run is slower.  Free some memory and try again.
+	 */
+	sparse_active = 0;
+}
+
+static int list_grow(void **list, unsigned int *max, size_t size)
+{
+	unsigned int n = *max==0 ? 256 : *max*2;
+	void *grown = realloc(*list,size*n);
+	if ( grown==NULL )
+		return 0;
+	*list = grown;
+	*max = n;
+	return 1;
+}
+
+/* add an object to an id list and return its position plus one, 0 on failure */
+static unsigned int idlist_add(IDLIST *list, OBJECTNUM id)
+{
+	if ( list->n==list->max && !list_grow((void**)&list->id,&list->max,sizeof(OBJECTNUM)) )
+		return 0;
+	list->id[list->n++] = id;
+	return list->n;
+}
+
+/* remove the item at pos (plus one) by moving the last item there; returns the id moved, or -1 */
+static int64 idlist_remove(IDLIST *list, unsigned int pos)
+{
+	OBJECTNUM last = list->id[--list->n];
+	if ( pos-1==list->n )
+		return -1;
+	list->id[pos-1] = last;
+	return last;
+}
+
+/*
+ * wakeup heaps, ordered by the earliest hard (or soft) event of each sleeping object
+ */
+#define KEY(H,I) (sparse_object[sparse_heap[H].id[I]].at[H])
+static void heap_swap(int h, unsigned int i, unsigned int j)
+{
+	OBJECTNUM a = sparse_heap[h].id[i], b = sparse_heap[h].id[j];
+	sparse_heap[h].id[i] = b;
+	sparse_heap[h].id[j] = a;
+	sparse_object[b].heap[h] = i+1;
+	sparse_object[a].heap[h] = j+1;
+}
+static void heap_up(int h, unsigned int i)
+{
+	while ( i>0 && KEY(h,(i-1)/2)>KEY(h,i) )
+	{
+		heap_swap(h,i,(i-1)/2);
+		i = (i-1)/2;
+	}
+}
+static void heap_down(int h, unsigned int i)
+{
+	for (;;)
+	{
+		unsigned int l = 2*i+1, r = l+1, m = i;
+		if ( l<sparse_heap[h].n && KEY(h,l)<KEY(h,m) ) m = l;
+		if ( r<sparse_heap[h].n && KEY(h,r)<KEY(h,m) ) m = r;
+		if ( m==i )
+			break;
+		heap_swap(h,i,m);
+		i = m;
+	}
+}
+static int heap_push(int h, OBJECTNUM id)
+{
+	unsigned int pos = idlist_add(&sparse_heap[h],id);
+	if ( pos==0 )
+		return 0;
+	sparse_object[id].heap[h] = pos;
+	heap_up(h,pos-1);
+	return 1;
+}
+static void heap_remove(int h, OBJECTNUM id)
+{
+	unsigned int i = sparse_object[id].heap[h]-1;
+	int64 moved;
+	sparse_object[id].heap[h] = 0;
+	moved = idlist_remove(&sparse_heap[h],i+1);
+	if ( moved>=0 )
+	{
+		sparse_object[moved].heap[h] = i+1;
+		heap_up(h,i);
+		heap_down(h,sparse_object[moved].heap[h]-1);
+	}
+}
+
+/* the wakeup properties of a class, NULL if it has none */
+static SPARSECLASS *get_class(CLASS *oclass)
+{
+	SPARSECLASS *sc;
+	PROPERTY *prop;
+	for ( sc=sparse_classes ; sc!=NULL ; sc=sc->next )
+	{
+		if ( sc->oclass==oclass )
+			return sc;
+	}
+	sc = (SPARSECLASS*)malloc(sizeof(SPARSECLASS));
+	if ( sc==NULL )
+		return NULL;
+	memset(sc,0,sizeof(SPARSECLASS));
+	sc->oclass = oclass;
+	for ( prop=oclass->pmap ; prop!=NULL ; prop=prop->next ) /* includes inherited properties */
+	{
+		if ( (prop->flags&PF_WAKEUP) && property_size(prop)>0 )
+			sc->n++;
+	}
+	if ( sc->n>0 )
+	{
+		sc->prop = (PROPERTY**)malloc(sizeof(PROPERTY*)*sc->n);
+		if ( sc->prop==NULL )
+		{
+			free(sc);
+			return NULL;
+		}
+		sc->n = 0;
+		for ( prop=oclass->pmap ; prop!=NULL ; prop=prop->next )
+		{
+			if ( (prop->flags&PF_WAKEUP) && property_size(prop)>0 )
+			{
+				sc->prop[sc->n++] = prop;
+				sc->size += property_size(prop);
+			}
+		}
+	}
+	sc->next = sparse_classes;
+	sparse_classes = sc;
+	return sc;
+}
+
+/* copy or compare the wakeup properties of an object; returns non-zero if they changed */
+static int snapshot(SPARSEOBJECT *so, int compare)
+{
+	unsigned char *p = so->snapshot;
+	unsigned int i;
+	for ( i=0 ; i<so->sc->n ; i++ )
+	{
+		PROPERTY *prop = so->sc->prop[i];
+		size_t size = property_size(prop);
+		void *addr = GETADDR(so->obj,prop);
+		if ( compare )
+		{
+			if ( memcmp(p,addr,size)!=0 )
+				return 1;
+		}
+		else
+			memcpy(p,addr,size);
+		p += size;
+	}
+	return 0;
+}
+
+static int wake(OBJECTNUM id)
+{
+	SPARSEOBJECT *so = sparse_object + id;
+	int h;
+	unsigned int pos;
+	for ( h=HARD ; h<=SOFT ; h++ )
+	{
+		if ( so->heap[h]>0 )
+			heap_remove(h,id);
+	}
+	if ( so->watch>0 )
+	{
+		int64 moved = idlist_remove(&sparse_watch,so->watch);
+		if ( moved>=0 )
+			sparse_object[moved].watch = so->watch;
+		so->watch = 0;
+	}
+	pos = idlist_add(&sparse_awake,id);
+	if ( pos==0 )
+		return 0;
+	so->awake = pos;
+	sparse_wakeups++;
+	return 1;
+}
+
+static int fall_asleep(OBJECTNUM id)
+{
+	SPARSEOBJECT *so = sparse_object + id;
+	int h;
+	for ( h=HARD ; h<=SOFT ; h++ )
+	{
+		if ( so->at[h]<TS_NEVER && !heap_push(h,id) )
+			return 0;
+	}
+	if ( so->sc!=NULL && so->sc->n>0 )
+	{
+		unsigned int pos = idlist_add(&sparse_watch,id);
+		if ( pos==0 )
+			return 0;
+		so->watch = pos;
+		snapshot(so,0);
+	}
+	sparse_sleeps++;
+	return 1;
+}
+
+/** Split the frozen ranks into the objects that never sleep and those that may.
+	All objects start awake.
+	@return 1 if sparse synchronization is in use, 0 otherwise
+ **/
+int sparse_init(INDEX **ranks)
+{
+	OBJECT *obj;
+	int pass, i;
+	unsigned int n_sleepers = 0;
+
+	sparse_count = object_get_count();
+	sparse_object = (SPARSEOBJECT*)malloc(sizeof(SPARSEOBJECT)*(sparse_count>0?sparse_count:1));
+	if ( sparse_object==NULL )
+		goto Error;
+	memset(sparse_object,0,sizeof(SPARSEOBJECT)*sparse_count);
+	for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+	{
+		SPARSEOBJECT *so;
+		if ( obj->id>=sparse_count || (obj->oclass->passconfig&PC_SPARSE_SYNC)==0 )
+			continue;
+		so = sparse_object + obj->id;
+		so->obj = obj;
+		so->sc = get_class(obj->oclass);
+		if ( so->sc==NULL )
+			goto Error;
+		if ( so->sc->size>0 && (so->snapshot=(unsigned char*)malloc(so->sc->size))==NULL )
+			goto Error;
+		so->rank[0] = so->rank[1] = so->rank[2] = -1;
+		so->at[HARD] = so->at[SOFT] = TS_NEVER;
+		if ( !wake(obj->id) )
+			goto Error;
+		n_sleepers++;
+	}
+
+	for ( pass=0 ; pass<NPASSES && ranks[pass]!=NULL ; pass++ )
+	{
+		sparse_nranks[pass] = ranks[pass]->last_ordinal - ranks[pass]->first_ordinal;
+		sparse_ranks[pass] = (SPARSERANK*)malloc(sizeof(SPARSERANK)*(sparse_nranks[pass]>0?sparse_nranks[pass]:1));
+		if ( sparse_ranks[pass]==NULL )
+			goto Error;
+		memset(sparse_ranks[pass],0,sizeof(SPARSERANK)*sparse_nranks[pass]);
+		for ( i=0 ; i<sparse_nranks[pass] ; i++ )
+		{
+			INDEXARRAY *all = ranks[pass]->frozen + i;
+			SPARSERANK *rank = sparse_ranks[pass] + i;
+			size_t n;
+			if ( all->size==0 )
+				continue;
+			rank->list.item = (void**)malloc(sizeof(void*)*all->size);
+			if ( rank->list.item==NULL )
+				goto Error;
+			rank->max = all->size;
+			for ( n=0 ; n<all->size ; n++ )
+			{
+				obj = (OBJECT*)all->item[n];
+				if ( sparse_object[obj->id].obj==NULL )
+					rank->list.item[rank->fixed++] = obj;
+				else
+					sparse_object[obj->id].rank[pass] = i;
+			}
+			rank->list.size = rank->fixed;
+		}
+	}
+	sparse_active = 1;
+	sparse_wakeups = 0;
+	output_verbose("sparse sync enabled, %u of %u objects may sleep", n_sleepers, sparse_count);
+	return 1;
+
+Error:
+	output_error("sparse_init(): unable to allocate sparse sync tables: %s", strerror(errno));
+	/* TROUBLESHOOT
+		The memory needed to track sleeping objects could not be allocated.
+		Free some memory or disable sparse_sync and try again.
+	 */
+	sparse_term();
+	return 0;
+}
+
+/** Wake the sleeping objects whose next event is due at \p t or whose
+	wakeup properties changed, and rebuild the rank lists.  Called before
+	the passes of each iteration.
+
+	The due events cost O(log n) per object woken, but the wakeup
+	properties are not indexed: every sleeping object of a class that has
+	any is compared with its snapshot, so this scan is O(watched sleepers)
+	on every iteration.
+ **/
+void sparse_wake(TIMESTAMP t)
+{
+	unsigned int i;
+	int h, pass;
+	if ( !sparse_active )
+		return;
+
+	/* events that are due */
+	for ( h=HARD ; h<=SOFT ; h++ )
+	{
+		while ( sparse_heap[h].n>0 && KEY(h,0)<=t )
+		{
+			if ( !wake(sparse_heap[h].id[0]) )
+			{
+				fallback();
+				return;
+			}
+		}
+	}
+
+	/* inputs that changed */
+	for ( i=0 ; i<sparse_watch.n ; )
+	{
+		OBJECTNUM id = sparse_watch.id[i];
+		if ( !snapshot(sparse_object+id,1) )
+			i++;
+		else if ( !wake(id) ) /* moves the last watched object to i */
+		{
+			fallback();
+			return;
+		}
+	}
+
+	/* the awake objects join the objects that never sleep */
+	for ( pass=0 ; pass<NPASSES ; pass++ )
+	{
+		for ( i=0 ; i<(unsigned int)sparse_nranks[pass] ; i++ )
+			sparse_ranks[pass][i].list.size = sparse_ranks[pass][i].fixed;
+	}
+	for ( i=0 ; i<sparse_awake.n ; i++ )
+	{
+		SPARSEOBJECT *so = sparse_object + sparse_awake.id[i];
+		so->at[HARD] = so->at[SOFT] = TS_NEVER;
+		for ( pass=0 ; pass<NPASSES ; pass++ )
+		{
+			if ( so->rank[pass]>=0 )
+			{
+				SPARSERANK *rank = sparse_ranks[pass] + so->rank[pass];
+				rank->list.item[rank->list.size++] = so->obj; /* never more than all the objects of the rank */
+			}
+		}
+	}
+}
+
+/** Get the objects of a rank to synchronize in this iteration
+	@return \p all when sparse synchronization is not in use
+ **/
+INDEXARRAY *sparse_rank(int pass, int rank, INDEXARRAY *all)
+{
+	if ( !sparse_active || pass>=NPASSES || rank<0 || rank>=sparse_nranks[pass] )
+		return all;
+	return &sparse_ranks[pass][rank].list;
+}
+
+/** Record the time returned by a pass of an object.  Each object is
+	called by one thread at a time, so this needs no lock.
+ **/
+void sparse_record(OBJECT *obj, TIMESTAMP t)
+{
+	SPARSEOBJECT *so;
+	if ( !sparse_active || obj->id>=sparse_count || (so=sparse_object+obj->id)->obj==NULL )
+		return;
+	if ( t<-1 ) /* soft event */
+	{
+		if ( -t<so->at[SOFT] )
+			so->at[SOFT] = -t;
+	}
+	else if ( t<so->at[HARD] )
+		so->at[HARD] = t;
+}
+
+/** Put to sleep the awake objects whose events are all later than \p t
+	and post the earliest events of the sleeping objects to the main sync
+	event.  Called after the passes of each iteration.
+ **/
+void sparse_sleep(TIMESTAMP t)
+{
+	unsigned int i;
+	if ( !sparse_active )
+		return;
+	for ( i=0 ; i<sparse_awake.n ; )
+	{
+		OBJECTNUM id = sparse_awake.id[i];
+		SPARSEOBJECT *so = sparse_object + id;
+		if ( so->at[HARD]<=t || so->at[SOFT]<=t )
+			i++;
+		else if ( fall_asleep(id) )
+		{
+			int64 moved = idlist_remove(&sparse_awake,so->awake);
+			if ( moved>=0 )
+				sparse_object[moved].awake = so->awake;
+			so->awake = 0;
+		}
+		else
+		{
+			fallback();
+			return;
+		}
+	}
+	if ( sparse_heap[HARD].n>0 )
+		exec_sync_set(NULL,KEY(HARD,0),false);
+	if ( sparse_heap[SOFT].n>0 )
+		exec_sync_set(NULL,-KEY(SOFT,0),false);
+}
+
+/** Release the sparse synchronization tables */
+void sparse_term(void)
+{
+	int pass, i;
+	unsigned int n;
+	if ( sparse_active )
+		output_verbose("sparse sync put objects to sleep %u times and woke them %u times", sparse_sleeps, sparse_wakeups);
+	sparse_active = 0;
+	for ( pass=0 ; pass<NPASSES ; pass++ )
+	{
+		for ( i=0 ; sparse_ranks[pass]!=NULL && i<sparse_nranks[pass] ; i++ )
+			free(sparse_ranks[pass][i].list.item);
+		free(sparse_ranks[pass]);
+		sparse_ranks[pass] = NULL;
+		sparse_nranks[pass] = 0;
+	}
+	for ( n=0 ; sparse_object!=NULL && n<sparse_count ; n++ )
+		free(sparse_object[n].snapshot);
+	free(sparse_object);
+	sparse_object = NULL;
+	sparse_count = 0;
+	while ( sparse_classes!=NULL )
+	{
+		SPARSECLASS *next = sparse_classes->next;
+		free(sparse_classes->prop);
+		free(sparse_classes);
+		sparse_classes = next;
+	}
+	free(sparse_heap[HARD].id);
+	free(sparse_heap[SOFT].id);
+	free(sparse_awake.id);
+	free(sparse_watch.id);
+	memset(sparse_heap,0,sizeof(sparse_heap));
+	memset(&sparse_awake,0,sizeof(sparse_awake));
+	memset(&sparse_watch,0,sizeof(sparse_watch));
+	sparse_sleeps = sparse_wakeups = 0;
+}
+
+/**@}**/
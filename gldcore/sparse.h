@@ -0,0 +1,59 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file sparse.h
+	@addtogroup sparse Sparse synchronization
+	@ingroup core
+
+	Normally every object in every rank is synchronized on every pass of
+	every iteration, even when most of them will not change until an event
+	far in the future.  When the \p sparse_sync global is set, objects of
+	classes registered with \p PC_SPARSE_SYNC fall asleep after an
+	iteration in which all their passes returned a time later than the
+	clock.  A sleeping object is left out of the ranks until
+	- the clock reaches the earliest time it returned, or
+	- one of the properties its class published with \p PF_WAKEUP changed
+	  since it fell asleep.
+
+	The earliest hard and soft events of the sleeping objects are kept in
+	two heaps, and are posted to the main sync event on every iteration as
+	if the objects had returned them again.  Objects of other classes are
+	synchronized as before, so the cost of a step is the number of those
+	objects plus the number of objects that wake up, plus one comparison of
+	the wakeup properties of each sleeping object that has any.  That last
+	scan is O(watched sleepers) per iteration because property writes are
+	not intercepted, so classes should publish \p PF_WAKEUP only on inputs
+	that other objects actually write (e.g., the \p magnitude of a tape
+	shaper).
+
+	A class may use \p PC_SPARSE_SYNC only when calling its sync again
+	before its next event, with the same inputs, would not change anything
+	(e.g., it does not re-post contributions to its parent on every pass).
+ @{
+ **/
+
+#ifndef _SPARSE_H
+#define _SPARSE_H
+
+#include "index.h"
+#include "object.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int sparse_active; /**< non-zero while sparse synchronization is in use */
+
+int sparse_init(INDEX **ranks);
+void sparse_wake(TIMESTAMP t);
+INDEXARRAY *sparse_rank(int pass, int rank, INDEXARRAY *all);
+void sparse_record(OBJECT *obj, TIMESTAMP t);
+void sparse_sleep(TIMESTAMP t);
+void sparse_term(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}**/
@@ -13,6 +13,7 @@
 #include "find.h"
 #include "test.h"
 #include "aggregate.h"
+#include "threadpool.h"
 
 typedef struct s_testlist {
 	char name[64];
@@ -27,7 +28,10 @@ static TESTLIST test_list[] = {
 	{"schedule",	schedule_test,		0, test_list+4},
 	{"loadshape",	loadshape_test,		0, test_list+5},
 	{"enduse",		enduse_test,		0, test_list+6},
-	{"lock",		test_lock,			0, NULL}, /* last test in list has no next */
+	{"localtime",	timestamp_cache_test,	0, test_list+7},
+	{"lock",		test_lock,			0, test_list+8},
+	{"wsp",			wsp_test,			0, test_list+9},
+	{"objpool",		object_pool_test,	0, NULL}, /* last test in list has no next */
 	/* add new core test routines before this line */
 }, *last_test = test_list+sizeof(test_list)/sizeof(test_list[0])-1;
 
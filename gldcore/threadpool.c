@@ -312,3 +312,396 @@ int mti_run(MTIDATA result, MTI *mti, MTIDATA input)
 	mti->runtime += (clock_t)exec_clock() - t0;
 	return 1;
 }
+
+/******************************************************************
+ * WORK-STEALING POOL
+ ******************************************************************/
+
+/** Worker range of items not yet taken **/
+typedef struct s_wsprange {
+	pthread_mutex_t lock;		/**< protects head and tail */
+	size_t head;				/**< first item not yet taken */
+	size_t tail;				/**< one past the last item */
+} WSPRANGE;
+
+/** Worker thread data **/
+typedef struct s_wspworker {
+	unsigned int id;			/**< worker id (0 is the caller) */
+	WSPOOL *pool;				/**< pool to which worker belongs */
+	pthread_t thread_id;		/**< pthread handle/id */
+	int enabled;				/**< flag indicating thread is running */
+	unsigned int run;			/**< last run completed by this worker */
+	WSPRANGE range;				/**< items owned by this worker */
+	size_t n_steals;			/**< number of successful steals */
+	size_t n_done;				/**< number of items processed in the current run */
+} WSPWORKER;
+
+/** Work-stealing pool control block **/
+struct s_wspool {
+	const char *name;			/**< name given to pool */
+	pthread_mutex_t lock;		/**< protects run and n_busy */
+	pthread_cond_t start;		/**< signals start of a run */
+	pthread_cond_t stop;		/**< signals end of a run */
+	unsigned int run;			/**< current run number */
+	unsigned int n_busy;		/**< workers still processing the current run */
+	int done;					/**< flag to shutdown workers */
+	size_t max_chunk;			/**< largest chunk taken at once */
+	void **item;				/**< items of the current run */
+	WSPCALLFN call;				/**< call of the current run */
+	void *arg;					/**< argument of the current run */
+	unsigned int n_workers;		/**< number of workers (including caller) */
+	WSPWORKER *worker;			/**< worker list */
+};
+
+/* take a chunk from the front of a worker's own range */
+static int wsp_take(WSPOOL *pool, WSPWORKER *w, size_t *first, size_t *last)
+{
+	size_t remain, n;
+	pthread_mutex_lock(&w->range.lock);
+	remain = w->range.tail - w->range.head;
+	if ( remain==0 )
+	{
+		pthread_mutex_unlock(&w->range.lock);
+		return 0;
+	}
+
+	/* guided chunking - big chunks first, single items near the end */
+	n = remain/(2*pool->n_workers);
+	if ( n==0 ) n = 1;
+	if ( pool->max_chunk>0 && n>pool->max_chunk ) n = pool->max_chunk;
+	*first = w->range.head;
+	*last = w->range.head += n;
+	pthread_mutex_unlock(&w->range.lock);
+	return 1;
+}
+
+/* steal the back half of the largest range held by another worker */
+static int wsp_steal(WSPOOL *pool, WSPWORKER *w)
+{
+	for ( ;; )
+	{
+		unsigned int n, best = pool->n_workers;
+		size_t most = 0;
+		WSPWORKER *victim;
+		size_t remain, n_steal;
+
+		/* find the victim with the most work left */
+		for ( n=1 ; n<pool->n_workers ; n++ )
+		{
+			WSPWORKER *v = &pool->worker[(w->id+n)%pool->n_workers];
+			size_t size = v->range.tail - v->range.head; /* unlocked peek, confirmed below */
+			if ( size>most )
+			{
+				most = size;
+				best = v->id;
+			}
+		}
+		if ( best==pool->n_workers )
+			return 0;
+
+		/* take the back half of its range */
+		victim = &pool->worker[best];
+		pthread_mutex_lock(&victim->range.lock);
+		remain = victim->range.tail - victim->range.head;
+		if ( remain==0 )
+		{
+			/* victim finished meanwhile, look again */
+			pthread_mutex_unlock(&victim->range.lock);
+			continue;
+		}
+		n_steal = (remain+1)/2;
+		victim->range.tail -= n_steal;
+		pthread_mutex_lock(&w->range.lock);
+		w->range.head = victim->range.tail;
+		w->range.tail = victim->range.tail + n_steal;
+		pthread_mutex_unlock(&w->range.lock);
+		pthread_mutex_unlock(&victim->range.lock);
+		w->n_steals++;
+		return 1;
+	}
+}
+
+/* process items until no worker has any left */
+static size_t wsp_work(WSPOOL *pool, WSPWORKER *w)
+{
+	size_t count = 0;
+	do {
+		size_t first, last;
+		while ( wsp_take(pool,w,&first,&last) )
+		{
+			count += last-first;
+			for ( ; first<last ; first++ )
+				pool->call(w->id,pool->item[first],pool->arg);
+		}
+	} while ( wsp_steal(pool,w) );
+	return count;
+}
+
+static void *wsp_proc(void *arg)
+{
+	WSPWORKER *w = (WSPWORKER*)arg;
+	WSPOOL *pool = w->pool;
+	for ( ;; )
+	{
+		/* wait for the start of a new run */
+		pthread_mutex_lock(&pool->lock);
+		while ( w->run==pool->run && !pool->done )
+			pthread_cond_wait(&pool->start,&pool->lock);
+		if ( pool->done )
+		{
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+		w->run = pool->run;
+		pthread_mutex_unlock(&pool->lock);
+
+		w->n_done = wsp_work(pool,w);
+
+		/* signal this worker is done */
+		pthread_mutex_lock(&pool->lock);
+		if ( --pool->n_busy==0 )
+			pthread_cond_signal(&pool->stop);
+		pthread_mutex_unlock(&pool->lock);
+	}
+	return NULL;
+}
+
+WSPOOL *wsp_create(const char *name, unsigned int n_workers, size_t max_chunk)
+{
+	unsigned int n;
+	WSPOOL *pool;
+	char buffer[16];
+
+	mti_debug_mode = global_getvar("mti_debug",buffer,sizeof(buffer))?atoi(buffer):0;
+	if ( n_workers<1 )
+		n_workers = 1;
+	pool = (WSPOOL*)malloc(sizeof(WSPOOL));
+	if ( pool==NULL ) 
+		return NULL;
+	memset(pool,0,sizeof(WSPOOL));
+	pool->worker = (WSPWORKER*)malloc(sizeof(WSPWORKER)*n_workers);
+	if ( pool->worker==NULL )
+	{
+		output_error("wsp_create memory allocation failed");
+		/* TROUBLESHOOT
+		   Memory allocation failed while creating the work-stealing
+		   pool used for multithreaded object synchronization.  Free
+		   up memory and try again.
+		 */
+		free(pool);
+		return NULL;
+	}
+	memset(pool->worker,0,sizeof(WSPWORKER)*n_workers);
+	pool->name = name;
+	pool->max_chunk = max_chunk;
+	pool->n_workers = n_workers;
+	pthread_mutex_init(&pool->lock,NULL);
+	pthread_cond_init(&pool->start,NULL);
+	pthread_cond_init(&pool->stop,NULL);
+	for ( n=0 ; n<n_workers ; n++ )
+	{
+		WSPWORKER *w = &pool->worker[n];
+		w->id = n;
+		w->pool = pool;
+		pthread_mutex_init(&w->range.lock,NULL);
+	}
+
+	/* worker 0 is the caller of wsp_run */
+	for ( n=1 ; n<n_workers ; n++ )
+	{
+		WSPWORKER *w = &pool->worker[n];
+		w->enabled = ( pthread_create(&w->thread_id,NULL,wsp_proc,w)==0 );
+		if ( !w->enabled )
+		{
+			output_error("wsp_create unable to start worker %d of pool '%s'", n, name);
+			/* TROUBLESHOOT
+			   A worker thread could not be created for the work-stealing pool.
+			   Reduce the threadcount or free up system resources and try again.
+			 */
+			pool->n_workers = n;
+			break;
+		}
+	}
+	mti_debug(NULL,"work-stealing pool '%s' started with %d workers", name, pool->n_workers);
+	return pool;
+}
+
+size_t wsp_run(WSPOOL *pool, void **item, size_t n_items, WSPCALLFN call, void *arg)
+{
+	unsigned int n;
+	size_t count, n_steals = 0;
+
+	if ( n_items==0 )
+		return 0;
+
+	/* too few items to justify waking the workers */
+	if ( pool->n_workers<2 || n_items<2 )
+	{
+		for ( count=0 ; count<n_items ; count++ )
+			call(0,item[count],arg);
+		return n_items;
+	}
+
+	/* deal out even ranges */
+	pool->item = item;
+	pool->call = call;
+	pool->arg = arg;
+	for ( n=0 ; n<pool->n_workers ; n++ )
+	{
+		WSPWORKER *w = &pool->worker[n];
+		w->range.head = n_items*n/pool->n_workers;
+		w->range.tail = n_items*(n+1)/pool->n_workers;
+		w->n_steals = 0;
+	}
+
+	/* start the helpers */
+	pthread_mutex_lock(&pool->lock);
+	pool->n_busy = pool->n_workers-1;
+	pool->run++;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+
+	/* caller works too */
+	pool->worker[0].n_done = wsp_work(pool,&pool->worker[0]);
+
+	/* wait for the helpers to finish */
+	pthread_mutex_lock(&pool->lock);
+	while ( pool->n_busy>0 )
+		pthread_cond_wait(&pool->stop,&pool->lock);
+	pthread_mutex_unlock(&pool->lock);
+
+	for ( n=0, count=0 ; n<pool->n_workers ; n++ )
+	{
+		n_steals += pool->worker[n].n_steals;
+		count += pool->worker[n].n_done;
+	}
+	mti_debug(NULL,"pool '%s' processed %d of %d items with %d steals", pool->name, (int)count, (int)n_items, (int)n_steals);
+	return count;
+}
+
+unsigned int wsp_count(WSPOOL *pool)
+{
+	return pool ? pool->n_workers : 1;
+}
+
+void wsp_destroy(WSPOOL *pool)
+{
+	unsigned int n;
+	if ( pool==NULL )
+		return;
+	pthread_mutex_lock(&pool->lock);
+	pool->done = 1;
+	pthread_cond_broadcast(&pool->start);
+	pthread_mutex_unlock(&pool->lock);
+	for ( n=1 ; n<pool->n_workers ; n++ )
+	{
+		if ( pool->worker[n].enabled )
+			pthread_join(pool->worker[n].thread_id,NULL);
+	}
+	for ( n=0 ; n<pool->n_workers ; n++ )
+		pthread_mutex_destroy(&pool->worker[n].range.lock);
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->start);
+	pthread_cond_destroy(&pool->stop);
+	free(pool->worker);
+	free(pool);
+}
+
+/******************************************************************
+ * WORK-STEALING POOL TEST
+ ******************************************************************/
+
+// should include output.h and exec.h, but this causes a conflict with int64
+int output_test(const char *format,...);
+EXITCODE exec_setexitcode(EXITCODE);
+
+typedef struct s_wsptest {
+	unsigned int *hits;			/**< number of times each item ran */
+	size_t *sum;				/**< sum of the items seen by each worker */
+} WSPTEST;
+
+static void wsp_test_call(unsigned int thread, void *item, void *arg)
+{
+	WSPTEST *test = (WSPTEST*)arg;
+	size_t n = (size_t)item;
+	test->hits[n]++;
+	test->sum[thread] += n;
+	/* make some items much more expensive so the workers steal */
+	if ( n%97==0 )
+	{
+		volatile unsigned int spin;
+		for ( spin=0 ; spin<20000 ; spin++ );
+	}
+}
+
+/** Test the work-stealing pool
+	Each run adds up the index of every item over all the workers and checks
+	the total, the count returned, and that every item ran exactly once.
+	@returns the number of failed runs
+ **/
+int wsp_test(void)
+{
+	static size_t sizes[] = {0, 1, 2, 3, 7, 1000, 100000};
+	static size_t chunks[] = {0, 1, 64};
+	unsigned int n_workers = global_threadcount>1 ? global_threadcount : 4;
+	size_t max_items = sizes[sizeof(sizes)/sizeof(sizes[0])-1];
+	void **item = (void**)malloc(sizeof(void*)*max_items);
+	unsigned int *hits = (unsigned int*)malloc(sizeof(unsigned int)*max_items);
+	size_t *sum = (size_t*)malloc(sizeof(size_t)*n_workers);
+	WSPTEST test = {hits,sum};
+	unsigned int c, i, failed = 0, succeeded = 0;
+	size_t n;
+
+	output_test("BEGIN: work-stealing pool test with %d workers", n_workers);
+	if ( item==NULL || hits==NULL || sum==NULL )
+	{
+		output_test("FAILED: memory allocation failed");
+		free(item);
+		free(hits);
+		free(sum);
+		exec_setexitcode(XC_TSTERR);
+		return 1;
+	}
+	for ( n=0 ; n<max_items ; n++ )
+		item[n] = (void*)n;
+	for ( c=0 ; c<sizeof(chunks)/sizeof(chunks[0]) ; c++ )
+	{
+		WSPOOL *pool = wsp_create("wsp_test",n_workers,chunks[c]);
+		if ( pool==NULL )
+		{
+			output_test("FAILED: unable to create pool with %d workers", n_workers);
+			failed++;
+			continue;
+		}
+		for ( i=0 ; i<sizeof(sizes)/sizeof(sizes[0]) ; i++ )
+		{
+			size_t n_items = sizes[i], count, total = 0, missed = 0, repeated = 0;
+			memset(hits,0,sizeof(unsigned int)*n_items);
+			memset(sum,0,sizeof(size_t)*n_workers);
+			count = wsp_run(pool,item,n_items,wsp_test_call,&test);
+			for ( n=0 ; n<wsp_count(pool) ; n++ )
+				total += sum[n];
+			for ( n=0 ; n<n_items ; n++ )
+			{
+				if ( hits[n]==0 ) missed++;
+				else if ( hits[n]>1 ) repeated++;
+			}
+			if ( count!=n_items || total!=n_items*(n_items-1)/2 || missed>0 || repeated>0 )
+			{
+				output_test("FAILED: %d items, max chunk %d: count=%d, total=%d, %d missed, %d repeated",
+					(int)n_items, (int)chunks[c], (int)count, (int)total, (int)missed, (int)repeated);
+				failed++;
+			}
+			else
+				succeeded++;
+		}
+		wsp_destroy(pool);
+	}
+	free(item);
+	free(hits);
+	free(sum);
+	output_test("END: work-stealing pool test, %d succeeded, %d failed", succeeded, failed);
+	if ( failed>0 )
+		exec_setexitcode(XC_TSTERR);
+	return failed;
+}
@@ -158,6 +158,64 @@ int mti_run(MTIDATA result,   /**< result of iterator */
             MTIDATA input);   /**< data to send to iterator call function */
 
 int processor_count(void);
+
+/** @} **/
+
+/** @addtogroup wsp Work-stealing pool
+    @ingroup core
+
+A work-stealing pool (WSP) is a persistent set of worker threads that
+process an array of items in parallel.  Unlike an MTI, the pool is not
+bound to a particular list of items: each call to #wsp_run() hands the
+pool a new array, which is split evenly into per-worker ranges.  Each
+worker takes chunks from the front of its own range, with the chunk
+size shrinking as the range empties.  When a worker runs out of items
+it steals the back half of the largest remaining range held by another
+worker, so a few expensive items no longer stall the whole batch.
+
+The caller participates as worker 0, so a pool of \p n workers creates
+\p n-1 helper threads.  #wsp_run() returns only when every item has
+been processed, which makes it suitable for barrier-separated passes
+such as the rank lists processed by exec_start().
+
+@{**/
+
+typedef struct s_wspool WSPOOL;
+
+/** Work-stealing pool call function prototype
+    @param thread the worker id (0 to #wsp_count()-1)
+    @param item the item to process
+    @param arg the argument given to #wsp_run()
+ **/
+typedef void (*WSPCALLFN)(unsigned int thread, void *item, void *arg);
+
+/** Create a work-stealing pool
+    @returns a pointer to the pool, or NULL if the pool could not be created
+ **/
+WSPOOL *wsp_create(const char *name, /**< name of the pool (used by debug output) */
+                   unsigned int n_workers, /**< number of workers (including caller) */
+                   size_t max_chunk); /**< largest number of items taken at once (0 for no limit) */
+
+/** Run the pool on an array of items
+    @returns the number of items processed
+ **/
+size_t wsp_run(WSPOOL *pool, /**< pointer returned by wsp_create */
+               void **item, /**< array of items */
+               size_t n_items, /**< number of items */
+               WSPCALLFN call, /**< function called for each item */
+               void *arg); /**< argument passed to each call */
+
+/** Get the number of workers in a pool (including caller) **/
+unsigned int wsp_count(WSPOOL *pool);
+
+/** Stop the workers and free the pool **/
+void wsp_destroy(WSPOOL *pool);
+
+/** Test the work-stealing pool (see \p --test \p wsp)
+    @returns the number of failed runs
+ **/
+int wsp_test(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,373 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file timeline.c
+	@addtogroup timeline
+	@ingroup core
+
+	Per-thread event buffers of the profiler timeline.  See timeline.h for
+	what is recorded.
+ @{
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <pthread.h>
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include "platform.h"
+#include "globals.h"
+#include "output.h"
+#include "class.h"
+#include "timeline.h"
+
+typedef struct s_timelineevent {
+	int64 start, end; /**< monotonic clock in ns */
+	const char *category;
+	const char *name;
+	OBJECT *obj; /**< the object called, for object events */
+	int call; /**< the OBJECTPROFILEITEM of class and object events, -1 otherwise */
+	int64 arg; /**< rank index, object count, or a value given by the caller */
+} TIMELINEEVENT;
+
+/** The buffer of one thread.  Only the owning thread appends to it, and
+	only timeline_flush() and timeline_save() read it, while the other
+	threads are idle. */
+typedef struct s_timelinebuffer {
+	unsigned int tid; /**< order in which threads first recorded an event */
+	TIMELINEEVENT *event;
+	unsigned int n, max;
+	unsigned int dropped; /**< events lost when the buffer was full */
+	TIMELINEEVENT run; /**< the open run of calls to objects of one class */
+	struct s_timelinebuffer *next;
+} TIMELINEBUFFER;
+
+int timeline_active = 0;
+static pthread_mutex_t timeline_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_key_t timeline_key;
+static int timeline_keyed = 0;
+static TIMELINEBUFFER *timeline_buffers = NULL;
+static unsigned int timeline_threads = 0;
+static int64 timeline_epoch = 0;
+
+static const char *call_name[_OPI_NUMITEMS] = {"presync","sync","postsync","init","heartbeat","precommit","commit","finalize"};
+
+/** Read the monotonic clock
+	@return nanoseconds since an arbitrary time, or 0 when the timeline is not active
+ **/
+int64 timeline_now(void)
+{
+#ifdef WIN32
+	static LARGE_INTEGER freq = {0};
+	LARGE_INTEGER count;
+	if ( !timeline_active )
+		return 0;
+	if ( freq.QuadPart==0 )
+		QueryPerformanceFrequency(&freq);
+	QueryPerformanceCounter(&count);
+	return (int64)(count.QuadPart/freq.QuadPart*1000000000 + count.QuadPart%freq.QuadPart*1000000000/freq.QuadPart);
+#else
+	struct timespec ts;
+	if ( !timeline_active )
+		return 0;
+	clock_gettime(CLOCK_MONOTONIC,&ts);
+	return (int64)ts.tv_sec*1000000000 + ts.tv_nsec;
+#endif
+}
+
+/* the calling thread's buffer, created on first use */
+static TIMELINEBUFFER *get_buffer(void)
+{
+	TIMELINEBUFFER *buffer = (TIMELINEBUFFER*)pthread_getspecific(timeline_key);
+	if ( buffer!=NULL )
+		return buffer;
+	buffer = (TIMELINEBUFFER*)malloc(sizeof(TIMELINEBUFFER));
+	if ( buffer==NULL )
+		return NULL;
+	memset(buffer,0,sizeof(TIMELINEBUFFER));
+	pthread_mutex_lock(&timeline_lock);
+	buffer->tid = timeline_threads++;
+	buffer->next = timeline_buffers;
+	timeline_buffers = buffer;
+	pthread_mutex_unlock(&timeline_lock);
+	pthread_setspecific(timeline_key,buffer);
+	return buffer;
+}
+
+static void append(TIMELINEBUFFER *buffer, TIMELINEEVENT *event)
+{
+	if ( buffer->n==buffer->max )
+	{
+		unsigned int max = buffer->max==0 ? 4096 : buffer->max*2;
+		TIMELINEEVENT *grown = max>TIMELINE_MAXEVENTS ? NULL : (TIMELINEEVENT*)realloc(buffer->event,sizeof(TIMELINEEVENT)*max);
+		if ( grown==NULL )
+		{
+			buffer->dropped++;
+			return;
+		}
+		buffer->event = grown;
+		buffer->max = max;
+	}
+	buffer->event[buffer->n++] = *event;
+}
+
+/* close the open run of class calls of a buffer */
+static void close_run(TIMELINEBUFFER *buffer)
+{
+	if ( buffer->run.obj!=NULL )
+	{
+		buffer->run.obj = NULL;
+		append(buffer,&buffer->run);
+	}
+}
+
+/* test whether an object is in the profile_trace_objects list */
+static int is_selected(OBJECT *obj)
+{
+	char list[1024], *item, *last = NULL;
+	strncpy(list,global_profile_trace_objects,sizeof(list)-1);
+	list[sizeof(list)-1] = '\0';
+	for ( item=strtok_s(list,", \t",&last) ; item!=NULL ; item=strtok_s(NULL,", \t",&last) )
+	{
+		if ( strcmp(item,"*")==0 || strcmp(item,obj->oclass->name)==0 || (obj->name!=NULL && strcmp(item,obj->name)==0) )
+			return 1;
+	}
+	return 0;
+}
+
+/** Start recording if \p profile_trace names a file
+	@return 1 if recording, 0 otherwise
+ **/
+int timeline_init(void)
+{
+	OBJECT *obj;
+	unsigned int n = 0;
+	if ( global_profile_trace[0]=='\0' )
+		return 0;
+	if ( !timeline_keyed )
+	{
+		if ( pthread_key_create(&timeline_key,NULL)!=0 )
+		{
+			output_error("timeline_init(): unable to create the thread key for the profiler timeline");
+			/* TROUBLESHOOT
+			   The system refused to create the thread-specific storage used by the profiler timeline.
+			   This is usually caused by a shortage of system resources.  Close other programs and try again.
+			 */
+			return 0;
+		}
+		timeline_keyed = 1;
+	}
+	for ( obj=object_get_first() ; obj!=NULL ; obj=object_get_next(obj) )
+	{
+		if ( global_profile_trace_objects[0]!='\0' && is_selected(obj) )
+		{
+			obj->flags |= OF_TRACE;
+			n++;
+		}
+		else
+			obj->flags &= ~OF_TRACE;
+	}
+	timeline_active = 1;
+	timeline_epoch = timeline_now();
+	get_buffer(); /* the main thread is thread 0 */
+	output_verbose("profiler timeline started, tracing %u object%s individually", n, n==1?"":"s");
+	return 1;
+}
+
+/** Record an event that started at \p start and ends now on the calling thread.
+	\p category and \p name must remain valid until timeline_save() is called.
+ **/
+void timeline_event(const char *category, const char *name, int64 start, int64 arg)
+{
+	TIMELINEBUFFER *buffer;
+	TIMELINEEVENT event;
+	if ( !timeline_active || start==0 || (buffer=get_buffer())==NULL )
+		return;
+	event.start = start;
+	event.end = timeline_now();
+	event.category = category;
+	event.name = name;
+	event.obj = NULL;
+	event.call = -1;
+	event.arg = arg;
+	append(buffer,&event);
+}
+
+/** Record a call to an object that started at \p start and ends now.
+	Consecutive calls of the same kind to objects of the same class are
+	merged into one class event.
+ **/
+void timeline_object(OBJECT *obj, OBJECTPROFILEITEM call, int64 start)
+{
+	TIMELINEBUFFER *buffer;
+	int64 end;
+	if ( !timeline_active || start==0 || (buffer=get_buffer())==NULL )
+		return;
+	end = timeline_now();
+	if ( buffer->run.obj!=NULL && buffer->run.obj->oclass==obj->oclass && buffer->run.call==(int)call )
+	{
+		buffer->run.end = end;
+		buffer->run.arg++;
+	}
+	else
+	{
+		close_run(buffer);
+		buffer->run.start = start;
+		buffer->run.end = end;
+		buffer->run.category = "class";
+		buffer->run.name = obj->oclass->name;
+		buffer->run.obj = obj;
+		buffer->run.call = (int)call;
+		buffer->run.arg = 1;
+	}
+	if ( obj->flags&OF_TRACE )
+	{
+		TIMELINEEVENT event;
+		event.start = start;
+		event.end = end;
+		event.category = "object";
+		event.name = NULL;
+		event.obj = obj;
+		event.call = (int)call;
+		event.arg = obj->id;
+		append(buffer,&event);
+	}
+}
+
+/** Close the runs of class calls of all threads.  Must be called by a
+	single thread while no other thread is calling objects, e.g., after
+	each rank.
+ **/
+void timeline_flush(void)
+{
+	TIMELINEBUFFER *buffer;
+	if ( !timeline_active )
+		return;
+	for ( buffer=timeline_buffers ; buffer!=NULL ; buffer=buffer->next )
+		close_run(buffer);
+}
+
+/* write a JSON string, escaping what needs it */
+static void write_string(FILE *fp, const char *s)
+{
+	fputc('"',fp);
+	for ( ; *s!='\0' ; s++ )
+	{
+		if ( *s=='"' || *s=='\\' )
+			fprintf(fp,"\\%c",*s);
+		else if ( (unsigned char)*s<0x20 )
+			fprintf(fp,"\\u%04x",(unsigned char)*s);
+		else
+			fputc(*s,fp);
+	}
+	fputc('"',fp);
+}
+
+static void write_event(FILE *fp, TIMELINEBUFFER *buffer, TIMELINEEVENT *event)
+{
+	char name[1024];
+	int64 start = event->start - timeline_epoch;
+	int64 duration = event->end - event->start;
+	if ( event->obj!=NULL && event->name==NULL )
+		object_name(event->obj,name,sizeof(name));
+	else
+		strncpy(name,event->name?event->name:"",sizeof(name)-1), name[sizeof(name)-1] = '\0';
+	fprintf(fp,",\n{\"name\":");
+	write_string(fp,name);
+	fprintf(fp,",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%"FMT_INT64"d.%03d,\"dur\":%"FMT_INT64"d.%03d,\"args\":{",
+		event->category, buffer->tid, start/1000, (int)(start%1000), duration/1000, (int)(duration%1000));
+	if ( strcmp(event->category,"class")==0 )
+		fprintf(fp,"\"call\":\"%s\",\"objects\":%"FMT_INT64"d}}", call_name[event->call], event->arg);
+	else if ( strcmp(event->category,"object")==0 )
+		fprintf(fp,"\"call\":\"%s\",\"class\":\"%s\",\"id\":%"FMT_INT64"d}}", call_name[event->call], event->obj->oclass->name, event->arg);
+	else if ( strcmp(event->category,"rank")==0 )
+		fprintf(fp,"\"rank\":%"FMT_INT64"d}}", event->arg);
+	else
+		fprintf(fp,"\"value\":%"FMT_INT64"d}}", event->arg);
+}
+
+/** Stop recording, write the events to the \p profile_trace file and
+	release the buffers
+	@return 1 on success, 0 on failure
+ **/
+int timeline_save(void)
+{
+	TIMELINEBUFFER *buffer;
+	FILE *fp;
+	unsigned int i, total = 0, dropped = 0;
+	int ok = 1;
+
+	if ( !timeline_active )
+		return 1;
+	timeline_flush();
+	timeline_active = 0;
+
+	fp = fopen(global_profile_trace,"w");
+	if ( fp==NULL )
+	{
+		output_error("timeline_save(): unable to write profiler timeline '%s': %s", global_profile_trace, strerror(errno));
+		/* TROUBLESHOOT
+		   The profiler timeline could not be written to the file named by the profile_trace global.
+		   Check that the folder exists and that you have permission to write to it, and try again.
+		 */
+		ok = 0;
+	}
+	else
+	{
+		fprintf(fp,"{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+		fprintf(fp,"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"gridlabd\"}}");
+		for ( buffer=timeline_buffers ; buffer!=NULL ; buffer=buffer->next )
+		{
+			if ( buffer->tid==0 )
+				fprintf(fp,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"main\"}}");
+			else
+				fprintf(fp,",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"worker %u\"}}", buffer->tid, buffer->tid);
+			fprintf(fp,",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}", buffer->tid, buffer->tid);
+			for ( i=0 ; i<buffer->n ; i++ )
+				write_event(fp,buffer,buffer->event+i);
+			total += buffer->n;
+			dropped += buffer->dropped;
+		}
+		fprintf(fp,"\n]}\n");
+		if ( ferror(fp) )
+		{
+			output_error("timeline_save(): error writing profiler timeline '%s': %s", global_profile_trace, strerror(errno));
+			/* TROUBLESHOOT
+			   The profiler timeline could not be completely written to the file named by the profile_trace global.
+			   Check that there is enough space on the disk and try again.
+			 */
+			ok = 0;
+		}
+		fclose(fp);
+		if ( ok )
+			output_verbose("profiler timeline of %u events on %u threads written to '%s'", total, timeline_threads, global_profile_trace);
+		if ( dropped>0 )
+			output_warning("profiler timeline dropped %u events because a thread recorded more than %d", dropped, TIMELINE_MAXEVENTS);
+			/* TROUBLESHOOT
+			   A thread recorded more events than the profiler timeline keeps, so the latest events are missing from the trace.
+			   Shorten the simulation or reduce the number of objects listed in profile_trace_objects and try again.
+			 */
+	}
+
+	/* buffers are not reused by a later run */
+	while ( (buffer=timeline_buffers)!=NULL )
+	{
+		timeline_buffers = buffer->next;
+		free(buffer->event);
+		free(buffer);
+	}
+	timeline_threads = 0;
+	if ( timeline_keyed )
+	{
+		pthread_key_delete(timeline_key);
+		timeline_keyed = 0;
+	}
+	return ok;
+}
+
+/**@}**/
@@ -0,0 +1,58 @@
+/** $Id$
+	Copyright (C) 2008 Battelle Memorial Institute
+	@file timeline.h
+	@addtogroup timeline Profiler timeline
+	@ingroup core
+
+	The class profiler accumulates \p clock() deltas per class, which do not
+	tell which thread did what or when.  When the \p profile_trace global
+	names a file, every thread records timed events with a monotonic
+	nanosecond clock while the simulation runs, and the events are written
+	to that file as a trace event JSON document that Perfetto
+	(ui.perfetto.dev) or \p chrome://tracing can display.
+
+	The events recorded are
+	- each pass (\p pass) and each rank of a pass (\p rank),
+	- runs of consecutive calls a thread makes to objects of the same class
+	  (\p class), with the number of objects called,
+	- each call to the objects selected by \p profile_trace_objects
+	  (\p object), given as a comma separated list of object names or
+	  class names, or \p * for all objects,
+	- core phases such as \p syncall_internals, \p commit_all and
+	  \p delta_update (\p core), and
+	- whatever modules record with gl_timeline_event(), like the
+	  powerflow solver (\p module).
+
+	Each thread appends to its own buffer, which needs no lock.  When
+	\p profile_trace is empty nothing is recorded and each instrumented
+	call costs one test of \p timeline_active.
+ @{
+ **/
+
+#ifndef _TIMELINE_H
+#define _TIMELINE_H
+
+#include "object.h"
+
+#define TIMELINE_MAXEVENTS (1<<20) /**< most events kept for one thread */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern int timeline_active; /**< non-zero while events are being recorded */
+
+int timeline_init(void);
+int64 timeline_now(void);
+void timeline_event(const char *category, const char *name, int64 start, int64 arg);
+void timeline_object(OBJECT *obj, OBJECTPROFILEITEM call, int64 start);
+void timeline_flush(void);
+int timeline_save(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
+
+/**@}**/
@@ -36,6 +36,8 @@
 #include "globals.h"
 #include "lock.h"
 
+#include <pthread.h>
+
 #ifndef WIN32
 	#define _tzname tzname
 	#define _timezone timezone
@@ -71,6 +73,51 @@ static char current_tzname[64], tzstd[32], tzdst[32];
 #define LOCALTIME(T) ((T)-tzoffset+(isdst((T))?3600:0))
 #define GMTIME(T) ((T)+tzoffset-(isdst((T)+tzoffset)?3600:0))
 
+/** Per-thread record of the last local time conversions.  Between two DST
+	events isdst() cannot change, and within one local day only the time of
+	day changes, so conversions of nearby timestamps are served from the
+	spans recorded here with a few integer operations.
+ **/
+typedef struct s_tscache {
+	unsigned int version; /**< the timezone the spans were computed for */
+	TIMESTAMP dst_lo, dst_hi; /**< the span over which isdst() is constant */
+	int dst; /**< the result of isdst() over the span */
+	TIMESTAMP day_lo, day_hi; /**< the span over which the local date is constant */
+	TIMESTAMP midnight; /**< the GMT timestamp of local midnight of that date */
+	DATETIME day; /**< the local date, time zone and offset over the span */
+} TSCACHE;
+static volatile unsigned int tzversion = 1; /* changed whenever the timezone changes */
+static int tscache_enabled = 1;
+static pthread_key_t tscache_key;
+static pthread_once_t tscache_once = PTHREAD_ONCE_INIT;
+static void tscache_init(void)
+{
+	pthread_key_create(&tscache_key,free);
+}
+static TSCACHE *tscache_get(void)
+{
+	TSCACHE *cache;
+	if ( !tscache_enabled )
+		return NULL;
+	pthread_once(&tscache_once,tscache_init);
+	cache = (TSCACHE*)pthread_getspecific(tscache_key);
+	if ( cache==NULL )
+	{
+		cache = (TSCACHE*)malloc(sizeof(TSCACHE));
+		if ( cache==NULL )
+			return NULL;
+		memset(cache,0,sizeof(TSCACHE));
+		pthread_setspecific(tscache_key,cache);
+	}
+	if ( cache->version!=tzversion )
+	{
+		cache->version = tzversion;
+		cache->dst_lo = cache->dst_hi = 0;
+		cache->day_lo = cache->day_hi = 0;
+	}
+	return cache;
+}
+
 /** Read the current timezone specification
 	@return a pointer to the first character in the timezone spec string
  **/
@@ -125,12 +172,10 @@ int timestamp_year(TIMESTAMP ts, TIMESTAMP *remainder)
 	return year + YEAR0;
 }
 
-/** Determine whether a GMT timestamp is under DST rules
- **/
-int isdst(TIMESTAMP t)
+/* apply the DST rules of a year to a GMT timestamp */
+static int isdst_year(TIMESTAMP t, int year)
 {
 	int DSTstart_year, DSTend_year;
-	int year = timestamp_year(t + tzoffset, NULL) - YEAR0;
 
 	//Preliminary check to make sure something exists
 	if (dststart[year]>=0)	//If it's -1, no sense going forth
@@ -185,22 +230,84 @@ int isdst(TIMESTAMP t)
 	}
 }
 
+/* narrow the span [*lo,*hi) around t to exclude the event at e */
+static void tscache_clip(TIMESTAMP t, TIMESTAMP e, TIMESTAMP *lo, TIMESTAMP *hi)
+{
+	if ( e>*lo && e<=t )
+		*lo = e;
+	else if ( e>t && e<*hi )
+		*hi = e;
+}
+
+/** Determine whether a GMT timestamp is under DST rules
+ **/
+int isdst(TIMESTAMP t)
+{
+	TSCACHE *cache = tscache_get();
+	int year, dst;
+	TIMESTAMP lo, hi;
+
+	if ( cache!=NULL && t>=cache->dst_lo && t<cache->dst_hi )
+		return cache->dst;
+
+	year = timestamp_year(t + tzoffset, NULL) - YEAR0;
+	dst = isdst_year(t,year);
+	if ( cache==NULL )
+		return dst;
+
+	/* the result only changes at the year boundaries and at the events isdst_year() compares against */
+	lo = tszero[year] - tzoffset;
+	hi = year+1<sizeof(tszero)/sizeof(tszero[0]) ? tszero[year+1] - tzoffset : TS_MAX;
+	tscache_clip(t,dststart[year],&lo,&hi);
+	tscache_clip(t,dstend[year],&lo,&hi);
+	if ( year>0 )
+	{
+		tscache_clip(t,dststart[year-1],&lo,&hi);
+		tscache_clip(t,dstend[year-1],&lo,&hi);
+		tscache_clip(t,dstend[year-1]+1,&lo,&hi);
+	}
+	cache->dst_lo = lo;
+	cache->dst_hi = hi;
+	cache->dst = dst;
+	return dst;
+}
+
+/* fill the time of day of dt from the cached local date, if ts falls in it */
+static int tscache_datetime(TIMESTAMP ts, DATETIME *dt)
+{
+	TSCACHE *cache = tscache_get();
+	TIMESTAMP rem;
+	if ( cache==NULL || ts<cache->day_lo || ts>=cache->day_hi )
+		return 0;
+	memcpy(dt,&cache->day,sizeof(DATETIME));
+	dt->timestamp = ts;
+	rem = ts - cache->midnight;
+	dt->hour = (unsigned short)(rem / HOUR);
+	rem %= HOUR;
+	dt->minute = (unsigned short)(rem / MINUTE);
+	rem %= MINUTE;
+	dt->second = (unsigned short)rem / TS_SECOND;
+	return 1;
+}
+
+/* record the local date of ts, given the ticks elapsed since its local midnight */
+static void tscache_store(TIMESTAMP ts, DATETIME *dt, TIMESTAMP dayrem)
+{
+	TSCACHE *cache = tscache_get();
+	if ( cache==NULL || ts<cache->dst_lo || ts>=cache->dst_hi )
+		return;
+	memcpy(&cache->day,dt,sizeof(DATETIME));
+	cache->day.nanosecond = 0;
+	cache->midnight = ts - dayrem;
+	cache->day_lo = cache->midnight > cache->dst_lo ? cache->midnight : cache->dst_lo;
+	cache->day_hi = cache->midnight + DAY < cache->dst_hi ? cache->midnight + DAY : cache->dst_hi;
+}
+
 /** Calculate the current TZ offset in seconds
  **/
 int local_tzoffset(TIMESTAMP t)
 {
-#ifdef USE_TS_CACHE
-	static old_t = 0;
-	static old_tzoffset = 0;
-	if (old_t==0 || old_t!=t)
-	{
-		old_tzoffset = tzoffset + isdst(t)?3600:0;
-		old_t = t;
-	}
-	return old_tzoffset;
-#else
 	return (int)(tzoffset + (isdst(t)?3600:0));
-#endif
 }
 
 /** Converts a GMT timestamp to local datetime struct
@@ -211,14 +318,9 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 
 	int64 n;
 	TIMESTAMP rem = 0;
-	TIMESTAMP local;
+	TIMESTAMP local, dayrem;
 	int tsyear;
 
-#ifdef USE_TS_CACHE
-	/* allow caching */
-	static TIMESTAMP old_ts =0;
-	static DATETIME old_dt;
-#endif
 
 	if( ts == TS_NEVER || ts==TS_ZERO )
 		return 0;
@@ -228,13 +330,10 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 		output_error("local_datetime(ts=%lli,...): invalid local_datetime request",ts);
 		return 0;
 	}
-#ifdef USE_TS_CACHE
-	/* check cache */
-	if (old_ts == ts && old_ts!=0)
-		memcpy(dt,&old_dt,sizeof(DATETIME));
-	else
-		old_ts = 0;
-#endif
+
+	/* same local date as the last conversion */
+	if ( tscache_datetime(ts,dt) )
+		return 1;
 
 	local = LOCALTIME(ts);
 	tsyear = timestamp_year(local, &rem);
@@ -302,6 +401,7 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 	/* compute day */
 	dt->day = (unsigned short)(rem / DAY + 1);
 	rem %= DAY;
+	dayrem = rem;
 
 	/* compute hour */
 	dt->hour = (unsigned short)(rem / HOUR);
@@ -324,11 +424,7 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt)
 	/* timezone offset in seconds */
 	dt->tzoffset = (int)(tzoffset - (isdst(dt->timestamp)?3600:0));
 
-#ifdef USE_TS_CACHE
-	/* cache result */
-	old_ts = ts;
-	memcpy(&old_dt,dt,sizeof(old_dt));
-#endif
+	tscache_store(ts,dt,dayrem);
 	return 1;
 }
 
@@ -342,14 +438,9 @@ int local_datetime_delta(double tsdbl, DATETIME *dt)
 	int64 n;
 	TIMESTAMP ts;
 	TIMESTAMP rem = 0;
-	TIMESTAMP local;
+	TIMESTAMP local, dayrem;
 	int tsyear;
 
-#ifdef USE_TS_CACHE
-	/* allow caching */
-	static TIMESTAMP old_ts =0;
-	static DATETIME old_dt;
-#endif
 
 	/*Get the cast version*/
 	ts = (TIMESTAMP)tsdbl;
@@ -362,13 +453,13 @@ int local_datetime_delta(double tsdbl, DATETIME *dt)
 		output_error("local_datetime_delta(ts=%lli,...): invalid local_datetime request",ts);
 		return 0;
 	}
-#ifdef USE_TS_CACHE
-	/* check cache */
-	if (old_ts == ts && old_ts!=0)
-		memcpy(dt,&old_dt,sizeof(DATETIME));
-	else
-		old_ts = 0;
-#endif
+
+	/* same local date as the last conversion */
+	if ( tscache_datetime(ts,dt) )
+	{
+		dt->nanosecond = (unsigned int)((tsdbl - (double)(ts))*1e9 + 0.5);
+		return 1;
+	}
 
 	local = LOCALTIME(ts);
 	tsyear = timestamp_year(local, &rem);
@@ -436,6 +527,7 @@ int local_datetime_delta(double tsdbl, DATETIME *dt)
 	/* compute day */
 	dt->day = (unsigned short)(rem / DAY + 1);
 	rem %= DAY;
+	dayrem = rem;
 
 	/* compute hour */
 	dt->hour = (unsigned short)(rem / HOUR);
@@ -458,11 +550,7 @@ int local_datetime_delta(double tsdbl, DATETIME *dt)
 	/* timezone offset in seconds */
 	dt->tzoffset = (int)(tzoffset - (isdst(dt->timestamp)?3600:0));
 
-#ifdef USE_TS_CACHE
-	/* cache result */
-	old_ts = ts;
-	memcpy(&old_dt,dt,sizeof(old_dt));
-#endif
+	tscache_store(ts,dt,dayrem);
 	return 1;
 }
 
@@ -860,6 +948,7 @@ void load_tzspecs(char *tz){
 
 	found = 0;
 	tzvalid = 0;
+	tzversion++;
 	pTzname = tz_name(tz);
 
 	if(pTzname == 0){
@@ -968,6 +1057,7 @@ void load_tzspecs(char *tz){
 
 	fclose(fp);
 	tzvalid = 1;
+	tzversion++;
 }
 
 /** Establish the default timezone for time conversion.
@@ -1458,6 +1548,121 @@ int timestamp_test(void)
 	return failed;
 }
 
+/* compare two local date conversions field by field */
+static int datetime_match(DATETIME *a, DATETIME *b)
+{
+	return a->year==b->year && a->month==b->month && a->day==b->day
+		&& a->hour==b->hour && a->minute==b->minute && a->second==b->second
+		&& a->nanosecond==b->nanosecond && a->is_dst==b->is_dst
+		&& strcmp(a->tz,b->tz)==0 && a->weekday==b->weekday
+		&& a->yearday==b->yearday && a->timestamp==b->timestamp
+		&& a->tzoffset==b->tzoffset;
+}
+
+/** Test the local time conversion cache against uncached conversions
+	and measure the conversion rate with and without it
+	@return the number of tests that failed
+ **/
+int timestamp_cache_test(void)
+{
+#define NCONVERSIONS 1000000
+	static TIMESTAMP steps[] = {SECOND, MINUTE, HOUR, DAY};
+	TIMESTAMP *event[]={dststart,dstend};
+	int enabled = tscache_enabled;
+	int year, test, i, failed=0, succeeded=0;
+	TIMESTAMP ts;
+	char buf1[64], buf2[64];
+	unsigned int seed = 1;
+
+	output_test("BEGIN: local time cache test for TZ=%s...", current_tzname);
+	for (year=0; year<NYEARS; year++)
+	{
+		for (test=0; test<2; test++)
+		{
+			if ((event[test])[year]<0)
+				continue;
+			/* walk across each DST event one way then the other */
+			for (i=0; i<2; i++)
+			{
+				for (ts=(event[test])[year]-2*HOUR; ts<(event[test])[year]+2*HOUR; ts+=MINUTE-SECOND)
+				{
+					DATETIME cached, uncached;
+					TIMESTAMP t = i==0 ? ts : 2*(event[test])[year]-ts;
+					int ok1, ok2, off1, off2;
+					tscache_enabled = 1;
+					ok1 = local_datetime(t,&cached);
+					off1 = local_tzoffset(t);
+					tscache_enabled = 0;
+					ok2 = local_datetime(t,&uncached);
+					off2 = local_tzoffset(t);
+					if (ok1!=ok2 || off1!=off2 || (ok1 && !datetime_match(&cached,&uncached)))
+					{
+						output_test("FAILED: cached conversion of ts=%"FMT_INT64"d gave %s (offset %d) instead of %s (offset %d)", t,
+							ok1&&strdatetime(&cached,buf1,sizeof(buf1))?buf1:"(invalid)", off1,
+							ok2&&strdatetime(&uncached,buf2,sizeof(buf2))?buf2:"(invalid)", off2);
+						failed++;
+					}
+					else
+						succeeded++;
+				}
+			}
+		}
+	}
+	for (i=0; i<NCONVERSIONS/10; i++)
+	{
+		DATETIME cached, uncached;
+		int ok1, ok2;
+		/* jump around, then take a few small steps */
+		seed = seed*1103515245 + 12345;
+		ts = (i%4==0) ? DAY+(TIMESTAMP)(seed%(unsigned int)(DAY*365*NYEARS/SECOND))*SECOND : ts + (seed>>16)%(2*HOUR);
+		tscache_enabled = 1;
+		ok1 = local_datetime(ts,&cached);
+		tscache_enabled = 0;
+		ok2 = local_datetime(ts,&uncached);
+		if (ok1!=ok2 || (ok1 && !datetime_match(&cached,&uncached)))
+		{
+			output_test("FAILED: cached conversion of ts=%"FMT_INT64"d gave %s instead of %s", ts,
+				ok1&&strdatetime(&cached,buf1,sizeof(buf1))?buf1:"(invalid)",
+				ok2&&strdatetime(&uncached,buf2,sizeof(buf2))?buf2:"(invalid)");
+			failed++;
+		}
+		else
+			succeeded++;
+	}
+	output_test("END: local time cache test");
+
+	output_test("BEGIN: local time conversion benchmark (%d conversions per run)", NCONVERSIONS);
+	for (i=0; i<sizeof(steps)/sizeof(steps[0]); i++)
+	{
+		double rate[2];
+		char steptxt[32];
+		for (test=0; test<2; test++)
+		{
+			DATETIME dt;
+			int n;
+			clock_t t0;
+			double dt_sec;
+			tscache_enabled = test;
+			t0 = clock();
+			for (n=0, ts=DAY+tzoffset; n<NCONVERSIONS; n++, ts+=steps[i])
+			{
+				if (ts>=DAY*365*NYEARS) /* wrap long steps around the tested years */
+					ts = DAY+tzoffset;
+				local_datetime(ts,&dt);
+			}
+			dt_sec = (double)(clock()-t0)/CLOCKS_PER_SEC;
+			rate[test] = dt_sec>0 ? NCONVERSIONS/dt_sec : 0;
+		}
+		convert_from_timestamp(steps[i],steptxt,sizeof(steptxt));
+		output_test("  %s steps: %.0f conversions/s uncached, %.0f conversions/s cached (%.1fx)", steptxt,
+			rate[0], rate[1], rate[0]>0 ? rate[1]/rate[0] : 0);
+	}
+	output_test("END: local time conversion benchmark");
+	tscache_enabled = enabled;
+	output_verbose("local time cache tests: %d succeeded, %d failed (see '%s' for details)", succeeded, failed, global_testoutputfile);
+	return failed;
+}
+
 double timestamp_get_part(void *x, char *name)
 {
 	TIMESTAMP ts = *(TIMESTAMP*)x;
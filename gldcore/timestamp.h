@@ -85,6 +85,7 @@ int local_datetime(TIMESTAMP ts, DATETIME *dt);
 int local_datetime_delta(double tsdbl, DATETIME *dt);
 
 int timestamp_test(void);
+int timestamp_cache_test(void);
 
 char *timestamp_set_tz(char *tzname);
 TIMESTAMP timestamp_from_local(time_t t);
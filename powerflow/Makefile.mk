@@ -82,6 +82,10 @@ powerflow_powerflow_la_SOURCES += powerflow/sectionalizer.cpp
 powerflow_powerflow_la_SOURCES += powerflow/sectionalizer.h
 powerflow_powerflow_la_SOURCES += powerflow/series_reactor.cpp
 powerflow_powerflow_la_SOURCES += powerflow/series_reactor.h
+powerflow_powerflow_la_SOURCES += powerflow/solver_fbs.cpp
+powerflow_powerflow_la_SOURCES += powerflow/solver_fbs.h
+powerflow_powerflow_la_SOURCES += powerflow/solver_klu.cpp
+powerflow_powerflow_la_SOURCES += powerflow/solver_klu.h
 powerflow_powerflow_la_SOURCES += powerflow/solver_nr.cpp
 powerflow_powerflow_la_SOURCES += powerflow/solver_nr.h
 powerflow_powerflow_la_SOURCES += powerflow/substation.cpp
@@ -79,11 +79,24 @@ EXPORT CLASS *init(CALLBACKS *fntable, MODULE *module, int argc, char *argv[])
 	gl_global_create("powerflow::NR_matrix_output_references",PT_bool,&NRMatReferences,NULL);
 	gl_global_create("powerflow::NR_island_failure_handled",PT_bool,&NR_island_fail_method,PT_DESCRIPTION,"Indicates if an island fails if it should be removed from service",NULL);
 	gl_global_create("powerflow::line_capacitance",PT_bool,&use_line_cap,NULL);
+	gl_global_create("powerflow::line_impedance_cache",PT_bool,&line_impedance_cache,PT_DESCRIPTION,"Flag to compute line impedances once per configuration and phasing and scale them by the line length",NULL);
 	gl_global_create("powerflow::line_limits",PT_bool,&use_link_limits,NULL);
 	gl_global_create("powerflow::lu_solver",PT_char256,&LUSolverName,NULL);
+	gl_global_create("powerflow::matrix_solver_method",PT_enumeration,&matrix_solver_method,PT_DESCRIPTION,"Sparse matrix solver used by the NR solver (lu_solver overrides this with an external solver)",
+		PT_KEYWORD,"SUPERLU",(enumeration)MM_SUPERLU,
+		PT_KEYWORD,"EXTERN",(enumeration)MM_EXTERN,
+		PT_KEYWORD,"KLU",(enumeration)MM_KLU,
+		NULL);
 	gl_global_create("powerflow::NR_iteration_limit",PT_int64,&NR_iteration_limit,NULL);
 	gl_global_create("powerflow::NR_deltamode_iteration_limit",PT_int64,&NR_delta_iteration_limit,NULL);
 	gl_global_create("powerflow::NR_superLU_procs",PT_int32,&NR_superLU_procs,NULL);
+	gl_global_create("powerflow::NR_superLU_reuse_ordering",PT_bool,&NR_superLU_reuse_ordering,PT_DESCRIPTION,"Flag to reuse the superLU column ordering and elimination tree while the admittance matrix sparsity pattern is unchanged",NULL);
+	gl_global_create("powerflow::FBS_array_solver",PT_bool,&FBS_array_solver,PT_DESCRIPTION,"Flag to sweep FBS feeders to convergence on flat bus and branch arrays in one sync call",NULL);
+	gl_global_create("powerflow::FBS_iteration_limit",PT_int64,&FBS_iteration_limit,PT_DESCRIPTION,"Number of sweeps the FBS array solver makes before letting the core iterate again",NULL);
+	gl_global_create("powerflow::FBS_feeder_threadcount",PT_int32,&FBS_feeder_threadcount,PT_DESCRIPTION,"Number of threads sweeping FBS feeders concurrently (0 uses threadcount, 1 sweeps them one at a time)",NULL);
+	gl_global_create("powerflow::FBS_iteration_count",PT_int64,&FBS_iteration_count,PT_DESCRIPTION,"Sweeps done by the last FBS array solve",NULL);
+	gl_global_create("powerflow::FBS_voltage_mismatch",PT_double,&FBS_voltage_mismatch,PT_UNITS,"V",PT_DESCRIPTION,"Largest node voltage change on the last sweep of the last FBS array solve",NULL);
+	gl_global_create("powerflow::NR_island_threadcount",PT_int32,&NR_island_threadcount,PT_DESCRIPTION,"Number of threads solving Newton-Raphson islands concurrently (0 uses threadcount, 1 solves them one at a time)",NULL);
 	gl_global_create("powerflow::default_maximum_voltage_error",PT_double,&default_maximum_voltage_error,NULL);
 	gl_global_create("powerflow::default_maximum_power_error",PT_double,&default_maximum_power_error,NULL);
 	gl_global_create("powerflow::NR_admit_change",PT_bool,&NR_admit_change,NULL);
@@ -341,7 +354,9 @@ EXPORT SIMULATIONMODE interupdate(MODULE *module, TIMESTAMP t0, unsigned int64 d
 			//Put in try/catch, since GL_THROWs inside solver_nr tend to be a little upsetting
 			try {
 				//Call solver_nr
+				int64 solve_start = gl_timeline_now();
 				pf_result = solver_nr(NR_bus_count, NR_busdata, NR_branch_count, NR_branchdata, &NR_powerflow, powerflow_type, NULL, &bad_computation);
+				gl_timeline_event("module","powerflow::solver_nr",solve_start,pf_result);
 			}
 			catch (const char *msg)
 			{
@@ -42,6 +42,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <errno.h>
 #include <math.h>
 #include <iostream>
@@ -58,6 +59,7 @@ line::line(MODULE *mod) : link_object(mod) {
 	{
 		pclass = link_object::oclass;
 		
+		// not PC_PARALLEL_INIT: link_object::init sets the parents, ranks and link counts of the nodes it connects (recalc only writes the line and the locked impedance cache)
 		line_class = oclass = gl_register_class(mod,"line",sizeof(line),PC_PRETOPDOWN|PC_BOTTOMUP|PC_POSTTOPDOWN|PC_UNSAFE_OVERRIDE_OMIT|PC_AUTOLOCK);
 		if (oclass==NULL)
 			throw "unable to register class line";
@@ -332,6 +334,155 @@ void line::recalc_line_matricies(complex Zabc_mat[3][3], complex Yabc_mat[3][3])
 	multiply(A_mat,b_mat,B_mat);
 }
 
+/* Lines that share a configuration and phasing have the same impedance per mile, so the
+   Carson/Kron-reduced values are computed by the first of them and only scaled by length
+   for the others.  The entries are checked against a copy of the configuration and of the
+   conductor and spacing objects it refers to, so a change to any of them (or to the
+   frequency) causes the values to be computed again by the next line that needs them. */
+#define LINE_IMPEDANCE_CACHE_SIZE 1024
+static LINEIMPEDANCECACHE *line_impedance_cache_table[LINE_IMPEDANCE_CACHE_SIZE];
+static unsigned int line_impedance_cache_lock = 0;
+
+/* copies (when copy is true) or compares (otherwise) the data the impedance of a configuration
+   depends on; returns the size of that data, or 0 if the comparison found a difference */
+static size_t line_configuration_data(OBJECT *config, char *snapshot, size_t size, bool copy)
+{
+	OBJECT *item[16];
+	size_t n_items = 0, offset = 0;
+	PROPERTY *prop;
+
+	// the configuration itself and the objects it refers to (conductors and spacing)
+	item[n_items++] = config;
+	for (prop=config->oclass->pmap; prop!=NULL && prop->oclass==config->oclass && n_items<16; prop=prop->next)
+	{
+		if (prop->ptype==PT_object)
+		{
+			OBJECT *ref = *(OBJECT**)(OBJECTDATA(config,char)+(size_t)prop->addr);
+			if (ref!=NULL)
+				item[n_items++] = ref;
+		}
+	}
+	for (size_t i=0; i<n_items; i++)
+	{
+		size_t len = item[i]->oclass->size;
+		if (snapshot!=NULL)
+		{
+			if (offset+len>size)
+				return 0;
+			if (copy)
+				memcpy(snapshot+offset,OBJECTDATA(item[i],char),len);
+			else if (memcmp(snapshot+offset,OBJECTDATA(item[i],char),len)!=0)
+				return 0;
+		}
+		offset += len;
+	}
+	return (snapshot!=NULL && !copy && offset!=size) ? 0 : offset;
+}
+
+static inline double line_impedance_frequency(void)
+{
+	return enable_frequency_dependence ? current_frequency : nominal_frequency;
+}
+
+/** Gets the impedance of this line from the values computed for another line with the same configuration.
+	@return true if Zabc_mat, Yabc_mat (if not NULL), and aux (if not NULL) were set for this line's length,
+	false if they must be computed (and then given to save_cached_impedance)
+ **/
+bool line::load_cached_impedance(complex Zabc_mat[3][3], complex Yabc_mat[3][3], complex *aux)
+{
+	LINEIMPEDANCECACHE *entry;
+	double miles = length / 5280.0;
+	bool found = false;
+
+	if (line_impedance_cache==false || configuration==NULL)
+		return false;
+
+	READLOCK(&line_impedance_cache_lock);
+	for (entry=line_impedance_cache_table[configuration->id%LINE_IMPEDANCE_CACHE_SIZE]; entry!=NULL; entry=entry->next)
+	{
+		if (entry->configuration==configuration && entry->phases==phases)
+		{
+			found = entry->frequency==line_impedance_frequency()
+				&& entry->use_line_cap==use_line_cap
+				&& line_configuration_data(configuration,entry->snapshot,entry->snapshot_size,false)!=0;
+			if (found)
+			{
+				multiply(miles,entry->z_abc,Zabc_mat);
+				if (Yabc_mat!=NULL)
+					multiply(miles,entry->y_abc,Yabc_mat);
+				if (aux!=NULL)
+					for (int i=0; i<3; i++)
+						aux[i] = entry->aux[i];
+			}
+			break;
+		}
+	}
+	READUNLOCK(&line_impedance_cache_lock);
+	return found;
+}
+
+/** Keeps the per-mile impedance computed for this line for the other lines with the same configuration,
+	and scales Zabc_mat and Yabc_mat (if not NULL) by this line's length.
+ **/
+void line::save_cached_impedance(complex Zabc_mat[3][3], complex Yabc_mat[3][3], complex *aux)
+{
+	double miles = length / 5280.0;
+
+	if (line_impedance_cache==true && configuration!=NULL)
+	{
+		LINEIMPEDANCECACHE **head = &line_impedance_cache_table[configuration->id%LINE_IMPEDANCE_CACHE_SIZE];
+		LINEIMPEDANCECACHE *entry;
+
+		WRITELOCK(&line_impedance_cache_lock);
+		for (entry=*head; entry!=NULL; entry=entry->next)
+		{
+			if (entry->configuration==configuration && entry->phases==phases)
+				break;
+		}
+		if (entry==NULL)
+		{
+			entry = (LINEIMPEDANCECACHE*)gl_malloc(sizeof(LINEIMPEDANCECACHE));
+			if (entry!=NULL)
+			{
+				memset(entry,0,sizeof(LINEIMPEDANCECACHE));
+				entry->configuration = configuration;
+				entry->phases = phases;
+				entry->next = *head;
+				*head = entry;
+			}
+		}
+		if (entry!=NULL)
+		{
+			size_t size = line_configuration_data(configuration,NULL,0,false);
+			if (entry->snapshot_size!=size)
+			{
+				if (entry->snapshot!=NULL)
+					gl_free(entry->snapshot);
+				entry->snapshot = (char*)gl_malloc(size);
+				entry->snapshot_size = (entry->snapshot!=NULL ? size : 0);
+			}
+			if (entry->snapshot!=NULL)
+				line_configuration_data(configuration,entry->snapshot,entry->snapshot_size,true);
+			else
+				entry->configuration = NULL; // unusable, will not match again
+			entry->frequency = line_impedance_frequency();
+			entry->use_line_cap = use_line_cap;
+			equalm(Zabc_mat,entry->z_abc);
+			for (int i=0; i<3; i++)
+			{
+				for (int j=0; j<3; j++)
+					entry->y_abc[i][j] = (Yabc_mat!=NULL ? Yabc_mat[i][j] : complex(0,0));
+				entry->aux[i] = (aux!=NULL ? aux[i] : complex(0,0));
+			}
+		}
+		WRITEUNLOCK(&line_impedance_cache_lock);
+	}
+
+	multiply(miles,Zabc_mat,Zabc_mat);
+	if (Yabc_mat!=NULL)
+		multiply(miles,Yabc_mat,Yabc_mat);
+}
+
 //////////////////////////////////////////////////////////////////////////
 // IMPLEMENTATION OF CORE LINKAGE: line
 //////////////////////////////////////////////////////////////////////////
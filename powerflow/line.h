@@ -26,6 +26,20 @@ extern bool show_matrix_values;
 #include "triplex_line_configuration.h"
 #include "triplex_line_conductor.h"
 
+/* per-mile impedances shared by the lines with the same configuration and phasing */
+typedef struct s_line_impedance_cache {
+	OBJECT *configuration;		///< configuration the values were computed from
+	set phases;					///< phasing of the lines sharing them
+	double frequency;			///< frequency they were computed at
+	bool use_line_cap;			///< shunt capacitance was included
+	char *snapshot;				///< configuration, conductor, and spacing data they were computed from
+	size_t snapshot_size;		///< size of the snapshot
+	complex z_abc[3][3];		///< series impedance (Ohm/mile)
+	complex y_abc[3][3];		///< shunt admittance (S/mile)
+	complex aux[3];				///< values that do not scale with length (triplex neutral factors)
+	struct s_line_impedance_cache *next;
+} LINEIMPEDANCECACHE;
+
 class line : public link_object
 {
 public:
@@ -43,6 +57,8 @@ public:
 protected:
 	void load_matrix_based_configuration(complex Zabc_mat[3][3], complex Yabc_mat[3][3]);
 	void recalc_line_matricies(complex Zabc_mat[3][3], complex Yabc_mat[3][3]);
+	bool load_cached_impedance(complex Zabc_mat[3][3], complex Yabc_mat[3][3], complex *aux=NULL);
+	void save_cached_impedance(complex Zabc_mat[3][3], complex Yabc_mat[3][3], complex *aux=NULL);
 };
 
 #include "triplex_line.h"
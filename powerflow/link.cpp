@@ -230,6 +230,7 @@ int link_object::create(void)
 	SpecialLnk = NORMAL;
 	prev_LTime=0;
 	NR_branch_reference=-1;
+	FBS_array_branch=false;
 	If_in[0] = If_in[1] = If_in[2] = complex(0,0);
 	If_out[0] = If_out[1] = If_out[2] = complex(0,0);
 
@@ -2830,7 +2831,7 @@ TIMESTAMP link_object::sync(TIMESTAMP t0)
 
 	if (is_closed())
 	{
-		if (solver_method==SM_FBS)
+		if ((solver_method==SM_FBS) && (FBS_array_branch==false))	//Array FBS computes the currents of its branches from the swing bus
 		{
 			node *f;
 			node *t;
@@ -72,6 +72,7 @@ public:
 	enumeration prev_status;	///< Previous link status (used for recalculation detection)
 
 	bool current_accumulated;	///< Flag to indicate if NR current has been "handled" yet
+	bool FBS_array_branch;	///< Flag to indicate solver_fbs sweeps this link (its sync leaves the current injection alone)
 	bool check_link_limits;	///< Flag to see if this particular link needs limits checked
 	OBJECT *from;			///< from_node - source node
 	OBJECT *to;				///< to_node - load node
@@ -53,6 +53,7 @@
 #include <math.h>
 
 #include "solver_nr.h"
+#include "solver_klu.h"
 #include "node.h"
 #include "link.h"
 
@@ -274,6 +275,7 @@ int node::create(void)
 	NR_child_nodes = NULL;
 
 	NR_node_reference = -1;	//Newton-Raphson bus index, set to -1 initially
+	FBS_array_bus = false;	//Array-based FBS flag, set when the swing bus builds the arrays
 	house_present = false;	//House attachment flag
 	nom_res_curr[0] = nom_res_curr[1] = nom_res_curr[2] = 0.0;	//Nominal house current variables
 
@@ -775,9 +777,26 @@ int node::init(OBJECT *parent)
 		//Make sure it is the "master swing" too
 		if (obj == NR_swing_bus)
 		{
-			if (LUSolverName[0]=='\0')	//Empty name, default to superLU
+			if (LUSolverName[0]=='\0')	//Empty name, use a built-in solver
 			{
-				matrix_solver_method=MM_SUPERLU;	//This is the default, but we'll set it here anyways
+				if (matrix_solver_method==MM_KLU)	//Built-in KLU solver, hooked through the external solver interface
+				{
+					LUSolverFcns.dllLink = NULL;
+					LUSolverFcns.ext_init = (void *)KLU_NR_init;
+					LUSolverFcns.ext_alloc = (void *)KLU_NR_alloc;
+					LUSolverFcns.ext_solve = (void *)KLU_NR_solve;
+					LUSolverFcns.ext_destroy = (void *)KLU_NR_destroy;
+
+					gl_verbose("Built-in KLU solver selected for NR");
+					/*  TROUBLESHOOT
+					The matrix_solver_method was set to KLU, so NR will be calculated using the
+					built-in KLU-style sparse LU solver instead of superLU.
+					*/
+				}
+				else
+				{
+					matrix_solver_method=MM_SUPERLU;	//This is the default, but we'll set it here anyways
+				}
 			}
 			else	//Something is there, see if we can find it
 			{
@@ -2018,6 +2037,10 @@ TIMESTAMP node::presync(TIMESTAMP t0)
 			condition = OC_NORMAL;	//Clear the flag in case we're a switch
 		}
 #endif
+		/* the swing bus builds the sweep arrays the first time through, before anyone accumulates currents */
+		if ((FBS_array_solver==true) && (bustype==SWING) && (FBS_array_bus==false))
+			solver_fbs_init(obj);
+
 		/* reset the current accumulator */
 		current_inj[0] = current_inj[1] = current_inj[2] = complex(0,0);
 
@@ -2194,108 +2217,100 @@ void node::NR_node_sync_fxn(OBJECT *obj)
 
 		if (SubNode==CHILD)
 		{
-			//Post our loads up to our parent
+			//Post our loads up to our parent - the core adds them in once our siblings are done too
 			node *ParToLoad = OBJECTDATA(SubNodeParent,node);
 
 			if (gl_object_isa(SubNodeParent,"load","powerflow"))	//Load gets cleared at every presync, so reaggregate :(
 			{
-				//Lock the parent for accumulation
-				LOCK_OBJECT(SubNodeParent);
-
 				//Import power and "load" characteristics
-				ParToLoad->power[0]+=power[0];
-				ParToLoad->power[1]+=power[1];
-				ParToLoad->power[2]+=power[2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->power[0],power[0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->power[1],power[1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->power[2],power[2]);
 
-				ParToLoad->shunt[0]+=shunt[0];
-				ParToLoad->shunt[1]+=shunt[1];
-				ParToLoad->shunt[2]+=shunt[2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->shunt[0],shunt[0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->shunt[1],shunt[1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->shunt[2],shunt[2]);
 
-				ParToLoad->current[0]+=current[0];
-				ParToLoad->current[1]+=current[1];
-				ParToLoad->current[2]+=current[2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->current[0],current[0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->current[1],current[1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->current[2],current[2]);
 
 				//Accumulate the unrotated values too
-				ParToLoad->pre_rotated_current[0] += pre_rotated_current[0];
-				ParToLoad->pre_rotated_current[1] += pre_rotated_current[1];
-				ParToLoad->pre_rotated_current[2] += pre_rotated_current[2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[0],pre_rotated_current[0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[1],pre_rotated_current[1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[2],pre_rotated_current[2]);
 
 				//And the deltamode accumulators too -- if deltamode
 				if (deltamode_inclusive == true)
 				{
 					//Pull our parent value down -- everything is being pushed up there anyways
 					//Pulling to keep meters accurate (theoretically)
+					READLOCK_OBJECT(SubNodeParent);
 					deltamode_dynamic_current[0] = ParToLoad->deltamode_dynamic_current[0];
 					deltamode_dynamic_current[1] = ParToLoad->deltamode_dynamic_current[1];
 					deltamode_dynamic_current[2] = ParToLoad->deltamode_dynamic_current[2];
+					READUNLOCK_OBJECT(SubNodeParent);
 				}
 
 				//Do the same for explicit delta/wye portions
 				for (loop_index_var=0; loop_index_var<6; loop_index_var++)
 				{
-					ParToLoad->power_dy[loop_index_var] += power_dy[loop_index_var];
-					ParToLoad->shunt_dy[loop_index_var] += shunt_dy[loop_index_var];
-					ParToLoad->current_dy[loop_index_var] += current_dy[loop_index_var];
+					gl_reduce(obj,SubNodeParent,ParToLoad->power_dy[loop_index_var],power_dy[loop_index_var]);
+					gl_reduce(obj,SubNodeParent,ParToLoad->shunt_dy[loop_index_var],shunt_dy[loop_index_var]);
+					gl_reduce(obj,SubNodeParent,ParToLoad->current_dy[loop_index_var],current_dy[loop_index_var]);
 				}
-
-				//All done, unlock
-				UNLOCK_OBJECT(SubNodeParent);
 			}
 			else if (gl_object_isa(SubNodeParent,"node","powerflow"))	//"parented" node - update values - This has to go to the bottom
 			{												//since load/meter share with node (and load handles power in presync)
-				//Lock the parent for accumulation
-				LOCK_OBJECT(SubNodeParent);
-
 				//Import power and "load" characteristics
-				ParToLoad->power[0]+=power[0]-last_child_power[0][0];
-				ParToLoad->power[1]+=power[1]-last_child_power[0][1];
-				ParToLoad->power[2]+=power[2]-last_child_power[0][2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->power[0],power[0]-last_child_power[0][0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->power[1],power[1]-last_child_power[0][1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->power[2],power[2]-last_child_power[0][2]);
 
-				ParToLoad->shunt[0]+=shunt[0]-last_child_power[1][0];
-				ParToLoad->shunt[1]+=shunt[1]-last_child_power[1][1];
-				ParToLoad->shunt[2]+=shunt[2]-last_child_power[1][2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->shunt[0],shunt[0]-last_child_power[1][0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->shunt[1],shunt[1]-last_child_power[1][1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->shunt[2],shunt[2]-last_child_power[1][2]);
 
-				ParToLoad->current[0]+=current[0]-last_child_power[2][0];
-				ParToLoad->current[1]+=current[1]-last_child_power[2][1];
-				ParToLoad->current[2]+=current[2]-last_child_power[2][2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->current[0],current[0]-last_child_power[2][0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->current[1],current[1]-last_child_power[2][1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->current[2],current[2]-last_child_power[2][2]);
 
-				ParToLoad->pre_rotated_current[0] += pre_rotated_current[0]-last_child_power[3][0];
-				ParToLoad->pre_rotated_current[1] += pre_rotated_current[1]-last_child_power[3][1];
-				ParToLoad->pre_rotated_current[2] += pre_rotated_current[2]-last_child_power[3][2];
+				gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[0],pre_rotated_current[0]-last_child_power[3][0]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[1],pre_rotated_current[1]-last_child_power[3][1]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[2],pre_rotated_current[2]-last_child_power[3][2]);
 
 				//And the deltamode accumulators too -- if deltamode
 				if (deltamode_inclusive == true)
 				{
 					//Pull our parent value down -- everything is being pushed up there anyways
 					//Pulling to keep meters accurate (theoretically)
+					READLOCK_OBJECT(SubNodeParent);
 					deltamode_dynamic_current[0] = ParToLoad->deltamode_dynamic_current[0];
 					deltamode_dynamic_current[1] = ParToLoad->deltamode_dynamic_current[1];
 					deltamode_dynamic_current[2] = ParToLoad->deltamode_dynamic_current[2];
+					READUNLOCK_OBJECT(SubNodeParent);
 				}
 
 				//Do the same for the explicit delta/wye loads - last_child_power is set up as columns of ZIP, not ABC
 				for (loop_index_var=0; loop_index_var<6; loop_index_var++)
 				{
-					ParToLoad->power_dy[loop_index_var] += power_dy[loop_index_var] - last_child_power_dy[loop_index_var][0];
-					ParToLoad->shunt_dy[loop_index_var] += shunt_dy[loop_index_var] - last_child_power_dy[loop_index_var][1];
-					ParToLoad->current_dy[loop_index_var] += current_dy[loop_index_var] - last_child_power_dy[loop_index_var][2];
+					gl_reduce(obj,SubNodeParent,ParToLoad->power_dy[loop_index_var],power_dy[loop_index_var] - last_child_power_dy[loop_index_var][0]);
+					gl_reduce(obj,SubNodeParent,ParToLoad->shunt_dy[loop_index_var],shunt_dy[loop_index_var] - last_child_power_dy[loop_index_var][1]);
+					gl_reduce(obj,SubNodeParent,ParToLoad->current_dy[loop_index_var],current_dy[loop_index_var] - last_child_power_dy[loop_index_var][2]);
 				}
 
 				if (has_phase(PHASE_S))	//Triplex gets another term as well
 				{
-					ParToLoad->current12 +=current12-last_child_current12;
+					gl_reduce(obj,SubNodeParent,ParToLoad->current12,current12-last_child_current12);
 				}
 
 				//See if we have a house!
 				if (house_present==true)	//Add our values into our parent's accumulator!
 				{
-					ParToLoad->nom_res_curr[0] += nom_res_curr[0];
-					ParToLoad->nom_res_curr[1] += nom_res_curr[1];
-					ParToLoad->nom_res_curr[2] += nom_res_curr[2];
+					gl_reduce(obj,SubNodeParent,ParToLoad->nom_res_curr[0],nom_res_curr[0]);
+					gl_reduce(obj,SubNodeParent,ParToLoad->nom_res_curr[1],nom_res_curr[1]);
+					gl_reduce(obj,SubNodeParent,ParToLoad->nom_res_curr[2],nom_res_curr[2]);
 				}
-
-				//Unlock the parent now that we are done
-				UNLOCK_OBJECT(SubNodeParent);
 			}
 			else
 			{
@@ -2341,48 +2356,44 @@ void node::NR_node_sync_fxn(OBJECT *obj)
 			//Post our loads up to our parent - in the appropriate fashion
 			node *ParToLoad = OBJECTDATA(SubNodeParent,node);
 
-			//Lock the parent for accumulation
-			LOCK_OBJECT(SubNodeParent);
-
 			//Update post them.  Row 1 is power, row 2 is admittance, row 3 is current
-			ParToLoad->Extra_Data[0] += power[0];
-			ParToLoad->Extra_Data[1] += power[1];
-			ParToLoad->Extra_Data[2] += power[2];
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[0],power[0]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[1],power[1]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[2],power[2]);
 
-			ParToLoad->Extra_Data[3] += shunt[0];
-			ParToLoad->Extra_Data[4] += shunt[1];
-			ParToLoad->Extra_Data[5] += shunt[2];
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[3],shunt[0]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[4],shunt[1]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[5],shunt[2]);
 
-			ParToLoad->Extra_Data[6] += current[0];
-			ParToLoad->Extra_Data[7] += current[1];
-			ParToLoad->Extra_Data[8] += current[2];
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[6],current[0]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[7],current[1]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->Extra_Data[8],current[2]);
 
 			//Add in the unrotated stuff too -- it should never be subject to "connectivity"
-			ParToLoad->pre_rotated_current[0] += pre_rotated_current[0];
-			ParToLoad->pre_rotated_current[1] += pre_rotated_current[1];
-			ParToLoad->pre_rotated_current[2] += pre_rotated_current[2];
+			gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[0],pre_rotated_current[0]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[1],pre_rotated_current[1]);
+			gl_reduce(obj,SubNodeParent,ParToLoad->pre_rotated_current[2],pre_rotated_current[2]);
 
 			//And the deltamode accumulators too -- if deltamode
 			if (deltamode_inclusive == true)
 			{
 				//Pull our parent value down -- everything is being pushed up there anyways
 				//Pulling to keep meters accurate (theoretically)
+				READLOCK_OBJECT(SubNodeParent);
 				deltamode_dynamic_current[0] = ParToLoad->deltamode_dynamic_current[0];
 				deltamode_dynamic_current[1] = ParToLoad->deltamode_dynamic_current[1];
 				deltamode_dynamic_current[2] = ParToLoad->deltamode_dynamic_current[2];
+				READUNLOCK_OBJECT(SubNodeParent);
 			}
 
 			//Import power and "load" characteristics for explicit delta/wye portions
 			for (loop_index_var=0; loop_index_var<6; loop_index_var++)
 			{
-				ParToLoad->power_dy[loop_index_var] += power_dy[loop_index_var];
-				ParToLoad->shunt_dy[loop_index_var] += shunt_dy[loop_index_var];
-				ParToLoad->current_dy[loop_index_var] += current_dy[loop_index_var];
+				gl_reduce(obj,SubNodeParent,ParToLoad->power_dy[loop_index_var],power_dy[loop_index_var]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->shunt_dy[loop_index_var],shunt_dy[loop_index_var]);
+				gl_reduce(obj,SubNodeParent,ParToLoad->current_dy[loop_index_var],current_dy[loop_index_var]);
 			}
 
-			//Finished, unlock parent
-			UNLOCK_OBJECT(SubNodeParent);
-
 			//Update our tracking variable
 			for (loop_index_var=0; loop_index_var<6; loop_index_var++)
 			{
@@ -2417,9 +2428,9 @@ void node::NR_node_sync_fxn(OBJECT *obj)
 	}//end not uninitialized
 }
 
-TIMESTAMP node::sync(TIMESTAMP t0)
+//Functionalized FBS current injection of the node's own loads -- called by sync and by the array sweep (solver_fbs)
+void node::FBS_load_current(void)
 {
-	TIMESTAMP t1 = powerflow_object::sync(t0);
 	OBJECT *obj = OBJECTHDR(this);
 	complex delta_current[3];
 	complex power_current[3];
@@ -2427,247 +2438,291 @@ TIMESTAMP node::sync(TIMESTAMP t0)
 	complex delta_shunt_curr[3];
 	complex dy_curr_accum[3];
 	complex temp_current_val[3];
-	
-	//Generic time keeping variable - used for phase checks (GS does this explicitly below)
-	if (t0!=prev_NTime)
-	{
-		//Update time tracking variable
-		prev_NTime=t0;
-	}
-
-	switch (solver_method)
-	{
-	case SM_FBS:
-		{
-		if (phases&PHASE_S)
-		{	// Split phase
-			complex temp_inj[2];
-			complex adjusted_curr[3];
-			complex temp_curr_val[3];
 
-			if (house_present)
-			{
-				//Update phase adjustments
-				adjusted_curr[0].SetPolar(1.0,voltage[0].Arg());	//Pull phase of V1
-				adjusted_curr[1].SetPolar(1.0,voltage[1].Arg());	//Pull phase of V2
-				adjusted_curr[2].SetPolar(1.0,voltaged[0].Arg());	//Pull phase of V12
+	if (phases&PHASE_S)
+	{	// Split phase
+		complex temp_inj[2];
+		complex adjusted_curr[3];
+		complex temp_curr_val[3];
 
-				//Update these current contributions
-				temp_curr_val[0] = nom_res_curr[0]/(~adjusted_curr[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
-				temp_curr_val[1] = nom_res_curr[1]/(~adjusted_curr[1]);
-				temp_curr_val[2] = nom_res_curr[2]/(~adjusted_curr[2]);
-			}
-			else
-			{
-				temp_curr_val[0] = temp_curr_val[1] = temp_curr_val[2] = 0.0;	//No house present, just zero em
-			}
+		if (house_present)
+		{
+			//Update phase adjustments
+			adjusted_curr[0].SetPolar(1.0,voltage[0].Arg());	//Pull phase of V1
+			adjusted_curr[1].SetPolar(1.0,voltage[1].Arg());	//Pull phase of V2
+			adjusted_curr[2].SetPolar(1.0,voltaged[0].Arg());	//Pull phase of V12
+
+			//Update these current contributions
+			temp_curr_val[0] = nom_res_curr[0]/(~adjusted_curr[0]);		//Just denominator conjugated to keep math right (rest was conjugated in house)
+			temp_curr_val[1] = nom_res_curr[1]/(~adjusted_curr[1]);
+			temp_curr_val[2] = nom_res_curr[2]/(~adjusted_curr[2]);
+		}
+		else
+		{
+			temp_curr_val[0] = temp_curr_val[1] = temp_curr_val[2] = 0.0;	//No house present, just zero em
+		}
 
 #ifdef SUPPORT_OUTAGES
-			if (voltage[0]!=0.0)
-			{
+		if (voltage[0]!=0.0)
+		{
 #endif
-			complex d1 = (voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ? (current1 + temp_curr_val[0]) : (current1 + ~(power1/voltage1) + voltage1*shunt1 + temp_curr_val[0]);
-			complex d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (current12 + temp_curr_val[2]) : (current12 + ~(power12/(voltage1+voltage2)) + (voltage1+voltage2)*shunt12 + temp_curr_val[2]);
-			
-			current_inj[0] += d1;
-			temp_inj[0] = current_inj[0];
-			current_inj[0] += d2;
+		complex d1 = (voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ? (current1 + temp_curr_val[0]) : (current1 + ~(power1/voltage1) + voltage1*shunt1 + temp_curr_val[0]);
+		complex d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (current12 + temp_curr_val[2]) : (current12 + ~(power12/(voltage1+voltage2)) + (voltage1+voltage2)*shunt12 + temp_curr_val[2]);
+		
+		current_inj[0] += d1;
+		temp_inj[0] = current_inj[0];
+		current_inj[0] += d2;
 
 #ifdef SUPPORT_OUTAGES
-			}
-			else
-			{
-				temp_inj[0] = 0.0;
-				//WRITELOCK_OBJECT(obj);
-				current_inj[0]=0.0;
-				//UNLOCK_OBJECT(obj);
-			}
+		}
+		else
+		{
+			temp_inj[0] = 0.0;
+			//WRITELOCK_OBJECT(obj);
+			current_inj[0]=0.0;
+			//UNLOCK_OBJECT(obj);
+		}
 
-			if (voltage[1]!=0)
-			{
+		if (voltage[1]!=0)
+		{
 #endif
-			d1 = (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero())) ? (-current2 - temp_curr_val[1]) : (-current2 - ~(power2/voltage2) - voltage2*shunt2 - temp_curr_val[1]);
-			d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (-current12 - temp_curr_val[2]) : (-current12 - ~(power12/(voltage1+voltage2)) - (voltage1+voltage2)*shunt12 - temp_curr_val[2]);
+		d1 = (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero())) ? (-current2 - temp_curr_val[1]) : (-current2 - ~(power2/voltage2) - voltage2*shunt2 - temp_curr_val[1]);
+		d2 = ((voltage1+voltage2).IsZero() || (power12.IsZero() && shunt12.IsZero())) ? (-current12 - temp_curr_val[2]) : (-current12 - ~(power12/(voltage1+voltage2)) - (voltage1+voltage2)*shunt12 - temp_curr_val[2]);
 
-			current_inj[1] += d1;
-			temp_inj[1] = current_inj[1];
-			current_inj[1] += d2;
-			
+		current_inj[1] += d1;
+		temp_inj[1] = current_inj[1];
+		current_inj[1] += d2;
+		
 #ifdef SUPPORT_OUTAGES
-			}
-			else
-			{
-				temp_inj[0] = 0.0;
-				//WRITELOCK_OBJECT(obj);
-				current_inj[1] = 0.0;
-				//UNLOCK_OBJECT(obj);
-			}
+		}
+		else
+		{
+			temp_inj[0] = 0.0;
+			//WRITELOCK_OBJECT(obj);
+			current_inj[1] = 0.0;
+			//UNLOCK_OBJECT(obj);
+		}
 #endif
 
-			if (obj->parent!=NULL && gl_object_isa(obj->parent,"triplex_line","powerflow")) {
-				link_object *plink = OBJECTDATA(obj->parent,link_object);
-				complex d = plink->tn[0]*current_inj[0] + plink->tn[1]*current_inj[1];
-				current_inj[2] += d;
-			}
-			else {
-				complex d = ((voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ||
-								   (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero()))) 
-									? currentN : -(temp_inj[0] + temp_inj[1]);
-				current_inj[2] += d;
-			}
+		if (obj->parent!=NULL && gl_object_isa(obj->parent,"triplex_line","powerflow")) {
+			link_object *plink = OBJECTDATA(obj->parent,link_object);
+			complex d = plink->tn[0]*current_inj[0] + plink->tn[1]*current_inj[1];
+			current_inj[2] += d;
 		}
-		else if (has_phase(PHASE_D)) 
-		{   // 'Delta' connected load
-			
-			//Convert delta connected power to appropriate line current
-			delta_current[0]= (voltaged[0].IsZero()) ? 0 : ~(power[0]/voltaged[0]);
-			delta_current[1]= (voltaged[1].IsZero()) ? 0 : ~(power[1]/voltaged[1]);
-			delta_current[2]= (voltaged[2].IsZero()) ? 0 : ~(power[2]/voltaged[2]);
+		else {
+			complex d = ((voltage1.IsZero() || (power1.IsZero() && shunt1.IsZero())) ||
+							   (voltage2.IsZero() || (power2.IsZero() && shunt2.IsZero()))) 
+								? currentN : -(temp_inj[0] + temp_inj[1]);
+			current_inj[2] += d;
+		}
+	}
+	else if (has_phase(PHASE_D)) 
+	{   // 'Delta' connected load
+		
+		//Convert delta connected power to appropriate line current
+		delta_current[0]= (voltaged[0].IsZero()) ? 0 : ~(power[0]/voltaged[0]);
+		delta_current[1]= (voltaged[1].IsZero()) ? 0 : ~(power[1]/voltaged[1]);
+		delta_current[2]= (voltaged[2].IsZero()) ? 0 : ~(power[2]/voltaged[2]);
 
-			power_current[0]=delta_current[0]-delta_current[2];
-			power_current[1]=delta_current[1]-delta_current[0];
-			power_current[2]=delta_current[2]-delta_current[1];
+		power_current[0]=delta_current[0]-delta_current[2];
+		power_current[1]=delta_current[1]-delta_current[0];
+		power_current[2]=delta_current[2]-delta_current[1];
 
-			//Convert delta connected load to appropriate line current
-			delta_shunt[0] = voltaged[0]*shunt[0];
-			delta_shunt[1] = voltaged[1]*shunt[1];
-			delta_shunt[2] = voltaged[2]*shunt[2];
+		//Convert delta connected load to appropriate line current
+		delta_shunt[0] = voltaged[0]*shunt[0];
+		delta_shunt[1] = voltaged[1]*shunt[1];
+		delta_shunt[2] = voltaged[2]*shunt[2];
 
-			delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
-			delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
-			delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
+		delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
+		delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
+		delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
 
-			//Convert delta-current into a phase current - reuse temp variable
-			delta_current[0]=current[0]-current[2];
-			delta_current[1]=current[1]-current[0];
-			delta_current[2]=current[2]-current[1];
+		//Convert delta-current into a phase current - reuse temp variable
+		delta_current[0]=current[0]-current[2];
+		delta_current[1]=current[1]-current[0];
+		delta_current[2]=current[2]-current[1];
 
 #ifdef SUPPORT_OUTAGES
-			for (char kphase=0;kphase<3;kphase++)
+		for (char kphase=0;kphase<3;kphase++)
+		{
+			if (voltaged[kphase]==0.0)
 			{
-				if (voltaged[kphase]==0.0)
-				{
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] = 0.0;
-					//UNLOCK_OBJECT(obj);
-				}
-				else
-				{
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] += delta_current[kphase] + power_current[kphase] + delta_shunt_curr[kphase];
-					//UNLOCK_OBJECT(obj);
-				}
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] = 0.0;
+				//UNLOCK_OBJECT(obj);
 			}
+			else
+			{
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] += delta_current[kphase] + power_current[kphase] + delta_shunt_curr[kphase];
+				//UNLOCK_OBJECT(obj);
+			}
+		}
 #else
-			temp_current_val[0] = delta_current[0] + power_current[0] + delta_shunt_curr[0];
-			temp_current_val[1] = delta_current[1] + power_current[1] + delta_shunt_curr[1];
-			temp_current_val[2] = delta_current[2] + power_current[2] + delta_shunt_curr[2];
+		temp_current_val[0] = delta_current[0] + power_current[0] + delta_shunt_curr[0];
+		temp_current_val[1] = delta_current[1] + power_current[1] + delta_shunt_curr[1];
+		temp_current_val[2] = delta_current[2] + power_current[2] + delta_shunt_curr[2];
 
-			current_inj[0] += temp_current_val[0];
-			current_inj[1] += temp_current_val[1];
-			current_inj[2] += temp_current_val[2];
+		current_inj[0] += temp_current_val[0];
+		current_inj[1] += temp_current_val[1];
+		current_inj[2] += temp_current_val[2];
 #endif
-		}
-		else 
-		{	// 'WYE' connected load
+	}
+	else 
+	{	// 'WYE' connected load
 
 #ifdef SUPPORT_OUTAGES
-			for (char kphase=0;kphase<3;kphase++)
+		for (char kphase=0;kphase<3;kphase++)
+		{
+			if (voltage[kphase]==0.0)
 			{
-				if (voltage[kphase]==0.0)
-				{
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] = 0.0;
-					//UNLOCK_OBJECT(obj);
-				}
-				else
-				{
-					complex d = ((voltage[kphase]==0.0) || ((power[kphase] == 0) && shunt[kphase].IsZero())) ? current[kphase] : current[kphase] + ~(power[kphase]/voltage[kphase]) + voltage[kphase]*shunt[kphase];
-					//WRITELOCK_OBJECT(obj);
-					current_inj[kphase] += d;
-					//UNLOCK_OBJECT(obj);
-				}
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] = 0.0;
+				//UNLOCK_OBJECT(obj);
+			}
+			else
+			{
+				complex d = ((voltage[kphase]==0.0) || ((power[kphase] == 0) && shunt[kphase].IsZero())) ? current[kphase] : current[kphase] + ~(power[kphase]/voltage[kphase]) + voltage[kphase]*shunt[kphase];
+				//WRITELOCK_OBJECT(obj);
+				current_inj[kphase] += d;
+				//UNLOCK_OBJECT(obj);
 			}
+		}
 #else
 
-			temp_current_val[0] = (voltage[0].IsZero() || (power[0].IsZero() && shunt[0].IsZero())) ? current[0] : current[0] + ~(power[0]/voltage[0]) + voltage[0]*shunt[0];
-			temp_current_val[1] = (voltage[1].IsZero() || (power[1].IsZero() && shunt[1].IsZero())) ? current[1] : current[1] + ~(power[1]/voltage[1]) + voltage[1]*shunt[1];
-			temp_current_val[2] = (voltage[2].IsZero() || (power[2].IsZero() && shunt[2].IsZero())) ? current[2] : current[2] + ~(power[2]/voltage[2]) + voltage[2]*shunt[2];
+		temp_current_val[0] = (voltage[0].IsZero() || (power[0].IsZero() && shunt[0].IsZero())) ? current[0] : current[0] + ~(power[0]/voltage[0]) + voltage[0]*shunt[0];
+		temp_current_val[1] = (voltage[1].IsZero() || (power[1].IsZero() && shunt[1].IsZero())) ? current[1] : current[1] + ~(power[1]/voltage[1]) + voltage[1]*shunt[1];
+		temp_current_val[2] = (voltage[2].IsZero() || (power[2].IsZero() && shunt[2].IsZero())) ? current[2] : current[2] + ~(power[2]/voltage[2]) + voltage[2]*shunt[2];
 
-			current_inj[0] += temp_current_val[0];
-			current_inj[1] += temp_current_val[1];
-			current_inj[2] += temp_current_val[2];
+		current_inj[0] += temp_current_val[0];
+		current_inj[1] += temp_current_val[1];
+		current_inj[2] += temp_current_val[2];
 #endif
-		}
+	}
 
-		//Handle explicit delta-wye connections now -- no triplex
-		if (!(has_phase(PHASE_S)))
-		{
-			//Convert delta connected power to appropriate line current
-			delta_current[0]= (voltageAB.IsZero()) ? 0 : ~(power_dy[0]/voltageAB);
-			delta_current[1]= (voltageBC.IsZero()) ? 0 : ~(power_dy[1]/voltageBC);
-			delta_current[2]= (voltageCA.IsZero()) ? 0 : ~(power_dy[2]/voltageCA);
-
-			power_current[0]=delta_current[0]-delta_current[2];
-			power_current[1]=delta_current[1]-delta_current[0];
-			power_current[2]=delta_current[2]-delta_current[1];
-
-			//Convert delta connected load to appropriate line current
-			delta_shunt[0] = voltageAB*shunt_dy[0];
-			delta_shunt[1] = voltageBC*shunt_dy[1];
-			delta_shunt[2] = voltageCA*shunt_dy[2];
-
-			delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
-			delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
-			delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
-
-			//Convert delta-current into a phase current - reuse temp variable
-			delta_current[0]=current_dy[0]-current_dy[2];
-			delta_current[1]=current_dy[1]-current_dy[0];
-			delta_current[2]=current_dy[2]-current_dy[1];
-
-			//Accumulate
-			dy_curr_accum[0] = delta_current[0] + power_current[0] + delta_shunt_curr[0];
-			dy_curr_accum[1] = delta_current[1] + power_current[1] + delta_shunt_curr[1];
-			dy_curr_accum[2] = delta_current[2] + power_current[2] + delta_shunt_curr[2];
-
-			//Wye-connected portions
-			dy_curr_accum[0] += (voltageA.IsZero() || (power_dy[3].IsZero() && shunt_dy[3].IsZero())) ? current_dy[3] : current_dy[3] + ~(power_dy[3]/voltageA) + voltageA*shunt_dy[3];
-			dy_curr_accum[1] += (voltageB.IsZero() || (power_dy[4].IsZero() && shunt_dy[4].IsZero())) ? current_dy[4] : current_dy[4] + ~(power_dy[4]/voltageB) + voltageB*shunt_dy[4];
-			dy_curr_accum[2] += (voltageC.IsZero() || (power_dy[5].IsZero() && shunt_dy[5].IsZero())) ? current_dy[5] : current_dy[5] + ~(power_dy[5]/voltageC) + voltageC*shunt_dy[5];
-				
-			//Accumulate in to final portion
-			current_inj[0] += dy_curr_accum[0];
-			current_inj[1] += dy_curr_accum[1];
-			current_inj[2] += dy_curr_accum[2];
+	//Handle explicit delta-wye connections now -- no triplex
+	if (!(has_phase(PHASE_S)))
+	{
+		//Convert delta connected power to appropriate line current
+		delta_current[0]= (voltageAB.IsZero()) ? 0 : ~(power_dy[0]/voltageAB);
+		delta_current[1]= (voltageBC.IsZero()) ? 0 : ~(power_dy[1]/voltageBC);
+		delta_current[2]= (voltageCA.IsZero()) ? 0 : ~(power_dy[2]/voltageCA);
+
+		power_current[0]=delta_current[0]-delta_current[2];
+		power_current[1]=delta_current[1]-delta_current[0];
+		power_current[2]=delta_current[2]-delta_current[1];
+
+		//Convert delta connected load to appropriate line current
+		delta_shunt[0] = voltageAB*shunt_dy[0];
+		delta_shunt[1] = voltageBC*shunt_dy[1];
+		delta_shunt[2] = voltageCA*shunt_dy[2];
+
+		delta_shunt_curr[0] = delta_shunt[0]-delta_shunt[2];
+		delta_shunt_curr[1] = delta_shunt[1]-delta_shunt[0];
+		delta_shunt_curr[2] = delta_shunt[2]-delta_shunt[1];
+
+		//Convert delta-current into a phase current - reuse temp variable
+		delta_current[0]=current_dy[0]-current_dy[2];
+		delta_current[1]=current_dy[1]-current_dy[0];
+		delta_current[2]=current_dy[2]-current_dy[1];
+
+		//Accumulate
+		dy_curr_accum[0] = delta_current[0] + power_current[0] + delta_shunt_curr[0];
+		dy_curr_accum[1] = delta_current[1] + power_current[1] + delta_shunt_curr[1];
+		dy_curr_accum[2] = delta_current[2] + power_current[2] + delta_shunt_curr[2];
+
+		//Wye-connected portions
+		dy_curr_accum[0] += (voltageA.IsZero() || (power_dy[3].IsZero() && shunt_dy[3].IsZero())) ? current_dy[3] : current_dy[3] + ~(power_dy[3]/voltageA) + voltageA*shunt_dy[3];
+		dy_curr_accum[1] += (voltageB.IsZero() || (power_dy[4].IsZero() && shunt_dy[4].IsZero())) ? current_dy[4] : current_dy[4] + ~(power_dy[4]/voltageB) + voltageB*shunt_dy[4];
+		dy_curr_accum[2] += (voltageC.IsZero() || (power_dy[5].IsZero() && shunt_dy[5].IsZero())) ? current_dy[5] : current_dy[5] + ~(power_dy[5]/voltageC) + voltageC*shunt_dy[5];
+			
+		//Accumulate in to final portion
+		current_inj[0] += dy_curr_accum[0];
+		current_inj[1] += dy_curr_accum[1];
+		current_inj[2] += dy_curr_accum[2];
 
-		}//End delta/wye explicit
+	}//End delta/wye explicit
 
 #ifdef SUPPORT_OUTAGES
 	if (is_open_any())
-		throw "unable to handle node open phase condition";
+	throw "unable to handle node open phase condition";
 
 	if (is_contact_any())
 	{
-		/* phase-phase contact */
-		if (is_contact(PHASE_A|PHASE_B|PHASE_C))
-			voltageA = voltageB = voltageC = (voltageA + voltageB + voltageC)/3;
-		else if (is_contact(PHASE_A|PHASE_B))
-			voltageA = voltageB = (voltageA + voltageB)/2;
-		else if (is_contact(PHASE_B|PHASE_C))
-			voltageB = voltageC = (voltageB + voltageC)/2;
-		else if (is_contact(PHASE_A|PHASE_C))
-			voltageA = voltageC = (voltageA + voltageC)/2;
-
-		/* phase-neutral/ground contact */
-		if (is_contact(PHASE_A|PHASE_N) || is_contact(PHASE_A|GROUND))
-			voltageA /= 2;
-		if (is_contact(PHASE_B|PHASE_N) || is_contact(PHASE_B|GROUND))
-			voltageB /= 2;
-		if (is_contact(PHASE_C|PHASE_N) || is_contact(PHASE_C|GROUND))
-			voltageC /= 2;
+	/* phase-phase contact */
+	if (is_contact(PHASE_A|PHASE_B|PHASE_C))
+		voltageA = voltageB = voltageC = (voltageA + voltageB + voltageC)/3;
+	else if (is_contact(PHASE_A|PHASE_B))
+		voltageA = voltageB = (voltageA + voltageB)/2;
+	else if (is_contact(PHASE_B|PHASE_C))
+		voltageB = voltageC = (voltageB + voltageC)/2;
+	else if (is_contact(PHASE_A|PHASE_C))
+		voltageA = voltageC = (voltageA + voltageC)/2;
+
+	/* phase-neutral/ground contact */
+	if (is_contact(PHASE_A|PHASE_N) || is_contact(PHASE_A|GROUND))
+		voltageA /= 2;
+	if (is_contact(PHASE_B|PHASE_N) || is_contact(PHASE_B|GROUND))
+		voltageB /= 2;
+	if (is_contact(PHASE_C|PHASE_N) || is_contact(PHASE_C|GROUND))
+		voltageC /= 2;
 	}
 #endif
+}
+
+//Fills in this node's entry of the array-based FBS bus data and flags us as swept there
+void node::FBS_populate(FBS_BUSDATA *bus_data)
+{
+	bus_data->bus = this;
+	bus_data->V = &voltage[0];
+	bus_data->Vd = &voltaged[0];
+	bus_data->last_V = &last_voltage[0];
+	bus_data->I = &current_inj[0];
+	bus_data->split = has_phase(PHASE_S);
+	bus_data->max_volt_error = maximum_voltage_error;
+	bus_data->obj = OBJECTHDR(this);
+
+	FBS_array_bus = true;
+}
+
+TIMESTAMP node::sync(TIMESTAMP t0)
+{
+	TIMESTAMP t1 = powerflow_object::sync(t0);
+	OBJECT *obj = OBJECTHDR(this);
+	
+	//Generic time keeping variable - used for phase checks (GS does this explicitly below)
+	if (t0!=prev_NTime)
+	{
+		//Update time tracking variable
+		prev_NTime=t0;
+	}
+
+	switch (solver_method)
+	{
+	case SM_FBS:
+		{
+		if (FBS_array_bus == true)
+		{
+			//The swing bus sweeps the whole feeder, everyone else in the arrays is handled there
+			if (bustype != SWING)
+				break;
+
+			int64 solve_start = gl_timeline_now();
+			int64 result = solver_fbs();
+			gl_timeline_event("module","powerflow::solver_fbs",solve_start,result);
+
+			if (result<0)	//Failure to converge, the nodes will request another pass
+			{
+				gl_verbose("Forward-Back Sweep failed to converge in %lld iterations, mismatch is %g V.",-result,FBS_voltage_mismatch);
+				/*  TROUBLESHOOT
+				The array-based Forward-Back Sweep did not converge in the number of iterations specified in FBS_iteration_limit.
+				The nodes will request another pass, so it will try again (if the global iteration limit has not been reached).
+				*/
+			}
+		}
+
+		//Accumulate our own loads
+		FBS_load_current();
 
 		// if the parent object is another node
 		if (obj->parent!=NULL && gl_object_isa(obj->parent,"node","powerflow"))
@@ -2729,7 +2784,9 @@ TIMESTAMP node::sync(TIMESTAMP t0)
 					powerflow_type = PF_NORMAL;
 				}
 
+				int64 solve_start = gl_timeline_now();
 				int64 result = solver_nr(NR_bus_count, NR_busdata, NR_branch_count, NR_branchdata, &NR_powerflow, powerflow_type, NULL, &bad_computation);
+				gl_timeline_event("module","powerflow::solver_nr",solve_start,result);
 
 				//De-flag the change - no contention should occur
 				NR_admit_change = false;
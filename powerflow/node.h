@@ -273,6 +273,11 @@ public:
 	//NR bus status toggle function
 	STATUS NR_swap_swing_status(bool desired_status);
 
+	//Array-based FBS functions
+	bool FBS_array_bus;		/// Flag to indicate solver_fbs sweeps this node (its sync leaves the current injection alone)
+	void FBS_load_current(void);
+	void FBS_populate(FBS_BUSDATA *bus_data);
+
 	//Island-condition reset function
 	STATUS reset_node_island_condition(void);
 
@@ -298,7 +298,7 @@ void overhead_line::recalc(void)
 			A_mat[2][2] = 1.0;
 		}
 	}
-	else
+	else if (load_cached_impedance(Zabc_mat, Yabc_mat) == false)
 	{
 		// Use Kersting's equations to define the z-matrix
 		double dab, dbc, dac, dan, dbn, dcn;
@@ -310,7 +310,7 @@ void overhead_line::recalc(void)
 		bool valid_capacitance = false;	//Assume capacitance is invalid by default
 		double freq_coeff_real, freq_coeff_imag, freq_additive_term;
 		line_spacing *spacing_val = NULL;
-		double miles = length / 5280.0;
+		double miles = 1.0;	//Values are computed per mile, then scaled by the length when cached
 		double cap_coeff;
 		complex cap_freq_mult;
 		
@@ -813,6 +813,9 @@ void overhead_line::recalc(void)
 				A_mat[2][2] = 1.0;
 			}
 		}
+
+		//Share the per-mile values with the other lines using this configuration, and scale them for this one
+		save_cached_impedance(Zabc_mat, Yabc_mat);
 	}
 
 	// Calculate line matrixies A_mat, B_mat, a_mat, b_mat, c_mat and d_mat based on Zabc_mat and Yabc_mat
@@ -23,7 +23,7 @@ overhead_line_conductor::overhead_line_conductor(MODULE *mod) : powerflow_librar
 {
 	if(oclass == NULL)
 	{
-		oclass = gl_register_class(mod,"overhead_line_conductor",sizeof(overhead_line_conductor),0x00);
+		oclass = gl_register_class(mod,"overhead_line_conductor",sizeof(overhead_line_conductor),PC_PARALLEL_INIT);
 		if (oclass==NULL)
 			throw "unable to register class overhead_line_conductor";
 		else
@@ -12,6 +12,7 @@
 
 #include "gridlabd.h"
 #include "solver_nr.h"
+#include "solver_fbs.h"
 
 #ifdef _POWERFLOW_CPP
 #define GLOBAL
@@ -32,7 +33,7 @@ void print_matrix(complex mat[3][3]);
 #define TSNVRDBL 9223372036854775808.0
 
 typedef enum {SM_FBS=0, SM_GS=1, SM_NR=2} SOLVERMETHOD;		/**< powerflow solver methodology */
-typedef enum {MM_SUPERLU=0, MM_EXTERN=1} MATRIXSOLVERMETHOD;	/**< NR matrix solver methodlogy */
+typedef enum {MM_SUPERLU=0, MM_EXTERN=1, MM_KLU=2} MATRIXSOLVERMETHOD;	/**< NR matrix solver methodlogy */
 typedef enum {
 	MD_NONE=0,			///< No matrix dump desired
 	MD_ONCE=1,			///< Single matrix dump desired
@@ -90,11 +91,19 @@ GLOBAL int64 NR_iteration_limit INIT(500);			/**< Newton-Raphson iteration limit
 GLOBAL bool NR_dyn_first_run INIT(true);			/**< Newton-Raphson first run indicator - used by deltamode functionality for initialization powerflow */
 GLOBAL bool NR_admit_change INIT(true);				/**< Newton-Raphson admittance matrix change detector - used to prevent complete recalculation of admittance at every timestep */
 GLOBAL int NR_superLU_procs INIT(1);				/**< Newton-Raphson related - superLU MT processor count to request - separate from thread_count */
+GLOBAL bool NR_superLU_reuse_ordering INIT(true);	/**< Newton-Raphson related - reuse the superLU column ordering and elimination tree while the matrix sparsity pattern is unchanged */
+GLOBAL int NR_island_threadcount INIT(1);			/**< Newton-Raphson related - number of threads solving islands concurrently (0 uses threadcount, 1 solves them one at a time) */
 GLOBAL TIMESTAMP NR_retval INIT(TS_NEVER);			/**< Newton-Raphson current return value - if t0 objects know we aren't going anywhere */
 GLOBAL OBJECT *NR_swing_bus INIT(NULL);				/**< Newton-Raphson swing bus */
 GLOBAL int NR_swing_bus_reference INIT(-1);			/**< Newton-Raphson swing bus index reference in NR_busdata */
 GLOBAL int64 NR_delta_iteration_limit INIT(10);		/**< Newton-Raphson iteration limit (per deltamode timestep) */
 GLOBAL bool FBS_swing_set INIT(false);				/**< Forward-Back Sweep swing assignment variable */
+GLOBAL bool FBS_array_solver INIT(false);			/**< Forward-Back Sweep related - sweep flat bus/branch arrays to convergence in one sync call */
+GLOBAL int64 FBS_iteration_limit INIT(100);		/**< Forward-Back Sweep related - array solver iteration limit (per GridLAB-D iteration) */
+GLOBAL int FBS_feeder_threadcount INIT(1);			/**< Forward-Back Sweep related - number of threads sweeping feeders concurrently (0 uses threadcount, 1 sweeps them one at a time) */
+GLOBAL int64 FBS_iteration_count INIT(0);			/**< Forward-Back Sweep related - sweeps done by the last array solve (largest over the feeders) */
+GLOBAL double FBS_voltage_mismatch INIT(0.0);		/**< Forward-Back Sweep related - largest voltage change on the last sweep of the last array solve */
+GLOBAL bool line_impedance_cache INIT(true);			/**< share per-mile line impedances between lines with the same configuration */
 GLOBAL bool show_matrix_values INIT(false);			/**< flag to enable dumping matrix calculations as they occur */
 GLOBAL double primary_voltage_ratio INIT(60.0);		/**< primary voltage ratio (@todo explain primary_voltage_ratio in powerflow (ticket #131) */
 GLOBAL double nominal_frequency INIT(60.0);			/**< nomimal operating frequencty */
@@ -29,7 +29,7 @@ regulator_configuration::regulator_configuration(MODULE *mod) : powerflow_librar
 	if (oclass==NULL)
 	{
 		// register the class definition
-		oclass = gl_register_class(mod,"regulator_configuration",sizeof(regulator_configuration),0x00);
+		oclass = gl_register_class(mod,"regulator_configuration",sizeof(regulator_configuration),PC_PARALLEL_INIT);
 		if (oclass==NULL)
 			throw "unable to register class regulator_configuration";
 		else
@@ -44,6 +44,7 @@ restoration::restoration(MODULE *mod) : powerflow_library(mod)
 			PT_double,"upper_voltage_limit[pu]",PADDR(voltage_limit[1]),PT_DESCRIPTION,"Upper voltage limit for the reconfiguration validity checks - per unit",
 			PT_char1024,"output_filename",PADDR(logfile_name),PT_DESCRIPTION,"Output text file name to describe final or attempted switching operations",
 			PT_bool,"generate_all_scenarios",PADDR(stop_and_generate),PT_DESCRIPTION,"Flag to determine if restoration reconfiguration and continues, or explores the full space",
+			PT_bool,"warm_start",PADDR(warm_start),PT_DESCRIPTION,"Flag to start each candidate powerflow from the pre-restoration solution, rather than from nominal voltages",
 			NULL) < 1) GL_THROW("unable to publish properties in %s",__FILE__);
 
 		if (gl_publish_function(oclass,	"perform_restoration", (FUNCTIONADDR)perform_restoration)==NULL)
@@ -63,6 +64,7 @@ int restoration::create(void)
 	file_output_desired = false;	//By default, no output
 
 	stop_and_generate = false;		//By default, just reconfigure until we're happy
+	warm_start = true;				//By default, start candidates from the pre-restoration solution
 
 	feeder_power_limit = NULL;
 	microgrid_limit = NULL;
@@ -2378,7 +2380,6 @@ void restoration::renewFaultLocation(BRANCHVERTICES *faultsection)
 int restoration::spanningTreeSearch(void)
 {
 	int idx, counter, preCounter, feederID, feeder_overloaded, k, tvi, startIdx, allocsize;
-	int powerflow_result;
 	CHORDSET FCutSet, FCutSet_1, FCutSet_2, FCutSet_2_1, FCutSet_2_2, new_tie_swi;
 	BRANCHVERTICES FCutSetentry, FCutSet_1entry, FCutSet_2entry;
 	BRANCHVERTICES SW_to_Open, SW_to_Open_1, SW_to_Open_2;
@@ -2492,49 +2493,12 @@ int restoration::spanningTreeSearch(void)
 		if (candidateSwOpe.data_5[counter] == 0)
 		{
 			//Adjustment from WSU code below - just run a powerflow
-			//If it fails, then modifyModel again (should de-toggle all of what was just toggled)
-
-				//Initialize storage variables, in case we fail
-				overLoad = 0.0;
-				feederID = 0;
-
-				//Perform the modification
-				modifyModel(counter);
-
-				// Run power flow
-				powerflow_result = runPowerFlow();
-				
-				//See if it even worked -- if not, modifyModel again and set as a "false"
-				if (powerflow_result == -1)
-				{
-					return -2;	//Serious error occurred, so flag us as "really bad"
-					//basically, the state of the system may be corrupted, so any subsequent powerflows can't be trusted
-				}
-				else if (powerflow_result == 0)
-				{
-					//Call the modify function again, to undo what we just did
-					modifyModel(counter);
-
-					//Set us as invalid
-					feasible=false;
-
-					//Restore voltage for next pass
-					PowerflowRestore();
-				}
-				else	//Success!?
-				{
-					//Check results
-					checkPF2(&feasible, &overLoad, &feederID);
-
-					//Check feasible again -- if not feasible, undo the operations again
-					if (feasible==false)
-					{
-						modifyModel(counter);	//Undo it by calling it again
-
-						//Restore voltage for next pass
-						PowerflowRestore();
-					}
-				}
+			//If it fails, evaluateCandidate undoes what it toggled
+			if (evaluateCandidate(counter, &feasible, &overLoad, &feederID) == -1)
+			{
+				return -2;	//Serious error occurred, so flag us as "really bad"
+				//basically, the state of the system may be corrupted, so any subsequent powerflows can't be trusted
+			}
 	        
 			// If feasible restoration scheme is found
 			if (feasible == true)
@@ -2688,44 +2652,12 @@ int restoration::spanningTreeSearch(void)
 		else
 		{
 			//Adjustment from WSU code below - just run a powerflow
-			//If it fails, then modifyModel again (should de-toggle all of what was just toggled)
-				//Perform the modification
-				modifyModel(counter);
-
-				// Run power flow
-				powerflow_result = runPowerFlow();
-				
-				//See if it even worked -- if not, modifyModel again and set as a "false"
-				if (powerflow_result == -1)
-				{
-					return -2;	//Serious error occurred, so flag us as "really bad"
-					//basically, the state of the system may be corrupted, so any subsequent powerflows can't be trusted
-				}
-				else if (powerflow_result == 0)
-				{
-					//Call the modify function again, to undo what we just did
-					modifyModel(counter);
-
-					//Set us as invalid
-					feasible=false;
-
-					//Restore voltage for next pass
-					PowerflowRestore();
-				}
-				else	//Success!?
-				{
-					//Check results
-					checkPF2(&feasible, &overLoad, &feederID);
-
-					//Check feasible again -- if not feasible, undo the operations again
-					if (feasible==false)
-					{
-						modifyModel(counter);	//Undo it by calling it again
-
-						//Restore voltage for next pass
-						PowerflowRestore();
-					}
-				}
+			//If it fails, evaluateCandidate undoes what it toggled
+			if (evaluateCandidate(counter, &feasible, &overLoad, &feederID) == -1)
+			{
+				return -2;	//Serious error occurred, so flag us as "really bad"
+				//basically, the state of the system may be corrupted, so any subsequent powerflows can't be trusted
+			}
 	        
 			// If feasible restoration scheme is found
 			if (feasible == true)
@@ -3326,6 +3258,64 @@ int restoration::runPowerFlow(void)
 	return overallresult;
 }
 
+//Evaluate a candidate switching operation
+//Switches the model to the candidate, solves it from the start voltages, and checks the results
+//Infeasible candidates are switched back (and the pre-restoration voltages restored) before returning
+//
+//Candidates are evaluated one at a time, in place, on the shared model - this only picks the start point (see warm_start)
+//They can't run concurrently: switching a candidate changes the switch objects and rewrites NR_busdata/NR_branchdata
+//phases, and solver_nr works off shared globals (NR_admit_change, NR_islands_detected) and link-owned admittance matrices
+//
+//Return codes - -1 = error (model state can't be trusted), 0 = powerflow failed, 1 = powerflow solved (see feasible)
+int restoration::evaluateCandidate(int counter, bool *feasible, double *overLoad, int *feederID)
+{
+	int powerflow_result;
+
+	//Initialize storage variables, in case we fail
+	*feasible = false;
+	*overLoad = 0.0;
+	*feederID = 0;
+
+	//Perform the modification
+	modifyModel(counter);
+
+	//Set the starting point
+	PowerflowStart();
+
+	// Run power flow
+	powerflow_result = runPowerFlow();
+
+	//See if it even worked -- if not, modifyModel again and set as a "false"
+	if (powerflow_result == -1)
+	{
+		return -1;	//Serious error occurred -- the state of the system may be corrupted
+	}
+	else if (powerflow_result == 0)
+	{
+		//Call the modify function again, to undo what we just did
+		modifyModel(counter);
+
+		//Restore voltage for next pass
+		PowerflowRestore();
+	}
+	else	//Success!?
+	{
+		//Check results
+		checkPF2(feasible, overLoad, feederID);
+
+		//Check feasible again -- if not feasible, undo the operations again
+		if (*feasible == false)
+		{
+			modifyModel(counter);	//Undo it by calling it again
+
+			//Restore voltage for next pass
+			PowerflowRestore();
+		}
+	}
+
+	return powerflow_result;
+}
+
 //Function to check the results of the powerflow solution
 void restoration::checkPF2(bool *flag, double *overLoad, int *feederID)
 {
@@ -3917,18 +3907,11 @@ void restoration::PowerflowSave(void)
 	//See if we're already allocated - we shouldn't be, but check
 	if (voltage_storage != NULL)
 	{
-		//Loop and free our components first
-		for (indexval=0; indexval<NR_bus_count; indexval++)
-		{
-			gl_free(voltage_storage[indexval]);
-		}
-
-		//Free us up too
 		gl_free(voltage_storage);
 	}
 
-	//Allocate us
-	voltage_storage = (complex **)gl_malloc(NR_bus_count*sizeof(complex *));
+	//Allocate us - one block, 3 entries per bus
+	voltage_storage = (complex *)gl_malloc(3*NR_bus_count*sizeof(complex));
 
 	//Make sure it worked
 	if (voltage_storage == NULL)
@@ -3941,23 +3924,12 @@ void restoration::PowerflowSave(void)
 		*/
 	}
 
-	//Now loop for allocate/copy
+	//Copy the voltage values
 	for (indexval=0; indexval<NR_bus_count; indexval++)
 	{
-		//Allocate this entry
-		voltage_storage[indexval] = (complex *)gl_malloc(3*sizeof(complex));
-
-		//Check it
-		if (voltage_storage[indexval] == NULL)
-		{
-			GL_THROW("Restoration: failed to allocate memory for base voltage values!");
-			//Defined above
-		}
-
-		//Copy the voltage values
-		voltage_storage[indexval][0] = NR_busdata[indexval].V[0];
-		voltage_storage[indexval][1] = NR_busdata[indexval].V[1];
-		voltage_storage[indexval][2] = NR_busdata[indexval].V[2];
+		voltage_storage[3*indexval] = NR_busdata[indexval].V[0];
+		voltage_storage[3*indexval+1] = NR_busdata[indexval].V[1];
+		voltage_storage[3*indexval+2] = NR_busdata[indexval].V[2];
 	}
 }
 
@@ -3969,9 +3941,69 @@ void restoration::PowerflowRestore(void)
 	//Loop through and put the values back
 	for (indexval=0; indexval<NR_bus_count; indexval++)
 	{
-		NR_busdata[indexval].V[0] = voltage_storage[indexval][0];
-		NR_busdata[indexval].V[1] = voltage_storage[indexval][1];
-		NR_busdata[indexval].V[2] = voltage_storage[indexval][2];
+		NR_busdata[indexval].V[0] = voltage_storage[3*indexval];
+		NR_busdata[indexval].V[1] = voltage_storage[3*indexval+1];
+		NR_busdata[indexval].V[2] = voltage_storage[3*indexval+2];
+	}
+}
+
+//Sets the starting voltages for a candidate powerflow, once its switching is done
+//Warm start uses the pre-restoration solution, except on phases the candidate energizes
+//that were dead (under 1% of nominal) in it -- those start at nominal, like a flat start does for all phases
+void restoration::PowerflowStart(void)
+{
+	unsigned int indexval;
+	int phaseidx;
+	unsigned char phasebits;
+	double angleval;
+	bool flat_phase;
+
+	for (indexval=0; indexval<NR_bus_count; indexval++)
+	{
+		//Start from the saved values
+		NR_busdata[indexval].V[0] = voltage_storage[3*indexval];
+		NR_busdata[indexval].V[1] = voltage_storage[3*indexval+1];
+		NR_busdata[indexval].V[2] = voltage_storage[3*indexval+2];
+
+		phasebits = NR_busdata[indexval].phases;
+
+		if ((phasebits & 0x80) == 0x80)	//Triplex - both legs at the angle of the phase it is on
+		{
+			if ((phasebits & 0x07) == 0x00)	//Not energized by this candidate
+				continue;
+
+			if ((NR_busdata[indexval].origphases & 0x04) == 0x04)
+				angleval = 0.0;
+			else if ((NR_busdata[indexval].origphases & 0x02) == 0x02)
+				angleval = -2.0*PI/3.0;
+			else
+				angleval = 2.0*PI/3.0;
+
+			for (phaseidx=0; phaseidx<2; phaseidx++)
+			{
+				flat_phase = (warm_start == false) || (NR_busdata[indexval].V[phaseidx].Mag() < (0.01*NR_busdata[indexval].volt_base));
+
+				if (flat_phase == true)
+				{
+					NR_busdata[indexval].V[phaseidx].SetPolar(NR_busdata[indexval].volt_base,angleval);
+				}
+			}
+		}
+		else	//"Normal" - A, B, and C
+		{
+			for (phaseidx=0; phaseidx<3; phaseidx++)
+			{
+				if ((phasebits & (0x04 >> phaseidx)) == 0x00)	//Phase not energized by this candidate
+					continue;
+
+				flat_phase = (warm_start == false) || (NR_busdata[indexval].V[phaseidx].Mag() < (0.01*NR_busdata[indexval].volt_base));
+
+				if (flat_phase == true)
+				{
+					NR_busdata[indexval].V[phaseidx].SetPolar(NR_busdata[indexval].volt_base,-2.0*PI/3.0*phaseidx);
+				}
+			}
+		}
 	}
 }
 
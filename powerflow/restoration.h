@@ -195,6 +195,8 @@ public:
 	bool stop_and_generate;				//Flag to either perform the base-WSU functionality (check all scenarios), or to just do a "first solution exit" approach
 										//False = GLD approach (exit when first valid reconfig found), true = WSU MATLAB (generate all)
 
+	bool warm_start;					//Flag to start each candidate powerflow from the pre-restoration solution (true) or from nominal voltages (false)
+
 	//I/O functions for GLD Interface
 	int PerformRestoration(int faulting_link);	//Base function - similar to main class of MATLAB (called by fault_check)
 
@@ -264,11 +266,12 @@ private:
 	CANDSWOP candidateSwOpe_1;			//Candidate switching operations on top_sim_1
 	CANDSWOP candidateSwOpe_2;			//Candidate switching operations on top_sim_2
 
-	complex **voltage_storage;			//Voltage storage - to restore when powerflow dies a horrible death
+	complex *voltage_storage;			//Voltage storage - to restore when powerflow dies a horrible death - 3 per bus, in NR_busdata order
 
 	//Voltage saving (value saving) functions
 	void PowerflowSave(void);
 	void PowerflowRestore(void);
+	void PowerflowStart(void);
 
 	//General parsing functions
 	double *ParseDoubleString(char *input_string,int *num_items_found);
@@ -309,6 +312,7 @@ private:
 	void CHORDSETintersect(CHORDSET *set_1, CHORDSET *set_2, CHORDSET *intersect);
 	void modifyModel(int counter);
 	int runPowerFlow(void);
+	int evaluateCandidate(int counter, bool *feasible, double *overLoad, int *feederID);
 	void checkPF2(bool *flag, double *overLoad, int *feederID);
 	bool checkVoltage(void);
 	void checkFeederPower(bool *fFlag, double *overLoad, int *feederID);
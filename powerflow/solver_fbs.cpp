@@ -0,0 +1,673 @@
+/* $Id
+ * Array-based Forward-Back Sweep solver
+ *
+ * The rank-based FBS does one backward sweep (link and node sync) and one
+ * forward sweep (link postsync) per core iteration, so converging takes as
+ * many core iterations as sweeps.  When FBS_array_solver is set, the swing
+ * bus builds flat arrays of the buses and branches it feeds, in topological
+ * order, the first time it presyncs.  On every sync it sweeps them to
+ * convergence itself, and the nodes and links in the arrays leave their
+ * FBS currents alone in their own syncs.
+ *
+ * Every branch (or child node) leaving the swing bus starts a feeder.  The
+ * swing voltage is fixed during the sweeps, so the feeders are independent
+ * and FBS_feeder_threadcount threads can sweep them at the same time.
+ */
+
+#include <pthread.h>
+
+#include "powerflow.h"
+#include "node.h"
+#include "link.h"
+
+static FBS_BUSDATA *FBS_busdata = NULL;			//Buses - the swing first, then each feeder in topological order
+static unsigned int FBS_bus_count = 0;
+static FBS_BRANCHDATA *FBS_branchdata = NULL;	//Branches - in the order of the buses they feed
+static unsigned int FBS_branch_count = 0;
+static FBS_FEEDER *FBS_feeders = NULL;			//Feeders - contiguous ranges of FBS_busdata
+static unsigned int FBS_feeder_count = 0;
+
+//Topology edge - a branch, or a parent-child relationship between nodes (lnk is NULL)
+typedef struct {
+	OBJECT *to;
+	OBJECT *lnk;
+	int next;
+} FBS_EDGE;
+
+//Feeder job - shared by the threads sweeping feeders
+typedef struct {
+	unsigned int thread_count;		//Number of threads (including the calling one) working on the feeders
+	unsigned int next_feeder;		//Next feeder waiting for a thread
+	int failed_feeder;				//Lowest feeder that threw an exception (-1 for none)
+	char failed_msg[1024];			//Exception message of failed_feeder
+} FBS_FEEDER_JOB;
+
+//Feeder thread information - index to compare against the job's thread count and the last job generation seen
+typedef struct {
+	unsigned int index;
+	unsigned int generation;
+} FBS_FEEDER_THREAD;
+
+//Feeder threads are started on first use and parked between solver_fbs calls
+static pthread_mutex_t FBS_feeder_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t FBS_feeder_pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t FBS_feeder_pool_done = PTHREAD_COND_INITIALIZER;
+static unsigned int FBS_feeder_pool_size = 0;		//Number of feeder threads started
+static unsigned int FBS_feeder_pool_busy = 0;		//Number of feeder threads still on the current job
+static unsigned int FBS_feeder_pool_generation = 0;	//Incremented with every job, so parked threads can tell a new one arrived
+static FBS_FEEDER_JOB *FBS_feeder_pool_job = NULL;	//Current job
+
+//Adds a bus to the arrays - returns its index
+static int solver_fbs_add_bus(OBJECT *obj, int branch, int parent, int *bus_index)
+{
+	FBS_BUSDATA *bus_data = &FBS_busdata[FBS_bus_count];
+
+	OBJECTDATA(obj,node)->FBS_populate(bus_data);
+	bus_data->I_ext[0] = bus_data->I_ext[1] = bus_data->I_ext[2] = complex(0,0);
+	bus_data->branch = branch;
+	bus_data->parent = parent;
+	bus_index[obj->id] = FBS_bus_count;
+
+	return FBS_bus_count++;
+}
+
+/** Builds the bus and branch arrays of everything the swing bus feeds
+	@return 1 on success, 0 if the arrays can't be used (the rank-based sweep is used instead)
+ **/
+int solver_fbs_init(OBJECT *swing)
+{
+	FINDLIST *pf_objects;
+	OBJECT *obj, *par;
+	FBS_EDGE *edges = NULL;
+	int *first_edge = NULL;
+	int *bus_index = NULL;
+	unsigned int object_count, edge_count, pf_count;
+	unsigned int index, queue;
+	int edge, walk;
+	OBJECT *loop_obj = NULL;
+
+	object_count = gl_get_object_count();
+
+	pf_objects = gl_find_objects(FL_NEW,FT_MODULE,SAME,"powerflow",FT_END);
+
+	if (pf_objects == NULL)
+	{
+		return 0;	//Nothing to sweep, the swing bus will find itself alone
+	}
+
+	pf_count = pf_objects->hit_count;
+
+	//Allocate the topology and the arrays - no more buses, branches or feeders than powerflow objects
+	edges = (FBS_EDGE *)gl_malloc(pf_count*sizeof(FBS_EDGE));
+	first_edge = (int *)gl_malloc(object_count*sizeof(int));
+	bus_index = (int *)gl_malloc(object_count*sizeof(int));
+	FBS_busdata = (FBS_BUSDATA *)gl_malloc(pf_count*sizeof(FBS_BUSDATA));
+	FBS_branchdata = (FBS_BRANCHDATA *)gl_malloc(pf_count*sizeof(FBS_BRANCHDATA));
+	FBS_feeders = (FBS_FEEDER *)gl_malloc(pf_count*sizeof(FBS_FEEDER));
+
+	if ((edges == NULL) || (first_edge == NULL) || (bus_index == NULL) || (FBS_busdata == NULL) || (FBS_branchdata == NULL) || (FBS_feeders == NULL))
+	{
+		gl_warning("FBS: unable to allocate the sweep arrays, using the rank-based sweep");
+		/*  TROUBLESHOOT
+		While building the bus and branch arrays for FBS_array_solver, memory could not be allocated.  The forward-back
+		sweep is done by the objects' own syncs instead, which gives the same answer in more core iterations.
+		*/
+		goto fail;
+	}
+
+	for (index=0; index<object_count; index++)
+	{
+		first_edge[index] = -1;
+		bus_index[index] = -1;
+	}
+
+	//Links point from their from node to their to node, child nodes hang off their parent node
+	edge_count = 0;
+	obj = NULL;
+	while ((obj=gl_find_next(pf_objects,obj)) != NULL)
+	{
+		if (gl_object_isa(obj,"link","powerflow"))
+		{
+			link_object *lnk = OBJECTDATA(obj,link_object);
+
+			if ((lnk->from == NULL) || (lnk->to == NULL))
+				continue;
+
+			par = lnk->from;
+			edges[edge_count].to = lnk->to;
+			edges[edge_count].lnk = obj;
+		}
+		else if (gl_object_isa(obj,"node","powerflow") && (obj->parent != NULL) && gl_object_isa(obj->parent,"node","powerflow"))
+		{
+			par = obj->parent;
+			edges[edge_count].to = obj;
+			edges[edge_count].lnk = NULL;
+		}
+		else
+			continue;
+
+		edges[edge_count].next = first_edge[par->id];
+		first_edge[par->id] = edge_count;
+		edge_count++;
+	}
+
+	//Breadth-first from the swing bus, one feeder at a time, so each feeder is contiguous and topologically ordered
+	FBS_bus_count = FBS_branch_count = FBS_feeder_count = 0;
+	solver_fbs_add_bus(swing,-1,-1,bus_index);
+
+	for (edge=first_edge[swing->id]; edge>=0; edge=edges[edge].next)
+	{
+		FBS_FEEDER *feeder = &FBS_feeders[FBS_feeder_count++];
+		feeder->first_bus = FBS_bus_count;
+
+		//Root bus of the feeder
+		if (bus_index[edges[edge].to->id] >= 0)
+		{
+			loop_obj = edges[edge].to;
+			goto fail;
+		}
+		if (edges[edge].lnk != NULL)
+		{
+			FBS_branchdata[FBS_branch_count].lnk = OBJECTDATA(edges[edge].lnk,link_object);
+			FBS_branchdata[FBS_branch_count].obj = edges[edge].lnk;
+			FBS_branchdata[FBS_branch_count].from = 0;
+			FBS_branchdata[FBS_branch_count].to = FBS_bus_count;
+			solver_fbs_add_bus(edges[edge].to,FBS_branch_count++,-1,bus_index);
+		}
+		else
+			solver_fbs_add_bus(edges[edge].to,-1,0,bus_index);
+
+		//Expand the queue until the feeder is exhausted
+		for (queue=feeder->first_bus; queue<FBS_bus_count; queue++)
+		{
+			OBJECT *bus_obj = FBS_busdata[queue].obj;
+
+			for (walk=first_edge[bus_obj->id]; walk>=0; walk=edges[walk].next)
+			{
+				if (bus_index[edges[walk].to->id] >= 0)	//Reached twice - not radial
+				{
+					loop_obj = edges[walk].to;
+					goto fail;
+				}
+
+				if (edges[walk].lnk != NULL)
+				{
+					FBS_branchdata[FBS_branch_count].lnk = OBJECTDATA(edges[walk].lnk,link_object);
+					FBS_branchdata[FBS_branch_count].obj = edges[walk].lnk;
+					FBS_branchdata[FBS_branch_count].from = queue;
+					FBS_branchdata[FBS_branch_count].to = FBS_bus_count;
+					solver_fbs_add_bus(edges[walk].to,FBS_branch_count++,-1,bus_index);
+				}
+				else
+					solver_fbs_add_bus(edges[walk].to,-1,queue,bus_index);
+			}
+		}
+
+		feeder->last_bus = FBS_bus_count;
+		feeder->iteration_count = 0;
+		feeder->max_mismatch = 0.0;
+		feeder->converged = false;
+	}
+
+	//Let the links know they are swept here (the nodes were flagged as they were added)
+	for (index=0; index<FBS_branch_count; index++)
+		FBS_branchdata[index].lnk->FBS_array_branch = true;
+
+	gl_verbose("FBS: sweeping %d buses and %d branches on %d feeders from %s",FBS_bus_count,FBS_branch_count,FBS_feeder_count,swing->name?swing->name:"the swing bus");
+
+	gl_free(edges);
+	gl_free(first_edge);
+	gl_free(bus_index);
+	gl_free(pf_objects);
+	return 1;
+
+fail:
+	if (loop_obj != NULL)
+	{
+		gl_warning("FBS: %s is reached twice from the swing bus, using the rank-based sweep",loop_obj->name?loop_obj->name:"a node");
+		/*  TROUBLESHOOT
+		FBS_array_solver only handles radial systems, where every node is fed by exactly one link or parent node.  A node
+		was found on two paths from the swing bus, so the forward-back sweep is done by the objects' own syncs instead.
+		*/
+	}
+
+	//Nobody is swept here after all
+	for (index=0; index<FBS_bus_count; index++)
+		FBS_busdata[index].bus->FBS_array_bus = false;
+
+	FBS_array_solver = false;
+	FBS_bus_count = FBS_branch_count = FBS_feeder_count = 0;
+
+	if (edges != NULL) gl_free(edges);
+	if (first_edge != NULL) gl_free(first_edge);
+	if (bus_index != NULL) gl_free(bus_index);
+	if (FBS_busdata != NULL) gl_free(FBS_busdata);
+	if (FBS_branchdata != NULL) gl_free(FBS_branchdata);
+	if (FBS_feeders != NULL) gl_free(FBS_feeders);
+	FBS_busdata = NULL;
+	FBS_branchdata = NULL;
+	FBS_feeders = NULL;
+	gl_free(pf_objects);
+	return 0;
+}
+
+//Sweeps one feeder until every bus voltage moves less than its maximum_voltage_error, or FBS_iteration_limit is reached
+static void solver_fbs_feeder(FBS_FEEDER *feeder)
+{
+	unsigned int index;
+	int64 iteration_limit, iteration;
+	FBS_BUSDATA *bus_data, *parent_data;
+	FBS_BRANCHDATA *branch_data;
+	link_object *lnk;
+	complex *Vf, *Vt, *It;
+	double sync_V;
+
+	iteration_limit = (FBS_iteration_limit > 0) ? FBS_iteration_limit : 1;
+
+	for (iteration=1; iteration<=iteration_limit; iteration++)
+	{
+		//Backward sweep - start from what the objects outside the sweep posted
+		for (index=feeder->first_bus; index<feeder->last_bus; index++)
+		{
+			bus_data = &FBS_busdata[index];
+			bus_data->I[0] = bus_data->I_ext[0];
+			bus_data->I[1] = bus_data->I_ext[1];
+			bus_data->I[2] = bus_data->I_ext[2];
+		}
+
+		//Each bus has everything downstream of it by the time it is reached
+		for (index=feeder->last_bus; index-- > feeder->first_bus; )
+		{
+			bus_data = &FBS_busdata[index];
+
+			//Our own loads
+			bus_data->bus->FBS_load_current();
+
+			if (bus_data->branch >= 0)	//Fed by a link - same as link_object::sync
+			{
+				branch_data = &FBS_branchdata[bus_data->branch];
+				lnk = branch_data->lnk;
+
+				if (lnk->is_closed())
+				{
+					Vt = bus_data->V;
+					It = bus_data->I;
+
+					lnk->current_in[0] = 
+						lnk->c_mat[0][0] * Vt[0] +
+						lnk->c_mat[0][1] * Vt[1] +
+						lnk->c_mat[0][2] * Vt[2] +
+						lnk->d_mat[0][0] * It[0] +
+						lnk->d_mat[0][1] * It[1] +
+						lnk->d_mat[0][2] * It[2];
+					lnk->current_in[1] = 
+						lnk->c_mat[1][0] * Vt[0] +
+						lnk->c_mat[1][1] * Vt[1] +
+						lnk->c_mat[1][2] * Vt[2] +
+						lnk->d_mat[1][0] * It[0] +
+						lnk->d_mat[1][1] * It[1] +
+						lnk->d_mat[1][2] * It[2];
+					lnk->current_in[2] = 
+						lnk->c_mat[2][0] * Vt[0] +
+						lnk->c_mat[2][1] * Vt[1] +
+						lnk->c_mat[2][2] * Vt[2] +
+						lnk->d_mat[2][0] * It[0] +
+						lnk->d_mat[2][1] * It[1] +
+						lnk->d_mat[2][2] * It[2];
+
+					//The swing bus collects the feeders once they are done, so feeders never share a bus
+					if (branch_data->from > 0)
+					{
+						parent_data = &FBS_busdata[branch_data->from];
+						parent_data->I[0] += lnk->current_in[0];
+						parent_data->I[1] += lnk->current_in[1];
+						parent_data->I[2] += lnk->current_in[2];
+					}
+				}
+			}
+			else if (bus_data->parent > 0)	//Child node - same as node::sync
+			{
+				parent_data = &FBS_busdata[bus_data->parent];
+				parent_data->I[0] += bus_data->I[0];
+				parent_data->I[1] += bus_data->I[1];
+				parent_data->I[2] += bus_data->I[2];
+			}
+		}
+
+		//Forward sweep - voltages flow from the swing bus out
+		feeder->max_mismatch = 0.0;
+		feeder->converged = true;
+
+		for (index=feeder->first_bus; index<feeder->last_bus; index++)
+		{
+			bus_data = &FBS_busdata[index];
+
+			//Remember the voltage of the last sweep, so the nodes' own convergence check agrees with ours
+			bus_data->last_V[0] = bus_data->V[0];
+			bus_data->last_V[1] = bus_data->V[1];
+			bus_data->last_V[2] = bus_data->V[2];
+
+			if (bus_data->branch >= 0)	//Fed by a link - same as link_object::postsync
+			{
+				branch_data = &FBS_branchdata[bus_data->branch];
+				lnk = branch_data->lnk;
+
+				if (!lnk->is_open())
+				{
+					Vf = FBS_busdata[branch_data->from].V;
+					It = bus_data->I;
+
+					bus_data->V[0] = 
+						lnk->A_mat[0][0] * Vf[0] +
+						lnk->A_mat[0][1] * Vf[1] +
+						lnk->A_mat[0][2] * Vf[2] -
+						lnk->B_mat[0][0] * It[0] -
+						lnk->B_mat[0][1] * It[1] -
+						lnk->B_mat[0][2] * It[2];
+					bus_data->V[1] = 
+						lnk->A_mat[1][0] * Vf[0] +
+						lnk->A_mat[1][1] * Vf[1] +
+						lnk->A_mat[1][2] * Vf[2] -
+						lnk->B_mat[1][0] * It[0] -
+						lnk->B_mat[1][1] * It[1] -
+						lnk->B_mat[1][2] * It[2];
+					bus_data->V[2] = 
+						lnk->A_mat[2][0] * Vf[0] +
+						lnk->A_mat[2][1] * Vf[1] +
+						lnk->A_mat[2][2] * Vf[2] -
+						lnk->B_mat[2][0] * It[0] -
+						lnk->B_mat[2][1] * It[1] -
+						lnk->B_mat[2][2] * It[2];
+				}
+			}
+			else if (bus_data->parent >= 0)	//Child node - copies its parent, same as node::postsync
+			{
+				parent_data = &FBS_busdata[bus_data->parent];
+				bus_data->V[0] = parent_data->V[0];
+				bus_data->V[1] = parent_data->V[1];
+				bus_data->V[2] = parent_data->V[2];
+			}
+
+			//Update appropriate "other" voltages - the loads use them on the next backward sweep
+			if (bus_data->split)
+			{	// split-tap voltage diffs are different
+				bus_data->Vd[0] = bus_data->V[0] + bus_data->V[1];	//V12
+				bus_data->Vd[1] = bus_data->V[1] - bus_data->V[2];	//V2N
+				bus_data->Vd[2] = bus_data->V[0] - bus_data->V[2];	//V1N
+			}
+			else
+			{	// compute 3phase voltage differences
+				bus_data->Vd[0] = bus_data->V[0] - bus_data->V[1];	//AB
+				bus_data->Vd[1] = bus_data->V[1] - bus_data->V[2];	//BC
+				bus_data->Vd[2] = bus_data->V[2] - bus_data->V[0];	//CA
+			}
+
+			//Compute the sync voltage change
+			sync_V = (bus_data->last_V[0]-bus_data->V[0]).Mag() + (bus_data->last_V[1]-bus_data->V[1]).Mag() + (bus_data->last_V[2]-bus_data->V[2]).Mag();
+
+			if (sync_V > bus_data->max_volt_error)
+				feeder->converged = false;
+
+			if (sync_V > feeder->max_mismatch)
+				feeder->max_mismatch = sync_V;
+		}
+
+		feeder->iteration_count = iteration;
+
+		if (feeder->converged == true)
+			break;
+	}
+}
+
+//Records an exception thrown while sweeping a feeder - only the lowest feeder's message is kept, so the error doesn't depend on thread timing
+static void solver_fbs_feeder_failed(FBS_FEEDER_JOB *job, unsigned int feeder_index, const char *msg)
+{
+	pthread_mutex_lock(&FBS_feeder_pool_mutex);
+	if ((job->failed_feeder < 0) || ((int)feeder_index < job->failed_feeder))
+	{
+		job->failed_feeder = feeder_index;
+		strncpy(job->failed_msg,msg,sizeof(job->failed_msg)-1);
+		job->failed_msg[sizeof(job->failed_msg)-1] = '\0';
+	}
+	pthread_mutex_unlock(&FBS_feeder_pool_mutex);
+}
+
+//Takes feeders off the job and sweeps each to completion, until none are left
+static void solver_fbs_feeder_work(FBS_FEEDER_JOB *job)
+{
+	unsigned int feeder_index;
+
+	while (true)
+	{
+		//Claim the next feeder
+		pthread_mutex_lock(&FBS_feeder_pool_mutex);
+		feeder_index = job->next_feeder++;
+		pthread_mutex_unlock(&FBS_feeder_pool_mutex);
+
+		if (feeder_index >= FBS_feeder_count)
+		{
+			break;
+		}
+
+		//Exceptions can't leave the thread, so hand them back to the solver
+		try {
+			solver_fbs_feeder(&FBS_feeders[feeder_index]);
+		}
+		catch (const char *msg)
+		{
+			solver_fbs_feeder_failed(job,feeder_index,msg);
+		}
+		catch (...)
+		{
+			solver_fbs_feeder_failed(job,feeder_index,"FBS: unknown exception while sweeping a feeder");
+		}
+	}
+}
+
+//Feeder thread - waits for a job, works on it, and parks again
+static void *solver_fbs_feeder_thread(void *arg)
+{
+	FBS_FEEDER_THREAD *thread_info = (FBS_FEEDER_THREAD *)arg;
+	FBS_FEEDER_JOB *job;
+
+	pthread_mutex_lock(&FBS_feeder_pool_mutex);
+	while (true)
+	{
+		//Wait for a new job
+		while (FBS_feeder_pool_generation == thread_info->generation)
+		{
+			pthread_cond_wait(&FBS_feeder_pool_start,&FBS_feeder_pool_mutex);
+		}
+		thread_info->generation = FBS_feeder_pool_generation;
+		job = FBS_feeder_pool_job;
+		pthread_mutex_unlock(&FBS_feeder_pool_mutex);
+
+		//Only help if this job wants this many threads
+		if (thread_info->index+1 < job->thread_count)
+		{
+			solver_fbs_feeder_work(job);
+		}
+
+		//Let the solver know we're done with the job
+		pthread_mutex_lock(&FBS_feeder_pool_mutex);
+		FBS_feeder_pool_busy--;
+		if (FBS_feeder_pool_busy == 0)
+		{
+			pthread_cond_signal(&FBS_feeder_pool_done);
+		}
+	}
+	return NULL;
+}
+
+//Sweeps the feeders of a job on the feeder threads - the calling thread sweeps feeders too
+static void solver_fbs_feeders_concurrent(FBS_FEEDER_JOB *job)
+{
+	FBS_FEEDER_THREAD *thread_info;
+	pthread_t thread_id;
+
+	pthread_mutex_lock(&FBS_feeder_pool_mutex);
+
+	//Start any threads we don't have yet
+	while (FBS_feeder_pool_size+1 < job->thread_count)
+	{
+		thread_info = (FBS_FEEDER_THREAD *)gl_malloc(sizeof(FBS_FEEDER_THREAD));
+
+		if (thread_info == NULL)
+		{
+			break;	//Make do with the threads we have
+		}
+
+		thread_info->index = FBS_feeder_pool_size;
+		thread_info->generation = FBS_feeder_pool_generation;
+
+		if (pthread_create(&thread_id,NULL,solver_fbs_feeder_thread,(void *)thread_info) != 0)
+		{
+			gl_free(thread_info);
+			break;	//Make do with the threads we have
+		}
+
+		pthread_detach(thread_id);
+		FBS_feeder_pool_size++;
+	}
+
+	//Hand the job out
+	FBS_feeder_pool_job = job;
+	FBS_feeder_pool_busy = FBS_feeder_pool_size;
+	FBS_feeder_pool_generation++;
+	pthread_cond_broadcast(&FBS_feeder_pool_start);
+	pthread_mutex_unlock(&FBS_feeder_pool_mutex);
+
+	solver_fbs_feeder_work(job);
+
+	//Wait for the feeder threads to be done with it
+	pthread_mutex_lock(&FBS_feeder_pool_mutex);
+	while (FBS_feeder_pool_busy > 0)
+	{
+		pthread_cond_wait(&FBS_feeder_pool_done,&FBS_feeder_pool_mutex);
+	}
+	FBS_feeder_pool_job = NULL;
+	pthread_mutex_unlock(&FBS_feeder_pool_mutex);
+}
+
+//Determines how many threads to sweep the feeders with - 1 sweeps them one at a time
+static unsigned int solver_fbs_threadcount(void)
+{
+	char temp_buff[64];
+	int thread_count;
+
+	if (FBS_feeder_count < 2)
+	{
+		return 1;
+	}
+
+	thread_count = FBS_feeder_threadcount;
+
+	//Zero uses the core thread count
+	if (thread_count == 0)
+	{
+		if (gl_global_getvar("threadcount",temp_buff,sizeof(temp_buff)) != NULL)
+		{
+			thread_count = atoi(temp_buff);
+		}
+	}
+
+	//No sense having more threads than feeders
+	if (thread_count > (int)FBS_feeder_count)
+	{
+		thread_count = FBS_feeder_count;
+	}
+
+	return (thread_count < 1) ? 1 : (unsigned int)thread_count;
+}
+
+/** Array-based Forward-Back Sweep solver
+	Sweeps every feeder of the swing bus to convergence, then adds the feeder
+	currents to the swing bus, which accumulates its own loads afterwards.
+	Called by the swing bus in its sync, once the objects in the arrays
+	have posted their loads.
+
+	@return n>0 to indicate convergence after n sweeps (largest over the feeders), or
+	n<0 to indicate failure after n sweeps
+ **/
+int64 solver_fbs(void)
+{
+	unsigned int index;
+	FBS_BUSDATA *swing_data, *bus_data;
+	FBS_BRANCHDATA *branch_data;
+	FBS_FEEDER_JOB job;
+	bool converged;
+
+	if (FBS_bus_count == 0)
+	{
+		return 0;
+	}
+
+	//Whatever is in the accumulators now was posted by objects the sweep doesn't solve
+	for (index=0; index<FBS_bus_count; index++)
+	{
+		bus_data = &FBS_busdata[index];
+		bus_data->I_ext[0] = bus_data->I[0];
+		bus_data->I_ext[1] = bus_data->I[1];
+		bus_data->I_ext[2] = bus_data->I[2];
+	}
+
+	job.thread_count = solver_fbs_threadcount();
+	job.next_feeder = 0;
+	job.failed_feeder = -1;
+	job.failed_msg[0] = '\0';
+
+	if (job.thread_count > 1)
+	{
+		solver_fbs_feeders_concurrent(&job);
+	}
+	else
+	{
+		solver_fbs_feeder_work(&job);
+	}
+
+	//Pass on the first exception a feeder threw
+	if (job.failed_feeder >= 0)
+	{
+		GL_THROW("%s",job.failed_msg);
+	}
+
+	//Collect the feeders on the swing bus and report the worst of them
+	swing_data = &FBS_busdata[0];
+	converged = true;
+	FBS_iteration_count = 0;
+	FBS_voltage_mismatch = 0.0;
+
+	for (index=0; index<FBS_feeder_count; index++)
+	{
+		bus_data = &FBS_busdata[FBS_feeders[index].first_bus];
+
+		if (bus_data->branch >= 0)
+		{
+			branch_data = &FBS_branchdata[bus_data->branch];
+
+			if (branch_data->lnk->is_closed())
+			{
+				swing_data->I[0] += branch_data->lnk->current_in[0];
+				swing_data->I[1] += branch_data->lnk->current_in[1];
+				swing_data->I[2] += branch_data->lnk->current_in[2];
+			}
+		}
+		else
+		{
+			swing_data->I[0] += bus_data->I[0];
+			swing_data->I[1] += bus_data->I[1];
+			swing_data->I[2] += bus_data->I[2];
+		}
+
+		if (FBS_feeders[index].converged == false)
+			converged = false;
+
+		if (FBS_feeders[index].iteration_count > FBS_iteration_count)
+			FBS_iteration_count = FBS_feeders[index].iteration_count;
+
+		if (FBS_feeders[index].max_mismatch > FBS_voltage_mismatch)
+			FBS_voltage_mismatch = FBS_feeders[index].max_mismatch;
+	}
+
+	return converged ? FBS_iteration_count : -FBS_iteration_count;
+}
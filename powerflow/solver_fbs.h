@@ -0,0 +1,46 @@
+/* $Id
+ * Array-based Forward-Back Sweep solver
+ */
+
+#ifndef _SOLVER_FBS
+#define _SOLVER_FBS
+
+#include "complex.h"
+#include "object.h"
+
+class node;
+class link_object;
+
+typedef struct {
+	node *bus;				///< node object
+	complex *V;				///< bus voltage
+	complex *Vd;			///< bus voltage differences
+	complex *last_V;		///< bus voltage before the last forward sweep (used by the node convergence check)
+	complex *I;				///< current injection accumulator
+	complex I_ext[3];		///< current injection posted by objects outside the sweep before it started
+	bool split;				///< split-phase node (different voltage differences)
+	double max_volt_error;	///< maximum voltage error specified for that node
+	int branch;				///< index of the branch feeding this bus, -1 if it is a child node or the swing
+	int parent;				///< index of the bus this one is a child of, -1 if it is fed by a branch or is the swing
+	OBJECT *obj;			///< Link to original object header
+} FBS_BUSDATA;
+
+typedef struct {
+	link_object *lnk;		///< link object
+	int from;				///< index into bus data
+	int to;					///< index into bus data
+	OBJECT *obj;			///< Link to original object header
+} FBS_BRANCHDATA;
+
+typedef struct {
+	unsigned int first_bus;		///< first bus of the feeder (buses are in topological order)
+	unsigned int last_bus;		///< one past the last bus of the feeder
+	int64 iteration_count;		///< sweeps done on the last solve
+	double max_mismatch;		///< largest voltage change on the last sweep
+	bool converged;				///< flag to indicate the last solve converged
+} FBS_FEEDER;
+
+int solver_fbs_init(OBJECT *swing);
+int64 solver_fbs(void);
+
+#endif
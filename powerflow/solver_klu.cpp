@@ -0,0 +1,578 @@
+/* $Id
+ * Built-in KLU-style sparse LU solver for the Newton-Raphson solver
+ *
+ * The columns are ordered by minimum degree on A'+A (using the superLU_MT ordering
+ * routines) and the matrix is factored with a left-looking (Gilbert-Peierls) LU.
+ * Pivots are chosen by partial pivoting that prefers the diagonal, which suits the
+ * nearly symmetric structure of the powerflow Jacobian.  The ordering, pivot sequence
+ * and factor structure are kept between calls, so while the sparsity pattern of the
+ * matrix stays the same, only a numeric refactorization is needed.
+ */
+
+#include "solver_klu.h"
+
+#include <slu_mt_ddefs.h>	//superLU_MT - column ordering routines
+
+/* access to module global variables */
+#include "powerflow.h"
+
+#define KLU_NR_PIVOT_TOLERANCE 0.001	//Diagonal pivot is used if within this fraction of the largest candidate
+
+//Grow one of the factor arrays, keeping its contents
+static bool klu_nr_grow(int **index_array, double **value_array, unsigned int *curr_size, unsigned int used, unsigned int needed)
+{
+	unsigned int new_size;
+	int *new_index;
+	double *new_value;
+
+	//See if there's already room
+	if (needed <= *curr_size)
+		return true;
+
+	new_size = 2*(*curr_size);
+	if (new_size < needed)
+		new_size = needed;
+
+	new_index = (int *)gl_malloc(new_size*sizeof(int));
+	new_value = (double *)gl_malloc(new_size*sizeof(double));
+
+	//Make sure it worked
+	if ((new_index == NULL) || (new_value == NULL))
+	{
+		if (new_index != NULL)
+			gl_free(new_index);
+
+		if (new_value != NULL)
+			gl_free(new_value);
+
+		return false;
+	}
+
+	//Copy over what's there
+	if (*index_array != NULL)
+	{
+		memcpy(new_index,*index_array,used*sizeof(int));
+		memcpy(new_value,*value_array,used*sizeof(double));
+		gl_free(*index_array);
+		gl_free(*value_array);
+	}
+
+	*index_array = new_index;
+	*value_array = new_value;
+	*curr_size = new_size;
+
+	return true;
+}
+
+//Free the pattern-dependent arrays
+static void klu_nr_clear(KLU_NR_vars *klu_vars)
+{
+	if (klu_vars->pattern_cols != NULL)
+		gl_free(klu_vars->pattern_cols);
+
+	if (klu_vars->pattern_rows != NULL)
+		gl_free(klu_vars->pattern_rows);
+
+	if (klu_vars->Q != NULL)
+		gl_free(klu_vars->Q);
+
+	if (klu_vars->Pinv != NULL)
+		gl_free(klu_vars->Pinv);
+
+	if (klu_vars->Lp != NULL)
+		gl_free(klu_vars->Lp);
+
+	if (klu_vars->Li != NULL)
+		gl_free(klu_vars->Li);
+
+	if (klu_vars->Lx != NULL)
+		gl_free(klu_vars->Lx);
+
+	if (klu_vars->Up != NULL)
+		gl_free(klu_vars->Up);
+
+	if (klu_vars->Ui != NULL)
+		gl_free(klu_vars->Ui);
+
+	if (klu_vars->Ux != NULL)
+		gl_free(klu_vars->Ux);
+
+	if (klu_vars->X != NULL)
+		gl_free(klu_vars->X);
+
+	if (klu_vars->W != NULL)
+		gl_free(klu_vars->W);
+
+	klu_vars->pattern_cols = NULL;
+	klu_vars->pattern_rows = NULL;
+	klu_vars->Q = NULL;
+	klu_vars->Pinv = NULL;
+	klu_vars->Lp = NULL;
+	klu_vars->Li = NULL;
+	klu_vars->Lx = NULL;
+	klu_vars->L_max = 0;
+	klu_vars->Up = NULL;
+	klu_vars->Ui = NULL;
+	klu_vars->Ux = NULL;
+	klu_vars->U_max = 0;
+	klu_vars->X = NULL;
+	klu_vars->W = NULL;
+	klu_vars->n = 0;
+	klu_vars->nnz = 0;
+	klu_vars->factored = false;
+}
+
+//Allocate the size-dependent arrays
+static bool klu_nr_setup(KLU_NR_vars *klu_vars, unsigned int n, int nnz)
+{
+	unsigned int index;
+
+	klu_nr_clear(klu_vars);
+
+	klu_vars->pattern_cols = (int *)gl_malloc((n+1)*sizeof(int));
+	klu_vars->pattern_rows = (int *)gl_malloc(nnz*sizeof(int));
+	klu_vars->Q = (int *)gl_malloc(n*sizeof(int));
+	klu_vars->Pinv = (int *)gl_malloc(n*sizeof(int));
+	klu_vars->Lp = (int *)gl_malloc((n+1)*sizeof(int));
+	klu_vars->Up = (int *)gl_malloc((n+1)*sizeof(int));
+	klu_vars->X = (double *)gl_malloc(n*sizeof(double));
+	klu_vars->W = (int *)gl_malloc(3*n*sizeof(int));
+
+	if ((klu_vars->pattern_cols == NULL) || (klu_vars->pattern_rows == NULL) || (klu_vars->Q == NULL) || (klu_vars->Pinv == NULL) ||
+		(klu_vars->Lp == NULL) || (klu_vars->Up == NULL) || (klu_vars->X == NULL) || (klu_vars->W == NULL))
+	{
+		klu_nr_clear(klu_vars);
+		return false;
+	}
+
+	//Initial guess at the factor sizes - they grow as needed
+	if (!klu_nr_grow(&klu_vars->Li,&klu_vars->Lx,&klu_vars->L_max,0,2*nnz+n) || !klu_nr_grow(&klu_vars->Ui,&klu_vars->Ux,&klu_vars->U_max,0,2*nnz+n))
+	{
+		klu_nr_clear(klu_vars);
+		return false;
+	}
+
+	//Work vector is kept zeroed
+	for (index=0; index<n; index++)
+	{
+		klu_vars->X[index] = 0.0;
+	}
+
+	klu_vars->n = n;
+	klu_vars->nnz = nnz;
+
+	return true;
+}
+
+//Compute the column ordering - minimum degree on A'+A
+static void klu_nr_order(KLU_NR_vars *klu_vars, NR_SOLVER_VARS *system_info_vars)
+{
+	SuperMatrix A_order;
+	NCformat A_store;
+	int *perm_c = klu_vars->W;	//Borrow the work space
+	unsigned int index;
+
+	A_store.nnz = klu_vars->nnz;
+	A_store.nzval = system_info_vars->a_LU;
+	A_store.rowind = system_info_vars->rows_LU;
+	A_store.colptr = system_info_vars->cols_LU;
+
+	A_order.Stype = SLU_NC;
+	A_order.Dtype = SLU_D;
+	A_order.Mtype = SLU_GE;
+	A_order.nrow = klu_vars->n;
+	A_order.ncol = klu_vars->n;
+	A_order.Store = &A_store;
+
+	get_perm_c(2, &A_order, perm_c);
+
+	//perm_c gives the position of each column - invert it to get the column for each step
+	for (index=0; index<klu_vars->n; index++)
+	{
+		klu_vars->Q[perm_c[index]] = index;
+	}
+}
+
+//Depth-first search of the graph of L from row start_row -- adds the rows reached to the top of the stack
+static int klu_nr_dfs(KLU_NR_vars *klu_vars, int start_row, int top, int mark_val)
+{
+	int *xi = klu_vars->W;
+	int *pstack = klu_vars->W + klu_vars->n;
+	int *mark = klu_vars->W + 2*klu_vars->n;
+	int head, row, col, indexp, pend;
+	bool done;
+
+	head = 0;
+	xi[0] = start_row;
+	while (head >= 0)
+	{
+		row = xi[head];
+		col = klu_vars->Pinv[row];
+		if (mark[row] != mark_val)
+		{
+			mark[row] = mark_val;
+			pstack[head] = (col < 0) ? 0 : klu_vars->Lp[col] + 1;	//Skip the unit diagonal
+		}
+
+		done = true;
+		pend = (col < 0) ? 0 : klu_vars->Lp[col+1];
+		for (indexp=pstack[head]; indexp<pend; indexp++)
+		{
+			if (mark[klu_vars->Li[indexp]] != mark_val)
+			{
+				pstack[head] = indexp + 1;
+				xi[++head] = klu_vars->Li[indexp];
+				done = false;
+				break;
+			}
+		}
+
+		if (done)
+		{
+			head--;
+			xi[--top] = row;
+		}
+	}
+
+	return top;
+}
+
+//Full factorization -- chooses the pivots and the structure of L and U
+//Returns 0 on success, or k+1 if column k of the ordered matrix is singular
+static int klu_nr_factor(KLU_NR_vars *klu_vars, int *Ap, int *Ai, double *Ax)
+{
+	int n = klu_vars->n;
+	int *xi = klu_vars->W;
+	int *mark = klu_vars->W + 2*n;
+	double *X = klu_vars->X;
+	int k, col, top, indexp, indexq, row, pcol, ipiv;
+	unsigned int lnz, unz;
+	double xval, absval, maxval, pivot;
+
+	for (row=0; row<n; row++)
+	{
+		klu_vars->Pinv[row] = -1;
+		mark[row] = -1;
+	}
+
+	lnz = unz = 0;
+	for (k=0; k<n; k++)
+	{
+		klu_vars->Lp[k] = lnz;
+		klu_vars->Up[k] = unz;
+
+		//Make sure there's room for the worst case of this column
+		if (!klu_nr_grow(&klu_vars->Li,&klu_vars->Lx,&klu_vars->L_max,lnz,lnz+n) || !klu_nr_grow(&klu_vars->Ui,&klu_vars->Ux,&klu_vars->U_max,unz,unz+n))
+		{
+			GL_THROW("NR: Failed to allocate memory for the KLU factorization");
+			/*  TROUBLESHOOT
+			While factoring the Newton-Raphson matrix with the built-in KLU solver, the memory for the
+			factors could not be allocated.  Please try again.  If the error persists, try using the superLU
+			solver or reduce the size of the model.
+			*/
+		}
+
+		//Find the nonzero pattern of this column of L and U
+		col = klu_vars->Q[k];
+		top = n;
+		for (indexp=Ap[col]; indexp<Ap[col+1]; indexp++)
+		{
+			if (mark[Ai[indexp]] != k)
+				top = klu_nr_dfs(klu_vars,Ai[indexp],top,k);
+		}
+
+		//Scatter the column and solve with the columns of L found so far
+		for (indexp=Ap[col]; indexp<Ap[col+1]; indexp++)
+		{
+			X[Ai[indexp]] = Ax[indexp];
+		}
+
+		for (indexp=top; indexp<n; indexp++)
+		{
+			row = xi[indexp];
+			pcol = klu_vars->Pinv[row];
+			if (pcol < 0)
+				continue;
+
+			xval = X[row];
+			for (indexq=klu_vars->Lp[pcol]+1; indexq<klu_vars->Lp[pcol+1]; indexq++)
+			{
+				X[klu_vars->Li[indexq]] -= klu_vars->Lx[indexq]*xval;
+			}
+		}
+
+		//Pull off the U part and find the largest pivot candidate
+		ipiv = -1;
+		maxval = -1.0;
+		for (indexp=top; indexp<n; indexp++)
+		{
+			row = xi[indexp];
+			if (klu_vars->Pinv[row] < 0)
+			{
+				absval = fabs(X[row]);
+				if (absval > maxval)
+				{
+					maxval = absval;
+					ipiv = row;
+				}
+			}
+			else
+			{
+				klu_vars->Ui[unz] = klu_vars->Pinv[row];
+				klu_vars->Ux[unz++] = X[row];
+			}
+		}
+
+		if ((ipiv < 0) || (maxval <= 0.0))
+		{
+			//Clean the work vector before leaving
+			for (indexp=top; indexp<n; indexp++)
+			{
+				X[xi[indexp]] = 0.0;
+			}
+			return k+1;
+		}
+
+		//Prefer the diagonal, if it is big enough
+		if ((klu_vars->Pinv[col] < 0) && (mark[col] == k) && (fabs(X[col]) >= KLU_NR_PIVOT_TOLERANCE*maxval))
+			ipiv = col;
+
+		//Diagonal of U goes last
+		pivot = X[ipiv];
+		klu_vars->Ui[unz] = k;
+		klu_vars->Ux[unz++] = pivot;
+		klu_vars->Pinv[ipiv] = k;
+
+		//Unit diagonal of L goes first
+		klu_vars->Li[lnz] = ipiv;
+		klu_vars->Lx[lnz++] = 1.0;
+		for (indexp=top; indexp<n; indexp++)
+		{
+			row = xi[indexp];
+			if (klu_vars->Pinv[row] < 0)
+			{
+				klu_vars->Li[lnz] = row;
+				klu_vars->Lx[lnz++] = X[row]/pivot;
+			}
+			X[row] = 0.0;
+		}
+	}
+
+	klu_vars->Lp[n] = lnz;
+	klu_vars->Up[n] = unz;
+
+	//Put L in pivot order
+	for (indexp=0; indexp<(int)lnz; indexp++)
+	{
+		klu_vars->Li[indexp] = klu_vars->Pinv[klu_vars->Li[indexp]];
+	}
+
+	klu_vars->factor_count++;
+	return 0;
+}
+
+//Numeric-only refactorization -- reuses the pivots and the structure of L and U
+//Returns false if a pivot has become too small, in which case a full factorization is needed
+static bool klu_nr_refactor(KLU_NR_vars *klu_vars, int *Ap, int *Ai, double *Ax)
+{
+	int n = klu_vars->n;
+	double *X = klu_vars->X;
+	int k, col, indexp, indexq, row, uend;
+	double xval, pivot, maxval, absval;
+
+	for (k=0; k<n; k++)
+	{
+		//Scatter the column in pivot order
+		col = klu_vars->Q[k];
+		for (indexp=Ap[col]; indexp<Ap[col+1]; indexp++)
+		{
+			X[klu_vars->Pinv[Ai[indexp]]] = Ax[indexp];
+		}
+
+		//Eliminate in the order recorded by the full factorization
+		uend = klu_vars->Up[k+1] - 1;
+		for (indexp=klu_vars->Up[k]; indexp<uend; indexp++)
+		{
+			row = klu_vars->Ui[indexp];
+			xval = X[row];
+			klu_vars->Ux[indexp] = xval;
+			X[row] = 0.0;
+			for (indexq=klu_vars->Lp[row]+1; indexq<klu_vars->Lp[row+1]; indexq++)
+			{
+				X[klu_vars->Li[indexq]] -= klu_vars->Lx[indexq]*xval;
+			}
+		}
+
+		pivot = X[k];
+		X[k] = 0.0;
+		klu_vars->Ux[uend] = pivot;
+
+		//Make sure the pivot is still acceptable
+		maxval = fabs(pivot);
+		for (indexq=klu_vars->Lp[k]+1; indexq<klu_vars->Lp[k+1]; indexq++)
+		{
+			absval = fabs(X[klu_vars->Li[indexq]]);
+			if (absval > maxval)
+				maxval = absval;
+		}
+
+		if ((pivot == 0.0) || (fabs(pivot) < KLU_NR_PIVOT_TOLERANCE*maxval))
+		{
+			for (indexq=klu_vars->Lp[k]+1; indexq<klu_vars->Lp[k+1]; indexq++)
+			{
+				X[klu_vars->Li[indexq]] = 0.0;
+			}
+			return false;
+		}
+
+		for (indexq=klu_vars->Lp[k]+1; indexq<klu_vars->Lp[k+1]; indexq++)
+		{
+			row = klu_vars->Li[indexq];
+			klu_vars->Lx[indexq] = X[row]/pivot;
+			X[row] = 0.0;
+		}
+	}
+
+	klu_vars->refactor_count++;
+	return true;
+}
+
+//Solve with the factors -- the solution overwrites rhs
+static void klu_nr_backsolve(KLU_NR_vars *klu_vars, double *rhs)
+{
+	int n = klu_vars->n;
+	double *X = klu_vars->X;
+	int index, indexp;
+
+	for (index=0; index<n; index++)
+	{
+		X[klu_vars->Pinv[index]] = rhs[index];
+	}
+
+	//L is unit lower triangular
+	for (index=0; index<n; index++)
+	{
+		for (indexp=klu_vars->Lp[index]+1; indexp<klu_vars->Lp[index+1]; indexp++)
+		{
+			X[klu_vars->Li[indexp]] -= klu_vars->Lx[indexp]*X[index];
+		}
+	}
+
+	//U has its diagonal last
+	for (index=n-1; index>=0; index--)
+	{
+		X[index] /= klu_vars->Ux[klu_vars->Up[index+1]-1];
+		for (indexp=klu_vars->Up[index]; indexp<klu_vars->Up[index+1]-1; indexp++)
+		{
+			X[klu_vars->Ui[indexp]] -= klu_vars->Ux[indexp]*X[index];
+		}
+	}
+
+	for (index=0; index<n; index++)
+	{
+		rhs[klu_vars->Q[index]] = X[index];
+		X[index] = 0.0;
+	}
+}
+
+//Allocate the island's variables, if they aren't already
+void *KLU_NR_init(void *ext_array)
+{
+	KLU_NR_vars *klu_vars;
+
+	if (ext_array != NULL)
+		return ext_array;
+
+	klu_vars = (KLU_NR_vars *)gl_malloc(sizeof(KLU_NR_vars));
+	if (klu_vars == NULL)
+		return NULL;
+
+	//Null everything so the clear works
+	memset(klu_vars,0,sizeof(KLU_NR_vars));
+	klu_nr_clear(klu_vars);
+
+	return (void *)klu_vars;
+}
+
+//Matrix was resized or reallocated -- nothing cached applies any more
+void KLU_NR_alloc(void *ext_array, unsigned int rowcount, unsigned int colcount, bool admittance_change)
+{
+	KLU_NR_vars *klu_vars = (KLU_NR_vars *)ext_array;
+
+	klu_vars->factored = false;
+}
+
+//Factor (or refactor) the matrix and solve -- returns 0 on success, like superLU
+int KLU_NR_solve(void *ext_array, NR_SOLVER_VARS *system_info_vars, unsigned int rowcount, unsigned int colcount)
+{
+	KLU_NR_vars *klu_vars = (KLU_NR_vars *)ext_array;
+	int nnz = system_info_vars->cols_LU[rowcount];
+	int *Ap = system_info_vars->cols_LU;
+	int *Ai = system_info_vars->rows_LU;
+	double *Ax = system_info_vars->a_LU;
+	bool same_pattern;
+	unsigned int rhs_index;
+	int info;
+
+	//See if the pattern matches what was factored last
+	same_pattern = klu_vars->factored && (klu_vars->n == rowcount) && (klu_vars->nnz == nnz) &&
+		(memcmp(klu_vars->pattern_cols,Ap,(rowcount+1)*sizeof(int)) == 0) &&
+		(memcmp(klu_vars->pattern_rows,Ai,nnz*sizeof(int)) == 0);
+
+	if (same_pattern && klu_nr_refactor(klu_vars,Ap,Ai,Ax))
+	{
+		info = 0;
+	}
+	else
+	{
+		if (!same_pattern)
+		{
+			//New pattern -- set up for it and order it
+			if ((klu_vars->n != rowcount) || (klu_vars->nnz != nnz) || (klu_vars->Q == NULL))
+			{
+				if (!klu_nr_setup(klu_vars,rowcount,nnz))
+				{
+					GL_THROW("NR: Failed to allocate memory for the KLU factorization");
+					//Defined above
+				}
+			}
+
+			memcpy(klu_vars->pattern_cols,Ap,(rowcount+1)*sizeof(int));
+			memcpy(klu_vars->pattern_rows,Ai,nnz*sizeof(int));
+			klu_nr_order(klu_vars,system_info_vars);
+		}
+
+		info = klu_nr_factor(klu_vars,Ap,Ai,Ax);
+		klu_vars->factored = (info == 0);
+	}
+
+	if (info != 0)
+		return info;
+
+	//Solve for each right-hand side
+	for (rhs_index=0; rhs_index<colcount; rhs_index++)
+	{
+		klu_nr_backsolve(klu_vars,&system_info_vars->rhs_LU[rhs_index*rowcount]);
+	}
+
+	return 0;
+}
+
+//End of an iteration -- the factorization is kept for the next one
+void KLU_NR_destroy(void *ext_array, bool new_iteration)
+{
+}
+
+//Free everything for the island
+void KLU_NR_free(void *ext_array)
+{
+	KLU_NR_vars *klu_vars = (KLU_NR_vars *)ext_array;
+
+	if (klu_vars == NULL)
+		return;
+
+	gl_verbose("KLU solver performed %u full factorizations and %u refactorizations",klu_vars->factor_count,klu_vars->refactor_count);
+
+	klu_nr_clear(klu_vars);
+	gl_free(klu_vars);
+}
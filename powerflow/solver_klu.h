@@ -0,0 +1,40 @@
+/* $Id
+ * Built-in KLU-style sparse LU solver for the Newton-Raphson solver
+ */
+
+#ifndef _SOLVER_KLU
+#define _SOLVER_KLU
+
+#include "solver_nr.h"
+
+//Working variables for one island -- the factorization is kept between calls so it can be reused
+typedef struct {
+	unsigned int n;			///< Size of the matrix the factorization is for
+	int nnz;				///< Number of non-zeros of the matrix the factorization is for
+	int *pattern_cols;		///< Column pointers of the factored matrix - used to detect pattern changes
+	int *pattern_rows;		///< Row indices of the factored matrix - used to detect pattern changes
+	int *Q;					///< Column ordering - Q[k] is the column of A factored in step k
+	int *Pinv;				///< Row pivoting - Pinv[i] is the step in which row i of A was the pivot
+	int *Lp;				///< Column pointers of L (unit lower triangular, unit diagonal stored first)
+	int *Li;				///< Row indices of L
+	double *Lx;				///< Values of L
+	unsigned int L_max;		///< Allocated size of Li and Lx
+	int *Up;				///< Column pointers of U (upper triangular, diagonal stored last)
+	int *Ui;				///< Row indices of U - stored in the order the column must be eliminated in
+	double *Ux;				///< Values of U
+	unsigned int U_max;		///< Allocated size of Ui and Ux
+	double *X;				///< Dense work vector - kept zeroed between uses
+	int *W;					///< Integer work space - DFS stack, DFS positions and marks
+	bool factored;			///< Flag indicating the ordering, pivoting and factors match the cached pattern
+	unsigned int factor_count;		///< Number of full factorizations performed
+	unsigned int refactor_count;	///< Number of numeric-only refactorizations performed
+} KLU_NR_vars;
+
+//Functions follow the external LU solver interface (see solver_nr.h)
+void *KLU_NR_init(void *ext_array);
+void KLU_NR_alloc(void *ext_array, unsigned int rowcount, unsigned int colcount, bool admittance_change);
+int KLU_NR_solve(void *ext_array, NR_SOLVER_VARS *system_info_vars, unsigned int rowcount, unsigned int colcount);
+void KLU_NR_destroy(void *ext_array, bool new_iteration);
+void KLU_NR_free(void *ext_array);
+
+#endif
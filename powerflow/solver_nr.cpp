@@ -33,7 +33,10 @@ Initialization after returning to service?
 
 
 
+#include <pthread.h>
+
 #include "solver_nr.h"
+#include "solver_klu.h"
 
 #define MT // this enables multithreaded SuperLU
 
@@ -50,11 +53,141 @@ typedef struct {
 	int *perm_r;
 	SuperMatrix A_LU;
 	SuperMatrix B_LU;
+	int *ordering_perm_c;		//Postordered column ordering computed for the cached sparsity pattern
+	int *ordering_cols;			//Column pointers of the cached sparsity pattern
+	int *ordering_rows;			//Row indices of the cached sparsity pattern
+	int *ordering_etree;		//Column elimination tree of the cached sparsity pattern (superLU_MT)
+	int *ordering_colcnt_h;		//Column counts of the cached sparsity pattern (superLU_MT)
+	int *ordering_part_super_h;	//Supernode partition of the cached sparsity pattern (superLU_MT)
+	unsigned int ordering_n;	//Size of the cached sparsity pattern
+	int ordering_nnz;			//Number of non-zeros in the cached sparsity pattern
 } SUPERLU_NR_vars;
 
 /* access to module global variables */
 #include "powerflow.h"
 
+//Free up the cached superLU symbolic analysis
+static void superLU_ordering_clear(SUPERLU_NR_vars *superLU_vars)
+{
+	if (superLU_vars->ordering_perm_c != NULL)
+		gl_free(superLU_vars->ordering_perm_c);
+
+	if (superLU_vars->ordering_cols != NULL)
+		gl_free(superLU_vars->ordering_cols);
+
+	if (superLU_vars->ordering_rows != NULL)
+		gl_free(superLU_vars->ordering_rows);
+
+#ifdef MT
+	//The elimination tree and supernode arrays were allocated inside superLU
+	if (superLU_vars->ordering_etree != NULL)
+		SUPERLU_FREE(superLU_vars->ordering_etree);
+
+	if (superLU_vars->ordering_colcnt_h != NULL)
+		SUPERLU_FREE(superLU_vars->ordering_colcnt_h);
+
+	if (superLU_vars->ordering_part_super_h != NULL)
+		SUPERLU_FREE(superLU_vars->ordering_part_super_h);
+#endif
+
+	superLU_vars->ordering_perm_c = NULL;
+	superLU_vars->ordering_cols = NULL;
+	superLU_vars->ordering_rows = NULL;
+	superLU_vars->ordering_etree = NULL;
+	superLU_vars->ordering_colcnt_h = NULL;
+	superLU_vars->ordering_part_super_h = NULL;
+	superLU_vars->ordering_n = 0;
+	superLU_vars->ordering_nnz = 0;
+}
+
+#ifdef MT
+//Factor and solve an island's system with superLU_MT -- this is what pdgssv() does, except that the symbolic
+//analysis (the column ordering, the postordered column elimination tree, the column counts and the supernode
+//partition) only depends on the sparsity pattern, so it is kept and reused while the pattern stays the same.
+//The numeric factorization is new every time.
+static void superLU_factor_solve(SUPERLU_NR_vars *superLU_vars, NR_SOLVER_VARS *matrices_LUin, unsigned int n, int nnz, SuperMatrix *L_LU, SuperMatrix *U_LU, int *info)
+{
+	SuperMatrix AC_LU;
+	superlumt_options_t superlumt_options;
+	Gstat_t superlumt_stat;
+	int_t panel_size = sp_ienv(1);
+	int_t relax = sp_ienv(2);
+	bool reuse;
+
+	//See if the cached analysis still applies
+	reuse = NR_superLU_reuse_ordering && (superLU_vars->ordering_perm_c != NULL) && (superLU_vars->ordering_n == n) && (superLU_vars->ordering_nnz == nnz)
+		&& (memcmp(superLU_vars->ordering_cols,matrices_LUin->cols_LU,(n+1)*sizeof(int)) == 0)
+		&& (memcmp(superLU_vars->ordering_rows,matrices_LUin->rows_LU,nnz*sizeof(int)) == 0);
+
+	StatAlloc(n, NR_superLU_procs, panel_size, relax, &superlumt_stat);
+	StatInit(n, NR_superLU_procs, &superlumt_stat);
+
+	memset(&superlumt_options,0,sizeof(superlumt_options));
+	if (reuse == true)
+	{
+		//Same pattern -- the ordering is the postordered one, which goes with the cached tree
+		memcpy(superLU_vars->perm_c,superLU_vars->ordering_perm_c,n*sizeof(int));
+		superlumt_options.etree = superLU_vars->ordering_etree;
+		superlumt_options.colcnt_h = superLU_vars->ordering_colcnt_h;
+		superlumt_options.part_super_h = superLU_vars->ordering_part_super_h;
+	}
+	else
+	{
+		get_perm_c(1, &superLU_vars->A_LU, superLU_vars->perm_c);
+	}
+
+	//Permute the columns -- with refact=YES, superLU takes the tree from the options instead of computing it
+	pdgstrf_init(NR_superLU_procs, EQUILIBRATE, NOTRANS, (reuse ? YES : NO), panel_size, relax, 1.0, NO, 0.0,
+				 superLU_vars->perm_c, superLU_vars->perm_r, NULL, 0, &superLU_vars->A_LU, &AC_LU, &superlumt_options, &superlumt_stat);
+
+	//The L and U of the last solve are gone, so the numeric factorization allocates its own
+	superlumt_options.refact = NO;
+	pdgstrf(&superlumt_options, &AC_LU, superLU_vars->perm_r, L_LU, U_LU, &superlumt_stat, info);
+
+	if (*info == 0)
+		dgstrs(NOTRANS, L_LU, U_LU, superLU_vars->perm_r, superLU_vars->perm_c, &superLU_vars->B_LU, &superlumt_stat, info);
+
+	//pxgstrf_finalize() would free the tree too, so only the permuted matrix goes here
+	Destroy_CompCol_Permuted(&AC_LU);
+	StatFree(&superlumt_stat);
+
+	if (reuse == true)
+		return;
+
+	//Keep the new analysis for the next solve, if wanted
+	superLU_ordering_clear(superLU_vars);
+	if (NR_superLU_reuse_ordering)
+	{
+		superLU_vars->ordering_perm_c = (int *)gl_malloc(n*sizeof(int));
+		superLU_vars->ordering_cols = (int *)gl_malloc((n+1)*sizeof(int));
+		superLU_vars->ordering_rows = (int *)gl_malloc(nnz*sizeof(int));
+		superLU_vars->ordering_etree = superlumt_options.etree;
+		superLU_vars->ordering_colcnt_h = superlumt_options.colcnt_h;
+		superLU_vars->ordering_part_super_h = superlumt_options.part_super_h;
+
+		//If any failed, just don't cache it
+		if ((superLU_vars->ordering_perm_c == NULL) || (superLU_vars->ordering_cols == NULL) || (superLU_vars->ordering_rows == NULL))
+		{
+			superLU_ordering_clear(superLU_vars);
+			return;
+		}
+
+		//Store the pattern and the postordered ordering
+		superLU_vars->ordering_n = n;
+		superLU_vars->ordering_nnz = nnz;
+		memcpy(superLU_vars->ordering_perm_c,superLU_vars->perm_c,n*sizeof(int));
+		memcpy(superLU_vars->ordering_cols,matrices_LUin->cols_LU,(n+1)*sizeof(int));
+		memcpy(superLU_vars->ordering_rows,matrices_LUin->rows_LU,nnz*sizeof(int));
+	}
+	else
+	{
+		SUPERLU_FREE(superlumt_options.etree);
+		SUPERLU_FREE(superlumt_options.colcnt_h);
+		SUPERLU_FREE(superlumt_options.part_super_h);
+	}
+}
+#endif
+
 //Initialize the sparse notation
 void sparse_init(SPARSE* sm, int nels, int ncols)
 {
@@ -287,35 +420,186 @@ void sparse_tonr(SPARSE* sm, NR_SOLVER_VARS *matrices_LUin)
 	}
 }
 
-/** Newton-Raphson solver
-	Solves a power flow problem using the Newton-Raphson method
-	
-	@return n=0 on failure to complete a single iteration, 
-	n>0 to indicate success after n interations, or 
-	n<0 to indicate failure after n iterations
- **/
-int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type , NR_MESHFAULT_IMPEDANCE *mesh_imped_vals, bool *bad_computations)
+//State of an island after a Newton-Raphson pass on it
+typedef enum {
+	NR_ISLAND_ITERATE=0,	//Island needs another iteration
+	NR_ISLAND_SOLVED=1,		//Island is done - converged, failed, or hit the iteration limit
+	NR_ISLAND_EMPTY=2,		//Island has an empty admittance matrix, so there was nothing to solve
+	NR_ISLAND_EXIT=3		//Solver is done with all islands (mesh fault impedance calculations)
+} NR_ISLAND_STATE;
+
+//Islands solved concurrently - everything the island threads need for one solver_nr call
+typedef struct {
+	unsigned int bus_count;
+	BUSDATA *bus;
+	unsigned int branch_count;
+	BRANCHDATA *branch;
+	NR_SOLVER_STRUCT *powerflow_values;
+	NRSOLVERMODE powerflow_type;
+	bool *bad_computations;
+	unsigned int thread_count;		//Number of threads (including the calling one) working on the islands
+	NR_ISLAND_STATE *island_state;	//How each island finished
+	int next_island;				//Next island waiting for a thread
+	int failed_island;				//Lowest island that threw an exception (-1 for none)
+	char failed_msg[1024];			//Exception message of failed_island
+} NR_ISLAND_JOB;
+
+//Island thread information - index to compare against the job's thread count and the last job generation seen
+typedef struct {
+	unsigned int index;
+	unsigned int generation;
+} NR_ISLAND_THREAD;
+
+//Island threads are started on first use and parked between solver_nr calls
+static pthread_mutex_t NR_island_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t NR_island_pool_start = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t NR_island_pool_done = PTHREAD_COND_INITIALIZER;
+static unsigned int NR_island_pool_size = 0;		//Number of island threads started
+static unsigned int NR_island_pool_busy = 0;		//Number of island threads still on the current job
+static unsigned int NR_island_pool_generation = 0;	//Incremented with every job, so parked threads can tell a new one arrived
+static NR_ISLAND_JOB *NR_island_pool_job = NULL;	//Current job
+
+//Determines how many threads to solve the islands with - 1 solves them one at a time
+static unsigned int solver_nr_island_threadcount(NR_MESHFAULT_IMPEDANCE *mesh_imped_vals)
 {
-	//Index for "islanding operations", when needed
-	int island_index_val;
+	char temp_buff[64];
+	int thread_count;
 
-	//Temporary island looping value
-	int island_loop_index;
+	//Mesh fault impedance calculations and matrix dumps are done one island at a time, and external LU solvers are not known to be thread-safe
+	if ((NR_islands_detected < 2) || (mesh_imped_vals != NULL) || (NRMatDumpMethod != MD_NONE) || (matrix_solver_method == MM_EXTERN))
+	{
+		return 1;
+	}
+
+	thread_count = NR_island_threadcount;
+
+	//Zero uses the core thread count
+	if (thread_count == 0)
+	{
+		if (gl_global_getvar("threadcount",temp_buff,sizeof(temp_buff)) != NULL)
+		{
+			thread_count = atoi(temp_buff);
+		}
+	}
+
+	//No sense having more threads than islands
+	if (thread_count > NR_islands_detected)
+	{
+		thread_count = NR_islands_detected;
+	}
+
+	return (thread_count > 1) ? thread_count : 1;
+}
 
+//Reports how an island finished - kept out of the iteration passes so islands solved concurrently still report in island order
+static void solver_nr_island_report(NR_SOLVER_STRUCT *powerflow_values, int island_loop_index, NR_ISLAND_STATE island_state)
+{
+	if (island_state == NR_ISLAND_EMPTY)	//Empty matrix - nothing was solved
+	{
+		//Figure out which message to send
+		if (NR_islands_detected > 1)
+		{
+			gl_warning("Empty powerflow connectivity matrix for island %d, your system is empty!",(island_loop_index+1));
+			/*  TROUBLESHOOT
+			Newton-Raphson has an empty admittance matrix that it is trying to solve.  Either the whole system
+			faulted, or something is not properly defined.  Please try again.  If the problem persists, please
+			submit your code and a bug report via the trac website.
+			*/
+		}
+		else	//Single island
+		{
+			gl_warning("Empty powerflow connectivity matrix, your system is empty!");
+			/*  TROUBLESHOOT
+			Newton-Raphson has an empty admittance matrix that it is trying to solve.  Either the whole system
+			faulted, or something is not properly defined.  Please try again.  If the problem persists, please
+			submit your code and a bug report via the trac website.
+			*/
+		}
+	}
+	else if (powerflow_values->island_matrix_values[island_loop_index].new_iteration_required == true)	//Hit the iteration limit
+	{
+		if (NR_islands_detected > 1)
+		{
+			gl_verbose("Max solver mismatch of failed solution %f on island %d\n",powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge,(island_loop_index+1));
+		}
+		else
+		{
+			gl_verbose("Max solver mismatch of failed solution %f\n",powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge);
+		}
+	}
+	else if (powerflow_values->island_matrix_values[island_loop_index].solver_info == 0)	//It was a convergence exit
+	{
+		//See if we're multi-islanded or not
+		if (NR_islands_detected > 1)
+		{
+			gl_verbose("Power flow calculation for island %d converges at Iteration %d \n",(island_loop_index+1),(powerflow_values->island_matrix_values[island_loop_index].iteration_count+1));
+		}
+		else	//Singular
+		{
+			gl_verbose("Power flow calculation converges at Iteration %d \n",(powerflow_values->island_matrix_values[island_loop_index].iteration_count+1));
+		}
+	}
+	else	//Write out the "failure"
+	{
+		//See which version to write
+		if (NR_islands_detected > 1)
+		{
+			//For superLU - 2 = singular matrix it appears - positive values = process errors (singular, etc), negative values = input argument/syntax error
+			if (matrix_solver_method==MM_SUPERLU)
+			{
+				gl_verbose("superLU failed out of island %d with return value %d",(island_loop_index+1),powerflow_values->island_matrix_values[island_loop_index].solver_info);
+			}
+			else if (matrix_solver_method==MM_KLU)
+			{
+				gl_verbose("KLU failed out of island %d at column %d",(island_loop_index+1),powerflow_values->island_matrix_values[island_loop_index].solver_info);
+			}
+			else if (matrix_solver_method==MM_EXTERN)
+			{
+				gl_verbose("External LU solver failed out of island %d with return value %d",(island_loop_index+1),powerflow_values->island_matrix_values[island_loop_index].solver_info);
+			}
+			//Defaulted else - shouldn't exist (or make it this far), but if it does, we're failing anyways
+		}
+		else	//Singular
+		{
+			//For superLU - 2 = singular matrix it appears - positive values = process errors (singular, etc), negative values = input argument/syntax error
+			if (matrix_solver_method==MM_SUPERLU)
+			{
+				gl_verbose("superLU failed out with return value %d",powerflow_values->island_matrix_values[island_loop_index].solver_info);
+			}
+			else if (matrix_solver_method==MM_KLU)
+			{
+				gl_verbose("KLU failed out at column %d",powerflow_values->island_matrix_values[island_loop_index].solver_info);
+			}
+			else if (matrix_solver_method==MM_EXTERN)
+			{
+				gl_verbose("External LU solver failed out with return value %d",powerflow_values->island_matrix_values[island_loop_index].solver_info);
+			}
+			//Defaulted else - shouldn't exist (or make it this far), but if it does, we're failing anyways
+		}
+	}
+}
+
+/** Newton-Raphson iteration on one island
+	Performs one pass (load update, admittance matrix build, LU solve and voltage update) of the Newton-Raphson
+	method on an island.  Only the island's buses, branches and matrices are touched, so different islands
+	can be passed on concurrently.
+
+	@return NR_ISLAND_ITERATE if the island needs another pass, NR_ISLAND_SOLVED or NR_ISLAND_EMPTY when the island
+	is done, or NR_ISLAND_EXIT if the solver should return exit_value right away (mesh fault impedance calculations)
+ **/
+static NR_ISLAND_STATE solver_nr_island_pass(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type, NR_MESHFAULT_IMPEDANCE *mesh_imped_vals, bool *bad_computations, int island_loop_index, int64 *exit_value)
+{
 	//File pointer for debug outputs
 	FILE *FPoutVal;
 
 	//Saturation mismatch tracking variable
 	int func_result_val;
 
-	//Temporary function variable
-	FUNCTIONADDR temp_fxn_val;
-
 	//Generic status variable
 	STATUS call_return_status;
 
 	//Phase collapser variable
-	unsigned char phase_worka, phase_workb, phase_workc, phase_workd, phase_worke;
+	unsigned char phase_worka;
 
 	//Temporary calculation variables
 	double tempIcalcReal, tempIcalcImag;
@@ -323,30 +607,23 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 	double tempQbus; //tempQbus store the temporary value of reactive power load at each bus
 
 	//Miscellaneous index variable
-	unsigned int indexer, tempa, tempb, jindexer, kindexer;
+	unsigned int indexer, tempa, jindexer, kindexer;
 	char jindex, kindex;
 	char temp_index, temp_index_b;
 	unsigned int temp_index_c;
 
-	//Working matrix for admittance collapsing/determinations
-	complex tempY[3][3];
-
 	//Working matrix for mesh fault impedance storage, prior to "reconstruction"
 	double temp_z_store[6][6];
 
 	//Miscellaneous flag variables
-	bool Full_Mat_A, Full_Mat_B, proceed_flag;
+	bool proceed_flag;
 
 	//Deltamode intermediate variables
 	complex temp_complex_0, temp_complex_1, temp_complex_2, temp_complex_3, temp_complex_4, temp_complex_5;
 	complex aval, avalsq;
 
 	//Temporary size variable
-	char temp_size, temp_size_b, temp_size_c;
-
-	//Temporary admittance variables
-	complex Temp_Ad_A[3][3];
-	complex Temp_Ad_B[3][3];
+	char temp_size;
 
 	//DV checking array
 	complex DVConvCheck[3];
@@ -370,77 +647,14 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 	int row, col;
 	double value;
 
-	//Multi-island passes
-	bool still_iterating_islands;
-	bool proceed_to_next_island;
-	int64 return_value_for_solver_NR;
-
 	//Multi-island pointer to current superLU variables
 	SUPERLU_NR_vars *curr_island_superLU_vars;
-	
+
 #ifndef MT
 	superlu_options_t options;	//Additional variables for sequential superLU
 	SuperLUStat_t stat;
 #endif
 
-	//Set the global - we're working now, so no more adjustments to island arrays until we're done (except removals)
-	NR_solver_working = true;
-
-	//Initialize the tracker variable inside each island, just in case
-	for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-	{
-		powerflow_values->island_matrix_values[island_loop_index].index_count = 0;
-	}
-
-	//Ensure bad computations flag is set first
-	*bad_computations = false;
-
-	//Determine special circumstances of SWING bus -- do we want it to truly participate right
-	if (powerflow_type != PF_NORMAL)
-	{
-		if (powerflow_type == PF_DYNCALC)	//Parse the list -- anything that is a swing and a generator, deflag it out of principle (and to make it work right)
-		{
-			//Set the master swing flag - do for all islands
-			for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-			{
-				powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = false;
-			}
-
-			//Check the buses
-			for (indexer=0; indexer<bus_count; indexer++)
-			{
-				//See if we're a swing-flagged bus
-				if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))
-				{
-					//See if we're "generator ready"
-					if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].DynCurrent != NULL))
-					{
-						//Deflag us back to "PQ" status
-						bus[indexer].swing_functions_enabled = false;
-					}
-				}
-				//Default else -- normal bus
-			}//End bus traversion loop
-		}//Handle running dynamics differently
-		else	//Must be PF_DYNINIT
-		{
-			//Loop through the islands
-			for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-			{
-				//Flag us as true, initially
-				powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = true;
-			}
-		}
-	}//End not normal
-	else	//Must be normal
-	{
-		//Loop through all islands
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-		{
-			powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = true;	//Flag as a swing, even though this shouldn't do anything
-		}
-	}
-
 	//Populate aval, if necessary
 	if (powerflow_type == PF_DYNINIT)
 	{
@@ -454,3930 +668,4121 @@ int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count,
 		avalsq = 0.0;
 	}
 
-	if (matrix_solver_method==MM_EXTERN)
+	//Map the superLU variables each time -- just easier to do it always
+	if (matrix_solver_method==MM_SUPERLU)
 	{
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-		{
-			//Call the initialization routine
-			powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars = ((void *(*)(void *))(LUSolverFcns.ext_init))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars);
-
-			//Make sure it worked (allocation check)
-			if (powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars==NULL)
-			{
-				GL_THROW("External LU matrix solver failed to allocate memory properly!");
-				/*  TROUBLESHOOT
-				While attempting to allocate memory for the external LU solver, an error occurred.
-				Please try again.  If the error persists, ensure your external LU solver is behaving correctly
-				and coordinate with their development team as necessary.
-				*/
-			}
-		}//End Island loop
+		//Put the void pointer into a local context
+		curr_island_superLU_vars = (SUPERLU_NR_vars *)powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars;
 	}
-	else if (matrix_solver_method == MM_SUPERLU)	//SuperLU multi-island-related item
-	{
-		//Loop through and see if we need to allocate things
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-		{
-			//See if the superLU variables are populated
-			if (powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars == NULL)
-			{
-				//Allocate one up
-				curr_island_superLU_vars = (SUPERLU_NR_vars *)gl_malloc(sizeof(SUPERLU_NR_vars));
 
-				//Make sure it worked
-				if (curr_island_superLU_vars == NULL)
-				{
-					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-					//Defined elsewhere
-				}
+	//Call the load subfunction
+	compute_load_values(bus_count,bus,powerflow_values,false,island_loop_index);
 
-				//Initialize it, for giggles/paranoia
-				curr_island_superLU_vars->A_LU.Store = NULL;
+	// Calculate the mismatch of three phase current injection at each bus (deltaI), 
+	//and store the deltaI in terms of real and reactive value in array powerflow_values->island_matrix_values[island_loop_index].deltaI_NR    
+	if (powerflow_values->island_matrix_values[island_loop_index].deltaI_NR==NULL)
+	{
+		powerflow_values->island_matrix_values[island_loop_index].deltaI_NR = (double *)gl_malloc((2*powerflow_values->island_matrix_values[island_loop_index].total_variables) *sizeof(double));   // left_hand side of equation (11)
 
-				//Do the same for the underlying properties, just because
-				curr_island_superLU_vars->A_LU.Stype = SLU_NC;
-				curr_island_superLU_vars->A_LU.Dtype = SLU_D;
-				curr_island_superLU_vars->A_LU.Mtype = SLU_GE;
-				curr_island_superLU_vars->A_LU.nrow = 0;
-				curr_island_superLU_vars->A_LU.ncol = 0;
+		//Make sure it worked
+		if (powerflow_values->island_matrix_values[island_loop_index].deltaI_NR == NULL)
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-				//Repeat for B_LU
-				curr_island_superLU_vars->B_LU.Store = NULL;
+		//Update the max size
+		powerflow_values->island_matrix_values[island_loop_index].max_total_variables = powerflow_values->island_matrix_values[island_loop_index].total_variables;
+	}
+	else if (powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed)		//Bigger sized (this was checked above)
+	{
+		//Decimate the existing value
+		gl_free(powerflow_values->island_matrix_values[island_loop_index].deltaI_NR);
 
-				//Do the same for the underlying properties, just because
-				curr_island_superLU_vars->B_LU.Stype = SLU_NC;
-				curr_island_superLU_vars->B_LU.Dtype = SLU_D;
-				curr_island_superLU_vars->B_LU.Mtype = SLU_GE;
-				curr_island_superLU_vars->B_LU.nrow = 0;
-				curr_island_superLU_vars->B_LU.ncol = 0;
+		//Reallocate it...bigger...faster...stronger!
+		powerflow_values->island_matrix_values[island_loop_index].deltaI_NR = (double *)gl_malloc((2*powerflow_values->island_matrix_values[island_loop_index].total_variables) *sizeof(double));
 
-				//Other arrays
-				curr_island_superLU_vars->perm_c = NULL;
-				curr_island_superLU_vars->perm_r = NULL;
+		//Make sure it worked
+		if (powerflow_values->island_matrix_values[island_loop_index].deltaI_NR == NULL)
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-				//Assign it in
-				powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars = (void *)curr_island_superLU_vars;
-			}
-		}
+		//Store the updated value
+		powerflow_values->island_matrix_values[island_loop_index].max_total_variables = powerflow_values->island_matrix_values[island_loop_index].total_variables;
+	}
 
-		//Renull the random pointer, just in case
-		curr_island_superLU_vars = NULL;
+	//If we're in PF_DYNINIT mode, initialize the balancing convergence
+	if (powerflow_type == PF_DYNINIT)
+	{
+		powerflow_values->island_matrix_values[island_loop_index].swing_converged = true;	//init it to yes, fail by exception, not default
 	}
 
-	if (NR_admit_change)	//If an admittance update was detected, fix it
+	//Compute the calculated loads (not specified) at each bus
+	for (indexer=0; indexer<bus_count; indexer++) //for specific bus k
 	{
-		//Build the diagonal elements of the bus admittance matrix - this should only happen once no matter what
-		if (powerflow_values->BA_diag == NULL)
+		//Make sure the bus we're looking at is relevant to this island - otherwise, we can skip it
+		if (bus[indexer].island_number == island_loop_index)
 		{
-			powerflow_values->BA_diag = (Bus_admit *)gl_malloc(bus_count *sizeof(Bus_admit));   //BA_diag store the location and value of diagonal elements of Bus Admittance matrix
-
-			//Make sure it worked
-			if (powerflow_values->BA_diag == NULL)
+			//Update for generator symmetry - only in static dynamic mode and when SWING is a SWING
+			if ((powerflow_type == PF_DYNINIT) && (powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing==true))
 			{
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-				/*  TROUBLESHOOT
-				During the allocation stage of the NR algorithm, one of the matrices failed to be allocated.
-				Please try again and if this bug persists, submit your code and a bug report using the trac
-				website.
-				*/
-			}
-		}
-		
-		//Loop the islands and reset the bus count, just in case
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-		{
-			powerflow_values->island_matrix_values[island_loop_index].bus_count = 0;
-		}
+				//Secondary check - see if it is even needed - basically built around 3-phase right now
+				//Initializes the Norton equivalent item -- normal generators shoudln't need this
+				if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
+				{
+					//Form denominator term of Ii, since it won't change
+					temp_complex_1 = (~bus[indexer].V[0]) + (~bus[indexer].V[1])*avalsq + (~bus[indexer].V[2])*aval;
+					
+					//Form up numerator portion that doesn't change (Q and admittance)
+					//Do in parts, just for readability
+					temp_complex_2 = ~bus[indexer].V[0];	//conj(Va)
+					
+					//Row 1 of admittance mult
+					temp_complex_0 = temp_complex_2*(bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2]);
 
-		for (indexer=0; indexer<bus_count; indexer++) // Construct the diagonal elements of Bus admittance matrix.
-		{
-			//Increment the island bus counter
-			if (bus[indexer].island_number != -1)
-			{
-				powerflow_values->island_matrix_values[bus[indexer].island_number].bus_count++;
-			}
+					// Row 1 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus 
+					temp_complex_5 = bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2];
+					temp_complex_4 = ~temp_complex_5;
+					temp_complex_3 = bus[indexer].V[0]*temp_complex_4;
 
-			//Determine the size we need
-			if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
-				powerflow_values->BA_diag[indexer].size = 2;
-			else										//Other cases, figure out how big they are
-			{
-				phase_worka = 0;
-				for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
-				{
-					phase_worka += ((bus[indexer].phases & (0x01 << jindex)) >> jindex);
-				}
-				powerflow_values->BA_diag[indexer].size = phase_worka;
-			}
+					//conj(Vb)
+					temp_complex_2 = ~bus[indexer].V[1];
 
-			//Ensure the admittance matrix is zeroed
-			for (jindex=0; jindex<3; jindex++)
-			{
-				for (kindex=0; kindex<3; kindex++)
+					//Row 2 of admittance
+					temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2]);
+					
+					// Row 2 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
+					temp_complex_5 = bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2];
+					temp_complex_4 = ~temp_complex_5;
+					temp_complex_3 += bus[indexer].V[1]*temp_complex_4;
+
+					//conj(Vc)
+					temp_complex_2 = ~bus[indexer].V[2];
+
+					//Row 3 of admittance
+					temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2]);
+
+					// Row 3 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
+					temp_complex_5 = bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2];
+					temp_complex_4 = ~temp_complex_5;
+					temp_complex_3 += bus[indexer].V[2]*temp_complex_4;					
+
+					//numerator done, except PT portion (add in below - SWING bus is different
+
+					//On that note, if we are a SWING, zero our PT portion and QT for accumulation
+					if ((bus[indexer].type == 2) && (powerflow_values->island_matrix_values[island_loop_index].iteration_count>0))
+					{
+						*bus[indexer].PGenTotal = complex(0.0,0.0);
+					}
+				}
+				else	//Not enabled or not "full-Y-ed" - set to zero
 				{
-					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = 0;
-					tempY[jindex][kindex] = 0;
+					temp_complex_0 = 0.0;
+					temp_complex_1 = 0.0;	//Basically a flag to ignore it
 				}
-			}
+			}//End PF_DYNINIT and SWING is still the same
 
-			//If we're in any deltamode, store out self-admittance as well, if it exists
-			if ((powerflow_type!=PF_NORMAL) && (bus[indexer].full_Y != NULL))
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++) // rows - for specific phase that exists
 			{
-				//Loop and add
-				for (jindex=0; jindex<3; jindex++)
+				tempIcalcReal = tempIcalcImag = 0;   
+
+				if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - triplex bus
 				{
-					for (kindex=0; kindex<3; kindex++)
+					//Two states of triplex bus - To node of SPCT transformer needs to be different
+					//First different - Delta-I and diagonal contributions
+					if ((bus[indexer].phases & 0x20) == 0x20)	//We're the To bus
 					{
-						tempY[jindex][kindex] = bus[indexer].full_Y[jindex*3+kindex];	//Adds in any self-admittance terms (generators)
+						//Pre-negated due to the nature of how it's calculated (V1 compared to I1)
+						tempPbus =  bus[indexer].PL[jindex];	//Copy load amounts in
+						tempQbus =  bus[indexer].QL[jindex];	
 					}
-				}
-			}
+					else	//We're just a normal triplex bus
+					{
+						//This one isn't negated (normal operations)
+						tempPbus =  -bus[indexer].PL[jindex];	//Copy load amounts in
+						tempQbus =  -bus[indexer].QL[jindex];	
+					}//end normal triplex bus
+
+					//Get diagonal contributions - only (& always) 2
+					//Column 1
+					tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Im();// equation (7), the diag elements of bus admittance matrix 
+					tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Re();// equation (8), the diag elements of bus admittance matrix 
+
+					//Column 2
+					tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Im();// equation (7), the diag elements of bus admittance matrix 
+					tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Re();// equation (8), the diag elements of bus admittance matrix 
+
+					//Now off diagonals
+					for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)
+					{
+						//Apply proper index to jindexer (easier to implement this way)
+						jindexer=bus[indexer].Link_Table[kindexer];
 
-			//Now go through all of the branches to get the self admittance information (hinges on size)
-			for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size);kindexer++)
-			{ 
-				//Assign jindexer as intermediate variable (easier for me this way)
-				jindexer = bus[indexer].Link_Table[kindexer];
+						if (branch[jindexer].from == indexer)	//We're the from bus
+						{
+							if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
+							{
+								work_vals_char_0 = jindex*3;
 
-				if ((branch[jindexer].from == indexer) || (branch[jindexer].to == indexer))	//Bus is the from or to side of things - not sure how it would be in link table otherwise, but meh
-				{
-					if ((bus[indexer].phases & 0x07) == 0x07)		//Full three phase
-					{
-						for (jindex=0; jindex<3; jindex++)	//Add in all three phase values
+								//This situation can only be a normal line (triplex will never be the from for another type)
+								//Again only, & always 2 columns (just do them explicitly)
+								//Column 1
+								tempIcalcReal += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+								//Column2
+								tempIcalcReal += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+							}//End SPCT To bus - from diagonal contributions
+							else		//Normal line connection to normal triplex
+							{
+								work_vals_char_0 = jindex*3;
+								//This situation can only be a normal line (triplex will never be the from for another type)
+								//Again only, & always 2 columns (just do them explicitly)
+								//Column 1
+								tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+								//Column2
+								tempIcalcReal += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+							}//end normal triplex from
+						}//end from bus
+						else if (branch[jindexer].to == indexer)	//We're the to bus
 						{
-							//See if this phase is valid
-							phase_workb = 0x04 >> jindex;
+							if (branch[jindexer].v_ratio != 1.0)	//Transformer
+							{
+								//Only a single contributor on the from side - figure out how to get to it
+								if ((branch[jindexer].phases & 0x01) == 0x01)	//C
+								{
+									temp_index=2;
+								}
+								else if ((branch[jindexer].phases & 0x02) == 0x02)	//B
+								{
+									temp_index=1;
+								}
+								else if ((branch[jindexer].phases & 0x04) == 0x04)	//A
+								{
+									temp_index=0;
+								}
+								else	//How'd we get here!?!
+								{
+									GL_THROW("NR: A split-phase transformer appears to have an invalid phase");
+								}
 
-							if ((phase_workb & branch[jindexer].phases) == phase_workb)
+								work_vals_char_0 = jindex*3+temp_index;
+
+								//Perform the update, it only happens for one column (nature of the transformer)
+								tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+							}//end transformer
+							else									//Must be a normal line then
 							{
-								for (kindex=0; kindex<3; kindex++)
+								if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
 								{
-									//Check phase
-									phase_workd = 0x04 >> kindex;
+									work_vals_char_0 = jindex*3;
+									//This case should never really exist, but if someone reverses a secondary or is doing meshed secondaries, it might
+									//Again only, & always 2 columns (just do them explicitly)
+									//Column 1
+									tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+									tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
 
-									if ((phase_workd & branch[jindexer].phases) == phase_workd)
-									{
-										if (branch[jindexer].from == indexer)	//We're the from version
-										{
-											tempY[jindex][kindex] += branch[jindexer].YSfrom[jindex*3+kindex];
-										}
-										else									//Must be the to version
-										{
-											tempY[jindex][kindex] += branch[jindexer].YSto[jindex*3+kindex];
-										}
-									}//End valid column phase
-								}
-							}//End valid row phase
-						}
-					}
-					else if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - add in 2x2 element to upper left 2x2
+									//Column2
+									tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+									tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								}//End SPCT To bus - from diagonal contributions
+								else		//Normal line connection to normal triplex
+								{
+									work_vals_char_0 = jindex*3;
+									//Again only, & always 2 columns (just do them explicitly)
+									//Column 1
+									tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+									tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+
+									//Column2
+									tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+									tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								}//End normal triplex connection
+							}//end normal line
+						}//end to bus
+						else	//We're nothing
+							;
+
+					}//End branch traversion
+
+					//Determine how we are posting this update
+					if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
 					{
-						if (branch[jindexer].from == indexer)	//From branch
-						{
-							//End of SPCT transformer requires slightly different Diagonal components (so when it's the To bus of SPCT and from for other triplex
-							if ((bus[indexer].phases & 0x20) == 0x20)	//Special case
-							{
-								//Other triplexes need to be negated to match sign conventions
-								tempY[0][0] -= branch[jindexer].YSfrom[0];
-								tempY[0][1] -= branch[jindexer].YSfrom[1];
-								tempY[1][0] -= branch[jindexer].YSfrom[3];
-								tempY[1][1] -= branch[jindexer].YSfrom[4];
-							}
-							else										//Just a normal to bus
-							{
-								tempY[0][0] += branch[jindexer].YSfrom[0];
-								tempY[0][1] += branch[jindexer].YSfrom[1];
-								tempY[1][0] += branch[jindexer].YSfrom[3];
-								tempY[1][1] += branch[jindexer].YSfrom[4];
-							}
-						}
-						else									//To branch
+						if ((powerflow_type == PF_DYNINIT) && (bus[indexer].DynCurrent != NULL))	//We're a generator-type bus
 						{
-							//Replicate the above for SPCT test, in case people put lines in backwards
-							//End of SPCT transformer requires slightly different Diagonal components (so when it's the To bus of SPCT and from for other triplex
-							if (((bus[indexer].phases & 0x20) == 0x20) && (branch[jindexer].lnk_type == 1))	//Special case, but make sure we're not the transformer
-							{
-								tempY[0][0] -= branch[jindexer].YSto[0];
-								tempY[0][1] -= branch[jindexer].YSto[1];
-								tempY[1][0] -= branch[jindexer].YSto[3];
-								tempY[1][1] -= branch[jindexer].YSto[4];
-							}
-							else	//Normal bus - no funky SPCT nonsense
+							//Compute the delta_I, just like below - but don't post it (still zero in calcs)
+							work_vals_double_3 = tempPbus - tempIcalcReal;
+							work_vals_double_4 = tempQbus - tempIcalcImag;
+
+							//Form a magnitude vector
+							work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
+							
+							if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
 							{
-								tempY[0][0] += branch[jindexer].YSto[0];
-								tempY[0][1] += branch[jindexer].YSto[1];
-								tempY[1][0] += branch[jindexer].YSto[3];
-								tempY[1][1] += branch[jindexer].YSto[4];
+								powerflow_values->island_matrix_values[island_loop_index].swing_converged=false;
 							}
-						}
-					}
-					else	//We must be a single or two-phase line - always populate the upper left portion of matrix (easier for later)
+						}//End PF_DYNINIT SWING traversion
+
+						//Must be normal run, since DYNRUN should have swing capabilities deflagged
+						//Normal run - zero it - should already be zerod, but let's be paranoid for now
+						powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
+						powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
+					}//End SWING bus cases
+					else	//PQ bus or SWING masquerading as a PQ
+					{
+						//It's I.  Just a direct conversion (P changed above to I as well)
+						powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = tempPbus - tempIcalcReal;
+						powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = tempQbus - tempIcalcImag;
+					}//End Normal PQ bus
+				}//End split-phase present
+				else	//Three phase or some variant thereof
+				{
+					tempPbus =  - bus[indexer].PL[jindex];	//Copy load amounts in
+					tempQbus =  - bus[indexer].QL[jindex];	
+
+					for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)		//cols - Still only for specified phases
 					{
+						//Determine our indices, based on phase information
+						temp_index = -1;
 						switch(bus[indexer].phases & 0x07) {
-							case 0x00:	//No phases (we've been faulted out
+							case 0x01:	//C
 								{
-									break;	//Just get us outta here
-								}
-							case 0x01:	//Only C
+									temp_index=2;
+									break;
+								}//end 0x01
+							case 0x02:	//B
 								{
-									if ((branch[jindexer].phases & 0x01) == 0x01)	//Phase C valid on branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[8];
-										}
-									}//End valid phase C
+									temp_index=1;
 									break;
-								}
-							case 0x02:	//Only B
+								}//end 0x02
+							case 0x03:	//BC
 								{
-									if ((branch[jindexer].phases & 0x02) == 0x02)	//Phase B valid on branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[4];
-										}
-									}//End valid phase B
+									if (kindex==0)	//B
+										temp_index=1;
+									else	//C
+										temp_index=2;
 									break;
-								}
-							case 0x03:	//B & C
+								}//end 0x03
+							case 0x04:	//A
 								{
-									phase_worka = (branch[jindexer].phases & 0x03);	//Extract branch phases
-
-									if (phase_worka == 0x03)	//Full B & C
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[4];
-											tempY[0][1] += branch[jindexer].YSfrom[5];
-											tempY[1][0] += branch[jindexer].YSfrom[7];
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[4];
-											tempY[0][1] += branch[jindexer].YSto[5];
-											tempY[1][0] += branch[jindexer].YSto[7];
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//End valid B & C
-									else if (phase_worka == 0x01)	//Only C branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//end valid C
-									else if (phase_worka == 0x02)	//Only B branch
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[4];
-										}
-									}//end valid B
-									else	//Must be nothing then - all phases must be faulted, or something
-										;
+									temp_index=0;
 									break;
-								}
-							case 0x04:	//Only A
+								}//end 0x04
+							case 0x05:	//AC
 								{
-									if ((branch[jindexer].phases & 0x04) == 0x04)	//Phase A is valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-										}
-									}//end valid phase A
+									if (kindex==0)	//A
+										temp_index=0;
+									else			//C
+										temp_index=2;
 									break;
-								}
-							case 0x05:	//A & C
+								}//end 0x05
+							case 0x06:	//AB
 								{
-									phase_worka = branch[jindexer].phases & 0x05;	//Extract phases
-
-									if (phase_worka == 0x05)	//Both A & C valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-											tempY[0][1] += branch[jindexer].YSfrom[2];
-											tempY[1][0] += branch[jindexer].YSfrom[6];
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-											tempY[0][1] += branch[jindexer].YSto[2];
-											tempY[1][0] += branch[jindexer].YSto[6];
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//End A & C valid
-									else if (phase_worka == 0x04)	//Only A valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-										}
-									}//end only A valid
-									else if (phase_worka == 0x01)	//Only C valid
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[1][1] += branch[jindexer].YSfrom[8];
-										}
-										else									//To branch
-										{
-											tempY[1][1] += branch[jindexer].YSto[8];
-										}
-									}//end only C valid
-									else	//No connection - must be faulted
-										;
+									if (kindex==0)	//A
+										temp_index=0;
+									else			//B
+										temp_index=1;
 									break;
-								}
-							case 0x06:	//A & B
+								}//end 0x06
+							case 0x07:	//ABC
 								{
-									phase_worka = branch[jindexer].phases & 0x06;	//Extract phases
-
-									if (phase_worka == 0x06)	//Valid A & B phase
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-											tempY[0][1] += branch[jindexer].YSfrom[1];
-											tempY[1][0] += branch[jindexer].YSfrom[3];
-											tempY[1][1] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-											tempY[0][1] += branch[jindexer].YSto[1];
-											tempY[1][0] += branch[jindexer].YSto[3];
-											tempY[1][1] += branch[jindexer].YSto[4];
-										}
-									}//End valid A & B
-									else if (phase_worka == 0x04)	//Only valid A
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[0][0] += branch[jindexer].YSfrom[0];
-										}
-										else									//To branch
-										{
-											tempY[0][0] += branch[jindexer].YSto[0];
-										}
-									}//end valid A
-									else if (phase_worka == 0x02)	//Only valid B
-									{
-										if (branch[jindexer].from == indexer)	//From branch
-										{
-											tempY[1][1] += branch[jindexer].YSfrom[4];
-										}
-										else									//To branch
-										{
-											tempY[1][1] += branch[jindexer].YSto[4];
-										}
-									}//end valid B
-									else	//Default - must be already handled
-										;
+									temp_index = kindex;	//Will loop all 3
 									break;
-								}
-							default:	//How'd we get here?
-								{
-									GL_THROW("Unknown phase connection in NR self admittance diagonal");
-									/*  TROUBLESHOOT
-									An unknown phase condition was encountered in the NR solver when constructing
-									the self admittance diagonal.  Please report this bug and submit your code to 
-									the trac system.
-									*/
-								break;
-								}
-						}	//switch end
-					}	//1 or 2 phase end
-				}	//phase accumulation end
-				else		//It's nothing (no connnection)
-					;
-			}//branch traversion end
+								}//end 0x07
+						}//End switch/case
 
-			//Store the self admittance into BA_diag.  Also update the indices for possible use later
-			//Only do this if we're actually populated
-			island_index_val = bus[indexer].island_number;
+						if (temp_index==-1)	//Error check
+						{
+							GL_THROW("NR: A voltage index failed to be found.");
+							/*  TROUBLESHOOT
+							While attempting to compute the calculated power current, a voltage index failed to be
+							resolved.  Please submit your code and a bug report via the trac website.
+							*/
+						}
 
-			if (island_index_val != -1)
-			{
-				powerflow_values->BA_diag[indexer].col_ind = powerflow_values->BA_diag[indexer].row_ind = powerflow_values->island_matrix_values[island_index_val].index_count;	// Store the row and column starting information (square matrices)
-				bus[indexer].Matrix_Loc = powerflow_values->island_matrix_values[island_index_val].index_count;								//Store our location so we know where we go
-				powerflow_values->island_matrix_values[island_index_val].index_count += powerflow_values->BA_diag[indexer].size;				// Update the index for this matrix's size, so next one is in appropriate place
-			}
+						//Normal diagonal contributions
+						tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
+						tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
 
-			//Store the admittance values into the BA_diag matrix structure
-			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-			{
-				for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
-				{
-					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = tempY[jindex][kindex];// Store the self admittance terms.
-				}
-			}
+						//In-rush load contributions (if any) - only along explicit diagonal
+						if ((bus[indexer].full_Y_load != NULL) && (jindex==kindex))
+						{
+							tempIcalcReal += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Re() - (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
+							tempIcalcImag += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Im() + (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
+						}
 
-			//Copy values into node-specific link (if needed)
-			if (bus[indexer].full_Y_all != NULL)
-			{
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
-				{
-					for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
-					{
-						bus[indexer].full_Y_all[jindex*3+kindex] = tempY[jindex][kindex];// Store the self admittance terms.
-					}
-				}
-			}//End self-admittance update
-		}//End diagonal construction
+						//Off diagonal contributions
+						//Need another variable to handle the rows
+						temp_index_b = -1;
+						switch(bus[indexer].phases & 0x07) {
+							case 0x01:	//C
+								{
+									temp_index_b=2;
+									break;
+								}//end 0x01
+							case 0x02:	//B
+								{
+									temp_index_b=1;
+									break;
+								}//end 0x02
+							case 0x03:	//BC
+								{
+									if (jindex==0)	//B
+										temp_index_b=1;
+									else	//C
+										temp_index_b=2;
+									break;
+								}//end 0x03
+							case 0x04:	//A
+								{
+									temp_index_b=0;
+									break;
+								}//end 0x04
+							case 0x05:	//AC
+								{
+									if (jindex==0)	//A
+										temp_index_b=0;
+									else			//C
+										temp_index_b=2;
+									break;
+								}//end 0x05
+							case 0x06:	//AB
+								{
+									if (jindex==0)	//A
+										temp_index_b=0;
+									else			//B
+										temp_index_b=1;
+									break;
+								}//end 0x06
+							case 0x07:	//ABC
+								{
+									temp_index_b = jindex;	//Will loop all 3
+									break;
+								}//end 0x07
+						}//End switch/case
 
-		//Loop through the islands and set the initial items
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-		{
-			//Store the size of the diagonal, since it represents how many variables we are solving (useful later)
-			powerflow_values->island_matrix_values[island_loop_index].total_variables = powerflow_values->island_matrix_values[island_loop_index].index_count;
+						if (temp_index_b==-1)	//Error check
+						{
+							GL_THROW("NR: A voltage index failed to be found.");
+						}
 
-			//Check to see if we've exceeded our max.  If so, reallocate!
-			if (powerflow_values->island_matrix_values[island_loop_index].total_variables > powerflow_values->island_matrix_values[island_loop_index].max_total_variables)
-				powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
+						for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)	//Parse through the branch list
+						{
+							//Apply proper index to jindexer (easier to implement this way)
+							jindexer=bus[indexer].Link_Table[kindexer];
 
-			/// Build the off_diagonal_PQ bus elements of 6n*6n Y_NR matrix.Equation (12). All the value in this part will not be updated at each iteration.
-			//Constructed using sparse methodology, non-zero elements are the only thing considered (and non-PV)
-			//No longer necessarily 6n*6n any more either,
-			powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ = 0;
-		}//End loop traversion
+							if (branch[jindexer].from == indexer) 
+							{
+								//See if we're a triplex transformer (will only occur on the from side)
+								if ((branch[jindexer].phases & 0x80) == 0x80)	//Triplexy
+								{
+									proceed_flag = false;
+									phase_worka = branch[jindexer].phases & 0x07;
 
-		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse all of the branches
-		{
-			tempa  = branch[jindexer].from;
-			tempb  = branch[jindexer].to;
+									if (kindex==0)	//All of this will only occur the first column iteration
+									{
+										switch (bus[indexer].phases & 0x07)	{
+											case 0x01:	//C
+												{
+													if (phase_worka==0x01)
+														proceed_flag=true;
+													break;
+												}//end 0x01
+											case 0x02:	//B
+												{
+													if (phase_worka==0x02)
+														proceed_flag=true;
+													break;
+												}//end 0x02
+											case 0x03:	//BC
+												{
+													if ((jindex==0) && (phase_worka==0x02))	//First row and is a B
+														proceed_flag=true;
+													else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
+														proceed_flag=true;
+													else
+														;
+													break;
+												}//end 0x03
+											case 0x04:	//A
+												{
+													if (phase_worka==0x04)
+														proceed_flag=true;
+													break;
+												}//end 0x04
+											case 0x05:	//AC
+												{
+													if ((jindex==0) && (phase_worka==0x04))	//First row and is a A
+														proceed_flag=true;
+													else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
+														proceed_flag=true;
+													else
+														;
+													break;
+												}//end 0x05
+											case 0x06:	//AB - shares with ABC
+											case 0x07:	//ABC 
+												{
+													if ((jindex==0) && (phase_worka==0x04))	//A & first row
+														proceed_flag=true;
+													else if ((jindex==1) && (phase_worka==0x02))	//B & second row
+														proceed_flag=true;
+													else if ((jindex==2) && (phase_worka==0x01))	//C & third row
+														proceed_flag=true;
+													else;
+													break;
+												}//end 0x07
+										}//end switch
+									}//End if kindex==0
+
+									if (proceed_flag)
+									{
+										work_vals_char_0 = temp_index_b*3;
+										//Do columns individually
+										//1
+										tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+										tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
 
-			//Pull the island index off the from bus -- for islands, both ends SHOULD be in the same index
-			island_index_val = bus[tempa].island_number;
+										//2
+										tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+										tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
 
-			//Check and see if we should just skip this branch -- if it's an unassociated node, probably don't need this branch
-			if (island_index_val == -1)
-			{
-				continue;
-			}
+									}
+								}//end SPCT transformer
+								else	///Must be a standard line
+								{
+									work_vals_char_0 = temp_index_b*3+temp_index;
+									work_vals_double_0 = (-branch[jindexer].Yfrom[work_vals_char_0]).Re();
+									work_vals_double_1 = (-branch[jindexer].Yfrom[work_vals_char_0]).Im();
+									work_vals_double_2 = (bus[branch[jindexer].to].V[temp_index]).Re();
+									work_vals_double_3 = (bus[branch[jindexer].to].V[temp_index]).Im();
 
-			//Preliminary check to make sure we weren't missed in the initialization
-			if ((bus[tempa].Matrix_Loc == -1) || (bus[tempb].Matrix_Loc == -1))
-			{
-				GL_THROW("An element in NR line:%d was not properly localized");
-				/*  TROUBLESHOOT
-				When parsing the bus list, the Newton-Raphson solver found a bus that did not
-				appear to have a location within the overall admittance/Jacobian matrix.  Please
-				submit this as a bug with your code on the Trac site.
-				*/
-			}
+									tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+									tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
 
-			if (((branch[jindexer].phases & 0x80) == 0x80) && (branch[jindexer].v_ratio==1.0))	//Triplex, but not SPCT
-			{
-				for (jindex=0; jindex<2; jindex++)			//rows
-				{
-					for (kindex=0; kindex<2; kindex++)		//columns
+								}//end standard line
+							}	
+							if  (branch[jindexer].to == indexer)
+							{
+								work_vals_char_0 = temp_index_b*3+temp_index;
+								work_vals_double_0 = (-branch[jindexer].Yto[work_vals_char_0]).Re();
+								work_vals_double_1 = (-branch[jindexer].Yto[work_vals_char_0]).Im();
+								work_vals_double_2 = (bus[branch[jindexer].from].V[temp_index]).Re();
+								work_vals_double_3 = (bus[branch[jindexer].from].V[temp_index]).Im();
+
+								tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+								tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+							}
+							else;
+						}
+					}//end intermediate current for each phase column
+
+					//Determine how we are posting this update
+					if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
 					{
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+						if ((powerflow_type == PF_DYNINIT) && (bus[indexer].DynCurrent != NULL))
+						{
+							//See if we're a Norton-equivalent-based generator
+							if (bus[indexer].full_Y != NULL)
+							{
+								//Compute our "power generated" value for this phase - conjugated in formation
+								temp_complex_2 = bus[indexer].V[jindex] * complex(tempIcalcReal,-tempIcalcImag);
 
-						if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+								if (powerflow_values->island_matrix_values[island_loop_index].iteration_count>0)	//Only update SWING on subsequent passes
+								{
+									//Now add it into the "generation total" for the SWING
+									(*bus[indexer].PGenTotal) += temp_complex_2 - temp_complex_3/3.0; // both PT and QT = Ssource-Sysource = v conj(I) - v conj(ysource v)
+								}
 
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+								//Compute the delta_I, just like below - but don't post it (still zero in calcs)
+								work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
 
-						if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
-					}//end columns of split phase
-				}//end rows of split phase
-			}//end traversion of split-phase
-			else											//Three phase or some variety
-			{
-				//Make sure we aren't SPCT, otherwise things get jacked
-				if ((branch[jindexer].phases & 0x80) != 0x80)	//SPCT, but v_ratio not = 1
-				{
-					for (jindex=0; jindex<3; jindex++)			//rows
-					{
-						//See if this phase is valid
-						phase_workb = 0x04 >> jindex;
+								if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
+								{
+									work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
+									work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
+									work_vals_double_3 = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal; // equation(7), Real part of deltaI, left hand side of equation (11)
+									work_vals_double_4 = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
 
-						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
-						{
-							for (kindex=0; kindex<3; kindex++)		//columns
+									//Form a magnitude value - put in work_vals_double_0, since we're done with it
+									work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
+								}
+								else	//Would give us a NAN, so it must be out of service or something (case from below - really shouldn't apply to SWING)
+								{
+									work_vals_double_0 = 0.0;	//Assumes "converged"
+								}
+								
+								if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
+								{
+									powerflow_values->island_matrix_values[island_loop_index].swing_converged=false;
+								}
+							}//End Norton-equivalent SWING
+							else	//Other generator types
 							{
-								//Check this phase as well
-								phase_workd = 0x04 >> kindex;
+								//Compute the delta_I, just like below - but don't post it (still zero in calcs)
+								work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
 
-								if ((phase_workd & branch[jindexer].phases) == phase_workd)	//Column validity check
+								if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
 								{
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+									work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
+									work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
+									work_vals_double_3 = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal; // equation(7), Real part of deltaI, left hand side of equation (11)
+									work_vals_double_4 = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+									//Form a magnitude value - put in work_vals_double_0, since we're done with it
+									work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
+								}
+								else	//Would give us a NAN, so it must be out of service or something (case from below - really shouldn't apply to SWING)
+								{
+									work_vals_double_0 = 0.0;	//Assumes "converged"
+								}
 
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+								if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
+								{
+									powerflow_values->island_matrix_values[island_loop_index].swing_converged=false;
+								}
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
-								}//end column validity check
-							}//end columns of 3 phase
-						}//End row validity check
-					}//end rows of 3 phase
-				}//end not SPCT
-				else	//SPCT implementation
-				{
-					for (jindex=0; jindex<3; jindex++)			//rows
+								//Put this into DynCurrent for storage
+								bus[indexer].DynCurrent[jindex] = complex(tempIcalcReal,tempIcalcImag);
+							}//End other generator types
+						}//End PF_DYNINIT SWING traversion
+
+						//Effectively Zero out the components, regardless of normal run or not
+						//Should already be zerod, but do it again for paranoia sake
+						if (NR_busdata[indexer].BusHistTerm != NULL)	//See if we're "delta-capable"
+						{
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Re();
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Im();
+						}
+						else
+						{
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
+						}
+
+						//Saturation skipped for "swing is a swing" case, since it doesn't affect the admittance (no need to offset)
+					}//End SWING bus cases
+					else	//PQ bus or SWING masquerading as a PQ
 					{
-						//See if this phase is valid
-						phase_workb = 0x04 >> jindex;
+						work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
 
-						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+						if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
 						{
-							for (kindex=0; kindex<3; kindex++)		//Row valid, traverse all columns for SPCT Yfrom
-							{
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
-									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+							work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
+							work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
-							}//end columns traverse
+							//See if deltamode needs to include extra term
+							if (NR_busdata[indexer].BusHistTerm != NULL)
+							{
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) + NR_busdata[indexer].BusHistTerm[jindex].Re() - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) + NR_busdata[indexer].BusHistTerm[jindex].Im() - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
+							}
+							else	//Nope
+							{
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
+							}
 
-							//If row is valid, now traverse the rows of that column for Yto
-							for (kindex=0; kindex<3; kindex++)
+							//Accumulate in any saturation current values as well, while we're here
+							if (NR_busdata[indexer].BusSatTerm != NULL)
 							{
-								if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
-									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Re();
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Im();
+							}
+						}
+						else
+						{
+							if (NR_busdata[indexer].BusHistTerm != NULL)	//See if extra deltamode term needs to be included
+							{
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Re();
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Im();
+							}
+							else
+							{
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
+							}
 
-								if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
-									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
-							}//end rows traverse
-						}//End row validity check
-					}//end rows of 3 phase
-				}//End SPCT
-			}//end three phase
-		}//end line traversion
+							//Accumulate in any saturation current values as well, while we're here
+							if (NR_busdata[indexer].BusSatTerm != NULL)
+							{
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Re();
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Im();
+							}
+						}
+					}//End normal bus handling
+				}//End three-phase or variant thereof
+			}//End delta_I for each phase row
 
-		//Loop through the islands again
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-		{
-			//Allocate the space - double the number found (each element goes in two places)
-			if (powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ == NULL)
+			//Add in generator current amounts, if relevant
+			if (powerflow_type != PF_NORMAL)
 			{
-				powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2) *sizeof(Y_NR));   //powerflow_values->island_matrix_values[x].Y_offdiag_PQ store the row,column and value of off_diagonal elements of Bus Admittance matrix in which all the buses are not PV buses. 
+				//Secondary check - see if it is even needed - basically built around 3-phase right now (checks)
+				if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].DynCurrent != NULL))
+				{
+					//See if we're a Norton-equivalent generator
+					if (bus[indexer].full_Y != NULL)
+					{
+						if ((bus[indexer].phases & 0x07) == 0x07)	//Make sure is three-phase
+						{
+							//Only update in particular mode - SWING bus values should still be treated as such
+							if ((powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing == true) && (powerflow_type == PF_DYNINIT))	//Really only true for PF_DYNINIT anyways
+							{
+								//Power should be all updated, now update current values
+								temp_complex_0 += complex((*bus[indexer].PGenTotal).Re(),-(*bus[indexer].PGenTotal).Im()); // total generated power injected congugated
 
-				//Make sure it worked
-				if (powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ == NULL)
-					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+								//Compute Ii
+								if (temp_complex_1.Mag() > 0.0)	//Non zero
+								{
+									temp_complex_2 = temp_complex_0/temp_complex_1;	//Forms Ii
 
-				//Save our size
-				powerflow_values->island_matrix_values[island_loop_index].max_size_offdiag_PQ = powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ;	//Don't care about the 2x, since we'll be comparing it against itself
-			}
-			else if (powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ > powerflow_values->island_matrix_values[island_loop_index].max_size_offdiag_PQ)	//Something changed and we are bigger!!
-			{
-				//Destroy us!
-				gl_free(powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ);
+									//Now convert Ii to the individual phase amounts
+									bus[indexer].DynCurrent[0] = temp_complex_2;
+									bus[indexer].DynCurrent[1] = temp_complex_2*avalsq;
+									bus[indexer].DynCurrent[2] = temp_complex_2*aval;
+								}
+								else	//Must make zero
+								{
+									bus[indexer].DynCurrent[0] = complex(0.0,0.0);
+									bus[indexer].DynCurrent[1] = complex(0.0,0.0);
+									bus[indexer].DynCurrent[2] = complex(0.0,0.0);
+								}
+							}//End SWING is still swing, otherwise should just accumulate what it had
 
-				//Rebuild us, we have the technology
-				powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2) *sizeof(Y_NR));
+							//Don't get added in as part of "normal swing" routine
+							if ((bus[indexer].type == 0) || ((bus[indexer].type>1) && (bus[indexer].swing_functions_enabled == false)))
+							{
+								//Add these into the system - added because "generation"
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size] += bus[indexer].DynCurrent[0].Re();		//Phase A
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 1] += bus[indexer].DynCurrent[1].Re();	//Phase B
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 2] += bus[indexer].DynCurrent[2].Re();	//Phase C
 
-				//Make sure it worked
-				if (powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ == NULL)
-					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc] += bus[indexer].DynCurrent[0].Im();		//Phase A
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 1] += bus[indexer].DynCurrent[1].Im();	//Phase B
+								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 2] += bus[indexer].DynCurrent[2].Im();	//Phase C
+							}
+							//Defaulted else - leave as they were
+						}//End three-phase
+						else	//Not three-phase at the moment
+						{
+							//See if we ever were (reliability call)
+							if ((bus[indexer].origphases & 0x07) == 0x07)
+							{
+								//Just zero it
+								bus[indexer].DynCurrent[0] = complex(0.0,0.0);
+								bus[indexer].DynCurrent[1] = complex(0.0,0.0);
+								bus[indexer].DynCurrent[2] = complex(0.0,0.0);
+							}
+							else	//Never was, just fail out
+							{
+								GL_THROW("NR_solver: bus:%s has tried updating deltamode dynamics, but is not three-phase!",bus[indexer].name);
+								/*  TROUBLESHOOT
+								The NR_solver routine tried update a three-phase current value for a bus that is not
+								three phase.  At this time, the deltamode system only supports three-phase buses for
+								generator attachment.
+								*/
+							}
+						}
+					}//End Norton-equivalent call
+					else	//Must be another generator
+					{
+						//Replicate the injection from above -- assume three-phase right now
+						//Don't get added in as part of "normal swing" routine
+						if ((bus[indexer].type == 0) || ((bus[indexer].type>1) && (bus[indexer].swing_functions_enabled == false)))
+						{
+							//Add these into the system - added because "generation"
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size] += bus[indexer].DynCurrent[0].Re();		//Phase A
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 1] += bus[indexer].DynCurrent[1].Re();	//Phase B
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 2] += bus[indexer].DynCurrent[2].Re();	//Phase C
+
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc] += bus[indexer].DynCurrent[0].Im();		//Phase A
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 1] += bus[indexer].DynCurrent[1].Im();	//Phase B
+							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 2] += bus[indexer].DynCurrent[2].Im();	//Phase C
+						}
+						//Defaulted else - leave as they were - if it is still a swing, this is all moot anyways
+					}//End other generator delta call
+				}//End extra current adds
+			}//End dynamic (generator postings)
+		}//End part of this island check
+		//Default else -- not in this island, so skip us!
+	}//End delta_I for each bus
 
-				//Store the new size
-				powerflow_values->island_matrix_values[island_loop_index].max_size_offdiag_PQ = powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ;
+	//Call the load subfunction - flag for Jacobian update
+	compute_load_values(bus_count,bus,powerflow_values,true,island_loop_index);
 
-				//Flag for a reallocation
-				powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
-			}
+	//Build the dynamic diagnal elements of 6n*6n Y matrix. All the elements in this part will be updated at each iteration.
 
-			//Zero the indexer term used in the next section
-			powerflow_values->island_matrix_values[island_loop_index].indexer = 0;
-		}//End island loop
+	//Reset it
+	powerflow_values->island_matrix_values[island_loop_index].size_diag_update = 0;
 
-		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse through all of the branches
+	//Adjust it
+	for (jindexer=0; jindexer<bus_count;jindexer++) 
+	{
+		//Check our relevance to this matrix
+		if (bus[jindexer].island_number == island_loop_index)
 		{
-			//Extract both ends
-			tempa  = branch[jindexer].from;
-			tempb  = branch[jindexer].to;
+			if  (bus[jindexer].type != 1)	//PV bus ignored (for now?)
+				powerflow_values->island_matrix_values[island_loop_index].size_diag_update += powerflow_values->BA_diag[jindexer].size; 
+			//Defaulted else - PV bus ignored
+		}
+		//Default else -- different island, skip for now
+	}
+	
+	if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_update == NULL)
+	{
+		powerflow_values->island_matrix_values[island_loop_index].Y_diag_update = (Y_NR *)gl_malloc((4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update) *sizeof(Y_NR));   //powerflow_values->island_matrix_values[island_loop_index].Y_diag_update store the row,column and value of the dynamic part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
 
-			//Pull the island index off the from bus -- for islands, both ends SHOULD be in the same index
-			island_index_val = bus[tempa].island_number;
+		//Make sure it worked
+		if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_update == NULL)
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-			//Make sure it isn't invalid -- if it is, just skip this, since that means these lines do nothing anyways
-			if (island_index_val == -1)
-			{
-				continue;
-			}
+		//Update maximum size
+		powerflow_values->island_matrix_values[island_loop_index].max_size_diag_update = powerflow_values->island_matrix_values[island_loop_index].size_diag_update;
+	}
+	else if (powerflow_values->island_matrix_values[island_loop_index].size_diag_update > powerflow_values->island_matrix_values[island_loop_index].max_size_diag_update)	//We've exceeded our limits
+	{
+		//Disappear the old one
+		gl_free(powerflow_values->island_matrix_values[island_loop_index].Y_diag_update);
 
-			phase_worka = 0;
-			phase_workb = 0;
-			for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
-			{
-				phase_worka += ((bus[tempa].phases & (0x01 << jindex)) >> jindex);
-				phase_workb += ((bus[tempb].phases & (0x01 << jindex)) >> jindex);
-			}
+		//Make a new one in its image
+		powerflow_values->island_matrix_values[island_loop_index].Y_diag_update = (Y_NR *)gl_malloc((4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update) *sizeof(Y_NR));
 
-			if ((phase_worka==3) && (phase_workb==3))	//Both ends are full three phase, normal operations
+		//Make sure it worked
+		if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_update == NULL)
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+
+		//Update the size
+		powerflow_values->island_matrix_values[island_loop_index].max_size_diag_update = powerflow_values->island_matrix_values[island_loop_index].size_diag_update;
+
+		//Flag for a realloc
+		powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
+	}
+
+	indexer = 0;	//Rest positional counter
+
+	for (jindexer=0; jindexer<bus_count; jindexer++)	//Parse through bus list
+	{
+		//See if we're part of the currently progressing island -- if not, skip us
+		if (bus[jindexer].island_number == island_loop_index)
+		{
+			if ((bus[jindexer].type > 1) && (bus[jindexer].swing_functions_enabled == true))	//Swing bus - and we aren't ignoring it
 			{
-				for (jindex=0; jindex<3; jindex++)		//Loop through rows of admittance matrices				
+				for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
 				{
-					//See if this row is valid for this branch
-					phase_workd = 0x04 >> jindex;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = 1e10; // swing bus gets large admittance
+					indexer += 1;
+
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind + powerflow_values->BA_diag[jindexer].size;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re();	//Normal admittance portion
+					indexer += 1;
+
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind - powerflow_values->BA_diag[jindexer].size;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re();	//Normal admittance portion
+					indexer += 1;
+
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = 1e10; // swing bus gets large admittance
+					indexer += 1;
+				}//End swing bus traversion
+			}//End swing bus
+
+			if ((bus[jindexer].type == 0) || ((bus[jindexer].type > 1) && bus[jindexer].swing_functions_enabled == false))	//Only do on PQ (or SWING masquerading as PQ)
+			{
+				for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
+				{
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Im() + bus[jindexer].Jacob_A[jindex]; // Equation(14)
+					indexer += 1;
+					
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind + powerflow_values->BA_diag[jindexer].size;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re() + bus[jindexer].Jacob_B[jindex]; // Equation(15)
+					indexer += 1;
+					
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = 2*bus[jindexer].Matrix_Loc + jindex;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re() + bus[jindexer].Jacob_C[jindex]; // Equation(16)
+					indexer += 1;
+					
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
+					powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Im() + bus[jindexer].Jacob_D[jindex]; // Equation(17)
+					indexer += 1;
+				}//end PQ phase traversion
+			}//End PQ bus
+		}//End island relevance check
+	}//End bus parse list
+
+	// Build the Amatrix, Amatrix includes all the elements of Y_offdiag_PQ, Y_diag_fixed and Y_diag_update.
+	powerflow_values->island_matrix_values[island_loop_index].size_Amatrix = powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2 + powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2 + 4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update;
+
+	//Test to make sure it isn't an empty matrix - reliability induced 3-phase fault
+	if (powerflow_values->island_matrix_values[island_loop_index].size_Amatrix==0)
+	{
+		//Set our return code, like success
+		powerflow_values->island_matrix_values[island_loop_index].return_code = 0;
 
-					if ((branch[jindexer].phases & phase_workd) == phase_workd)	//Validity check
-					{
-						for (kindex=0; kindex<3; kindex++)	//Loop through columns of admittance matrices
-						{
-							//Extract column information
-							phase_worke = 0x04 >> kindex;
+		//Nothing to solve - this island is done
+		return NR_ISLAND_EMPTY;
+	}
 
-							if ((branch[jindexer].phases & phase_worke) == phase_worke)	//Valid column too!
-							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								}
+	if (powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix == NULL)
+	{
+		powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix = (SPARSE*) gl_malloc(sizeof(SPARSE));
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								}
+		//Make sure it worked
+		if (powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix == NULL)
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-								}
+		//Initiliaze it
+		sparse_init(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, powerflow_values->island_matrix_values[island_loop_index].size_Amatrix, 6*powerflow_values->island_matrix_values[island_loop_index].bus_count);
+	}
+	else if (powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed)	//If one of the above changed, we changed too
+	{
+		//Destroy the old version
+		sparse_clear(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix);
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-								}
-							}//End valid column
-						}//column end
-					}//End valid row
-				}//row end
-			}//if all 3 end
-			else if (((bus[tempa].phases & 0x80) == 0x80) || ((bus[tempb].phases & 0x80) == 0x80))	//Someone's a triplex
+		//Create a new 
+		sparse_init(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, powerflow_values->island_matrix_values[island_loop_index].size_Amatrix, 6*powerflow_values->island_matrix_values[island_loop_index].bus_count);
+	}
+	else
+	{
+		//Just clear it out
+		sparse_reset(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, 6*powerflow_values->island_matrix_values[island_loop_index].bus_count);
+	}
+
+	//integrate off diagonal components
+	for (indexer=0; indexer<powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2; indexer++)
+	{
+		row = powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ[indexer].row_ind;
+		col = powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ[indexer].col_ind;
+		value = powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ[indexer].Y_value;
+		sparse_add(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, row, col, value, bus, bus_count, powerflow_values, island_loop_index);
+	}
+
+	//Integrate fixed portions of diagonal components
+	for (indexer=0; indexer< (powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2); indexer++)
+	{
+		row = powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed[indexer].row_ind;
+		col = powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed[indexer].col_ind;
+		value = powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed[indexer].Y_value;
+		sparse_add(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, row, col, value, bus, bus_count, powerflow_values, island_loop_index);
+	}
+
+	//Integrate the variable portions of the diagonal components
+	for (indexer=0; indexer< (4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update); indexer++)
+	{
+		row = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
+		col = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind;
+		value = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value;
+		sparse_add(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, row, col, value, bus, bus_count, powerflow_values, island_loop_index);
+	}
+
+	//See if we want to dump out the matrix values
+	if (NRMatDumpMethod != MD_NONE)
+	{
+		//Code to export the sparse matrix values - useful for debugging issues
+
+		//Reset the flag
+		something_has_been_output = false;
+
+		//Check our frequency
+		if ((NRMatDumpMethod == MD_ALL) || ((NRMatDumpMethod != MD_ALL) && (powerflow_values->island_matrix_values[island_loop_index].iteration_count == 0)))
+		{
+			//Open the text file - append now
+			FPoutVal=fopen(MDFileName,"at");
+
+			//See if we wanted references - Only do this once per call, regardless (keeps file size down)
+			if ((NRMatReferences == true) && (powerflow_values->island_matrix_values[island_loop_index].iteration_count == 0))
 			{
-				if (((bus[tempa].phases & 0x80) == 0x80) && ((bus[tempb].phases & 0x80) == 0x80))	//Both are triplex, easy case
+				//Print the index information
+				if (NR_islands_detected > 1)
 				{
-					for (jindex=0; jindex<2; jindex++)		//Loop through rows of admittance matrices (only 2x2)
+					fprintf(FPoutVal,"Matrix Index information for this call in island:%d - start,stop,name\n",(island_loop_index+1));
+				}
+				else
+				{
+					fprintf(FPoutVal,"Matrix Index information for this call - start,stop,name\n");
+				}
+
+				for (indexer=0; indexer<bus_count; indexer++)
+				{
+					//Island check
+					if (bus[indexer].island_number == island_loop_index)
 					{
-						for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
-						{
-							//Make sure one end of us isn't a SPCT transformer To node (they are different)
-							if (((bus[tempa].phases & 0x20) & (bus[tempb].phases & 0x20)) == 0x20)	//Both ends are SPCT tos
-							{
-								GL_THROW("NR: SPCT to SPCT via triplex connections are unsupported at this time.");
-								/*  TROUBLESHOOT
-								The Newton-Raphson solve does not currently support running a triplex line between the low-voltage
-								side of two different split-phase center tapped transformers.  This functionality may be added if needed
-								in the future.
-								*/
-							}//end both ends SPCT to
-							else if ((bus[tempa].phases & 0x20) == 0x20)	//From end is a SPCT to
-							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+						//Extract the start/stop indices
+						jindexer = 2*bus[indexer].Matrix_Loc;
+						kindexer = jindexer + 2*powerflow_values->BA_diag[indexer].size - 1;
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								}
+						//Print them out
+						fprintf(FPoutVal,"%d,%d,%s\n",jindexer,kindexer,bus[indexer].name);
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								}
+						//Set the flag
+						something_has_been_output = true;
+					}//End island check
+				}
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-								}
+				//Add in a blank line so it looks pretty
+				fprintf(FPoutVal,"\n");
+			}//End print the references
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-								}
-							}//end From end SPCT to
-							else if ((bus[tempb].phases & 0x20) == 0x20)	//To end is a SPCT to
-							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+			//Print the simulation time and iteration number
+			fprintf(FPoutVal,"Timestamp: %lld - Iteration %lld\n",gl_globalclock,powerflow_values->island_matrix_values[island_loop_index].iteration_count);
 
-								//Make sure we aren't the transformer
-								if (branch[jindexer].lnk_type == 1)	//We're not, we're a line - proceed
-								{
+			//See if anything wrote out
+			if (something_has_been_output == true)
+			{
+				//Print size - for parsing ease
+				fprintf(FPoutVal,"Matrix Information - non-zero element count = %d\n",powerflow_values->island_matrix_values[island_loop_index].size_Amatrix);
+				
+				//Print the values - printed as "row index, column index, value"
+				//This particular output is after they have been column sorted for the algorithm
+				//Header
+				fprintf(FPoutVal,"Matrix Information - row, column, value\n");
 
-									//Indices counted out from Self admittance above.  needs doubling due to complex separation
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+				//Null temp variable
+				temp_element = NULL;
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
+				//Loop through the columns, extracting starting point each time
+				for (jindexer=0; jindexer<powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix->ncols; jindexer++)
+				{
+					//Extract the column starting point
+					temp_element = powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix->cols[jindexer];
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+					//Check for nulling
+					if (temp_element != NULL)
+					{
+						//Print this value
+						fprintf(FPoutVal,"%d,%d,%f\n",temp_element->row_ind,jindexer,temp_element->value);
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
+						//Loop
+						while (temp_element->next != NULL)
+						{
+							//Get next element
+							temp_element = temp_element->next;
 
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							//Repeat the print
+							fprintf(FPoutVal,"%d,%d,%f\n",temp_element->row_ind,jindexer,temp_element->value);
+						}
+					}
+					//If it is null, go next.  Implies we have an invalid matrix size, but that may be what we're looking for
+				}//End sparse matrix traversion for dump
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
+				//Print an extra line, so it looks nice for ALL/PERCALL
+				fprintf(FPoutVal,"\n");
+			}
+			else //Nothing written - indicate as much
+			{
+				//Print the emptiness
+				fprintf(FPoutVal,"Empty island (possibly powerflow-removed)\n\n");
+			}
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+			//Close the file, we're done with it
+			fclose(FPoutVal);
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
-								}//End SPCT TO bus and we're a line
-								else	//Transformer to - don't do things weird
-								{
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+			//See if we were a "ONCE" - if so, deflag us
+			if (NRMatDumpMethod == MD_ONCE)
+			{
+				//See if we're a multi-island -- if so, only do this on the last one
+				if (NR_islands_detected > 1)
+				{
+					//See if we're the last one
+					if (island_loop_index >= (NR_islands_detected - 1))
+					{
+						NRMatDumpMethod = MD_NONE;	//Flag to do no more
+					}
+					//Default else -- we're not the last one, so stay as MD_ONCE
+				}
+				else
+				{
+					NRMatDumpMethod = MD_NONE;	//Flag to do no more
+				}
+			}
+		}//End Actual output
+	}//End matrix dump desired
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
+	///* Initialize parameters. */
+	m = 2*powerflow_values->island_matrix_values[island_loop_index].total_variables;
+	n = 2*powerflow_values->island_matrix_values[island_loop_index].total_variables;
+	nnz = powerflow_values->island_matrix_values[island_loop_index].size_Amatrix;
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+	if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU == NULL)	//First run
+	{
+		/* Set aside space for the arrays. */
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU = (double *) gl_malloc(nnz *sizeof(double));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU==NULL)
+		{
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+			/*  TROUBLESHOOT
+			While attempting to allocate the memory for one of the SuperLU working matrices,
+			an error was encountered and it was not allocated.  Please try again.  If it fails
+			again, please submit your code and a bug report using the trac website.
+			*/
+		}
+		
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU = (int *) gl_malloc(nnz *sizeof(int));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU == NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU = (int *) gl_malloc((n+1) *sizeof(int));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU == NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+		/* Create the right-hand side matrix B. */
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU = (double *) gl_malloc(m *sizeof(double));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU == NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
+		if (matrix_solver_method==MM_SUPERLU)
+		{
+			///* Set up the arrays for the permutations. */
+			curr_island_superLU_vars->perm_r = (int *) gl_malloc(m *sizeof(int));
+			if (curr_island_superLU_vars->perm_r == NULL)
+				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
-									{
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+			curr_island_superLU_vars->perm_c = (int *) gl_malloc(n *sizeof(int));
+			if (curr_island_superLU_vars->perm_c == NULL)
+				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
-										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									}
-								}//End SPCT TO and we're the transformer
-							}//end To end SPCT to
-							else											//Plain old ugly line
-							{
-								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+			//Set up storage pointers - single element, but need to be malloced for some reason
+			curr_island_superLU_vars->A_LU.Store = (void *)gl_malloc(sizeof(NCformat));
+			if (curr_island_superLU_vars->A_LU.Store == NULL)
+				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								}
+			curr_island_superLU_vars->B_LU.Store = (void *)gl_malloc(sizeof(DNformat));
+			if (curr_island_superLU_vars->B_LU.Store == NULL)
+				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								}
+			//Populate these structures - A_LU matrix
+			curr_island_superLU_vars->A_LU.Stype = SLU_NC;
+			curr_island_superLU_vars->A_LU.Dtype = SLU_D;
+			curr_island_superLU_vars->A_LU.Mtype = SLU_GE;
+			curr_island_superLU_vars->A_LU.nrow = n;
+			curr_island_superLU_vars->A_LU.ncol = m;
+
+			//Populate these structures - B_LU matrix
+			curr_island_superLU_vars->B_LU.Stype = SLU_DN;
+			curr_island_superLU_vars->B_LU.Dtype = SLU_D;
+			curr_island_superLU_vars->B_LU.Mtype = SLU_GE;
+			curr_island_superLU_vars->B_LU.nrow = m;
+			curr_island_superLU_vars->B_LU.ncol = 1;
+		}
+		else if ((matrix_solver_method == MM_EXTERN) || (matrix_solver_method == MM_KLU))	//External routine
+		{
+			//Run allocation routine
+			((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,n,n,NR_admit_change);
+		}
+		else
+		{
+			GL_THROW("Invalid matrix solution method specified for NR solver!");
+			//Defined elsewhere
+		}
 
-								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-								}
+		//Update tracking variable
+		powerflow_values->island_matrix_values[island_loop_index].prev_m = m;
+	}
+	else if (powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed)	//Something changed, we'll just destroy everything and start over
+	{
+		//Get rid of all of them first
+		gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU);
+		gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU);
+		gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU);
+		gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU);
 
-								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
-								{
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-									
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
-									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
-									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-								}
-							}//end Normal triplex branch
-						}//column end
-					}//row end
-				}//end both triplexy
-				else if ((bus[tempa].phases & 0x80) == 0x80)	//From is the triplex - this implies transformer with or something, we don't support this
-				{
-					GL_THROW("NR does not support triplex to 3-phase connections.");
-					/*  TROUBLESHOOT
-					The Newton-Raphson solver does not have any implementation elements
-					to support the connection of a split-phase or triplex node to a three-phase
-					node.  The opposite (3-phase to triplex) is available as the split-phase-center-
-					tapped transformer model.  See if that will work for your implementation.
-					*/
-				}//end from triplexy
-				else	//Only option left is the to must be the triplex - implies SPCT xformer - so only one phase on the three-phase side (we just need to figure out where)
-				{
-					//Extract the line phase
-					phase_workc = (branch[jindexer].phases & 0x07);
+		if (matrix_solver_method==MM_SUPERLU)
+		{
+			//Free up superLU matrices
+			gl_free(curr_island_superLU_vars->perm_r);
+			gl_free(curr_island_superLU_vars->perm_c);
 
-					//Reset temp_index and size, just in case
-					temp_index = -1;
-					temp_size = -1;
+			//The matrix is being rebuilt, so the cached ordering goes too
+			superLU_ordering_clear(curr_island_superLU_vars);
+		}
+		//Default else - don't care - destructions are presumed to be handled inside external LU's alloc function
 
-					//Figure out what the offset on the from side is (how many phases and which one we are)
-					switch(bus[tempa].phases & 0x07)
-					{
-						case 0x01:	//C
-							{
-								temp_size = 1;	//Single phase matrix
+		/* Set aside space for the arrays. - Copied from above */
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU = (double *) gl_malloc(nnz *sizeof(double));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU==NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+		
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU = (int *) gl_malloc(nnz *sizeof(int));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU == NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//Only C in the node, so no offset
-									temp_index = 0;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-									/*  TROUBLESHOOT
-									A split-phase, center-tapped transformer in the Newton-Raphson solver is somehow attached
-									to a node that is missing the required phase of the transformer.  This should have been caught.
-									Please submit your code and a bug report using the trac website.
-									*/
-								}
-								else					//Has to be phase A
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU = (int *) gl_malloc((n+1) *sizeof(int));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU == NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-								break;
-							}
-						case 0x02:	//B
-							{
-								temp_size = 1;	//Single phase matrix
+		/* Create the right-hand side matrix B. */
+		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU = (double *) gl_malloc(m *sizeof(double));
+		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU == NULL)
+			GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-								if (phase_workc==0x01)	//Line is phase C
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//Only B in the node, so no offset
-									temp_index = 0;
-								}
-								else					//Has to be phase A
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+		if (matrix_solver_method==MM_SUPERLU)
+		{
+			///* Set up the arrays for the permutations. */
+			curr_island_superLU_vars->perm_r = (int *) gl_malloc(m *sizeof(int));
+			if (curr_island_superLU_vars->perm_r == NULL)
+				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-								break;
-							}
-						case 0x03:	//BC
-							{
-								temp_size = 2;	//Two phase matrix
+			curr_island_superLU_vars->perm_c = (int *) gl_malloc(n *sizeof(int));
+			if (curr_island_superLU_vars->perm_c == NULL)
+				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//BC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//BC in the node, so offset by 0
-									temp_index = 0;
-								}
-								else					//Has to be phase A
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+			//Update structures - A_LU matrix
+			curr_island_superLU_vars->A_LU.Stype = SLU_NC;
+			curr_island_superLU_vars->A_LU.Dtype = SLU_D;
+			curr_island_superLU_vars->A_LU.Mtype = SLU_GE;
+			curr_island_superLU_vars->A_LU.nrow = n;
+			curr_island_superLU_vars->A_LU.ncol = m;
+
+			//Update structures - B_LU matrix
+			curr_island_superLU_vars->B_LU.Stype = SLU_DN;
+			curr_island_superLU_vars->B_LU.Dtype = SLU_D;
+			curr_island_superLU_vars->B_LU.Mtype = SLU_GE;
+			curr_island_superLU_vars->B_LU.nrow = m;
+			curr_island_superLU_vars->B_LU.ncol = 1;
+		}
+		else if ((matrix_solver_method == MM_EXTERN) || (matrix_solver_method == MM_KLU))	//External routine
+		{
+			//Run allocation routine
+			((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,n,n,NR_admit_change);
+		}
+		else
+		{
+			GL_THROW("Invalid matrix solution method specified for NR solver!");
+			//Defined elsewhere
+		}
 
-								break;
-							}
-						case 0x04:	//A
-							{
-								temp_size = 1;	//Single phase matrix
+		//Update tracking variable
+		powerflow_values->island_matrix_values[island_loop_index].prev_m = m;
+	}
+	else if (powerflow_values->island_matrix_values[island_loop_index].prev_m != m)	//Non-reallocing size change occurred
+	{
+		if (matrix_solver_method==MM_SUPERLU)
+		{
+			//Update relevant portions
+			curr_island_superLU_vars->A_LU.nrow = n;
+			curr_island_superLU_vars->A_LU.ncol = m;
 
-								if (phase_workc==0x01)	//Line is phase C
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else if (phase_workc==0x02)	//Line is phase B
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else					//Has to be phase A
-								{
-									//Only A in the node, so no offset
-									temp_index = 0;
-								}
+			curr_island_superLU_vars->B_LU.nrow = m;
+		}
+		else if ((matrix_solver_method == MM_EXTERN) || (matrix_solver_method == MM_KLU))	//External routine - call full reallocation, just in case
+		{
+			//Run allocation routine
+			((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,n,n,NR_admit_change);
+		}
+		else
+		{
+			GL_THROW("Invalid matrix solution method specified for NR solver!");
+			//Defined elsewhere
+		}
 
-								break;
-							}
-						case 0x05:	//AC
-							{
-								temp_size = 2;	//Two phase matrix
+		//Update tracking variable
+		powerflow_values->island_matrix_values[island_loop_index].prev_m = m;
+	}
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//AC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else					//Has to be phase A
-								{
-									//AC in the node, so offset by 0
-									temp_index = 0;
-								}
+#ifndef MT
+	if (matrix_solver_method==MM_SUPERLU)
+	{
+		/* superLU sequential options*/
+		set_default_options ( &options );
+	}
+	//Default else - not superLU
+#endif
+	
+	sparse_tonr(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, &powerflow_values->island_matrix_values[island_loop_index].matrices_LU);
+	powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU[n] = nnz ;// number of non-zeros;
 
-								break;
-							}
-						case 0x06:	//AB
-							{
-								temp_size = 2;	//Two phase matrix
+	//Determine how to populate the rhs vector
+	if (mesh_imped_vals == NULL)	//Normal powerflow, copy in the values
+	{
+		for (temp_index_c=0;temp_index_c<m;temp_index_c++)
+		{ 
+			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU[temp_index_c] = powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[temp_index_c];
+		}
+	}
+	//Default else -- it is NULL - zero it and "populate it" below
 
-								if (phase_workc==0x01)	//Line is phase C
-									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//BC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else					//Has to be phase A
-								{
-									//AB in the node, so offset by 0
-									temp_index = 0;
-								}
+	if (matrix_solver_method==MM_SUPERLU)
+	{
+		////* Create Matrix A in the format expected by Super LU.*/
+		//Populate the matrix values (temporary value)
+		Astore = (NCformat*)curr_island_superLU_vars->A_LU.Store;
+		Astore->nnz = nnz;
+		Astore->nzval = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU;
+		Astore->rowind = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU;
+		Astore->colptr = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU;
+		
+		// Create right-hand side matrix B in format expected by Super LU
+		//Populate the matrix (temporary values)
+		Bstore = (DNformat*)curr_island_superLU_vars->B_LU.Store;
+		Bstore->lda = m;
+		Bstore->nzval = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU;
+
+		//See how to call the function - if normal mode or not
+		//**************************** How will this work with islanding stuff !?!?!?!? ****************************
+		if (mesh_imped_vals != NULL)
+		{
+			//Start with "failure" option on the structure
+			mesh_imped_vals->return_code = 0;
 
-								break;
-							}
-						case 0x07:	//ABC
-							{
-								temp_size = 3;	//Three phase matrix
+			//Determine the base index (error check)
+			if (mesh_imped_vals->NodeRefNum > 0)
+			{
+				tempa = 2*bus[mesh_imped_vals->NodeRefNum].Matrix_Loc;	//These are already separated into real/imag, so the base is 2x
+			}
+			else	//Error
+			{
+				gl_error("solver_nr: Node reference for mesh fault calculation was invalid -- it may be a child");
+				/*  TROUBLESHOOT
+				While attempting to compute the equivalent impedance at a mesh faulted node, an invalid node reference
+				was found.  This is likely an internal error to the code -- submit your code and a bug report via the
+				tracking website.
+				*/
 
-								if (phase_workc==0x01)	//Line is phase C
-								{
-									//ABC in the node, so offset by 2
-									temp_index = 2;
-								}
-								else if (phase_workc==0x02)	//Line is phase B
-								{
-									//ABC in the node, so offset by 1
-									temp_index = 1;
-								}
-								else					//Has to be phase A
-								{
-									//ABC in the node, so offset by 0
-									temp_index = 0;
-								}
+				//Set the flags
+				mesh_imped_vals->return_code = 0;
+				*bad_computations = true;
 
-								break;
-							}
-						default:
-							GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-							break;
-					}//end switch
-					if ((temp_index==-1) || (temp_size==-1))	//Should never get here
-						GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
-
-					//Determine first index
-					if (phase_workc==0x01)	//Line is phase C
-					{
-						jindex=2;
-					}//end line C if
-					else if (phase_workc==0x02)	//Line is phase B
-					{
-						jindex=1;
-					}//end line B if
-					else						//Line has to be phase A
-					{
-						jindex=0;
-					}//End line A if
+				//Return a 0 to flag
+				*exit_value = 0;
+				return NR_ISLAND_EXIT;
+			}
 
+			//Determine our phasing size - what entries to pull - double for the complex notation
+			temp_size = 2*powerflow_values->BA_diag[mesh_imped_vals->NodeRefNum].size;
 
-					//Indices counted out from Self admittance above.  needs doubling due to complex separation
-					for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
-					{
+			//Check for error - size of zero
+			if (temp_size == 0)
+			{
+				gl_error("solver_nr: Mesh fault impedance extract failed - invalid node");
+				/*  TROUBLESHOOT
+				While attempting to extract the mesh fault impedance value, a node with either
+				invalid phasing or no phases (already removed) was somehow flagged.  Please check
+				your file and try again.  If the error persists, please submit your code
+				and a bug report via the ticketing system.
+				*/
 
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-						{
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-						}
+				//Flags
+				*bad_computations = true;
+				mesh_imped_vals->return_code = 0;
 
-						if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-						{
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Im());
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[kindex*3+jindex]).Im();
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-						}
+				//Exit
+				*exit_value = 0;
+				return NR_ISLAND_EXIT;
+			}
+			//Default else -- okay
 
-						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-						{
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-						}
+			//Clear out the output matrix first -- assumes it is 3x3, regardless
+			for (jindex=0; jindex<9; jindex++)
+			{
+				mesh_imped_vals->z_matrix[jindex] = complex(0.0,0.0);
+			}
 
-						if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-						{
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
-							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
-							powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-						}
-					}//secondary index end
+			//Zero the double matrix - the big storage (6x6 - re & im split)
+			for (jindex=0; jindex<6; jindex++)
+			{
+				for (kindex=0; kindex<6; kindex++)
+				{
+					temp_z_store[jindex][kindex] = 0.0;
+				}
+			}
 
-				}//end to triplexy
-			}//end triplex in here
-			else					//Some combination of not-3 phase
+			//Overall loop - for number of phases
+			for (kindex=0; kindex<temp_size; kindex++)
 			{
-				//Clear working variables, just in case
-				temp_index = temp_index_b = -1;
-				temp_size = temp_size_b = temp_size_c = -1;
-				Full_Mat_A = Full_Mat_B = false;
 
-				//Intermediate store the admittance matrices so they can be directly indexed later
-				switch(branch[jindexer].phases & 0x07) {
-					case 0x00:	//No phases (open switch or reliability excluded item)
-						{
-							temp_size_c = -99;	//Arbitrary flag
-							break;
-						}
-					case 0x01:	//C only
-						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[8];
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[8];
-							temp_size_c = 1;
-							break;
-						}
-					case 0x02:	//B only
-						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
-							temp_size_c = 1;
-							break;
-						}
-					case 0x03:	//BC only
-						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
-							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[5];
-							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[7];
-							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
-							
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
-							Temp_Ad_B[0][1] = branch[jindexer].Yto[5];
-							Temp_Ad_B[1][0] = branch[jindexer].Yto[7];
-							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
+				//Start by zeroing the "solution" vector
+				for (temp_index_c=0;temp_index_c<m;temp_index_c++)
+				{ 
+					powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU[temp_index_c] = 0.0;
+				}
 
-							temp_size_c = 2;
-							break;
-						}
-					case 0x04:	//A only
-						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
-							temp_size_c = 1;
-							break;
-						}
-					case 0x05:	//AC only
-						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
-							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[2];
-							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[6];
-							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
-							
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
-							Temp_Ad_B[0][1] = branch[jindexer].Yto[2];
-							Temp_Ad_B[1][0] = branch[jindexer].Yto[6];
-							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
+				//"Identity"-ize the real part of the current index
+				powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU[tempa + kindex] = 1.0;
 
-							temp_size_c = 2;
-							break;
-						}
-					case 0x06:	//AB only
-						{
-							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
-							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[1];
-							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[3];
-							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[4];
-							
-							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
-							Temp_Ad_B[0][1] = branch[jindexer].Yto[1];
-							Temp_Ad_B[1][0] = branch[jindexer].Yto[3];
-							Temp_Ad_B[1][1] = branch[jindexer].Yto[4];
+				//Do a solution to get this entry (copied from below - includes "destructors"
+#ifdef MT
+				//superLU_MT commands
 
-							temp_size_c = 2;
-							break;
-						}
-					default:
-						{
-							break;
-						}
-				}//end line switch/case
+				//Solve the system, reusing the symbolic analysis if the pattern is unchanged
+				superLU_factor_solve(curr_island_superLU_vars, &powerflow_values->island_matrix_values[island_loop_index].matrices_LU, n, nnz, &L_LU, &U_LU, &info);
 
-				if (temp_size_c==-99)
-				{
-					continue;	//Next iteration of branch loop
-				}
+				/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
+				//superLU_MT commands
+				Destroy_SuperNode_SCP(&L_LU);
+				Destroy_CompCol_NCP(&U_LU);
+#else
+				//sequential superLU
 
-				if (temp_size_c==-1)	//Make sure it is right
+				StatInit ( &stat );
+
+				// solve the system
+				dgssv(&options, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c, curr_island_superLU_vars->perm_r, &L_LU, &U_LU, &curr_island_superLU_vars->B_LU, &stat, &info);
+
+				/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
+				//sequential superLU commands
+				Destroy_SuperNode_Matrix( &L_LU );
+				Destroy_CompCol_Matrix( &U_LU );
+				StatFree ( &stat );
+#endif
+				//Crude superLU checks - see if it is mission accomplished or not
+				if (info != 0)	//Failed inversion, for various reasons
 				{
-					GL_THROW("NR: A line's phase was flagged as not full three-phase, but wasn't: (%s) %u %u", 
-									 branch[jindexer].name, branch[jindexer].phases, branch[jindexer].origphases);
+					gl_error("solver_nr: superLU failed mesh fault matrix inversion with code %d",info);
 					/*  TROUBLESHOOT
-					A line inside the powerflow model was flagged as not being full three-phase or
-					triplex in any form.  It failed the other cases though, so it must have been.
-					Please submit your code and a bug report to the trac website.
+					superLU failed to invert the equivalent impedance matrix for the mesh fault calculation
+					method.  Please try again and make sure your system is valid.  If the error persists, please
+					submit your code and a bug report via the ticketing system.
 					*/
+
+					//Flag as bad
+					*bad_computations = true;
+					mesh_imped_vals->return_code = 0;
+
+					//Exit
+					*exit_value = 0;
+					return NR_ISLAND_EXIT;
 				}
+				//Default else, must have converged!
 
-				//Check the from side and get all appropriate offsets
-				switch(bus[tempa].phases & 0x07) {
-					case 0x01:	//C
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_size = 1;		//Single size
-								temp_index = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-								/*  TROUBLESHOOT
-								One of the lines in the powerflow model has an invalid phase in
-								reference to its to and from ends.  This should have been caught
-								earlier, so submit your code and a bug report using the trac website.
-								*/
-							}
-							break;
-						}//end 0x01
-					case 0x02:	//B
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_size = 1;		//Single size
-								temp_index = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x02
-					case 0x03:	//BC
-						{
-							temp_size = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
-							{
-								temp_index = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x03
-					case 0x04:	//A
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_size = 1;		//Single size
-								temp_index = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x04
-					case 0x05:	//AC
-						{
-							temp_size = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
-							{
-								temp_index = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x05
-					case 0x06:	//AB
-						{
-							temp_size = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
-							{
-								temp_index = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x06
-					case 0x07:	//ABC
-						{
-							temp_size = 3;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index = 2;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
-							{
-								temp_index = 1;
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
-							{
-								temp_index = 0;
-								Full_Mat_A = true;		//Flag so we know C needs to be gapped
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
-							{
-								temp_index = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x07
-					default:
+				//Map up the solution vector
+				sol_LU = (double*) ((DNformat*) curr_island_superLU_vars->B_LU.Store)->nzval;
+
+				//Extract out this column into the temporary matrix
+				for (jindex=0; jindex<temp_size; jindex++)
+				{
+					temp_z_store[jindex][kindex] = sol_LU[tempa+jindex];
+				}
+			}//End "phase loop" - impedance components are ready
+
+			//Extract the values - do with a massive case/switch, just because
+			switch(bus[mesh_imped_vals->NodeRefNum].phases & 0x07) {
+				case 0x01:	//C
+					{
+						mesh_imped_vals->z_matrix[8] = complex(temp_z_store[1][0],temp_z_store[1][1]);
+						break;
+					}
+				case 0x02:	//B
+					{
+						mesh_imped_vals->z_matrix[4] = complex(temp_z_store[1][0],temp_z_store[1][1]);
+						break;
+					}
+				case 0x03:	//BC
+					{
+						//BB and BC portion
+						mesh_imped_vals->z_matrix[4] = complex(temp_z_store[2][0],temp_z_store[2][2]);
+						mesh_imped_vals->z_matrix[5] = complex(temp_z_store[2][1],temp_z_store[2][3]);
+
+						//CB and CC portion
+						mesh_imped_vals->z_matrix[7] = complex(temp_z_store[3][0],temp_z_store[3][2]);
+						mesh_imped_vals->z_matrix[8] = complex(temp_z_store[3][1],temp_z_store[3][3]);
+						break;
+					}
+				case 0x04:	//A
+					{
+						mesh_imped_vals->z_matrix[0] = complex(temp_z_store[1][0],temp_z_store[1][1]);
+						break;
+					}
+				case 0x05:	//AC
+					{
+						//AA and AC portion
+						mesh_imped_vals->z_matrix[0] = complex(temp_z_store[2][0],temp_z_store[2][2]);
+						mesh_imped_vals->z_matrix[2] = complex(temp_z_store[2][1],temp_z_store[2][3]);
+
+						//CA and CC portion
+						mesh_imped_vals->z_matrix[6] = complex(temp_z_store[3][0],temp_z_store[3][2]);
+						mesh_imped_vals->z_matrix[8] = complex(temp_z_store[3][1],temp_z_store[3][3]);
+						break;
+					}
+				case 0x06:	//AB
+					{
+						//AA and AB portion
+						mesh_imped_vals->z_matrix[0] = complex(temp_z_store[2][0],temp_z_store[2][2]);
+						mesh_imped_vals->z_matrix[1] = complex(temp_z_store[2][1],temp_z_store[2][3]);
+
+						//BA and BB portion
+						mesh_imped_vals->z_matrix[3] = complex(temp_z_store[3][0],temp_z_store[3][2]);
+						mesh_imped_vals->z_matrix[4] = complex(temp_z_store[3][1],temp_z_store[3][3]);
+						break;
+					}
+				case 0x07:	//ABC
+					{
+						//A row
+						mesh_imped_vals->z_matrix[0] = complex(temp_z_store[3][0],temp_z_store[3][3]);
+						mesh_imped_vals->z_matrix[1] = complex(temp_z_store[3][1],temp_z_store[3][4]);
+						mesh_imped_vals->z_matrix[2] = complex(temp_z_store[3][2],temp_z_store[3][5]);
+
+						//B row
+						mesh_imped_vals->z_matrix[3] = complex(temp_z_store[4][0],temp_z_store[4][3]);
+						mesh_imped_vals->z_matrix[4] = complex(temp_z_store[4][1],temp_z_store[4][4]);
+						mesh_imped_vals->z_matrix[5] = complex(temp_z_store[4][2],temp_z_store[4][5]);
+
+						//C row
+						mesh_imped_vals->z_matrix[6] = complex(temp_z_store[5][0],temp_z_store[5][3]);
+						mesh_imped_vals->z_matrix[7] = complex(temp_z_store[5][1],temp_z_store[5][4]);
+						mesh_imped_vals->z_matrix[8] = complex(temp_z_store[5][2],temp_z_store[5][5]);
+						break;
+					}
+				default:	//Not sure how we got here
+					{
+						gl_error("solver_nr: Mesh fault impedance extract failed - invalid node");
+						//Defined above, same message
+
+						//Flags
+						*bad_computations = true;
+						mesh_imped_vals->return_code = 0;
+
+						//Exit
+						*exit_value = 0;
+						return NR_ISLAND_EXIT;
+					}
+			}//end phase switch/case
+
+			//Flag as success
+			*bad_computations = false;
+			mesh_imped_vals->return_code = 1;
+
+			//Exit
+			*exit_value = 1;
+			return NR_ISLAND_EXIT;
+		}//End "just mesh impedance calculations"
+		else	//Nulled, "normal" powerflow
+		{
+#ifdef MT
+			//superLU_MT commands
+
+			//Solve the system, reusing the symbolic analysis if the pattern is unchanged
+			superLU_factor_solve(curr_island_superLU_vars, &powerflow_values->island_matrix_values[island_loop_index].matrices_LU, n, nnz, &L_LU, &U_LU, &powerflow_values->island_matrix_values[island_loop_index].solver_info);
+#else
+			//sequential superLU
+
+			StatInit ( &stat );
+
+			// solve the system
+			dgssv(&options, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c, curr_island_superLU_vars->perm_r, &L_LU, &U_LU, &curr_island_superLU_vars->B_LU, &stat, &powerflow_values->island_matrix_values[island_loop_index].solver_info);
+#endif
+
+			sol_LU = (double*) ((DNformat*) curr_island_superLU_vars->B_LU.Store)->nzval;
+		}
+	}
+	else if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))
+	{
+		//General error check right now -- mesh fault current may not work properly
+		if (mesh_imped_vals != NULL)
+		{
+			gl_error("solver_nr: Mesh impedance attempted from unsupported LU solver");
+			/* TROUBLESHOOT
+			The mesh fault current impedance "pull" was selected, but for the external LU
+			solver.  This is unsupported at this time.  To use the mesh fault current capabilities,
+			please use the superLU solver.
+			*/
+
+			//Set return code
+			mesh_imped_vals->return_code = 2;
+
+			//Perform the clean up - external LU destructor routing
+			((void (*)(void *, bool))(LUSolverFcns.ext_destroy))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,powerflow_values->island_matrix_values[island_loop_index].new_iteration_required);
+
+			//Flag bad computations, just because
+			*bad_computations = true;
+
+			//Exit
+			*exit_value = 0;
+			return NR_ISLAND_EXIT;
+		}
+		//Default else -- not mesh fault mode, so go like normal
+
+		//Call the solver
+		powerflow_values->island_matrix_values[island_loop_index].solver_info = ((int (*)(void *,NR_SOLVER_VARS *, unsigned int, unsigned int))(LUSolverFcns.ext_solve))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,&powerflow_values->island_matrix_values[island_loop_index].matrices_LU,n,1);
+
+		//Point the solution to the proper place
+		sol_LU = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU;
+	}
+	else
+	{
+		GL_THROW("Invalid matrix solution method specified for NR solver!");
+		/*  TROUBLESHOOT
+		An invalid matrix solution method was selected for the Newton-Raphson solver method.
+		Valid options are the superLU solver or an external solver.  Please select one of these methods.
+		*/
+	}
+
+	//Update bus voltages - check convergence while we're here
+	powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge = 0;
+
+	temp_index = -1;
+	temp_index_b = -1;
+	powerflow_values->island_matrix_values[island_loop_index].new_iteration_required = false;	//Reset iteration requester flag - defaults to not needing another
+
+	for (indexer=0; indexer<bus_count; indexer++)
+	{
+		//See if we're part of the relevant island
+		if (bus[indexer].island_number == island_loop_index)
+		{
+			//Avoid swing bus updates on normal runs
+			if ((bus[indexer].type == 0) || ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == false)))
+			{
+				//Figure out the offset we need to be for each phase
+				if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
+				{
+					//Pull the two updates (assume split-phase is always 2)
+					DVConvCheck[0]=complex(sol_LU[2*bus[indexer].Matrix_Loc],sol_LU[(2*bus[indexer].Matrix_Loc+2)]);
+					DVConvCheck[1]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+1)],sol_LU[(2*bus[indexer].Matrix_Loc+3)]);
+					bus[indexer].V[0] += DVConvCheck[0];
+					bus[indexer].V[1] += DVConvCheck[1];	//Negative due to convention
+					
+					//Pull off the magnitude (no sense calculating it twice)
+					CurrConvVal=DVConvCheck[0].Mag();
+					if (CurrConvVal > powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge)	//Update our convergence check if it is bigger
+						powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge=CurrConvVal;
+
+					if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
+						powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;								//Flag that a new iteration must occur
+
+					CurrConvVal=DVConvCheck[1].Mag();
+					if (CurrConvVal > powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge)	//Update our convergence check if it is bigger
+						powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge=CurrConvVal;
+
+					if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
+						powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;								//Flag that a new iteration must occur
+				}//end split phase update
+				else										//Not split phase
+				{
+					for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)	//parse through the phases
+					{
+						switch(bus[indexer].phases & 0x07) {
+							case 0x01:	//C
+								{
+									temp_index=0;
+									temp_index_b=2;
+									break;
+								}
+							case 0x02:	//B
+								{
+									temp_index=0;
+									temp_index_b=1;
+									break;
+								}
+							case 0x03:	//BC
+								{
+									if (jindex==0)	//B
+									{
+										temp_index=0;
+										temp_index_b=1;
+									}
+									else			//C
+									{
+										temp_index=1;
+										temp_index_b=2;
+									}
+
+									break;
+								}
+							case 0x04:	//A
+								{
+									temp_index=0;
+									temp_index_b=0;
+									break;
+								}
+							case 0x05:	//AC
+								{
+									if (jindex==0)	//A
+									{
+										temp_index=0;
+										temp_index_b=0;
+									}
+									else			//C
+									{
+										temp_index=1;
+										temp_index_b=2;
+									}
+									break;
+								}
+							case 0x06:	//AB
+							case 0x07:	//ABC
+								{
+									temp_index = jindex;
+									temp_index_b = jindex;
+									break;
+								}
+						}//end phase switch/case
+
+						if ((temp_index==-1) || (temp_index_b==-1))
 						{
-							break;
+							GL_THROW("NR: An error occurred indexing voltage updates");
+							/*  TROUBLESHOOT
+							While attempting to create the voltage update indices for the
+							Newton-Raphson solver, an error was encountered.  Please submit
+							your code and a bug report using the trac website.
+							*/
 						}
-				}//End switch/case for from
 
-				//Check the to side and get all appropriate offsets
-				switch(bus[tempb].phases & 0x07) {
-					case 0x01:	//C
+						DVConvCheck[jindex]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+temp_index)],sol_LU[(2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size+temp_index)]);
+						bus[indexer].V[temp_index_b] += DVConvCheck[jindex];
+						
+						//Pull off the magnitude (no sense calculating it twice)
+						CurrConvVal=DVConvCheck[jindex].Mag();
+						if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
+							powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;								//Flag that a new iteration must occur
+
+						if (CurrConvVal > powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge)	//See if the current differential is the largest found so far or not
+							powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge = CurrConvVal;	//It is, store it
+
+					}//End For loop for phase traversion
+				}//End not split phase update
+			}//end if not swing
+			//Default else -- this must be the swing and in a valid interval
+
+			//See if this particular bus has any "current injection update" requirements - semi-silly to do this for SWING-enabled buses, but makes the code more consistent
+			if ((bus[indexer].ExtraCurrentInjFunc != NULL) && ((bus[indexer].type == 0) || ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == false))))
+			{
+				//Call the function
+				call_return_status = ((STATUS (*)(OBJECT *))(*bus[indexer].ExtraCurrentInjFunc))(bus[indexer].ExtraCurrentInjFuncObject);
+
+				//Make sure it worked
+				if (call_return_status == FAILED)
+				{
+					GL_THROW("External current injection update failed for device %s",bus[indexer].ExtraCurrentInjFuncObject->name ? bus[indexer].ExtraCurrentInjFuncObject->name : "Unnamed");
+					/*  TROUBLESHOOT
+					While attempting to perform the external current injection update function call, something failed.  Please try again.
+					If the error persists, please submit your code and a bug report via the ticketing system.
+					*/
+				}
+				//Default else - it worked
+			}
+		}//End "in the island"
+		//Default else - not in the island, skip it
+	}//End bus traversion
+
+	//Perform saturation current update/convergence check
+	//******************** FIGURE OUT HOW TO DO THIS BETTER - This is very inefficient!***********************//
+	if ((enable_inrush_calculations == true) && (deltatimestep_running > 0))	//Don't even both with this if inrush not on
+	{
+		//Start out assuming the convergence is true (reiter is false)
+		powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent = false;
+
+		//Loop through all branches -- inefficient, but meh
+		for (indexer=0; indexer<branch_count; indexer++)
+		{
+			//See if this branch is associated with this island
+			if (branch[indexer].island_number == island_loop_index)
+			{
+				//See if the function exists
+				if (branch[indexer].ExtraDeltaModeFunc != NULL)
+				{
+					//Call the function
+					func_result_val = ((int (*)(OBJECT *,bool *))(*branch[indexer].ExtraDeltaModeFunc))(branch[indexer].obj,&(powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent));
+
+					//Make sure it worked
+					if (func_result_val != 1)
+					{
+						GL_THROW("Extra delta update failed for device %s",branch[indexer].name ? branch[indexer].name : "Unnamed");
+						/*  TROUBLESHOOT
+						While attempting to perform the extra deltamode update, something failed.  Please try again.
+						If the error persists, please submit your code and a bug report via the ticketing system.
+						*/
+					}
+					//Default else -- it worked, keep going
+				}
+				//Default else - is NULL
+			}
+			//Default else -- not part of this island, so don't mess with it
+		}//End inefficient branch traversion
+	}//End in-rush and deltamode running
+
+	//Additional checks for special modes - only needs to happen in first dynamics powerflow
+	if (powerflow_type == PF_DYNINIT)
+	{
+		//See what "mode" we're in
+		if (powerflow_values->island_matrix_values[island_loop_index].new_iteration_required == false)	//Overall powerflow has converged
+		{
+			if (powerflow_values->island_matrix_values[island_loop_index].swing_converged == false)	//See if deltaI_sym is being met
+			{
+				//See which message to print
+				if (NR_islands_detected > 1)
+				{
+					//Give a verbose message, just cause
+					gl_verbose("NR_Solver: swing bus failed balancing criteria on island %d - making it a PQ for future dynamics",(island_loop_index+1));
+				}
+				else	//Single system
+				{
+					//Give a verbose message, just cause
+					gl_verbose("NR_Solver: swing bus failed balancing criteria - making it a PQ for future dynamics");
+				}
+
+				//See if we're still swing_is_a_swing mode
+				if (powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing == true)
+				{
+					//Deflag us
+					powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = false;
+
+					//Loop through and deflag appropriate swing buses
+					for (indexer=0; indexer<bus_count; indexer++)
+					{
+						//See if we're in the "island of interest"
+						if (bus[indexer].island_number == island_loop_index)
 						{
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							//See if we're a swing-flagged bus
+							if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))
 							{
-								temp_size_b = 1;		//Single size
-								temp_index_b = 0;		//No offset (only 1 big)
+								//See if we're "generator ready"
+								if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].DynCurrent != NULL))
+								{
+									//Deflag us back to "PQ" status
+									bus[indexer].swing_functions_enabled = false;
+
+									//Force a reiteration
+									powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;
+								}
 							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-								/*  TROUBLESHOOT
-								One of the lines in the powerflow model has an invalid phase in
-								reference to its to and from ends.  This should have been caught
-								earlier, so submit your code and a bug report using the trac website.
-								*/
-							}
-							break;
-						}//end 0x01
-					case 0x02:	//B
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_size_b = 1;		//Single size
-								temp_index_b = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x02
-					case 0x03:	//BC
-						{
-							temp_size_b = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index_b = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
-							{
-								temp_index_b = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x03
-					case 0x04:	//A
-						{
-							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_size_b = 1;		//Single size
-								temp_index_b = 0;		//No offset (only 1 big)
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x04
-					case 0x05:	//AC
-						{
-							temp_size_b = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index_b = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
-							{
-								temp_index_b = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x05
-					case 0x06:	//AB
-						{
-							temp_size_b = 2;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index_b = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
-							{
-								temp_index_b = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x06
-					case 0x07:	//ABC
-						{
-							temp_size_b = 3;	//Size of this matrix's admittance
-							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
-							{
-								temp_index_b = 2;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
-							{
-								temp_index_b = 1;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
-							{
-								temp_index_b = 1;
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
-							{
-								temp_index_b = 0;		//offset
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
-							{
-								temp_index_b = 0;
-								Full_Mat_B = true;		//Flag so we know C needs to be gapped
-							}
-							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
-							{
-								temp_index_b = 0;
-							}
-							else
-							{
-								GL_THROW("NR: One of the lines has invalid phase parameters");
-							}
-							break;
-						}//end 0x07
-					default:
-						{
-							break;
-						}
-				}//End switch/case for to
-
-				//Make sure everything was set before proceeding
-				if ((temp_index==-1) || (temp_index_b==-1) || (temp_size==-1) || (temp_size_b==-1) || (temp_size_c==-1))
-				{
-					GL_THROW("NR: Failure to construct single/double phase line indices");
-					/*  TROUBLESHOOT
-					A single or double phase line (e.g., just A or AB) has failed to properly initialize all of the indices
-					necessary to form the admittance matrix.  Please submit a bug report, with your code, to the trac site.
-					*/
+							//Default else -- normal bus
+						}//End Island check
+						//Default else -- not in the current relevant island
+					}//End bus traversion loop
 				}
+				//Default else - if we're out of symmetry bounds, but already hit close, good enough
+			}
+			//Defaulted else - we're converged on all fronts, huzzah!
+		}
+		//Default else - still need to iterate
+	}//End special convergence criterion
 
-				if (Full_Mat_A)	//From side is a full ABC and we have AC
-				{
-					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
-					{
-						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
-						{
-							//Indices counted out from Self admittance above.  needs doubling due to complex separation
-							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							}
+	//Check Saturation mismatch 
+	if (powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent == true)
+	{
+		//Force a reiter
+		powerflow_values->island_matrix_values[island_loop_index].new_iteration_required = true;
+	}
+	//Default else -- either no saturation, or it has converged - leave it be
 
-							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							}
+	//Turn off reallocation flag no matter what
+	powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = false;
 
-							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-							}
+	if (matrix_solver_method==MM_SUPERLU)
+	{
+		/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
+#ifdef MT
+		//superLU_MT commands
+		Destroy_SuperNode_SCP(&L_LU);
+		Destroy_CompCol_NCP(&U_LU);
+#else
+		//sequential superLU commands
+		Destroy_SuperNode_Matrix( &L_LU );
+		Destroy_CompCol_Matrix( &U_LU );
+		StatFree ( &stat );
+#endif
+	}
+	else if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))
+	{
+		//Call destruction routine
+		((void (*)(void *, bool))(LUSolverFcns.ext_destroy))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,powerflow_values->island_matrix_values[island_loop_index].new_iteration_required);
+	}
+	else	//Not sure how we get here
+	{
+		GL_THROW("Invalid matrix solution method specified for NR solver!");
+		//Defined above
+	}
 
-							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-							}
-						}//column end
-					}//row end
-				}//end full ABC for from AC
+	//Final check -- see if the info result wasn't zero -- if so, deflag us no matter what here
+	if (powerflow_values->island_matrix_values[island_loop_index].solver_info != 0)
+	{
+		powerflow_values->island_matrix_values[island_loop_index].new_iteration_required = false;
+	}
 
-				if (Full_Mat_B)	//To side is a full ABC and we have AC
-				{
-					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
-					{
-						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
-						{
-							//Indices counted out from Self admittance above.  needs doubling due to complex separation
-							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							}
+	//Determine how we got here and what the next steps are
+	if (powerflow_values->island_matrix_values[island_loop_index].new_iteration_required == true)	//We think we need a new one
+	{
+		//Make sure we still can iterate - if we hit the iteration limit, we can't
+		if (powerflow_values->island_matrix_values[island_loop_index].iteration_count>=NR_iteration_limit)
+		{
+			powerflow_values->island_matrix_values[island_loop_index].return_code = -(powerflow_values->island_matrix_values[island_loop_index].iteration_count);
 
-							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							}
+			//We got here, we're done with this island
+			return NR_ISLAND_SOLVED;
+		}
+		else	//Normal iteration procedure - update the counter
+		{
+			powerflow_values->island_matrix_values[island_loop_index].iteration_count++;
 
-							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-							}
-
-							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-							}
-						}//column end
-					}//row end
-				}//end full ABC for to AC
-
-				if ((!Full_Mat_A) && (!Full_Mat_B))	//Neither is a full ABC, or we aren't doing AC, so we don't care
-				{
-					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
-					{
-						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
-						{
-							//Indices counted out from Self admittance above.  needs doubling due to complex separation
-							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							}
-
-							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-							}
-
-							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-							}
-
-							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
-							{
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-								
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
-								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
-								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
-							}
-						}//column end
-					}//row end
-				}//end not full ABC with AC on either side case
-			}//end all others else
-		}//end branch for
-
-		//Loop through the islands
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-		{
-			//Build the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix. This part will not be updated at each iteration. 
-			powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed = 0;
+			return NR_ISLAND_ITERATE;
 		}
-
-		for (jindexer=0; jindexer<bus_count;jindexer++) 
+	}
+	else	//Should be done
+	{
+		if (powerflow_values->island_matrix_values[island_loop_index].solver_info == 0)	//It was a convergence exit
 		{
-			if (bus[jindexer].island_number != -1)
-			{
-				//Pull the index
-				island_loop_index = bus[jindexer].island_number;
-
-				//Loop through and get sizes
-				for (jindex=0; jindex<3; jindex++)
-				{
-					for (kindex=0; kindex<3; kindex++)
-					{		 
-						if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)  
-							powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed += 1; 
-						if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex) 
-							powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed += 1; 
-					}
-				}
-			}
-			//Default else -- nota  valid island anyways
+			//Store the value as the return code
+			powerflow_values->island_matrix_values[island_loop_index].return_code = powerflow_values->island_matrix_values[island_loop_index].iteration_count;
 		}
-
-		//Loop through the islands again
-		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+		else
 		{
-			if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed == NULL)
-			{
-				powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2) *sizeof(Y_NR));   //powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed store the row,column and value of the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
-
-				//Make sure it worked
-				if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed == NULL)
-					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-				//Update the max size
-				powerflow_values->island_matrix_values[island_loop_index].max_size_diag_fixed = powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed;
-			}
-			else if (powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed > powerflow_values->island_matrix_values[island_loop_index].max_size_diag_fixed)		//Something changed and we are bigger!!
-			{
-				//Destroy us!
-				gl_free(powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed);
-
-				//Rebuild us, we have the technology
-				powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2) *sizeof(Y_NR));
-
-				//Make sure it worked
-				if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed == NULL)
-					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-				//Store the new size
-				powerflow_values->island_matrix_values[island_loop_index].max_size_diag_fixed = powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed;
-
-				//Flag for a reallocation
-				powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
-			}
-
-			//Zero the accumulator for the next section, while we're in here
-			powerflow_values->island_matrix_values[island_loop_index].indexer = 0;
-		}//End island loop routine
+			//Store the return value as the failure
+			powerflow_values->island_matrix_values[island_loop_index].return_code = 0;
+		}
 
-		for (jindexer=0; jindexer<bus_count;jindexer++)	//Parse through bus list
-		{ 
-			//Extract our island reference
-			island_index_val = bus[jindexer].island_number;
+		return NR_ISLAND_SOLVED;
+	}
+}
 
-			//If we're unallocated, just skip us
-			if (island_index_val == -1)
-			{
-				continue;
-			}
-			//Default else -- proceed
+//Records an exception thrown while solving an island - only the lowest island's message is kept, so the error doesn't depend on thread timing
+static void solver_nr_island_failed(NR_ISLAND_JOB *job, int island_loop_index, const char *msg)
+{
+	pthread_mutex_lock(&NR_island_pool_mutex);
+	if ((job->failed_island < 0) || (island_loop_index < job->failed_island))
+	{
+		job->failed_island = island_loop_index;
+		strncpy(job->failed_msg,msg,sizeof(job->failed_msg)-1);
+		job->failed_msg[sizeof(job->failed_msg)-1] = '\0';
+	}
+	pthread_mutex_unlock(&NR_island_pool_mutex);
+}
 
-			for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
-			{
-				for (kindex=0; kindex<powerflow_values->BA_diag[jindexer].size; kindex++)
-				{					
-					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
-					{
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
-						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+//Takes islands off the job and iterates each to completion, until none are left
+static void solver_nr_island_work(NR_ISLAND_JOB *job)
+{
+	int island_loop_index;
+	NR_ISLAND_STATE island_state;
+	int64 exit_value;
 
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
-						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-					}
+	while (true)
+	{
+		//Claim the next island
+		pthread_mutex_lock(&NR_island_pool_mutex);
+		island_loop_index = job->next_island++;
+		pthread_mutex_unlock(&NR_island_pool_mutex);
 
-					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
-					{
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
-						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-						
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
-						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
-						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
-					}
-				}
-			}
-		}//End bus parse for fixed diagonal
-	}//End admittance update
+		if (island_loop_index >= NR_islands_detected)
+		{
+			break;
+		}
 
-	//Loop through each island to reset these flags
-	for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
-	{
-		//Reset saturation checks
-		powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent = false;
+		//Exceptions can't leave the thread, so hand them back to the solver
+		try {
+			do {
+				island_state = solver_nr_island_pass(job->bus_count,job->bus,job->branch_count,job->branch,job->powerflow_values,job->powerflow_type,NULL,job->bad_computations,island_loop_index,&exit_value);
+			} while (island_state == NR_ISLAND_ITERATE);
 
-		//Reset the iteration counters
-		powerflow_values->island_matrix_values[island_loop_index].iteration_count = 0;
+			job->island_state[island_loop_index] = island_state;
+		}
+		catch (const char *msg)
+		{
+			solver_nr_island_failed(job,island_loop_index,msg);
+		}
+		catch (...)
+		{
+			solver_nr_island_failed(job,island_loop_index,"NR: unknown exception while solving an island");
+		}
 	}
+}
 
-	//Reset the global flag for iterations on islands -- will be set at the end
-	still_iterating_islands = true;
-
-	//Also reset island index
-	island_loop_index = 0;
+//Island thread - waits for a job, works on it, and parks again
+static void *solver_nr_island_thread(void *arg)
+{
+	NR_ISLAND_THREAD *thread_info = (NR_ISLAND_THREAD *)arg;
+	NR_ISLAND_JOB *job;
 
-	//While it - loop through until we solve the issue
-	while (still_iterating_islands == true)
+	pthread_mutex_lock(&NR_island_pool_mutex);
+	while (true)
 	{
-		//Map the superLU variables each time -- just easier to do it always
-		if (matrix_solver_method==MM_SUPERLU)
+		//Wait for a new job
+		while (NR_island_pool_generation == thread_info->generation)
 		{
-			//Put the void pointer into a local context
-			curr_island_superLU_vars = (SUPERLU_NR_vars *)powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars;
+			pthread_cond_wait(&NR_island_pool_start,&NR_island_pool_mutex);
 		}
+		thread_info->generation = NR_island_pool_generation;
+		job = NR_island_pool_job;
+		pthread_mutex_unlock(&NR_island_pool_mutex);
 
-		//Call the load subfunction
-		compute_load_values(bus_count,bus,powerflow_values,false,island_loop_index);
-	
-		// Calculate the mismatch of three phase current injection at each bus (deltaI), 
-		//and store the deltaI in terms of real and reactive value in array powerflow_values->island_matrix_values[island_loop_index].deltaI_NR    
-		if (powerflow_values->island_matrix_values[island_loop_index].deltaI_NR==NULL)
+		//Only help if this job wants this many threads
+		if (thread_info->index+1 < job->thread_count)
 		{
-			powerflow_values->island_matrix_values[island_loop_index].deltaI_NR = (double *)gl_malloc((2*powerflow_values->island_matrix_values[island_loop_index].total_variables) *sizeof(double));   // left_hand side of equation (11)
-
-			//Make sure it worked
-			if (powerflow_values->island_matrix_values[island_loop_index].deltaI_NR == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-			//Update the max size
-			powerflow_values->island_matrix_values[island_loop_index].max_total_variables = powerflow_values->island_matrix_values[island_loop_index].total_variables;
+			solver_nr_island_work(job);
 		}
-		else if (powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed)		//Bigger sized (this was checked above)
+
+		//Let the solver know we're done with the job
+		pthread_mutex_lock(&NR_island_pool_mutex);
+		NR_island_pool_busy--;
+		if (NR_island_pool_busy == 0)
 		{
-			//Decimate the existing value
-			gl_free(powerflow_values->island_matrix_values[island_loop_index].deltaI_NR);
+			pthread_cond_signal(&NR_island_pool_done);
+		}
+	}
+	return NULL;
+}
 
-			//Reallocate it...bigger...faster...stronger!
-			powerflow_values->island_matrix_values[island_loop_index].deltaI_NR = (double *)gl_malloc((2*powerflow_values->island_matrix_values[island_loop_index].total_variables) *sizeof(double));
+//Solves the islands of a job on the island threads - the calling thread works on islands too
+static void solver_nr_islands_concurrent(NR_ISLAND_JOB *job)
+{
+	NR_ISLAND_THREAD *thread_info;
+	pthread_t thread_id;
 
-			//Make sure it worked
-			if (powerflow_values->island_matrix_values[island_loop_index].deltaI_NR == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+	pthread_mutex_lock(&NR_island_pool_mutex);
 
-			//Store the updated value
-			powerflow_values->island_matrix_values[island_loop_index].max_total_variables = powerflow_values->island_matrix_values[island_loop_index].total_variables;
-		}
+	//Start any threads we don't have yet
+	while (NR_island_pool_size+1 < job->thread_count)
+	{
+		thread_info = (NR_ISLAND_THREAD *)gl_malloc(sizeof(NR_ISLAND_THREAD));
 
-		//If we're in PF_DYNINIT mode, initialize the balancing convergence
-		if (powerflow_type == PF_DYNINIT)
+		if (thread_info == NULL)
 		{
-			powerflow_values->island_matrix_values[island_loop_index].swing_converged = true;	//init it to yes, fail by exception, not default
+			break;	//Make do with the threads we have
 		}
 
-		//Compute the calculated loads (not specified) at each bus
-		for (indexer=0; indexer<bus_count; indexer++) //for specific bus k
-		{
-			//Make sure the bus we're looking at is relevant to this island - otherwise, we can skip it
-			if (bus[indexer].island_number == island_loop_index)
-			{
-				//Update for generator symmetry - only in static dynamic mode and when SWING is a SWING
-				if ((powerflow_type == PF_DYNINIT) && (powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing==true))
-				{
-					//Secondary check - see if it is even needed - basically built around 3-phase right now
-					//Initializes the Norton equivalent item -- normal generators shoudln't need this
-					if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].full_Y != NULL) && (bus[indexer].DynCurrent != NULL))
-					{
-						//Form denominator term of Ii, since it won't change
-						temp_complex_1 = (~bus[indexer].V[0]) + (~bus[indexer].V[1])*avalsq + (~bus[indexer].V[2])*aval;
-						
-						//Form up numerator portion that doesn't change (Q and admittance)
-						//Do in parts, just for readability
-						temp_complex_2 = ~bus[indexer].V[0];	//conj(Va)
-						
-						//Row 1 of admittance mult
-						temp_complex_0 = temp_complex_2*(bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2]);
-
-						// Row 1 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus 
-						temp_complex_5 = bus[indexer].full_Y[0]*bus[indexer].V[0] + bus[indexer].full_Y[1]*bus[indexer].V[1] + bus[indexer].full_Y[2]*bus[indexer].V[2];
-						temp_complex_4 = ~temp_complex_5;
-						temp_complex_3 = bus[indexer].V[0]*temp_complex_4;
+		thread_info->index = NR_island_pool_size;
+		thread_info->generation = NR_island_pool_generation;
 
-						//conj(Vb)
-						temp_complex_2 = ~bus[indexer].V[1];
-
-						//Row 2 of admittance
-						temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2]);
-						
-						// Row 2 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
-						temp_complex_5 = bus[indexer].full_Y[3]*bus[indexer].V[0] + bus[indexer].full_Y[4]*bus[indexer].V[1] + bus[indexer].full_Y[5]*bus[indexer].V[2];
-						temp_complex_4 = ~temp_complex_5;
-						temp_complex_3 += bus[indexer].V[1]*temp_complex_4;
+		if (pthread_create(&thread_id,NULL,solver_nr_island_thread,(void *)thread_info) != 0)
+		{
+			gl_free(thread_info);
+			break;	//Make do with the threads we have
+		}
 
-						//conj(Vc)
-						temp_complex_2 = ~bus[indexer].V[2];
+		pthread_detach(thread_id);
+		NR_island_pool_size++;
+	}
 
-						//Row 3 of admittance
-						temp_complex_0 += temp_complex_2*(bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2]);
+	//Hand the job out
+	NR_island_pool_job = job;
+	NR_island_pool_busy = NR_island_pool_size;
+	NR_island_pool_generation++;
+	pthread_cond_broadcast(&NR_island_pool_start);
+	pthread_mutex_unlock(&NR_island_pool_mutex);
 
-						// Row 3 also calculate Sysource ( = v * conj(ysource * v)) to substract from PTsource and obtain Pgen at generator bus
-						temp_complex_5 = bus[indexer].full_Y[6]*bus[indexer].V[0] + bus[indexer].full_Y[7]*bus[indexer].V[1] + bus[indexer].full_Y[8]*bus[indexer].V[2];
-						temp_complex_4 = ~temp_complex_5;
-						temp_complex_3 += bus[indexer].V[2]*temp_complex_4;					
+	solver_nr_island_work(job);
 
-						//numerator done, except PT portion (add in below - SWING bus is different
+	//Wait for the island threads to be done with it
+	pthread_mutex_lock(&NR_island_pool_mutex);
+	while (NR_island_pool_busy > 0)
+	{
+		pthread_cond_wait(&NR_island_pool_done,&NR_island_pool_mutex);
+	}
+	NR_island_pool_job = NULL;
+	pthread_mutex_unlock(&NR_island_pool_mutex);
+}
 
-						//On that note, if we are a SWING, zero our PT portion and QT for accumulation
-						if ((bus[indexer].type == 2) && (powerflow_values->island_matrix_values[island_loop_index].iteration_count>0))
-						{
-							*bus[indexer].PGenTotal = complex(0.0,0.0);
-						}
-					}
-					else	//Not enabled or not "full-Y-ed" - set to zero
-					{
-						temp_complex_0 = 0.0;
-						temp_complex_1 = 0.0;	//Basically a flag to ignore it
-					}
-				}//End PF_DYNINIT and SWING is still the same
+/** Newton-Raphson solver
+	Solves a power flow problem using the Newton-Raphson method
+	
+	@return n=0 on failure to complete a single iteration, 
+	n>0 to indicate success after n interations, or 
+	n<0 to indicate failure after n iterations
+ **/
+int64 solver_nr(unsigned int bus_count, BUSDATA *bus, unsigned int branch_count, BRANCHDATA *branch, NR_SOLVER_STRUCT *powerflow_values, NRSOLVERMODE powerflow_type , NR_MESHFAULT_IMPEDANCE *mesh_imped_vals, bool *bad_computations)
+{
+	//Index for "islanding operations", when needed
+	int island_index_val;
 
-				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++) // rows - for specific phase that exists
-				{
-					tempIcalcReal = tempIcalcImag = 0;   
+	//Temporary island looping value
+	int island_loop_index;
 
-					if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - triplex bus
-					{
-						//Two states of triplex bus - To node of SPCT transformer needs to be different
-						//First different - Delta-I and diagonal contributions
-						if ((bus[indexer].phases & 0x20) == 0x20)	//We're the To bus
-						{
-							//Pre-negated due to the nature of how it's calculated (V1 compared to I1)
-							tempPbus =  bus[indexer].PL[jindex];	//Copy load amounts in
-							tempQbus =  bus[indexer].QL[jindex];	
-						}
-						else	//We're just a normal triplex bus
-						{
-							//This one isn't negated (normal operations)
-							tempPbus =  -bus[indexer].PL[jindex];	//Copy load amounts in
-							tempQbus =  -bus[indexer].QL[jindex];	
-						}//end normal triplex bus
-
-						//Get diagonal contributions - only (& always) 2
-						//Column 1
-						tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Im();// equation (7), the diag elements of bus admittance matrix 
-						tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][0]).Re() * (bus[indexer].V[0]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][0]).Im() * (bus[indexer].V[0]).Re();// equation (8), the diag elements of bus admittance matrix 
-
-						//Column 2
-						tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Im();// equation (7), the diag elements of bus admittance matrix 
-						tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][1]).Re() * (bus[indexer].V[1]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][1]).Im() * (bus[indexer].V[1]).Re();// equation (8), the diag elements of bus admittance matrix 
-
-						//Now off diagonals
-						for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)
-						{
-							//Apply proper index to jindexer (easier to implement this way)
-							jindexer=bus[indexer].Link_Table[kindexer];
+	//Temporary function variable
+	FUNCTIONADDR temp_fxn_val;
 
-							if (branch[jindexer].from == indexer)	//We're the from bus
-							{
-								if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
-								{
-									work_vals_char_0 = jindex*3;
+	//Generic status variable
+	STATUS call_return_status;
 
-									//This situation can only be a normal line (triplex will never be the from for another type)
-									//Again only, & always 2 columns (just do them explicitly)
-									//Column 1
-									tempIcalcReal += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += ((branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + ((branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+	//Phase collapser variable
+	unsigned char phase_worka, phase_workb, phase_workc, phase_workd, phase_worke;
 
-									//Column2
-									tempIcalcReal += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += ((branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + ((branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+	//Miscellaneous index variable
+	unsigned int indexer, tempa, tempb, jindexer, kindexer;
+	char jindex, kindex;
+	char temp_index, temp_index_b;
 
-								}//End SPCT To bus - from diagonal contributions
-								else		//Normal line connection to normal triplex
-								{
-									work_vals_char_0 = jindex*3;
-									//This situation can only be a normal line (triplex will never be the from for another type)
-									//Again only, & always 2 columns (just do them explicitly)
-									//Column 1
-									tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+	//Working matrix for admittance collapsing/determinations
+	complex tempY[3][3];
 
-									//Column2
-									tempIcalcReal += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += (-(branch[jindexer].Yfrom[jindex*3+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[jindex*3+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+	//Miscellaneous flag variables
+	bool Full_Mat_A, Full_Mat_B;
 
-								}//end normal triplex from
-							}//end from bus
-							else if (branch[jindexer].to == indexer)	//We're the to bus
-							{
-								if (branch[jindexer].v_ratio != 1.0)	//Transformer
-								{
-									//Only a single contributor on the from side - figure out how to get to it
-									if ((branch[jindexer].phases & 0x01) == 0x01)	//C
-									{
-										temp_index=2;
-									}
-									else if ((branch[jindexer].phases & 0x02) == 0x02)	//B
-									{
-										temp_index=1;
-									}
-									else if ((branch[jindexer].phases & 0x04) == 0x04)	//A
-									{
-										temp_index=0;
-									}
-									else	//How'd we get here!?!
-									{
-										GL_THROW("NR: A split-phase transformer appears to have an invalid phase");
-									}
+	//Temporary size variable
+	char temp_size, temp_size_b, temp_size_c;
 
-									work_vals_char_0 = jindex*3+temp_index;
+	//Temporary admittance variables
+	complex Temp_Ad_A[3][3];
+	complex Temp_Ad_B[3][3];
 
-									//Perform the update, it only happens for one column (nature of the transformer)
-									tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[temp_index]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[temp_index]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+	//Multi-island return value
+	int64 return_value_for_solver_NR;
 
-								}//end transformer
-								else									//Must be a normal line then
-								{
-									if ((bus[indexer].phases & 0x20) == 0x20)	//SPCT from bus - needs different signage
-									{
-										work_vals_char_0 = jindex*3;
-										//This case should never really exist, but if someone reverses a secondary or is doing meshed secondaries, it might
-										//Again only, & always 2 columns (just do them explicitly)
-										//Column 1
-										tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-										tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + ((branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-										//Column2
-										tempIcalcReal += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-										tempIcalcImag += ((branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + ((branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									}//End SPCT To bus - from diagonal contributions
-									else		//Normal line connection to normal triplex
-									{
-										work_vals_char_0 = jindex*3;
-										//Again only, & always 2 columns (just do them explicitly)
-										//Column 1
-										tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Re() - (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-										tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0])).Re() * (bus[branch[jindexer].from].V[0]).Im() + (-(branch[jindexer].Yto[work_vals_char_0])).Im() * (bus[branch[jindexer].from].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-										//Column2
-										tempIcalcReal += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Re() - (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-										tempIcalcImag += (-(branch[jindexer].Yto[work_vals_char_0+1])).Re() * (bus[branch[jindexer].from].V[1]).Im() + (-(branch[jindexer].Yto[work_vals_char_0+1])).Im() * (bus[branch[jindexer].from].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									}//End normal triplex connection
-								}//end normal line
-							}//end to bus
-							else	//We're nothing
-								;
-
-						}//End branch traversion
-
-						//Determine how we are posting this update
-						if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
-						{
-							if ((powerflow_type == PF_DYNINIT) && (bus[indexer].DynCurrent != NULL))	//We're a generator-type bus
-							{
-								//Compute the delta_I, just like below - but don't post it (still zero in calcs)
-								work_vals_double_3 = tempPbus - tempIcalcReal;
-								work_vals_double_4 = tempQbus - tempIcalcImag;
+	//Multi-island pointer to current superLU variables
+	SUPERLU_NR_vars *curr_island_superLU_vars;
 
-								//Form a magnitude vector
-								work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
-								
-								if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
-								{
-									powerflow_values->island_matrix_values[island_loop_index].swing_converged=false;
-								}
-							}//End PF_DYNINIT SWING traversion
+	//Island solve variables
+	unsigned int island_thread_count;
+	NR_ISLAND_STATE island_state;
+	NR_ISLAND_JOB island_job;
 
-							//Must be normal run, since DYNRUN should have swing capabilities deflagged
-							//Normal run - zero it - should already be zerod, but let's be paranoid for now
-							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
-							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
-						}//End SWING bus cases
-						else	//PQ bus or SWING masquerading as a PQ
-						{
-							//It's I.  Just a direct conversion (P changed above to I as well)
-							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = tempPbus - tempIcalcReal;
-							powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = tempQbus - tempIcalcImag;
-						}//End Normal PQ bus
-					}//End split-phase present
-					else	//Three phase or some variant thereof
-					{
-						tempPbus =  - bus[indexer].PL[jindex];	//Copy load amounts in
-						tempQbus =  - bus[indexer].QL[jindex];	
+	//Set the global - we're working now, so no more adjustments to island arrays until we're done (except removals)
+	NR_solver_working = true;
 
-						for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)		//cols - Still only for specified phases
-						{
-							//Determine our indices, based on phase information
-							temp_index = -1;
-							switch(bus[indexer].phases & 0x07) {
-								case 0x01:	//C
-									{
-										temp_index=2;
-										break;
-									}//end 0x01
-								case 0x02:	//B
-									{
-										temp_index=1;
-										break;
-									}//end 0x02
-								case 0x03:	//BC
-									{
-										if (kindex==0)	//B
-											temp_index=1;
-										else	//C
-											temp_index=2;
-										break;
-									}//end 0x03
-								case 0x04:	//A
-									{
-										temp_index=0;
-										break;
-									}//end 0x04
-								case 0x05:	//AC
-									{
-										if (kindex==0)	//A
-											temp_index=0;
-										else			//C
-											temp_index=2;
-										break;
-									}//end 0x05
-								case 0x06:	//AB
-									{
-										if (kindex==0)	//A
-											temp_index=0;
-										else			//B
-											temp_index=1;
-										break;
-									}//end 0x06
-								case 0x07:	//ABC
-									{
-										temp_index = kindex;	//Will loop all 3
-										break;
-									}//end 0x07
-							}//End switch/case
+	//Initialize the tracker variable inside each island, just in case
+	for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+	{
+		powerflow_values->island_matrix_values[island_loop_index].index_count = 0;
+	}
 
-							if (temp_index==-1)	//Error check
-							{
-								GL_THROW("NR: A voltage index failed to be found.");
-								/*  TROUBLESHOOT
-								While attempting to compute the calculated power current, a voltage index failed to be
-								resolved.  Please submit your code and a bug report via the trac website.
-								*/
-							}
+	//Ensure bad computations flag is set first
+	*bad_computations = false;
 
-							//Normal diagonal contributions
-							tempIcalcReal += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Re() - (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
-							tempIcalcImag += (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Re() * (bus[indexer].V[temp_index]).Im() + (powerflow_values->BA_diag[indexer].Y[jindex][kindex]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
+	//Determine special circumstances of SWING bus -- do we want it to truly participate right
+	if (powerflow_type != PF_NORMAL)
+	{
+		if (powerflow_type == PF_DYNCALC)	//Parse the list -- anything that is a swing and a generator, deflag it out of principle (and to make it work right)
+		{
+			//Set the master swing flag - do for all islands
+			for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+			{
+				powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = false;
+			}
 
-							//In-rush load contributions (if any) - only along explicit diagonal
-							if ((bus[indexer].full_Y_load != NULL) && (jindex==kindex))
-							{
-								tempIcalcReal += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Re() - (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Im();// equation (7), the diag elements of bus admittance matrix 
-								tempIcalcImag += (bus[indexer].full_Y_load[temp_index]).Re() * (bus[indexer].V[temp_index]).Im() + (bus[indexer].full_Y_load[temp_index]).Im() * (bus[indexer].V[temp_index]).Re();// equation (8), the diag elements of bus admittance matrix 
-							}
+			//Check the buses
+			for (indexer=0; indexer<bus_count; indexer++)
+			{
+				//See if we're a swing-flagged bus
+				if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))
+				{
+					//See if we're "generator ready"
+					if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].DynCurrent != NULL))
+					{
+						//Deflag us back to "PQ" status
+						bus[indexer].swing_functions_enabled = false;
+					}
+				}
+				//Default else -- normal bus
+			}//End bus traversion loop
+		}//Handle running dynamics differently
+		else	//Must be PF_DYNINIT
+		{
+			//Loop through the islands
+			for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+			{
+				//Flag us as true, initially
+				powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = true;
+			}
+		}
+	}//End not normal
+	else	//Must be normal
+	{
+		//Loop through all islands
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+		{
+			powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = true;	//Flag as a swing, even though this shouldn't do anything
+		}
+	}
 
-							//Off diagonal contributions
-							//Need another variable to handle the rows
-							temp_index_b = -1;
-							switch(bus[indexer].phases & 0x07) {
-								case 0x01:	//C
-									{
-										temp_index_b=2;
-										break;
-									}//end 0x01
-								case 0x02:	//B
-									{
-										temp_index_b=1;
-										break;
-									}//end 0x02
-								case 0x03:	//BC
-									{
-										if (jindex==0)	//B
-											temp_index_b=1;
-										else	//C
-											temp_index_b=2;
-										break;
-									}//end 0x03
-								case 0x04:	//A
-									{
-										temp_index_b=0;
-										break;
-									}//end 0x04
-								case 0x05:	//AC
-									{
-										if (jindex==0)	//A
-											temp_index_b=0;
-										else			//C
-											temp_index_b=2;
-										break;
-									}//end 0x05
-								case 0x06:	//AB
-									{
-										if (jindex==0)	//A
-											temp_index_b=0;
-										else			//B
-											temp_index_b=1;
-										break;
-									}//end 0x06
-								case 0x07:	//ABC
-									{
-										temp_index_b = jindex;	//Will loop all 3
-										break;
-									}//end 0x07
-							}//End switch/case
+	if ((matrix_solver_method==MM_EXTERN) || (matrix_solver_method==MM_KLU))
+	{
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+		{
+			//Call the initialization routine
+			powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars = ((void *(*)(void *))(LUSolverFcns.ext_init))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars);
 
-							if (temp_index_b==-1)	//Error check
-							{
-								GL_THROW("NR: A voltage index failed to be found.");
-							}
+			//Make sure it worked (allocation check)
+			if (powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars==NULL)
+			{
+				GL_THROW("External LU matrix solver failed to allocate memory properly!");
+				/*  TROUBLESHOOT
+				While attempting to allocate memory for the external LU solver, an error occurred.
+				Please try again.  If the error persists, ensure your external LU solver is behaving correctly
+				and coordinate with their development team as necessary.
+				*/
+			}
+		}//End Island loop
+	}
+	else if (matrix_solver_method == MM_SUPERLU)	//SuperLU multi-island-related item
+	{
+		//Loop through and see if we need to allocate things
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+		{
+			//See if the superLU variables are populated
+			if (powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars == NULL)
+			{
+				//Allocate one up
+				curr_island_superLU_vars = (SUPERLU_NR_vars *)gl_malloc(sizeof(SUPERLU_NR_vars));
 
-							for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size); kindexer++)	//Parse through the branch list
-							{
-								//Apply proper index to jindexer (easier to implement this way)
-								jindexer=bus[indexer].Link_Table[kindexer];
+				//Make sure it worked
+				if (curr_island_superLU_vars == NULL)
+				{
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+					//Defined elsewhere
+				}
 
-								if (branch[jindexer].from == indexer) 
-								{
-									//See if we're a triplex transformer (will only occur on the from side)
-									if ((branch[jindexer].phases & 0x80) == 0x80)	//Triplexy
-									{
-										proceed_flag = false;
-										phase_worka = branch[jindexer].phases & 0x07;
+				//Initialize it, for giggles/paranoia
+				curr_island_superLU_vars->A_LU.Store = NULL;
 
-										if (kindex==0)	//All of this will only occur the first column iteration
-										{
-											switch (bus[indexer].phases & 0x07)	{
-												case 0x01:	//C
-													{
-														if (phase_worka==0x01)
-															proceed_flag=true;
-														break;
-													}//end 0x01
-												case 0x02:	//B
-													{
-														if (phase_worka==0x02)
-															proceed_flag=true;
-														break;
-													}//end 0x02
-												case 0x03:	//BC
-													{
-														if ((jindex==0) && (phase_worka==0x02))	//First row and is a B
-															proceed_flag=true;
-														else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
-															proceed_flag=true;
-														else
-															;
-														break;
-													}//end 0x03
-												case 0x04:	//A
-													{
-														if (phase_worka==0x04)
-															proceed_flag=true;
-														break;
-													}//end 0x04
-												case 0x05:	//AC
-													{
-														if ((jindex==0) && (phase_worka==0x04))	//First row and is a A
-															proceed_flag=true;
-														else if ((jindex==1) && (phase_worka==0x01))	//Second row and is a C
-															proceed_flag=true;
-														else
-															;
-														break;
-													}//end 0x05
-												case 0x06:	//AB - shares with ABC
-												case 0x07:	//ABC 
-													{
-														if ((jindex==0) && (phase_worka==0x04))	//A & first row
-															proceed_flag=true;
-														else if ((jindex==1) && (phase_worka==0x02))	//B & second row
-															proceed_flag=true;
-														else if ((jindex==2) && (phase_worka==0x01))	//C & third row
-															proceed_flag=true;
-														else;
-														break;
-													}//end 0x07
-											}//end switch
-										}//End if kindex==0
-
-										if (proceed_flag)
-										{
-											work_vals_char_0 = temp_index_b*3;
-											//Do columns individually
-											//1
-											tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-											tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0])).Re() * (bus[branch[jindexer].to].V[0]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0])).Im() * (bus[branch[jindexer].to].V[0]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+				//Do the same for the underlying properties, just because
+				curr_island_superLU_vars->A_LU.Stype = SLU_NC;
+				curr_island_superLU_vars->A_LU.Dtype = SLU_D;
+				curr_island_superLU_vars->A_LU.Mtype = SLU_GE;
+				curr_island_superLU_vars->A_LU.nrow = 0;
+				curr_island_superLU_vars->A_LU.ncol = 0;
 
-											//2
-											tempIcalcReal += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Re() - (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Im();// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-											tempIcalcImag += (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Re() * (bus[branch[jindexer].to].V[1]).Im() + (-(branch[jindexer].Yfrom[work_vals_char_0+1])).Im() * (bus[branch[jindexer].to].V[1]).Re();// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
+				//Repeat for B_LU
+				curr_island_superLU_vars->B_LU.Store = NULL;
 
-										}
-									}//end SPCT transformer
-									else	///Must be a standard line
-									{
-										work_vals_char_0 = temp_index_b*3+temp_index;
-										work_vals_double_0 = (-branch[jindexer].Yfrom[work_vals_char_0]).Re();
-										work_vals_double_1 = (-branch[jindexer].Yfrom[work_vals_char_0]).Im();
-										work_vals_double_2 = (bus[branch[jindexer].to].V[temp_index]).Re();
-										work_vals_double_3 = (bus[branch[jindexer].to].V[temp_index]).Im();
-
-										tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-										tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-
-									}//end standard line
-								}	
-								if  (branch[jindexer].to == indexer)
-								{
-									work_vals_char_0 = temp_index_b*3+temp_index;
-									work_vals_double_0 = (-branch[jindexer].Yto[work_vals_char_0]).Re();
-									work_vals_double_1 = (-branch[jindexer].Yto[work_vals_char_0]).Im();
-									work_vals_double_2 = (bus[branch[jindexer].from].V[temp_index]).Re();
-									work_vals_double_3 = (bus[branch[jindexer].from].V[temp_index]).Im();
+				//Do the same for the underlying properties, just because
+				curr_island_superLU_vars->B_LU.Stype = SLU_NC;
+				curr_island_superLU_vars->B_LU.Dtype = SLU_D;
+				curr_island_superLU_vars->B_LU.Mtype = SLU_GE;
+				curr_island_superLU_vars->B_LU.nrow = 0;
+				curr_island_superLU_vars->B_LU.ncol = 0;
 
-									tempIcalcReal += work_vals_double_0 * work_vals_double_2 - work_vals_double_1 * work_vals_double_3;// equation (7), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-									tempIcalcImag += work_vals_double_0 * work_vals_double_3 + work_vals_double_1 * work_vals_double_2;// equation (8), the off_diag elements of bus admittance matrix are equal to negative value of branch admittance
-								}
-								else;
-							}
-						}//end intermediate current for each phase column
+				//Other arrays
+				curr_island_superLU_vars->perm_c = NULL;
+				curr_island_superLU_vars->perm_r = NULL;
 
-						//Determine how we are posting this update
-						if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))	//SWING bus is different (when it really is a SWING bus)
-						{
-							if ((powerflow_type == PF_DYNINIT) && (bus[indexer].DynCurrent != NULL))
-							{
-								//See if we're a Norton-equivalent-based generator
-								if (bus[indexer].full_Y != NULL)
-								{
-									//Compute our "power generated" value for this phase - conjugated in formation
-									temp_complex_2 = bus[indexer].V[jindex] * complex(tempIcalcReal,-tempIcalcImag);
+				//Cached column ordering
+				curr_island_superLU_vars->ordering_perm_c = NULL;
+				curr_island_superLU_vars->ordering_cols = NULL;
+				curr_island_superLU_vars->ordering_rows = NULL;
+				curr_island_superLU_vars->ordering_etree = NULL;
+				curr_island_superLU_vars->ordering_colcnt_h = NULL;
+				curr_island_superLU_vars->ordering_part_super_h = NULL;
+				curr_island_superLU_vars->ordering_n = 0;
+				curr_island_superLU_vars->ordering_nnz = 0;
 
-									if (powerflow_values->island_matrix_values[island_loop_index].iteration_count>0)	//Only update SWING on subsequent passes
-									{
-										//Now add it into the "generation total" for the SWING
-										(*bus[indexer].PGenTotal) += temp_complex_2 - temp_complex_3/3.0; // both PT and QT = Ssource-Sysource = v conj(I) - v conj(ysource v)
-									}
+				//Assign it in
+				powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars = (void *)curr_island_superLU_vars;
+			}
+		}
 
-									//Compute the delta_I, just like below - but don't post it (still zero in calcs)
-									work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
+		//Renull the random pointer, just in case
+		curr_island_superLU_vars = NULL;
+	}
 
-									if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
-									{
-										work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
-										work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
-										work_vals_double_3 = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal; // equation(7), Real part of deltaI, left hand side of equation (11)
-										work_vals_double_4 = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
+	if (NR_admit_change)	//If an admittance update was detected, fix it
+	{
+		//Build the diagonal elements of the bus admittance matrix - this should only happen once no matter what
+		if (powerflow_values->BA_diag == NULL)
+		{
+			powerflow_values->BA_diag = (Bus_admit *)gl_malloc(bus_count *sizeof(Bus_admit));   //BA_diag store the location and value of diagonal elements of Bus Admittance matrix
 
-										//Form a magnitude value - put in work_vals_double_0, since we're done with it
-										work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
-									}
-									else	//Would give us a NAN, so it must be out of service or something (case from below - really shouldn't apply to SWING)
-									{
-										work_vals_double_0 = 0.0;	//Assumes "converged"
-									}
-									
-									if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
-									{
-										powerflow_values->island_matrix_values[island_loop_index].swing_converged=false;
-									}
-								}//End Norton-equivalent SWING
-								else	//Other generator types
-								{
-									//Compute the delta_I, just like below - but don't post it (still zero in calcs)
-									work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
-
-									if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
-									{
-										work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
-										work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
-										work_vals_double_3 = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal; // equation(7), Real part of deltaI, left hand side of equation (11)
-										work_vals_double_4 = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
-
-										//Form a magnitude value - put in work_vals_double_0, since we're done with it
-										work_vals_double_0 = sqrt((work_vals_double_3*work_vals_double_3+work_vals_double_4*work_vals_double_4));
-									}
-									else	//Would give us a NAN, so it must be out of service or something (case from below - really shouldn't apply to SWING)
-									{
-										work_vals_double_0 = 0.0;	//Assumes "converged"
-									}
-
-									if (work_vals_double_0 > bus[indexer].max_volt_error)	//Failure check (defaults to voltage convergence for now)
-									{
-										powerflow_values->island_matrix_values[island_loop_index].swing_converged=false;
-									}
-
-									//Put this into DynCurrent for storage
-									bus[indexer].DynCurrent[jindex] = complex(tempIcalcReal,tempIcalcImag);
-								}//End other generator types
-							}//End PF_DYNINIT SWING traversion
-
-							//Effectively Zero out the components, regardless of normal run or not
-							//Should already be zerod, but do it again for paranoia sake
-							if (NR_busdata[indexer].BusHistTerm != NULL)	//See if we're "delta-capable"
-							{
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Re();
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Im();
-							}
-							else
-							{
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
-							}
-
-							//Saturation skipped for "swing is a swing" case, since it doesn't affect the admittance (no need to offset)
-						}//End SWING bus cases
-						else	//PQ bus or SWING masquerading as a PQ
-						{
-							work_vals_double_0 = (bus[indexer].V[temp_index_b]).Mag()*(bus[indexer].V[temp_index_b]).Mag();
-
-							if (work_vals_double_0!=0)	//Only normal one (not square), but a zero is still a zero even after that
-							{
-								work_vals_double_1 = (bus[indexer].V[temp_index_b]).Re();
-								work_vals_double_2 = (bus[indexer].V[temp_index_b]).Im();
-
-								//See if deltamode needs to include extra term
-								if (NR_busdata[indexer].BusHistTerm != NULL)
-								{
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) + NR_busdata[indexer].BusHistTerm[jindex].Re() - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) + NR_busdata[indexer].BusHistTerm[jindex].Im() - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
-								}
-								else	//Nope
-								{
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] = (tempPbus * work_vals_double_1 + tempQbus * work_vals_double_2)/ (work_vals_double_0) - tempIcalcReal ; // equation(7), Real part of deltaI, left hand side of equation (11)
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = (tempPbus * work_vals_double_2 - tempQbus * work_vals_double_1)/ (work_vals_double_0) - tempIcalcImag; // Imaginary part of deltaI, left hand side of equation (11)
-								}
-
-								//Accumulate in any saturation current values as well, while we're here
-								if (NR_busdata[indexer].BusSatTerm != NULL)
-								{
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Re();
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Im();
-								}
-							}
-							else
-							{
-								if (NR_busdata[indexer].BusHistTerm != NULL)	//See if extra deltamode term needs to be included
-								{
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Re();
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = NR_busdata[indexer].BusHistTerm[jindex].Im();
-								}
-								else
-								{
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + jindex] = 0.0;
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] = 0.0;
-								}
-
-								//Accumulate in any saturation current values as well, while we're here
-								if (NR_busdata[indexer].BusSatTerm != NULL)
-								{
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+ powerflow_values->BA_diag[indexer].size + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Re();
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + jindex] -= NR_busdata[indexer].BusSatTerm[jindex].Im();
-								}
-							}
-						}//End normal bus handling
-					}//End three-phase or variant thereof
-				}//End delta_I for each phase row
-
-				//Add in generator current amounts, if relevant
-				if (powerflow_type != PF_NORMAL)
-				{
-					//Secondary check - see if it is even needed - basically built around 3-phase right now (checks)
-					if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].DynCurrent != NULL))
-					{
-						//See if we're a Norton-equivalent generator
-						if (bus[indexer].full_Y != NULL)
-						{
-							if ((bus[indexer].phases & 0x07) == 0x07)	//Make sure is three-phase
-							{
-								//Only update in particular mode - SWING bus values should still be treated as such
-								if ((powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing == true) && (powerflow_type == PF_DYNINIT))	//Really only true for PF_DYNINIT anyways
-								{
-									//Power should be all updated, now update current values
-									temp_complex_0 += complex((*bus[indexer].PGenTotal).Re(),-(*bus[indexer].PGenTotal).Im()); // total generated power injected congugated
-
-									//Compute Ii
-									if (temp_complex_1.Mag() > 0.0)	//Non zero
-									{
-										temp_complex_2 = temp_complex_0/temp_complex_1;	//Forms Ii
-
-										//Now convert Ii to the individual phase amounts
-										bus[indexer].DynCurrent[0] = temp_complex_2;
-										bus[indexer].DynCurrent[1] = temp_complex_2*avalsq;
-										bus[indexer].DynCurrent[2] = temp_complex_2*aval;
-									}
-									else	//Must make zero
-									{
-										bus[indexer].DynCurrent[0] = complex(0.0,0.0);
-										bus[indexer].DynCurrent[1] = complex(0.0,0.0);
-										bus[indexer].DynCurrent[2] = complex(0.0,0.0);
-									}
-								}//End SWING is still swing, otherwise should just accumulate what it had
-
-								//Don't get added in as part of "normal swing" routine
-								if ((bus[indexer].type == 0) || ((bus[indexer].type>1) && (bus[indexer].swing_functions_enabled == false)))
-								{
-									//Add these into the system - added because "generation"
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size] += bus[indexer].DynCurrent[0].Re();		//Phase A
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 1] += bus[indexer].DynCurrent[1].Re();	//Phase B
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 2] += bus[indexer].DynCurrent[2].Re();	//Phase C
-
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc] += bus[indexer].DynCurrent[0].Im();		//Phase A
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 1] += bus[indexer].DynCurrent[1].Im();	//Phase B
-									powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 2] += bus[indexer].DynCurrent[2].Im();	//Phase C
-								}
-								//Defaulted else - leave as they were
-							}//End three-phase
-							else	//Not three-phase at the moment
-							{
-								//See if we ever were (reliability call)
-								if ((bus[indexer].origphases & 0x07) == 0x07)
-								{
-									//Just zero it
-									bus[indexer].DynCurrent[0] = complex(0.0,0.0);
-									bus[indexer].DynCurrent[1] = complex(0.0,0.0);
-									bus[indexer].DynCurrent[2] = complex(0.0,0.0);
-								}
-								else	//Never was, just fail out
-								{
-									GL_THROW("NR_solver: bus:%s has tried updating deltamode dynamics, but is not three-phase!",bus[indexer].name);
-									/*  TROUBLESHOOT
-									The NR_solver routine tried update a three-phase current value for a bus that is not
-									three phase.  At this time, the deltamode system only supports three-phase buses for
-									generator attachment.
-									*/
-								}
-							}
-						}//End Norton-equivalent call
-						else	//Must be another generator
-						{
-							//Replicate the injection from above -- assume three-phase right now
-							//Don't get added in as part of "normal swing" routine
-							if ((bus[indexer].type == 0) || ((bus[indexer].type>1) && (bus[indexer].swing_functions_enabled == false)))
-							{
-								//Add these into the system - added because "generation"
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size] += bus[indexer].DynCurrent[0].Re();		//Phase A
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 1] += bus[indexer].DynCurrent[1].Re();	//Phase B
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size + 2] += bus[indexer].DynCurrent[2].Re();	//Phase C
-
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc] += bus[indexer].DynCurrent[0].Im();		//Phase A
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 1] += bus[indexer].DynCurrent[1].Im();	//Phase B
-								powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[2*bus[indexer].Matrix_Loc + 2] += bus[indexer].DynCurrent[2].Im();	//Phase C
-							}
-							//Defaulted else - leave as they were - if it is still a swing, this is all moot anyways
-						}//End other generator delta call
-					}//End extra current adds
-				}//End dynamic (generator postings)
-			}//End part of this island check
-			//Default else -- not in this island, so skip us!
-		}//End delta_I for each bus
-
-		//Call the load subfunction - flag for Jacobian update
-		compute_load_values(bus_count,bus,powerflow_values,true,island_loop_index);
-
-		//Build the dynamic diagnal elements of 6n*6n Y matrix. All the elements in this part will be updated at each iteration.
-
-		//Reset it
-		powerflow_values->island_matrix_values[island_loop_index].size_diag_update = 0;
-
-		//Adjust it
-		for (jindexer=0; jindexer<bus_count;jindexer++) 
-		{
-			//Check our relevance to this matrix
-			if (bus[jindexer].island_number == island_loop_index)
+			//Make sure it worked
+			if (powerflow_values->BA_diag == NULL)
 			{
-				if  (bus[jindexer].type != 1)	//PV bus ignored (for now?)
-					powerflow_values->island_matrix_values[island_loop_index].size_diag_update += powerflow_values->BA_diag[jindexer].size; 
-				//Defaulted else - PV bus ignored
+				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+				/*  TROUBLESHOOT
+				During the allocation stage of the NR algorithm, one of the matrices failed to be allocated.
+				Please try again and if this bug persists, submit your code and a bug report using the trac
+				website.
+				*/
 			}
-			//Default else -- different island, skip for now
 		}
 		
-		if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_update == NULL)
-		{
-			powerflow_values->island_matrix_values[island_loop_index].Y_diag_update = (Y_NR *)gl_malloc((4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update) *sizeof(Y_NR));   //powerflow_values->island_matrix_values[island_loop_index].Y_diag_update store the row,column and value of the dynamic part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
-
-			//Make sure it worked
-			if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_update == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-			//Update maximum size
-			powerflow_values->island_matrix_values[island_loop_index].max_size_diag_update = powerflow_values->island_matrix_values[island_loop_index].size_diag_update;
-		}
-		else if (powerflow_values->island_matrix_values[island_loop_index].size_diag_update > powerflow_values->island_matrix_values[island_loop_index].max_size_diag_update)	//We've exceeded our limits
+		//Loop the islands and reset the bus count, just in case
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
 		{
-			//Disappear the old one
-			gl_free(powerflow_values->island_matrix_values[island_loop_index].Y_diag_update);
-
-			//Make a new one in its image
-			powerflow_values->island_matrix_values[island_loop_index].Y_diag_update = (Y_NR *)gl_malloc((4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update) *sizeof(Y_NR));
-
-			//Make sure it worked
-			if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_update == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-			//Update the size
-			powerflow_values->island_matrix_values[island_loop_index].max_size_diag_update = powerflow_values->island_matrix_values[island_loop_index].size_diag_update;
-
-			//Flag for a realloc
-			powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
+			powerflow_values->island_matrix_values[island_loop_index].bus_count = 0;
 		}
 
-		indexer = 0;	//Rest positional counter
-
-		for (jindexer=0; jindexer<bus_count; jindexer++)	//Parse through bus list
-		{
-			//See if we're part of the currently progressing island -- if not, skip us
-			if (bus[jindexer].island_number == island_loop_index)
-			{
-				if ((bus[jindexer].type > 1) && (bus[jindexer].swing_functions_enabled == true))	//Swing bus - and we aren't ignoring it
-				{
-					for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
-					{
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = 1e10; // swing bus gets large admittance
-						indexer += 1;
-
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind + powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re();	//Normal admittance portion
-						indexer += 1;
-
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind - powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re();	//Normal admittance portion
-						indexer += 1;
-
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = 1e10; // swing bus gets large admittance
-						indexer += 1;
-					}//End swing bus traversion
-				}//End swing bus
-
-				if ((bus[jindexer].type == 0) || ((bus[jindexer].type > 1) && bus[jindexer].swing_functions_enabled == false))	//Only do on PQ (or SWING masquerading as PQ)
-				{
-					for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
-					{
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Im() + bus[jindexer].Jacob_A[jindex]; // Equation(14)
-						indexer += 1;
-						
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind + powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re() + bus[jindexer].Jacob_B[jindex]; // Equation(15)
-						indexer += 1;
-						
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = 2*bus[jindexer].Matrix_Loc + jindex;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Re() + bus[jindexer].Jacob_C[jindex]; // Equation(16)
-						indexer += 1;
-						
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind = 2*bus[jindexer].Matrix_Loc + jindex + powerflow_values->BA_diag[jindexer].size;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
-						powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][jindex]).Im() + bus[jindexer].Jacob_D[jindex]; // Equation(17)
-						indexer += 1;
-					}//end PQ phase traversion
-				}//End PQ bus
-			}//End island relevance check
-		}//End bus parse list
-
-		// Build the Amatrix, Amatrix includes all the elements of Y_offdiag_PQ, Y_diag_fixed and Y_diag_update.
-		powerflow_values->island_matrix_values[island_loop_index].size_Amatrix = powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2 + powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2 + 4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update;
-
-		//Test to make sure it isn't an empty matrix - reliability induced 3-phase fault
-		if (powerflow_values->island_matrix_values[island_loop_index].size_Amatrix==0)
+		for (indexer=0; indexer<bus_count; indexer++) // Construct the diagonal elements of Bus admittance matrix.
 		{
-			//Figure out which message to send
-			if (NR_islands_detected > 1)
-			{
-				gl_warning("Empty powerflow connectivity matrix for island %d, your system is empty!",(island_loop_index+1));
-				/*  TROUBLESHOOT
-				Newton-Raphson has an empty admittance matrix that it is trying to solve.  Either the whole system
-				faulted, or something is not properly defined.  Please try again.  If the problem persists, please
-				submit your code and a bug report via the trac website.
-				*/
-			}
-			else	//Single island
+			//Increment the island bus counter
+			if (bus[indexer].island_number != -1)
 			{
-				gl_warning("Empty powerflow connectivity matrix, your system is empty!");
-				/*  TROUBLESHOOT
-				Newton-Raphson has an empty admittance matrix that it is trying to solve.  Either the whole system
-				faulted, or something is not properly defined.  Please try again.  If the problem persists, please
-				submit your code and a bug report via the trac website.
-				*/
+				powerflow_values->island_matrix_values[bus[indexer].island_number].bus_count++;
 			}
 
-			//Set our return code, like success
-			powerflow_values->island_matrix_values[island_loop_index].return_code = 0;
-
-			//Figure out next steps - routine copied from the end of the iteration loop
-
-			//See if we need to continue
-			if (island_loop_index >= (NR_islands_detected - 1))	//We're the last one
+			//Determine the size we need
+			if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
+				powerflow_values->BA_diag[indexer].size = 2;
+			else										//Other cases, figure out how big they are
 			{
-				//Set the flag to be done
-				still_iterating_islands = false;
+				phase_worka = 0;
+				for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
+				{
+					phase_worka += ((bus[indexer].phases & (0x01 << jindex)) >> jindex);
+				}
+				powerflow_values->BA_diag[indexer].size = phase_worka;
 			}
-			else	//Not last -- increment the counter and onwards
-			{
-				//Increment the counter
-				island_loop_index++;
 
-				//Force the flag, just to be paranoid
-				still_iterating_islands = true;
+			//Ensure the admittance matrix is zeroed
+			for (jindex=0; jindex<3; jindex++)
+			{
+				for (kindex=0; kindex<3; kindex++)
+				{
+					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = 0;
+					tempY[jindex][kindex] = 0;
+				}
 			}
 
-			//Continue the while (or attempt to do so)
-			continue;
-		}
-
-		if (powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix == NULL)
-		{
-			powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix = (SPARSE*) gl_malloc(sizeof(SPARSE));
-
-			//Make sure it worked
-			if (powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix == NULL)
-				GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
-
-			//Initiliaze it
-			sparse_init(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, powerflow_values->island_matrix_values[island_loop_index].size_Amatrix, 6*powerflow_values->island_matrix_values[island_loop_index].bus_count);
-		}
-		else if (powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed)	//If one of the above changed, we changed too
-		{
-			//Destroy the old version
-			sparse_clear(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix);
-
-			//Create a new 
-			sparse_init(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, powerflow_values->island_matrix_values[island_loop_index].size_Amatrix, 6*powerflow_values->island_matrix_values[island_loop_index].bus_count);
-		}
-		else
-		{
-			//Just clear it out
-			sparse_reset(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, 6*powerflow_values->island_matrix_values[island_loop_index].bus_count);
-		}
-
-		//integrate off diagonal components
-		for (indexer=0; indexer<powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2; indexer++)
-		{
-			row = powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ[indexer].row_ind;
-			col = powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ[indexer].col_ind;
-			value = powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ[indexer].Y_value;
-			sparse_add(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, row, col, value, bus, bus_count, powerflow_values, island_loop_index);
-		}
-
-		//Integrate fixed portions of diagonal components
-		for (indexer=0; indexer< (powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2); indexer++)
-		{
-			row = powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed[indexer].row_ind;
-			col = powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed[indexer].col_ind;
-			value = powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed[indexer].Y_value;
-			sparse_add(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, row, col, value, bus, bus_count, powerflow_values, island_loop_index);
-		}
-
-		//Integrate the variable portions of the diagonal components
-		for (indexer=0; indexer< (4*powerflow_values->island_matrix_values[island_loop_index].size_diag_update); indexer++)
-		{
-			row = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].row_ind;
-			col = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].col_ind;
-			value = powerflow_values->island_matrix_values[island_loop_index].Y_diag_update[indexer].Y_value;
-			sparse_add(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, row, col, value, bus, bus_count, powerflow_values, island_loop_index);
-		}
-
-		//See if we want to dump out the matrix values
-		if (NRMatDumpMethod != MD_NONE)
-		{
-			//Code to export the sparse matrix values - useful for debugging issues
-
-			//Reset the flag
-			something_has_been_output = false;
-
-			//Check our frequency
-			if ((NRMatDumpMethod == MD_ALL) || ((NRMatDumpMethod != MD_ALL) && (powerflow_values->island_matrix_values[island_loop_index].iteration_count == 0)))
+			//If we're in any deltamode, store out self-admittance as well, if it exists
+			if ((powerflow_type!=PF_NORMAL) && (bus[indexer].full_Y != NULL))
 			{
-				//Open the text file - append now
-				FPoutVal=fopen(MDFileName,"at");
-
-				//See if we wanted references - Only do this once per call, regardless (keeps file size down)
-				if ((NRMatReferences == true) && (powerflow_values->island_matrix_values[island_loop_index].iteration_count == 0))
+				//Loop and add
+				for (jindex=0; jindex<3; jindex++)
 				{
-					//Print the index information
-					if (NR_islands_detected > 1)
-					{
-						fprintf(FPoutVal,"Matrix Index information for this call in island:%d - start,stop,name\n",(island_loop_index+1));
-					}
-					else
-					{
-						fprintf(FPoutVal,"Matrix Index information for this call - start,stop,name\n");
-					}
-
-					for (indexer=0; indexer<bus_count; indexer++)
+					for (kindex=0; kindex<3; kindex++)
 					{
-						//Island check
-						if (bus[indexer].island_number == island_loop_index)
-						{
-							//Extract the start/stop indices
-							jindexer = 2*bus[indexer].Matrix_Loc;
-							kindexer = jindexer + 2*powerflow_values->BA_diag[indexer].size - 1;
-
-							//Print them out
-							fprintf(FPoutVal,"%d,%d,%s\n",jindexer,kindexer,bus[indexer].name);
-
-							//Set the flag
-							something_has_been_output = true;
-						}//End island check
+						tempY[jindex][kindex] = bus[indexer].full_Y[jindex*3+kindex];	//Adds in any self-admittance terms (generators)
 					}
+				}
+			}
 
-					//Add in a blank line so it looks pretty
-					fprintf(FPoutVal,"\n");
-				}//End print the references
-
-				//Print the simulation time and iteration number
-				fprintf(FPoutVal,"Timestamp: %lld - Iteration %lld\n",gl_globalclock,powerflow_values->island_matrix_values[island_loop_index].iteration_count);
+			//Now go through all of the branches to get the self admittance information (hinges on size)
+			for (kindexer=0; kindexer<(bus[indexer].Link_Table_Size);kindexer++)
+			{ 
+				//Assign jindexer as intermediate variable (easier for me this way)
+				jindexer = bus[indexer].Link_Table[kindexer];
 
-				//See if anything wrote out
-				if (something_has_been_output == true)
+				if ((branch[jindexer].from == indexer) || (branch[jindexer].to == indexer))	//Bus is the from or to side of things - not sure how it would be in link table otherwise, but meh
 				{
-					//Print size - for parsing ease
-					fprintf(FPoutVal,"Matrix Information - non-zero element count = %d\n",powerflow_values->island_matrix_values[island_loop_index].size_Amatrix);
-					
-					//Print the values - printed as "row index, column index, value"
-					//This particular output is after they have been column sorted for the algorithm
-					//Header
-					fprintf(FPoutVal,"Matrix Information - row, column, value\n");
-
-					//Null temp variable
-					temp_element = NULL;
-
-					//Loop through the columns, extracting starting point each time
-					for (jindexer=0; jindexer<powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix->ncols; jindexer++)
+					if ((bus[indexer].phases & 0x07) == 0x07)		//Full three phase
 					{
-						//Extract the column starting point
-						temp_element = powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix->cols[jindexer];
-
-						//Check for nulling
-						if (temp_element != NULL)
+						for (jindex=0; jindex<3; jindex++)	//Add in all three phase values
 						{
-							//Print this value
-							fprintf(FPoutVal,"%d,%d,%f\n",temp_element->row_ind,jindexer,temp_element->value);
+							//See if this phase is valid
+							phase_workb = 0x04 >> jindex;
 
-							//Loop
-							while (temp_element->next != NULL)
+							if ((phase_workb & branch[jindexer].phases) == phase_workb)
 							{
-								//Get next element
-								temp_element = temp_element->next;
+								for (kindex=0; kindex<3; kindex++)
+								{
+									//Check phase
+									phase_workd = 0x04 >> kindex;
 
-								//Repeat the print
-								fprintf(FPoutVal,"%d,%d,%f\n",temp_element->row_ind,jindexer,temp_element->value);
-							}
+									if ((phase_workd & branch[jindexer].phases) == phase_workd)
+									{
+										if (branch[jindexer].from == indexer)	//We're the from version
+										{
+											tempY[jindex][kindex] += branch[jindexer].YSfrom[jindex*3+kindex];
+										}
+										else									//Must be the to version
+										{
+											tempY[jindex][kindex] += branch[jindexer].YSto[jindex*3+kindex];
+										}
+									}//End valid column phase
+								}
+							}//End valid row phase
 						}
-						//If it is null, go next.  Implies we have an invalid matrix size, but that may be what we're looking for
-					}//End sparse matrix traversion for dump
-
-					//Print an extra line, so it looks nice for ALL/PERCALL
-					fprintf(FPoutVal,"\n");
-				}
-				else //Nothing written - indicate as much
-				{
-					//Print the emptiness
-					fprintf(FPoutVal,"Empty island (possibly powerflow-removed)\n\n");
-				}
-
-				//Close the file, we're done with it
-				fclose(FPoutVal);
-
-				//See if we were a "ONCE" - if so, deflag us
-				if (NRMatDumpMethod == MD_ONCE)
-				{
-					//See if we're a multi-island -- if so, only do this on the last one
-					if (NR_islands_detected > 1)
-					{
-						//See if we're the last one
-						if (island_loop_index >= (NR_islands_detected - 1))
+					}
+					else if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase - add in 2x2 element to upper left 2x2
+					{
+						if (branch[jindexer].from == indexer)	//From branch
+						{
+							//End of SPCT transformer requires slightly different Diagonal components (so when it's the To bus of SPCT and from for other triplex
+							if ((bus[indexer].phases & 0x20) == 0x20)	//Special case
+							{
+								//Other triplexes need to be negated to match sign conventions
+								tempY[0][0] -= branch[jindexer].YSfrom[0];
+								tempY[0][1] -= branch[jindexer].YSfrom[1];
+								tempY[1][0] -= branch[jindexer].YSfrom[3];
+								tempY[1][1] -= branch[jindexer].YSfrom[4];
+							}
+							else										//Just a normal to bus
+							{
+								tempY[0][0] += branch[jindexer].YSfrom[0];
+								tempY[0][1] += branch[jindexer].YSfrom[1];
+								tempY[1][0] += branch[jindexer].YSfrom[3];
+								tempY[1][1] += branch[jindexer].YSfrom[4];
+							}
+						}
+						else									//To branch
 						{
-							NRMatDumpMethod = MD_NONE;	//Flag to do no more
+							//Replicate the above for SPCT test, in case people put lines in backwards
+							//End of SPCT transformer requires slightly different Diagonal components (so when it's the To bus of SPCT and from for other triplex
+							if (((bus[indexer].phases & 0x20) == 0x20) && (branch[jindexer].lnk_type == 1))	//Special case, but make sure we're not the transformer
+							{
+								tempY[0][0] -= branch[jindexer].YSto[0];
+								tempY[0][1] -= branch[jindexer].YSto[1];
+								tempY[1][0] -= branch[jindexer].YSto[3];
+								tempY[1][1] -= branch[jindexer].YSto[4];
+							}
+							else	//Normal bus - no funky SPCT nonsense
+							{
+								tempY[0][0] += branch[jindexer].YSto[0];
+								tempY[0][1] += branch[jindexer].YSto[1];
+								tempY[1][0] += branch[jindexer].YSto[3];
+								tempY[1][1] += branch[jindexer].YSto[4];
+							}
 						}
-						//Default else -- we're not the last one, so stay as MD_ONCE
 					}
-					else
+					else	//We must be a single or two-phase line - always populate the upper left portion of matrix (easier for later)
 					{
-						NRMatDumpMethod = MD_NONE;	//Flag to do no more
-					}
-				}
-			}//End Actual output
-		}//End matrix dump desired
+						switch(bus[indexer].phases & 0x07) {
+							case 0x00:	//No phases (we've been faulted out
+								{
+									break;	//Just get us outta here
+								}
+							case 0x01:	//Only C
+								{
+									if ((branch[jindexer].phases & 0x01) == 0x01)	//Phase C valid on branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[8];
+										}
+									}//End valid phase C
+									break;
+								}
+							case 0x02:	//Only B
+								{
+									if ((branch[jindexer].phases & 0x02) == 0x02)	//Phase B valid on branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[4];
+										}
+									}//End valid phase B
+									break;
+								}
+							case 0x03:	//B & C
+								{
+									phase_worka = (branch[jindexer].phases & 0x03);	//Extract branch phases
 
-		///* Initialize parameters. */
-		m = 2*powerflow_values->island_matrix_values[island_loop_index].total_variables;
-		n = 2*powerflow_values->island_matrix_values[island_loop_index].total_variables;
-		nnz = powerflow_values->island_matrix_values[island_loop_index].size_Amatrix;
+									if (phase_worka == 0x03)	//Full B & C
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[4];
+											tempY[0][1] += branch[jindexer].YSfrom[5];
+											tempY[1][0] += branch[jindexer].YSfrom[7];
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[4];
+											tempY[0][1] += branch[jindexer].YSto[5];
+											tempY[1][0] += branch[jindexer].YSto[7];
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//End valid B & C
+									else if (phase_worka == 0x01)	//Only C branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//end valid C
+									else if (phase_worka == 0x02)	//Only B branch
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[4];
+										}
+									}//end valid B
+									else	//Must be nothing then - all phases must be faulted, or something
+										;
+									break;
+								}
+							case 0x04:	//Only A
+								{
+									if ((branch[jindexer].phases & 0x04) == 0x04)	//Phase A is valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+										}
+									}//end valid phase A
+									break;
+								}
+							case 0x05:	//A & C
+								{
+									phase_worka = branch[jindexer].phases & 0x05;	//Extract phases
 
-		if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU == NULL)	//First run
-		{
-			/* Set aside space for the arrays. */
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU = (double *) gl_malloc(nnz *sizeof(double));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU==NULL)
-			{
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
-				/*  TROUBLESHOOT
-				While attempting to allocate the memory for one of the SuperLU working matrices,
-				an error was encountered and it was not allocated.  Please try again.  If it fails
-				again, please submit your code and a bug report using the trac website.
-				*/
-			}
-			
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU = (int *) gl_malloc(nnz *sizeof(int));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU == NULL)
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+									if (phase_worka == 0x05)	//Both A & C valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+											tempY[0][1] += branch[jindexer].YSfrom[2];
+											tempY[1][0] += branch[jindexer].YSfrom[6];
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+											tempY[0][1] += branch[jindexer].YSto[2];
+											tempY[1][0] += branch[jindexer].YSto[6];
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//End A & C valid
+									else if (phase_worka == 0x04)	//Only A valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+										}
+									}//end only A valid
+									else if (phase_worka == 0x01)	//Only C valid
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[1][1] += branch[jindexer].YSfrom[8];
+										}
+										else									//To branch
+										{
+											tempY[1][1] += branch[jindexer].YSto[8];
+										}
+									}//end only C valid
+									else	//No connection - must be faulted
+										;
+									break;
+								}
+							case 0x06:	//A & B
+								{
+									phase_worka = branch[jindexer].phases & 0x06;	//Extract phases
 
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU = (int *) gl_malloc((n+1) *sizeof(int));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU == NULL)
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+									if (phase_worka == 0x06)	//Valid A & B phase
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+											tempY[0][1] += branch[jindexer].YSfrom[1];
+											tempY[1][0] += branch[jindexer].YSfrom[3];
+											tempY[1][1] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+											tempY[0][1] += branch[jindexer].YSto[1];
+											tempY[1][0] += branch[jindexer].YSto[3];
+											tempY[1][1] += branch[jindexer].YSto[4];
+										}
+									}//End valid A & B
+									else if (phase_worka == 0x04)	//Only valid A
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[0][0] += branch[jindexer].YSfrom[0];
+										}
+										else									//To branch
+										{
+											tempY[0][0] += branch[jindexer].YSto[0];
+										}
+									}//end valid A
+									else if (phase_worka == 0x02)	//Only valid B
+									{
+										if (branch[jindexer].from == indexer)	//From branch
+										{
+											tempY[1][1] += branch[jindexer].YSfrom[4];
+										}
+										else									//To branch
+										{
+											tempY[1][1] += branch[jindexer].YSto[4];
+										}
+									}//end valid B
+									else	//Default - must be already handled
+										;
+									break;
+								}
+							default:	//How'd we get here?
+								{
+									GL_THROW("Unknown phase connection in NR self admittance diagonal");
+									/*  TROUBLESHOOT
+									An unknown phase condition was encountered in the NR solver when constructing
+									the self admittance diagonal.  Please report this bug and submit your code to 
+									the trac system.
+									*/
+								break;
+								}
+						}	//switch end
+					}	//1 or 2 phase end
+				}	//phase accumulation end
+				else		//It's nothing (no connnection)
+					;
+			}//branch traversion end
 
-			/* Create the right-hand side matrix B. */
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU = (double *) gl_malloc(m *sizeof(double));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU == NULL)
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+			//Store the self admittance into BA_diag.  Also update the indices for possible use later
+			//Only do this if we're actually populated
+			island_index_val = bus[indexer].island_number;
 
-			if (matrix_solver_method==MM_SUPERLU)
+			if (island_index_val != -1)
+			{
+				powerflow_values->BA_diag[indexer].col_ind = powerflow_values->BA_diag[indexer].row_ind = powerflow_values->island_matrix_values[island_index_val].index_count;	// Store the row and column starting information (square matrices)
+				bus[indexer].Matrix_Loc = powerflow_values->island_matrix_values[island_index_val].index_count;								//Store our location so we know where we go
+				powerflow_values->island_matrix_values[island_index_val].index_count += powerflow_values->BA_diag[indexer].size;				// Update the index for this matrix's size, so next one is in appropriate place
+			}
+
+			//Store the admittance values into the BA_diag matrix structure
+			for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+			{
+				for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
+				{
+					powerflow_values->BA_diag[indexer].Y[jindex][kindex] = tempY[jindex][kindex];// Store the self admittance terms.
+				}
+			}
+
+			//Copy values into node-specific link (if needed)
+			if (bus[indexer].full_Y_all != NULL)
 			{
-				///* Set up the arrays for the permutations. */
-				curr_island_superLU_vars->perm_r = (int *) gl_malloc(m *sizeof(int));
-				if (curr_island_superLU_vars->perm_r == NULL)
-					GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+				for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)
+				{
+					for (kindex=0; kindex<powerflow_values->BA_diag[indexer].size; kindex++)			//Store values - assume square matrix - don't bother parsing what doesn't exist.
+					{
+						bus[indexer].full_Y_all[jindex*3+kindex] = tempY[jindex][kindex];// Store the self admittance terms.
+					}
+				}
+			}//End self-admittance update
+		}//End diagonal construction
 
-				curr_island_superLU_vars->perm_c = (int *) gl_malloc(n *sizeof(int));
-				if (curr_island_superLU_vars->perm_c == NULL)
-					GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+		//Loop through the islands and set the initial items
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+		{
+			//Store the size of the diagonal, since it represents how many variables we are solving (useful later)
+			powerflow_values->island_matrix_values[island_loop_index].total_variables = powerflow_values->island_matrix_values[island_loop_index].index_count;
 
-				//Set up storage pointers - single element, but need to be malloced for some reason
-				curr_island_superLU_vars->A_LU.Store = (void *)gl_malloc(sizeof(NCformat));
-				if (curr_island_superLU_vars->A_LU.Store == NULL)
-					GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+			//Check to see if we've exceeded our max.  If so, reallocate!
+			if (powerflow_values->island_matrix_values[island_loop_index].total_variables > powerflow_values->island_matrix_values[island_loop_index].max_total_variables)
+				powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
 
-				curr_island_superLU_vars->B_LU.Store = (void *)gl_malloc(sizeof(DNformat));
-				if (curr_island_superLU_vars->B_LU.Store == NULL)
-					GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+			/// Build the off_diagonal_PQ bus elements of 6n*6n Y_NR matrix.Equation (12). All the value in this part will not be updated at each iteration.
+			//Constructed using sparse methodology, non-zero elements are the only thing considered (and non-PV)
+			//No longer necessarily 6n*6n any more either,
+			powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ = 0;
+		}//End loop traversion
 
-				//Populate these structures - A_LU matrix
-				curr_island_superLU_vars->A_LU.Stype = SLU_NC;
-				curr_island_superLU_vars->A_LU.Dtype = SLU_D;
-				curr_island_superLU_vars->A_LU.Mtype = SLU_GE;
-				curr_island_superLU_vars->A_LU.nrow = n;
-				curr_island_superLU_vars->A_LU.ncol = m;
+		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse all of the branches
+		{
+			tempa  = branch[jindexer].from;
+			tempb  = branch[jindexer].to;
 
-				//Populate these structures - B_LU matrix
-				curr_island_superLU_vars->B_LU.Stype = SLU_DN;
-				curr_island_superLU_vars->B_LU.Dtype = SLU_D;
-				curr_island_superLU_vars->B_LU.Mtype = SLU_GE;
-				curr_island_superLU_vars->B_LU.nrow = m;
-				curr_island_superLU_vars->B_LU.ncol = 1;
-			}
-			else if (matrix_solver_method == MM_EXTERN)	//External routine
+			//Pull the island index off the from bus -- for islands, both ends SHOULD be in the same index
+			island_index_val = bus[tempa].island_number;
+
+			//Check and see if we should just skip this branch -- if it's an unassociated node, probably don't need this branch
+			if (island_index_val == -1)
 			{
-				//Run allocation routine
-				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,n,n,NR_admit_change);
+				continue;
 			}
-			else
+
+			//Preliminary check to make sure we weren't missed in the initialization
+			if ((bus[tempa].Matrix_Loc == -1) || (bus[tempb].Matrix_Loc == -1))
 			{
-				GL_THROW("Invalid matrix solution method specified for NR solver!");
-				//Defined elsewhere
+				GL_THROW("An element in NR line:%d was not properly localized");
+				/*  TROUBLESHOOT
+				When parsing the bus list, the Newton-Raphson solver found a bus that did not
+				appear to have a location within the overall admittance/Jacobian matrix.  Please
+				submit this as a bug with your code on the Trac site.
+				*/
 			}
 
-			//Update tracking variable
-			powerflow_values->island_matrix_values[island_loop_index].prev_m = m;
-		}
-		else if (powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed)	//Something changed, we'll just destroy everything and start over
-		{
-			//Get rid of all of them first
-			gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU);
-			gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU);
-			gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU);
-			gl_free(powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU);
+			if (((branch[jindexer].phases & 0x80) == 0x80) && (branch[jindexer].v_ratio==1.0))	//Triplex, but not SPCT
+			{
+				for (jindex=0; jindex<2; jindex++)			//rows
+				{
+					for (kindex=0; kindex<2; kindex++)		//columns
+					{
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
 
-			if (matrix_solver_method==MM_SUPERLU)
+						if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+
+						if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+							powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+					}//end columns of split phase
+				}//end rows of split phase
+			}//end traversion of split-phase
+			else											//Three phase or some variety
 			{
-				//Free up superLU matrices
-				gl_free(curr_island_superLU_vars->perm_r);
-				gl_free(curr_island_superLU_vars->perm_c);
-			}
-			//Default else - don't care - destructions are presumed to be handled inside external LU's alloc function
+				//Make sure we aren't SPCT, otherwise things get jacked
+				if ((branch[jindexer].phases & 0x80) != 0x80)	//SPCT, but v_ratio not = 1
+				{
+					for (jindex=0; jindex<3; jindex++)			//rows
+					{
+						//See if this phase is valid
+						phase_workb = 0x04 >> jindex;
 
-			/* Set aside space for the arrays. - Copied from above */
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU = (double *) gl_malloc(nnz *sizeof(double));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU==NULL)
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
-			
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU = (int *) gl_malloc(nnz *sizeof(int));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU == NULL)
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+						{
+							for (kindex=0; kindex<3; kindex++)		//columns
+							{
+								//Check this phase as well
+								phase_workd = 0x04 >> kindex;
 
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU = (int *) gl_malloc((n+1) *sizeof(int));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU == NULL)
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+								if ((phase_workd & branch[jindexer].phases) == phase_workd)	//Column validity check
+								{
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
 
-			/* Create the right-hand side matrix B. */
-			powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU = (double *) gl_malloc(m *sizeof(double));
-			if (powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU == NULL)
-				GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
 
-			if (matrix_solver_method==MM_SUPERLU)
-			{
-				///* Set up the arrays for the permutations. */
-				curr_island_superLU_vars->perm_r = (int *) gl_malloc(m *sizeof(int));
-				if (curr_island_superLU_vars->perm_r == NULL)
-					GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+										powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+								}//end column validity check
+							}//end columns of 3 phase
+						}//End row validity check
+					}//end rows of 3 phase
+				}//end not SPCT
+				else	//SPCT implementation
+				{
+					for (jindex=0; jindex<3; jindex++)			//rows
+					{
+						//See if this phase is valid
+						phase_workb = 0x04 >> jindex;
 
-				curr_island_superLU_vars->perm_c = (int *) gl_malloc(n *sizeof(int));
-				if (curr_island_superLU_vars->perm_c == NULL)
-					GL_THROW("NR: One of the SuperLU solver matrices failed to allocate");
+						if ((phase_workb & branch[jindexer].phases) == phase_workb)	//Row check
+						{
+							for (kindex=0; kindex<3; kindex++)		//Row valid, traverse all columns for SPCT Yfrom
+							{
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))
+									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
 
-				//Update structures - A_LU matrix
-				curr_island_superLU_vars->A_LU.Stype = SLU_NC;
-				curr_island_superLU_vars->A_LU.Dtype = SLU_D;
-				curr_island_superLU_vars->A_LU.Mtype = SLU_GE;
-				curr_island_superLU_vars->A_LU.nrow = n;
-				curr_island_superLU_vars->A_LU.ncol = m;
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+							}//end columns traverse
 
-				//Update structures - B_LU matrix
-				curr_island_superLU_vars->B_LU.Stype = SLU_DN;
-				curr_island_superLU_vars->B_LU.Dtype = SLU_D;
-				curr_island_superLU_vars->B_LU.Mtype = SLU_GE;
-				curr_island_superLU_vars->B_LU.nrow = m;
-				curr_island_superLU_vars->B_LU.ncol = 1;
-			}
-			else if (matrix_solver_method == MM_EXTERN)	//External routine
-			{
-				//Run allocation routine
-				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,n,n,NR_admit_change);
-			}
-			else
-			{
-				GL_THROW("Invalid matrix solution method specified for NR solver!");
-				//Defined elsewhere
-			}
+							//If row is valid, now traverse the rows of that column for Yto
+							for (kindex=0; kindex<3; kindex++)
+							{
+								if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))  
+									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
 
-			//Update tracking variable
-			powerflow_values->island_matrix_values[island_loop_index].prev_m = m;
-		}
-		else if (powerflow_values->island_matrix_values[island_loop_index].prev_m != m)	//Non-reallocing size change occurred
+								if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1)) 
+									powerflow_values->island_matrix_values[island_index_val].size_offdiag_PQ += 1; 
+							}//end rows traverse
+						}//End row validity check
+					}//end rows of 3 phase
+				}//End SPCT
+			}//end three phase
+		}//end line traversion
+
+		//Loop through the islands again
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
 		{
-			if (matrix_solver_method==MM_SUPERLU)
+			//Allocate the space - double the number found (each element goes in two places)
+			if (powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ == NULL)
 			{
-				//Update relevant portions
-				curr_island_superLU_vars->A_LU.nrow = n;
-				curr_island_superLU_vars->A_LU.ncol = m;
+				powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2) *sizeof(Y_NR));   //powerflow_values->island_matrix_values[x].Y_offdiag_PQ store the row,column and value of off_diagonal elements of Bus Admittance matrix in which all the buses are not PV buses. 
 
-				curr_island_superLU_vars->B_LU.nrow = m;
-			}
-			else if (matrix_solver_method == MM_EXTERN)	//External routine - call full reallocation, just in case
-			{
-				//Run allocation routine
-				((void (*)(void *,unsigned int, unsigned int, bool))(LUSolverFcns.ext_alloc))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,n,n,NR_admit_change);
+				//Make sure it worked
+				if (powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+
+				//Save our size
+				powerflow_values->island_matrix_values[island_loop_index].max_size_offdiag_PQ = powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ;	//Don't care about the 2x, since we'll be comparing it against itself
 			}
-			else
+			else if (powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ > powerflow_values->island_matrix_values[island_loop_index].max_size_offdiag_PQ)	//Something changed and we are bigger!!
 			{
-				GL_THROW("Invalid matrix solution method specified for NR solver!");
-				//Defined elsewhere
+				//Destroy us!
+				gl_free(powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ);
+
+				//Rebuild us, we have the technology
+				powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ*2) *sizeof(Y_NR));
+
+				//Make sure it worked
+				if (powerflow_values->island_matrix_values[island_loop_index].Y_offdiag_PQ == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+
+				//Store the new size
+				powerflow_values->island_matrix_values[island_loop_index].max_size_offdiag_PQ = powerflow_values->island_matrix_values[island_loop_index].size_offdiag_PQ;
+
+				//Flag for a reallocation
+				powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
 			}
 
-			//Update tracking variable
-			powerflow_values->island_matrix_values[island_loop_index].prev_m = m;
-		}
+			//Zero the indexer term used in the next section
+			powerflow_values->island_matrix_values[island_loop_index].indexer = 0;
+		}//End island loop
 
-#ifndef MT
-		if (matrix_solver_method==MM_SUPERLU)
+		for (jindexer=0; jindexer<branch_count;jindexer++)	//Parse through all of the branches
 		{
-			/* superLU sequential options*/
-			set_default_options ( &options );
-		}
-		//Default else - not superLU
-#endif
-		
-		sparse_tonr(powerflow_values->island_matrix_values[island_loop_index].Y_Amatrix, &powerflow_values->island_matrix_values[island_loop_index].matrices_LU);
-		powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU[n] = nnz ;// number of non-zeros;
+			//Extract both ends
+			tempa  = branch[jindexer].from;
+			tempb  = branch[jindexer].to;
 
-		//Determine how to populate the rhs vector
-		if (mesh_imped_vals == NULL)	//Normal powerflow, copy in the values
-		{
-			for (temp_index_c=0;temp_index_c<m;temp_index_c++)
-			{ 
-				powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU[temp_index_c] = powerflow_values->island_matrix_values[island_loop_index].deltaI_NR[temp_index_c];
+			//Pull the island index off the from bus -- for islands, both ends SHOULD be in the same index
+			island_index_val = bus[tempa].island_number;
+
+			//Make sure it isn't invalid -- if it is, just skip this, since that means these lines do nothing anyways
+			if (island_index_val == -1)
+			{
+				continue;
 			}
-		}
-		//Default else -- it is NULL - zero it and "populate it" below
 
-		if (matrix_solver_method==MM_SUPERLU)
-		{
-			////* Create Matrix A in the format expected by Super LU.*/
-			//Populate the matrix values (temporary value)
-			Astore = (NCformat*)curr_island_superLU_vars->A_LU.Store;
-			Astore->nnz = nnz;
-			Astore->nzval = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.a_LU;
-			Astore->rowind = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rows_LU;
-			Astore->colptr = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.cols_LU;
-			
-			// Create right-hand side matrix B in format expected by Super LU
-			//Populate the matrix (temporary values)
-			Bstore = (DNformat*)curr_island_superLU_vars->B_LU.Store;
-			Bstore->lda = m;
-			Bstore->nzval = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU;
-
-			//See how to call the function - if normal mode or not
-			//**************************** How will this work with islanding stuff !?!?!?!? ****************************
-			if (mesh_imped_vals != NULL)
+			phase_worka = 0;
+			phase_workb = 0;
+			for (jindex=0; jindex<3; jindex++)		//Accumulate number of phases
 			{
-				//Start with "failure" option on the structure
-				mesh_imped_vals->return_code = 0;
+				phase_worka += ((bus[tempa].phases & (0x01 << jindex)) >> jindex);
+				phase_workb += ((bus[tempb].phases & (0x01 << jindex)) >> jindex);
+			}
 
-				//Determine the base index (error check)
-				if (mesh_imped_vals->NodeRefNum > 0)
-				{
-					tempa = 2*bus[mesh_imped_vals->NodeRefNum].Matrix_Loc;	//These are already separated into real/imag, so the base is 2x
-				}
-				else	//Error
+			if ((phase_worka==3) && (phase_workb==3))	//Both ends are full three phase, normal operations
+			{
+				for (jindex=0; jindex<3; jindex++)		//Loop through rows of admittance matrices				
 				{
-					gl_error("solver_nr: Node reference for mesh fault calculation was invalid -- it may be a child");
-					/*  TROUBLESHOOT
-					While attempting to compute the equivalent impedance at a mesh faulted node, an invalid node reference
-					was found.  This is likely an internal error to the code -- submit your code and a bug report via the
-					tracking website.
-					*/
-
-					//Set the flags
-					mesh_imped_vals->return_code = 0;
-					*bad_computations = true;
-
-					//Deflag the island locker, though not really needed
-					NR_solver_working = false;
+					//See if this row is valid for this branch
+					phase_workd = 0x04 >> jindex;
 
-					//Return a 0 to flag
-					return 0;
-				}
+					if ((branch[jindexer].phases & phase_workd) == phase_workd)	//Validity check
+					{
+						for (kindex=0; kindex<3; kindex++)	//Loop through columns of admittance matrices
+						{
+							//Extract column information
+							phase_worke = 0x04 >> kindex;
 
-				//Determine our phasing size - what entries to pull - double for the complex notation
-				temp_size = 2*powerflow_values->BA_diag[mesh_imped_vals->NodeRefNum].size;
+							if ((branch[jindexer].phases & phase_worke) == phase_worke)	//Valid column too!
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								}
+
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								}
+
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+								}
+
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 3;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+								}
+							}//End valid column
+						}//column end
+					}//End valid row
+				}//row end
+			}//if all 3 end
+			else if (((bus[tempa].phases & 0x80) == 0x80) || ((bus[tempb].phases & 0x80) == 0x80))	//Someone's a triplex
+			{
+				if (((bus[tempa].phases & 0x80) == 0x80) && ((bus[tempb].phases & 0x80) == 0x80))	//Both are triplex, easy case
+				{
+					for (jindex=0; jindex<2; jindex++)		//Loop through rows of admittance matrices (only 2x2)
+					{
+						for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
+						{
+							//Make sure one end of us isn't a SPCT transformer To node (they are different)
+							if (((bus[tempa].phases & 0x20) & (bus[tempb].phases & 0x20)) == 0x20)	//Both ends are SPCT tos
+							{
+								GL_THROW("NR: SPCT to SPCT via triplex connections are unsupported at this time.");
+								/*  TROUBLESHOOT
+								The Newton-Raphson solve does not currently support running a triplex line between the low-voltage
+								side of two different split-phase center tapped transformers.  This functionality may be added if needed
+								in the future.
+								*/
+							}//end both ends SPCT to
+							else if ((bus[tempa].phases & 0x20) == 0x20)	//From end is a SPCT to
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								}
+
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								}
+
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+								}
+
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+								}
+							}//end From end SPCT to
+							else if ((bus[tempb].phases & 0x20) == 0x20)	//To end is a SPCT to
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+
+								//Make sure we aren't the transformer
+								if (branch[jindexer].lnk_type == 1)	//We're not, we're a line - proceed
+								{
+
+									//Indices counted out from Self admittance above.  needs doubling due to complex separation
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+								}//End SPCT TO bus and we're a line
+								else	//Transformer to - don't do things weird
+								{
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Im());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(branch[jindexer].Yto[jindex*3+kindex]).Im();
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+
+									if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+
+									if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
+									{
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+										powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = ((branch[jindexer].Yto[jindex*3+kindex]).Re());
+										powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									}
+								}//End SPCT TO and we're the transformer
+							}//end To end SPCT to
+							else											//Plain old ugly line
+							{
+								//Indices counted out from Self admittance above.  needs doubling due to complex separation
+
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								}
+
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Im());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[jindex*3+kindex]).Im();
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								}
+
+								if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+								}
+
+								if (((branch[jindexer].Yto[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1 && bus[tempb].type != 1))	//To reals
+								{
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+									
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + jindex;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + kindex + 2;
+									powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[jindex*3+kindex]).Re());
+									powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+								}
+							}//end Normal triplex branch
+						}//column end
+					}//row end
+				}//end both triplexy
+				else if ((bus[tempa].phases & 0x80) == 0x80)	//From is the triplex - this implies transformer with or something, we don't support this
+				{
+					GL_THROW("NR does not support triplex to 3-phase connections.");
+					/*  TROUBLESHOOT
+					The Newton-Raphson solver does not have any implementation elements
+					to support the connection of a split-phase or triplex node to a three-phase
+					node.  The opposite (3-phase to triplex) is available as the split-phase-center-
+					tapped transformer model.  See if that will work for your implementation.
+					*/
+				}//end from triplexy
+				else	//Only option left is the to must be the triplex - implies SPCT xformer - so only one phase on the three-phase side (we just need to figure out where)
+				{
+					//Extract the line phase
+					phase_workc = (branch[jindexer].phases & 0x07);
+
+					//Reset temp_index and size, just in case
+					temp_index = -1;
+					temp_size = -1;
+
+					//Figure out what the offset on the from side is (how many phases and which one we are)
+					switch(bus[tempa].phases & 0x07)
+					{
+						case 0x01:	//C
+							{
+								temp_size = 1;	//Single phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+								{
+									//Only C in the node, so no offset
+									temp_index = 0;
+								}
+								else if (phase_workc==0x02)	//Line is phase B
+								{
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+									/*  TROUBLESHOOT
+									A split-phase, center-tapped transformer in the Newton-Raphson solver is somehow attached
+									to a node that is missing the required phase of the transformer.  This should have been caught.
+									Please submit your code and a bug report using the trac website.
+									*/
+								}
+								else					//Has to be phase A
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+
+								break;
+							}
+						case 0x02:	//B
+							{
+								temp_size = 1;	//Single phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else if (phase_workc==0x02)	//Line is phase B
+								{
+									//Only B in the node, so no offset
+									temp_index = 0;
+								}
+								else					//Has to be phase A
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+
+								break;
+							}
+						case 0x03:	//BC
+							{
+								temp_size = 2;	//Two phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+								{
+									//BC in the node, so offset by 1
+									temp_index = 1;
+								}
+								else if (phase_workc==0x02)	//Line is phase B
+								{
+									//BC in the node, so offset by 0
+									temp_index = 0;
+								}
+								else					//Has to be phase A
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+
+								break;
+							}
+						case 0x04:	//A
+							{
+								temp_size = 1;	//Single phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else if (phase_workc==0x02)	//Line is phase B
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else					//Has to be phase A
+								{
+									//Only A in the node, so no offset
+									temp_index = 0;
+								}
+
+								break;
+							}
+						case 0x05:	//AC
+							{
+								temp_size = 2;	//Two phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+								{
+									//AC in the node, so offset by 1
+									temp_index = 1;
+								}
+								else if (phase_workc==0x02)	//Line is phase B
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else					//Has to be phase A
+								{
+									//AC in the node, so offset by 0
+									temp_index = 0;
+								}
+
+								break;
+							}
+						case 0x06:	//AB
+							{
+								temp_size = 2;	//Two phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+									GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+								else if (phase_workc==0x02)	//Line is phase B
+								{
+									//BC in the node, so offset by 1
+									temp_index = 1;
+								}
+								else					//Has to be phase A
+								{
+									//AB in the node, so offset by 0
+									temp_index = 0;
+								}
+
+								break;
+							}
+						case 0x07:	//ABC
+							{
+								temp_size = 3;	//Three phase matrix
+
+								if (phase_workc==0x01)	//Line is phase C
+								{
+									//ABC in the node, so offset by 2
+									temp_index = 2;
+								}
+								else if (phase_workc==0x02)	//Line is phase B
+								{
+									//ABC in the node, so offset by 1
+									temp_index = 1;
+								}
+								else					//Has to be phase A
+								{
+									//ABC in the node, so offset by 0
+									temp_index = 0;
+								}
+
+								break;
+							}
+						default:
+							GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+							break;
+					}//end switch
+					if ((temp_index==-1) || (temp_size==-1))	//Should never get here
+						GL_THROW("NR: A center-tapped transformer has an invalid phase matching");
+
+					//Determine first index
+					if (phase_workc==0x01)	//Line is phase C
+					{
+						jindex=2;
+					}//end line C if
+					else if (phase_workc==0x02)	//Line is phase B
+					{
+						jindex=1;
+					}//end line B if
+					else						//Line has to be phase A
+					{
+						jindex=0;
+					}//End line A if
+
+
+					//Indices counted out from Self admittance above.  needs doubling due to complex separation
+					for (kindex=0; kindex<2; kindex++)	//Loop through columns of admittance matrices (only 2x2)
+					{
+
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+						{
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Im());
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yfrom[jindex*3+kindex]).Im();
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+						}
+
+						if (((branch[jindexer].Yto[kindex*3+jindex]).Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+						{
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Im());
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (branch[jindexer].Yto[kindex*3+jindex]).Im();
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+						}
+
+						if (((branch[jindexer].Yfrom[jindex*3+kindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+						{
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yfrom[jindex*3+kindex]).Re());
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+						}
+
+						if (((branch[jindexer].Yto[kindex*3+jindex]).Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+						{
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex + 2;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + kindex;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + temp_size;
+							powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -((branch[jindexer].Yto[kindex*3+jindex]).Re());
+							powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+						}
+					}//secondary index end
+
+				}//end to triplexy
+			}//end triplex in here
+			else					//Some combination of not-3 phase
+			{
+				//Clear working variables, just in case
+				temp_index = temp_index_b = -1;
+				temp_size = temp_size_b = temp_size_c = -1;
+				Full_Mat_A = Full_Mat_B = false;
+
+				//Intermediate store the admittance matrices so they can be directly indexed later
+				switch(branch[jindexer].phases & 0x07) {
+					case 0x00:	//No phases (open switch or reliability excluded item)
+						{
+							temp_size_c = -99;	//Arbitrary flag
+							break;
+						}
+					case 0x01:	//C only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[8];
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[8];
+							temp_size_c = 1;
+							break;
+						}
+					case 0x02:	//B only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
+							temp_size_c = 1;
+							break;
+						}
+					case 0x03:	//BC only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[4];
+							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[5];
+							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[7];
+							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
+							
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[4];
+							Temp_Ad_B[0][1] = branch[jindexer].Yto[5];
+							Temp_Ad_B[1][0] = branch[jindexer].Yto[7];
+							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
+
+							temp_size_c = 2;
+							break;
+						}
+					case 0x04:	//A only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
+							temp_size_c = 1;
+							break;
+						}
+					case 0x05:	//AC only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
+							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[2];
+							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[6];
+							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[8];
+							
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
+							Temp_Ad_B[0][1] = branch[jindexer].Yto[2];
+							Temp_Ad_B[1][0] = branch[jindexer].Yto[6];
+							Temp_Ad_B[1][1] = branch[jindexer].Yto[8];
+
+							temp_size_c = 2;
+							break;
+						}
+					case 0x06:	//AB only
+						{
+							Temp_Ad_A[0][0] = branch[jindexer].Yfrom[0];
+							Temp_Ad_A[0][1] = branch[jindexer].Yfrom[1];
+							Temp_Ad_A[1][0] = branch[jindexer].Yfrom[3];
+							Temp_Ad_A[1][1] = branch[jindexer].Yfrom[4];
+							
+							Temp_Ad_B[0][0] = branch[jindexer].Yto[0];
+							Temp_Ad_B[0][1] = branch[jindexer].Yto[1];
+							Temp_Ad_B[1][0] = branch[jindexer].Yto[3];
+							Temp_Ad_B[1][1] = branch[jindexer].Yto[4];
+
+							temp_size_c = 2;
+							break;
+						}
+					default:
+						{
+							break;
+						}
+				}//end line switch/case
+
+				if (temp_size_c==-99)
+				{
+					continue;	//Next iteration of branch loop
+				}
+
+				if (temp_size_c==-1)	//Make sure it is right
+				{
+					GL_THROW("NR: A line's phase was flagged as not full three-phase, but wasn't: (%s) %u %u", 
+									 branch[jindexer].name, branch[jindexer].phases, branch[jindexer].origphases);
+					/*  TROUBLESHOOT
+					A line inside the powerflow model was flagged as not being full three-phase or
+					triplex in any form.  It failed the other cases though, so it must have been.
+					Please submit your code and a bug report to the trac website.
+					*/
+				}
+
+				//Check the from side and get all appropriate offsets
+				switch(bus[tempa].phases & 0x07) {
+					case 0x01:	//C
+						{
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_size = 1;		//Single size
+								temp_index = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+								/*  TROUBLESHOOT
+								One of the lines in the powerflow model has an invalid phase in
+								reference to its to and from ends.  This should have been caught
+								earlier, so submit your code and a bug report using the trac website.
+								*/
+							}
+							break;
+						}//end 0x01
+					case 0x02:	//B
+						{
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_size = 1;		//Single size
+								temp_index = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x02
+					case 0x03:	//BC
+						{
+							temp_size = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_index = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_index = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
+							{
+								temp_index = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x03
+					case 0x04:	//A
+						{
+							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_size = 1;		//Single size
+								temp_index = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x04
+					case 0x05:	//AC
+						{
+							temp_size = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_index = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+							{
+								temp_index = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x05
+					case 0x06:	//AB
+						{
+							temp_size = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_index = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							{
+								temp_index = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x06
+					case 0x07:	//ABC
+						{
+							temp_size = 3;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_index = 2;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_index = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
+							{
+								temp_index = 1;
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+							{
+								temp_index = 0;
+								Full_Mat_A = true;		//Flag so we know C needs to be gapped
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							{
+								temp_index = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x07
+					default:
+						{
+							break;
+						}
+				}//End switch/case for from
+
+				//Check the to side and get all appropriate offsets
+				switch(bus[tempb].phases & 0x07) {
+					case 0x01:	//C
+						{
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_size_b = 1;		//Single size
+								temp_index_b = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+								/*  TROUBLESHOOT
+								One of the lines in the powerflow model has an invalid phase in
+								reference to its to and from ends.  This should have been caught
+								earlier, so submit your code and a bug report using the trac website.
+								*/
+							}
+							break;
+						}//end 0x01
+					case 0x02:	//B
+						{
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_size_b = 1;		//Single size
+								temp_index_b = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x02
+					case 0x03:	//BC
+						{
+							temp_size_b = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_index_b = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_index_b = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
+							{
+								temp_index_b = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x03
+					case 0x04:	//A
+						{
+							if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_size_b = 1;		//Single size
+								temp_index_b = 0;		//No offset (only 1 big)
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x04
+					case 0x05:	//AC
+						{
+							temp_size_b = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_index_b = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index_b = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+							{
+								temp_index_b = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x05
+					case 0x06:	//AB
+						{
+							temp_size_b = 2;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_index_b = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index_b = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							{
+								temp_index_b = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x06
+					case 0x07:	//ABC
+						{
+							temp_size_b = 3;	//Size of this matrix's admittance
+							if ((branch[jindexer].phases & 0x07) == 0x01)	//C
+							{
+								temp_index_b = 2;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x02)	//B
+							{
+								temp_index_b = 1;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x03)	//BC
+							{
+								temp_index_b = 1;
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x04)	//A
+							{
+								temp_index_b = 0;		//offset
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x05)	//AC
+							{
+								temp_index_b = 0;
+								Full_Mat_B = true;		//Flag so we know C needs to be gapped
+							}
+							else if ((branch[jindexer].phases & 0x07) == 0x06)	//AB
+							{
+								temp_index_b = 0;
+							}
+							else
+							{
+								GL_THROW("NR: One of the lines has invalid phase parameters");
+							}
+							break;
+						}//end 0x07
+					default:
+						{
+							break;
+						}
+				}//End switch/case for to
 
-				//Check for error - size of zero
-				if (temp_size == 0)
+				//Make sure everything was set before proceeding
+				if ((temp_index==-1) || (temp_index_b==-1) || (temp_size==-1) || (temp_size_b==-1) || (temp_size_c==-1))
 				{
-					gl_error("solver_nr: Mesh fault impedance extract failed - invalid node");
+					GL_THROW("NR: Failure to construct single/double phase line indices");
 					/*  TROUBLESHOOT
-					While attempting to extract the mesh fault impedance value, a node with either
-					invalid phasing or no phases (already removed) was somehow flagged.  Please check
-					your file and try again.  If the error persists, please submit your code
-					and a bug report via the ticketing system.
+					A single or double phase line (e.g., just A or AB) has failed to properly initialize all of the indices
+					necessary to form the admittance matrix.  Please submit a bug report, with your code, to the trac site.
 					*/
-
-					//Flags
-					*bad_computations = true;
-					mesh_imped_vals->return_code = 0;
-
-					//Deflag the island locker, though not really needed
-					NR_solver_working = false;
-
-					//Exit
-					return 0;
-				}
-				//Default else -- okay
-
-				//Clear out the output matrix first -- assumes it is 3x3, regardless
-				for (jindex=0; jindex<9; jindex++)
-				{
-					mesh_imped_vals->z_matrix[jindex] = complex(0.0,0.0);
 				}
 
-				//Zero the double matrix - the big storage (6x6 - re & im split)
-				for (jindex=0; jindex<6; jindex++)
+				if (Full_Mat_A)	//From side is a full ABC and we have AC
 				{
-					for (kindex=0; kindex<6; kindex++)
+					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
 					{
-						temp_z_store[jindex][kindex] = 0.0;
-					}
-				}
-
-				//Overall loop - for number of phases
-				for (kindex=0; kindex<temp_size; kindex++)
-				{
-
-					//Start by zeroing the "solution" vector
-					for (temp_index_c=0;temp_index_c<m;temp_index_c++)
-					{ 
-						powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU[temp_index_c] = 0.0;
-					}
-
-					//"Identity"-ize the real part of the current index
-					powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU[tempa + kindex] = 1.0;
-
-					//Do a solution to get this entry (copied from below - includes "destructors"
-#ifdef MT
-					//superLU_MT commands
-
-					//Populate perm_c
-					get_perm_c(1, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c);
-
-					//Solve the system 
-					pdgssv(NR_superLU_procs, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c, curr_island_superLU_vars->perm_r, &L_LU, &U_LU, &curr_island_superLU_vars->B_LU, &info);
+						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
+						{
+							//Indices counted out from Self admittance above.  needs doubling due to complex separation
+							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							}
 
-					/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
-					//superLU_MT commands
-					Destroy_SuperNode_SCP(&L_LU);
-					Destroy_CompCol_NCP(&U_LU);
-#else
-					//sequential superLU
+							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							}
 
-					StatInit ( &stat );
+							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2 + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+							}
 
-					// solve the system
-					dgssv(&options, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c, curr_island_superLU_vars->perm_r, &L_LU, &U_LU, &curr_island_superLU_vars->B_LU, &stat, &info);
+							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex*2 + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+							}
+						}//column end
+					}//row end
+				}//end full ABC for from AC
 
-					/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
-					//sequential superLU commands
-					Destroy_SuperNode_Matrix( &L_LU );
-					Destroy_CompCol_Matrix( &U_LU );
-					StatFree ( &stat );
-#endif
-					//Crude superLU checks - see if it is mission accomplished or not
-					if (info != 0)	//Failed inversion, for various reasons
+				if (Full_Mat_B)	//To side is a full ABC and we have AC
+				{
+					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
 					{
-						gl_error("solver_nr: superLU failed mesh fault matrix inversion with code %d",info);
-						/*  TROUBLESHOOT
-						superLU failed to invert the equivalent impedance matrix for the mesh fault calculation
-						method.  Please try again and make sure your system is valid.  If the error persists, please
-						submit your code and a bug report via the ticketing system.
-						*/
-
-						//Flag as bad
-						*bad_computations = true;
-						mesh_imped_vals->return_code = 0;
+						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
+						{
+							//Indices counted out from Self admittance above.  needs doubling due to complex separation
+							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							}
 
-						//Deflag the island locker, though not really needed
-						NR_solver_working = false;
+							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							}
 
-						//Exit
-						return 0;
-					}
-					//Default else, must have converged!
+							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex*2 + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+							}
 
-					//Map up the solution vector
-					sol_LU = (double*) ((DNformat*) curr_island_superLU_vars->B_LU.Store)->nzval;
+							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2 + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex*2;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+							}
+						}//column end
+					}//row end
+				}//end full ABC for to AC
 
-					//Extract out this column into the temporary matrix
-					for (jindex=0; jindex<temp_size; jindex++)
+				if ((!Full_Mat_A) && (!Full_Mat_B))	//Neither is a full ABC, or we aren't doing AC, so we don't care
+				{
+					for (jindex=0; jindex<temp_size_c; jindex++)		//Loop through rows of admittance matrices				
 					{
-						temp_z_store[jindex][kindex] = sol_LU[tempa+jindex];
-					}
-				}//End "phase loop" - impedance components are ready
-
-				//Extract the values - do with a massive case/switch, just because
-				switch(bus[mesh_imped_vals->NodeRefNum].phases & 0x07) {
-					case 0x01:	//C
-						{
-							mesh_imped_vals->z_matrix[8] = complex(temp_z_store[1][0],temp_z_store[1][1]);
-							break;
-						}
-					case 0x02:	//B
-						{
-							mesh_imped_vals->z_matrix[4] = complex(temp_z_store[1][0],temp_z_store[1][1]);
-							break;
-						}
-					case 0x03:	//BC
-						{
-							//BB and BC portion
-							mesh_imped_vals->z_matrix[4] = complex(temp_z_store[2][0],temp_z_store[2][2]);
-							mesh_imped_vals->z_matrix[5] = complex(temp_z_store[2][1],temp_z_store[2][3]);
-
-							//CB and CC portion
-							mesh_imped_vals->z_matrix[7] = complex(temp_z_store[3][0],temp_z_store[3][2]);
-							mesh_imped_vals->z_matrix[8] = complex(temp_z_store[3][1],temp_z_store[3][3]);
-							break;
-						}
-					case 0x04:	//A
-						{
-							mesh_imped_vals->z_matrix[0] = complex(temp_z_store[1][0],temp_z_store[1][1]);
-							break;
-						}
-					case 0x05:	//AC
-						{
-							//AA and AC portion
-							mesh_imped_vals->z_matrix[0] = complex(temp_z_store[2][0],temp_z_store[2][2]);
-							mesh_imped_vals->z_matrix[2] = complex(temp_z_store[2][1],temp_z_store[2][3]);
-
-							//CA and CC portion
-							mesh_imped_vals->z_matrix[6] = complex(temp_z_store[3][0],temp_z_store[3][2]);
-							mesh_imped_vals->z_matrix[8] = complex(temp_z_store[3][1],temp_z_store[3][3]);
-							break;
-						}
-					case 0x06:	//AB
-						{
-							//AA and AB portion
-							mesh_imped_vals->z_matrix[0] = complex(temp_z_store[2][0],temp_z_store[2][2]);
-							mesh_imped_vals->z_matrix[1] = complex(temp_z_store[2][1],temp_z_store[2][3]);
-
-							//BA and BB portion
-							mesh_imped_vals->z_matrix[3] = complex(temp_z_store[3][0],temp_z_store[3][2]);
-							mesh_imped_vals->z_matrix[4] = complex(temp_z_store[3][1],temp_z_store[3][3]);
-							break;
-						}
-					case 0x07:	//ABC
-						{
-							//A row
-							mesh_imped_vals->z_matrix[0] = complex(temp_z_store[3][0],temp_z_store[3][3]);
-							mesh_imped_vals->z_matrix[1] = complex(temp_z_store[3][1],temp_z_store[3][4]);
-							mesh_imped_vals->z_matrix[2] = complex(temp_z_store[3][2],temp_z_store[3][5]);
-
-							//B row
-							mesh_imped_vals->z_matrix[3] = complex(temp_z_store[4][0],temp_z_store[4][3]);
-							mesh_imped_vals->z_matrix[4] = complex(temp_z_store[4][1],temp_z_store[4][4]);
-							mesh_imped_vals->z_matrix[5] = complex(temp_z_store[4][2],temp_z_store[4][5]);
-
-							//C row
-							mesh_imped_vals->z_matrix[6] = complex(temp_z_store[5][0],temp_z_store[5][3]);
-							mesh_imped_vals->z_matrix[7] = complex(temp_z_store[5][1],temp_z_store[5][4]);
-							mesh_imped_vals->z_matrix[8] = complex(temp_z_store[5][2],temp_z_store[5][5]);
-							break;
-						}
-					default:	//Not sure how we got here
+						for (kindex=0; kindex<temp_size_c; kindex++)	//Loop through columns of admittance matrices
 						{
-							gl_error("solver_nr: Mesh fault impedance extract failed - invalid node");
-							//Defined above, same message
-
-							//Flags
-							*bad_computations = true;
-							mesh_imped_vals->return_code = 0;
-
-							//Deflag the island locker, though not really needed
-							NR_solver_working = false;
-
-							//Exit
-							return 0;
-						}
-				}//end phase switch/case
-
-				//Flag as success
-				*bad_computations = false;
-				mesh_imped_vals->return_code = 1;
-
-				//Exit
-				return 1;	//Non-zero, so success (manual checks outside though)
-			}//End "just mesh impedance calculations"
-			else	//Nulled, "normal" powerflow
-			{
-#ifdef MT
-				//superLU_MT commands
-
-				//Populate perm_c
-				get_perm_c(1, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c);
+							//Indices counted out from Self admittance above.  needs doubling due to complex separation
+							if ((Temp_Ad_A[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From imags
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (Temp_Ad_A[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							}
 
-				//Solve the system
-				pdgssv(NR_superLU_procs, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c, curr_island_superLU_vars->perm_r, &L_LU, &U_LU, &curr_island_superLU_vars->B_LU, &powerflow_values->island_matrix_values[island_loop_index].solver_info);
-#else
-				//sequential superLU
+							if ((Temp_Ad_B[jindex][kindex].Im() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To imags
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Im());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = Temp_Ad_B[jindex][kindex].Im();
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+							}
 
-				StatInit ( &stat );
+							if ((Temp_Ad_A[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//From reals
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempa].Matrix_Loc + temp_index + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + kindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_A[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+							}
 
-				// solve the system
-				dgssv(&options, &curr_island_superLU_vars->A_LU, curr_island_superLU_vars->perm_c, curr_island_superLU_vars->perm_r, &L_LU, &U_LU, &curr_island_superLU_vars->B_LU, &stat, &powerflow_values->island_matrix_values[island_loop_index].solver_info);
-#endif
+							if ((Temp_Ad_B[jindex][kindex].Re() != 0) && (bus[tempa].type != 1) && (bus[tempb].type != 1))	//To reals
+							{
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex + temp_size_b;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+								
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*bus[tempb].Matrix_Loc + temp_index_b + jindex;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*bus[tempa].Matrix_Loc + temp_index + kindex + temp_size;
+								powerflow_values->island_matrix_values[island_index_val].Y_offdiag_PQ[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(Temp_Ad_B[jindex][kindex].Re());
+								powerflow_values->island_matrix_values[island_index_val].indexer += 1;	
+							}
+						}//column end
+					}//row end
+				}//end not full ABC with AC on either side case
+			}//end all others else
+		}//end branch for
 
-				sol_LU = (double*) ((DNformat*) curr_island_superLU_vars->B_LU.Store)->nzval;
-			}
+		//Loop through the islands
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+		{
+			//Build the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix. This part will not be updated at each iteration. 
+			powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed = 0;
 		}
-		else if (matrix_solver_method==MM_EXTERN)
+
+		for (jindexer=0; jindexer<bus_count;jindexer++) 
 		{
-			//General error check right now -- mesh fault current may not work properly
-			if (mesh_imped_vals != NULL)
+			if (bus[jindexer].island_number != -1)
 			{
-				gl_error("solver_nr: Mesh impedance attempted from unsupported LU solver");
-				/* TROUBLESHOOT
-				The mesh fault current impedance "pull" was selected, but for the external LU
-				solver.  This is unsupported at this time.  To use the mesh fault current capabilities,
-				please use the superLU solver.
-				*/
-
-				//Set return code
-				mesh_imped_vals->return_code = 2;
-
-				//Perform the clean up - external LU destructor routing
-				((void (*)(void *, bool))(LUSolverFcns.ext_destroy))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,powerflow_values->island_matrix_values[island_loop_index].new_iteration_required);
-
-				//Flag bad computations, just because
-				*bad_computations = true;
-
-				//Deflag us, even though that may be moot here
-				NR_solver_working = false;
+				//Pull the index
+				island_loop_index = bus[jindexer].island_number;
 
-				//Exit
-				return 0;
+				//Loop through and get sizes
+				for (jindex=0; jindex<3; jindex++)
+				{
+					for (kindex=0; kindex<3; kindex++)
+					{		 
+						if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)  
+							powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed += 1; 
+						if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex) 
+							powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed += 1; 
+					}
+				}
 			}
-			//Default else -- not mesh fault mode, so go like normal
-
-			//Call the solver
-			powerflow_values->island_matrix_values[island_loop_index].solver_info = ((int (*)(void *,NR_SOLVER_VARS *, unsigned int, unsigned int))(LUSolverFcns.ext_solve))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,&powerflow_values->island_matrix_values[island_loop_index].matrices_LU,n,1);
-
-			//Point the solution to the proper place
-			sol_LU = powerflow_values->island_matrix_values[island_loop_index].matrices_LU.rhs_LU;
-		}
-		else
-		{
-			GL_THROW("Invalid matrix solution method specified for NR solver!");
-			/*  TROUBLESHOOT
-			An invalid matrix solution method was selected for the Newton-Raphson solver method.
-			Valid options are the superLU solver or an external solver.  Please select one of these methods.
-			*/
+			//Default else -- nota  valid island anyways
 		}
 
-		//Update bus voltages - check convergence while we're here
-		powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge = 0;
-
-		temp_index = -1;
-		temp_index_b = -1;
-		powerflow_values->island_matrix_values[island_loop_index].new_iteration_required = false;	//Reset iteration requester flag - defaults to not needing another
-
-		for (indexer=0; indexer<bus_count; indexer++)
+		//Loop through the islands again
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
 		{
-			//See if we're part of the relevant island
-			if (bus[indexer].island_number == island_loop_index)
+			if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed == NULL)
 			{
-				//Avoid swing bus updates on normal runs
-				if ((bus[indexer].type == 0) || ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == false)))
-				{
-					//Figure out the offset we need to be for each phase
-					if ((bus[indexer].phases & 0x80) == 0x80)	//Split phase
-					{
-						//Pull the two updates (assume split-phase is always 2)
-						DVConvCheck[0]=complex(sol_LU[2*bus[indexer].Matrix_Loc],sol_LU[(2*bus[indexer].Matrix_Loc+2)]);
-						DVConvCheck[1]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+1)],sol_LU[(2*bus[indexer].Matrix_Loc+3)]);
-						bus[indexer].V[0] += DVConvCheck[0];
-						bus[indexer].V[1] += DVConvCheck[1];	//Negative due to convention
-						
-						//Pull off the magnitude (no sense calculating it twice)
-						CurrConvVal=DVConvCheck[0].Mag();
-						if (CurrConvVal > powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge)	//Update our convergence check if it is bigger
-							powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge=CurrConvVal;
-
-						if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
-							powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;								//Flag that a new iteration must occur
-
-						CurrConvVal=DVConvCheck[1].Mag();
-						if (CurrConvVal > powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge)	//Update our convergence check if it is bigger
-							powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge=CurrConvVal;
-
-						if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
-							powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;								//Flag that a new iteration must occur
-					}//end split phase update
-					else										//Not split phase
-					{
-						for (jindex=0; jindex<powerflow_values->BA_diag[indexer].size; jindex++)	//parse through the phases
-						{
-							switch(bus[indexer].phases & 0x07) {
-								case 0x01:	//C
-									{
-										temp_index=0;
-										temp_index_b=2;
-										break;
-									}
-								case 0x02:	//B
-									{
-										temp_index=0;
-										temp_index_b=1;
-										break;
-									}
-								case 0x03:	//BC
-									{
-										if (jindex==0)	//B
-										{
-											temp_index=0;
-											temp_index_b=1;
-										}
-										else			//C
-										{
-											temp_index=1;
-											temp_index_b=2;
-										}
+				powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2) *sizeof(Y_NR));   //powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed store the row,column and value of the fixed part of the diagonal PQ bus elements of 6n*6n Y_NR matrix.
 
-										break;
-									}
-								case 0x04:	//A
-									{
-										temp_index=0;
-										temp_index_b=0;
-										break;
-									}
-								case 0x05:	//AC
-									{
-										if (jindex==0)	//A
-										{
-											temp_index=0;
-											temp_index_b=0;
-										}
-										else			//C
-										{
-											temp_index=1;
-											temp_index_b=2;
-										}
-										break;
-									}
-								case 0x06:	//AB
-								case 0x07:	//ABC
-									{
-										temp_index = jindex;
-										temp_index_b = jindex;
-										break;
-									}
-							}//end phase switch/case
+				//Make sure it worked
+				if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-							if ((temp_index==-1) || (temp_index_b==-1))
-							{
-								GL_THROW("NR: An error occurred indexing voltage updates");
-								/*  TROUBLESHOOT
-								While attempting to create the voltage update indices for the
-								Newton-Raphson solver, an error was encountered.  Please submit
-								your code and a bug report using the trac website.
-								*/
-							}
+				//Update the max size
+				powerflow_values->island_matrix_values[island_loop_index].max_size_diag_fixed = powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed;
+			}
+			else if (powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed > powerflow_values->island_matrix_values[island_loop_index].max_size_diag_fixed)		//Something changed and we are bigger!!
+			{
+				//Destroy us!
+				gl_free(powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed);
 
-							DVConvCheck[jindex]=complex(sol_LU[(2*bus[indexer].Matrix_Loc+temp_index)],sol_LU[(2*bus[indexer].Matrix_Loc+powerflow_values->BA_diag[indexer].size+temp_index)]);
-							bus[indexer].V[temp_index_b] += DVConvCheck[jindex];
-							
-							//Pull off the magnitude (no sense calculating it twice)
-							CurrConvVal=DVConvCheck[jindex].Mag();
-							if (CurrConvVal > bus[indexer].max_volt_error)	//Check for convergence
-								powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;								//Flag that a new iteration must occur
+				//Rebuild us, we have the technology
+				powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed = (Y_NR *)gl_malloc((powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed*2) *sizeof(Y_NR));
 
-							if (CurrConvVal > powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge)	//See if the current differential is the largest found so far or not
-								powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge = CurrConvVal;	//It is, store it
+				//Make sure it worked
+				if (powerflow_values->island_matrix_values[island_loop_index].Y_diag_fixed == NULL)
+					GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
 
-						}//End For loop for phase traversion
-					}//End not split phase update
-				}//end if not swing
-				//Default else -- this must be the swing and in a valid interval
+				//Store the new size
+				powerflow_values->island_matrix_values[island_loop_index].max_size_diag_fixed = powerflow_values->island_matrix_values[island_loop_index].size_diag_fixed;
 
-				//See if this particular bus has any "current injection update" requirements - semi-silly to do this for SWING-enabled buses, but makes the code more consistent
-				if ((bus[indexer].ExtraCurrentInjFunc != NULL) && ((bus[indexer].type == 0) || ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == false))))
-				{
-					//Call the function
-					call_return_status = ((STATUS (*)(OBJECT *))(*bus[indexer].ExtraCurrentInjFunc))(bus[indexer].ExtraCurrentInjFuncObject);
+				//Flag for a reallocation
+				powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = true;
+			}
 
-					//Make sure it worked
-					if (call_return_status == FAILED)
-					{
-						GL_THROW("External current injection update failed for device %s",bus[indexer].ExtraCurrentInjFuncObject->name ? bus[indexer].ExtraCurrentInjFuncObject->name : "Unnamed");
-						/*  TROUBLESHOOT
-						While attempting to perform the external current injection update function call, something failed.  Please try again.
-						If the error persists, please submit your code and a bug report via the ticketing system.
-						*/
-					}
-					//Default else - it worked
-				}
-			}//End "in the island"
-			//Default else - not in the island, skip it
-		}//End bus traversion
+			//Zero the accumulator for the next section, while we're in here
+			powerflow_values->island_matrix_values[island_loop_index].indexer = 0;
+		}//End island loop routine
 
-		//Perform saturation current update/convergence check
-		//******************** FIGURE OUT HOW TO DO THIS BETTER - This is very inefficient!***********************//
-		if ((enable_inrush_calculations == true) && (deltatimestep_running > 0))	//Don't even both with this if inrush not on
-		{
-			//Start out assuming the convergence is true (reiter is false)
-			powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent = false;
+		for (jindexer=0; jindexer<bus_count;jindexer++)	//Parse through bus list
+		{ 
+			//Extract our island reference
+			island_index_val = bus[jindexer].island_number;
 
-			//Loop through all branches -- inefficient, but meh
-			for (indexer=0; indexer<branch_count; indexer++)
+			//If we're unallocated, just skip us
+			if (island_index_val == -1)
 			{
-				//See if this branch is associated with this island
-				if (branch[indexer].island_number == island_loop_index)
-				{
-					//See if the function exists
-					if (branch[indexer].ExtraDeltaModeFunc != NULL)
-					{
-						//Call the function
-						func_result_val = ((int (*)(OBJECT *,bool *))(*branch[indexer].ExtraDeltaModeFunc))(branch[indexer].obj,&(powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent));
-
-						//Make sure it worked
-						if (func_result_val != 1)
-						{
-							GL_THROW("Extra delta update failed for device %s",branch[indexer].name ? branch[indexer].name : "Unnamed");
-							/*  TROUBLESHOOT
-							While attempting to perform the extra deltamode update, something failed.  Please try again.
-							If the error persists, please submit your code and a bug report via the ticketing system.
-							*/
-						}
-						//Default else -- it worked, keep going
-					}
-					//Default else - is NULL
-				}
-				//Default else -- not part of this island, so don't mess with it
-			}//End inefficient branch traversion
-		}//End in-rush and deltamode running
+				continue;
+			}
+			//Default else -- proceed
 
-		//Additional checks for special modes - only needs to happen in first dynamics powerflow
-		if (powerflow_type == PF_DYNINIT)
-		{
-			//See what "mode" we're in
-			if (powerflow_values->island_matrix_values[island_loop_index].new_iteration_required == false)	//Overall powerflow has converged
+			for (jindex=0; jindex<powerflow_values->BA_diag[jindexer].size; jindex++)
 			{
-				if (powerflow_values->island_matrix_values[island_loop_index].swing_converged == false)	//See if deltaI_sym is being met
-				{
-					//See which message to print
-					if (NR_islands_detected > 1)
-					{
-						//Give a verbose message, just cause
-						gl_verbose("NR_Solver: swing bus failed balancing criteria on island %d - making it a PQ for future dynamics",(island_loop_index+1));
-					}
-					else	//Single system
+				for (kindex=0; kindex<powerflow_values->BA_diag[jindexer].size; kindex++)
+				{					
+					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
 					{
-						//Give a verbose message, just cause
-						gl_verbose("NR_Solver: swing bus failed balancing criteria - making it a PQ for future dynamics");
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
+						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = -(powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Im();
+						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
 					}
 
-					//See if we're still swing_is_a_swing mode
-					if (powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing == true)
+					if ((powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re() != 0 && bus[jindexer].type != 1 && jindex!=kindex)
 					{
-						//Deflag us
-						powerflow_values->island_matrix_values[island_loop_index].swing_is_a_swing = false;
-
-						//Loop through and deflag appropriate swing buses
-						for (indexer=0; indexer<bus_count; indexer++)
-						{
-							//See if we're in the "island of interest"
-							if (bus[indexer].island_number == island_loop_index)
-							{
-								//See if we're a swing-flagged bus
-								if ((bus[indexer].type > 1) && (bus[indexer].swing_functions_enabled == true))
-								{
-									//See if we're "generator ready"
-									if ((*bus[indexer].dynamics_enabled==true) && (bus[indexer].DynCurrent != NULL))
-									{
-										//Deflag us back to "PQ" status
-										bus[indexer].swing_functions_enabled = false;
-
-										//Force a reiteration
-										powerflow_values->island_matrix_values[island_loop_index].new_iteration_required=true;
-									}
-								}
-								//Default else -- normal bus
-							}//End Island check
-							//Default else -- not in the current relevant island
-						}//End bus traversion loop
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
+						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
+						
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].row_ind = 2*powerflow_values->BA_diag[jindexer].row_ind + jindex +powerflow_values->BA_diag[jindexer].size;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].col_ind = 2*powerflow_values->BA_diag[jindexer].col_ind + kindex;
+						powerflow_values->island_matrix_values[island_index_val].Y_diag_fixed[powerflow_values->island_matrix_values[island_index_val].indexer].Y_value = (powerflow_values->BA_diag[jindexer].Y[jindex][kindex]).Re();
+						powerflow_values->island_matrix_values[island_index_val].indexer += 1;
 					}
-					//Default else - if we're out of symmetry bounds, but already hit close, good enough
 				}
-				//Defaulted else - we're converged on all fronts, huzzah!
 			}
-			//Default else - still need to iterate
-		}//End special convergence criterion
+		}//End bus parse for fixed diagonal
+	}//End admittance update
 
-		//Check Saturation mismatch 
-		if (powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent == true)
-		{
-			//Force a reiter
-			powerflow_values->island_matrix_values[island_loop_index].new_iteration_required = true;
-		}
-		//Default else -- either no saturation, or it has converged - leave it be
+	//Loop through each island to reset these flags
+	for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
+	{
+		//Reset saturation checks
+		powerflow_values->island_matrix_values[island_loop_index].SaturationMismatchPresent = false;
+
+		//Reset the iteration counters
+		powerflow_values->island_matrix_values[island_loop_index].iteration_count = 0;
+	}
 
-		//Turn off reallocation flag no matter what
-		powerflow_values->island_matrix_values[island_loop_index].NR_realloc_needed = false;
+	//Solve the islands - each one is iterated to completion, concurrently if there are threads for it
+	island_thread_count = solver_nr_island_threadcount(mesh_imped_vals);
 
-		if (matrix_solver_method==MM_SUPERLU)
-		{
-			/* De-allocate storage - superLU matrix types must be destroyed at every iteration, otherwise they balloon fast (65 MB norma becomes 1.5 GB) */
-#ifdef MT
-			//superLU_MT commands
-			Destroy_SuperNode_SCP(&L_LU);
-			Destroy_CompCol_NCP(&U_LU);
-#else
-			//sequential superLU commands
-			Destroy_SuperNode_Matrix( &L_LU );
-			Destroy_CompCol_Matrix( &U_LU );
-			StatFree ( &stat );
-#endif
-		}
-		else if (matrix_solver_method==MM_EXTERN)
-		{
-			//Call destruction routine
-			((void (*)(void *, bool))(LUSolverFcns.ext_destroy))(powerflow_values->island_matrix_values[island_loop_index].LU_solver_vars,powerflow_values->island_matrix_values[island_loop_index].new_iteration_required);
-		}
-		else	//Not sure how we get here
+	if (island_thread_count > 1)
+	{
+		//Set up the job
+		island_job.bus_count = bus_count;
+		island_job.bus = bus;
+		island_job.branch_count = branch_count;
+		island_job.branch = branch;
+		island_job.powerflow_values = powerflow_values;
+		island_job.powerflow_type = powerflow_type;
+		island_job.bad_computations = bad_computations;
+		island_job.thread_count = island_thread_count;
+		island_job.next_island = 0;
+		island_job.failed_island = -1;
+		island_job.island_state = (NR_ISLAND_STATE *)gl_malloc(NR_islands_detected*sizeof(NR_ISLAND_STATE));
+
+		//Make sure it worked
+		if (island_job.island_state == NULL)
+			GL_THROW("NR: Failed to allocate memory for one of the necessary matrices");
+
+		solver_nr_islands_concurrent(&island_job);
+
+		//Pass along any island failure
+		if (island_job.failed_island >= 0)
 		{
-			GL_THROW("Invalid matrix solution method specified for NR solver!");
-			//Defined above
-		}
+			gl_free(island_job.island_state);
 
-		//Final check -- see if the info result wasn't zero -- if so, deflag us no matter what here
-		if (powerflow_values->island_matrix_values[island_loop_index].solver_info != 0)
-		{
-			powerflow_values->island_matrix_values[island_loop_index].new_iteration_required = false;
+			GL_THROW("%s",island_job.failed_msg);
+			//Defined where it was thrown
 		}
 
-		//Set the flag to not continue -- all should be handled below, this is just logic paranoia
-		proceed_to_next_island = false;
-
-		//Determine how we got here and what the next steps are
-		if (powerflow_values->island_matrix_values[island_loop_index].new_iteration_required == true)	//We think we need a new one
+		//Report in island order, so the output doesn't depend on which island finished first
+		for (island_loop_index=0; island_loop_index<NR_islands_detected; island_loop_index++)
 		{
-			//Make sure we still can iterate - if we hit the iteration limit, we can't
-			if (powerflow_values->island_matrix_values[island_loop_index].iteration_count>=NR_iteration_limit)
-			{
-				powerflow_values->island_matrix_values[island_loop_index].return_code = -(powerflow_values->island_matrix_values[island_loop_index].iteration_count);
-	
-				if (NR_islands_detected > 1)
-				{
-					gl_verbose("Max solver mismatch of failed solution %f on island %d\n",powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge,(island_loop_index+1));
-				}
-				else
-				{
-					gl_verbose("Max solver mismatch of failed solution %f\n",powerflow_values->island_matrix_values[island_loop_index].max_mismatch_converge);
-				}
+			solver_nr_island_report(powerflow_values,island_loop_index,island_job.island_state[island_loop_index]);
+		}
 
-				//We got here, we're done with this island
-				proceed_to_next_island = true;
-			}
-			else	//Normal iteration procedure - update the counter
-			{
-				powerflow_values->island_matrix_values[island_loop_index].iteration_count++;
+		gl_free(island_job.island_state);
+	}
+	else	//One island at a time
+	{
+		island_loop_index = 0;
 
-				//Set the overall progression flag
-				proceed_to_next_island = false;
-			}
-		}
-		else	//Should be done
+		while (island_loop_index < NR_islands_detected)
 		{
-			//All paths lead to the next island/completion
-			proceed_to_next_island = true;
+			island_state = solver_nr_island_pass(bus_count,bus,branch_count,branch,powerflow_values,powerflow_type,mesh_imped_vals,bad_computations,island_loop_index,&return_value_for_solver_NR);
 
-			//Report how we think we're done
-			if (powerflow_values->island_matrix_values[island_loop_index].solver_info == 0)	//It was a convergence exit
+			if (island_state == NR_ISLAND_EXIT)	//Mesh fault impedance calculations are done
 			{
-				//See if we're multi-islanded or not
-				if (NR_islands_detected > 1)
-				{
-					gl_verbose("Power flow calculation for island %d converges at Iteration %d \n",(island_loop_index+1),(powerflow_values->island_matrix_values[island_loop_index].iteration_count+1));
-				}
-				else	//Singular
-				{
-					gl_verbose("Power flow calculation converges at Iteration %d \n",(powerflow_values->island_matrix_values[island_loop_index].iteration_count+1));
-				}
+				//Deflag the island locker
+				NR_solver_working = false;
 
-				//Store the value as the return code
-				powerflow_values->island_matrix_values[island_loop_index].return_code = powerflow_values->island_matrix_values[island_loop_index].iteration_count;
+				return return_value_for_solver_NR;
 			}
-			else
+			else if (island_state != NR_ISLAND_ITERATE)	//Island is done, onwards
 			{
-				//Write out the "failure"
-
-				//See which version to write
-				if (NR_islands_detected > 1)
-				{
-					//For superLU - 2 = singular matrix it appears - positive values = process errors (singular, etc), negative values = input argument/syntax error
-					if (matrix_solver_method==MM_SUPERLU)
-					{
-						gl_verbose("superLU failed out of island %d with return value %d",(island_loop_index+1),powerflow_values->island_matrix_values[island_loop_index].solver_info);
-					}
-					else if (matrix_solver_method==MM_EXTERN)
-					{
-						gl_verbose("External LU solver failed out of island %d with return value %d",(island_loop_index+1),powerflow_values->island_matrix_values[island_loop_index].solver_info);
-					}
-					//Defaulted else - shouldn't exist (or make it this far), but if it does, we're failing anyways
-				}
-				else	//Singular
-				{
-					//For superLU - 2 = singular matrix it appears - positive values = process errors (singular, etc), negative values = input argument/syntax error
-					if (matrix_solver_method==MM_SUPERLU)
-					{
-						gl_verbose("superLU failed out with return value %d",powerflow_values->island_matrix_values[island_loop_index].solver_info);
-					}
-					else if (matrix_solver_method==MM_EXTERN)
-					{
-						gl_verbose("External LU solver failed out with return value %d",powerflow_values->island_matrix_values[island_loop_index].solver_info);
-					}
-					//Defaulted else - shouldn't exist (or make it this far), but if it does, we're failing anyways
-				}
+				solver_nr_island_report(powerflow_values,island_loop_index,island_state);
 
-				//Store the return value as the failure
-				powerflow_values->island_matrix_values[island_loop_index].return_code = 0;
-			}
-		}
-
-		//Overall progression flag
-		if (proceed_to_next_island == true)
-		{
-			//See if we need to continue
-			if (island_loop_index >= (NR_islands_detected - 1))	//We're the last one
-			{
-				//Set the flag to be done
-				still_iterating_islands = false;
-			}
-			else	//Not last -- increment the counter and onwards
-			{
-				//Increment the counter
 				island_loop_index++;
-
-				//Force the flag, just to be paranoid
-				still_iterating_islands = true;
 			}
+			//Default else - iterate this island again
 		}
-	}//End iteration still needed while - indexed on island_loop_index
+	}
 
 	//Figure out the exit return values -- make them "worst case", so if all failed, return "bad_computations"
 	//If at least one passes, just return the max iteration count
@@ -5815,12 +6220,19 @@ STATUS NR_array_structure_free(NR_SOLVER_STRUCT *struct_of_interest,int number_o
 				if (curr_island_superLU_vars->perm_r != NULL)
 					gl_free(curr_island_superLU_vars->perm_r);
 
+				superLU_ordering_clear(curr_island_superLU_vars);
+
 				//Null the pointer again, just because
 				curr_island_superLU_vars = NULL;
 
 				//Free the value
 				gl_free(struct_of_interest->island_matrix_values[index_val].LU_solver_vars);
 			}
+			else if (matrix_solver_method == MM_KLU)
+			{
+				//Built-in solver keeps its factorization between iterations, so free it all here
+				KLU_NR_free(struct_of_interest->island_matrix_values[index_val].LU_solver_vars);
+			}
 			else if (matrix_solver_method == MM_EXTERN)
 			{
 				//Call destruction routine
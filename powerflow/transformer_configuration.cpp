@@ -40,7 +40,7 @@ transformer_configuration::transformer_configuration(MODULE *mod) : powerflow_li
 {
 	if(oclass == NULL)
 	{
-		oclass = gl_register_class(mod,"transformer_configuration",sizeof(transformer_configuration),NULL);
+		oclass = gl_register_class(mod,"transformer_configuration",sizeof(transformer_configuration),PC_PARALLEL_INIT);
 		if (oclass==NULL)
 			throw "unable to register class transformer_configuration";
 		else
@@ -324,6 +324,11 @@ void triplex_line::recalc(void)
 			GL_THROW("Only NR and FBS support z-matrix components.");
 
 	}
+	else if (load_cached_impedance(b_mat, NULL, tn) == true)
+	{
+		//Another line with this configuration already computed the impedance - it comes back scaled to this line's length
+		equalm(b_mat,B_mat);
+	}
 	else
 	{
 		// create local variables that will be used to calculate matrices.
@@ -424,8 +429,11 @@ void triplex_line::recalc(void)
 		tn[1] = -zp23/zp33;
 		tn[2] = 0;
 
-		multiply(length/5280.0,zs,b_mat); // Length comes in ft, convert to miles.
-		multiply(length/5280.0,zs,B_mat);
+		//Share the per-mile values with the other lines using this configuration, and scale them for this one
+		save_cached_impedance(zs, NULL, tn);
+
+		equalm(zs,b_mat);
+		equalm(zs,B_mat);
 	}
 	
 	//Check for negative resistance in the line's impedance matrix
@@ -331,7 +331,7 @@ void underground_line::recalc(void)
 			A_mat[2][2] = 1.0;
 		}
 	}
-	else
+	else if (load_cached_impedance(Zabc_mat, Yabc_mat) == false)
 	{
 		double dia_od1, dia_od2, dia_od3;
 		int16 strands_4, strands_5, strands_6;
@@ -342,7 +342,7 @@ void underground_line::recalc(void)
 		complex cap_freq_coeff;
 		complex z[7][7],z_ts[3][3]; //, z_ij[3][3], z_in[3][3], z_nj[3][3], z_nn[3][3], z_abc[3][3];
 		double freq_coeff_real, freq_coeff_imag, freq_additive_term;
-		double miles = length / 5280.0;
+		double miles = 1.0;	//Values are computed per mile, then scaled by the length when cached
 
 		complex test;///////////////
 
@@ -1105,6 +1105,9 @@ void underground_line::recalc(void)
 				A_mat[2][2] = 1.0;
 			}
 		}
+
+		//Share the per-mile values with the other lines using this configuration, and scale them for this one
+		save_cached_impedance(Zabc_mat, Yabc_mat);
 	}
 
 	// Calculate line matrixies A_mat, B_mat, a_mat, b_mat, c_mat and d_mat based on Zabc_mat and Yabc_mat
@@ -23,7 +23,7 @@ underground_line_conductor::underground_line_conductor(MODULE *mod) : powerflow_
 {
 	if(oclass == NULL)
 	{
-		oclass = gl_register_class(mod,"underground_line_conductor",sizeof(underground_line_conductor),0x00);
+		oclass = gl_register_class(mod,"underground_line_conductor",sizeof(underground_line_conductor),PC_PARALLEL_INIT);
 		if (oclass==NULL)
 			throw "unable to register class underground_line_conductor";
 		else
@@ -156,6 +156,7 @@ double house_e::warn_low_temp = 55; // degF
 double house_e::warn_high_temp = 95; // degF
 bool house_e::warn_control = true;
 double house_e::system_dwell_time = 1; // seconds
+etp_batch house_e::thermal_solver;
 
 /** House object constructor:  Registers the class and publishes the variables that can be set by the user. 
 Sets default randomized values for published variables.
@@ -166,7 +167,8 @@ house_e::house_e(MODULE *mod) : residential_enduse(mod)
 	if (oclass==NULL)  
 	{
 		// register the class definition
-		oclass = gl_register_class(mod,"house",sizeof(house_e),PC_PRETOPDOWN|PC_BOTTOMUP|PC_POSTTOPDOWN|PC_AUTOLOCK);
+		// init only writes to the house, its parent meter (under lock) and its rank (see init_climate)
+		oclass = gl_register_class(mod,"house",sizeof(house_e),PC_PRETOPDOWN|PC_BOTTOMUP|PC_POSTTOPDOWN|PC_AUTOLOCK|PC_PARALLEL_INIT);
 		if (oclass==NULL)
 			throw "unable to register class house";
 		else
@@ -518,6 +520,8 @@ int house_e::create()
 	gl_global_getvar("residential::implicit_enduses",active_enduses,sizeof(active_enduses));
 	char *token = NULL;
 	error_flag = 0;
+	thermal_index = thermal_solver.add();
+	thermal_event = TE_NONE;
 
 	//glazing_shgc = 0.65; // assuming generic double glazing
 	// now zero to catch lookup trigger
@@ -779,7 +783,18 @@ int house_e::init_climate()
 	int not_found = 0;
 	if (climates==NULL && not_found==0) 
 	{
-		climates = gl_find_objects(FL_NEW,FT_CLASS,SAME,"climate",FT_END);
+		// the search is the same for every house, so it is done once (houses may be initialized concurrently)
+		static FINDLIST *all_climates = NULL;
+		static bool all_climates_found = false;
+		static unsigned int all_climates_lock = 0;
+		WRITELOCK(&all_climates_lock);
+		if (!all_climates_found)
+		{
+			all_climates = gl_find_objects(FL_NEW,FT_CLASS,SAME,"climate",FT_END);
+			all_climates_found = true;
+		}
+		WRITEUNLOCK(&all_climates_lock);
+		climates = all_climates;
 		if (climates==NULL)
 		{
 			not_found = 1;
@@ -1270,7 +1285,6 @@ and internal gain variables.
 int house_e::init(OBJECT *parent)
 {
 	gld_property *meter_house_present;
-	gld_wlock *test_rlock;
 	bool temp_bool_val;
 
 	if(parent != NULL){
@@ -1304,9 +1318,12 @@ int house_e::init(OBJECT *parent)
 			return 0;
 		}
 
-		//Set the value
+		//Set the value -- under the meter's lock, since houses sharing a meter may be initialized concurrently
 		temp_bool_val = true;
-		meter_house_present->setp<bool>(temp_bool_val,*test_rlock);
+		{
+			gld_wlock meter_lock(parent);
+			meter_house_present->setp<bool>(temp_bool_val,meter_lock);
+		}
 
 		//Remove the temp property
 		delete meter_house_present;
@@ -1736,7 +1753,10 @@ int house_e::init(OBJECT *parent)
 		}
 		else
 		{
+			static unsigned int res_object_count_lock = 0;
+			WRITELOCK(&res_object_count_lock);
 			res_object_count++;	//Increment the counter
+			WRITEUNLOCK(&res_object_count_lock);
 		}
 	}//End deltamode inclusive
 	else	//Not enabled for this model
@@ -2583,8 +2603,10 @@ TIMESTAMP house_e::sync(TIMESTAMP t0, TIMESTAMP t1)
 	// determine temperature of next event
 	update_Tevent();
 
-	/* solve for the time to the next event */
-	double dt2;
+	/* find how to get the time to the next event -- the ETP equation is 
+		solved at the end of this rank together with those of all the other houses
+	 */
+	thermal_event = TE_KNOWN;
 	
 	/* dt2 is for the next thermal event ... avoid calculating the next time to a given
 		temperature until the cycle time has elapse.
@@ -2593,38 +2615,63 @@ TIMESTAMP house_e::sync(TIMESTAMP t0, TIMESTAMP t1)
 		if(thermostat_off_cycle_time == -1 && thermostat_on_cycle_time == -1){
 			// this is always false if thermostat_cycle_time == 0
 			if(t < thermostat_last_cycle_time + thermostat_cycle_time){
-				dt2 = (double)(thermostat_last_cycle_time + thermostat_cycle_time);
+				thermal_event_dt = (double)(thermostat_last_cycle_time + thermostat_cycle_time);
 			} else {
-				dt2 = e2solve(k1,r1,k2,r2,Teq-Tevent)*3600.0;
+				thermal_event = TE_SOLVE;
 			}
 		} else if(thermostat_off_cycle_time >= 0 && thermostat_on_cycle_time >= 0){
 			if(thermostat_last_off_cycle_time > thermostat_last_on_cycle_time){
 				if(t < thermostat_last_off_cycle_time + thermostat_off_cycle_time){
-					dt2 = (double)(thermostat_last_off_cycle_time + thermostat_off_cycle_time);
+					thermal_event_dt = (double)(thermostat_last_off_cycle_time + thermostat_off_cycle_time);
 				} else {
-					dt2 = e2solve(k1,r1,k2,r2,Teq-Tevent)*3600;
+					thermal_event = TE_SOLVE;
 				}
 			} else if(thermostat_last_off_cycle_time < thermostat_last_on_cycle_time){
 				if(t < thermostat_last_on_cycle_time + thermostat_on_cycle_time){
-					dt2 = (double)(thermostat_last_on_cycle_time + thermostat_on_cycle_time);
+					thermal_event_dt = (double)(thermostat_last_on_cycle_time + thermostat_on_cycle_time);
 				} else {
-					dt2 = e2solve(k1,r1,k2,r2,Teq-Tevent)*3600;
+					thermal_event = TE_SOLVE;
 				}
 			} else {
 				if(t < thermostat_last_cycle_time + thermostat_cycle_time){
-					dt2 = (double)(thermostat_last_cycle_time + thermostat_cycle_time);
+					thermal_event_dt = (double)(thermostat_last_cycle_time + thermostat_cycle_time);
 				} else {
-					dt2 = e2solve(k1,r1,k2,r2,Teq-Tevent)*3600;
+					thermal_event = TE_SOLVE;
 				}
 			}
 		} else {
 			gl_error("Both the thermostat_off_cycle_time and the thermostat_on_cycle_time must be greater than zero.");
+			thermal_event = TE_NONE;
 			return TS_INVALID;
 		}
 	} else {
-		dt2 = TS_NEVER;
+		thermal_event_dt = TS_NEVER;
 	}
 
+	// a soft event from the enduses or panel always comes before the thermal event, so it won't matter
+	if (t2<0)
+		thermal_event = TE_NONE;
+	else if (thermal_event==TE_SOLVE)
+		thermal_solver.set(thermal_index,k1,r1,k2,r2,Teq-Tevent);
+
+#ifdef _DEBUG
+	char tbuf[64];
+	gl_printtime(t2, tbuf, 64);
+//		gl_debug("house %s (%d) next event at '%s'", obj->name, obj->id, tbuf);
+#endif
+
+	//Update the off-return value
+	return enforce_dwell_time(t2);
+}
+
+/** Determines the time of the next thermal event given the time to it (in seconds)
+	@returns the earlier of the thermal event and \p t2
+ **/
+TIMESTAMP house_e::next_thermal_event(TIMESTAMP t1, double dt2, TIMESTAMP t2)
+{
+	OBJECT *obj = OBJECTHDR(this);
+	TIMESTAMP t;
+
 	// if no solution is found or it has already occurred
 	if (isnan(dt2) || !isfinite(dt2) || dt2<0)
 	{
@@ -2650,21 +2697,19 @@ TIMESTAMP house_e::sync(TIMESTAMP t0, TIMESTAMP t1)
 //		gl_debug("house %s (%d) time to next event is %.2f hrs", obj->name, obj->id, dt2/3600);
 #endif
 	}
+	return t2;
+}
 
-#ifdef _DEBUG
-	char tbuf[64];
-	gl_printtime(t2, tbuf, 64);
-//		gl_debug("house %s (%d) next event at '%s'", obj->name, obj->id, tbuf);
-#endif
-
+/** Rounds an event time up to the system dwell time, making hard events soft (and soft events hard)
+ **/
+TIMESTAMP house_e::enforce_dwell_time(TIMESTAMP t2)
+{
 	// enforce dwell time
 	if (t2!=TS_NEVER)
 	{
 		TIMESTAMP t = (TIMESTAMP)(ceil((t2<0 ? -t2 : t2)/system_dwell_time)*system_dwell_time);
 		t2 = (t2<0 ? t : -t);
 	}
-	//gl_output("glsovers returns %f.",dt2);
-	//Update the off-return value
 	return t2;
 }
 
@@ -2697,6 +2742,15 @@ TIMESTAMP house_e::postsync(TIMESTAMP t0, TIMESTAMP t1)
 		push_complex_powerflow_values();
 	}
 
+	// post the next thermal event found in sync -- the equations of all the houses were solved at the end of their sync rank
+	if (thermal_event != TE_NONE)
+	{
+		double dt2 = (thermal_event==TE_SOLVE ? thermal_solver.get(thermal_index)*3600.0 : thermal_event_dt);
+		TIMESTAMP t2 = next_thermal_event(t1,dt2,TS_NEVER);
+		thermal_event = TE_NONE;
+		return enforce_dwell_time(t2);
+	}
+
 	return TS_NEVER;
 }
 
@@ -3308,41 +3362,20 @@ void house_e::pull_complex_powerflow_values(void)
 //Function to push up all changes of complex properties to powerflow from local variables
 void house_e::push_complex_powerflow_values(void)
 {
-	complex temp_complex_val;
-	gld_wlock *test_rlock;
+	OBJECT *obj = OBJECTHDR(this);
 	int indexval;
 
+	//Add our contributions to the parent -- the core folds them in once all the siblings are done
 	for (indexval=0; indexval<3; indexval++)
 	{
 		//**** Current value ***/
-		//Pull current value again, just in case
-		temp_complex_val = pLine_I[indexval]->get_complex();
-
-		//Add the difference
-		temp_complex_val += value_Line_I[indexval];
-
-		//Push it back up
-		pLine_I[indexval]->setp<complex>(temp_complex_val,*test_rlock);
+		pLine_I[indexval]->addp(value_Line_I[indexval],obj);
 
 		//**** shunt value ***/
-		//Pull current value again, just in case
-		temp_complex_val = pShunt[indexval]->get_complex();
-
-		//Add the difference
-		temp_complex_val += value_Shunt[indexval];
-
-		//Push it back up
-		pShunt[indexval]->setp<complex>(temp_complex_val,*test_rlock);
+		pShunt[indexval]->addp(value_Shunt[indexval],obj);
 
 		//**** Power value ***/
-		//Pull current value again, just in case
-		temp_complex_val = pPower[indexval]->get_complex();
-
-		//Add the difference
-		temp_complex_val += value_Power[indexval];
-
-		//Push it back up
-		pPower[indexval]->setp<complex>(temp_complex_val,*test_rlock);
+		pPower[indexval]->addp(value_Power[indexval],obj);
 	}
 }
 
@@ -15,6 +15,7 @@
 #include "enduse.h"
 #include "loadshape.h"
 #include "residential_enduse.h"
+#include "solvers.h"
 
 typedef struct s_implicit_enduse {
 	enduse load;
@@ -416,6 +417,19 @@ private:
 	bool check_start;
 	bool heat_start;
 
+	// the time to the next thermal event is found in sync but solved for all houses together in postsync
+	typedef enum {
+		TE_NONE = 0,	// no thermal event to post
+		TE_SOLVE = 1,	// time to the event comes from thermal_solver
+		TE_KNOWN = 2,	// time to the event is thermal_event_dt
+	} THERMALEVENT;
+	static etp_batch thermal_solver;	// ETP equations of all the houses
+	unsigned int thermal_index;		// index of this house's equation in thermal_solver
+	THERMALEVENT thermal_event;
+	double thermal_event_dt;
+	TIMESTAMP next_thermal_event(TIMESTAMP t1, double dt2, TIMESTAMP t2);
+	TIMESTAMP enforce_dwell_time(TIMESTAMP t2);
+
 	bool deltamode_inclusive;	//Boolean for deltamode calls - pulled from object flags
 	bool deltamode_registered;	//Boolean for deltamode registration -- basically a "first run" flag
 	bool proper_meter_parent;		//Flag to see if powerflow interactions should occur
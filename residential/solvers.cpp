@@ -4,6 +4,7 @@
 
 #define USE_GLSOLVERS
 #include "gridlabd.h"
+#include "solvers.h"
 
 #ifdef USE_NEWSOLVER
 
@@ -99,3 +100,220 @@ double e2solve(double a, double n, double b, double m, double c, double p, doubl
 }
 
 #endif
+
+//////////////////////////////////////////////////////////////////////////
+// etp_batch - solves many ETP equations at once
+//////////////////////////////////////////////////////////////////////////
+#define ETPB_IDLE 0
+#define ETPB_PENDING 1
+#define ETPB_SOLVED 2
+#define ETPB_EVAL(t,a,n,b,m,c) (a*exp(n*t) + b*exp(m*t) + c)
+
+etp_batch::etp_batch(double precision, unsigned int iterations)
+{
+	lock = 0;
+	count = size = 0;
+	a = n = b = m = c = t = f = dfdt = NULL;
+	iter = active = NULL;
+	status = NULL;
+	p = precision;
+	max_iterations = iterations;
+}
+
+etp_batch::~etp_batch(void)
+{
+	free(a); free(n); free(b); free(m); free(c);
+	free(t); free(f); free(dfdt);
+	free(iter); free(active); free(status);
+}
+
+void etp_batch::grow(void)
+{
+	size = ( size==0 ? 1024 : size*2 );
+	a = (double*)realloc(a,size*sizeof(double));
+	n = (double*)realloc(n,size*sizeof(double));
+	b = (double*)realloc(b,size*sizeof(double));
+	m = (double*)realloc(m,size*sizeof(double));
+	c = (double*)realloc(c,size*sizeof(double));
+	t = (double*)realloc(t,size*sizeof(double));
+	f = (double*)realloc(f,size*sizeof(double));
+	dfdt = (double*)realloc(dfdt,size*sizeof(double));
+	iter = (unsigned int*)realloc(iter,size*sizeof(unsigned int));
+	active = (unsigned int*)realloc(active,size*sizeof(unsigned int));
+	status = (unsigned char*)realloc(status,size*sizeof(unsigned char));
+	if ( a==NULL || n==NULL || b==NULL || m==NULL || c==NULL || t==NULL || f==NULL || dfdt==NULL || iter==NULL || active==NULL || status==NULL )
+		throw "etp_batch: memory allocation failed";
+}
+
+/** add an equation to the batch
+	@returns the index of the equation
+ **/
+unsigned int etp_batch::add(void)
+{
+	WRITELOCK(&lock);
+	if ( count==size )
+	{
+		try {
+			grow();
+		}
+		catch (...)
+		{
+			WRITEUNLOCK(&lock);
+			throw;
+		}
+	}
+	unsigned int i = count++;
+	status[i] = ETPB_IDLE;
+	t[i] = NaN;
+	WRITEUNLOCK(&lock);
+	return i;
+}
+
+/** set the coefficients of an equation and mark it for solving at the end of the rank
+	(equations may be set concurrently as long as each has a single owner)
+ **/
+void etp_batch::set(unsigned int i, double _a, double _n, double _b, double _m, double _c)
+{
+	a[i] = _a;
+	n[i] = _n;
+	b[i] = _b;
+	m[i] = _m;
+	c[i] = _c;
+	status[i] = ETPB_PENDING;
+	gl_reduce_call(solve_batch,this);
+}
+
+/** solve the pending equations once no object of the rank is running **/
+void etp_batch::solve_batch(void *batch)
+{
+	((etp_batch*)batch)->solve();
+}
+
+/** get the solution of an equation, normally solved at the end of the rank that set it
+	@returns the time t at which the equation is satisfied, NaN if it has no solution
+ **/
+double etp_batch::get(unsigned int i)
+{
+	if ( status[i]==ETPB_PENDING ) // only if the end of rank solve could not be queued
+	{
+		WRITELOCK(&lock);
+		if ( status[i]==ETPB_PENDING )
+			solve();
+		WRITEUNLOCK(&lock);
+	}
+	return t[i];
+}
+
+/** solve all pending equations - this follows the ETP solver in gldcore/solvers/etp.cpp
+	step for step, only each step is done for all the equations before moving to the next one
+ **/
+void etp_batch::solve(void)
+{
+	unsigned int i, k, n_active=0, n_left;
+
+	// check for degenerate cases and extrema/inflexions to find the starting points
+	for ( i=0 ; i<count ; i++ )
+	{
+		if ( status[i]!=ETPB_PENDING )
+			continue;
+		status[i] = ETPB_SOLVED;
+		t[i] = 0;
+		f[i] = ETPB_EVAL(t[i],a[i],n[i],b[i],m[i],c[i]);
+
+		// one exponential term is dominant
+		if (fabs(a[i]/b[i])<p)
+		{
+			t[i] = c[i]*b[i]<0 && fabs(c[i])<fabs(b[i]) ? log(-c[i]/b[i])/m[i] : NaN;
+			continue;
+		}
+		else if (fabs(b[i]/a[i])<p)
+		{
+			t[i] = c[i]*a[i]<0 && fabs(c[i])<fabs(a[i]) ? log(-c[i]/a[i])/n[i] : NaN;
+			continue;
+		}
+
+		// extremum/inflexion to consider
+		if (a[i]*b[i]<0)
+		{
+			double an_bm = -a[i]*n[i]/(b[i]*m[i]);
+			double tm = log(an_bm)/(m[i]-n[i]);
+			double fm = ETPB_EVAL(tm,a[i],n[i],b[i],m[i],c[i]);
+			double ti = log(an_bm*n[i]/m[i])/(m[i]-n[i]);
+			double fi = ETPB_EVAL(ti,a[i],n[i],b[i],m[i],c[i]);
+			if (tm>0) // extremum in domain
+			{
+				if (f[i]*fm<0) // first solution is in range
+					t[i] = 0;
+				else if (c[i]*fm<0) // second solution is in range
+					t[i] = ti;
+				else // no solution is in range
+				{
+					t[i] = NaN;
+					continue;
+				}
+			}
+			else if (tm<0 && ti>0) // no extremum but inflexion in domain
+			{
+				if (fm*c[i]<0) // solution in range
+					t[i] = ti;
+				else // no solution in range
+				{
+					t[i] = NaN;
+					continue;
+				}
+			}
+			else if (ti<0) // no extremum or inflexion in domain
+			{
+				if (fi*c[i]<0) // solution in range
+					t[i] = ti;
+				else // no solution in range
+				{
+					t[i] = NaN;
+					continue;
+				}
+			}
+			else // no solution possible (includes tm==0 and ti==0)
+			{
+				t[i] = NaN;
+				continue;
+			}
+		}
+		else if (f[i]*c[i]>0) // solution is not reachable from t=0 (same sign)
+		{
+			t[i] = NaN;
+			continue;
+		}
+
+		// needs Newton's method
+		if (t[i]!=0) // initial t changed to inflexion point
+			f[i] = ETPB_EVAL(t[i],a[i],n[i],b[i],m[i],c[i]);
+		dfdt[i] = ETPB_EVAL(t[i],a[i]*n[i],n[i],b[i]*m[i],m[i],0);
+		iter[i] = max_iterations;
+		active[n_active++] = i;
+	}
+
+	// Newton's method, one iteration of all the unconverged equations at a time
+	while ( n_active>0 )
+	{
+		n_left = 0;
+		for ( k=0 ; k<n_active ; k++ )
+		{
+			i = active[k];
+			if ( fabs(f[i])>p && isfinite(t[i]) && iter[i]-->0 )
+			{
+				t[i] -= f[i]/dfdt[i];
+				f[i] = ETPB_EVAL(t[i],a[i],n[i],b[i],m[i],c[i]);
+				dfdt[i] = ETPB_EVAL(t[i],a[i]*n[i],n[i],b[i]*m[i],m[i],0);
+				active[n_left++] = i;
+			}
+			else if (iter[i]==0)
+			{
+				gl_error("etp::solve(a=%.4f,n=%.4f,b=%.4f,m=%.4f,c=%.4f,prec=%.g) failed to converge",a[i],n[i],b[i],m[i],c[i],p);
+				t[i] = NaN;
+			}
+			else if (t[i]<=0)
+				t[i] = NaN;
+		}
+		n_active = n_left;
+	}
+}
@@ -10,4 +10,34 @@
 
 double e2solve( double a,double n,double b,double m,double c,double p=1e-8,double *e=NULL);
 
+/// Batch solver for the dual-decay ETP equation \f$ ae^{nt} + be^{mt} + c = 0 \f$.
+/// Equations are kept as arrays (one entry per house).  The equations set
+/// while a rank is synchronized are solved together by one thread once the
+/// rank is done (see gl_reduce_call), so results are read without locking.
+/// Each result is exactly what e2solve() would give for the same equation.
+class etp_batch {
+private:
+	unsigned int lock;		///< protects the arrays while equations are added, or solved outside a rank
+	unsigned int count;		///< number of equations in the batch
+	unsigned int size;		///< allocated size of the arrays
+	double *a, *n, *b, *m, *c;	///< equation coefficients
+	double *t;				///< solutions (NaN if no solution)
+	double *f, *dfdt;		///< Newton's method working values
+	unsigned int *iter;		///< Newton's method iterations left
+	unsigned char *status;	///< ETPB_IDLE, ETPB_PENDING or ETPB_SOLVED
+	unsigned int *active;	///< equations still iterating
+	double p;				///< precision
+	unsigned int max_iterations;	///< Newton's method iteration limit
+	void grow(void);
+	void solve(void);
+	static void solve_batch(void *batch);
+public:
+	etp_batch(double precision=1e-8, unsigned int iterations=100);
+	~etp_batch(void);
+	unsigned int add(void);
+	void set(unsigned int i, double a, double n, double b, double m, double c);
+	double get(unsigned int i);
+	inline unsigned int get_count(void) { return count; };
+};
+
 #endif
@@ -10,8 +10,15 @@ tape_tape_la_LDFLAGS += $(AM_LDFLAGS)
 tape_tape_la_LIBADD =
 tape_tape_la_LIBADD += third_party/jsonCpp/libjsoncpp.la
 tape_tape_la_LIBADD += -ldl
+tape_tape_la_LIBADD += $(PTHREAD_CFLAGS)
+tape_tape_la_LIBADD += $(PTHREAD_LIBS)
 
 tape_tape_la_SOURCES =
+tape_tape_la_SOURCES += tape/async.c
+tape_tape_la_SOURCES += tape/async.h
+tape_tape_la_SOURCES += tape/binary.c
+tape_tape_la_SOURCES += tape/binary.h
+tape_tape_la_SOURCES += tape/binary_sampler.c
 tape_tape_la_SOURCES += tape/collector.c
 tape_tape_la_SOURCES += tape/file.c
 tape_tape_la_SOURCES += tape/file.h
@@ -34,7 +41,18 @@ tape_tape_la_SOURCES += tape/multi_recorder.c
 tape_tape_la_SOURCES += tape/odbc.c
 tape_tape_la_SOURCES += tape/odbc.h
 tape_tape_la_SOURCES += tape/player.c
+tape_tape_la_SOURCES += tape/player_cache.c
 tape_tape_la_SOURCES += tape/recorder.c
 tape_tape_la_SOURCES += tape/shaper.c
 tape_tape_la_SOURCES += tape/tape.c
 tape_tape_la_SOURCES += tape/tape.h
+
+bin_PROGRAMS += tape2csv
+
+tape2csv_CPPFLAGS =
+tape2csv_CPPFLAGS += $(AM_CPPFLAGS)
+
+tape2csv_SOURCES =
+tape2csv_SOURCES += tape/binary.c
+tape2csv_SOURCES += tape/binary.h
+tape2csv_SOURCES += tape/tape2csv.c
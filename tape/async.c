@@ -0,0 +1,389 @@
+/* $Id$
+ *	Copyright (C) 2008 Battelle Memorial Institute
+ *
+ *	Background writer for tape output.  See async.h for the design.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/time.h>
+#include <pthread.h>
+
+#include "gridlabd.h"
+#include "async.h"
+
+#ifdef _MSC_VER
+#include <windows.h>
+#define async_barrier() MemoryBarrier()
+#define async_next_seq() ((unsigned int64)InterlockedIncrement64((volatile LONGLONG*)&async_seq))
+#else
+#define async_barrier() __sync_synchronize()
+#define async_next_seq() __sync_add_and_fetch(&async_seq,1)
+#endif
+
+#define ASYNC_ALIGN(X) (((X)+7)&~(size_t)7)
+#define ASYNC_POLL 10 /* ms the writer sleeps when it has not been woken */
+
+extern int32 async_output;
+extern int32 async_buffer_size;
+
+typedef enum {
+	AO_WRITE=0, /**< write the data */
+	AO_FLUSH=1, /**< flush the file */
+	AO_CLOSE=2, /**< close the file */
+	AO_WRAP=3 /**< the rest of the ring is unused */
+} ASYNCOP;
+
+typedef struct s_asyncrecord {
+	unsigned int64 seq; /**< global order of the record */
+	FILE *fp;
+	unsigned int op; /**< ASYNCOP */
+	unsigned int len; /**< bytes of data following the record */
+} ASYNCRECORD;
+
+/** A single-producer single-consumer ring.  Only the owning thread moves
+	\p tail and only the writer moves \p head; both only ever grow. */
+typedef struct s_asyncring {
+	char *data;
+	size_t size;
+	volatile size_t head; /**< bytes consumed by the writer */
+	volatile size_t tail; /**< bytes queued by the owner */
+	struct s_asyncring *next;
+} ASYNCRING;
+
+ASYNCOPS async_ops = {async_printf,async_vprintf,async_write,async_flush,async_close};
+
+static pthread_mutex_t async_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_ready = PTHREAD_COND_INITIALIZER; /* signals the writer */
+static pthread_cond_t async_space = PTHREAD_COND_INITIALIZER; /* signals waiting producers */
+static pthread_key_t async_key;
+static pthread_t async_thread;
+static int async_started = 0;
+static volatile int async_stop = 0;
+static ASYNCRING * volatile async_rings = NULL;
+static volatile unsigned int64 async_seq = 0;
+static volatile int async_errors = 0;
+static int async_lasterr = 0;
+
+/* the record at the ring's head, or NULL when the ring is empty */
+static ASYNCRECORD *peek(ASYNCRING *ring)
+{
+	while ( ring->head!=ring->tail )
+	{
+		size_t pos = ring->head%ring->size;
+		ASYNCRECORD *rec;
+		async_barrier();
+		rec = (ASYNCRECORD*)(ring->data+pos);
+		if ( ring->size-pos<sizeof(ASYNCRECORD) || rec->op==AO_WRAP )
+		{
+			ring->head += ring->size-pos;
+			continue;
+		}
+		return rec;
+	}
+	return NULL;
+}
+
+static void perform(ASYNCRECORD *rec)
+{
+	int rc = 0;
+	switch ( rec->op ) {
+	case AO_WRITE:
+		rc = fwrite(rec+1,1,rec->len,rec->fp)==rec->len ? 0 : EOF;
+		break;
+	case AO_FLUSH:
+		rc = fflush(rec->fp);
+		break;
+	case AO_CLOSE:
+		rc = fclose(rec->fp);
+		break;
+	default:
+		break;
+	}
+	if ( rc!=0 )
+	{
+		async_lasterr = errno;
+		async_errors++;
+	}
+}
+
+/* write everything queued so far in sequence order
+   @return the number of records written */
+static unsigned int drain(void)
+{
+	unsigned int count = 0;
+	for (;;)
+	{
+		ASYNCRING *ring, *first = NULL;
+		ASYNCRECORD *rec, *next = NULL;
+		for ( ring=async_rings ; ring!=NULL ; ring=ring->next )
+		{
+			rec = peek(ring);
+			if ( rec!=NULL && (next==NULL || rec->seq<next->seq) )
+			{
+				next = rec;
+				first = ring;
+			}
+		}
+		if ( next==NULL )
+			return count;
+		perform(next);
+		async_barrier();
+		first->head += ASYNC_ALIGN(sizeof(ASYNCRECORD)+next->len);
+		count++;
+	}
+}
+
+static void *async_main(void *arg)
+{
+	pthread_mutex_lock(&async_lock);
+	for (;;)
+	{
+		unsigned int count;
+		pthread_mutex_unlock(&async_lock);
+		count = drain();
+		pthread_mutex_lock(&async_lock);
+		if ( count>0 )
+			pthread_cond_broadcast(&async_space);
+		else if ( async_stop )
+			break;
+		else
+		{
+			struct timespec until;
+			struct timeval now;
+			gettimeofday(&now,NULL);
+			until.tv_sec = now.tv_sec;
+			until.tv_nsec = (now.tv_usec+ASYNC_POLL*1000)*1000;
+			if ( until.tv_nsec>=1000000000 )
+			{
+				until.tv_sec++;
+				until.tv_nsec -= 1000000000;
+			}
+			pthread_cond_timedwait(&async_ready,&async_lock,&until);
+		}
+	}
+	pthread_mutex_unlock(&async_lock);
+	return NULL;
+}
+
+/* the calling thread's ring, starting the writer on first use */
+static ASYNCRING *get_ring(void)
+{
+	ASYNCRING *ring;
+	pthread_mutex_lock(&async_lock);
+	if ( !async_started )
+	{
+		if ( pthread_key_create(&async_key,NULL)!=0 || pthread_create(&async_thread,NULL,async_main,NULL)!=0 )
+		{
+			pthread_mutex_unlock(&async_lock);
+			gl_warning("tape::async_output: unable to start the writer thread, output will be synchronous");
+			async_output = 0;
+			return NULL;
+		}
+		async_started = 1;
+	}
+	pthread_mutex_unlock(&async_lock);
+	ring = (ASYNCRING*)pthread_getspecific(async_key);
+	if ( ring!=NULL )
+		return ring;
+	ring = (ASYNCRING*)malloc(sizeof(ASYNCRING));
+	if ( ring==NULL )
+		return NULL;
+	ring->size = ASYNC_ALIGN(async_buffer_size<4096 ? 4096 : (size_t)async_buffer_size);
+	ring->data = (char*)malloc(ring->size);
+	if ( ring->data==NULL )
+	{
+		free(ring);
+		return NULL;
+	}
+	ring->head = ring->tail = 0;
+	pthread_mutex_lock(&async_lock);
+	ring->next = async_rings;
+	async_barrier();
+	async_rings = ring;
+	pthread_mutex_unlock(&async_lock);
+	pthread_setspecific(async_key,ring);
+	return ring;
+}
+
+/* block until the writer has consumed \p ring up to \p pos,
+   or every ring entirely when \p ring is NULL */
+static void wait_for(ASYNCRING *ring, size_t pos)
+{
+	pthread_mutex_lock(&async_lock);
+	for (;;)
+	{
+		ASYNCRING *r;
+		int done = 1;
+		if ( ring!=NULL )
+			done = ring->head>=pos;
+		else
+		{
+			for ( r=async_rings ; r!=NULL ; r=r->next )
+			{
+				if ( r->head!=r->tail )
+					done = 0;
+			}
+		}
+		if ( done )
+			break;
+		pthread_cond_signal(&async_ready);
+		pthread_cond_wait(&async_space,&async_lock);
+	}
+	pthread_mutex_unlock(&async_lock);
+}
+
+/* queue a record, waiting for room if the ring is full
+   @return the ring position just past the record, or 0 if it was not queued */
+static size_t enqueue(ASYNCRING *ring, FILE *fp, ASYNCOP op, const void *data, size_t len)
+{
+	size_t need = ASYNC_ALIGN(sizeof(ASYNCRECORD)+len);
+	size_t pos = ring->tail%ring->size;
+	size_t skip = ring->size-pos<need ? ring->size-pos : 0;
+	ASYNCRECORD *rec;
+
+	if ( need>ring->size/2 )
+		return 0;
+	if ( ring->size-(ring->tail-ring->head)<skip+need )
+		wait_for(ring,ring->tail+skip+need-ring->size);
+	if ( skip>0 )
+	{
+		if ( skip>=sizeof(ASYNCRECORD) )
+			((ASYNCRECORD*)(ring->data+pos))->op = AO_WRAP;
+		pos = 0;
+	}
+	rec = (ASYNCRECORD*)(ring->data+pos);
+	rec->seq = async_next_seq();
+	rec->fp = fp;
+	rec->op = op;
+	rec->len = (unsigned int)len;
+	if ( len>0 )
+		memcpy(rec+1,data,len);
+	async_barrier();
+	ring->tail += skip+need;
+
+	/* wake the writer early rather than let the ring fill up */
+	if ( op!=AO_WRITE || ring->tail-ring->head>ring->size/2 )
+	{
+		pthread_mutex_lock(&async_lock);
+		pthread_cond_signal(&async_ready);
+		pthread_mutex_unlock(&async_lock);
+	}
+	return ring->tail;
+}
+
+static void report_errors(void)
+{
+	if ( async_errors>0 )
+	{
+		gl_error("tape::async_output: %d writes failed (%s)", async_errors, strerror(async_lasterr));
+		async_errors = 0;
+	}
+}
+
+/** Queue \p len bytes for \p fp
+	@return \p len, or -1 on failure
+ **/
+int async_write(FILE *fp, const void *data, size_t len)
+{
+	ASYNCRING *ring;
+	if ( !async_output || (ring=get_ring())==NULL )
+		return fwrite(data,1,len,fp)==len ? (int)len : -1;
+	report_errors();
+	if ( enqueue(ring,fp,AO_WRITE,data,len)==0 )
+	{
+		/* too big to queue, so write it once everything before it is out */
+		wait_for(NULL,0);
+		return fwrite(data,1,len,fp)==len ? (int)len : -1;
+	}
+	return (int)len;
+}
+
+int async_vprintf(FILE *fp, const char *format, va_list ptr)
+{
+	char buffer[1024], *text = buffer;
+	int len;
+	va_list copy;
+	if ( !async_output )
+		return vfprintf(fp,format,ptr);
+	va_copy(copy,ptr);
+	len = vsnprintf(buffer,sizeof(buffer),format,ptr);
+	if ( len>=(int)sizeof(buffer) && (text=(char*)malloc(len+1))!=NULL )
+		vsnprintf(text,len+1,format,copy);
+	va_end(copy);
+	if ( len<0 || text==NULL )
+		return -1;
+	len = async_write(fp,text,len);
+	if ( text!=buffer )
+		free(text);
+	return len;
+}
+
+/** Queue formatted output for \p fp
+	@return the number of characters queued, or a negative value on failure
+ **/
+int async_printf(FILE *fp, const char *format, ...)
+{
+	int len;
+	va_list ptr;
+	va_start(ptr,format);
+	len = async_vprintf(fp,format,ptr);
+	va_end(ptr);
+	return len;
+}
+
+/** Queue a flush of \p fp
+	@return 0 on success, EOF on failure
+ **/
+int async_flush(FILE *fp)
+{
+	ASYNCRING *ring;
+	if ( !async_output || (ring=get_ring())==NULL )
+		return fflush(fp);
+	return enqueue(ring,fp,AO_FLUSH,NULL,0)>0 ? 0 : EOF;
+}
+
+/** Close \p fp once its queued output is written.  Unlike a flush this
+	waits, so the file may be reopened as soon as it returns.
+	@return 0 on success, EOF on failure
+ **/
+int async_close(FILE *fp)
+{
+	ASYNCRING *ring;
+	size_t pos;
+	int errors;
+	if ( !async_output || (ring=get_ring())==NULL )
+		return fclose(fp);
+	errors = async_errors;
+	pos = enqueue(ring,fp,AO_CLOSE,NULL,0);
+	if ( pos==0 )
+		return EOF;
+	wait_for(ring,pos);
+	return async_errors>errors ? EOF : 0;
+}
+
+/** Write everything still queued and stop the writer */
+void async_term(void)
+{
+	ASYNCRING *ring;
+	if ( !async_started )
+		return;
+	pthread_mutex_lock(&async_lock);
+	async_stop = 1;
+	pthread_cond_signal(&async_ready);
+	pthread_mutex_unlock(&async_lock);
+	pthread_join(async_thread,NULL);
+	report_errors();
+	while ( (ring=async_rings)!=NULL )
+	{
+		async_rings = ring->next;
+		free(ring->data);
+		free(ring);
+	}
+	async_started = 0;
+	async_stop = 0;
+	async_output = 0;
+}
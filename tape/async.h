@@ -0,0 +1,60 @@
+/* $Id$
+ *	Copyright (C) 2008 Battelle Memorial Institute
+ */
+
+#ifndef _ASYNC_H
+#define _ASYNC_H
+
+#include <stdio.h>
+#include <stdarg.h>
+
+/** @addtogroup async_output Asynchronous tape output
+	@ingroup tapes
+
+	When \p tape::async_output is set, records written by the tape objects
+	are queued in a ring buffer owned by the calling thread and a single
+	background thread writes them to disk, so a slow disk no longer stalls
+	the sync and commit passes.  Records carry a global sequence number and
+	the writer always takes the lowest one waiting, so the records of any
+	one file reach it in the order they were queued even when successive
+	passes run the object on different threads.
+
+	Each ring holds \p tape::async_buffer_size bytes.  When a ring is full
+	the caller waits for the writer to make room.  A flush is queued like a
+	write, but a close waits until the file is really closed, since callers
+	may reopen or rename it.  The writer is drained and stopped when the
+	module terminates.
+
+	When \p tape::async_output is not set every call goes straight to stdio.
+ @{
+ **/
+
+/** The output calls, as handed to the tape_<mode> libraries */
+typedef struct s_async_ops {
+	int (*printf)(FILE *fp, const char *format, ...);
+	int (*vprintf)(FILE *fp, const char *format, va_list ptr);
+	int (*write)(FILE *fp, const void *data, size_t len);
+	int (*flush)(FILE *fp);
+	int (*close)(FILE *fp);
+} ASYNCOPS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int async_printf(FILE *fp, const char *format, ...);
+int async_vprintf(FILE *fp, const char *format, va_list ptr);
+int async_write(FILE *fp, const void *data, size_t len);
+int async_flush(FILE *fp);
+int async_close(FILE *fp);
+void async_term(void);
+
+extern ASYNCOPS async_ops;
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif
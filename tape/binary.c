@@ -0,0 +1,862 @@
+/* $Id$
+ *	Copyright (C) 2008 Battelle Memorial Institute
+ *
+ *	Reader and writer for binary columnar tapes.  This file does not use the
+ *	core API so that it can be linked into the tape2csv converter as well as
+ *	the tape module; see binary.h for the file layout.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+
+#include "binary.h"
+
+/*******************************************************************
+ * varints and scratch buffer
+ */
+static unsigned int64 zigzag(int64 v)
+{
+	return ((unsigned int64)v<<1) ^ (unsigned int64)(v>>63);
+}
+
+static int64 unzigzag(unsigned int64 u)
+{
+	return (int64)(u>>1) ^ -(int64)(u&1);
+}
+
+/** make room for \p more bytes after the first \p len bytes of the scratch buffer
+	@return a pointer to the buffer, or NULL when out of memory
+ **/
+static unsigned char *reserve(BINARYTAPE *tape, size_t len, size_t more)
+{
+	if ( len+more > tape->buffer_size )
+	{
+		size_t size = tape->buffer_size>0 ? tape->buffer_size : 65536;
+		unsigned char *buffer;
+		while ( size < len+more )
+			size *= 2;
+		buffer = (unsigned char*)realloc(tape->buffer,size);
+		if ( buffer==NULL )
+		{
+			sprintf(tape->lasterr,"out of memory");
+			return NULL;
+		}
+		tape->buffer = buffer;
+		tape->buffer_size = size;
+	}
+	return tape->buffer;
+}
+
+static size_t put_varint(unsigned char *p, unsigned int64 v)
+{
+	size_t n = 0;
+	while ( v>=0x80 )
+	{
+		p[n++] = (unsigned char)(v|0x80);
+		v >>= 7;
+	}
+	p[n++] = (unsigned char)v;
+	return n;
+}
+
+static int get_varint(const unsigned char **p, const unsigned char *end, unsigned int64 *v)
+{
+	unsigned int64 r = 0;
+	int shift;
+	for ( shift=0 ; *p<end && shift<64 ; shift+=7 )
+	{
+		unsigned char c = *(*p)++;
+		r |= (unsigned int64)(c&0x7f)<<shift;
+		if ( (c&0x80)==0 )
+		{
+			*v = r;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static int write_varint(FILE *fp, unsigned int64 v)
+{
+	unsigned char buffer[10];
+	size_t n = put_varint(buffer,v);
+	return fwrite(buffer,1,n,fp)==n;
+}
+
+/** @return 1 on success, 0 at a clean end of file, -1 when the file ends mid-value */
+static int read_varint(FILE *fp, unsigned int64 *v)
+{
+	unsigned int64 r = 0;
+	int shift, c;
+	for ( shift=0 ; shift<64 ; shift+=7 )
+	{
+		if ( (c=fgetc(fp))==EOF )
+			return shift==0 ? 0 : -1;
+		r |= (unsigned int64)(c&0x7f)<<shift;
+		if ( (c&0x80)==0 )
+		{
+			*v = r;
+			return 1;
+		}
+	}
+	return -1;
+}
+
+static int write_string(FILE *fp, const char *s)
+{
+	size_t len = strlen(s);
+	return write_varint(fp,len) && fwrite(s,1,len,fp)==len;
+}
+
+static char *read_string(FILE *fp)
+{
+	unsigned int64 len;
+	char *s;
+	if ( read_varint(fp,&len)!=1 || len>=BINARY_TAPE_TEXTSIZE*64 )
+		return NULL;
+	s = (char*)malloc((size_t)len+1);
+	if ( s==NULL )
+		return NULL;
+	if ( fread(s,1,(size_t)len,fp)!=(size_t)len )
+	{
+		free(s);
+		return NULL;
+	}
+	s[len] = '\0';
+	return s;
+}
+
+static char *copy_string(const char *s)
+{
+	char *copy = (char*)malloc(strlen(s)+1);
+	if ( copy!=NULL )
+		strcpy(copy,s);
+	return copy;
+}
+
+/*******************************************************************
+ * column encoders
+ *
+ * Each encoder writes one column of the current block to the start of
+ * the scratch buffer and returns the number of bytes, or -1 when out of
+ * memory.
+ */
+static int64 encode_raw(BINARYTAPE *tape, const void *values, unsigned int n)
+{
+	const unsigned char *v = (const unsigned char*)values;
+	unsigned char *p = reserve(tape,0,(size_t)n*8);
+	size_t len = 0;
+	unsigned int i;
+	if ( p==NULL )
+		return -1;
+	for ( i=0 ; i<n ; i++ )
+	{
+		unsigned int64 bits;
+		int b;
+		memcpy(&bits,v+(size_t)i*8,8);
+		for ( b=0 ; b<8 ; b++ )
+			p[len++] = (unsigned char)(bits>>(8*b));
+	}
+	return (int64)len;
+}
+
+static int64 encode_delta(BINARYTAPE *tape, const int64 *values, unsigned int n, int order)
+{
+	unsigned int64 prev = 0, prev_delta = 0;
+	size_t len = 0;
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+	{
+		unsigned int64 delta = (unsigned int64)values[i] - prev;
+		unsigned char *p = reserve(tape,len,10);
+		if ( p==NULL )
+			return -1;
+		if ( order==2 )
+		{
+			len += put_varint(p+len,zigzag((int64)(delta-prev_delta)));
+			prev_delta = delta;
+		}
+		else
+			len += put_varint(p+len,zigzag((int64)delta));
+		prev = (unsigned int64)values[i];
+	}
+	return (int64)len;
+}
+
+static int64 encode_xor(BINARYTAPE *tape, const double *values, unsigned int n)
+{
+	unsigned int64 prev = 0;
+	size_t len = 0;
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+	{
+		unsigned int64 bits, x;
+		int lead = 0, trail = 0, b;
+		unsigned char *p = reserve(tape,len,9);
+		if ( p==NULL )
+			return -1;
+		memcpy(&bits,values+i,8);
+		x = bits^prev;
+		prev = bits;
+		if ( x==0 )
+		{
+			p[len++] = 0x80;
+			continue;
+		}
+		while ( (x>>(56-8*lead))==0 )
+			lead++;
+		while ( ((x>>(8*trail))&0xff)==0 )
+			trail++;
+		p[len++] = (unsigned char)((lead<<4)|trail);
+		for ( b=trail ; b<8-lead ; b++ )
+			p[len++] = (unsigned char)(x>>(8*b));
+	}
+	return (int64)len;
+}
+
+static int64 encode_text(BINARYTAPE *tape, char **values, unsigned int n)
+{
+	size_t len = 0;
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+	{
+		size_t size = strlen(values[i]);
+		unsigned char *p = reserve(tape,len,size+10);
+		if ( p==NULL )
+			return -1;
+		if ( i>0 && strcmp(values[i],values[i-1])==0 )
+			len += put_varint(p+len,0);
+		else
+		{
+			len += put_varint(p+len,(unsigned int64)size+1);
+			memcpy(p+len,values[i],size);
+			len += size;
+		}
+	}
+	return (int64)len;
+}
+
+/*******************************************************************
+ * column decoders
+ */
+static int decode_raw(const unsigned char *p, const unsigned char *end, void *values, unsigned int n)
+{
+	unsigned char *v = (unsigned char*)values;
+	unsigned int i;
+	if ( end-p != (ptrdiff_t)n*8 )
+		return 0;
+	for ( i=0 ; i<n ; i++ )
+	{
+		unsigned int64 bits = 0;
+		int b;
+		for ( b=0 ; b<8 ; b++ )
+			bits |= (unsigned int64)(*p++)<<(8*b);
+		memcpy(v+(size_t)i*8,&bits,8);
+	}
+	return 1;
+}
+
+static int decode_delta(const unsigned char *p, const unsigned char *end, int64 *values, unsigned int n, int order)
+{
+	unsigned int64 prev = 0, prev_delta = 0;
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+	{
+		unsigned int64 u, delta;
+		if ( !get_varint(&p,end,&u) )
+			return 0;
+		delta = (unsigned int64)unzigzag(u);
+		if ( order==2 )
+		{
+			delta += prev_delta;
+			prev_delta = delta;
+		}
+		prev += delta;
+		values[i] = (int64)prev;
+	}
+	return p==end;
+}
+
+static int decode_xor(const unsigned char *p, const unsigned char *end, double *values, unsigned int n)
+{
+	unsigned int64 prev = 0;
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+	{
+		unsigned int64 x = 0;
+		int lead, trail, b;
+		if ( p>=end )
+			return 0;
+		lead = *p>>4;
+		trail = *p&0x0f;
+		p++;
+		if ( lead<8 )
+		{
+			if ( lead+trail>7 || end-p < 8-lead-trail )
+				return 0;
+			for ( b=trail ; b<8-lead ; b++ )
+				x |= (unsigned int64)(*p++)<<(8*b);
+		}
+		prev ^= x;
+		memcpy(values+i,&prev,8);
+	}
+	return p==end;
+}
+
+static int decode_text(const unsigned char *p, const unsigned char *end, char **values, unsigned int n)
+{
+	unsigned int i;
+	for ( i=0 ; i<n ; i++ )
+	{
+		unsigned int64 size;
+		if ( !get_varint(&p,end,&size) )
+			return 0;
+		if ( size==0 )
+		{
+			if ( i==0 )
+				return 0;
+			values[i] = copy_string(values[i-1]);
+		}
+		else
+		{
+			size--;
+			if ( (unsigned int64)(end-p) < size )
+				return 0;
+			values[i] = (char*)malloc((size_t)size+1);
+			if ( values[i]!=NULL )
+			{
+				memcpy(values[i],p,(size_t)size);
+				values[i][size] = '\0';
+			}
+			p += size;
+		}
+		if ( values[i]==NULL )
+			return 0;
+	}
+	return p==end;
+}
+
+/*******************************************************************
+ * blocks
+ */
+static int write_column(BINARYTAPE *tape, BINARYENCODING encoding, int64 len)
+{
+	if ( len<0 )
+		return 0;
+	if ( fputc(encoding,tape->fp)==EOF
+		|| !write_varint(tape->fp,(unsigned int64)len)
+		|| fwrite(tape->buffer,1,(size_t)len,tape->fp)!=(size_t)len )
+	{
+		sprintf(tape->lasterr,"write failed: %s", strerror(errno));
+		return 0;
+	}
+	return 1;
+}
+
+static int write_block(BINARYTAPE *tape)
+{
+	unsigned int n = tape->n_rows, c, i;
+	if ( n==0 )
+		return 1;
+	tape->n_rows = 0;
+	if ( !write_varint(tape->fp,n) )
+	{
+		sprintf(tape->lasterr,"write failed: %s", strerror(errno));
+		return 0;
+	}
+	if ( !write_column(tape,BE_DELTA2,encode_delta(tape,tape->time,n,2)) )
+		return 0;
+	for ( c=0 ; c<tape->n_columns ; c++ )
+	{
+		BINARYCOLUMN *col = tape->column+c;
+		int64 len;
+		switch ( col->type ) {
+		case BT_DOUBLE:
+			/* noisy signals may not compress, so fall back to raw values */
+			len = encode_xor(tape,col->data.d,n);
+			if ( len > (int64)n*8 )
+			{
+				if ( !write_column(tape,BE_RAW,encode_raw(tape,col->data.d,n)) )
+					return 0;
+			}
+			else if ( !write_column(tape,BE_XOR,len) )
+				return 0;
+			break;
+		case BT_INT64:
+			len = encode_delta(tape,col->data.i,n,1);
+			if ( len > (int64)n*8 )
+			{
+				if ( !write_column(tape,BE_RAW,encode_raw(tape,col->data.i,n)) )
+					return 0;
+			}
+			else if ( !write_column(tape,BE_DELTA,len) )
+				return 0;
+			break;
+		case BT_TEXT:
+			len = encode_text(tape,col->data.s,n);
+			for ( i=0 ; i<n ; i++ )
+			{
+				free(col->data.s[i]);
+				col->data.s[i] = NULL;
+			}
+			if ( !write_column(tape,BE_TEXT,len) )
+				return 0;
+			break;
+		default:
+			sprintf(tape->lasterr,"column '%s' has an invalid type", col->name);
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/** read the encoding and payload of the next column into the scratch buffer
+	@return the encoding, or -1 on error
+ **/
+static int read_column(BINARYTAPE *tape, size_t *len)
+{
+	unsigned int64 size;
+	int encoding = fgetc(tape->fp);
+	if ( encoding==EOF || read_varint(tape->fp,&size)!=1 || size>(unsigned int64)BINARY_TAPE_BLOCK*(BINARY_TAPE_TEXTSIZE+10) )
+		return -1;
+	if ( reserve(tape,0,(size_t)size)==NULL || fread(tape->buffer,1,(size_t)size,tape->fp)!=(size_t)size )
+		return -1;
+	*len = (size_t)size;
+	return encoding;
+}
+
+static void free_text(BINARYTAPE *tape, unsigned int n)
+{
+	unsigned int c, i;
+	for ( c=0 ; c<tape->n_columns ; c++ )
+	{
+		if ( tape->column[c].type!=BT_TEXT || tape->column[c].data.s==NULL )
+			continue;
+		for ( i=0 ; i<n ; i++ )
+		{
+			free(tape->column[c].data.s[i]);
+			tape->column[c].data.s[i] = NULL;
+		}
+	}
+}
+
+/*******************************************************************
+ * columns
+ */
+static BINARYCOLUMN *new_column(BINARYTAPE *tape, char *name, char *unit, char *keywords, BINARYTYPE type)
+{
+	BINARYCOLUMN *list = (BINARYCOLUMN*)realloc(tape->column,sizeof(BINARYCOLUMN)*(tape->n_columns+1));
+	BINARYCOLUMN *col;
+	if ( list==NULL )
+		return NULL;
+	tape->column = list;
+	col = list+tape->n_columns++;
+	memset(col,0,sizeof(BINARYCOLUMN));
+	col->name = name;
+	col->unit = unit;
+	col->keywords = keywords;
+	col->type = type;
+	if ( name==NULL || unit==NULL || keywords==NULL )
+		return NULL;
+	switch ( type ) {
+	case BT_DOUBLE:
+		col->data.d = (double*)malloc(sizeof(double)*BINARY_TAPE_BLOCK);
+		break;
+	case BT_INT64:
+		col->data.i = (int64*)malloc(sizeof(int64)*BINARY_TAPE_BLOCK);
+		break;
+	case BT_TEXT:
+		col->data.s = (char**)calloc(BINARY_TAPE_BLOCK,sizeof(char*));
+		col->text_row = (char*)calloc(1,BINARY_TAPE_TEXTSIZE);
+		col->text_held = (char*)calloc(1,BINARY_TAPE_TEXTSIZE);
+		if ( col->text_row==NULL || col->text_held==NULL )
+			return NULL;
+		break;
+	default:
+		return NULL;
+	}
+	return col->data.d!=NULL ? col : NULL;
+}
+
+/*******************************************************************
+ * public interface
+ */
+
+/** Determine whether a file name selects a binary tape
+	@return nonzero if \p fname ends in \p BINARY_TAPE_EXT
+ **/
+int binary_tape_match(const char *fname)
+{
+	size_t len = strlen(fname), ext = strlen(BINARY_TAPE_EXT);
+	return len>ext && strcmp(fname+len-ext,BINARY_TAPE_EXT)==0;
+}
+
+/** Create a binary tape for writing.  Info and columns are added before
+	the header is written by binary_tape_start().
+	@return the tape, or NULL with \p errno set
+ **/
+BINARYTAPE *binary_tape_create(const char *fname)
+{
+	BINARYTAPE *tape = (BINARYTAPE*)calloc(1,sizeof(BINARYTAPE));
+	if ( tape==NULL )
+		return NULL;
+	tape->writing = 1;
+	tape->time = (int64*)malloc(sizeof(int64)*BINARY_TAPE_BLOCK);
+	tape->fp = fopen(fname,"wb");
+	if ( tape->time==NULL || tape->fp==NULL )
+	{
+		int err = errno;
+		if ( tape->fp!=NULL )
+			fclose(tape->fp);
+		tape->fp = NULL;
+		binary_tape_close(tape);
+		errno = err;
+		return NULL;
+	}
+	return tape;
+}
+
+/** Add a name/value entry to the header, or replace the value of an existing one
+	@return 1 on success, 0 on failure
+ **/
+int binary_tape_set_info(BINARYTAPE *tape, const char *name, const char *value)
+{
+	char **info;
+	unsigned int n;
+	if ( tape->started )
+	{
+		sprintf(tape->lasterr,"info '%s' set after the header was written", name);
+		return 0;
+	}
+	for ( n=0 ; n<tape->n_info ; n++ )
+	{
+		if ( strcmp(tape->info[2*n],name)==0 )
+		{
+			char *copy = copy_string(value?value:"");
+			if ( copy==NULL )
+			{
+				sprintf(tape->lasterr,"out of memory");
+				return 0;
+			}
+			free(tape->info[2*n+1]);
+			tape->info[2*n+1] = copy;
+			return 1;
+		}
+	}
+	info = (char**)realloc(tape->info,sizeof(char*)*2*(tape->n_info+1));
+	if ( info==NULL )
+	{
+		sprintf(tape->lasterr,"out of memory");
+		return 0;
+	}
+	tape->info = info;
+	info[2*tape->n_info] = copy_string(name);
+	info[2*tape->n_info+1] = copy_string(value?value:"");
+	tape->n_info++;
+	if ( info[2*tape->n_info-2]==NULL || info[2*tape->n_info-1]==NULL )
+	{
+		sprintf(tape->lasterr,"out of memory");
+		return 0;
+	}
+	return 1;
+}
+
+/** Add a value column
+	@return the column index, or -1 on failure
+ **/
+int binary_tape_add_column(BINARYTAPE *tape, const char *name, const char *unit, const char *keywords, BINARYTYPE type)
+{
+	if ( tape->started )
+	{
+		sprintf(tape->lasterr,"column '%s' added after the header was written", name);
+		return -1;
+	}
+	if ( new_column(tape,copy_string(name),copy_string(unit?unit:""),copy_string(keywords?keywords:""),type)==NULL )
+	{
+		sprintf(tape->lasterr,"unable to add column '%s'", name);
+		return -1;
+	}
+	return (int)tape->n_columns-1;
+}
+
+/** Write the header
+	@return 1 on success, 0 on failure
+ **/
+int binary_tape_start(BINARYTAPE *tape)
+{
+	unsigned int i;
+	char magic[8] = BINARY_TAPE_MAGIC;
+	if ( tape->started )
+		return 1;
+	if ( fwrite(magic,1,sizeof(magic),tape->fp)!=sizeof(magic)
+		|| !write_varint(tape->fp,BINARY_TAPE_VERSION)
+		|| !write_varint(tape->fp,tape->n_info) )
+		goto Error;
+	for ( i=0 ; i<2*tape->n_info ; i++ )
+	{
+		if ( !write_string(tape->fp,tape->info[i]) )
+			goto Error;
+	}
+	if ( !write_varint(tape->fp,tape->n_columns) )
+		goto Error;
+	for ( i=0 ; i<tape->n_columns ; i++ )
+	{
+		BINARYCOLUMN *col = tape->column+i;
+		if ( !write_string(tape->fp,col->name) || !write_string(tape->fp,col->unit)
+			|| !write_string(tape->fp,col->keywords) || fputc(col->type,tape->fp)==EOF )
+			goto Error;
+	}
+	tape->started = 1;
+	return 1;
+Error:
+	sprintf(tape->lasterr,"header write failed: %s", strerror(errno));
+	return 0;
+}
+
+void binary_tape_put_double(BINARYTAPE *tape, unsigned int col, double value)
+{
+	tape->column[col].row.d = value;
+}
+
+void binary_tape_put_int64(BINARYTAPE *tape, unsigned int col, int64 value)
+{
+	tape->column[col].row.i = value;
+}
+
+void binary_tape_put_text(BINARYTAPE *tape, unsigned int col, const char *value)
+{
+	strncpy(tape->column[col].text_row,value,BINARY_TAPE_TEXTSIZE-1);
+}
+
+/** Compare the values put since the last hold with the held values
+	@return nonzero if any value differs or nothing has been held yet
+ **/
+int binary_tape_changed(BINARYTAPE *tape)
+{
+	unsigned int c;
+	if ( !tape->held )
+		return 1;
+	for ( c=0 ; c<tape->n_columns ; c++ )
+	{
+		BINARYCOLUMN *col = tape->column+c;
+		if ( col->type==BT_TEXT ? strcmp(col->text_row,col->text_held)!=0 : memcmp(&col->row,&col->held,sizeof(BINARYVALUE))!=0 )
+			return 1;
+	}
+	return 0;
+}
+
+/** Keep the values put so far as the row the next append writes
+ **/
+void binary_tape_hold(BINARYTAPE *tape)
+{
+	unsigned int c;
+	for ( c=0 ; c<tape->n_columns ; c++ )
+	{
+		BINARYCOLUMN *col = tape->column+c;
+		if ( col->type==BT_TEXT )
+			strcpy(col->text_held,col->text_row);
+		else
+			col->held = col->row;
+	}
+	tape->held = 1;
+}
+
+/** Append the held row at time \p ns (nanoseconds since the epoch)
+	@return 1 on success, 0 on failure
+ **/
+int binary_tape_append(BINARYTAPE *tape, int64 ns)
+{
+	unsigned int c, n = tape->n_rows;
+	if ( !tape->started && !binary_tape_start(tape) )
+		return 0;
+	if ( !tape->held )
+	{
+		sprintf(tape->lasterr,"no row held");
+		return 0;
+	}
+	tape->time[n] = ns;
+	for ( c=0 ; c<tape->n_columns ; c++ )
+	{
+		BINARYCOLUMN *col = tape->column+c;
+		switch ( col->type ) {
+		case BT_DOUBLE: col->data.d[n] = col->held.d; break;
+		case BT_INT64: col->data.i[n] = col->held.i; break;
+		case BT_TEXT:
+			col->data.s[n] = copy_string(col->text_held);
+			if ( col->data.s[n]==NULL )
+			{
+				sprintf(tape->lasterr,"out of memory");
+				return 0;
+			}
+			break;
+		default: break;
+		}
+	}
+	tape->n_rows++;
+	if ( tape->n_rows==BINARY_TAPE_BLOCK )
+		return write_block(tape);
+	return 1;
+}
+
+/** Write the rows appended so far as a block and flush the file
+	@return 1 on success, 0 on failure
+ **/
+int binary_tape_flush(BINARYTAPE *tape)
+{
+	if ( !tape->started && !binary_tape_start(tape) )
+		return 0;
+	return write_block(tape) && fflush(tape->fp)==0;
+}
+
+/** Open a binary tape for reading and load its header
+	@return the tape, or NULL with \p errno set
+ **/
+BINARYTAPE *binary_tape_open(const char *fname)
+{
+	char magic[8];
+	unsigned int64 version, n, i;
+	BINARYTAPE *tape = (BINARYTAPE*)calloc(1,sizeof(BINARYTAPE));
+	if ( tape==NULL )
+		return NULL;
+	tape->time = (int64*)malloc(sizeof(int64)*BINARY_TAPE_BLOCK);
+	tape->fp = fopen(fname,"rb");
+	if ( tape->time==NULL || tape->fp==NULL )
+		goto Error;
+	tape->started = 1;
+	if ( fread(magic,1,sizeof(magic),tape->fp)!=sizeof(magic) || memcmp(magic,BINARY_TAPE_MAGIC,sizeof(magic))!=0
+		|| read_varint(tape->fp,&version)!=1 || version>BINARY_TAPE_VERSION
+		|| read_varint(tape->fp,&n)!=1 || n>65536 )
+		goto Invalid;
+	tape->info = (char**)calloc((size_t)(2*n+1),sizeof(char*));
+	if ( tape->info==NULL )
+		goto Error;
+	for ( i=0 ; i<n ; i++ )
+	{
+		tape->n_info++;
+		if ( (tape->info[2*i]=read_string(tape->fp))==NULL || (tape->info[2*i+1]=read_string(tape->fp))==NULL )
+			goto Invalid;
+	}
+	if ( read_varint(tape->fp,&n)!=1 || n>1048576 )
+		goto Invalid;
+	for ( i=0 ; i<n ; i++ )
+	{
+		char *name = read_string(tape->fp);
+		char *unit = read_string(tape->fp);
+		char *keywords = read_string(tape->fp);
+		int type = fgetc(tape->fp);
+		if ( new_column(tape,name,unit,keywords,(BINARYTYPE)type)==NULL )
+			goto Invalid;
+	}
+	return tape;
+Invalid:
+	errno = EINVAL;
+Error:
+	{
+		int err = errno;
+		binary_tape_close(tape);
+		errno = err;
+	}
+	return NULL;
+}
+
+/** Read the next block of rows into the column data
+	@return the number of rows read, 0 at the end of the tape, -1 on error
+ **/
+int binary_tape_read(BINARYTAPE *tape)
+{
+	unsigned int64 n;
+	unsigned int c;
+	size_t len;
+	int rc;
+
+	free_text(tape,tape->n_rows);
+	tape->n_rows = 0;
+	rc = read_varint(tape->fp,&n);
+	if ( rc==0 || (rc==1 && n==0) )
+		return 0; /* end of tape (a missing end marker means the run was cut short) */
+	if ( rc<0 || n>BINARY_TAPE_BLOCK )
+		goto Error;
+	if ( read_column(tape,&len)!=BE_DELTA2 || !decode_delta(tape->buffer,tape->buffer+len,tape->time,(unsigned int)n,2) )
+		goto Error;
+	for ( c=0 ; c<tape->n_columns ; c++ )
+	{
+		BINARYCOLUMN *col = tape->column+c;
+		const unsigned char *p, *end;
+		int ok = 0;
+		int encoding = read_column(tape,&len);
+		p = tape->buffer;
+		end = p+len;
+		switch ( encoding ) {
+		case BE_RAW: ok = col->type!=BT_TEXT && decode_raw(p,end,col->data.d,(unsigned int)n); break;
+		case BE_DELTA: ok = col->type==BT_INT64 && decode_delta(p,end,col->data.i,(unsigned int)n,1); break;
+		case BE_DELTA2: ok = col->type==BT_INT64 && decode_delta(p,end,col->data.i,(unsigned int)n,2); break;
+		case BE_XOR: ok = col->type==BT_DOUBLE && decode_xor(p,end,col->data.d,(unsigned int)n); break;
+		case BE_TEXT: ok = col->type==BT_TEXT && decode_text(p,end,col->data.s,(unsigned int)n); break;
+		default: break;
+		}
+		if ( !ok )
+		{
+			free_text(tape,(unsigned int)n);
+			goto Error;
+		}
+	}
+	tape->n_rows = (unsigned int)n;
+	return (int)n;
+Error:
+	sprintf(tape->lasterr,"block is damaged or truncated");
+	return -1;
+}
+
+/** @return the value of header info \p name, or NULL if none
+ **/
+const char *binary_tape_get_info(BINARYTAPE *tape, const char *name)
+{
+	unsigned int i;
+	for ( i=0 ; i<tape->n_info ; i++ )
+	{
+		if ( tape->info[2*i]!=NULL && strcmp(tape->info[2*i],name)==0 )
+			return tape->info[2*i+1];
+	}
+	return NULL;
+}
+
+/** Close a tape.  A tape being written gets its last block and the end
+	marker first.
+	@return 1 on success, 0 if the final write failed
+ **/
+int binary_tape_close(BINARYTAPE *tape)
+{
+	int ok = 1;
+	unsigned int i;
+	if ( tape==NULL )
+		return 1;
+	if ( tape->fp!=NULL )
+	{
+		if ( tape->writing )
+			ok = (tape->started || binary_tape_start(tape)) && write_block(tape) && write_varint(tape->fp,0);
+		if ( fclose(tape->fp)!=0 )
+			ok = 0;
+	}
+	free_text(tape,BINARY_TAPE_BLOCK);
+	for ( i=0 ; i<2*tape->n_info ; i++ )
+		free(tape->info[i]);
+	free(tape->info);
+	for ( i=0 ; i<tape->n_columns ; i++ )
+	{
+		BINARYCOLUMN *col = tape->column+i;
+		free(col->name);
+		free(col->unit);
+		free(col->keywords);
+		free(col->text_row);
+		free(col->text_held);
+		free(col->data.d);
+	}
+	free(tape->column);
+	free(tape->time);
+	free(tape->buffer);
+	free(tape);
+	return ok;
+}
@@ -0,0 +1,128 @@
+/* $Id$
+ *	Copyright (C) 2008 Battelle Memorial Institute
+ */
+
+#ifndef _BINARY_H
+#define _BINARY_H
+
+#include <stdio.h>
+#include "platform.h"
+
+/** @addtogroup binary_tape Binary tapes
+	@ingroup tapes
+
+	Binary tapes are a columnar alternative to the CSV output of the
+	recorder, group_recorder and multi_recorder.  A recorder writes one
+	when its file name ends in \p BINARY_TAPE_EXT.
+
+	The file starts with a header holding the magic string, the format
+	version, a list of name/value info entries (the same information the
+	CSV header lines carry) and the column list (name, unit, type and the
+	enumeration keywords, if any).  Samples follow in blocks of up to
+	\p BINARY_TAPE_BLOCK rows.  Each block stores the timestamp column
+	(int64 nanoseconds since the epoch) and then every value column,
+	each with its own encoding so that a column can pick the smallest
+	representation for that block:
+	- timestamps are delta-of-delta varints, so a fixed interval costs
+	  one byte per row;
+	- integers are either raw or zigzag delta varints;
+	- doubles are either raw or XORed with the previous value and trimmed
+	  of leading and trailing zero bytes;
+	- text is length prefixed, with a zero length meaning "same as the
+	  previous row".
+	Every block restarts its encoders, so a truncated file can be read up
+	to the last complete block.  A block of zero rows ends the tape.
+
+	All numbers are little-endian regardless of the host.
+ @{
+ **/
+
+#define BINARY_TAPE_MAGIC "GLDTAPE" /**< first 8 bytes of the file (including the NUL) */
+#define BINARY_TAPE_VERSION 1 /**< format version written to the header */
+#define BINARY_TAPE_EXT ".gbt" /**< file extension that selects binary output */
+#define BINARY_TAPE_BLOCK 4096 /**< maximum number of rows per block */
+#define BINARY_TAPE_TEXTSIZE 1024 /**< maximum length of a text value */
+
+typedef enum {
+	BT_DOUBLE=1, /**< double precision value */
+	BT_INT64=2, /**< integer value (also enumerations, sets, bools and timestamps) */
+	BT_TEXT=3 /**< anything else, as the core formats it */
+} BINARYTYPE;
+
+typedef enum {
+	BE_RAW=0, /**< 8 bytes per value */
+	BE_DELTA=1, /**< zigzag varint of the difference from the previous value */
+	BE_DELTA2=2, /**< zigzag varint of the difference between successive deltas */
+	BE_XOR=3, /**< previous value XORed, with zero bytes trimmed */
+	BE_TEXT=4 /**< length prefixed strings, 0 repeats the previous string */
+} BINARYENCODING;
+
+typedef union {
+	double d;
+	int64 i;
+} BINARYVALUE;
+
+typedef struct s_binarycolumn {
+	char *name;
+	char *unit; /**< unit name, or "" */
+	char *keywords; /**< "NAME=value|..." for enumerations, or "" */
+	BINARYTYPE type;
+	BINARYVALUE row; /**< the value most recently put */
+	BINARYVALUE held; /**< the value that will be appended */
+	char *text_row, *text_held; /**< text values (BT_TEXT only) */
+	union {
+		double *d;
+		int64 *i;
+		char **s;
+	} data; /**< block storage */
+} BINARYCOLUMN;
+
+typedef struct s_binarytape {
+	FILE *fp;
+	int writing; /**< nonzero when the tape was created rather than opened */
+	unsigned int n_info;
+	char **info; /**< name/value pairs */
+	unsigned int n_columns;
+	BINARYCOLUMN *column;
+	int64 *time; /**< block timestamps (ns) */
+	unsigned int n_rows; /**< rows in the current block */
+	int held; /**< nonzero once a row has been held */
+	int started; /**< nonzero once the header is written */
+	unsigned char *buffer; /**< encoder/decoder scratch */
+	size_t buffer_size;
+	char lasterr[1024];
+} BINARYTAPE;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int binary_tape_match(const char *fname);
+
+/* writing */
+BINARYTAPE *binary_tape_create(const char *fname);
+int binary_tape_set_info(BINARYTAPE *tape, const char *name, const char *value);
+int binary_tape_add_column(BINARYTAPE *tape, const char *name, const char *unit, const char *keywords, BINARYTYPE type);
+int binary_tape_start(BINARYTAPE *tape);
+void binary_tape_put_double(BINARYTAPE *tape, unsigned int col, double value);
+void binary_tape_put_int64(BINARYTAPE *tape, unsigned int col, int64 value);
+void binary_tape_put_text(BINARYTAPE *tape, unsigned int col, const char *value);
+int binary_tape_changed(BINARYTAPE *tape);
+void binary_tape_hold(BINARYTAPE *tape);
+int binary_tape_append(BINARYTAPE *tape, int64 ns);
+int binary_tape_flush(BINARYTAPE *tape);
+
+/* reading */
+BINARYTAPE *binary_tape_open(const char *fname);
+int binary_tape_read(BINARYTAPE *tape);
+const char *binary_tape_get_info(BINARYTAPE *tape, const char *name);
+
+int binary_tape_close(BINARYTAPE *tape);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**@}*/
+
+#endif
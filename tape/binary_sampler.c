@@ -0,0 +1,249 @@
+/* $Id$
+ *	Copyright (C) 2008 Battelle Memorial Institute
+ *
+ *	Binds object properties to the columns of a binary tape.  Values are
+ *	read straight from the object data, so unlike the CSV path no text is
+ *	formatted for numeric properties.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <math.h>
+#include <time.h>
+
+#include "gridlabd.h"
+#include "tape.h"
+
+/** Create a binary tape and fill in the header info common to all recorders
+	@return the sampler, or NULL on failure
+ **/
+BINARYSAMPLER *binary_sampler_open(OBJECT *obj, char *fname)
+{
+	time_t now = time(NULL);
+	char buffer[1024], *eol;
+	BINARYSAMPLER *bs = (BINARYSAMPLER*)malloc(sizeof(BINARYSAMPLER));
+	if ( bs==NULL )
+	{
+		gl_error("binary tape %s: out of memory", fname);
+		return NULL;
+	}
+	memset(bs,0,sizeof(BINARYSAMPLER));
+	bs->tape = binary_tape_create(fname);
+	if ( bs->tape==NULL )
+	{
+		gl_error("binary tape %s: %s", fname, strerror(errno));
+		free(bs);
+		return NULL;
+	}
+	binary_tape_set_info(bs->tape,"file",fname);
+	strncpy(buffer,asctime(localtime(&now)),sizeof(buffer)-1);
+	buffer[sizeof(buffer)-1] = '\0';
+	if ( (eol=strchr(buffer,'\n'))!=NULL )
+		*eol = '\0';
+	binary_tape_set_info(bs->tape,"date",buffer);
+#ifdef WIN32
+	binary_tape_set_info(bs->tape,"user",getenv("USERNAME"));
+	binary_tape_set_info(bs->tape,"host",getenv("MACHINENAME"));
+#else
+	binary_tape_set_info(bs->tape,"user",getenv("USER"));
+	binary_tape_set_info(bs->tape,"host",getenv("HOST"));
+#endif
+	if ( gl_name_object(obj,buffer,sizeof(buffer))>0 )
+		binary_tape_set_info(bs->tape,"source",buffer);
+	if ( gl_global_getvar("double_format",buffer,sizeof(buffer))!=NULL )
+		binary_tape_set_info(bs->tape,"double_format",buffer);
+	return bs;
+}
+
+static int add_source(BINARYSAMPLER *bs, OBJECT *obj, PROPERTY *prop, char *name, CPLPT part, BINARYTYPE type, char *keywords)
+{
+	char unit[256] = "";
+	int column;
+	BINARYSOURCE *src;
+	PROPERTY *native = gl_get_property(obj,prop->name,NULL);
+
+	/* report values in the requested unit, or in the property's own unit */
+	if ( prop->unit!=NULL )
+		strncpy(unit,prop->unit->name,sizeof(unit)-1);
+	else if ( native!=NULL && native->unit!=NULL )
+		strncpy(unit,native->unit->name,sizeof(unit)-1);
+
+	column = binary_tape_add_column(bs->tape,name,unit,keywords,type);
+	if ( column<0 )
+	{
+		gl_error("binary tape: %s", bs->tape->lasterr);
+		return 0;
+	}
+	src = (BINARYSOURCE*)malloc(sizeof(BINARYSOURCE));
+	if ( src==NULL )
+	{
+		gl_error("binary tape: out of memory");
+		return 0;
+	}
+	src->obj = obj;
+	src->prop = prop;
+	src->from = (type==BT_DOUBLE && prop->unit!=NULL && native!=NULL && native->unit!=NULL && native->unit!=prop->unit) ? native->unit : NULL;
+	src->part = part;
+	src->column = (unsigned int)column;
+	src->next = NULL;
+	if ( bs->first==NULL )
+		bs->first = src;
+	else
+		bs->last->next = src;
+	bs->last = src;
+	return 1;
+}
+
+/** Add the columns for a property.  Complex values are split into .real
+	and .imag columns unless \p part picks a single part.  Enumerations
+	and bools keep their keywords in the header so the converter can print
+	them by name.
+	@return 1 on success, 0 on failure
+ **/
+int binary_sampler_add(BINARYSAMPLER *bs, OBJECT *obj, PROPERTY *prop, char *name, CPLPT part)
+{
+	char keywords[1024] = "";
+	char column[1024];
+	KEYWORD *key;
+	size_t len = 0;
+
+	switch ( prop->ptype ) {
+	case PT_double:
+	case PT_float:
+		return add_source(bs,obj,prop,name,NONE,BT_DOUBLE,"");
+	case PT_complex:
+		if ( part!=NONE )
+			return add_source(bs,obj,prop,name,part,BT_DOUBLE,"");
+		sprintf(column,"%.1000s.real",name);
+		if ( !add_source(bs,obj,prop,column,REAL,BT_DOUBLE,"") )
+			return 0;
+		sprintf(column,"%.1000s.imag",name);
+		return add_source(bs,obj,prop,column,IMAG,BT_DOUBLE,"");
+	case PT_bool:
+		return add_source(bs,obj,prop,name,NONE,BT_INT64,"FALSE=0|TRUE=1");
+	case PT_enumeration:
+		for ( key=prop->keywords ; key!=NULL ; key=key->next )
+		{
+			int n = snprintf(keywords+len,sizeof(keywords)-len,"%s%s=%" FMT_INT64 "u", len>0?"|":"", key->name, key->value);
+			if ( n<0 || len+n>=sizeof(keywords) )
+			{
+				keywords[len] = '\0';
+				break;
+			}
+			len += n;
+		}
+		return add_source(bs,obj,prop,name,NONE,BT_INT64,keywords);
+	case PT_int16:
+	case PT_int32:
+	case PT_int64:
+	case PT_timestamp:
+		return add_source(bs,obj,prop,name,NONE,BT_INT64,"");
+	default:
+		return add_source(bs,obj,prop,name,NONE,BT_TEXT,"");
+	}
+}
+
+/* convert a value from the property's unit to the unit requested for its column */
+static int convert_unit(BINARYSOURCE *src, double *value)
+{
+	if ( src->from!=NULL && gl_convert_ex(src->from,src->prop->unit,value)==0 )
+	{
+		gl_error("binary tape: unable to convert %s to %s", src->from->name, src->prop->unit->name);
+		return 0;
+	}
+	return 1;
+}
+
+/** Read the current value of every source into the tape's row
+	@return 1 on success, 0 on failure
+ **/
+int binary_sampler_read(BINARYSAMPLER *bs)
+{
+	BINARYSOURCE *src;
+	for ( src=bs->first ; src!=NULL ; src=src->next )
+	{
+		void *addr = GETADDR(src->obj,src->prop);
+		double value;
+		complex *c;
+		switch ( src->prop->ptype ) {
+		case PT_double:
+			value = *(double*)addr;
+			if ( !convert_unit(src,&value) )
+				return 0;
+			binary_tape_put_double(bs->tape,src->column,value);
+			break;
+		case PT_float:
+			binary_tape_put_double(bs->tape,src->column,*(float*)addr);
+			break;
+		case PT_complex:
+			c = (complex*)addr;
+			switch ( src->part ) {
+			case IMAG: value = c->i; break;
+			case MAG: value = sqrt(c->r*c->r+c->i*c->i); break;
+			case ANG: value = atan2(c->i,c->r)*180/PI; break;
+			case ANG_RAD: value = atan2(c->i,c->r); break;
+			default: value = c->r; break;
+			}
+			if ( src->part!=ANG && src->part!=ANG_RAD && !convert_unit(src,&value) )
+				return 0;
+			binary_tape_put_double(bs->tape,src->column,value);
+			break;
+		case PT_bool:
+			binary_tape_put_int64(bs->tape,src->column,*(bool*)addr?1:0);
+			break;
+		case PT_enumeration:
+			binary_tape_put_int64(bs->tape,src->column,*(enumeration*)addr);
+			break;
+		case PT_int16:
+			binary_tape_put_int64(bs->tape,src->column,*(int16*)addr);
+			break;
+		case PT_int32:
+			binary_tape_put_int64(bs->tape,src->column,*(int32*)addr);
+			break;
+		case PT_int64:
+		case PT_timestamp:
+			binary_tape_put_int64(bs->tape,src->column,*(int64*)addr);
+			break;
+		default:
+			{
+				char buffer[BINARY_TAPE_TEXTSIZE];
+				if ( gl_get_value(src->obj,addr,buffer,sizeof(buffer)-1,src->prop)==0 )
+				{
+					gl_error("binary tape: unable to read %s", src->prop->name);
+					return 0;
+				}
+				binary_tape_put_text(bs->tape,src->column,buffer);
+			}
+			break;
+		}
+	}
+	return 1;
+}
+
+/** Append the held row at \p ts seconds plus \p ns nanoseconds
+	@return 1 on success, 0 on failure
+ **/
+int binary_sampler_write(BINARYSAMPLER *bs, TIMESTAMP ts, int64 ns)
+{
+	if ( !binary_tape_append(bs->tape,ts*1000000000+ns) )
+	{
+		gl_error("binary tape: %s", bs->tape->lasterr);
+		return 0;
+	}
+	return 1;
+}
+
+void binary_sampler_close(BINARYSAMPLER *bs)
+{
+	BINARYSOURCE *src = bs->first;
+	if ( !binary_tape_close(bs->tape) )
+		gl_error("binary tape: unable to write the end of the tape");
+	while ( src!=NULL )
+	{
+		BINARYSOURCE *next = src->next;
+		free(src);
+		src = next;
+	}
+	free(bs);
+}
@@ -51,6 +51,7 @@ group_recorder::group_recorder(MODULE *mod){
 int group_recorder::create(){
 	memcpy(this, defaults, sizeof(group_recorder));
 	deltamode_gr = false;
+	binary = NULL;
 	return 1;
 }
 
@@ -134,19 +135,21 @@ int group_recorder::init(OBJECT *obj){
 		}
 	}
 	
-	// open file
-	rec_file = fopen(filename.get_string(), "w");
-	if(0 == rec_file){
-		if(strict){
-			gl_error("group_recorder::init(): unable to open file '%s' for writing", filename.get_string());
-			return 0;
-		} else {
-			gl_warning("group_recorder::init(): unable to open file '%s' for writing", filename.get_string());
-			/* TROUBLESHOOT
-				If the group_recorder cannot open the specified output file, it will 
-			 */
-			tape_status = TS_ERROR;
-			return 1;
+	// open file (binary tapes are opened once the columns are known)
+	if(!binary_tape_match(filename.get_string())){
+		rec_file = fopen(filename.get_string(), "w");
+		if(0 == rec_file){
+			if(strict){
+				gl_error("group_recorder::init(): unable to open file '%s' for writing", filename.get_string());
+				return 0;
+			} else {
+				gl_warning("group_recorder::init(): unable to open file '%s' for writing", filename.get_string());
+				/* TROUBLESHOOT
+					If the group_recorder cannot open the specified output file, it will 
+				 */
+				tape_status = TS_ERROR;
+				return 1;
+			}
 		}
 	}
 
@@ -178,6 +181,17 @@ int group_recorder::init(OBJECT *obj){
 		}
 	}
 
+	if(binary_tape_match(filename.get_string()) && 0 == open_binary()){
+		if(strict){
+			gl_error("group_recorder::init(): unable to open binary tape '%s' for writing", filename.get_string());
+			return 0;
+		} else {
+			gl_warning("group_recorder::init(): unable to open binary tape '%s' for writing", filename.get_string());
+			tape_status = TS_ERROR;
+			return 1;
+		}
+	}
+
 	tape_status = TS_OPEN;
 	if(0 == write_header()){
 		gl_error("group_recorder::init(): an error occured when writing the file header");
@@ -312,7 +326,7 @@ int group_recorder::commit(TIMESTAMP t1, double t1dbl, bool deltacall){
 				gl_error("group_recorder::commit(): error when reading the values");
 				return 0;
 			}
-			if(0 != strcmp(line_buffer, prev_line_buffer) ){
+			if( binary ? binary_tape_changed(binary->tape) : 0 != strcmp(line_buffer, prev_line_buffer) ){
 				if(0 == write_line(t1,t1dbl,deltacall)){
 					gl_error("group_recorder::commit(): error when writing the values to the file");
 					return 0;
@@ -337,7 +351,12 @@ int group_recorder::commit(TIMESTAMP t1, double t1dbl, bool deltacall){
 	if(limit > 0 && write_count >= limit){
 		// write footer
 		write_footer();
-		fclose(rec_file);
+		if(binary){
+			binary_sampler_close(binary);
+			binary = NULL;
+		} else {
+			async_close(rec_file);
+		}
 		rec_file = 0;
 		free(line_buffer);
 		line_buffer = 0;
@@ -362,6 +381,47 @@ int group_recorder::isa(char *classname){
 	return (strcmp(classname, oclass->name) == 0);
 }
 
+/**
+	Binary tapes buffer whole blocks, so an open tape is closed at the end of the run.
+	@return 1 always
+ **/
+int group_recorder::finalize(){
+	if(binary){
+		binary_sampler_close(binary);
+		binary = NULL;
+	}
+	return 1;
+}
+
+/**
+	Creates the binary tape and one column per object.  The column names
+	match the CSV header.
+	@return 0 on failure, 1 on success
+ **/
+int group_recorder::open_binary(){
+	quickobjlist *qol = 0;
+	char name[256];
+
+	binary = binary_sampler_open(OBJECTHDR(this), filename.get_string());
+	if(0 == binary){
+		return 0;
+	}
+	for(qol = obj_list; qol != 0; qol = qol->next){
+		if(0 != qol->obj->name){
+			strncpy(name, qol->obj->name, sizeof(name)-1);
+			name[sizeof(name)-1] = 0;
+		} else {
+			sprintf(name, "%.200s:%i", qol->obj->oclass->name, qol->obj->id);
+		}
+		if(0 == binary_sampler_add(binary, qol->obj, &(qol->prop), name, complex_part)){
+			binary_sampler_close(binary);
+			binary = NULL;
+			return 0;
+		}
+	}
+	return 1;
+}
+
 /**
 	@return 0 on failure, 1 on success
  **/
@@ -375,6 +435,25 @@ int group_recorder::write_header(){
 		// could be ERROR or CLOSED
 		return 0;
 	}
+	if(binary){
+		char buffer[64];
+		binary_tape_set_info(binary->tape, "group", group_def.get_string());
+		binary_tape_set_info(binary->tape, "property", property_name.get_string());
+		sprintf(buffer, "%d", limit);
+		binary_tape_set_info(binary->tape, "limit", buffer);
+		sprintf(buffer, "%" FMT_INT64 "d", write_interval);
+		binary_tape_set_info(binary->tape, "interval", buffer);
+		binary_tape_set_info(binary->tape, "format", format ? "1" : "0");
+		if(NONE != complex_part){
+			// read_line() prints complex parts as %f, not in the double_format
+			binary_tape_set_info(binary->tape, "double_format", "%f");
+		}
+		if(0 == binary_tape_start(binary->tape)){
+			gl_error("group_recorder::write_header(): %s", binary->tape->lasterr);
+			return 0;
+		}
+		return 1;
+	}
 	if(0 == rec_file){
 		gl_error("group_recorder::write_header(): the output file was not opened");
 		/* TROUBLESHOOT
@@ -428,6 +507,11 @@ int group_recorder::read_line(){
 		return 0;
 	}
 
+	// binary tapes sample the values directly and keep their own copy of the last row
+	if(binary){
+		return binary_sampler_read(binary);
+	}
+
 	// pre-calculate buffer needs
 	if(line_size <= 0 || line_buffer == 0){
 		size_t prop_size;
@@ -541,7 +625,7 @@ int group_recorder::write_line(TIMESTAMP t1, double t1dbl, bool deltacall){
 		// could be ERROR or CLOSED, should not have happened
 		return 0;
 	}
-	if(0 == rec_file){
+	if(0 == rec_file && 0 == binary){
 		gl_error("group_recorder::write_line(): no output file open and state is 'open'");
 		/* TROUBLESHOOT
 			group_recorder claimed to be open and attempted to write to a file when
@@ -551,6 +635,22 @@ int group_recorder::write_line(TIMESTAMP t1, double t1dbl, bool deltacall){
 		return 0;
 	}
 
+	// binary tapes keep the raw time in nanoseconds, whatever the format
+	if(binary){
+		int64 ns = 0;
+		if(deltacall){
+			t1 = (TIMESTAMP)floor(t1dbl);
+			ns = (int64)((t1dbl - (double)t1) * 1e9 + 0.5);
+		}
+		binary_tape_hold(binary->tape);
+		if(0 == binary_sampler_write(binary, t1, ns)){
+			tape_status = TS_ERROR;
+			return 0;
+		}
+		++write_count;
+		return 1;
+	}
+
 	// check that buffer needs were pre-calculated
 	if(line_size <= 0 || line_buffer == 0){
 		gl_error("group_recorder::write_line(): output buffer not initialized (read_line() not called)");
@@ -611,7 +711,7 @@ int group_recorder::write_line(TIMESTAMP t1, double t1dbl, bool deltacall){
 	}
 
 	// print line to file
-	if(0 >= fprintf(rec_file, "%s%s\n", time_str, line_buffer)){
+	if(0 >= async_printf(rec_file, "%s%s\n", time_str, line_buffer)){
 		gl_error("group_recorder::write_line(): error when writing to the output file");
 		/* TROUBLESHOOT
 			File I/O error.
@@ -633,6 +733,14 @@ int group_recorder::flush_line(){
 		// could be ERROR or CLOSED, should not have happened
 		return 0;
 	}
+	if(binary){
+		if(0 == binary_tape_flush(binary->tape)){
+			gl_error("group_recorder::flush_line(): %s", binary->tape->lasterr);
+			tape_status = TS_ERROR;
+			return 0;
+		}
+		return 1;
+	}
 	if(0 == rec_file){
 		gl_error("group_recorder::flush_line(): output file is not open");
 		/* TROUBLESHOOT
@@ -642,7 +750,7 @@ int group_recorder::flush_line(){
 		tape_status = TS_ERROR;
 		return 0;
 	}
-	if(0 != fflush(rec_file)){
+	if(0 != async_flush(rec_file)){
 		gl_error("group_recorder::flush_line(): unable to flush output file");
 		/* TROUBLESHOOT
 			An IO error has occured.
@@ -662,6 +770,10 @@ int group_recorder::write_footer(){
 		// could be ERROR or CLOSED, should not have happened
 		return 0;
 	}
+	if(binary){
+		// the end of a binary tape is written when it is closed
+		return 1;
+	}
 	if(0 == rec_file){
 		gl_error("group_recorder::write_footer(): output file is not open");
 		/* TROUBLESHOOT
@@ -673,7 +785,7 @@ int group_recorder::write_footer(){
 	}
 
 	// not a lot to this one.
-	if(0 >= fprintf(rec_file, "# end of file\n")){ return 0; }
+	if(0 >= async_printf(rec_file, "# end of file\n")){ return 0; }
 
 	return 1;
 }
@@ -761,6 +873,11 @@ EXPORT int commit_group_recorder(OBJECT *obj){
 	return rv;
 }
 
+EXPORT STATUS finalize_group_recorder(OBJECT *obj){
+	group_recorder *my = OBJECTDATA(obj, group_recorder);
+	return my->finalize() ? SUCCESS : FAILED;
+}
+
 EXPORT int isa_group_recorder(OBJECT *obj, char *classname)
 {
 	return OBJECTDATA(obj, group_recorder)->isa(classname);
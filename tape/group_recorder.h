@@ -50,8 +50,12 @@ private:
 	int write_line(TIMESTAMP t1, double t1dbl, bool deltacall);
 	int flush_line();
 	int write_footer();
+	int open_binary();
+public:
+	int finalize();
 private:
 	FILE *rec_file;
+	BINARYSAMPLER *binary; // non-NULL when writing a binary tape instead of rec_file
 	FINDLIST *items;
 	quickobjlist *obj_list;
 	PROPERTY *prop_ptr;
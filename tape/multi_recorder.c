@@ -108,11 +108,67 @@ EXPORT int create_multi_recorder(OBJECT **obj, OBJECT *parent)
 		my->target = gl_get_property(*obj,my->property,NULL);
 		my->header_units = HU_DEFAULT;
 		my->line_units = LU_DEFAULT;
+		my->binary = NULL;
 		return 1;
 	}
 	return 0;
 }
 
+/* binary tapes are written by the recorder itself rather than a tape_<mode> library */
+static int multi_recorder_open_binary(OBJECT *obj, char *fname)
+{
+	struct recorder *my = OBJECTDATA(obj,struct recorder);
+	BINARYTAPE *tape;
+	RECORDER_MAP *rmap = my->rmap;
+	char1024 list;
+	char buffer[64];
+	char *item;
+
+	if ( my->multifile[0]!='\0' )
+	{
+		gl_error("multi_recorder:%d: multi-run output files cannot be binary tapes", obj->id);
+		return 0;
+	}
+	my->binary = binary_sampler_open(obj,fname);
+	if ( my->binary==NULL )
+		return 0;
+	tape = my->binary->tape;
+	binary_tape_set_info(tape,"trigger",my->trigger[0]=='\0'?"(none)":my->trigger);
+	sprintf(buffer,"%" FMT_INT64 "d",my->interval);
+	binary_tape_set_info(tape,"interval",buffer);
+	sprintf(buffer,"%d",my->limit);
+	binary_tape_set_info(tape,"limit",buffer);
+	binary_tape_set_info(tape,"property",my->property);
+	binary_tape_set_info(tape,"format",my->format?"1":"0");
+
+	/* name the columns as they appear in the property list, less any unit */
+	strcpy(list,my->property);
+	for (item=strtok(list,","); item!=NULL && rmap!=NULL; item=strtok(NULL,","), rmap=rmap->next)
+	{
+		char *unit;
+		while (isspace(*item)) item++;
+		if ( (unit=strchr(item,'['))!=NULL )
+			*unit = '\0';
+		if ( !binary_sampler_add(my->binary,rmap->obj,&(rmap->prop),item,NONE) )
+			return 0;
+	}
+	if ( !binary_tape_start(tape) )
+	{
+		gl_error("multi_recorder:%d: %s", obj->id, tape->lasterr);
+		return 0;
+	}
+
+	/* the sample taken before the tape opened is written next */
+	if ( !binary_sampler_read(my->binary) )
+		return 0;
+	binary_tape_hold(tape);
+	my->type = FT_FILE;
+	my->last.ts = TS_ZERO;
+	my->status = TS_OPEN;
+	my->samples = 0;
+	return 1;
+}
+
 static int multi_recorder_open(OBJECT *obj)
 {
 	char32 type="file";
@@ -136,6 +192,9 @@ static int multi_recorder_open(OBJECT *obj)
 		/* use object name-id as default file name */
 		sprintf(fname,"%s-%d.%s",obj->parent->oclass->name,obj->parent->id, my->filetype);
 
+	if ( strcmp(type,"file")==0 && binary_tape_match(fname) )
+		return multi_recorder_open_binary(obj,fname);
+
 	/* open multiple-run input file & temp output file */
 	if(my->type == FT_FILE && my->multifile[0] != 0){
 		if(my->interval < 1){
@@ -450,6 +509,10 @@ static void close_multi_recorder(struct recorder *my)
 	if (my->ops){
 		my->ops->close(my);
 	}
+	if (my->binary){
+		binary_sampler_close(my->binary);
+		my->binary = NULL;
+	}
 	if(my->multifp){
 		if(0 != fclose(my->multifp)){
 			gl_error("multirecorder: unable to close multi-run temp file \'%s\'", my->multitempfile);
@@ -477,6 +540,19 @@ static TIMESTAMP multi_recorder_write(OBJECT *obj)
 {
 	struct recorder *my = OBJECTDATA(obj,struct recorder);
 	char ts[64]="0"; /* 0 = INIT */
+	if (my->binary!=NULL)
+	{
+		/* binary tapes keep the raw timestamp and have no multi-run file */
+		if ((my->limit>0 && my->samples > my->limit) /* limit reached */
+			|| binary_sampler_write(my->binary, my->last.ts, 0)==0) /* write failed */
+		{
+			close_multi_recorder(my);
+			my->status = TS_DONE;
+		}
+		else
+			my->samples++;
+		return TS_NEVER;
+	}
 	if (my->format==0)
 	{
 		if (my->last.ts>TS_ZERO)
@@ -602,7 +678,7 @@ RECORDER_MAP *link_multi_properties(OBJECT *obj, char *property_list)
 
 		// everything that looks like a property name, then read units up to ]
 		while (isspace(*item)) item++;
-		if(2 == sscanf(item,"%[A-Za-z0-9_.][%[^]\n,\0]", pstr, ustr)){
+		if(2 == sscanf(item,"%[A-Za-z0-9_.][%[^]\n,]", pstr, ustr)){
 			unit = gl_find_unit(ustr);
 			if(unit == NULL){
 				gl_error("multirecorder: unable to find unit '%s' for property '%s' in object '%s %i'", ustr,pstr,target_obj->oclass->name, target_obj->id);
@@ -719,6 +795,31 @@ int read_multi_properties(struct recorder *my, OBJECT *obj, RECORDER_MAP *rmap,
 	return count;
 }
 
+/* Binary tapes sample typed values instead of text.  Unless a trigger needs
+   the text, the buffer only gets a marker that matches last.value exactly
+   when the values are unchanged since they were last held. */
+static int multi_recorder_read(struct recorder *my, OBJECT *obj, char *buffer, int size)
+{
+	if (my->binary==NULL)
+		return read_multi_properties(my,obj,my->rmap,buffer,size);
+	if (binary_sampler_read(my->binary)==0)
+		return 0;
+	if (my->trigger[0]!='\0')
+		return read_multi_properties(my,obj,my->rmap,buffer,size);
+	if (binary_tape_changed(my->binary->tape))
+		strcpy(buffer, my->last.value[0]=='+' ? "-" : "+");
+	else
+		strcpy(buffer, my->last.value[0]!='\0' ? my->last.value : "=");
+	return 1;
+}
+
+static void multi_recorder_hold(struct recorder *my, char *buffer)
+{
+	strncpy(my->last.value,buffer,sizeof(my->last.value));
+	if (my->binary!=NULL)
+		binary_tape_hold(my->binary->tape);
+}
+
 EXPORT TIMESTAMP sync_multi_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 {
 	struct recorder *my = OBJECTDATA(obj,struct recorder);
@@ -779,7 +880,7 @@ EXPORT TIMESTAMP sync_multi_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 
 	/* update property value */
 	if ((my->rmap != NULL) && (my->interval == 0 || my->interval == -1)){	
-		if(read_multi_properties(my, obj->parent,my->rmap,buffer,sizeof(buffer))==0) // vestigal use of parent
+		if(multi_recorder_read(my, obj->parent,buffer,sizeof(buffer))==0) // vestigal use of parent
 		{
 			//sprintf(buffer,"unable to read property '%s' of %s %d", my->property, obj->parent->oclass->name, obj->parent->id);
 			sprintf(buffer,"unable to read a property");
@@ -789,7 +890,7 @@ EXPORT TIMESTAMP sync_multi_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 	}
 	if ((my->rmap != NULL) && (my->interval > 0)){
 		if((t0 >=my->last.ts + my->interval) || (t0 == my->last.ts)){
-			if(read_multi_properties(my, obj->parent,my->rmap,buffer,sizeof(buffer))==0)
+			if(multi_recorder_read(my, obj->parent,buffer,sizeof(buffer))==0)
 			{
 				//sprintf(buffer,"unable to read property '%s' of %s %d", my->property, obj->parent->oclass->name, obj->parent->id);
 				sprintf(buffer,"unable to read a property");
@@ -831,11 +932,11 @@ EXPORT TIMESTAMP sync_multi_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 			)
 
 		{
-			strncpy(my->last.value,buffer,sizeof(my->last.value));
+			multi_recorder_hold(my,buffer);
 			my->last.ts = t0;
 			multi_recorder_write(obj);
 		} else if (my->interval > 0 && my->last.ts == t0){
-			strncpy(my->last.value,buffer,sizeof(my->last.value));
+			multi_recorder_hold(my,buffer);
 		}
 	}
 Error:
@@ -857,4 +958,17 @@ Error:
 	}
 }
 
+EXPORT STATUS finalize_multi_recorder(OBJECT *obj)
+{
+	struct recorder *my = OBJECTDATA(obj,struct recorder);
+
+	/* binary tapes buffer whole blocks, so they must be closed before exit */
+	if (my->binary!=NULL)
+	{
+		binary_sampler_close(my->binary);
+		my->binary = NULL;
+	}
+	return SUCCESS;
+}
+
 /**@}*/
@@ -75,7 +75,7 @@ PROPERTY *player_link_properties(struct player *player, OBJECT *obj, char *prope
 
 		// everything that looks like a property name, then read units up to ]
 		while (isspace(*item)) item++;
-		if(2 == sscanf(item,"%[A-Za-z0-9_.][%[^]\n,\0]", pstr, ustr)){
+		if(2 == sscanf(item,"%[A-Za-z0-9_.][%[^]\n,]", pstr, ustr)){
 			unit = gl_find_unit(ustr);
 			if(unit == NULL){
 				gl_error("sync_player:%d: unable to find unit '%s' for property '%s'",obj->id, ustr,pstr);
@@ -178,6 +178,8 @@ EXPORT int create_player(OBJECT **obj, OBJECT *parent)
 		my->delta_track.ns = 0;
 		my->delta_track.ts = TS_NEVER;
 		my->delta_track.value[0] = '\0';
+		my->cache = NULL;
+		my->cache_pos = 0;
 		return 1;
 	}
 	return 0;
@@ -217,6 +219,10 @@ static int player_open(OBJECT *obj)
 	/* access the input stream to the player */
 	if ( (my->ops->open)(my, fname, flags)==1 )
 	{
+		/* use the compiled form of plain files */
+		if ( my->type==FT_FILE && my->fp!=stdin )
+			my->cache = player_cache_open(my, fname);
+
 		/* set up the delta_mode recorder if enabled */
 		if ( (obj->flags)&OF_DELTAMODE )
 		{
@@ -238,7 +244,10 @@ static int player_open(OBJECT *obj)
 
 static void rewind_player(struct player *my)
 {
-	(*my->ops->rewind)(my);
+	if (my->cache!=NULL)
+		player_cache_rewind(my);
+	else
+		(*my->ops->rewind)(my);
 }
 
 static void close_player(struct player *my)
@@ -265,115 +274,72 @@ static void trim(char *str, char *to){
 	}
 }
 
-TIMESTAMP player_read(OBJECT *obj)
+/** Get the date format used to read player timestamps
+	@return 0 for ISO, 1 for US, 2 for EURO
+ **/
+int player_dateformat(void)
+{
+	/* TODO move this to tape.c and make the variable available to all classes in tape */
+	static int dateformat = -1;
+	if ( dateformat<0 )
+	{
+		static char global_dateformat[8]="";
+		gl_global_getvar("dateformat",global_dateformat,sizeof(global_dateformat));
+		if (strcmp(global_dateformat,"US")==0) dateformat = 1;
+		else if (strcmp(global_dateformat,"EURO")==0) dateformat = 2;
+		else dateformat = 0;
+	}
+	return dateformat;
+}
+
+/** Parse a line of a player file
+	@return 0 if the line is a comment or blank, 1 otherwise; \p value
+	receives the value, or the line itself if it could not be parsed
+ **/
+int player_parse(char *line, PLAYERRECORD *rec, char *value)
 {
-	char buffer[1024];
 	char timebuf[64], valbuf[1024], tbuf[64];
 	char tz[6];
 	int Y=0,m=0,d=0,H=0,M=0;
 	double S=0;
-	struct player *my = OBJECTDATA(obj,struct player);
 	char unit[2];
 	TIMESTAMP t1;
-	char *result=NULL;
-	char1024 value;
 	int voff=0;
+	int dateformat = player_dateformat();
 
-	/* TODO move this to tape.c and make the variable available to all classes in tape */
-	static enum {UNKNOWN,ISO,US,EURO} dateformat = UNKNOWN;
-	if ( dateformat==UNKNOWN )
-	{
-		static char global_dateformat[8]="";
-		gl_global_getvar("dateformat",global_dateformat,sizeof(global_dateformat));
-		if (strcmp(global_dateformat,"ISO")==0) dateformat = ISO;
-		else if (strcmp(global_dateformat,"US")==0) dateformat = US;
-		else if (strcmp(global_dateformat,"EURO")==0) dateformat = EURO;
-		else dateformat = ISO;
-	}
-
-Retry:
-	result = my->ops->read(my, buffer, sizeof(buffer));
-
+	memset(rec, 0, sizeof(PLAYERRECORD));
 	memset(timebuf, 0, 64);
 	memset(valbuf, 0, 1024);
 	memset(tbuf, 0, 64);
-	memset(value, 0, 1024);
 	memset(tz, 0, 6);
-	if (result==NULL)
-	{
-		if (my->loopnum>0)
-		{
-			rewind_player(my);
-			my->loopnum--;
-			goto Retry;
-		}
-		else {
-			close_player(my);
-			my->status=TS_DONE;
-			my->next.ts = TS_NEVER;
-			my->next.ns = 0;
-			goto Done;
-		}
-	}
-	if (result[0]=='#' || result[0]=='\n') /* ignore comments and blank lines */
-		goto Retry;
+	value[0] = '\0';
+	if (line[0]=='#' || line[0]=='\n') /* ignore comments and blank lines */
+		return 0;
 
-	if(sscanf(result, "%32[^,],%1024[^\n\r;]", tbuf, valbuf) == 2){
+	if(sscanf(line, "%32[^,],%1024[^\n\r;]", tbuf, valbuf) == 2){
+		char1024 trimmed;
+		memset(trimmed, 0, 1024);
 		trim(tbuf, timebuf);
-		trim(valbuf, value);
-		if (sscanf(timebuf,"%d-%d-%d %d:%d:%lf %4s",&Y,&m,&d,&H,&M,&S, tz)==7){
-			//struct tm dt = {S,M,H,d,m-1,Y-1900,0,0,0};
-			DATETIME dt;
-			switch ( dateformat ) {
-			case ISO:
-				dt.year = Y;
-				dt.month = m;
-				dt.day = d;
-				break;
-			case US:
-				dt.year = d;
-				dt.month = Y;
-				dt.day = m;
-				break;
-			case EURO:
-				dt.year = d;
-				dt.month = m;
-				dt.day = Y;
-				break;
-			}
-			dt.hour = H;
-			dt.minute = M;
-			dt.second = (unsigned short)S;
-			dt.nanosecond = (unsigned int)(1e9*(S-dt.second));
-			strcpy(dt.tz, tz);
-			t1 = (TIMESTAMP)gl_mktime(&dt);
-			if ((obj->flags & OF_DELTAMODE)==OF_DELTAMODE)	/* Only request deltamode if we're explicitly enabled */
-				enable_deltamode(dt.nanosecond==0?TS_NEVER:t1);
-			if (t1!=TS_INVALID && my->loop==my->loopnum){
-				my->next.ts = t1;
-				my->next.ns = dt.nanosecond;
-				while(value[voff] == ' '){
-					++voff;
-				}
-				strcpy(my->next.value, value+voff);
-			}
+		trim(valbuf, trimmed);
+		while(trimmed[voff] == ' '){
+			++voff;
 		}
-		else if (sscanf(timebuf,"%d-%d-%d %d:%d:%lf",&Y,&m,&d,&H,&M,&S)>=4)
-		{
+		strcpy(value, trimmed+voff);
+		if (sscanf(timebuf,"%d-%d-%d %d:%d:%lf %4s",&Y,&m,&d,&H,&M,&S, tz)>=4){
 			//struct tm dt = {S,M,H,d,m-1,Y-1900,0,0,0};
 			DATETIME dt;
 			switch ( dateformat ) {
-			case ISO:
+			case 0:
 				dt.year = Y;
 				dt.month = m;
 				dt.day = d;
 				break;
-			case US:
+			case 1:
 				dt.year = d;
 				dt.month = Y;
 				dt.day = m;
 				break;
-			case EURO:
+			case 2:
 				dt.year = d;
 				dt.month = m;
 				dt.day = Y;
@@ -382,72 +348,130 @@ Retry:
 			dt.hour = H;
 			dt.minute = M;
 			dt.second = (unsigned short)S;
-			dt.tz[0] = 0;
 			dt.nanosecond = (unsigned int)(1e9*(S-dt.second));
-			t1 = (TIMESTAMP)gl_mktime(&dt);
-			if ((obj->flags & OF_DELTAMODE)==OF_DELTAMODE)	/* Only request deltamode if we're explicitly enabled */
-				enable_deltamode(dt.nanosecond==0?TS_NEVER:t1);
-			if (t1!=TS_INVALID && my->loop==my->loopnum){
-				my->next.ts = t1;
-				my->next.ns = dt.nanosecond;
-				while(value[voff] == ' '){
-					++voff;
-				}
-				strcpy(my->next.value, value+voff);
-			}
+			strcpy(dt.tz, tz);
+			rec->type = PR_DATETIME;
+			rec->ts = (TIMESTAMP)gl_mktime(&dt);
+			rec->ns = dt.nanosecond;
 		}
 		else if (sscanf(timebuf,"%" FMT_INT64 "d%1s", &t1, unit)==2)
 		{
-			{
-				int64 scale=1;
-				switch(unit[0]) {
-				case 's': scale=TS_SECOND; break;
-				case 'm': scale=60*TS_SECOND; break;
-				case 'h': scale=3600*TS_SECOND; break;
-				case 'd': scale=86400*TS_SECOND; break;
-				default: break;
-				}
-				t1 *= scale;
-				if (result[0]=='+'){ /* timeshifts have leading + */
-					my->next.ts += t1;
-					while(value[voff] == ' '){
-						++voff;
-					}
-					strcpy(my->next.value, value+voff);
-				} else if (my->loop==my->loopnum){ /* absolute times are ignored on all but first loops */
-					my->next.ts = t1;
-					while(value[voff] == ' '){
-						++voff;
-					}
-					strcpy(my->next.value, value+voff);
-				}
+			int64 scale=1;
+			switch(unit[0]) {
+			case 's': scale=TS_SECOND; break;
+			case 'm': scale=60*TS_SECOND; break;
+			case 'h': scale=3600*TS_SECOND; break;
+			case 'd': scale=86400*TS_SECOND; break;
+			default: break;
 			}
+			rec->type = line[0]=='+' ? PR_RELATIVE : PR_ABSOLUTE; /* timeshifts have leading + */
+			rec->ts = t1*scale;
 		}
 		else if (sscanf(timebuf,"%lf", &S)==1)
 		{
-			if (my->loop==my->loopnum) {
-				my->next.ts = (unsigned short)S;
-				my->next.ns = (unsigned int)(1e9*(S-my->next.ts));
-				if ((obj->flags & OF_DELTAMODE)==OF_DELTAMODE)	/* Only request deltamode if we're explicitly enabled */
-					enable_deltamode(my->next.ns==0?TS_NEVER:t1);
-				while(value[voff] == ' '){
-					++voff;
-				}
-				strcpy(my->next.value, value+voff);
-			}
+			rec->type = PR_SECONDS;
+			rec->ts = (unsigned short)S;
+			rec->ns = (unsigned int)(1e9*(S-rec->ts));
 		}
 		else
 		{
-			gl_warning("player was unable to parse timestamp \'%s\'", result);
+			rec->type = PR_BADTIME;
+			strcpy(value, line);
 		}
 	} else {
-		gl_warning("player was unable to split input string \'%s\'", result);
+		rec->type = PR_BADLINE;
+		strncpy(value, line, 1023);
+		value[1023] = '\0';
 	}
+	return 1;
+}
 
-Done:
+/** Apply a parsed line to the player
+	@return the time of the next value
+ **/
+static TIMESTAMP player_apply(OBJECT *obj, PLAYERRECORD *rec, const char *value)
+{
+	struct player *my = OBJECTDATA(obj,struct player);
+
+	switch (rec->type) {
+	case PR_DATETIME:
+		if ((obj->flags & OF_DELTAMODE)==OF_DELTAMODE)	/* Only request deltamode if we're explicitly enabled */
+			enable_deltamode(rec->ns==0?TS_NEVER:rec->ts);
+		if (rec->ts!=TS_INVALID && my->loop==my->loopnum){
+			my->next.ts = rec->ts;
+			my->next.ns = rec->ns;
+			strcpy(my->next.value, value);
+		}
+		break;
+	case PR_RELATIVE:
+		my->next.ts += rec->ts;
+		strcpy(my->next.value, value);
+		break;
+	case PR_ABSOLUTE:
+		if (my->loop==my->loopnum){ /* absolute times are ignored on all but first loops */
+			my->next.ts = rec->ts;
+			strcpy(my->next.value, value);
+		}
+		break;
+	case PR_SECONDS:
+		if (my->loop==my->loopnum) {
+			my->next.ts = rec->ts;
+			my->next.ns = rec->ns;
+			if ((obj->flags & OF_DELTAMODE)==OF_DELTAMODE)	/* Only request deltamode if we're explicitly enabled */
+				enable_deltamode(my->next.ns==0?TS_NEVER:rec->ts);
+			strcpy(my->next.value, value);
+		}
+		break;
+	case PR_BADTIME:
+		gl_warning("player was unable to parse timestamp \'%s\'", value);
+		break;
+	default:
+		gl_warning("player was unable to split input string \'%s\'", value);
+		break;
+	}
 	return my->next.ns==0 ? my->next.ts : (my->next.ts+1);
 }
 
+TIMESTAMP player_read(OBJECT *obj)
+{
+	char buffer[1024];
+	char1024 value;
+	struct player *my = OBJECTDATA(obj,struct player);
+	PLAYERRECORD rec, *next;
+	const char *text = value;
+
+Retry:
+	if (my->cache!=NULL)
+	{
+		next = player_cache_next(my, &text);
+		if (next!=NULL)
+			return player_apply(obj, next, text);
+	}
+	else
+	{
+		char *result = my->ops->read(my, buffer, sizeof(buffer));
+		if (result!=NULL)
+		{
+			if (player_parse(result, &rec, value)==0)
+				goto Retry;
+			return player_apply(obj, &rec, value);
+		}
+	}
+
+	/* end of tape */
+	if (my->loopnum>0)
+	{
+		rewind_player(my);
+		my->loopnum--;
+		goto Retry;
+	}
+	close_player(my);
+	my->status=TS_DONE;
+	my->next.ts = TS_NEVER;
+	my->next.ns = 0;
+	return TS_NEVER;
+}
+
 EXPORT TIMESTAMP sync_player(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 {
 	struct player *my = OBJECTDATA(obj,struct player);
@@ -466,6 +490,9 @@ EXPORT TIMESTAMP sync_player(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 		}
 		else
 		{
+			/* skip ahead to the start of the simulation when the tape is cached */
+			if (my->cache!=NULL)
+				player_cache_seek(my, t0);
 			t1 = player_read(obj);
 		}
 	}
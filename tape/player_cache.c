@@ -0,0 +1,438 @@
+/* $Id$
+ *	Copyright (C) 2008 Battelle Memorial Institute
+ *
+ *	Compiled player tapes, used when tape::player_cache is set.  The first
+ *	player that opens a text file parses every line once into an array of
+ *	records (timestamps already converted, values already trimmed) and saves
+ *	it next to the file with the extension PLAYER_CACHE_EXT.  Later runs map
+ *	the compiled file instead of parsing the text, as long as the text file
+ *	has the same size and content hash and the timezone and date format are
+ *	unchanged.  Hashing the text is much cheaper than parsing it, and unlike
+ *	the modification time it also catches an edit made within the same
+ *	second.  Players that read the same file share one compiled tape, and
+ *	looping only resets a record index.
+ *
+ *	The compiled file holds a PLAYERCACHEHEADER, the PLAYERRECORD array and
+ *	the text table of NUL terminated values, in host byte order.  Each record
+ *	also holds the time it has on the first pass through the tape, so a
+ *	player that starts after the beginning of its tape finds its first value
+ *	with a binary search instead of reading every earlier line.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#ifdef WIN32
+#include <io.h>
+#include <process.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "gridlabd.h"
+#include "tape.h"
+
+#define PLAYER_CACHE_MAGIC "GLDPLAY" /**< first 8 bytes of the file (including the NUL) */
+#define PLAYER_CACHE_VERSION 2 /**< format version written to the header */
+#define PLAYER_CACHE_EXT ".gpc" /**< extension added to the name of the text file */
+#define PLAYER_CACHE_ENDIAN 0x01020304 /**< detects files written on a host with another byte order */
+#define PLAYER_CACHE_PROBES 4 /**< number of dates used to detect a timezone change */
+
+extern int32 player_cache;
+
+typedef struct s_playercacheheader {
+	char magic[8];
+	unsigned int version;
+	unsigned int endian;
+	int64 source_size; /**< size of the text file */
+	unsigned int64 source_hash; /**< FNV-1a hash of the text file */
+	int64 probe[PLAYER_CACHE_PROBES]; /**< timestamps of fixed local dates in the timezone used */
+	int32 dateformat; /**< the date format used (see player_dateformat()) */
+	unsigned int n_records;
+	unsigned int n_seekable; /**< number of leading records that can be skipped by player_cache_seek() */
+	unsigned int reserved;
+	int64 text_size;
+} PLAYERCACHEHEADER;
+
+typedef struct s_playercache {
+	char path[1024]; /**< the text file */
+	pthread_mutex_t lock; /**< held while the tape is compiled */
+	void *data; /**< the header, the records and the text */
+	size_t size;
+	int mapped; /**< nonzero when data is mapped rather than allocated */
+	PLAYERCACHEHEADER *header;
+	PLAYERRECORD *record;
+	char *text;
+	struct s_playercache *next;
+} PLAYERCACHE;
+
+static PLAYERCACHE *cache_list = NULL;
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* 64-bit FNV-1a hash of the rest of a file, which is then rewound
+   @return the hash, or 0 if the file could not be read */
+static unsigned int64 get_hash(FILE *fp)
+{
+	unsigned int64 hash = 0xcbf29ce484222325ULL;
+	unsigned char buffer[65536];
+	size_t len, n;
+	while ( (len=fread(buffer,1,sizeof(buffer),fp))>0 )
+	{
+		for ( n=0 ; n<len ; n++ )
+			hash = (hash^buffer[n])*0x100000001b3ULL;
+	}
+	if ( ferror(fp) )
+		hash = 0;
+	clearerr(fp);
+	fseek(fp,0,SEEK_SET);
+	return hash;
+}
+
+/* the key of the compiled form of a text file */
+static void get_key(PLAYERCACHEHEADER *header, struct stat *st, FILE *fp)
+{
+	static const short date[PLAYER_CACHE_PROBES][3] = {{2000,1,1},{2000,7,1},{2020,1,1},{2020,7,1}};
+	unsigned int n;
+	memset(header,0,sizeof(PLAYERCACHEHEADER));
+	memcpy(header->magic,PLAYER_CACHE_MAGIC,sizeof(header->magic));
+	header->version = PLAYER_CACHE_VERSION;
+	header->endian = PLAYER_CACHE_ENDIAN;
+	header->source_size = (int64)st->st_size;
+	header->source_hash = get_hash(fp);
+	for ( n=0 ; n<PLAYER_CACHE_PROBES ; n++ )
+	{
+		DATETIME dt;
+		memset(&dt,0,sizeof(dt));
+		dt.year = date[n][0];
+		dt.month = date[n][1];
+		dt.day = date[n][2];
+		header->probe[n] = gl_mktime(&dt);
+	}
+	header->dateformat = player_dateformat();
+}
+
+/* map a compiled file if it matches the key */
+static int load_cache(PLAYERCACHE *cache, const char *cachename, PLAYERCACHEHEADER *key)
+{
+	PLAYERCACHEHEADER *header;
+	struct stat st;
+	size_t size;
+	FILE *fp = fopen(cachename,"rb");
+	if ( fp==NULL )
+		return 0;
+	if ( fstat(fileno(fp),&st)!=0 || (size_t)st.st_size<sizeof(PLAYERCACHEHEADER) )
+	{
+		fclose(fp);
+		return 0;
+	}
+	size = (size_t)st.st_size;
+#ifndef WIN32
+	cache->data = mmap(NULL,size,PROT_READ,MAP_PRIVATE,fileno(fp),0);
+	if ( cache->data!=MAP_FAILED )
+		cache->mapped = 1;
+	else
+#endif
+	{
+		cache->data = malloc(size);
+		if ( cache->data==NULL || fread(cache->data,1,size,fp)!=size )
+		{
+			free(cache->data);
+			cache->data = NULL;
+		}
+	}
+	fclose(fp);
+	if ( cache->data==NULL )
+		return 0;
+	cache->size = size;
+
+	/* everything but the counts must match the key */
+	header = (PLAYERCACHEHEADER*)cache->data;
+	if ( memcmp(header,key,(char*)&header->n_records-(char*)header)!=0
+		|| sizeof(PLAYERCACHEHEADER)+(size_t)header->n_records*sizeof(PLAYERRECORD)+(size_t)header->text_size!=size
+		|| header->n_seekable>header->n_records )
+	{
+		gl_verbose("compiled player tape '%s' is out of date", cachename);
+		return 0;
+	}
+	cache->header = header;
+	cache->record = (PLAYERRECORD*)(header+1);
+	cache->text = (char*)(cache->record+header->n_records);
+
+	/* the values are used straight from the file, so every one must lie inside the text and be terminated */
+	if ( header->n_records>0 && (header->text_size==0 || cache->text[header->text_size-1]!='\0') )
+	{
+		gl_verbose("compiled player tape '%s' is damaged (text is not terminated)", cachename);
+		return 0;
+	}
+	{	unsigned int n;
+		for ( n=0; n<header->n_records; n++ )
+		{
+			if ( (int64)cache->record[n].value>=header->text_size )
+			{
+				gl_verbose("compiled player tape '%s' is damaged (record %u is out of range)", cachename, n);
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/* parse the text file into memory */
+static int compile_cache(PLAYERCACHE *cache, FILE *fp, PLAYERCACHEHEADER *key)
+{
+	char buffer[1024];
+	char1024 value;
+	PLAYERRECORD rec, *record = NULL;
+	char *text = NULL;
+	size_t n_records = 0, max_records = 0, text_size = 0, max_text = 0;
+	unsigned int n_seekable = 0;
+	int seekable = 1;
+	int64 ts = TS_ZERO, ns = 0;
+
+	while ( fgets(buffer,sizeof(buffer),fp)!=NULL )
+	{
+		size_t len;
+		if ( player_parse(buffer,&rec,value)==0 )
+			continue;
+
+		/* the time of the line on the first pass (see player_apply()) */
+		switch ( rec.type ) {
+		case PR_DATETIME:
+			if ( rec.ts!=TS_INVALID )
+			{
+				ts = rec.ts;
+				ns = rec.ns;
+			}
+			else
+				seekable = 0;
+			break;
+		case PR_RELATIVE: ts += rec.ts; break;
+		case PR_ABSOLUTE: ts = rec.ts; break;
+		case PR_SECONDS: ts = rec.ts; ns = rec.ns; seekable = 0; break;
+		default: seekable = 0; break;
+		}
+		if ( seekable && ns==0 && (n_records==0 || ts>=record[n_records-1].abs) )
+			n_seekable++;
+		else
+			seekable = 0;
+		rec.abs = ts;
+
+		/* store the record and its value */
+		len = strlen(value)+1;
+		if ( n_records==max_records || text_size+len>max_text )
+		{
+			PLAYERRECORD *more_records;
+			char *more_text;
+			max_records = max_records ? max_records*2 : 1024;
+			max_text = max_text ? max_text*2+len : 16384;
+			more_records = (PLAYERRECORD*)realloc(record,sizeof(PLAYERRECORD)*max_records);
+			if ( more_records!=NULL ) record = more_records;
+			more_text = (char*)realloc(text,max_text);
+			if ( more_text!=NULL ) text = more_text;
+			if ( more_records==NULL || more_text==NULL )
+			{
+				gl_warning("player file %s: not enough memory to compile the tape, reading it as text", cache->path);
+				free(record);
+				free(text);
+				return 0;
+			}
+		}
+		rec.value = (unsigned int)text_size;
+		record[n_records++] = rec;
+		memcpy(text+text_size,value,len);
+		text_size += len;
+	}
+
+	/* lay it out like a compiled file */
+	cache->size = sizeof(PLAYERCACHEHEADER)+n_records*sizeof(PLAYERRECORD)+text_size;
+	cache->data = malloc(cache->size);
+	if ( cache->data!=NULL )
+	{
+		cache->header = (PLAYERCACHEHEADER*)cache->data;
+		memcpy(cache->header,key,sizeof(PLAYERCACHEHEADER));
+		cache->header->n_records = (unsigned int)n_records;
+		cache->header->n_seekable = n_seekable;
+		cache->header->text_size = (int64)text_size;
+		cache->record = (PLAYERRECORD*)(cache->header+1);
+		cache->text = (char*)(cache->record+n_records);
+		if ( n_records>0 )
+		{
+			memcpy(cache->record,record,n_records*sizeof(PLAYERRECORD));
+			memcpy(cache->text,text,text_size);
+		}
+	}
+	free(record);
+	free(text);
+	return cache->data!=NULL;
+}
+
+/* write the compiled tape so the next run can map it */
+static void save_cache(PLAYERCACHE *cache, const char *cachename)
+{
+	char tmpname[1024+32];
+	FILE *fp;
+	sprintf(tmpname,"%s.%d",cachename,(int)getpid());
+	fp = fopen(tmpname,"wb");
+	if ( fp==NULL )
+	{
+		gl_verbose("unable to save compiled player tape '%s' (%s)", cachename, strerror(errno));
+		return;
+	}
+	if ( fwrite(cache->data,1,cache->size,fp)!=cache->size )
+	{
+		fclose(fp);
+		unlink(tmpname);
+		gl_verbose("unable to save compiled player tape '%s' (%s)", cachename, strerror(errno));
+		return;
+	}
+	fclose(fp);
+#ifdef WIN32
+	unlink(cachename);
+#endif
+	if ( rename(tmpname,cachename)!=0 )
+	{
+		unlink(tmpname);
+		gl_verbose("unable to save compiled player tape '%s' (%s)", cachename, strerror(errno));
+	}
+}
+
+/** Get the compiled form of the player's text file, compiling it if needed.
+	The file must already be open as \p my->fp.
+	@return the compiled tape, or NULL if the file must be read as text
+ **/
+PLAYERCACHE *player_cache_open(struct player *my, char *fname)
+{
+	char path[1024], cachename[1024+sizeof(PLAYER_CACHE_EXT)];
+	PLAYERCACHEHEADER key;
+	PLAYERCACHE *cache;
+	struct stat st;
+	int found = 0;
+
+	if ( player_cache==0 )
+		return NULL;
+	if ( gl_findfile(fname,NULL,R_OK,path,sizeof(path))==NULL || stat(path,&st)!=0 || (st.st_mode&S_IFMT)!=S_IFREG )
+		return NULL;
+
+	/* players that read the same file share its compiled tape */
+	pthread_mutex_lock(&cache_lock);
+	for ( cache=cache_list ; cache!=NULL ; cache=cache->next )
+	{
+		if ( strcmp(cache->path,path)==0 )
+		{
+			found = 1;
+			break;
+		}
+	}
+	if ( !found )
+	{
+		cache = (PLAYERCACHE*)malloc(sizeof(PLAYERCACHE));
+		if ( cache==NULL )
+		{
+			pthread_mutex_unlock(&cache_lock);
+			return NULL;
+		}
+		memset(cache,0,sizeof(PLAYERCACHE));
+		strcpy(cache->path,path);
+		pthread_mutex_init(&cache->lock,NULL);
+		pthread_mutex_lock(&cache->lock);
+		cache->next = cache_list;
+		cache_list = cache;
+	}
+	pthread_mutex_unlock(&cache_lock);
+
+	if ( found )
+	{
+		/* wait until the player that found it first is done compiling it */
+		pthread_mutex_lock(&cache->lock);
+		pthread_mutex_unlock(&cache->lock);
+	}
+	else
+	{
+		get_key(&key,&st,my->fp);
+		sprintf(cachename,"%s%s",path,PLAYER_CACHE_EXT);
+		if ( load_cache(cache,cachename,&key) )
+			gl_verbose("player file %s: using compiled tape '%s'", path, cachename);
+		else
+		{
+#ifndef WIN32
+			if ( cache->mapped )
+				munmap(cache->data,cache->size);
+			else
+#endif
+			free(cache->data);
+			cache->data = NULL;
+			cache->header = NULL;
+			cache->mapped = 0;
+			if ( compile_cache(cache,my->fp,&key) )
+				save_cache(cache,cachename);
+			else
+			{
+				free(cache->data);
+				cache->data = NULL;
+				cache->header = NULL;
+			}
+			fseek(my->fp,0,SEEK_SET);
+		}
+		pthread_mutex_unlock(&cache->lock);
+	}
+
+	if ( cache->header==NULL )
+		return NULL;
+	my->cache_pos = 0;
+	return cache;
+}
+
+/** Get the next record of a compiled tape
+	@return the record, or NULL at the end of the tape
+ **/
+PLAYERRECORD *player_cache_next(struct player *my, const char **value)
+{
+	PLAYERCACHE *cache = my->cache;
+	PLAYERRECORD *rec;
+	if ( my->cache_pos>=cache->header->n_records )
+		return NULL;
+	rec = cache->record + my->cache_pos++;
+	*value = cache->text + rec->value;
+	return rec;
+}
+
+/** Restart a compiled tape */
+void player_cache_rewind(struct player *my)
+{
+	my->cache_pos = 0;
+}
+
+/** Skip the records of a compiled tape that the first read would post and
+	overwrite before time \p t, so the next read returns the last record at
+	or before \p t.  Only the leading records in time order with whole
+	second timestamps are skipped.
+ **/
+void player_cache_seek(struct player *my, TIMESTAMP t)
+{
+	PLAYERCACHE *cache = my->cache;
+	unsigned int lo = 0, hi = cache->header->n_seekable;
+
+	if ( my->cache_pos!=0 || my->loop!=my->loopnum || hi==0 || cache->record[0].abs>t )
+		return;
+
+	/* find the last record at or before t */
+	while ( hi-lo>1 )
+	{
+		unsigned int mid = lo+(hi-lo)/2;
+		if ( cache->record[mid].abs<=t )
+			lo = mid;
+		else
+			hi = mid;
+	}
+	if ( lo>0 )
+	{
+		my->cache_pos = lo;
+		my->next.ts = cache->record[lo-1].abs;
+		my->next.ns = 0;
+	}
+}
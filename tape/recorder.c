@@ -99,11 +99,75 @@ EXPORT int create_recorder(OBJECT **obj, OBJECT *parent)
 		my->header_units = HU_DEFAULT;
 		my->line_units = LU_DEFAULT;
 		my->flush = -1; /* -1 (default): flush when buffer full, 0 flush each line, >0 flush seconds */
+		my->binary = NULL;
 		return 1;
 	}
 	return 0;
 }
 
+/* binary tapes are written by the recorder itself rather than a tape_<mode> library */
+static int recorder_open_binary(OBJECT *obj, char *fname)
+{
+	struct recorder *my = OBJECTDATA(obj,struct recorder);
+	BINARYTAPE *tape;
+	PROPERTY *prop = my->target;
+	char1024 list;
+	char buffer[64];
+	char *item;
+
+	if ( my->multifile[0]!='\0' )
+	{
+		gl_error("recorder:%d: multi-run output files cannot be binary tapes", obj->id);
+		return 0;
+	}
+	my->binary = binary_sampler_open(obj,fname);
+	if ( my->binary==NULL )
+		return 0;
+	tape = my->binary->tape;
+	sprintf(buffer,"%s %d",obj->parent->oclass->name,obj->parent->id);
+	binary_tape_set_info(tape,"target",buffer);
+	binary_tape_set_info(tape,"trigger",my->trigger[0]=='\0'?"(none)":my->trigger);
+	sprintf(buffer,"%" FMT_INT64 "d",my->interval);
+	binary_tape_set_info(tape,"interval",buffer);
+	sprintf(buffer,"%d",my->limit);
+	binary_tape_set_info(tape,"limit",buffer);
+	binary_tape_set_info(tape,"property",my->property);
+	binary_tape_set_info(tape,"format",my->format?"1":"0");
+
+	/* name the columns as they appear in the property list, less any unit */
+	strcpy(list,my->property);
+	for (item=strtok(list,","); item!=NULL && prop!=NULL; item=strtok(NULL,","), prop=prop->next)
+	{
+		char *unit;
+		while (isspace(*item)) item++;
+		if ( (unit=strchr(item,'['))!=NULL )
+			*unit = '\0';
+		if ( !binary_sampler_add(my->binary,obj->parent,prop,item,NONE) )
+			return 0;
+	}
+	if ( !binary_tape_start(tape) )
+	{
+		gl_error("recorder:%d: %s", obj->id, tape->lasterr);
+		return 0;
+	}
+
+	/* the sample taken before the tape opened is written next */
+	if ( !binary_sampler_read(my->binary) )
+		return 0;
+	binary_tape_hold(tape);
+	my->type = FT_FILE;
+	my->last.ts = TS_ZERO;
+	my->status = TS_OPEN;
+	my->samples = 0;
+
+	if ( (obj->flags)&OF_DELTAMODE )
+	{
+		extern int delta_add_tape_device(OBJECT *obj, DELTATAPEOBJ tape_type);
+		return delta_add_tape_device(obj,RECORDER);
+	}
+	return 1;
+}
+
 static int recorder_open(OBJECT *obj)
 {
 	char32 type="file";
@@ -128,6 +192,9 @@ static int recorder_open(OBJECT *obj)
 		/* use object name-id as default file name */
 		sprintf(fname,"%s-%d.%s",obj->parent->oclass->name,obj->parent->id, my->filetype);
 
+	if ( binary_tape_match(fname) )
+		return recorder_open_binary(obj,fname);
+
 	/* open multiple-run input file & temp output file */
 	if(my->type == FT_FILE && my->multifile[0] != 0){
 		if(my->interval < 1){
@@ -376,6 +443,10 @@ static void close_recorder(struct recorder *my)
 	if (my->ops){
 		my->ops->close(my);
 	}
+	if (my->binary){
+		binary_sampler_close(my->binary);
+		my->binary = NULL;
+	}
 	if(my->multifp){
 		if(0 != fclose(my->multifp)){
 			gl_error("unable to close multi-run temp file \'%s\'", my->multitempfile);
@@ -403,6 +474,23 @@ static TIMESTAMP recorder_write(OBJECT *obj)
 {
 	struct recorder *my = OBJECTDATA(obj,struct recorder);
 	char ts[64]="0"; /* 0 = INIT */
+	if (my->binary!=NULL)
+	{
+		/* binary tapes keep the raw timestamp and have no multi-run file */
+		if ((my->limit>0 && my->samples > my->limit) /* limit reached */
+			|| binary_sampler_write(my->binary, my->last.ts, 0)==0) /* write failed */
+		{
+			close_recorder(my);
+			my->status = TS_DONE;
+		}
+		else
+		{
+			my->samples++;
+			if (my->flush==0 || (my->flush>0 && gl_globalclock%my->flush==0))
+				binary_tape_flush(my->binary->tape);
+		}
+		return TS_NEVER;
+	}
 	if (my->format==0)
 	{
 		if (my->last.ts>TS_ZERO)
@@ -505,7 +593,7 @@ PROPERTY *link_properties(struct recorder *rec, OBJECT *obj, char *property_list
 
 		// everything that looks like a property name, then read units up to ]
 		while (isspace(*item)) item++;
-		if(2 == sscanf(item,"%[A-Za-z0-9_.][%[^]\n,\0]", pstr, ustr)){
+		if(2 == sscanf(item,"%[A-Za-z0-9_.][%[^]\n,]", pstr, ustr)){
 			unit = gl_find_unit(ustr);
 			if(unit == NULL){
 				gl_error("recorder:%d: unable to find unit '%s' for property '%s'",obj->id, ustr,pstr);
@@ -615,6 +703,33 @@ int read_properties(struct recorder *my, OBJECT *obj, PROPERTY *prop, char *buff
 	return count;
 }
 
+/* Binary tapes sample typed values instead of text.  Unless a trigger needs
+   the text, the buffer only gets a marker that matches last.value exactly
+   when the values are unchanged since they were last held, which is all
+   the sampling logic in sync_recorder() compares. */
+static int recorder_read(struct recorder *my, OBJECT *obj, char *buffer, int size)
+{
+	if (my->binary==NULL)
+		return read_properties(my,obj,my->target,buffer,size);
+	if (binary_sampler_read(my->binary)==0)
+		return 0;
+	if (my->trigger[0]!='\0')
+		return read_properties(my,obj,my->target,buffer,size);
+	if (binary_tape_changed(my->binary->tape))
+		strcpy(buffer, my->last.value[0]=='+' ? "-" : "+");
+	else
+		strcpy(buffer, my->last.value[0]!='\0' ? my->last.value : "=");
+	return 1;
+}
+
+/* keep the sample just read as the one the next write records */
+static void recorder_hold(struct recorder *my, char *buffer)
+{
+	strncpy(my->last.value,buffer,sizeof(my->last.value));
+	if (my->binary!=NULL)
+		binary_tape_hold(my->binary->tape);
+}
+
 EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 {
 	struct recorder *my = OBJECTDATA(obj,struct recorder);
@@ -672,7 +787,7 @@ EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 
 	/* update property value */
 	if ((my->target != NULL) && (my->interval == 0 || my->interval == -1)){	
-		if(read_properties(my, obj->parent,my->target,buffer,sizeof(buffer))==0)
+		if(recorder_read(my, obj->parent,buffer,sizeof(buffer))==0)
 		{
 			sprintf(buffer,"unable to read property '%s' of %s %d", my->property, obj->parent->oclass->name, obj->parent->id);
 			close_recorder(my);
@@ -681,7 +796,7 @@ EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 	}
 	if ((my->target != NULL) && (my->interval > 0)){
 		if((t0 >=my->last.ts + my->interval) || ((t0 == my->last.ts) && (my->last.ns == 0))){
-			if(read_properties(my, obj->parent,my->target,buffer,sizeof(buffer))==0)
+			if(recorder_read(my, obj->parent,buffer,sizeof(buffer))==0)
 			{
 				sprintf(buffer,"unable to read property '%s' of %s %d", my->property, obj->parent->oclass->name, obj->parent->id);
 				close_recorder(my);
@@ -726,7 +841,7 @@ EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 			)
 
 		{
-			strncpy(my->last.value,buffer,sizeof(my->last.value));
+			recorder_hold(my,buffer);
 
 			/* Deltamode-related check -- if we're ahead, don't overwrite this */
 			if (my->last.ts < t0)
@@ -736,7 +851,7 @@ EXPORT TIMESTAMP sync_recorder(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 				recorder_write(obj);
 			}
 		} else if ((my->interval > 0) && (my->last.ts == t0) && (my->last.ns == 0)){
-			strncpy(my->last.value,buffer,sizeof(my->last.value));
+			recorder_hold(my,buffer);
 		}
 	}
 Error:
@@ -756,4 +871,17 @@ Error:
 		return my->last.ts+my->interval;
 }
 
+EXPORT STATUS finalize_recorder(OBJECT *obj)
+{
+	struct recorder *my = OBJECTDATA(obj,struct recorder);
+
+	/* binary tapes buffer whole blocks, so they must be closed before exit */
+	if (my->binary!=NULL)
+	{
+		binary_sampler_close(my->binary);
+		my->binary = NULL;
+	}
+	return SUCCESS;
+}
+
 /**@}*/
@@ -205,6 +205,7 @@ EXPORT TIMESTAMP sync_shaper(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 				return TS_NEVER;
 			}
 			my->n_targets = object_list->hit_count;
+			my->shaped_magnitude = my->magnitude;
 			my->targets = (SHAPERTARGET*)gl_malloc(sizeof(SHAPERTARGET)*my->n_targets);
 			memset(my->targets,0,sizeof(SHAPERTARGET)*my->n_targets);
 			if (my->targets==NULL)
@@ -248,6 +249,7 @@ EXPORT TIMESTAMP sync_shaper(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 		if (my->targets!=NULL)
 		{
 			unsigned int n;
+			int reshape = (my->events<=0 && my->magnitude!=my->shaped_magnitude);
 			for (n=0; n<my->n_targets; n++)
 			{
 				TIMESTAMP tn = TS_NEVER;
@@ -263,6 +265,13 @@ EXPORT TIMESTAMP sync_shaper(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 						tn = shaper_read(obj,t0,n);
 				}
 
+				/* a direct shape follows a change in magnitude right away */
+				else if (reshape && my->targets[n].addr!=NULL)
+				{
+					tn = shaper_read(obj,t0,n);
+					*(my->targets[n].addr) = my->targets[n].value;
+				}
+
 				/* make sure caller knows next event time */
 				else if (my->targets[n].ts<t1)
 					tn = my->targets[n].ts;
@@ -270,6 +279,7 @@ EXPORT TIMESTAMP sync_shaper(OBJECT *obj, TIMESTAMP t0, PASSCONFIG pass)
 				/* keep track of "nextest" event */
 				if (tn<t1) t1=tn;
 			}
+			my->shaped_magnitude = my->magnitude;
 		}
 	}
 	obj->clock = t0;
@@ -75,6 +75,9 @@ static char1024 tape_gnuplot_path;
 int32 flush_interval = 0;
 int csv_data_only = 0; /* enable this option to suppress addition of lines starting with # in CSV */
 int csv_keep_clean = 0; /* enable this option to keep data flushed at end of line */
+int32 async_output = 0; /* enable this option to write output on a background thread */
+int32 player_cache = 0; /* enable this option to save compiled player files next to them and reuse them in later runs */
+int32 async_buffer_size = 1048576; /* bytes queued per thread before writers wait */
 void (*update_csv_data_only)(void)=NULL;
 void (*update_csv_keep_clean)(void)=NULL;
 
@@ -101,6 +104,7 @@ TAPEFUNCS *get_ftable(char *mode){
 	TAPEOPS *ops = NULL;
 	void *lib = NULL;
 	CALLBACKS **c = NULL;
+	ASYNCOPS **a = NULL;
 	char tpath[1024];
 	while(fptr != NULL){
 		if(strcmp(fptr->mode, mode) == 0)
@@ -128,6 +132,9 @@ TAPEFUNCS *get_ftable(char *mode){
 	c = (CALLBACKS **)DLSYM(lib, "callback");
 	if(c)
 		*c = callback;
+	a = (ASYNCOPS **)DLSYM(lib, "tape_async");
+	if(a)
+		*a = &async_ops;
 
 	//	nonfatal ommission
 	ops = fptr->collector = malloc(sizeof(TAPEOPS));
@@ -203,12 +210,16 @@ EXPORT CLASS *init(CALLBACKS *fntable, void *module, int argc, char *argv[])
 	gl_global_create("tape::flush_interval",PT_int32,&flush_interval,NULL);
 	gl_global_create("tape::csv_data_only",PT_int32,&csv_data_only,NULL);
 	gl_global_create("tape::csv_keep_clean",PT_int32,&csv_keep_clean,NULL);
+	gl_global_create("tape::async_output",PT_int32,&async_output,NULL);
+	gl_global_create("tape::async_buffer_size",PT_int32,&async_buffer_size,NULL);
+	gl_global_create("tape::player_cache",PT_int32,&player_cache,NULL);
 
 	/* control delta mode */
 	gl_global_create("tape::delta_mode_needed", PT_timestamp, &delta_mode_needed,NULL);
 
 	/* register the first class implemented, use SHARE to reveal variables */
-	player_class = gl_register_class(module,"player",sizeof(struct player),PC_PRETOPDOWN); 
+	/* players only write their target when the next line of the tape is due, so they may sleep until then */
+	player_class = gl_register_class(module,"player",sizeof(struct player),PC_PRETOPDOWN|PC_SPARSE_SYNC); 
 	player_class->trl = TRL_PROVEN;
 	PUBLISH_STRUCT(player,char256,property);
 	PUBLISH_STRUCT(player,char1024,file);
@@ -216,15 +227,17 @@ EXPORT CLASS *init(CALLBACKS *fntable, void *module, int argc, char *argv[])
 	PUBLISH_STRUCT(player,char32,mode);
 	PUBLISH_STRUCT(player,int32,loop);
 
-	/* register the first class implemented, use SHARE to reveal variables */
-	shaper_class = gl_register_class(module,"shaper",sizeof(struct shaper),PC_PRETOPDOWN); 
+	/* shapers only write their targets at the next shape step, or when their magnitude is changed */
+	shaper_class = gl_register_class(module,"shaper",sizeof(struct shaper),PC_PRETOPDOWN|PC_SPARSE_SYNC); 
 	shaper_class->trl = TRL_QUALIFIED;
 	PUBLISH_STRUCT(shaper,char1024,file);
 	PUBLISH_STRUCT(shaper,char8,filetype);
 	PUBLISH_STRUCT(shaper,char32,mode);
 	PUBLISH_STRUCT(shaper,char256,group);
 	PUBLISH_STRUCT(shaper,char256,property);
-	PUBLISH_STRUCT(shaper,double,magnitude);
+	{	struct shaper *_t=NULL;
+		if (gl_publish_variable(shaper_class,PT_double,"magnitude",(char*)&(_t->magnitude)-(char*)_t,PT_FLAGS,PF_WAKEUP,NULL)<1) return NULL;
+	}
 	PUBLISH_STRUCT(shaper,double,events);
 
 	/* register the other classes as needed, */
@@ -515,7 +528,18 @@ EXPORT SIMULATIONMODE interupdate(MODULE *module, TIMESTAMP t0, unsigned int64 d
 					/* See if we're in service */
 					if ((obj->in_svc_double <= gl_globaldeltaclock) && (obj->out_svc_double >= gl_globaldeltaclock))
 					{
-						if( read_properties(my, obj->parent,my->target,value,sizeof(value)) )
+						if (my->binary!=NULL)
+						{
+							if ( !binary_sampler_read(my->binary) )
+								return SM_ERROR;
+							binary_tape_hold(my->binary->tape);
+							if ( !binary_sampler_write(my->binary,rec_integer_clock,(int64)rec_microseconds*1000) )
+							{
+								gl_error("recorder:%d: unable to write sample to file", obj->id);
+								return SM_ERROR;
+							}
+						}
+						else if( read_properties(my, obj->parent,my->target,value,sizeof(value)) )
 						{
 							if ( !my->ops->write(my, recorder_timestamp, value) )
 							{
@@ -735,7 +759,20 @@ EXPORT STATUS postupdate(MODULE *module, TIMESTAMP t0, unsigned int64 dt)
 			/* See if we're in service */
 			if ((obj->in_svc_double <= gl_globaldeltaclock) && (obj->out_svc_double >= gl_globaldeltaclock))
 			{
-				if( read_properties(myrec, obj->parent,myrec->target,value,sizeof(value)) )
+				if (myrec->binary!=NULL)
+				{
+					if ( !binary_sampler_read(myrec->binary) )
+						return FAILED;
+					binary_tape_hold(myrec->binary->tape);
+					if ( !binary_sampler_write(myrec->binary,rec_integer_clock,(int64)rec_microseconds*1000) )
+					{
+						gl_error("recorder:%d: unable to write sample to file", obj->id);
+						return FAILED;
+					}
+					myrec->last.ts = rec_integer_clock;
+					myrec->last.ns = rec_microseconds;
+				}
+				else if( read_properties(myrec, obj->parent,myrec->target,value,sizeof(value)) )
 				{
 					if ( !myrec->ops->write(myrec, recorder_timestamp, value) )
 					{
@@ -840,4 +877,10 @@ int do_kill()
 	return 0;
 }
 
+EXPORT void term(void)
+{
+	/* queued output must reach the disk before the process exits */
+	async_term();
+}
+
 /**@}*/
@@ -10,6 +10,8 @@
 #include "object.h"
 #include "aggregate.h"
 #include "memory.h"
+#include "binary.h"
+#include "async.h"
 
 /* tape global controls */
 static char timestamp_format[32]="%Y-%m-%d %H:%M:%S";
@@ -65,10 +67,47 @@ typedef struct s_deltaobj {
 	struct s_deltaobj *next;
 } DELTAOBJ_LIST;
 
+typedef struct s_binarysource {
+	OBJECT *obj;
+	PROPERTY *prop;
+	UNIT *from; /* native unit when a double is converted to prop->unit */
+	CPLPT part; /* complex part this column holds */
+	unsigned int column;
+	struct s_binarysource *next;
+} BINARYSOURCE;
+
+typedef struct s_binarysampler {
+	BINARYTAPE *tape;
+	BINARYSOURCE *first, *last;
+} BINARYSAMPLER; /**< the properties written to a binary tape */
+
 /** @}
   @addtogroup player
 	@{ 
  **/
+
+/** The kinds of line in a player file */
+typedef enum {
+	PR_DATETIME=1, /**< absolute date and time */
+	PR_ABSOLUTE=2, /**< absolute time with a unit */
+	PR_RELATIVE=3, /**< time offset from the previous line (leading +) */
+	PR_SECONDS=4, /**< fractional seconds */
+	PR_BADTIME=5, /**< the timestamp could not be parsed */
+	PR_BADLINE=6 /**< the line could not be split into a time and a value */
+} PLAYERRECORDTYPE;
+
+/** A parsed line of a player file (see player_cache.c for the file layout) */
+typedef struct s_playerrecord {
+	int64 ts; /**< the timestamp, or the offset of a relative line */
+	int64 abs; /**< the time of the line on the first pass (compiled tapes only) */
+	int32 ns; /**< the nanoseconds of the timestamp */
+	int32 type; /**< the kind of line (PLAYERRECORDTYPE) */
+	unsigned int value; /**< the offset of the value in the text table (compiled tapes only) */
+	unsigned int reserved;
+} PLAYERRECORD;
+
+struct s_playercache;
+
 struct player {
 	/* public */
 	char1024 file; /**< the name of the player source */
@@ -99,6 +138,8 @@ struct player {
 	PROPERTY *target;
 	TAPEOPS *ops;
 	char lasterr[1024];
+	struct s_playercache *cache; /**< the compiled tape, or NULL when the source is read as text */
+	unsigned int cache_pos; /**< the next record of the compiled tape */
 }; /**< a player item */
 /** @}
 	@addtogroup shaper
@@ -133,6 +174,7 @@ struct shaper {
 	int16 interval;	/* the interval over which events is counted (usually 24) */
 	int16 step;		/* the duration of a single step in the shape integral (usually 3600s) */
 	double scale;	/* the scaling of the shape over the interval */
+	double shaped_magnitude; /* the magnitude used by the last direct shape read */
 	int32 loopnum;
 	unsigned char shape[12][31][7][24];
 #define SHAPER_QUEUE 0x0001
@@ -186,6 +228,7 @@ struct recorder {
 	} last;
 	int32 samples;
 	PROPERTY *target;
+	BINARYSAMPLER *binary; /* non-NULL when writing a binary tape instead of using ops */
 };
 /** @}
 	@addtogroup collector
@@ -231,4 +274,21 @@ void enable_deltamode(TIMESTAMP t1); /* indicate when deltamode is needed */
 EXPORT int delta_add_tape_device(OBJECT *obj, DELTATAPEOBJ tape_type);
 void set_csv_options(void);
 
+/* player lines (player.c) */
+CDECL int player_dateformat(void);
+CDECL int player_parse(char *line, PLAYERRECORD *rec, char *value);
+
+/* compiled player tapes (player_cache.c) */
+CDECL struct s_playercache *player_cache_open(struct player *my, char *fname);
+CDECL PLAYERRECORD *player_cache_next(struct player *my, const char **value);
+CDECL void player_cache_rewind(struct player *my);
+CDECL void player_cache_seek(struct player *my, TIMESTAMP t);
+
+/* binary tape output (binary_sampler.c) */
+CDECL BINARYSAMPLER *binary_sampler_open(OBJECT *obj, char *fname);
+CDECL int binary_sampler_add(BINARYSAMPLER *bs, OBJECT *obj, PROPERTY *prop, char *name, CPLPT part);
+CDECL int binary_sampler_read(BINARYSAMPLER *bs);
+CDECL int binary_sampler_write(BINARYSAMPLER *bs, TIMESTAMP ts, int64 ns);
+CDECL void binary_sampler_close(BINARYSAMPLER *bs);
+
 #endif
@@ -0,0 +1,184 @@
+/* $Id$
+ *	Copyright (C) 2008 Battelle Memorial Institute
+ *
+ *	Converts a binary tape written by a recorder, group_recorder or
+ *	multi_recorder back into the CSV file the recorder would have written.
+ *
+ *	Usage: tape2csv [-d|-e] input.gbt [output.csv]
+ *
+ *	Timestamps are printed the way the recorder's format property asked
+ *	for unless -d (dates) or -e (epoch seconds) is given.  Dates are
+ *	printed in the local time of the process, so set TZ to the model's
+ *	timezone to reproduce the recorder's output exactly.
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "binary.h"
+
+static void usage(void)
+{
+	fprintf(stderr,"Usage: tape2csv [-d|-e] input%s [output.csv]\n", BINARY_TAPE_EXT);
+	fprintf(stderr,"  -d  print timestamps as local dates (set TZ to match the model)\n");
+	fprintf(stderr,"  -e  print timestamps as epoch seconds\n");
+}
+
+static void print_time(FILE *out, int64 ns, int epoch)
+{
+	time_t t = (time_t)(ns/1000000000);
+	int64 frac = ns%1000000000;
+	struct tm *tm;
+	char tz[64] = "";
+
+	if ( frac<0 )
+	{
+		frac += 1000000000;
+		t--;
+	}
+	if ( epoch )
+	{
+		if ( frac==0 )
+			fprintf(out,"%" FMT_INT64 "d", (int64)t);
+		else
+			fprintf(out,"%" FMT_INT64 "d.%06d", (int64)t, (int)(frac/1000));
+		return;
+	}
+	tm = localtime(&t);
+	if ( tm==NULL )
+	{
+		fprintf(out,"%" FMT_INT64 "d", (int64)t);
+		return;
+	}
+	strftime(tz,sizeof(tz),"%Z",tm);
+	fprintf(out,"%04d-%02d-%02d %02d:%02d:%02d", tm->tm_year+1900, tm->tm_mon+1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec);
+	if ( frac!=0 )
+		fprintf(out,".%06d", (int)(frac/1000));
+	fprintf(out," %s", tz);
+}
+
+/* print an integer using the column's keywords when it has any */
+static void print_keyword(FILE *out, BINARYCOLUMN *col, int64 value)
+{
+	const char *p = col->keywords;
+	while ( p!=NULL && *p!='\0' )
+	{
+		const char *eq = strchr(p,'=');
+		const char *next = strchr(p,'|');
+		if ( eq==NULL )
+			break;
+		if ( (next==NULL || eq<next) && atoi64(eq+1)==value )
+		{
+			fprintf(out,"%.*s", (int)(eq-p), p);
+			return;
+		}
+		p = next ? next+1 : NULL;
+	}
+	fprintf(out,"%" FMT_INT64 "d", value);
+}
+
+int main(int argc, char *argv[])
+{
+	BINARYTAPE *tape;
+	FILE *out = stdout;
+	const char *input = NULL, *output = NULL;
+	const char *double_format, *format;
+	int epoch = -1;
+	int n, i;
+	unsigned int c;
+
+	for ( i=1 ; i<argc ; i++ )
+	{
+		if ( strcmp(argv[i],"-d")==0 )
+			epoch = 0;
+		else if ( strcmp(argv[i],"-e")==0 )
+			epoch = 1;
+		else if ( argv[i][0]=='-' && argv[i][1]!='\0' )
+		{
+			usage();
+			return 2;
+		}
+		else if ( input==NULL )
+			input = argv[i];
+		else if ( output==NULL )
+			output = argv[i];
+		else
+		{
+			usage();
+			return 2;
+		}
+	}
+	if ( input==NULL )
+	{
+		usage();
+		return 2;
+	}
+
+	tape = binary_tape_open(input);
+	if ( tape==NULL )
+	{
+		fprintf(stderr,"tape2csv: unable to read '%s'\n", input);
+		return 1;
+	}
+	if ( output!=NULL && (out=fopen(output,"w"))==NULL )
+	{
+		fprintf(stderr,"tape2csv: unable to write '%s'\n", output);
+		binary_tape_close(tape);
+		return 1;
+	}
+	double_format = binary_tape_get_info(tape,"double_format");
+	if ( double_format==NULL || double_format[0]=='\0' )
+		double_format = "%+lg";
+	format = binary_tape_get_info(tape,"format");
+	if ( epoch<0 )
+		epoch = ( format!=NULL && strcmp(format,"1")==0 );
+
+	/* header, as the CSV recorder writes it */
+	for ( c=0 ; c<tape->n_info ; c++ )
+	{
+		const char *name = tape->info[2*c];
+		if ( strcmp(name,"format")==0 || strcmp(name,"double_format")==0 || strcmp(name,"source")==0 )
+			continue;
+		fprintf(out,"# %s%.*s %s\n", name, (int)(strlen(name)<10?10-strlen(name):0), "..........", tape->info[2*c+1]);
+	}
+	fprintf(out,"# timestamp");
+	for ( c=0 ; c<tape->n_columns ; c++ )
+	{
+		BINARYCOLUMN *col = tape->column+c;
+		if ( col->unit[0]!='\0' )
+			fprintf(out,",%s[%s]", col->name, col->unit);
+		else
+			fprintf(out,",%s", col->name);
+	}
+	fprintf(out,"\n");
+
+	/* rows */
+	while ( (n=binary_tape_read(tape))>0 )
+	{
+		for ( i=0 ; i<n ; i++ )
+		{
+			print_time(out,tape->time[i],epoch);
+			for ( c=0 ; c<tape->n_columns ; c++ )
+			{
+				BINARYCOLUMN *col = tape->column+c;
+				fputc(',',out);
+				switch ( col->type ) {
+				case BT_DOUBLE: fprintf(out,double_format,col->data.d[i]); break;
+				case BT_INT64: print_keyword(out,col,col->data.i[i]); break;
+				case BT_TEXT: fputs(col->data.s[i]?col->data.s[i]:"",out); break;
+				}
+			}
+			fputc('\n',out);
+		}
+	}
+	if ( n<0 )
+		fprintf(stderr,"tape2csv: %s: %s\n", input, tape->lasterr);
+	else
+		fprintf(out,"# end of tape\n");
+	binary_tape_close(tape);
+	if ( out!=stdout )
+		fclose(out);
+	return n<0 ? 1 : 0;
+}
@@ -1296,7 +1296,7 @@ int violation_recorder::write_to_stream (TIMESTAMP t1, bool echo, char *fmt, ...
 	vsprintf(buffer,fmt,ptr); /* note the lack of check on buffer overrun */
 	va_end(ptr);
 	// print line to file
-	if(0 >= fprintf(rec_file, "%s,%s\n", time_str, buffer)){
+	if(0 >= async_printf(rec_file, "%s,%s\n", time_str, buffer)){
 		gl_error("violation_recorder::write_line(): error when writing to the output file");
 		/* TROUBLESHOOT
 			File I/O error.
@@ -1319,7 +1319,7 @@ int violation_recorder::write_to_stream (TIMESTAMP t1, bool echo, char *fmt, ...
 	if(limit > 0 && write_count >= limit){
 		// write footer
 		write_footer();
-		fclose(rec_file);
+		async_close(rec_file);
 		rec_file = 0;
 		free(line_buffer);
 		line_buffer = 0;
@@ -1350,7 +1350,7 @@ int violation_recorder::flush_line(){
 		tape_status = TS_ERROR;
 		return 0;
 	}
-	if(0 != fflush(rec_file)){
+	if(0 != async_flush(rec_file)){
 		gl_error("violation_recorder::flush_line(): unable to flush output file");
 		/* TROUBLESHOOT
 			An IO error has occured.
@@ -1481,7 +1481,7 @@ int violation_recorder::write_footer(){
 	}
 
 	// not a lot to this one.
-	if(0 >= fprintf(rec_file, "# end of file\n")){ return 0; }
+	if(0 >= async_printf(rec_file, "# end of file\n")){ return 0; }
 
 	return 1;
 }
@@ -17,6 +17,7 @@
 #include <errno.h>
 #include <ctype.h>
 #include <time.h>
+#include <stdarg.h>
 
 #include "gridlabd.h"
 #include "../tape/tape.h"
@@ -25,6 +26,7 @@
 
 int csv_data_only = 0; /* enable this option to suppress addition of lines starting with # in CSV */
 int csv_keep_clean = 0; /* enable this option to keep data flushed at end of line */
+ASYNCOPS *tape_async = NULL;
 EXPORT void set_csv_data_only()
 {
 	csv_data_only = 1;
@@ -34,6 +36,25 @@ EXPORT void set_csv_keep_clean()
 	csv_keep_clean = 1;
 }
 
+/* output that may be queued, the header aside since nothing can be queued ahead of it */
+static int out_printf(FILE *fp, const char *format, ...)
+{
+	int count;
+	va_list ptr;
+	va_start(ptr,format);
+	count = tape_async ? tape_async->vprintf(fp,format,ptr) : vfprintf(fp,format,ptr);
+	va_end(ptr);
+	return count;
+}
+static int out_flush(FILE *fp)
+{
+	return tape_async ? tape_async->flush(fp) : fflush(fp);
+}
+static int out_close(FILE *fp)
+{
+	return tape_async ? tape_async->close(fp) : fclose(fp);
+}
+
 /*******************************************************************
  * players 
  */
@@ -368,8 +389,8 @@ EXPORT int open_recorder(struct recorder *my, char *fname, char *flags)
 
 EXPORT int write_recorder(struct recorder *my, char *timestamp, char *value)
 { 
-	int count = fprintf(my->fp,"%s,%s\n", timestamp, value);
-	if (csv_keep_clean) fflush(my->fp);
+	int count = out_printf(my->fp,"%s,%s\n", timestamp, value);
+	if (csv_keep_clean) out_flush(my->fp);
 	return count;
 }
 
@@ -377,8 +398,8 @@ EXPORT void close_recorder(struct recorder *my)
 {
 	if (my->fp)
 	{
-		if (!csv_data_only) fprintf(my->fp,"# end of tape\n");
-		fclose(my->fp);
+		if (!csv_data_only) out_printf(my->fp,"# end of tape\n");
+		out_close(my->fp);
 		my->fp = NULL; // Defensive programming. For some reason GridlabD was 
 		// closing the same pointer twice, causing it to crash.
 	}
@@ -443,8 +464,8 @@ EXPORT int open_histogram(histogram *my, char *fname, char *flags)
 
 EXPORT int write_histogram(histogram *my, char *timestamp, char *value)
 { 
-	int count = fprintf(my->fp,"%s,%s\n", timestamp, value);
-	if (csv_keep_clean) fflush(my->fp);
+	int count = out_printf(my->fp,"%s,%s\n", timestamp, value);
+	if (csv_keep_clean) out_flush(my->fp);
 	return count;
 }
 
@@ -452,8 +473,8 @@ EXPORT void close_histogram(histogram *my)
 {
 	if (my->fp)
 	{
-		fprintf(my->fp,"# end of tape\n");
-		fclose(my->fp);
+		out_printf(my->fp,"# end of tape\n");
+		out_close(my->fp);
 		my->fp = NULL;
 		/* Defensive programming. For some reason GridlabD was 
 		 * closing the same pointer twice, causing it to crash.
@@ -506,8 +527,8 @@ EXPORT int open_collector(struct collector *my, char *fname, char *flags)
 
 EXPORT int write_collector(struct collector *my, char *timestamp, char *value)
 {
-	int count = fprintf(my->fp,"%s,%s\n", timestamp, value);
-	if (csv_keep_clean) fflush(my->fp);
+	int count = out_printf(my->fp,"%s,%s\n", timestamp, value);
+	if (csv_keep_clean) out_flush(my->fp);
 	return count;
 }
 
@@ -515,8 +536,8 @@ EXPORT void close_collector(struct collector *my)
 {
 	if (my->fp)
 	{
-		if (!csv_data_only) fprintf(my->fp,"# end of tape\n");
-		fclose(my->fp);
+		if (!csv_data_only) out_printf(my->fp,"# end of tape\n");
+		out_close(my->fp);
 	}
 	my->fp = 0;
 }
@@ -69,7 +69,7 @@ typedef int_t shortint;
     int_t i__1;
 
     /* Local variables */
-    static int_t mdeg, ehead, i, mdlmt, mdnode;
+    int_t mdeg, ehead, i, mdlmt, mdnode;
     extern /* Subroutine */ int_t mmdelm_(int_t *, int_t *, shortint *, 
 	    shortint *, shortint *, shortint *, shortint *, shortint *, 
 	    shortint *, int_t *, int_t *), mmdupd_(int_t *, int_t *, 
@@ -78,7 +78,7 @@ typedef int_t shortint;
 	    int_t *), mmdint_(int_t *, int_t *, shortint *, shortint *, 
 	    shortint *, shortint *, shortint *, shortint *, shortint *), 
 	    mmdnum_(int_t *, shortint *, shortint *, shortint *);
-    static int_t nextmd, tag, num;
+    int_t nextmd, tag, num;
 
 
 /* *************************************************************** */
@@ -255,7 +255,7 @@ L1000:
     int_t i__1;
 
     /* Local variables */
-    static int_t ndeg, node, fnode;
+    int_t ndeg, node, fnode;
 
 
 /* *************************************************************** */
@@ -339,7 +339,7 @@ L1000:
     int_t i__1, i__2;
 
     /* Local variables */
-    static int_t node, link, rloc, rlmt, i, j, nabor, rnode, elmnt, xqnbr, 
+    int_t node, link, rloc, rlmt, i, j, nabor, rnode, elmnt, xqnbr, 
 	    istop, jstop, istrt, jstrt, nxnode, pvnode, nqnbrs, npv;
 
 
@@ -587,7 +587,7 @@ L1800:
     int_t i__1, i__2;
 
     /* Local variables */
-    static int_t node, mtag, link, mdeg0, i, j, enode, fnode, nabor, elmnt, 
+    int_t node, mtag, link, mdeg0, i, j, enode, fnode, nabor, elmnt, 
 	    istop, jstop, q2head, istrt, jstrt, qxhead, iq2, deg, deg0;
 
 
@@ -941,7 +941,7 @@ L2300:
     int_t i__1;
 
     /* Local variables */
-    static int_t node, root, nextf, father, nqsize, num;
+    int_t node, root, nextf, father, nqsize, num;
 
 
 /* *************************************************************** */
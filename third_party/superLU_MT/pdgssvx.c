@@ -673,6 +673,7 @@ pdgssvx(int_t nprocs, superlumt_options_t *superlumt_options, SuperMatrix *A,
     }
 
     superlu_dQuerySpace(nprocs, L, U, panel_size, superlu_memusage);
+    superlu_memusage->expansions = Gstat.expansions;
 
     /* ------------------------------------------------------------
        Deallocate storage after factorization.
@@ -176,8 +176,8 @@ void
     xlsub_end  = Glu->xlsub_end;
 
     /* Allocate and initialize the per-process working storage. */
-    if ( (*info = pdgstrf_WorkInit(m, panel_size, &iwork, &dwork)) ) {
-	*info += pdgstrf_memory_use(Glu->nzlmax, Glu->nzumax, Glu->nzlumax);
+    if ( (*info = pdgstrf_WorkInit(m, panel_size, &iwork, &dwork, Glu)) ) {
+	*info += pdgstrf_memory_use(Glu->nzlmax, Glu->nzumax, Glu->nzlumax, Glu->ndim);
 	return 0;
     }
     pxgstrf_SetIWork(m, panel_size, iwork, &segrep, &parent, &xplore,
@@ -70,7 +70,6 @@ pdgstrf_thread_finalize(pdgstrf_threadarg_t *pdgstrf_threadarg,
     int_t       nnzL, nnzU;
     superlumt_options_t *superlumt_options;
     GlobalLU_t *Glu;
-    extern ExpHeader *dexpanders;
 
     n = A->ncol;
     superlumt_options = pdgstrf_threadarg->superlumt_options;
@@ -127,8 +126,9 @@ pdgstrf_thread_finalize(pdgstrf_threadarg_t *pdgstrf_threadarg,
     SUPERLU_FREE(pxgstrf_shared->inv_perm_c);
     SUPERLU_FREE(pxgstrf_shared->xprune);
     SUPERLU_FREE(pxgstrf_shared->ispruned);
-    SUPERLU_FREE(dexpanders);
-    dexpanders = 0;
+    pxgstrf_shared->Gstat->expansions = Glu->no_expand - 1;
+    SUPERLU_FREE(Glu->expanders);
+    SUPERLU_FREE(Glu);
 
 #if ( DEBUGlevel>=1 )
     printf("** pdgstrf_thread_finalize() called\n");
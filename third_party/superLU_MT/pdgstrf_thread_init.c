@@ -72,7 +72,7 @@ pdgstrf_thread_init(SuperMatrix *A, SuperMatrix *L, SuperMatrix *U,
  *               memory allocation failure occurred, plus A->ncol.
  *
  */
-    static GlobalLU_t Glu; /* persistent to support repeated factors. */
+    GlobalLU_t *Glu; /* this factorization's; freed by pdgstrf_thread_finalize() */
     pdgstrf_threadarg_t *pdgstrf_threadarg;
     register int_t n, i, nprocs;
     NCPformat *Astore;
@@ -98,6 +98,8 @@ pdgstrf_thread_init(SuperMatrix *A, SuperMatrix *L, SuperMatrix *U,
     inv_perm_c = (int_t *) intMalloc(n);
     xprune     = (int_t *) intMalloc(n);
     ispruned   = (int_t *) intCalloc(n);
+    Glu        = (GlobalLU_t *) SUPERLU_MALLOC(sizeof(GlobalLU_t));
+    memset(Glu, 0, sizeof(GlobalLU_t));
     
     /* Pack shared data objects to each process. */
     pxgstrf_shared->inv_perm_r   = inv_perm_r;
@@ -105,7 +107,7 @@ pdgstrf_thread_init(SuperMatrix *A, SuperMatrix *L, SuperMatrix *U,
     pxgstrf_shared->xprune       = xprune;
     pxgstrf_shared->ispruned     = ispruned;
     pxgstrf_shared->A            = A;
-    pxgstrf_shared->Glu          = &Glu;
+    pxgstrf_shared->Glu          = Glu;
     pxgstrf_shared->Gstat        = Gstat;
     pxgstrf_shared->info         = info;
 
@@ -116,10 +118,10 @@ pdgstrf_thread_init(SuperMatrix *A, SuperMatrix *L, SuperMatrix *U,
     for (i = 0; i < n; ++i) inv_perm_c[perm_c[i]] = i;
 
     /* Initialization. */
-    Glu.nsuper = -1;
-    Glu.nextl  = 0;
-    Glu.nextu  = 0;
-    Glu.nextlu = 0;
+    Glu->nsuper = -1;
+    Glu->nextl  = 0;
+    Glu->nextu  = 0;
+    Glu->nextlu = 0;
     ifill(perm_r, n, EMPTY);
 
     /* Identify relaxed supernodes at the bottom of the etree. */
@@ -139,13 +141,13 @@ pdgstrf_thread_init(SuperMatrix *A, SuperMatrix *L, SuperMatrix *U,
     ParallelInit(n, pxgstrf_relax, options, pxgstrf_shared);
     
     /* Set up memory image in lusup[*]. */
-    nzlumax = dPresetMap(n, A, pxgstrf_relax, options, &Glu);
-    if ( options->refact == NO ) Glu.nzlumax = nzlumax;
+    nzlumax = dPresetMap(n, A, pxgstrf_relax, options, Glu);
+    if ( options->refact == NO ) Glu->nzlumax = nzlumax;
     
     SUPERLU_FREE (pxgstrf_relax);
 
     /* Allocate global storage common to all the factor routines */
-    *info = pdgstrf_MemInit(n, Astore->nnz, options, L, U, &Glu);
+    *info = pdgstrf_MemInit(n, Astore->nnz, options, L, U, Glu);
     if ( *info ) return NULL;
 
     /* Prepare arguments to all threads. */
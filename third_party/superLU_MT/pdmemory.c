@@ -37,9 +37,9 @@ at the top-level directory.
 void    *pdgstrf_expand (int_t *, MemType,int_t, int_t, GlobalLU_t *);
 void    copy_mem_double (int_t, void *, void *);
 void    pdgstrf_StackCompress(GlobalLU_t *);
-void    pdgstrf_SetupSpace (void *, int_t);
-void    *duser_malloc   (int_t, int_t);
-void    duser_free      (int_t, int_t);
+void    pdgstrf_SetupSpace (void *, int_t, GlobalLU_t *);
+void    *duser_malloc   (int_t, int_t, GlobalLU_t *);
+void    duser_free      (int_t, int_t, GlobalLU_t *);
 
 /* ----------------------------------------------
    External prototypes (in memory.c - prec-indep)
@@ -47,28 +47,21 @@ void    duser_free      (int_t, int_t);
 extern void    copy_mem_int    (int_t, void *, void *);
 extern void    user_bcopy      (char *, char *, int_t);
 
-typedef struct {
-    int_t  size;
-    int_t  used;
-    int_t  top1;  /* grow upward, relative to &array[0] */
-    int_t  top2;  /* grow downward */
-    void *array;
-#if ( MACH==PTHREAD )
-    pthread_mutex_t lock;;
-#endif
-} LU_stack_t;
-
 typedef enum {HEAD, TAIL}   stack_end_t;
 typedef enum {SYSTEM, USER} LU_space_t;
 
-ExpHeader *dexpanders = 0; /* Array of pointers to 4 types of memory */
-static LU_stack_t stack;
-static int_t        no_expand;
-static int_t        ndim;
-static LU_space_t whichspace; /* 0 - system malloc'd; 1 - user provided */
+/* The memory state (expanders, stack, whichspace, no_expand, ndim) is kept
+   in GlobalLU_t, so each factorization has its own */
+
+/* Array sizes of the last factorization.  A refactorization (refact = YES)
+   reuses the L and U of the last factorization, which don't record them. */
+static int_t last_nzlmax, last_nzumax, last_nzlumax;
+#if ( MACH==PTHREAD )
+static pthread_mutex_t last_size_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /* Macros to manipulate stack */
-#define StackFull(x)         ( x + stack.used >= stack.size )
+#define StackFull(x)         ( x + Glu->stack.used >= Glu->stack.size )
 #define NotDoubleAlign(addr) ( (long long int)addr & 7 )
 #define DoubleAlign(addr)    ( ((long long int)addr + 7) & ~7L )
 
@@ -82,40 +75,40 @@ static LU_space_t whichspace; /* 0 - system malloc'd; 1 - user provided */
  *    lwork = 0: use system malloc;
  *    lwork > 0: use user-supplied work[] space.
  */
-void pdgstrf_SetupSpace(void *work, int_t lwork)
+void pdgstrf_SetupSpace(void *work, int_t lwork, GlobalLU_t *Glu)
 {
     if ( lwork == 0 ) {
-        whichspace = SYSTEM; /* malloc/free */
+        Glu->whichspace = SYSTEM; /* malloc/free */
     } else if ( lwork > 0 ) {
-        whichspace = USER;   /* user provided space */
-        stack.size = lwork;
-        stack.used = 0;
-        stack.top1 = 0;
-        stack.top2 = lwork;
-        stack.array = (void *) work;
+        Glu->whichspace = USER;   /* user provided space */
+        Glu->stack.size = lwork;
+        Glu->stack.used = 0;
+        Glu->stack.top1 = 0;
+        Glu->stack.top2 = lwork;
+        Glu->stack.array = (void *) work;
     }
 #if ( MACH==PTHREAD )
-    pthread_mutex_init ( &stack.lock, NULL);
+    pthread_mutex_init ( &Glu->stack.lock, NULL);
 #endif
 }
 
 /*
  * Destroy the lock used for user stack memory.
  */
-void pdgstrf_StackFree()
+void pdgstrf_StackFree(GlobalLU_t *Glu)
 {
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-     if ( whichspace == USER ) 
-         pthread_mutex_destroy( &stack.lock );
+     if ( Glu->whichspace == USER ) 
+         pthread_mutex_destroy( &Glu->stack.lock );
 #endif
 } 
 
-void *duser_malloc(int_t bytes, int_t which_end)
+void *duser_malloc(int_t bytes, int_t which_end, GlobalLU_t *Glu)
 {
     void *buf;
 
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-    pthread_mutex_lock( &stack.lock );
+    pthread_mutex_lock( &Glu->stack.lock );
 #elif ( MACH==OPENMP ) /* Use openMP ... */
 #pragma omp critical ( STACK_LOCK )
 #endif
@@ -126,41 +119,41 @@ void *duser_malloc(int_t bytes, int_t which_end)
         }
 
         if ( which_end == HEAD ) {
-	    buf = (char*) stack.array + stack.top1;
-	    stack.top1 += bytes;
+	    buf = (char*) Glu->stack.array + Glu->stack.top1;
+	    Glu->stack.top1 += bytes;
         } else {
-	    stack.top2 -= bytes;
-	    buf = (char*) stack.array + stack.top2;
+	    Glu->stack.top2 -= bytes;
+	    buf = (char*) Glu->stack.array + Glu->stack.top2;
         }
-        stack.used += bytes;
+        Glu->stack.used += bytes;
         
      end: ;
     } /* ---- end critical section ---- */
 
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-    pthread_mutex_unlock( &stack.lock );
+    pthread_mutex_unlock( &Glu->stack.lock );
 #endif
     return buf;
 }
 
 
-void duser_free(int_t bytes, int_t which_end)
+void duser_free(int_t bytes, int_t which_end, GlobalLU_t *Glu)
 {
 
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-    pthread_mutex_lock( &stack.lock );
+    pthread_mutex_lock( &Glu->stack.lock );
 #elif ( MACH==OPENMP ) /* Use openMP ... */
 #pragma omp critical ( STACK_LOCK )
 #endif
 
     {
-        if ( which_end == HEAD ) stack.top1 -= bytes;
-        else stack.top2 += bytes;
-        stack.used -= bytes;
+        if ( which_end == HEAD ) Glu->stack.top1 -= bytes;
+        else Glu->stack.top2 += bytes;
+        Glu->stack.used -= bytes;
     }
 
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-    pthread_mutex_unlock( &stack.lock );
+    pthread_mutex_unlock( &Glu->stack.lock );
 #endif
 
 }
@@ -194,7 +187,7 @@ int_t superlu_dTempSpace(int_t n, int_t w, int_t p)
  *    o total_needed (float)
  *      The amount of space needed in bytes to perform factorization.
  *    o expansions (int)
- *      The number of memory expansions during the LU factorization.
+ *      Not set here -- the factorization leaves it in Gstat->expansions.
  */
 int_t superlu_dQuerySpace(int_t P, SuperMatrix *L, SuperMatrix *U, int_t panel_size,
                        superlu_memusage_t *superlu_memusage)
@@ -222,24 +215,50 @@ int_t superlu_dQuerySpace(int_t P, SuperMatrix *L, SuperMatrix *U, int_t panel_s
     lwork = superlu_dTempSpace(n, panel_size, P);
     superlu_memusage->total_needed = superlu_memusage->for_lu + lwork;
 
-    superlu_memusage->expansions = --no_expand;
-
     return 0;
 }
 
-float pdgstrf_memory_use(const int_t nzlmax, const int_t nzumax, const int_t nzlumax)
+float pdgstrf_memory_use(const int_t nzlmax, const int_t nzumax, const int_t nzlumax, const int_t n)
 {
     register float iword, dword, t;
 
     iword   = sizeof(int_t);
     dword   = sizeof(double);
 
-    t = 10. * ndim * iword + nzlmax * iword + nzumax * (iword + dword)
+    t = 10. * n * iword + nzlmax * iword + nzumax * (iword + dword)
 	+ nzlumax * dword;
     return t;
 }
 
 
+/*
+ * Record (save = 1) or retrieve (save = 0) the array sizes of the last
+ * factorization.
+ */
+static void
+pdgstrf_LastSizes(int_t save, int_t *nzlmax, int_t *nzumax, int_t *nzlumax)
+{
+#if ( MACH==PTHREAD ) /* Use pthread ... */
+    pthread_mutex_lock( &last_size_lock );
+#elif ( MACH==OPENMP ) /* Use openMP ... */
+#pragma omp critical ( LAST_SIZE_LOCK )
+#endif
+    {
+        if ( save ) {
+	    last_nzlmax  = *nzlmax;
+	    last_nzumax  = *nzumax;
+	    last_nzlumax = *nzlumax;
+        } else {
+	    *nzlmax  = last_nzlmax;
+	    *nzumax  = last_nzumax;
+	    *nzlumax = last_nzlumax;
+        }
+    }
+#if ( MACH==PTHREAD ) /* Use pthread ... */
+    pthread_mutex_unlock( &last_size_lock );
+#endif
+}
+
 /*
  * Allocate storage for the data structures common to all factor routines.
  * For those unpredictable size, make a guess as FILL * nnz(A).
@@ -271,13 +290,12 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
     int_t      FILL_UCOL = sp_ienv(7); /* Guess the fill-in growth for UCOL */
     int_t      FILL_LSUB = sp_ienv(8); /* Guess the fill-in growth for LSUB */
     
-    no_expand = 0;
-    ndim      = n;
+    Glu->no_expand = 0;
+    Glu->ndim      = n;
     iword     = sizeof(int_t);
     dword     = sizeof(double);
 
-    if ( !dexpanders )
-      dexpanders = (ExpHeader *) SUPERLU_MALLOC(NO_MEMTYPE * sizeof(ExpHeader));
+    Glu->expanders = (ExpHeader *) SUPERLU_MALLOC(NO_MEMTYPE * sizeof(ExpHeader));
 
     if ( refact == NO ) {
 
@@ -299,11 +317,11 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
 		    superlu_dTempSpace(n, panel_size, nprocs)
 		    + (nzlmax+nzumax)*iword + (nzlumax+nzumax)*dword);
         } else {
-	    pdgstrf_SetupSpace(work, lwork);
+	    pdgstrf_SetupSpace(work, lwork, Glu);
 	}
 	
 	/* Integer pointers for L\U factors */
-	if ( whichspace == SYSTEM ) {
+	if ( Glu->whichspace == SYSTEM ) {
 	    xsup       = intMalloc(n+1);
 	    xsup_end   = intMalloc(n);
 	    supno      = intMalloc(n+1);
@@ -314,15 +332,15 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
 	    xusub      = intMalloc(n+1);
 	    xusub_end  = intMalloc(n);
 	} else {
-	    xsup       = (int_t *)duser_malloc((n+1) * iword, HEAD);
-	    xsup_end   = (int_t *)duser_malloc((n) * iword, HEAD);
-	    supno      = (int_t *)duser_malloc((n+1) * iword, HEAD);
-	    xlsub      = (int_t *)duser_malloc((n+1) * iword, HEAD);
-	    xlsub_end  = (int_t *)duser_malloc((n) * iword, HEAD);
-	    xlusup     = (int_t *)duser_malloc((n+1) * iword, HEAD);
-	    xlusup_end = (int_t *)duser_malloc((n) * iword, HEAD);
-	    xusub      = (int_t *)duser_malloc((n+1) * iword, HEAD);
-	    xusub_end  = (int_t *)duser_malloc((n) * iword, HEAD);
+	    xsup       = (int_t *)duser_malloc((n+1) * iword, HEAD, Glu);
+	    xsup_end   = (int_t *)duser_malloc((n) * iword, HEAD, Glu);
+	    supno      = (int_t *)duser_malloc((n+1) * iword, HEAD, Glu);
+	    xlsub      = (int_t *)duser_malloc((n+1) * iword, HEAD, Glu);
+	    xlsub_end  = (int_t *)duser_malloc((n) * iword, HEAD, Glu);
+	    xlusup     = (int_t *)duser_malloc((n+1) * iword, HEAD, Glu);
+	    xlusup_end = (int_t *)duser_malloc((n) * iword, HEAD, Glu);
+	    xusub      = (int_t *)duser_malloc((n+1) * iword, HEAD, Glu);
+	    xusub_end  = (int_t *)duser_malloc((n) * iword, HEAD, Glu);
 	}
 
 	lusup = (double *) pdgstrf_expand( &nzlumax, LUSUP, 0, 0, Glu );
@@ -335,18 +353,18 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
 #if (PRNTlevel==1)
 	    printf(".. pdgstrf_MemInit(): #retries " IFMT "\n", ++retries);
 #endif
-	    if ( whichspace == SYSTEM ) {
+	    if ( Glu->whichspace == SYSTEM ) {
 		SUPERLU_FREE(ucol);
 		SUPERLU_FREE(lsub);
 		SUPERLU_FREE(usub);
 	    } else {
-		duser_free(nzumax*dword+(nzlmax+nzumax)*iword, HEAD);
+		duser_free(nzumax*dword+(nzlmax+nzumax)*iword, HEAD, Glu);
 	    }
 	    nzumax /= 2;    /* reduce request */
 	    nzlmax /= 2;
 	    if ( nzumax < annz/2 ) {
 		printf("Not enough memory to perform factorization.\n");
-		return (pdgstrf_memory_use(nzlmax, nzumax, nzlumax) + n);
+		return (pdgstrf_memory_use(nzlmax, nzumax, nzlumax, n) + n);
 	    }
 	    ucol  = (double *) pdgstrf_expand( &nzumax, UCOL, 0, 0, Glu );
 	    lsub  = (int_t *)  pdgstrf_expand( &nzlmax, LSUB, 0, 0, Glu );
@@ -354,7 +372,7 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
 	}
 	
 	if ( !lusup )  {
-	    float t = pdgstrf_memory_use(nzlmax, nzumax, nzlumax) + n;
+	    float t = pdgstrf_memory_use(nzlmax, nzumax, nzlumax, n) + n;
 	    printf("Not enough memory to perform factorization .. "
 		   "need %.1f GBytes\n", t*1e-9);
 	    fflush(stdout);
@@ -373,30 +391,29 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
 	xlusup_end= Lstore->nzval_colend;
 	xusub    = Ustore->colbeg;
 	xusub_end= Ustore->colend;
-	nzlmax   = Glu->nzlmax;    /* max from previous factorization */
-	nzumax   = Glu->nzumax;
-	nzlumax  = Glu->nzlumax;
+	/* max from previous factorization */
+	pdgstrf_LastSizes(0, &nzlmax, &nzumax, &nzlumax);
 	
 	if ( lwork == -1 ) {
 	    return (GluIntArray(n) * iword + superlu_dTempSpace(n, panel_size, nprocs)
 		    + (nzlmax+nzumax)*iword + (nzlumax+nzumax)*dword);
         } else if ( lwork == 0 ) {
-	    whichspace = SYSTEM;
+	    Glu->whichspace = SYSTEM;
 	} else {
-	    whichspace = USER;
-	    stack.size = lwork;
-	    stack.top2 = lwork;
+	    Glu->whichspace = USER;
+	    Glu->stack.size = lwork;
+	    Glu->stack.top2 = lwork;
 	}
 	
-	lsub  = dexpanders[LSUB].mem  = Lstore->rowind;
-	lusup = dexpanders[LUSUP].mem = Lstore->nzval;
-	usub  = dexpanders[USUB].mem  = Ustore->rowind;
-	ucol  = dexpanders[UCOL].mem  = Ustore->nzval;;
-
-	dexpanders[LSUB].size         = nzlmax;
-	dexpanders[LUSUP].size        = nzlumax;
-	dexpanders[USUB].size         = nzumax;
-	dexpanders[UCOL].size         = nzumax;	
+	lsub  = Glu->expanders[LSUB].mem  = Lstore->rowind;
+	lusup = Glu->expanders[LUSUP].mem = Lstore->nzval;
+	usub  = Glu->expanders[USUB].mem  = Ustore->rowind;
+	ucol  = Glu->expanders[UCOL].mem  = Ustore->nzval;;
+
+	Glu->expanders[LSUB].size         = nzlmax;
+	Glu->expanders[LUSUP].size        = nzlumax;
+	Glu->expanders[USUB].size         = nzumax;
+	Glu->expanders[UCOL].size         = nzumax;	
     }
 
     Glu->xsup       = xsup;
@@ -415,11 +432,12 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
     Glu->nzlmax     = nzlmax;
     Glu->nzumax     = nzumax;
     Glu->nzlumax    = nzlumax;
-    ++no_expand;
+    ++Glu->no_expand;
+    pdgstrf_LastSizes(1, &Glu->nzlmax, &Glu->nzumax, &Glu->nzlumax);
 
 #if ( PRNTlevel>=1 )
-    printf(".. pdgstrf_MemInit() refact %d, whichspace %d, nzlumax " IFMT ", nzumax " IFMT ", nzlmax " IFMT "\n",
-	refact, whichspace, nzlumax, nzumax, nzlmax);
+    printf(".. pdgstrf_MemInit() refact %d, Glu->whichspace %d, nzlumax " IFMT ", nzumax " IFMT ", nzlmax " IFMT "\n",
+	refact, Glu->whichspace, nzlumax, nzumax, nzlmax);
     printf(".. pdgstrf_MemInit() FILL_LUSUP " IFMT ", FILL_UCOL " IFMT ", FILL_LSUB " IFMT "\n",
 	FILL_LUSUP, FILL_UCOL, FILL_LSUB);
     fflush(stdout);
@@ -434,7 +452,8 @@ pdgstrf_MemInit(int_t n, int_t annz, superlumt_options_t *superlumt_options,
  * returns the number of bytes allocated so far when failure occurred.
  */
 int_t
-pdgstrf_WorkInit(int_t n, int_t panel_size, int_t **iworkptr, double **dworkptr)
+pdgstrf_WorkInit(int_t n, int_t panel_size, int_t **iworkptr, double **dworkptr,
+		 GlobalLU_t *Glu)
 {
     int_t  isize, dsize, extra;
     double *old_ptr;
@@ -445,19 +464,19 @@ pdgstrf_WorkInit(int_t n, int_t panel_size, int_t **iworkptr, double **dworkptr)
     dsize = (n * panel_size +
 	     NUM_TEMPV(n,panel_size,maxsuper,rowblk)) * sizeof(double);
     
-    if ( whichspace == SYSTEM ) 
+    if ( Glu->whichspace == SYSTEM ) 
 	*iworkptr = (int_t *) intCalloc(isize/sizeof(int_t));
     else
-	*iworkptr = (int_t *) duser_malloc(isize, TAIL);
+	*iworkptr = (int_t *) duser_malloc(isize, TAIL, Glu);
     if ( ! *iworkptr ) {
 	fprintf(stderr, "pdgstrf_WorkInit: malloc fails for local iworkptr[]\n");
 	return (isize + n);
     }
 
-    if ( whichspace == SYSTEM )
+    if ( Glu->whichspace == SYSTEM )
 	*dworkptr = (double *) SUPERLU_MALLOC((size_t) dsize);
     else {
-	    *dworkptr = (double *) duser_malloc(dsize, TAIL);
+	    *dworkptr = (double *) duser_malloc(dsize, TAIL, Glu);
 	    if ( NotDoubleAlign(*dworkptr) ) {
 	        old_ptr = *dworkptr;
 	        *dworkptr = (double*) DoubleAlign(*dworkptr);
@@ -467,16 +486,16 @@ pdgstrf_WorkInit(int_t n, int_t panel_size, int_t **iworkptr, double **dworkptr)
 	        printf("pdgstrf_WorkInit: not aligned, extra" IFMT "\n", extra);
 #endif	    
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-        pthread_mutex_lock( &stack.lock );
+        pthread_mutex_lock( &Glu->stack.lock );
 #elif ( MACH==OPENMP ) /* Use openMP ... */
 #pragma omp critical ( STACK_LOCK )
 #endif
               {
-	        stack.top2 -= extra;
-	        stack.used += extra;
+	        Glu->stack.top2 -= extra;
+	        Glu->stack.used += extra;
 	      }
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-        pthread_mutex_unlock( &stack.lock );
+        pthread_mutex_unlock( &Glu->stack.lock );
 #endif
 	    }
     } /* else */
@@ -511,23 +530,23 @@ pdgstrf_SetRWork(int_t n, int_t panel_size, double *dworkptr,
  */
 void pdgstrf_WorkFree(int_t *iwork, double *dwork, GlobalLU_t *Glu)
 {
-    if ( whichspace == SYSTEM ) {
+    if ( Glu->whichspace == SYSTEM ) {
 	SUPERLU_FREE (iwork);
 	SUPERLU_FREE (dwork);
     } else {
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-        pthread_mutex_lock( &stack.lock );
+        pthread_mutex_lock( &Glu->stack.lock );
 #elif ( MACH==OPENMP ) /* Use openMP ... */
 #pragma omp critical ( STACK_LOCK )
 #endif
         {
-	    stack.used -= (stack.size - stack.top2);
-	    stack.top2 = stack.size;
+	    Glu->stack.used -= (Glu->stack.size - Glu->stack.top2);
+	    Glu->stack.top2 = Glu->stack.size;
 	    
 	    /*	pdgstrf_StackCompress(Glu);  */
         }
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-        pthread_mutex_unlock( &stack.lock );
+        pthread_mutex_unlock( &Glu->stack.lock );
 #endif
     }
 }
@@ -568,7 +587,7 @@ pdgstrf_MemXpand(
 	int_t    nzlumax = Glu->nzlumax;
     	fprintf(stderr, "Can't expand MemType %d : jcol " IFMT "\n",
                 mem_type, jcol);
-    	return (pdgstrf_memory_use(nzlmax, nzumax, nzlumax) + ndim);
+    	return (pdgstrf_memory_use(nzlmax, nzumax, nzlumax, Glu->ndim) + Glu->ndim);
     }
 
     switch ( mem_type ) {
@@ -589,6 +608,7 @@ pdgstrf_MemXpand(
 	Glu->nzumax = *maxlen;
 	break;
     }
+    pdgstrf_LastSizes(1, &Glu->nzlmax, &Glu->nzumax, &Glu->nzlumax);
     
     return 0;
     
@@ -623,7 +643,7 @@ void
     int_t      new_len, tries, lword, extra, bytes_to_copy;
     void     *ret = NULL;
 
-    if ( no_expand == 0 || keep_prev ) /* First time allocate requested */
+    if ( Glu->no_expand == 0 || keep_prev ) /* First time allocate requested */
         new_len = *prev_len;
     else {
         new_len = alpha * *prev_len;
@@ -632,10 +652,10 @@ void
     if ( type == LSUB || type == USUB ) lword = sizeof(int_t);
     else lword = sizeof(double);
 
-    if ( whichspace == SYSTEM ) {
+    if ( Glu->whichspace == SYSTEM ) {
         new_mem = (void *) SUPERLU_MALLOC( (size_t) new_len * lword );
 
-        if ( no_expand != 0 ) {
+        if ( Glu->no_expand != 0 ) {
             tries = 0;
             if ( keep_prev ) {
                 if ( !new_mem ) return (NULL);
@@ -648,17 +668,17 @@ void
                 }
             }
             if ( type == LSUB || type == USUB ) {
-                copy_mem_int(len_to_copy, dexpanders[type].mem, new_mem);
+                copy_mem_int(len_to_copy, Glu->expanders[type].mem, new_mem);
             } else {
-                copy_mem_double(len_to_copy, dexpanders[type].mem, new_mem);
+                copy_mem_double(len_to_copy, Glu->expanders[type].mem, new_mem);
             }
-            SUPERLU_FREE (dexpanders[type].mem);
+            SUPERLU_FREE (Glu->expanders[type].mem);
         }
-        dexpanders[type].mem = (void *) new_mem;
+        Glu->expanders[type].mem = (void *) new_mem;
 
-    } else { /* whichspace == USER */
-        if ( no_expand == 0 ) {
-            new_mem = duser_malloc(new_len * lword, HEAD);
+    } else { /* Glu->whichspace == USER */
+        if ( Glu->no_expand == 0 ) {
+            new_mem = duser_malloc(new_len * lword, HEAD, Glu);
             if ( NotDoubleAlign(new_mem) &&
                 (type == LUSUP || type == UCOL) ) {
                 old_mem = new_mem;
@@ -668,33 +688,33 @@ void
                 printf("expand(): not aligned, extra " IFMT "\n", extra);
 #endif
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-      pthread_mutex_lock( &stack.lock );
+      pthread_mutex_lock( &Glu->stack.lock );
 #elif ( MACH==OPENMP ) /* Use openMP ... */
 #pragma omp critical ( STACK_LOCK )
 #endif
               {
-                stack.top1 += extra;
-                stack.used += extra;
+                Glu->stack.top1 += extra;
+                Glu->stack.used += extra;
               }
 #if ( MACH==PTHREAD ) /* Use pthread ... */
-      pthread_mutex_unlock( &stack.lock );
+      pthread_mutex_unlock( &Glu->stack.lock );
 #endif
             }
-            dexpanders[type].mem = (void *) new_mem;
+            Glu->expanders[type].mem = (void *) new_mem;
         } else {
             tries = 0;
             extra = (new_len - *prev_len) * lword;
             if ( keep_prev ) {
                 if ( StackFull(extra) ) {
                     new_len = 0;
-                    dexpanders[type].mem = NULL;
+                    Glu->expanders[type].mem = NULL;
 		    return NULL;
                 }
             } else {
                 while ( StackFull(extra) ) {
                     if ( ++tries > 10 ) {
                         new_len = 0;
-                        dexpanders[type].mem = NULL;
+                        Glu->expanders[type].mem = NULL;
 			return NULL;
 		    }
                     alpha = Reduce(alpha);
@@ -704,43 +724,43 @@ void
             }
 
             if ( type != USUB ) {
-                new_mem = (void*)((char*)dexpanders[type + 1].mem + extra);
-                bytes_to_copy = (char*)stack.array + stack.top1
-                    - (char*)dexpanders[type + 1].mem;
-                user_bcopy(dexpanders[type+1].mem, new_mem, bytes_to_copy);
+                new_mem = (void*)((char*)Glu->expanders[type + 1].mem + extra);
+                bytes_to_copy = (char*)Glu->stack.array + Glu->stack.top1
+                    - (char*)Glu->expanders[type + 1].mem;
+                user_bcopy(Glu->expanders[type+1].mem, new_mem, bytes_to_copy);
 
                 if ( type < USUB ) {
-                    Glu->usub = dexpanders[USUB].mem =
-                        (void*)((char*)dexpanders[USUB].mem + extra);
+                    Glu->usub = Glu->expanders[USUB].mem =
+                        (void*)((char*)Glu->expanders[USUB].mem + extra);
                 }
                 if ( type < LSUB ) {
-                    Glu->lsub = dexpanders[LSUB].mem =
-                        (void*)((char*)dexpanders[LSUB].mem + extra);
+                    Glu->lsub = Glu->expanders[LSUB].mem =
+                        (void*)((char*)Glu->expanders[LSUB].mem + extra);
                 }
                 if ( type < UCOL ) {
-                    Glu->ucol = dexpanders[UCOL].mem =
-                        (void*)((char*)dexpanders[UCOL].mem + extra);
+                    Glu->ucol = Glu->expanders[UCOL].mem =
+                        (void*)((char*)Glu->expanders[UCOL].mem + extra);
                 }
-                stack.top1 += extra;
-                stack.used += extra;
+                Glu->stack.top1 += extra;
+                Glu->stack.used += extra;
                 if ( type == UCOL ) {
-                    stack.top1 += extra;   /* Add same amount for USUB */
-                    stack.used += extra;
+                    Glu->stack.top1 += extra;   /* Add same amount for USUB */
+                    Glu->stack.used += extra;
                 }
 
             } /* if ... */
         } /* else ... */
 
-    } /* else, whichspace == USER */
+    } /* else, Glu->whichspace == USER */
 
 #ifdef DEBUG
     printf("pdgstrf_expand[type " IFMT "]\n", type);
 #endif
-    dexpanders[type].size = new_len;
+    Glu->expanders[type].size = new_len;
     *prev_len = new_len;
-    if ( no_expand ) ++no_expand;
+    if ( Glu->no_expand ) ++Glu->no_expand;
 
-    return (void *) dexpanders[type].mem;
+    return (void *) Glu->expanders[type].mem;
   
 } /* expand */
 
@@ -770,24 +790,24 @@ pdgstrf_StackCompress(GlobalLU_t *Glu)
     lusup  = Glu->lusup;
     
     dfrom = ucol;
-    dto = (double *)((char*)lusup + xlusup[ndim] * dword);
-    copy_mem_double(xusub_end[ndim-1], dfrom, dto);
+    dto = (double *)((char*)lusup + xlusup[Glu->ndim] * dword);
+    copy_mem_double(xusub_end[Glu->ndim-1], dfrom, dto);
     ucol = dto;
 
     ifrom = lsub;
-    ito = (int_t *) ((char*)ucol + xusub_end[ndim-1] * iword);
-    copy_mem_int(xlsub[ndim], ifrom, ito);
+    ito = (int_t *) ((char*)ucol + xusub_end[Glu->ndim-1] * iword);
+    copy_mem_int(xlsub[Glu->ndim], ifrom, ito);
     lsub = ito;
     
     ifrom = usub;
-    ito = (int_t *) ((char*)lsub + xlsub[ndim] * iword);
-    copy_mem_int(xusub_end[ndim-1], ifrom, ito);
+    ito = (int_t *) ((char*)lsub + xlsub[Glu->ndim] * iword);
+    copy_mem_int(xusub_end[Glu->ndim-1], ifrom, ito);
     usub = ito;
     
-    last = (char*)usub + xusub_end[ndim-1] * iword;
-    fragment = (char*) ((char*)stack.array + stack.top1 - last);
-    stack.used -= (long long int) fragment;
-    stack.top1 -= (long long int) fragment;
+    last = (char*)usub + xusub_end[Glu->ndim-1] * iword;
+    fragment = (char*) ((char*)Glu->stack.array + Glu->stack.top1 - last);
+    Glu->stack.used -= (long long int) fragment;
+    Glu->stack.top1 -= (long long int) fragment;
 
     Glu->ucol = ucol;
     Glu->lsub = lsub;
@@ -796,7 +816,7 @@ pdgstrf_StackCompress(GlobalLU_t *Glu)
 #ifdef CHK_EXPAND
     printf("pdgstrf_StackCompress: fragment " IFMT "\n", fragment);
     /* PrintStack("After compress", Glu);
-    for (last = 0; last < ndim; ++last)
+    for (last = 0; last < Glu->ndim; ++last)
 	print_lu_col("After compress:", last, 0);*/
 #endif    
     
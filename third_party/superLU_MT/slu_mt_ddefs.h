@@ -155,6 +155,18 @@ typedef int int_t; /* default */
  *	Storage: new row subscripts; that is indexed intp PA.
  *
  */
+/* Stack for the L\U factors in user supplied work[] space */
+typedef struct {
+    int_t  size;
+    int_t  used;
+    int_t  top1;  /* grow upward, relative to &array[0] */
+    int_t  top2;  /* grow downward */
+    void *array;
+#if ( MACH==PTHREAD )
+    pthread_mutex_t lock;
+#endif
+} LU_stack_t;
+
 typedef struct {
     int_t     *xsup;    /* supernode and column mapping */
     int_t     *xsup_end;
@@ -189,6 +201,16 @@ typedef struct {
 			* of the supernode in H.
 			*/
     int_t  dynamic_snode_bound;
+    /* ---------------------------------------------------------------
+     *  Memory management for the L\U factors (see pdmemory.c); kept
+     *  here rather than in statics, so that separate factorizations
+     *  can run at the same time
+     */
+    ExpHeader  *expanders;  /* headers of the 4 types of expandable memory */
+    LU_stack_t stack;       /* user supplied work[] space */
+    int_t      whichspace;  /* 0 - system malloc'd; 1 - user provided */
+    int_t      no_expand;   /* number of memory expansions (+1) */
+    int_t      ndim;        /* matrix dimension */
     /* --------------------------------------------------------------- */
 } GlobalLU_t;
 
@@ -282,7 +304,7 @@ extern void pxgstrf_scheduler (const int_t, const int_t, const int_t *,
 extern int_t  dParallelInit (int_t, pxgstrf_relax_t *, superlumt_options_t *,
 			  pxgstrf_shared_t *);
 extern int_t  ParallelFinalize ();
-extern void pdgstrf_StackFree ();
+extern void pdgstrf_StackFree (GlobalLU_t *);
 extern int_t  queue_init (queue_t *, int_t);
 extern int_t  queue_destroy (queue_t *);
 extern int_t  EnqueueRelaxSnode (queue_t *, int_t, pxgstrf_relax_t *,
@@ -439,8 +461,8 @@ extern int dgemv_(char*, int*, int*, double*, double*,
    ---------------*/
 extern float pdgstrf_MemInit (int_t, int_t, superlumt_options_t *,
 			SuperMatrix *, SuperMatrix *, GlobalLU_t *);
-extern float pdgstrf_memory_use(const int_t, const int_t, const int_t);
-extern int_t  pdgstrf_WorkInit (int_t, int_t, int_t **, double **);
+extern float pdgstrf_memory_use(const int_t, const int_t, const int_t, const int_t);
+extern int_t  pdgstrf_WorkInit (int_t, int_t, int_t **, double **, GlobalLU_t *);
 extern void pxgstrf_SetIWork (int_t, int_t, int_t *, int_t **, int_t **, int_t **,
 		      int_t **, int_t **, int_t **, int_t **);
 extern void pdgstrf_SetRWork (int_t, int_t, double *, double **, double **);
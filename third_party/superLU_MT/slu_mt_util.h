@@ -387,6 +387,7 @@ typedef struct {
     int_t        *cp_firstkid, *cp_nextkid; /* linked list of children */
     int_t        *height;
     float      *flops_by_height;
+    int_t      expansions; /* memory expansions in the last factorization */
 } Gstat_t;
 
 struct Branch {
@@ -396,6 +396,7 @@ StatInit(const int_t n, const int_t nprocs, Gstat_t *Gstat)
 	Gstat->procstat[i].pruned = 0;
 	Gstat->procstat[i].unpruned = 0;
     }
+    Gstat->expansions = 0;
 
 #ifdef PROFILE    
     for (i = 0; i < n; ++i) {